@@ -43,6 +43,14 @@ enum {
 #define THREAD_PRIORITY_HIGH 50
 #define THREAD_PRIORITY_MAX 99
 
+#define EVENT_QUEUE_ADD 1
+#define EVENT_QUEUE_MODIFY 2
+#define EVENT_QUEUE_REMOVE 3
+
+// These can be combined with the poll() events passed to event_queue_control().
+#define EVENT_QUEUE_EDGE_TRIGGERED (1 << 16)
+#define EVENT_QUEUE_ONE_SHOT (1 << 17)
+
 #ifdef __cplusplus
 }
 #endif
@@ -70,6 +70,9 @@ enum class NeedsBigProcessLock {
     S(dump_backtrace, NeedsBigProcessLock::No)             \
     S(dup2, NeedsBigProcessLock::No)                       \
     S(emuctl, NeedsBigProcessLock::No)                     \
+    S(event_queue_control, NeedsBigProcessLock::No)        \
+    S(event_queue_create, NeedsBigProcessLock::No)         \
+    S(event_queue_wait, NeedsBigProcessLock::No)           \
     S(execve, NeedsBigProcessLock::Yes)                    \
     S(exit, NeedsBigProcessLock::Yes)                      \
     S(exit_thread, NeedsBigProcessLock::Yes)               \
@@ -85,7 +88,7 @@ enum class NeedsBigProcessLock {
     S(fsmount, NeedsBigProcessLock::No)                    \
     S(fsync, NeedsBigProcessLock::No)                      \
     S(ftruncate, NeedsBigProcessLock::No)                  \
-    S(futex, NeedsBigProcessLock::Yes)                     \
+    S(futex, NeedsBigProcessLock::No)                      \
     S(futimens, NeedsBigProcessLock::No)                   \
     S(get_dir_entries, NeedsBigProcessLock::No)            \
     S(get_root_session_id, NeedsBigProcessLock::No)        \
@@ -113,7 +116,7 @@ enum class NeedsBigProcessLock {
     S(getuid, NeedsBigProcessLock::No)                     \
     S(inode_watcher_add_watch, NeedsBigProcessLock::No)    \
     S(inode_watcher_remove_watch, NeedsBigProcessLock::No) \
-    S(ioctl, NeedsBigProcessLock::Yes)                     \
+    S(ioctl, NeedsBigProcessLock::No)                      \
     S(join_thread, NeedsBigProcessLock::Yes)               \
     S(jail_create, NeedsBigProcessLock::No)                \
     S(jail_attach, NeedsBigProcessLock::No)                \
@@ -145,20 +148,21 @@ enum class NeedsBigProcessLock {
     S(profiling_free_buffer, NeedsBigProcessLock::Yes)     \
     S(ptrace, NeedsBigProcessLock::Yes)                    \
     S(purge, NeedsBigProcessLock::Yes)                     \
-    S(read, NeedsBigProcessLock::Yes)                      \
-    S(pread, NeedsBigProcessLock::Yes)                     \
+    S(read, NeedsBigProcessLock::No)                       \
+    S(pread, NeedsBigProcessLock::No)                      \
     S(readlink, NeedsBigProcessLock::No)                   \
-    S(readv, NeedsBigProcessLock::Yes)                     \
+    S(readv, NeedsBigProcessLock::No)                      \
     S(realpath, NeedsBigProcessLock::No)                   \
     S(recvfd, NeedsBigProcessLock::No)                     \
-    S(recvmsg, NeedsBigProcessLock::Yes)                   \
+    S(recvmsg, NeedsBigProcessLock::No)                    \
     S(rename, NeedsBigProcessLock::No)                     \
     S(remount, NeedsBigProcessLock::No)                    \
     S(rmdir, NeedsBigProcessLock::No)                      \
     S(scheduler_get_parameters, NeedsBigProcessLock::No)   \
     S(scheduler_set_parameters, NeedsBigProcessLock::No)   \
     S(sendfd, NeedsBigProcessLock::No)                     \
-    S(sendmsg, NeedsBigProcessLock::Yes)                   \
+    S(sendfile, NeedsBigProcessLock::No)                   \
+    S(sendmsg, NeedsBigProcessLock::No)                    \
     S(set_mmap_name, NeedsBigProcessLock::No)              \
     S(setegid, NeedsBigProcessLock::No)                    \
     S(seteuid, NeedsBigProcessLock::No)                    \
@@ -198,8 +202,8 @@ enum class NeedsBigProcessLock {
     S(utime, NeedsBigProcessLock::No)                      \
     S(utimensat, NeedsBigProcessLock::No)                  \
     S(waitid, NeedsBigProcessLock::Yes)                    \
-    S(write, NeedsBigProcessLock::Yes)                     \
-    S(pwritev, NeedsBigProcessLock::Yes)                   \
+    S(write, NeedsBigProcessLock::No)                      \
+    S(pwritev, NeedsBigProcessLock::No)                    \
     S(yield, NeedsBigProcessLock::No)
 
 namespace Syscall {
@@ -265,6 +269,13 @@ struct SC_poll_params {
     u32 const* sigmask;
 };
 
+struct SC_event_queue_wait_params {
+    int queue_fd;
+    struct pollfd* events;
+    unsigned max_events;
+    const struct timespec* timeout;
+};
+
 struct SC_clock_nanosleep_params {
     int clock_id;
     int flags;
@@ -38,22 +38,27 @@ void PageDirectory::deregister_page_directory(PageDirectory* directory)
     });
 }
 
+static Atomic<u64> s_next_context_id { 1 };
+
 LockRefPtr<PageDirectory> PageDirectory::find_current()
 {
     return s_cr3_map->map.with([&](auto& map) {
-        return map.find(read_cr3());
+        // NOTE: The low bits of CR3 hold the PCID, if we use those.
+        return map.find(read_cr3() & ~static_cast<FlatPtr>(PAGE_MASK));
     });
 }
 
 void activate_kernel_page_directory(PageDirectory const& pgd)
 {
-    write_cr3(pgd.cr3());
+    InterruptDisabler disabler;
+    Processor::current().load_page_directory(pgd);
 }
 
 void activate_page_directory(PageDirectory const& pgd, Thread* current_thread)
 {
-    current_thread->regs().cr3 = pgd.cr3();
-    write_cr3(pgd.cr3());
+    InterruptDisabler disabler;
+    current_thread->regs().set_page_directory(pgd);
+    Processor::current().load_page_directory(pgd);
 }
 
 UNMAP_AFTER_INIT NonnullLockRefPtr<PageDirectory> PageDirectory::must_create_kernel_page_directory()
@@ -124,7 +129,10 @@ ErrorOr<NonnullLockRefPtr<PageDirectory>> PageDirectory::try_create_for_userspac
     return directory;
 }
 
-PageDirectory::PageDirectory() = default;
+PageDirectory::PageDirectory()
+    : m_context_id(s_next_context_id.fetch_add(1))
+{
+}
 
 UNMAP_AFTER_INIT void PageDirectory::allocate_kernel_directory()
 {
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
 #include <AK/AtomicRefCounted.h>
 #include <AK/Badge.h>
 #include <AK/HashMap.h>
@@ -184,6 +185,25 @@ public:
 
     RecursiveSpinlock<LockRank::None>& get_lock() { return m_lock; }
 
+    // One bit per processor that has this page directory loaded right now. Only those have to be interrupted when one
+    // of its user mappings changes.
+    u64 active_processors() const { return m_active_processors.load(); }
+    void set_active_on_processor(u32 processor, bool active) const
+    {
+        if (active)
+            m_active_processors.fetch_or(1ull << processor);
+        else
+            m_active_processors.fetch_and(~(1ull << processor));
+    }
+
+    // Bumped whenever a user mapping changes. A processor that kept this page directory's TLB entries around under a
+    // PCID while running something else has to drop them when it loads it again, if this moved on in the meantime.
+    u64 tlb_generation() const { return m_tlb_generation.load(); }
+    void did_change_user_mappings() const { m_tlb_generation.fetch_add(1); }
+
+    // Unlike cr3(), this is never reused by a later page directory, so it's safe to remember across context switches.
+    u64 context_id() const { return m_context_id; }
+
     // This has to be public to let the global singleton access the member pointer
     IntrusiveRedBlackTreeNode<FlatPtr, PageDirectory, RawPtr<PageDirectory>> m_tree_node;
 
@@ -197,6 +217,10 @@ private:
     RefPtr<PhysicalPage> m_directory_table;
     RefPtr<PhysicalPage> m_directory_pages[512];
     RecursiveSpinlock<LockRank::None> m_lock {};
+
+    mutable Atomic<u64> m_active_processors { 0 };
+    mutable Atomic<u64> m_tlb_generation { 0 };
+    u64 m_context_id { 0 };
 };
 
 void activate_kernel_page_directory(PageDirectory const& pgd);
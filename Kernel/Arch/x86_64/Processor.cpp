@@ -524,6 +524,11 @@ UNMAP_AFTER_INIT void Processor::cpu_setup()
         ia32_pat.set(pat);
     }
 
+    if (has_feature(CPUFeature::PCID)) {
+        // Turn on CR4.PCIDE so TLB entries survive switching between address spaces, see load_page_directory().
+        write_cr4(read_cr4() | 0x20000);
+    }
+
     if (has_feature(CPUFeature::SMEP)) {
         // Turn on CR4.SMEP
         write_cr4(read_cr4() | 0x100000);
@@ -949,6 +954,14 @@ void ProcessorBase<T>::exit_trap(TrapFrame& trap)
 template<typename T>
 void ProcessorBase<T>::flush_tlb_local(VirtualAddress vaddr, size_t page_count)
 {
+    // Past this many pages, dropping all non-global entries of the current address space is cheaper than invalidating
+    // them one by one. Kernel ranges don't get this treatment, as that wouldn't flush them from the other PCIDs.
+    static constexpr size_t max_pages_to_invalidate_individually = 32;
+    if (page_count > max_pages_to_invalidate_individually && Memory::is_user_address(vaddr)) {
+        write_cr3(read_cr3());
+        return;
+    }
+
     auto ptr = vaddr.as_ptr();
     while (page_count > 0) {
         // clang-format off
@@ -965,18 +978,92 @@ void ProcessorBase<T>::flush_tlb_local(VirtualAddress vaddr, size_t page_count)
 template<typename T>
 void ProcessorBase<T>::flush_entire_tlb_local()
 {
+    Processor::current().forget_inactive_pcids();
     write_cr3(read_cr3());
 }
 
 template<typename T>
 void ProcessorBase<T>::flush_tlb(Memory::PageDirectory const* page_directory, VirtualAddress vaddr, size_t page_count)
 {
-    if (s_smp_enabled && (!Memory::is_user_address(vaddr) || Process::current().thread_count() > 1))
-        Processor::smp_broadcast_flush_tlb(page_directory, vaddr, page_count);
-    else
+    auto& processor = Processor::current();
+
+    if (!Memory::is_user_address(vaddr)) {
+        // Kernel mappings are part of every page directory, so any processor may have them cached.
+        if (s_smp_enabled) {
+            Processor::smp_broadcast_flush_tlb(page_directory, vaddr, page_count);
+        } else {
+            processor.forget_inactive_pcids();
+            flush_tlb_local(vaddr, page_count);
+        }
+        return;
+    }
+
+    // Processors that load this page directory again later will notice this and not reuse what they had cached for it.
+    // Only the ones that have it loaded right now need to be told.
+    page_directory->did_change_user_mappings();
+    auto other_processors = page_directory->active_processors() & ~(1ull << processor.id());
+    if (s_smp_enabled && other_processors != 0)
+        Processor::smp_multicast_flush_tlb(other_processors, page_directory, vaddr, page_count);
+    else if (processor.active_page_directory() == page_directory)
         flush_tlb_local(vaddr, page_count);
 }
 
+void Processor::forget_inactive_pcids()
+{
+    // The TLB may still hold kernel mappings under the PCIDs of these slots. Forgetting them makes sure that
+    // load_page_directory() flushes a slot before using it again.
+    for (size_t slot = 0; slot < pcid_slot_count; ++slot) {
+        if (slot != m_active_pcid_slot)
+            m_pcid_slots[slot].context_id = 0;
+    }
+}
+
+void Processor::load_page_directory(Memory::PageDirectory const& page_directory)
+{
+    VERIFY_INTERRUPTS_DISABLED();
+
+    auto processor_id = id();
+    if (m_active_page_directory != &page_directory) {
+        if (m_active_page_directory)
+            m_active_page_directory->set_active_on_processor(processor_id, false);
+        page_directory.set_active_on_processor(processor_id, true);
+        m_active_page_directory = &page_directory;
+    }
+
+    if (!has_feature(CPUFeature::PCID)) {
+        write_cr3(page_directory.cr3());
+        return;
+    }
+
+    // NOTE: This has to be read after marking ourselves active above. flush_tlb() bumps the generation before looking
+    //       at the active processors, so either we see the new generation here, or we get sent the flush.
+    auto tlb_generation = page_directory.tlb_generation();
+
+    Optional<size_t> slot;
+    for (size_t i = 0; i < pcid_slot_count; ++i) {
+        if (m_pcid_slots[i].context_id == page_directory.context_id()) {
+            slot = i;
+            break;
+        }
+    }
+
+    bool can_keep_tlb_entries = slot.has_value() && m_pcid_slots[*slot].tlb_generation == tlb_generation;
+    if (!slot.has_value()) {
+        slot = m_next_pcid_slot_to_evict;
+        m_next_pcid_slot_to_evict = (m_next_pcid_slot_to_evict + 1) % pcid_slot_count;
+        m_pcid_slots[*slot].context_id = page_directory.context_id();
+    }
+    m_pcid_slots[*slot].tlb_generation = tlb_generation;
+    m_active_pcid_slot = *slot;
+
+    // Bit 63 tells the CPU to keep the TLB entries tagged with this PCID.
+    static constexpr FlatPtr cr3_no_flush = 1ull << 63;
+    FlatPtr cr3 = page_directory.cr3() | (*slot + 1);
+    if (can_keep_tlb_entries)
+        cr3 |= cr3_no_flush;
+    write_cr3(cr3);
+}
+
 void Processor::smp_return_to_pool(ProcessorMessage& msg)
 {
     ProcessorMessage* next = nullptr;
@@ -1139,11 +1226,13 @@ bool Processor::smp_process_pending_messages()
                 if (Memory::is_user_address(VirtualAddress(msg->flush_tlb.ptr))) {
                     // We assume that we don't cross into kernel land!
                     VERIFY(Memory::is_user_range(VirtualAddress(msg->flush_tlb.ptr), msg->flush_tlb.page_count * PAGE_SIZE));
-                    if (read_cr3() != msg->flush_tlb.page_directory->cr3()) {
+                    if (m_active_page_directory != msg->flush_tlb.page_directory) {
                         // This processor isn't using this page directory right now, we can ignore this request
                         dbgln_if(SMP_DEBUG, "SMP[{}]: No need to flush {} pages at {}", current_id(), msg->flush_tlb.page_count, VirtualAddress(msg->flush_tlb.ptr));
                         break;
                     }
+                } else {
+                    forget_inactive_pcids();
                 }
                 flush_tlb_local(VirtualAddress(msg->flush_tlb.ptr), msg->flush_tlb.page_count);
                 break;
@@ -1215,6 +1304,24 @@ void Processor::smp_broadcast_message(ProcessorMessage& msg)
         APIC::the().broadcast_ipi();
 }
 
+void Processor::smp_multicast_message(u64 processor_mask, ProcessorMessage& msg)
+{
+    auto& current_processor = Processor::current();
+    VERIFY((processor_mask & (1ull << current_processor.id())) == 0);
+
+    dbgln_if(SMP_DEBUG, "SMP[{}]: Multicast message {} to cpus: {:#x} processor: {}", current_processor.id(), VirtualAddress(&msg), processor_mask, VirtualAddress(&current_processor));
+
+    msg.refs.store(popcount(processor_mask), AK::MemoryOrder::memory_order_release);
+    VERIFY(msg.refs > 0);
+    while (processor_mask != 0) {
+        auto cpu = count_trailing_zeroes(processor_mask);
+        processor_mask &= processor_mask - 1;
+        // Only interrupt processors that didn't have messages queued already.
+        if (processors()[cpu]->smp_enqueue_message(msg))
+            APIC::the().send_ipi(cpu);
+    }
+}
+
 void Processor::smp_broadcast_wait_sync(ProcessorMessage& msg)
 {
     auto& cur_proc = Processor::current();
@@ -1283,11 +1390,30 @@ void Processor::smp_broadcast_flush_tlb(Memory::PageDirectory const* page_direct
     msg.flush_tlb.page_count = page_count;
     smp_broadcast_message(msg);
     // While the other processors handle this request, we'll flush ours
+    Processor::current().forget_inactive_pcids();
     flush_tlb_local(vaddr, page_count);
     // Now wait until everybody is done as well
     smp_broadcast_wait_sync(msg);
 }
 
+// NOTE: This waits until every targeted processor has flushed, so each call is a full IPI round trip of its own.
+//       Flushes of several ranges are not batched into a single IPI.
+void Processor::smp_multicast_flush_tlb(u64 processor_mask, Memory::PageDirectory const* page_directory, VirtualAddress vaddr, size_t page_count)
+{
+    auto& msg = smp_get_from_pool();
+    msg.async = false;
+    msg.type = ProcessorMessage::FlushTlb;
+    msg.flush_tlb.page_directory = page_directory;
+    msg.flush_tlb.ptr = vaddr.as_ptr();
+    msg.flush_tlb.page_count = page_count;
+    smp_multicast_message(processor_mask, msg);
+    // While the other processors handle this request, we'll flush ours if we need to
+    if (Processor::current().m_active_page_directory == page_directory)
+        flush_tlb_local(vaddr, page_count);
+    // Now wait until everybody is done as well
+    smp_broadcast_wait_sync(msg);
+}
+
 void Processor::smp_broadcast_halt()
 {
     // We don't want to use a message, because this could have been triggered
@@ -1359,7 +1485,6 @@ extern "C" void enter_thread_context(Thread* from_thread, Thread* to_thread)
     bool has_xsave_avx_support = Processor::current().has_feature(CPUFeature::XSAVE) && Processor::current().has_feature(CPUFeature::AVX);
     Processor::set_current_thread(*to_thread);
 
-    auto& from_regs = from_thread->regs();
     auto& to_regs = to_thread->regs();
 
     // NOTE: IOPL should never be non-zero in any situation, so let's panic immediately
@@ -1392,8 +1517,8 @@ extern "C" void enter_thread_context(Thread* from_thread, Thread* to_thread)
     auto& processor = Processor::current();
     Processor::set_thread_specific_data(to_thread->thread_specific_data());
 
-    if (from_regs.cr3 != to_regs.cr3)
-        write_cr3(to_regs.cr3);
+    if (to_regs.page_directory != processor.active_page_directory())
+        processor.load_page_directory(*to_regs.page_directory);
 
     to_thread->set_cpu(processor.id());
 
@@ -1690,6 +1815,8 @@ UNMAP_AFTER_INIT void ProcessorBase<T>::initialize_context_switching(Thread& ini
     self->m_tss.rsp0l = regs.rsp0 & 0xffffffff;
     self->m_tss.rsp0h = regs.rsp0 >> 32;
 
+    self->load_page_directory(*regs.page_directory);
+
     m_scheduler_initialized = true;
 
     // clang-format off
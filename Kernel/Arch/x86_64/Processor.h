@@ -78,6 +78,22 @@ private:
 
     Atomic<ProcessorMessageEntry*> m_message_queue;
 
+    // The page directory currently loaded into CR3, see load_page_directory().
+    Memory::PageDirectory const* m_active_page_directory { nullptr };
+
+    // With PCIDs, the TLB keeps the entries of the last few page directories we ran around, each tagged with the PCID
+    // of its slot (slot index + 1, PCID 0 is only used until the first page directory gets loaded).
+    struct PCIDSlot {
+        u64 context_id { 0 };
+        u64 tlb_generation { 0 };
+    };
+    static constexpr size_t pcid_slot_count = 6;
+    Array<PCIDSlot, pcid_slot_count> m_pcid_slots {};
+    size_t m_active_pcid_slot { 0 };
+    size_t m_next_pcid_slot_to_evict { 0 };
+
+    void forget_inactive_pcids();
+
     void gdt_init();
     void write_raw_gdt_entry(u16 selector, u32 low, u32 high);
     void write_gdt_entry(u16 selector, Descriptor& descriptor);
@@ -89,6 +105,7 @@ private:
     bool smp_enqueue_message(ProcessorMessage&);
     static void smp_unicast_message(u32 cpu, ProcessorMessage& msg, bool async);
     static void smp_broadcast_message(ProcessorMessage& msg);
+    static void smp_multicast_message(u64 processor_mask, ProcessorMessage& msg);
     static void smp_broadcast_wait_sync(ProcessorMessage& msg);
     static void smp_broadcast_halt();
 
@@ -151,8 +168,13 @@ public:
 
     bool smp_process_pending_messages();
 
+    // Switches this processor over to the given page directory. Must be called with interrupts disabled.
+    void load_page_directory(Memory::PageDirectory const&);
+    Memory::PageDirectory const* active_page_directory() const { return m_active_page_directory; }
+
     static void smp_unicast(u32 cpu, Function<void()>, bool async);
     static void smp_broadcast_flush_tlb(Memory::PageDirectory const*, VirtualAddress, size_t);
+    static void smp_multicast_flush_tlb(u64 processor_mask, Memory::PageDirectory const*, VirtualAddress, size_t);
 };
 
 template<typename T>
@@ -41,6 +41,13 @@ struct ThreadRegisters {
     void set_ip(FlatPtr value) { rip = value; }
 
     FlatPtr cr3;
+    Memory::PageDirectory const* page_directory { nullptr };
+
+    void set_page_directory(Memory::PageDirectory const& directory)
+    {
+        page_directory = &directory;
+        cr3 = directory.cr3();
+    }
 
     FlatPtr ip() const
     {
@@ -62,7 +69,7 @@ struct ThreadRegisters {
         else
             cs = GDT_SELECTOR_CODE3 | 3;
 
-        cr3 = space.page_directory().cr3();
+        set_page_directory(space.page_directory());
 
         if (is_kernel_process) {
             set_sp(kernel_stack_top);
@@ -85,7 +92,7 @@ struct ThreadRegisters {
         cs = GDT_SELECTOR_CODE3 | 3;
         rip = entry_ip;
         rsp = userspace_sp;
-        cr3 = space.page_directory().cr3();
+        set_page_directory(space.page_directory());
     }
 };
 
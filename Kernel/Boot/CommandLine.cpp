@@ -263,6 +263,16 @@ UNMAP_AFTER_INIT AHCIResetMode CommandLine::ahci_reset_mode() const
     PANIC("Unknown AHCIResetMode: {}", ahci_reset_mode);
 }
 
+UNMAP_AFTER_INIT SchedulerReadyQueueMode CommandLine::scheduler_ready_queue_mode() const
+{
+    auto const scheduler_queues = lookup("scheduler_queues"sv).value_or("per_cpu"sv);
+    if (scheduler_queues == "per_cpu"sv)
+        return SchedulerReadyQueueMode::PerProcessor;
+    if (scheduler_queues == "global"sv)
+        return SchedulerReadyQueueMode::Global;
+    PANIC("Unknown SchedulerReadyQueueMode: {}", scheduler_queues);
+}
+
 StringView CommandLine::system_mode() const
 {
     return lookup("system_mode"sv).value_or("graphical"sv);
@@ -49,6 +49,11 @@ enum class AHCIResetMode {
     Aggressive,
 };
 
+enum class SchedulerReadyQueueMode {
+    PerProcessor,
+    Global,
+};
+
 class CommandLine {
 
 public:
@@ -96,6 +101,7 @@ public:
     [[nodiscard]] bool disable_virtio() const;
     [[nodiscard]] bool is_early_boot_console_disabled() const;
     [[nodiscard]] AHCIResetMode ahci_reset_mode() const;
+    [[nodiscard]] SchedulerReadyQueueMode scheduler_ready_queue_mode() const;
     [[nodiscard]] StringView userspace_init() const;
     [[nodiscard]] Vector<NonnullOwnPtr<KString>> userspace_init_args() const;
     [[nodiscard]] StringView root_device() const;
@@ -5,9 +5,12 @@
  */
 
 #include <AK/IntrusiveList.h>
+#include <AK/Singleton.h>
 #include <Kernel/Debug.h>
 #include <Kernel/FileSystem/BlockBasedFileSystem.h>
+#include <Kernel/Memory/MemoryManager.h>
 #include <Kernel/Tasks/Process.h>
+#include <Kernel/Tasks/WorkQueue.h>
 
 namespace Kernel {
 
@@ -15,104 +18,423 @@ struct CacheEntry {
     IntrusiveListNode<CacheEntry> list_node;
     BlockBasedFileSystem::BlockIndex block_index { 0 };
     u8* data { nullptr };
+    // Changes whenever the entry is reassigned or its data changes, so read-ahead can tell whether its
+    // reservation still stands once the device read completes.
+    u64 generation { 0 };
     bool has_data { false };
+    bool is_dirty { false };
 };
 
-class DiskCache {
+// A contiguous slab of cache entries along with the block data they point into.
+// Shards grow and shrink one segment at a time.
+struct DiskCacheSegment {
+    NonnullOwnPtr<KBuffer> cached_block_data;
+    NonnullOwnPtr<KBuffer> entries_buffer;
+    size_t entry_count { 0 };
+
+    CacheEntry* entries() { return (CacheEntry*)entries_buffer->data(); }
+};
+
+class DiskCacheShard {
 public:
-    static constexpr size_t EntryCount = 10000;
-    explicit DiskCache(BlockBasedFileSystem& fs, NonnullOwnPtr<KBuffer> cached_block_data, NonnullOwnPtr<KBuffer> entries_buffer)
-        : m_fs(fs)
-        , m_cached_block_data(move(cached_block_data))
-        , m_entries(move(entries_buffer))
+    DiskCacheShard() = default;
+    ~DiskCacheShard() = default;
+
+    size_t capacity() const { return m_capacity; }
+    size_t segment_count() const { return m_segments.size(); }
+    size_t cached_block_count() const { return m_hash.size(); }
+    size_t dirty_block_count() const { return m_dirty_count; }
+    u64 hit_count() const { return m_hit_count; }
+    u64 miss_count() const { return m_miss_count; }
+    u64 eviction_count() const { return m_eviction_count; }
+
+    size_t take_misses_since_rebalance() { return exchange(m_misses_since_rebalance, 0); }
+
+    ErrorOr<void> add_segment(size_t block_size, size_t entry_count)
     {
-        for (size_t i = 0; i < EntryCount; ++i) {
-            entries()[i].data = m_cached_block_data->data() + i * m_fs->logical_block_size();
-            m_clean_list.append(entries()[i]);
+        TRY(m_segments.try_ensure_capacity(m_segments.size() + 1));
+        auto cached_block_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache blocks"sv, entry_count * block_size));
+        auto entries_buffer = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache entries"sv, entry_count * sizeof(CacheEntry)));
+        m_segments.unchecked_append({ move(cached_block_data), move(entries_buffer), entry_count });
+
+        auto& segment = m_segments.last();
+        for (size_t i = 0; i < entry_count; ++i) {
+            auto& entry = segment.entries()[i];
+            entry.data = segment.cached_block_data->data() + i * block_size;
+            m_clean_list.append(entry);
         }
+        m_capacity += entry_count;
+        return {};
     }
 
-    ~DiskCache() = default;
-
-    bool is_dirty() const { return !m_dirty_list.is_empty(); }
-    bool entry_is_dirty(CacheEntry const& entry) const { return m_dirty_list.contains(entry); }
-
-    void mark_all_clean()
+    // Writes out and forgets all blocks cached in the most recently added segment, then releases it.
+    // The first segment is never released, so every shard can always hold at least some blocks.
+    bool remove_last_segment(BlockBasedFileSystem const& fs)
     {
-        while (auto* entry = m_dirty_list.first())
-            m_clean_list.prepend(*entry);
+        if (m_segments.size() <= 1)
+            return false;
+
+        auto& segment = m_segments.last();
+        for (size_t i = 0; i < segment.entry_count; ++i) {
+            auto& entry = segment.entries()[i];
+            if (entry.is_dirty) {
+                write_entry(fs, entry);
+                entry.is_dirty = false;
+                --m_dirty_count;
+            }
+            forget_entry(entry);
+            entry.list_node.remove();
+        }
+        m_capacity -= segment.entry_count;
+        m_segments.take_last();
+        return true;
     }
 
     void mark_dirty(CacheEntry& entry)
     {
+        did_change(entry);
+        if (!entry.is_dirty) {
+            entry.is_dirty = true;
+            ++m_dirty_count;
+        }
         m_dirty_list.prepend(entry);
     }
 
     void mark_clean(CacheEntry& entry)
     {
+        if (entry.is_dirty) {
+            entry.is_dirty = false;
+            --m_dirty_count;
+        }
         m_clean_list.prepend(entry);
     }
 
-    CacheEntry* get(BlockBasedFileSystem::BlockIndex block_index) const
+    CacheEntry* get(BlockBasedFileSystem::BlockIndex block_index)
     {
         auto it = m_hash.find(block_index);
         if (it == m_hash.end())
             return nullptr;
-        auto& entry = const_cast<CacheEntry&>(*it->value);
+        auto& entry = *it->value;
         VERIFY(entry.block_index == block_index);
-        if (!entry_is_dirty(entry) && (m_clean_list.first() != &entry)) {
+        if (!entry.is_dirty && (m_clean_list.first() != &entry)) {
             // Cache hit! Promote the entry to the front of the list.
             m_clean_list.prepend(entry);
         }
         return &entry;
     }
 
-    ErrorOr<CacheEntry*> ensure(BlockBasedFileSystem::BlockIndex block_index) const
+    enum class CountAccess {
+        No,
+        Yes,
+    };
+
+    ErrorOr<CacheEntry*> ensure(BlockBasedFileSystem const& fs, BlockBasedFileSystem::BlockIndex block_index, CountAccess count_access = CountAccess::Yes)
     {
-        if (auto* entry = get(block_index))
+        if (auto* entry = get(block_index)) {
+            if (count_access == CountAccess::Yes)
+                ++m_hit_count;
             return entry;
+        }
+        if (count_access == CountAccess::Yes) {
+            ++m_miss_count;
+            ++m_misses_since_rebalance;
+        }
 
         if (m_clean_list.is_empty()) {
-            // Not a single clean entry! Flush writes and try again.
-            // NOTE: We want to make sure we only call FileBackedFileSystem flush here,
-            //       not some FileBackedFileSystem subclass flush!
-            m_fs->flush_writes_impl();
-            return ensure(block_index);
+            // Not a single clean entry! Write out this shard's dirty blocks and try again.
+            flush(fs);
+            VERIFY(!m_clean_list.is_empty());
         }
 
         VERIFY(m_clean_list.last());
         auto& new_entry = *m_clean_list.last();
         m_clean_list.prepend(new_entry);
 
-        m_hash.remove(new_entry.block_index);
+        forget_entry(new_entry);
         TRY(m_hash.try_set(block_index, &new_entry));
 
         new_entry.block_index = block_index;
         new_entry.has_data = false;
+        did_change(new_entry);
 
         return &new_entry;
     }
 
-    CacheEntry const* entries() const { return (CacheEntry const*)m_entries->data(); }
-    CacheEntry* entries() { return (CacheEntry*)m_entries->data(); }
+    // Makes sure the block has an entry and returns its generation, unless the block is already cached.
+    // The caller can then read the block from the device without holding the shard lock, and only has to
+    // put it into the cache if the generation didn't change in the meantime.
+    Optional<u64> reserve_for_read_ahead(BlockBasedFileSystem const& fs, BlockBasedFileSystem::BlockIndex block_index)
+    {
+        auto entry_or_error = ensure(fs, block_index, CountAccess::No);
+        if (entry_or_error.is_error())
+            return {};
+        auto& entry = *entry_or_error.value();
+        if (entry.has_data)
+            return {};
+        return entry.generation;
+    }
+
+    // Returns whether the data was put into the cache.
+    bool complete_read_ahead(BlockBasedFileSystem const& fs, BlockBasedFileSystem::BlockIndex block_index, u64 generation, u8 const* data)
+    {
+        auto it = m_hash.find(block_index);
+        if (it == m_hash.end())
+            return false;
+        auto& entry = *it->value;
+        // The block was read, written or evicted while we were waiting for the device.
+        if (entry.generation != generation || entry.has_data)
+            return false;
+        memcpy(entry.data, data, fs.logical_block_size());
+        entry.has_data = true;
+        did_change(entry);
+        return true;
+    }
+
+    // Called when the block was written to the device behind the cache's back.
+    void invalidate_read_ahead(BlockBasedFileSystem::BlockIndex block_index)
+    {
+        auto it = m_hash.find(block_index);
+        if (it != m_hash.end() && !it->value->has_data)
+            did_change(*it->value);
+    }
+
+    ErrorOr<void> fill(BlockBasedFileSystem const& fs, CacheEntry& entry)
+    {
+        if (entry.has_data)
+            return {};
+        auto base_offset = entry.block_index.value() * fs.logical_block_size();
+        auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry.data);
+        auto nread = TRY(fs.file_description().read(entry_data_buffer, base_offset, fs.logical_block_size()));
+        VERIFY(nread == fs.logical_block_size());
+        entry.has_data = true;
+        did_change(entry);
+        return {};
+    }
+
+    // Writes all dirty blocks in this shard to disk and returns how many there were.
+    size_t flush(BlockBasedFileSystem const& fs)
+    {
+        size_t count = 0;
+        while (auto* entry = m_dirty_list.first()) {
+            write_entry(fs, *entry);
+            mark_clean(*entry);
+            ++count;
+        }
+        return count;
+    }
+
+    void write_entry(BlockBasedFileSystem const& fs, CacheEntry const& entry)
+    {
+        auto base_offset = entry.block_index.value() * fs.logical_block_size();
+        auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry.data);
+        [[maybe_unused]] auto rc = fs.file_description().write(base_offset, entry_data_buffer, fs.logical_block_size());
+    }
+
+private:
+    void did_change(CacheEntry& entry)
+    {
+        entry.generation = ++m_generation;
+    }
+
+    void forget_entry(CacheEntry& entry)
+    {
+        auto it = m_hash.find(entry.block_index);
+        if (it == m_hash.end() || it->value != &entry)
+            return;
+        m_hash.remove(it);
+        ++m_eviction_count;
+    }
+
+    // NOTE: m_segments must be declared before m_dirty_list and m_clean_list because their entries are allocated from it.
+    // We need to ensure that the destructors of m_dirty_list and m_clean_list are called before the segments are destroyed.
+    Vector<DiskCacheSegment> m_segments;
+    IntrusiveList<&CacheEntry::list_node> m_dirty_list;
+    IntrusiveList<&CacheEntry::list_node> m_clean_list;
+    HashMap<BlockBasedFileSystem::BlockIndex, CacheEntry*> m_hash;
+    size_t m_capacity { 0 };
+    size_t m_dirty_count { 0 };
+    size_t m_misses_since_rebalance { 0 };
+    u64 m_hit_count { 0 };
+    u64 m_miss_count { 0 };
+    u64 m_eviction_count { 0 };
+    u64 m_generation { 0 };
+};
+
+// All disk caches together may use up to 1/8 of physical memory. Every cache can grow into an equal
+// share of that, so mounting more file systems doesn't let their caches add up to more than the budget.
+struct DiskCacheBudgetUsage {
+    size_t used_size { 0 };
+    size_t cache_count { 0 };
+};
+
+static Singleton<SpinlockProtected<DiskCacheBudgetUsage, LockRank::None>> s_disk_cache_budget;
+
+static size_t disk_cache_budget_size()
+{
+    return MM.get_system_memory_info().physical_pages * PAGE_SIZE / 8;
+}
+
+class DiskCache {
+public:
+    // Blocks are spread over the shards by their index, so that accesses to different
+    // blocks rarely have to wait for each other.
+    static constexpr size_t ShardCount = 16;
+    static constexpr size_t MinimumEntriesPerSegment = 16;
+
+    static ErrorOr<NonnullOwnPtr<DiskCache>> try_create(size_t block_size)
+    {
+        auto cache = TRY(adopt_nonnull_own_or_enomem(new (nothrow) DiskCache(block_size)));
+        for (auto& shard : cache->m_shards) {
+            TRY(shard.with_exclusive([&](auto& shard) {
+                return shard.add_segment(block_size, cache->m_entries_per_segment);
+            }));
+        }
+        return cache;
+    }
+
+    MutexProtected<DiskCacheShard>& shard_for(BlockBasedFileSystem::BlockIndex block_index) const
+    {
+        return m_shards[block_index.value() % ShardCount];
+    }
 
     template<typename Callback>
-    void for_each_dirty_entry(Callback callback)
+    void for_each_shard(Callback callback) const
+    {
+        for (auto& shard : m_shards)
+            shard.with_exclusive([&](auto& shard) { callback(shard); });
+    }
+
+    ~DiskCache()
+    {
+        s_disk_cache_budget->with([&](auto& budget) {
+            budget.used_size -= m_cache_size;
+            --budget.cache_count;
+        });
+    }
+
+    // Gives back whatever we grew into earlier, one segment per shard. Returns whether anything was released.
+    bool shrink(BlockBasedFileSystem const& fs)
+    {
+        auto segment_size = m_entries_per_segment * m_block_size;
+        size_t released_size = 0;
+        for_each_shard([&](auto& shard) {
+            shard.take_misses_since_rebalance();
+            if (shard.remove_last_segment(fs)) {
+                released_size += segment_size;
+                dbgln_if(BBFS_DEBUG, "DiskCache: Shrunk shard to {} blocks", shard.capacity());
+            }
+        });
+        release_from_budget(released_size);
+        return released_size != 0;
+    }
+
+    void rebalance(BlockBasedFileSystem const& fs)
     {
-        for (auto& entry : m_dirty_list)
-            callback(entry);
+        if (MM.is_memory_low()) {
+            shrink(fs);
+            return;
+        }
+
+        // Other file systems may have been mounted since we grew, leaving us with more than our share of the budget.
+        if (m_cache_size > fair_share_of_budget()) {
+            shrink(fs);
+            return;
+        }
+
+        auto memory_info = MM.get_system_memory_info();
+        bool memory_is_plentiful = memory_info.physical_pages_uncommitted > memory_info.physical_pages / 4;
+        auto segment_size = m_entries_per_segment * m_block_size;
+        for_each_shard([&](auto& shard) {
+            auto misses = shard.take_misses_since_rebalance();
+            // A shard that missed on more than half of its capacity since the last time we looked is thrashing.
+            if (!memory_is_plentiful || misses <= shard.capacity() / 2)
+                return;
+            if (!try_reserve_from_budget(segment_size))
+                return;
+            if (shard.add_segment(m_block_size, m_entries_per_segment).is_error()) {
+                release_from_budget(segment_size);
+                return;
+            }
+            dbgln_if(BBFS_DEBUG, "DiskCache: Grew shard to {} blocks after {} misses", shard.capacity(), misses);
+        });
+    }
+
+    BlockBasedFileSystem::DiskCacheStatistics statistics() const
+    {
+        BlockBasedFileSystem::DiskCacheStatistics statistics;
+        statistics.shard_count = ShardCount;
+        for_each_shard([&](auto& shard) {
+            statistics.capacity += shard.capacity();
+            statistics.cached_blocks += shard.cached_block_count();
+            statistics.dirty_blocks += shard.dirty_block_count();
+            statistics.segments += shard.segment_count();
+            statistics.hits += shard.hit_count();
+            statistics.misses += shard.miss_count();
+            statistics.evictions += shard.eviction_count();
+        });
+        return statistics;
     }
 
 private:
-    mutable NonnullRefPtr<BlockBasedFileSystem> m_fs;
-    NonnullOwnPtr<KBuffer> m_cached_block_data;
-
-    // NOTE: m_entries must be declared before m_dirty_list and m_clean_list because their entries are allocated from it.
-    // We need to ensure that the destructors of m_dirty_list and m_clean_list are called before m_entries is destroyed.
-    NonnullOwnPtr<KBuffer> m_entries;
-    mutable IntrusiveList<&CacheEntry::list_node> m_dirty_list;
-    mutable IntrusiveList<&CacheEntry::list_node> m_clean_list;
-    mutable HashMap<BlockBasedFileSystem::BlockIndex, CacheEntry*> m_hash;
+    explicit DiskCache(size_t block_size)
+        : m_block_size(block_size)
+        , m_entries_per_segment(reserve_initial_entries_per_segment(block_size))
+        , m_cache_size(ShardCount * m_entries_per_segment * block_size)
+    {
+    }
+
+    // Start out with 1/32 of physical memory, or whatever is left of the budget. Every cache gets at least
+    // one minimally sized segment per shard though, even if that takes us over the budget.
+    static size_t reserve_initial_entries_per_segment(size_t block_size)
+    {
+        auto physical_memory_size = MM.get_system_memory_info().physical_pages * PAGE_SIZE;
+        auto preferred_initial_size = clamp<size_t>(physical_memory_size / 32, 4 * MiB, 64 * MiB);
+        auto budget_size = disk_cache_budget_size();
+        return s_disk_cache_budget->with([&](auto& budget) {
+            auto remaining_budget = budget_size - min(budget.used_size, budget_size);
+            auto initial_size = min(preferred_initial_size, remaining_budget);
+            auto entries_per_segment = max<size_t>(initial_size / block_size / ShardCount, MinimumEntriesPerSegment);
+            budget.used_size += ShardCount * entries_per_segment * block_size;
+            ++budget.cache_count;
+            return entries_per_segment;
+        });
+    }
+
+    static size_t fair_share_of_budget()
+    {
+        auto budget_size = disk_cache_budget_size();
+        return s_disk_cache_budget->with([&](auto& budget) {
+            return budget_size / max<size_t>(budget.cache_count, 1);
+        });
+    }
+
+    bool try_reserve_from_budget(size_t size)
+    {
+        auto budget_size = disk_cache_budget_size();
+        return s_disk_cache_budget->with([&](auto& budget) {
+            if (budget.used_size + size > budget_size)
+                return false;
+            if (m_cache_size + size > budget_size / budget.cache_count)
+                return false;
+            budget.used_size += size;
+            m_cache_size += size;
+            return true;
+        });
+    }
+
+    void release_from_budget(size_t size)
+    {
+        s_disk_cache_budget->with([&](auto& budget) {
+            VERIFY(budget.used_size >= size);
+            budget.used_size -= size;
+        });
+        m_cache_size -= size;
+    }
+
+    size_t const m_block_size { 0 };
+    size_t const m_entries_per_segment { 0 };
+    size_t m_cache_size { 0 };
+    mutable Array<MutexProtected<DiskCacheShard>, ShardCount> m_shards;
 };
 
 BlockBasedFileSystem::BlockBasedFileSystem(OpenFileDescription& file_description)
@@ -136,9 +458,7 @@ ErrorOr<void> BlockBasedFileSystem::initialize_while_locked()
     VERIFY(m_lock.is_locked());
     VERIFY(!is_initialized_while_locked());
     VERIFY(logical_block_size() != 0);
-    auto cached_block_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache blocks"sv, DiskCache::EntryCount * logical_block_size()));
-    auto entries_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache entries"sv, DiskCache::EntryCount * sizeof(CacheEntry)));
-    auto disk_cache = TRY(adopt_nonnull_own_or_enomem(new (nothrow) DiskCache(*this, move(cached_block_data), move(entries_data))));
+    auto disk_cache = TRY(DiskCache::try_create(logical_block_size()));
 
     m_cache.with_exclusive([&](auto& cache) {
         cache = move(disk_cache);
@@ -152,6 +472,20 @@ ErrorOr<void> BlockBasedFileSystem::write_block(BlockIndex index, UserOrKernelBu
     VERIFY(offset + count <= logical_block_size());
     dbgln_if(BBFS_DEBUG, "BlockBasedFileSystem::write_block {}, size={}", index, count);
 
+    if (!allow_cache) {
+        flush_specific_block_if_needed(index);
+        u64 base_offset = index.value() * logical_block_size() + offset;
+        auto nwritten = TRY(file_description().write(base_offset, data, count));
+        VERIFY(nwritten == count);
+        // A read-ahead that was already in flight may have read what was there before.
+        m_cache.with_shared([&](auto& cache) {
+            cache->shard_for(index).with_exclusive([&](auto& shard) {
+                shard.invalidate_read_ahead(index);
+            });
+        });
+        return {};
+    }
+
     // NOTE: We copy the `data` to write into a local buffer before taking the cache lock.
     //       This makes sure any page faults caused by accessing the data will occur before
     //       we tie down the cache.
@@ -159,25 +493,19 @@ ErrorOr<void> BlockBasedFileSystem::write_block(BlockIndex index, UserOrKernelBu
 
     TRY(data.read(buffered_data.bytes()));
 
-    return m_cache.with_exclusive([&](auto& cache) -> ErrorOr<void> {
-        if (!allow_cache) {
-            flush_specific_block_if_needed(index);
-            u64 base_offset = index.value() * logical_block_size() + offset;
-            auto nwritten = TRY(file_description().write(base_offset, data, count));
-            VERIFY(nwritten == count);
-            return {};
-        }
-
-        auto entry = TRY(cache->ensure(index));
-        if (count < logical_block_size()) {
-            // Fill the cache first.
-            TRY(read_block(index, nullptr, logical_block_size()));
-        }
-        memcpy(entry->data + offset, buffered_data.data(), count);
+    return m_cache.with_shared([&](auto& cache) -> ErrorOr<void> {
+        return cache->shard_for(index).with_exclusive([&](auto& shard) -> ErrorOr<void> {
+            auto* entry = TRY(shard.ensure(*this, index));
+            if (count < logical_block_size()) {
+                // Fill the cache first.
+                TRY(shard.fill(*this, *entry));
+            }
+            memcpy(entry->data + offset, buffered_data.data(), count);
 
-        cache->mark_dirty(*entry);
-        entry->has_data = true;
-        return {};
+            shard.mark_dirty(*entry);
+            entry->has_data = true;
+            return {};
+        });
     });
 }
 
@@ -233,26 +561,22 @@ ErrorOr<void> BlockBasedFileSystem::read_block(BlockIndex index, UserOrKernelBuf
     VERIFY(offset + count <= logical_block_size());
     dbgln_if(BBFS_DEBUG, "BlockBasedFileSystem::read_block {}", index);
 
-    return m_cache.with_exclusive([&](auto& cache) -> ErrorOr<void> {
-        if (!allow_cache) {
-            const_cast<BlockBasedFileSystem*>(this)->flush_specific_block_if_needed(index);
-            u64 base_offset = index.value() * logical_block_size() + offset;
-            auto nread = TRY(file_description().read(*buffer, base_offset, count));
-            VERIFY(nread == count);
-            return {};
-        }
-
-        auto* entry = TRY(cache->ensure(index));
-        if (!entry->has_data) {
-            auto base_offset = index.value() * logical_block_size();
-            auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry->data);
-            auto nread = TRY(file_description().read(entry_data_buffer, base_offset, logical_block_size()));
-            VERIFY(nread == logical_block_size());
-            entry->has_data = true;
-        }
-        if (buffer)
-            TRY(buffer->write(entry->data + offset, count));
+    if (!allow_cache) {
+        const_cast<BlockBasedFileSystem*>(this)->flush_specific_block_if_needed(index);
+        u64 base_offset = index.value() * logical_block_size() + offset;
+        auto nread = TRY(file_description().read(*buffer, base_offset, count));
+        VERIFY(nread == count);
         return {};
+    }
+
+    return m_cache.with_shared([&](auto& cache) -> ErrorOr<void> {
+        return cache->shard_for(index).with_exclusive([&](auto& shard) -> ErrorOr<void> {
+            auto* entry = TRY(shard.ensure(*this, index));
+            TRY(shard.fill(*this, *entry));
+            if (buffer)
+                TRY(buffer->write(entry->data + offset, count));
+            return {};
+        });
     });
 }
 
@@ -272,43 +596,160 @@ ErrorOr<void> BlockBasedFileSystem::read_blocks(BlockIndex index, unsigned count
     return {};
 }
 
-void BlockBasedFileSystem::flush_specific_block_if_needed(BlockIndex index)
+void BlockBasedFileSystem::schedule_read_ahead(Vector<BlockIndex> blocks) const
 {
-    m_cache.with_exclusive([&](auto& cache) {
-        if (!cache->is_dirty())
-            return;
-        auto* entry = cache->get(index);
-        if (!entry)
+    // Don't let read-ahead work pile up if the device can't keep up with it anyway.
+    static constexpr u32 maximum_pending_read_ahead_requests = 4;
+
+    if (blocks.is_empty())
+        return;
+    if (m_pending_read_ahead_requests.fetch_add(1) >= maximum_pending_read_ahead_requests) {
+        m_pending_read_ahead_requests.fetch_sub(1);
+        return;
+    }
+
+    NonnullRefPtr<BlockBasedFileSystem> protector = const_cast<BlockBasedFileSystem&>(*this);
+    auto result = g_read_ahead_work->try_queue([protector = move(protector), blocks = move(blocks)] {
+        protector->read_ahead_blocks(blocks);
+        protector->m_pending_read_ahead_requests.fetch_sub(1);
+    });
+    if (result.is_error())
+        m_pending_read_ahead_requests.fetch_sub(1);
+}
+
+void BlockBasedFileSystem::read_ahead_blocks(ReadonlySpan<BlockIndex> blocks)
+{
+    // Reads of physically contiguous blocks are merged into one device request of at most this many blocks.
+    static constexpr size_t maximum_blocks_per_request = 64;
+
+    auto block_size = logical_block_size();
+    // NOTE: The entries are reserved before reading from the device. Anything that happens to a block while
+    //       the read is in flight changes its generation, which makes us drop the (possibly stale) data we read.
+    auto reserve = [&](BlockIndex index) -> Optional<u64> {
+        return m_cache.with_shared([&](auto& cache) -> Optional<u64> {
+            if (!cache)
+                return {};
+            return cache->shard_for(index).with_exclusive([&](auto& shard) {
+                return shard.reserve_for_read_ahead(*this, index);
+            });
+        });
+    };
+
+    Array<u64, maximum_blocks_per_request> generations;
+    size_t i = 0;
+    while (i < blocks.size()) {
+        auto first_generation = reserve(blocks[i]);
+        if (!first_generation.has_value()) {
+            ++i;
+            continue;
+        }
+
+        auto first_block = blocks[i];
+        generations[0] = first_generation.value();
+        size_t block_count = 1;
+        while (i + block_count < blocks.size() && block_count < maximum_blocks_per_request
+            && blocks[i + block_count].value() == first_block.value() + block_count) {
+            auto generation = reserve(blocks[i + block_count]);
+            if (!generation.has_value())
+                break;
+            generations[block_count++] = generation.value();
+        }
+        i += block_count;
+
+        auto buffer_or_error = KBuffer::try_create_with_size("BlockBasedFS: Read-ahead"sv, block_count * block_size);
+        if (buffer_or_error.is_error())
             return;
-        if (!cache->entry_is_dirty(*entry))
+        auto buffer = buffer_or_error.release_value();
+        auto user_or_kernel_buffer = UserOrKernelBuffer::for_kernel_buffer(buffer->data());
+        auto nread_or_error = file_description().read(user_or_kernel_buffer, first_block.value() * block_size, block_count * block_size);
+        if (nread_or_error.is_error() || nread_or_error.value() != block_count * block_size) {
+            // The reserved entries are simply filled on demand later on.
+            dbgln_if(BBFS_DEBUG, "BlockBasedFileSystem: Read-ahead of {} blocks at {} failed", block_count, first_block);
             return;
-        size_t base_offset = entry->block_index.value() * logical_block_size();
-        auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry->data);
-        (void)file_description().write(base_offset, entry_data_buffer, logical_block_size());
+        }
+
+        m_cache.with_shared([&](auto& cache) {
+            if (!cache)
+                return;
+            for (size_t j = 0; j < block_count; ++j) {
+                BlockIndex index { first_block.value() + j };
+                cache->shard_for(index).with_exclusive([&](auto& shard) {
+                    if (shard.complete_read_ahead(*this, index, generations[j], buffer->data() + j * block_size))
+                        m_read_ahead_block_count.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+                });
+            }
+        });
+    }
+}
+
+void BlockBasedFileSystem::flush_specific_block_if_needed(BlockIndex index)
+{
+    m_cache.with_shared([&](auto& cache) {
+        cache->shard_for(index).with_exclusive([&](auto& shard) {
+            if (!shard.dirty_block_count())
+                return;
+            auto* entry = shard.get(index);
+            if (!entry)
+                return;
+            if (!entry->is_dirty)
+                return;
+            shard.write_entry(*this, *entry);
+        });
     });
 }
 
 void BlockBasedFileSystem::flush_writes_impl()
 {
     size_t count = 0;
-    m_cache.with_exclusive([&](auto& cache) {
-        if (!cache->is_dirty())
-            return;
-        cache->for_each_dirty_entry([&](CacheEntry& entry) {
-            auto base_offset = entry.block_index.value() * logical_block_size();
-            auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry.data);
-            [[maybe_unused]] auto rc = file_description().write(base_offset, entry_data_buffer, logical_block_size());
-            ++count;
+    m_cache.with_shared([&](auto& cache) {
+        cache->for_each_shard([&](auto& shard) {
+            count += shard.flush(*this);
         });
-        cache->mark_all_clean();
-        dbgln("{}: Flushed {} blocks to disk", class_name(), count);
     });
+    if (count)
+        dbgln("{}: Flushed {} blocks to disk", class_name(), count);
 }
 
 ErrorOr<void> BlockBasedFileSystem::flush_writes()
 {
     flush_writes_impl();
+    rebalance_disk_cache();
     return {};
 }
 
+void BlockBasedFileSystem::rebalance_disk_cache()
+{
+    m_cache.with_exclusive([&](auto& cache) {
+        if (cache)
+            cache->rebalance(*this);
+    });
+}
+
+void BlockBasedFileSystem::release_cache_memory()
+{
+    m_cache.with_exclusive([&](auto& cache) {
+        if (cache)
+            cache->shrink(*this);
+    });
+}
+
+BlockBasedFileSystem::DiskCacheBudget BlockBasedFileSystem::disk_cache_budget()
+{
+    auto budget_size = disk_cache_budget_size();
+    return s_disk_cache_budget->with([&](auto& budget) -> DiskCacheBudget {
+        return { budget_size, budget.used_size };
+    });
+}
+
+BlockBasedFileSystem::DiskCacheStatistics BlockBasedFileSystem::disk_cache_statistics() const
+{
+    return m_cache.with_shared([&](auto& cache) -> DiskCacheStatistics {
+        if (!cache)
+            return {};
+        auto statistics = cache->statistics();
+        statistics.read_ahead_blocks = m_read_ahead_block_count.load(AK::MemoryOrder::memory_order_relaxed);
+        return statistics;
+    });
+}
+
 }
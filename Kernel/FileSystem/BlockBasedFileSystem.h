@@ -22,6 +22,28 @@ public:
     virtual ErrorOr<void> flush_writes() override;
     void flush_writes_impl();
 
+    virtual void release_cache_memory() override;
+
+    struct DiskCacheStatistics {
+        size_t shard_count { 0 };
+        size_t segments { 0 };
+        size_t capacity { 0 };
+        size_t cached_blocks { 0 };
+        size_t dirty_blocks { 0 };
+        u64 hits { 0 };
+        u64 misses { 0 };
+        u64 evictions { 0 };
+        u64 read_ahead_blocks { 0 };
+    };
+    DiskCacheStatistics disk_cache_statistics() const;
+
+    // The memory budget shared by the disk caches of all block-based file systems.
+    struct DiskCacheBudget {
+        size_t size { 0 };
+        size_t used_size { 0 };
+    };
+    static DiskCacheBudget disk_cache_budget();
+
 protected:
     explicit BlockBasedFileSystem(OpenFileDescription&);
 
@@ -36,6 +58,9 @@ protected:
     ErrorOr<void> raw_read_blocks(BlockIndex index, size_t count, UserOrKernelBuffer&);
     ErrorOr<void> raw_write_blocks(BlockIndex index, size_t count, UserOrKernelBuffer const&);
 
+    // Asynchronously pulls the given blocks into the cache, so that a later read_block() won't have to wait for the device.
+    void schedule_read_ahead(Vector<BlockIndex>) const;
+
     ErrorOr<void> write_block(BlockIndex, UserOrKernelBuffer const&, size_t count, u64 offset = 0, bool allow_cache = true);
     ErrorOr<void> write_blocks(BlockIndex, unsigned count, UserOrKernelBuffer const&, bool allow_cache = true);
 
@@ -44,9 +69,15 @@ protected:
     void remove_disk_cache_before_last_unmount();
 
 private:
+    virtual bool is_block_based() const override { return true; }
+
     void flush_specific_block_if_needed(BlockIndex index);
+    void rebalance_disk_cache();
+    void read_ahead_blocks(ReadonlySpan<BlockIndex>);
 
     mutable MutexProtected<OwnPtr<DiskCache>> m_cache;
+    mutable Atomic<u32> m_pending_read_ahead_requests { 0 };
+    Atomic<u64> m_read_ahead_block_count { 0 };
 };
 
 }
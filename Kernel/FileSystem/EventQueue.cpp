@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/EventQueue.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+
+namespace Kernel {
+
+ErrorOr<NonnullRefPtr<EventQueue>> EventQueue::try_create()
+{
+    return adopt_nonnull_ref_or_enomem(new (nothrow) EventQueue);
+}
+
+EventQueue::~EventQueue()
+{
+    (void)close();
+}
+
+EventQueue::Watch::Watch(EventQueue& queue, int fd, LockWeakPtr<OpenFileDescription> description, File& file, BlockFlags interest, Trigger trigger)
+    : queue(queue)
+    , fd(fd)
+    , description(move(description))
+    , file(file)
+    , interest(interest)
+    , trigger(trigger)
+{
+}
+
+void EventQueue::Watch::block_conditions_may_have_changed()
+{
+    queue.put_on_ready_list(*this);
+}
+
+void EventQueue::put_on_ready_list(Watch& watch)
+{
+    bool did_become_ready = m_state.with([&](auto& state) {
+        if (watch.is_removed || watch.is_disarmed || watch.ready_list_node.is_in_list())
+            return false;
+        state.ready_list.append(watch);
+        return true;
+    });
+    if (did_become_ready)
+        evaluate_block_conditions();
+}
+
+void EventQueue::forget_watch(NonnullOwnPtr<Watch> watch)
+{
+    // NOTE: Once this returns, the blocker set is done calling us, so the watch can go away.
+    watch->file->blocker_set().remove_listener(*watch);
+}
+
+ErrorOr<void> EventQueue::close()
+{
+    MutexLocker locker(m_control_lock);
+    auto watches = m_state.with([](auto& state) {
+        for (auto& it : state.watches)
+            it.value->is_removed = true;
+        state.ready_list.clear();
+        return move(state.watches);
+    });
+    for (auto& it : watches)
+        forget_watch(move(it.value));
+    return {};
+}
+
+bool EventQueue::can_read(OpenFileDescription const&, u64) const
+{
+    return m_state.with([](auto& state) { return !state.ready_list.is_empty(); });
+}
+
+ErrorOr<void> EventQueue::add(int fd, NonnullRefPtr<OpenFileDescription> description, BlockFlags interest, Trigger trigger)
+{
+    // Event queues watching each other could end up notifying each other while holding their locks.
+    if (description->is_event_queue())
+        return EINVAL;
+
+    MutexLocker locker(m_control_lock);
+
+    auto weak_description = TRY(description->try_make_weak_ptr<OpenFileDescription>());
+    auto new_watch = TRY(adopt_nonnull_own_or_enomem(new (nothrow) Watch(*this, fd, move(weak_description), description->file(), interest, trigger)));
+    auto& watch = *new_watch;
+
+    auto replaced_watch = TRY(m_state.with([&](auto& state) -> ErrorOr<OwnPtr<Watch>> {
+        OwnPtr<Watch> replaced_watch;
+        if (auto it = state.watches.find(fd); it != state.watches.end()) {
+            if (it->value->description.unsafe_ptr() == description.ptr())
+                return EEXIST;
+            // The descriptor was closed and reused for something else without removing it from here first.
+            it->value->is_removed = true;
+            state.ready_list.remove(*it->value);
+            replaced_watch = move(it->value);
+            state.watches.remove(it);
+        }
+        TRY(state.watches.try_set(fd, move(new_watch)));
+        // It may well be ready already, which we'll find out when someone waits.
+        state.ready_list.append(watch);
+        return replaced_watch;
+    }));
+    if (replaced_watch)
+        forget_watch(replaced_watch.release_nonnull());
+
+    watch.file->blocker_set().add_listener(watch);
+    evaluate_block_conditions();
+    return {};
+}
+
+ErrorOr<void> EventQueue::modify(int fd, BlockFlags interest, Trigger trigger)
+{
+    MutexLocker locker(m_control_lock);
+    TRY(m_state.with([&](auto& state) -> ErrorOr<void> {
+        auto it = state.watches.find(fd);
+        if (it == state.watches.end())
+            return ENOENT;
+        auto& watch = *it->value;
+        watch.interest = interest;
+        watch.trigger = trigger;
+        // This re-arms one-shot watches.
+        watch.is_disarmed = false;
+        if (!watch.ready_list_node.is_in_list())
+            state.ready_list.append(watch);
+        return {};
+    }));
+    evaluate_block_conditions();
+    return {};
+}
+
+ErrorOr<void> EventQueue::remove(int fd)
+{
+    MutexLocker locker(m_control_lock);
+    auto watch = TRY(m_state.with([&](auto& state) -> ErrorOr<NonnullOwnPtr<Watch>> {
+        auto watch = state.watches.take(fd);
+        if (!watch.has_value())
+            return ENOENT;
+        watch.value()->is_removed = true;
+        state.ready_list.remove(*watch.value());
+        return watch.release_value();
+    }));
+    forget_watch(move(watch));
+    return {};
+}
+
+void EventQueue::collect_ready_events(Vector<ReadyEvent>& events, size_t max_events)
+{
+    // NOTE: Neither the references we take nor the watches whose descriptions went away may be released while we're
+    //       holding the state lock, since that could end up calling back into us.
+    Vector<NonnullLockRefPtr<OpenFileDescription>, 16> descriptions;
+    Vector<NonnullOwnPtr<Watch>> dead_watches;
+
+    m_state.with([&](auto& state) {
+        // Everything on the ready list *may* be ready, so check that now. Whatever turns out not to be ready is dropped
+        // from the list until its file tells us that something changed again.
+        IntrusiveList<&Watch::ready_list_node> still_ready;
+        while (events.size() < max_events) {
+            // Make room up front, so that a failed allocation can't make us drop anything while holding the lock.
+            if (descriptions.try_ensure_capacity(descriptions.size() + 1).is_error() || dead_watches.try_ensure_capacity(dead_watches.size() + 1).is_error())
+                break;
+            auto* watch = state.ready_list.take_first();
+            if (!watch)
+                break;
+            auto description = watch->description.strong_ref();
+            if (!description) {
+                // All file descriptors referring to the description have been closed.
+                watch->is_removed = true;
+                auto dead_watch = state.watches.take(watch->fd);
+                VERIFY(dead_watch.has_value() && dead_watch.value().ptr() == watch);
+                dead_watches.unchecked_append(dead_watch.release_value());
+                continue;
+            }
+            auto ready = description->should_unblock(watch->interest);
+            descriptions.unchecked_append(description.release_nonnull());
+            if (ready == BlockFlags::None)
+                continue;
+            events.unchecked_append({ watch->fd, watch->interest, ready });
+            switch (watch->trigger) {
+            case Trigger::Level:
+                still_ready.append(*watch);
+                break;
+            case Trigger::Edge:
+                break;
+            case Trigger::OneShot:
+                watch->is_disarmed = true;
+                break;
+            }
+        }
+
+        // These will most likely still be ready next time, but check the ones we didn't get to this time first.
+        while (auto* watch = still_ready.take_first())
+            state.ready_list.append(*watch);
+    });
+
+    for (auto& watch : dead_watches)
+        forget_watch(move(watch));
+}
+
+ErrorOr<NonnullOwnPtr<KString>> EventQueue::pseudo_path(OpenFileDescription const&) const
+{
+    return m_state.with([](auto& state) -> ErrorOr<NonnullOwnPtr<KString>> {
+        return KString::formatted("EventQueue:({})", state.watches.size());
+    });
+}
+
+}
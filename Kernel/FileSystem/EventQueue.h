@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/IntrusiveList.h>
+#include <AK/NonnullOwnPtr.h>
+#include <Kernel/FileSystem/File.h>
+#include <Kernel/Forward.h>
+#include <Kernel/Library/LockWeakPtr.h>
+#include <Kernel/Locking/Mutex.h>
+#include <Kernel/Locking/SpinlockProtected.h>
+#include <Kernel/Tasks/Thread.h>
+
+namespace Kernel {
+
+// A persistent set of file descriptions to wait on, like poll() without having to pass every description again on
+// every call. Each watched description tells us when its blocking conditions may have changed, which puts it on the
+// ready list. Waiting only has to look at the descriptions on that list, so it doesn't get slower with the number of
+// descriptions that are being watched. By default, readiness is level-triggered, the same as with poll().
+//
+// Watches don't keep their descriptions alive. Once the last file descriptor referring to a watched description has
+// been closed, its watch is dropped from the queue.
+//
+// The event queue itself is readable while its ready list isn't empty, so it can also be waited on with poll().
+class EventQueue final : public File {
+public:
+    using BlockFlags = Thread::FileBlocker::BlockFlags;
+
+    static ErrorOr<NonnullRefPtr<EventQueue>> try_create();
+    virtual ~EventQueue() override;
+
+    virtual bool can_read(OpenFileDescription const&, u64) const override;
+    virtual bool can_write(OpenFileDescription const&, u64) const override { return true; }
+    // Events are retrieved with event_queue_wait() instead.
+    virtual ErrorOr<size_t> read(OpenFileDescription&, u64, UserOrKernelBuffer&, size_t) override { return EINVAL; }
+    virtual ErrorOr<size_t> write(OpenFileDescription&, u64, UserOrKernelBuffer const&, size_t) override { return EINVAL; }
+    virtual ErrorOr<void> close() override;
+
+    virtual ErrorOr<NonnullOwnPtr<KString>> pseudo_path(OpenFileDescription const&) const override;
+    virtual StringView class_name() const override { return "EventQueue"sv; }
+    virtual bool is_event_queue() const override { return true; }
+
+    enum class Trigger {
+        // Reported every time we wait, for as long as the description is ready.
+        Level,
+        // Reported once each time the description's blocking conditions change and it turns out to be ready.
+        Edge,
+        // Reported once, then ignored until it's modified again.
+        OneShot,
+    };
+
+    ErrorOr<void> add(int fd, NonnullRefPtr<OpenFileDescription>, BlockFlags, Trigger);
+    ErrorOr<void> modify(int fd, BlockFlags, Trigger);
+    ErrorOr<void> remove(int fd);
+
+    struct ReadyEvent {
+        int fd { -1 };
+        BlockFlags interest { BlockFlags::None };
+        BlockFlags ready { BlockFlags::None };
+    };
+
+    // Appends the watched descriptions that are ready right now to the vector, which must have room for max_events.
+    void collect_ready_events(Vector<ReadyEvent>&, size_t max_events);
+
+private:
+    EventQueue() = default;
+
+    class Watch final : public FileBlockerSet::Listener {
+    public:
+        Watch(EventQueue&, int fd, LockWeakPtr<OpenFileDescription>, File&, BlockFlags, Trigger);
+
+        virtual void block_conditions_may_have_changed() override;
+
+        EventQueue& queue;
+        int const fd;
+        LockWeakPtr<OpenFileDescription> const description;
+        // We're registered with this file's blocker set, so it has to outlive us.
+        NonnullRefPtr<File> const file;
+
+        // These are protected by the event queue's state lock.
+        BlockFlags interest;
+        Trigger trigger;
+        bool is_disarmed { false };
+        bool is_removed { false };
+        IntrusiveListNode<Watch> ready_list_node;
+    };
+
+    void put_on_ready_list(Watch&);
+    void forget_watch(NonnullOwnPtr<Watch>);
+
+    struct State {
+        HashMap<int, NonnullOwnPtr<Watch>> watches;
+        IntrusiveList<&Watch::ready_list_node> ready_list;
+    };
+    SpinlockProtected<State, LockRank::None> m_state;
+
+    // Serializes adding and removing watches, so a watch can't go away while we're still registering it.
+    Mutex m_control_lock { "EventQueue"sv };
+};
+
+}
@@ -588,9 +588,37 @@ ErrorOr<size_t> Ext2FSInode::read_bytes_locked(off_t offset, size_t count, UserO
         nread += num_bytes_to_copy;
     }
 
+    if (allow_cache && description && nread > 0)
+        schedule_read_ahead_locked(*description, offset, nread);
+
     return nread;
 }
 
+void Ext2FSInode::schedule_read_ahead_locked(OpenFileDescription& description, off_t offset, size_t count) const
+{
+    VERIFY(m_inode_lock.is_locked());
+    auto range = description.record_read_for_read_ahead(offset, count, size());
+    if (!range.has_value())
+        return;
+
+    auto block_size = fs().logical_block_size();
+    auto first_block_logical_index = range->offset / block_size;
+    auto last_block_logical_index = min((range->offset + range->size - 1) / block_size, static_cast<u64>(m_block_list.size() - 1));
+
+    Vector<BlockBasedFileSystem::BlockIndex> blocks;
+    for (auto logical_index = first_block_logical_index; logical_index <= last_block_logical_index; ++logical_index) {
+        auto block_index = m_block_list[logical_index];
+        // Holes don't need to be read from anywhere.
+        if (block_index.value() == 0)
+            continue;
+        if (blocks.try_append(block_index).is_error())
+            return;
+    }
+
+    dbgln_if(EXT2_VERY_DEBUG, "Ext2FSInode[{}]::schedule_read_ahead_locked(): Reading ahead {} blocks at offset {}", identifier(), blocks.size(), range->offset);
+    fs().schedule_read_ahead(move(blocks));
+}
+
 ErrorOr<void> Ext2FSInode::resize(u64 new_size)
 {
     auto old_size = size();
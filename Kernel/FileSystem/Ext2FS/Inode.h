@@ -56,6 +56,7 @@ private:
     ErrorOr<void> flush_block_list();
 
     ErrorOr<void> compute_block_list_with_exclusive_locking();
+    void schedule_read_ahead_locked(OpenFileDescription&, off_t offset, size_t count) const;
     ErrorOr<Vector<BlockBasedFileSystem::BlockIndex>> compute_block_list() const;
     ErrorOr<Vector<BlockBasedFileSystem::BlockIndex>> compute_block_list_with_meta_blocks() const;
     ErrorOr<Vector<BlockBasedFileSystem::BlockIndex>> compute_block_list_impl(bool include_block_list_blocks) const;
@@ -8,6 +8,7 @@
 
 #include <AK/AtomicRefCounted.h>
 #include <AK/Error.h>
+#include <AK/IntrusiveList.h>
 #include <AK/StringView.h>
 #include <AK/Types.h>
 #include <Kernel/Forward.h>
@@ -32,6 +33,30 @@ public:
         return !blocker.unblock_if_conditions_are_met(true, data);
     }
 
+    // Unlike a blocker, a listener stays registered until it's removed, and gets told every time the blocking
+    // conditions of the file may have changed. This is called with the blocker set locked.
+    class Listener {
+    public:
+        virtual ~Listener() = default;
+        virtual void block_conditions_may_have_changed() = 0;
+
+    private:
+        friend class FileBlockerSet;
+        IntrusiveListNode<Listener> m_list_node;
+    };
+
+    void add_listener(Listener& listener)
+    {
+        SpinlockLocker lock(m_lock);
+        m_listeners.append(listener);
+    }
+
+    void remove_listener(Listener& listener)
+    {
+        SpinlockLocker lock(m_lock);
+        m_listeners.remove(listener);
+    }
+
     void unblock_all_blockers_whose_conditions_are_met()
     {
         SpinlockLocker lock(m_lock);
@@ -40,7 +65,12 @@ public:
             auto& blocker = static_cast<Thread::FileBlocker&>(b);
             return blocker.unblock_if_conditions_are_met(false, data);
         });
+        for (auto& listener : m_listeners)
+            listener.block_conditions_may_have_changed();
     }
+
+private:
+    IntrusiveList<&Listener::m_list_node> m_listeners;
 };
 
 // File is the base class for anything that can be referenced by a OpenFileDescription.
@@ -114,6 +144,7 @@ public:
     virtual bool is_character_device() const { return false; }
     virtual bool is_socket() const { return false; }
     virtual bool is_inode_watcher() const { return false; }
+    virtual bool is_event_queue() const { return false; }
     virtual bool is_mount_file() const { return false; }
 
     virtual bool is_regular_file() const { return false; }
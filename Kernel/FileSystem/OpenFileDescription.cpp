@@ -11,6 +11,7 @@
 #include <Kernel/Devices/TTY/MasterPTY.h>
 #include <Kernel/Devices/TTY/TTY.h>
 #include <Kernel/FileSystem/Custody.h>
+#include <Kernel/FileSystem/EventQueue.h>
 #include <Kernel/FileSystem/FIFO.h>
 #include <Kernel/FileSystem/InodeFile.h>
 #include <Kernel/FileSystem/InodeWatcher.h>
@@ -61,6 +62,9 @@ OpenFileDescription::~OpenFileDescription()
 
     if (m_inode)
         m_inode->remove_flocks_for_description(*this);
+
+    // Let anyone watching us (like event queues) know that we're gone.
+    m_file->blocker_set().unblock_all_blockers_whose_conditions_are_met();
 }
 
 ErrorOr<void> OpenFileDescription::attach()
@@ -109,6 +113,7 @@ ErrorOr<off_t> OpenFileDescription::seek(off_t offset, int whence)
     if (!m_file->is_seekable())
         return ESPIPE;
 
+    MutexLocker offset_locker(m_offset_lock);
     auto metadata = this->metadata();
 
     auto new_offset = TRY(m_state.with([&](auto& state) -> ErrorOr<off_t> {
@@ -163,6 +168,10 @@ ErrorOr<size_t> OpenFileDescription::write(u64 offset, UserOrKernelBuffer const&
 
 ErrorOr<size_t> OpenFileDescription::read(UserOrKernelBuffer& buffer, size_t count)
 {
+    MutexLocker offset_locker;
+    if (m_file->is_seekable())
+        offset_locker.attach_and_lock(m_offset_lock);
+
     auto offset = TRY(m_state.with([&](auto& state) -> ErrorOr<off_t> {
         if (Checked<off_t>::addition_would_overflow(state.current_offset, count))
             return EOVERFLOW;
@@ -177,6 +186,10 @@ ErrorOr<size_t> OpenFileDescription::read(UserOrKernelBuffer& buffer, size_t cou
 
 ErrorOr<size_t> OpenFileDescription::write(UserOrKernelBuffer const& data, size_t size)
 {
+    MutexLocker offset_locker;
+    if (m_file->is_seekable())
+        offset_locker.attach_and_lock(m_offset_lock);
+
     auto offset = TRY(m_state.with([&](auto& state) -> ErrorOr<off_t> {
         if (Checked<off_t>::addition_would_overflow(state.current_offset, size))
             return EOVERFLOW;
@@ -314,6 +327,18 @@ InodeWatcher* OpenFileDescription::inode_watcher()
     return static_cast<InodeWatcher*>(m_file.ptr());
 }
 
+bool OpenFileDescription::is_event_queue() const
+{
+    return m_file->is_event_queue();
+}
+
+EventQueue* OpenFileDescription::event_queue()
+{
+    if (!is_event_queue())
+        return nullptr;
+    return static_cast<EventQueue*>(m_file.ptr());
+}
+
 bool OpenFileDescription::is_mount_file() const
 {
     return m_file->is_mount_file();
@@ -499,6 +524,38 @@ bool OpenFileDescription::is_direct() const
     return m_state.with([](auto& state) { return state.direct; });
 }
 
+Optional<OpenFileDescription::ReadAheadRange> OpenFileDescription::record_read_for_read_ahead(u64 offset, size_t count, u64 file_size)
+{
+    static constexpr size_t initial_read_ahead_window = 32 * KiB;
+    static constexpr size_t maximum_read_ahead_window = 512 * KiB;
+
+    return m_state.with([&](auto& state) -> Optional<ReadAheadRange> {
+        auto end_offset = offset + count;
+        bool is_sequential = offset == state.next_sequential_read_offset;
+        state.next_sequential_read_offset = end_offset;
+
+        if (!is_sequential) {
+            state.read_ahead_window = 0;
+            state.read_ahead_end_offset = 0;
+            return {};
+        }
+
+        // Wait until the reader has consumed half of what we read ahead last time before reading further.
+        if (state.read_ahead_window != 0 && end_offset + state.read_ahead_window / 2 < state.read_ahead_end_offset)
+            return {};
+
+        // Keep doubling the window for as long as the reader stays sequential.
+        state.read_ahead_window = state.read_ahead_window == 0 ? initial_read_ahead_window : min(state.read_ahead_window * 2, maximum_read_ahead_window);
+
+        auto read_ahead_start = max(end_offset, state.read_ahead_end_offset);
+        auto read_ahead_end = min(end_offset + state.read_ahead_window, file_size);
+        if (read_ahead_start >= read_ahead_end)
+            return {};
+        state.read_ahead_end_offset = read_ahead_end;
+        return ReadAheadRange { read_ahead_start, static_cast<size_t>(read_ahead_end - read_ahead_start) };
+    });
+}
+
 bool OpenFileDescription::is_directory() const
 {
     return m_state.with([](auto& state) { return state.is_directory; });
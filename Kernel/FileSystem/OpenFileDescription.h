@@ -15,6 +15,8 @@
 #include <Kernel/FileSystem/InodeMetadata.h>
 #include <Kernel/Forward.h>
 #include <Kernel/Library/KBuffer.h>
+#include <Kernel/Library/LockWeakable.h>
+#include <Kernel/Locking/Mutex.h>
 #include <Kernel/Memory/VirtualAddress.h>
 
 namespace Kernel {
@@ -24,7 +26,8 @@ public:
     virtual ~OpenFileDescriptionData() = default;
 };
 
-class OpenFileDescription final : public AtomicRefCounted<OpenFileDescription> {
+class OpenFileDescription final : public AtomicRefCounted<OpenFileDescription>
+    , public LockWeakable<OpenFileDescription> {
 public:
     static ErrorOr<NonnullRefPtr<OpenFileDescription>> try_create(Custody&);
     static ErrorOr<NonnullRefPtr<OpenFileDescription>> try_create(File&);
@@ -63,6 +66,14 @@ public:
 
     bool is_direct() const;
 
+    struct ReadAheadRange {
+        u64 offset { 0 };
+        size_t size { 0 };
+    };
+    // Records a read from the underlying inode. If this description is being read sequentially,
+    // returns the part of the file that should be read ahead of the reader.
+    Optional<ReadAheadRange> record_read_for_read_ahead(u64 offset, size_t count, u64 file_size);
+
     bool is_directory() const;
 
     File& file() { return *m_file; }
@@ -80,6 +91,9 @@ public:
     InodeWatcher const* inode_watcher() const;
     InodeWatcher* inode_watcher();
 
+    bool is_event_queue() const;
+    EventQueue* event_queue();
+
     bool is_mount_file() const;
     MountFile const* mount_file() const;
     MountFile* mount_file();
@@ -124,6 +138,11 @@ public:
 
     off_t offset() const;
 
+    // Held by reads, writes and seeks that use the current offset of a seekable file, so that threads sharing this
+    // description can't both read (or write) at the same offset. Callers that need several of those operations to
+    // happen as one (like an appending write) can hold it across them.
+    Mutex& offset_lock() { return m_offset_lock; }
+
     ErrorOr<void> chown(Credentials const& credentials, UserID, GroupID);
 
     FileBlockerSet& blocker_set();
@@ -149,6 +168,9 @@ private:
         OwnPtr<OpenFileDescriptionData> data;
         RefPtr<Custody> custody;
         off_t current_offset { 0 };
+        u64 next_sequential_read_offset { 0 };
+        u64 read_ahead_end_offset { 0 };
+        size_t read_ahead_window { 0 };
         u32 file_flags { 0 };
         bool readable : 1 { false };
         bool writable : 1 { false };
@@ -160,5 +182,6 @@ private:
     };
 
     SpinlockProtected<State, LockRank::None> m_state {};
+    Mutex m_offset_lock { "OpenFileDescription offset"sv };
 };
 }
@@ -12,6 +12,7 @@
 #include <Kernel/FileSystem/SysFS/Subsystems/Kernel/Configuration/Directory.h>
 #include <Kernel/FileSystem/SysFS/Subsystems/Kernel/ConstantInformation.h>
 #include <Kernel/FileSystem/SysFS/Subsystems/Kernel/Directory.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/DiskCache.h>
 #include <Kernel/FileSystem/SysFS/Subsystems/Kernel/DiskUsage.h>
 #include <Kernel/FileSystem/SysFS/Subsystems/Kernel/GlobalInformation.h>
 #include <Kernel/FileSystem/SysFS/Subsystems/Kernel/Interrupts.h>
@@ -34,6 +35,7 @@ UNMAP_AFTER_INIT NonnullRefPtr<SysFSGlobalKernelStatsDirectory> SysFSGlobalKerne
     auto global_kernel_stats_directory = adopt_ref_if_nonnull(new (nothrow) SysFSGlobalKernelStatsDirectory(root_directory)).release_nonnull();
     MUST(global_kernel_stats_directory->m_child_components.with([&](auto& list) -> ErrorOr<void> {
         list.append(SysFSDiskUsage::must_create(*global_kernel_stats_directory));
+        list.append(SysFSDiskCache::must_create(*global_kernel_stats_directory));
         list.append(SysFSMemoryStatus::must_create(*global_kernel_stats_directory));
         list.append(SysFSSystemStatistics::must_create(*global_kernel_stats_directory));
         list.append(SysFSOverallProcesses::must_create(*global_kernel_stats_directory));
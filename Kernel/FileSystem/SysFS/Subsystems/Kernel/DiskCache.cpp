@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/JsonObjectSerializer.h>
+#include <Kernel/FileSystem/BlockBasedFileSystem.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/DiskCache.h>
+#include <Kernel/FileSystem/VirtualFileSystem.h>
+#include <Kernel/Sections.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT NonnullRefPtr<SysFSDiskCache> SysFSDiskCache::must_create(SysFSDirectory const& parent_directory)
+{
+    return adopt_ref_if_nonnull(new (nothrow) SysFSDiskCache(parent_directory)).release_nonnull();
+}
+
+UNMAP_AFTER_INIT SysFSDiskCache::SysFSDiskCache(SysFSDirectory const& parent_directory)
+    : SysFSGlobalInformation(parent_directory)
+{
+}
+
+ErrorOr<void> SysFSDiskCache::try_generate(KBufferBuilder& builder)
+{
+    auto json = TRY(JsonObjectSerializer<>::try_create(builder));
+    auto budget = BlockBasedFileSystem::disk_cache_budget();
+    TRY(json.add("budget"sv, budget.size));
+    TRY(json.add("budget_used"sv, budget.used_size));
+    auto array = TRY(json.add_array("file_systems"sv));
+    TRY(VirtualFileSystem::the().for_each_mount([&array](auto& mount) -> ErrorOr<void> {
+        auto& fs = mount.guest_fs();
+        if (!fs.is_block_based())
+            return {};
+        auto statistics = static_cast<BlockBasedFileSystem const&>(fs).disk_cache_statistics();
+        auto fs_object = TRY(array.add_object());
+        TRY(fs_object.add("fsid"sv, fs.fsid().value()));
+        TRY(fs_object.add("class_name"sv, fs.class_name()));
+        auto mount_point = TRY(mount.absolute_path());
+        TRY(fs_object.add("mount_point"sv, mount_point->view()));
+        TRY(fs_object.add("block_size"sv, static_cast<u64>(fs.logical_block_size())));
+        TRY(fs_object.add("shards"sv, statistics.shard_count));
+        TRY(fs_object.add("segments"sv, statistics.segments));
+        TRY(fs_object.add("capacity"sv, statistics.capacity));
+        TRY(fs_object.add("cached_blocks"sv, statistics.cached_blocks));
+        TRY(fs_object.add("dirty_blocks"sv, statistics.dirty_blocks));
+        TRY(fs_object.add("hits"sv, statistics.hits));
+        TRY(fs_object.add("misses"sv, statistics.misses));
+        TRY(fs_object.add("evictions"sv, statistics.evictions));
+        TRY(fs_object.add("read_ahead_blocks"sv, statistics.read_ahead_blocks));
+        TRY(fs_object.finish());
+        return {};
+    }));
+    TRY(array.finish());
+    TRY(json.finish());
+    return {};
+}
+
+}
@@ -37,6 +37,19 @@ ErrorOr<void> SysFSMemoryStatus::try_generate(KBufferBuilder& builder)
     TRY(json.add("physical_uncommitted"sv, system_memory.physical_pages_uncommitted));
     TRY(json.add("kmalloc_call_count"sv, stats.kmalloc_call_count));
     TRY(json.add("kfree_call_count"sv, stats.kfree_call_count));
+    auto kmalloc_per_cpu = TRY(json.add_array("kmalloc_per_cpu"sv));
+    for (u32 processor = 0; processor < Processor::count(); ++processor) {
+        kmalloc_processor_stats processor_stats;
+        get_kmalloc_processor_stats(processor, processor_stats);
+        auto obj = TRY(kmalloc_per_cpu.add_object());
+        TRY(obj.add("kmalloc_call_count"sv, processor_stats.kmalloc_call_count));
+        TRY(obj.add("kfree_call_count"sv, processor_stats.kfree_call_count));
+        TRY(obj.add("magazine_refill_count"sv, processor_stats.magazine_refill_count));
+        TRY(obj.add("magazine_drain_count"sv, processor_stats.magazine_drain_count));
+        TRY(obj.add("cached"sv, processor_stats.bytes_cached));
+        TRY(obj.finish());
+    }
+    TRY(kmalloc_per_cpu.finish());
     TRY(json.finish());
     return {};
 }
@@ -267,6 +267,18 @@ void VirtualFileSystem::sync_filesystems()
     }
 }
 
+void VirtualFileSystem::release_file_system_cache_memory()
+{
+    Vector<NonnullRefPtr<FileSystem>, 32> file_systems;
+    m_file_systems_list.with([&](auto const& list) {
+        for (auto& fs : list)
+            file_systems.append(fs);
+    });
+
+    for (auto& fs : file_systems)
+        fs->release_cache_memory();
+}
+
 void VirtualFileSystem::lock_all_filesystems()
 {
     Vector<NonnullRefPtr<FileSystem>, 32> file_systems;
@@ -89,6 +89,7 @@ public:
     ErrorOr<void> for_each_mount(Function<ErrorOr<void>(Mount const&)>) const;
 
     void sync_filesystems();
+    void release_file_system_cache_memory();
     void lock_all_filesystems();
 
     static void sync();
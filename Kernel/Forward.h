@@ -21,6 +21,7 @@ class Custody;
 class Device;
 class DiskCache;
 class DoubleBuffer;
+class EventQueue;
 class File;
 class FATInode;
 class OpenFileDescription;
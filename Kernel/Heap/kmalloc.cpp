@@ -10,6 +10,7 @@
 #include <Kernel/Debug.h>
 #include <Kernel/Heap/Heap.h>
 #include <Kernel/Heap/kmalloc.h>
+#include <Kernel/Interrupts/InterruptDisabler.h>
 #include <Kernel/KSyms.h>
 #include <Kernel/Library/Panic.h>
 #include <Kernel/Library/StdLib.h>
@@ -113,6 +114,34 @@ private:
     [[gnu::aligned(16)]] u8 m_data[];
 };
 
+// A small stack of free slabs of one size, owned by a single processor.
+// Allocations and frees of that size are served from it without taking the global kmalloc lock; only when it runs
+// empty (or full) does its processor go to the shared slabheap, which acts as the depot, and move a batch of slabs.
+class KmallocMagazine {
+public:
+    static constexpr size_t capacity = 32;
+
+    bool is_empty() const { return m_count == 0; }
+    bool is_full() const { return m_count == capacity; }
+    size_t count() const { return m_count; }
+
+    void* pop()
+    {
+        VERIFY(!is_empty());
+        return m_slabs[--m_count];
+    }
+
+    void push(void* ptr)
+    {
+        VERIFY(!is_full());
+        m_slabs[m_count++] = ptr;
+    }
+
+private:
+    size_t m_count { 0 };
+    void* m_slabs[capacity] {};
+};
+
 class KmallocSlabheap {
 public:
     KmallocSlabheap(size_t slab_size)
@@ -157,6 +186,24 @@ public:
             m_usable_blocks.append(*block);
     }
 
+    // Both of these leave the magazine half full, so that its processor can go on allocating and freeing for a while
+    // before it has to come back here.
+    void refill(KmallocMagazine& magazine)
+    {
+        while (magazine.count() < KmallocMagazine::capacity / 2) {
+            auto* ptr = allocate(CallerWillInitializeMemory::Yes);
+            if (!ptr)
+                return;
+            magazine.push(ptr);
+        }
+    }
+
+    void drain(KmallocMagazine& magazine, size_t count_to_keep = KmallocMagazine::capacity / 2)
+    {
+        while (magazine.count() > count_to_keep)
+            deallocate(magazine.pop());
+    }
+
     size_t allocated_bytes() const
     {
         size_t total = m_full_blocks.size_slow() * KmallocSlabBlock::block_size;
@@ -205,6 +252,8 @@ private:
     KmallocSlabBlock::List m_full_blocks;
 };
 
+static void drain_magazines_before_purge();
+
 struct KmallocGlobalData {
     static constexpr size_t minimum_subheap_size = 1 * MiB;
 
@@ -221,6 +270,24 @@ struct KmallocGlobalData {
         subheaps.append(*subheap);
     }
 
+    Optional<size_t> slabheap_index_for_allocation(size_t size, size_t alignment) const
+    {
+        for (size_t i = 0; i < slabheap_count; ++i) {
+            if (size <= slabheaps[i].slab_size() && alignment <= slabheaps[i].slab_size())
+                return i;
+        }
+        return {};
+    }
+
+    Optional<size_t> slabheap_index_for_deallocation(size_t size) const
+    {
+        for (size_t i = 0; i < slabheap_count; ++i) {
+            if (size <= slabheaps[i].slab_size())
+                return i;
+        }
+        return {};
+    }
+
     void* allocate(size_t size, size_t alignment, CallerWillInitializeMemory caller_will_initialize_memory)
     {
         VERIFY(!expansion_in_progress);
@@ -239,6 +306,7 @@ struct KmallocGlobalData {
         if (size <= KmallocSlabBlock::block_size * 2 + sizeof(ptrdiff_t) + sizeof(size_t)) {
             // FIXME: We should propagate a freed pointer, to find the specific subheap it belonged to
             //        This would save us iterating over them in the next step and remove a recursion
+            drain_magazines_before_purge();
             bool did_purge = false;
             for (auto& slabheap : slabheaps) {
                 if (slabheap.try_purge()) {
@@ -394,7 +462,8 @@ struct KmallocGlobalData {
 
     KmallocSubheap::List subheaps;
 
-    KmallocSlabheap slabheaps[6] = { 16, 32, 64, 128, 256, 512 };
+    static constexpr size_t slabheap_count = 6;
+    KmallocSlabheap slabheaps[slabheap_count] = { 16, 32, 64, 128, 256, 512 };
 
     bool expansion_in_progress { false };
 };
@@ -402,9 +471,99 @@ struct KmallocGlobalData {
 READONLY_AFTER_INIT static KmallocGlobalData* g_kmalloc_global;
 alignas(KmallocGlobalData) static u8 g_kmalloc_global_heap[sizeof(KmallocGlobalData)];
 
-static size_t g_kmalloc_call_count;
-static size_t g_kfree_call_count;
-static size_t g_nested_kfree_calls;
+// Everything in here is only touched by its own processor, with interrupts disabled.
+struct KmallocProcessorData {
+    void* allocate(size_t slabheap_index, CallerWillInitializeMemory caller_will_initialize_memory)
+    {
+        auto& magazine = magazines[slabheap_index];
+        auto& slabheap = g_kmalloc_global->slabheaps[slabheap_index];
+        if (magazine.is_empty()) {
+            SpinlockLocker lock(s_lock);
+            ++magazine_refill_count;
+            slabheap.refill(magazine);
+            if (magazine.is_empty()) {
+                dbgln_if(KMALLOC_DEBUG, "OOM while refilling kmalloc magazine ({})", slabheap.slab_size());
+                return nullptr;
+            }
+        }
+        auto* ptr = magazine.pop();
+        if (caller_will_initialize_memory == CallerWillInitializeMemory::No)
+            memset(ptr, KMALLOC_SCRUB_BYTE, slabheap.slab_size());
+        return ptr;
+    }
+
+    void deallocate(size_t slabheap_index, void* ptr)
+    {
+        auto& magazine = magazines[slabheap_index];
+        auto& slabheap = g_kmalloc_global->slabheaps[slabheap_index];
+        memset(ptr, KFREE_SCRUB_BYTE, slabheap.slab_size());
+        if (magazine.is_full()) {
+            SpinlockLocker lock(s_lock);
+            ++magazine_drain_count;
+            slabheap.drain(magazine);
+        }
+        magazine.push(ptr);
+    }
+
+    // Gives every cached slab back to its slabheap, so that their blocks can be purged. Must be called with the
+    // kmalloc lock held, on this processor.
+    void drain_all_magazines()
+    {
+        VERIFY(s_lock.is_locked());
+        for (size_t i = 0; i < KmallocGlobalData::slabheap_count; ++i) {
+            if (magazines[i].is_empty())
+                continue;
+            ++magazine_drain_count;
+            g_kmalloc_global->slabheaps[i].drain(magazines[i], 0);
+        }
+    }
+
+    void drain_all_magazines_if_requested()
+    {
+        if (!should_drain_magazines.load(AK::MemoryOrder::memory_order_relaxed)) [[likely]]
+            return;
+        SpinlockLocker lock(s_lock);
+        should_drain_magazines.store(false, AK::MemoryOrder::memory_order_relaxed);
+        drain_all_magazines();
+    }
+
+    size_t cached_bytes() const
+    {
+        size_t total = 0;
+        for (size_t i = 0; i < KmallocGlobalData::slabheap_count; ++i)
+            total += magazines[i].count() * g_kmalloc_global->slabheaps[i].slab_size();
+        return total;
+    }
+
+    KmallocMagazine magazines[KmallocGlobalData::slabheap_count];
+
+    size_t kmalloc_call_count { 0 };
+    size_t kfree_call_count { 0 };
+    size_t nested_kfree_calls { 0 };
+    size_t magazine_refill_count { 0 };
+    size_t magazine_drain_count { 0 };
+
+    // Set by other processors that want to purge slabheap blocks while some of their slabs are cached here.
+    Atomic<bool> should_drain_magazines { false };
+};
+
+// This has to be in place before the global constructors run, since kmalloc is used long before that.
+constinit static Array<KmallocProcessorData, MAX_CPU_COUNT> s_processor_data;
+
+// A slabheap block can only be purged once all of its slabs are free, which they aren't while they sit in a magazine.
+// We can't touch the other processors' magazines, so we give back our own slabs right away and have the others give back
+// theirs the next time they call into kmalloc, for a later purge to pick up.
+static void drain_magazines_before_purge()
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    auto current_processor = Processor::current_id();
+    for (u32 processor = 0; processor < Processor::count(); ++processor) {
+        if (processor != current_processor)
+            s_processor_data[processor].should_drain_magazines.store(true, AK::MemoryOrder::memory_order_relaxed);
+    }
+    s_processor_data[current_processor].drain_all_magazines();
+}
+
 bool g_dump_kmalloc_stacks;
 
 void kmalloc_enable_expand()
@@ -431,15 +590,25 @@ static void* kmalloc_impl(size_t size, size_t alignment, CallerWillInitializeMem
     // Alignment must be a power of two.
     VERIFY(is_power_of_two(alignment));
 
-    SpinlockLocker lock(s_lock);
-    ++g_kmalloc_call_count;
+    // Keeps us on this processor, and keeps interrupt handlers from using its magazines while we do.
+    InterruptDisabler disabler;
+    auto& processor_data = s_processor_data[Processor::current_id()];
+    ++processor_data.kmalloc_call_count;
+    processor_data.drain_all_magazines_if_requested();
 
     if (g_dump_kmalloc_stacks && Kernel::g_kernel_symbols_available) {
+        SpinlockLocker lock(s_lock);
         dbgln("kmalloc({})", size);
         Kernel::dump_backtrace();
     }
 
-    void* ptr = g_kmalloc_global->allocate(size, alignment, caller_will_initialize_memory);
+    void* ptr = nullptr;
+    if (auto slabheap_index = g_kmalloc_global->slabheap_index_for_allocation(size, alignment); slabheap_index.has_value()) {
+        ptr = processor_data.allocate(slabheap_index.value(), caller_will_initialize_memory);
+    } else {
+        SpinlockLocker lock(s_lock);
+        ptr = g_kmalloc_global->allocate(size, alignment, caller_will_initialize_memory);
+    }
 
     Thread* current_thread = Thread::current();
     if (!current_thread)
@@ -482,11 +651,13 @@ void kfree_sized(void* ptr, size_t size)
         Processor::verify_no_spinlocks_held();
     }
 
-    SpinlockLocker lock(s_lock);
-    ++g_kfree_call_count;
-    ++g_nested_kfree_calls;
+    InterruptDisabler disabler;
+    auto& processor_data = s_processor_data[Processor::current_id()];
+    ++processor_data.kfree_call_count;
+    ++processor_data.nested_kfree_calls;
+    processor_data.drain_all_magazines_if_requested();
 
-    if (g_nested_kfree_calls == 1) {
+    if (processor_data.nested_kfree_calls == 1) {
         Thread* current_thread = Thread::current();
         if (!current_thread)
             current_thread = Processor::idle_thread();
@@ -496,8 +667,14 @@ void kfree_sized(void* ptr, size_t size)
         }
     }
 
-    g_kmalloc_global->deallocate(ptr, size);
-    --g_nested_kfree_calls;
+    if (auto slabheap_index = g_kmalloc_global->slabheap_index_for_deallocation(size); slabheap_index.has_value()) {
+        VERIFY(g_kmalloc_global->is_valid_kmalloc_address(VirtualAddress { ptr }));
+        processor_data.deallocate(slabheap_index.value(), ptr);
+    } else {
+        SpinlockLocker lock(s_lock);
+        g_kmalloc_global->deallocate(ptr, size);
+    }
+    --processor_data.nested_kfree_calls;
 }
 
 size_t kmalloc_good_size(size_t size)
@@ -581,9 +758,38 @@ void operator delete[](void* ptr, size_t size) noexcept
 
 void get_kmalloc_stats(kmalloc_stats& stats)
 {
+    // NOTE: The other processors keep going while we look at their magazines and counters, so these are only a snapshot.
+    stats.kmalloc_call_count = 0;
+    stats.kfree_call_count = 0;
+    for (u32 processor = 0; processor < Processor::count(); ++processor) {
+        auto const& processor_data = s_processor_data[processor];
+        stats.kmalloc_call_count += processor_data.kmalloc_call_count;
+        stats.kfree_call_count += processor_data.kfree_call_count;
+    }
+
+    // Slabs only move between magazines and their slabheaps with the lock held, so with it held, every slab we count as
+    // cached is also counted as allocated by its slabheap. kmalloc() and kfree() still move slabs in and out of the
+    // magazines while we count, so clamp anyway, to make sure that a torn snapshot can't wrap around.
     SpinlockLocker lock(s_lock);
-    stats.bytes_allocated = g_kmalloc_global->allocated_bytes();
-    stats.bytes_free = g_kmalloc_global->free_bytes();
-    stats.kmalloc_call_count = g_kmalloc_call_count;
-    stats.kfree_call_count = g_kfree_call_count;
+    size_t cached_bytes = 0;
+    for (u32 processor = 0; processor < Processor::count(); ++processor)
+        cached_bytes += s_processor_data[processor].cached_bytes();
+
+    // Slabs sitting in a magazine are free as far as anyone asking is concerned, even though their slabheap has
+    // handed them out.
+    auto allocated_bytes = g_kmalloc_global->allocated_bytes();
+    cached_bytes = min(cached_bytes, allocated_bytes);
+    stats.bytes_allocated = allocated_bytes - cached_bytes;
+    stats.bytes_free = g_kmalloc_global->free_bytes() + cached_bytes;
+}
+
+void get_kmalloc_processor_stats(u32 processor, kmalloc_processor_stats& stats)
+{
+    VERIFY(processor < Processor::count());
+    auto const& processor_data = s_processor_data[processor];
+    stats.kmalloc_call_count = processor_data.kmalloc_call_count;
+    stats.kfree_call_count = processor_data.kfree_call_count;
+    stats.magazine_refill_count = processor_data.magazine_refill_count;
+    stats.magazine_drain_count = processor_data.magazine_drain_count;
+    stats.bytes_cached = processor_data.cached_bytes();
 }
@@ -55,6 +55,15 @@ struct kmalloc_stats {
 };
 void get_kmalloc_stats(kmalloc_stats&);
 
+struct kmalloc_processor_stats {
+    size_t kmalloc_call_count;
+    size_t kfree_call_count;
+    size_t magazine_refill_count;
+    size_t magazine_drain_count;
+    size_t bytes_cached;
+};
+void get_kmalloc_processor_stats(u32 processor, kmalloc_processor_stats&);
+
 extern bool g_dump_kmalloc_stacks;
 
 inline void* operator new(size_t, void* p) { return p; }
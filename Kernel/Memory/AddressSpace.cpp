@@ -81,10 +81,12 @@ ErrorOr<void> AddressSpace::unmap_mmap_range(VirtualAddress addr, size_t size)
         auto new_regions = TRY(try_split_region_around_range(*region, range_to_unmap));
 
         // And finally we map the new region(s) using our page directory (they were just allocated and don't have one).
+        // The unmap() above already flushed this whole range, and nothing was mapped there since, so there is nothing
+        // left in any TLB that we'd have to shoot down again.
         for (auto* new_region : new_regions) {
             // TODO: Ideally we should do this in a way that can be rolled back on failure, as failing here
             // leaves the caller in an undefined state.
-            TRY(new_region->map(page_directory()));
+            TRY(new_region->map(page_directory(), ShouldFlushTLB::No));
         }
 
         PerformanceManager::add_unmap_perf_event(Process::current(), range_to_unmap);
@@ -125,11 +127,11 @@ ErrorOr<void> AddressSpace::unmap_mmap_range(VirtualAddress addr, size_t size)
         TRY(new_regions.try_extend(split_regions));
     }
 
-    // And finally map the new region(s) into our page directory.
+    // And finally map the new region(s) into our page directory. As above, the unmap()s already flushed their ranges.
     for (auto* new_region : new_regions) {
         // TODO: Ideally we should do this in a way that can be rolled back on failure, as failing here
         // leaves the caller in an undefined state.
-        TRY(new_region->map(page_directory()));
+        TRY(new_region->map(page_directory(), ShouldFlushTLB::No));
     }
 
     PerformanceManager::add_unmap_perf_event(Process::current(), range_to_unmap);
@@ -148,6 +150,7 @@ ErrorOr<Region*> AddressSpace::try_allocate_split_region(Region const& source_re
     new_region->set_syscall_region(source_region.is_syscall_region());
     new_region->set_mmap(source_region.is_mmap(), source_region.mmapped_from_readable(), source_region.mmapped_from_writable());
     new_region->set_stack(source_region.is_stack());
+    new_region->set_huge_pages(source_region.wants_huge_pages());
     size_t page_offset_in_source_region = (offset_in_vmobject - source_region.offset_in_vmobject()) / PAGE_SIZE;
     for (size_t i = 0; i < new_region->page_count(); ++i) {
         if (source_region.should_cow(page_offset_in_source_region + i))
@@ -394,6 +397,15 @@ size_t AddressSpace::amount_shared() const
     return amount;
 }
 
+size_t AddressSpace::amount_huge() const
+{
+    size_t amount = 0;
+    for (auto const& region : m_region_tree.regions()) {
+        amount += region.amount_huge();
+    }
+    return amount;
+}
+
 size_t AddressSpace::amount_purgeable_volatile() const
 {
     size_t amount = 0;
@@ -58,6 +58,7 @@ public:
     size_t amount_virtual() const;
     size_t amount_resident() const;
     size_t amount_shared() const;
+    size_t amount_huge() const;
     size_t amount_purgeable_volatile() const;
     size_t amount_purgeable_nonvolatile() const;
 
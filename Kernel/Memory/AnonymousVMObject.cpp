@@ -275,6 +275,52 @@ NonnullRefPtr<PhysicalPage> AnonymousVMObject::allocate_committed_page(Badge<Reg
     return m_unused_committed_pages->take_one();
 }
 
+bool AnonymousVMObject::can_populate_huge_page(size_t first_page_index) const
+{
+    VERIFY(m_lock.is_locked());
+
+    // Pages shared with a fork have to be copied one at a time, so they can't become part of a huge page.
+    if (!m_cow_map.is_null() || m_cow_parent || m_shared_committed_cow_pages || m_volatile)
+        return false;
+
+    for (size_t i = 0; i < PAGES_PER_HUGE_PAGE; ++i) {
+        auto const& page = physical_pages()[first_page_index + i];
+        if (!page || (!page->is_shared_zero_page() && !page->is_lazy_committed_page()))
+            return false;
+    }
+    return true;
+}
+
+bool AnonymousVMObject::try_populate_huge_page(Badge<Region>, size_t first_page_index)
+{
+    VERIFY(first_page_index + PAGES_PER_HUGE_PAGE <= page_count());
+
+    {
+        SpinlockLocker locker(m_lock);
+        if (!can_populate_huge_page(first_page_index))
+            return false;
+    }
+
+    auto pages_or_error = MM.allocate_contiguous_physical_pages(HUGE_PAGE_SIZE, HUGE_PAGE_SIZE);
+    if (pages_or_error.is_error())
+        return false;
+    auto pages = pages_or_error.release_value();
+
+    SpinlockLocker locker(m_lock);
+    // Someone else may have faulted in a page while we were allocating.
+    if (!can_populate_huge_page(first_page_index))
+        return false;
+
+    for (size_t i = 0; i < PAGES_PER_HUGE_PAGE; ++i) {
+        auto& page_slot = physical_pages()[first_page_index + i];
+        // The huge page was allocated from uncommitted memory, so give back what was committed for this slot.
+        if (page_slot->is_lazy_committed_page())
+            m_unused_committed_pages->uncommit_one();
+        page_slot = move(pages[i]);
+    }
+    return true;
+}
+
 ErrorOr<void> AnonymousVMObject::ensure_cow_map()
 {
     if (m_cow_map.is_null())
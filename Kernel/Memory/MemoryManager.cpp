@@ -5,6 +5,7 @@
  */
 
 #include <AK/Assertions.h>
+#include <AK/Singleton.h>
 #include <AK/StringView.h>
 #include <Kernel/Arch/CPU.h>
 #include <Kernel/Arch/PageDirectory.h>
@@ -12,6 +13,7 @@
 #include <Kernel/Arch/RegisterState.h>
 #include <Kernel/Boot/BootInfo.h>
 #include <Kernel/Boot/Multiboot.h>
+#include <Kernel/Debug.h>
 #include <Kernel/FileSystem/Inode.h>
 #include <Kernel/Heap/kmalloc.h>
 #include <Kernel/Interrupts/InterruptDisabler.h>
@@ -25,6 +27,7 @@
 #include <Kernel/Prekernel/Prekernel.h>
 #include <Kernel/Sections.h>
 #include <Kernel/Tasks/Process.h>
+#include <Kernel/Tasks/WaitQueue.h>
 
 extern u8 start_of_kernel_image[];
 extern u8 end_of_kernel_image[];
@@ -604,6 +607,11 @@ PageTableEntry* MemoryManager::pte(PageDirectory& page_directory, VirtualAddress
     PageDirectoryEntry const& pde = pd[page_directory_index];
     if (!pde.is_present())
         return nullptr;
+#if ARCH(X86_64)
+    // Huge pages are mapped without a page table.
+    if (pde.is_huge())
+        return nullptr;
+#endif
 
     return &quickmap_pt(PhysicalAddress((FlatPtr)pde.page_table_base()))[page_table_index];
 }
@@ -617,6 +625,15 @@ PageTableEntry* MemoryManager::ensure_pte(PageDirectory& page_directory, Virtual
     u32 page_table_index = (vaddr.get() >> 12) & 0x1ff;
 
     auto* pd = quickmap_pd(page_directory, page_directory_table_index);
+#if ARCH(X86_64)
+    if (pd[page_directory_index].is_present() && pd[page_directory_index].is_huge()) {
+        // Someone wants to change the mapping of a single page that's part of a huge page,
+        // so we have to break the huge page up into a regular page table first.
+        if (!split_huge_pde(page_directory, vaddr))
+            return nullptr;
+        pd = quickmap_pd(page_directory, page_directory_table_index);
+    }
+#endif
     auto& pde = pd[page_directory_index];
     if (pde.is_present())
         return &quickmap_pt(PhysicalAddress(pde.page_table_base()))[page_table_index];
@@ -660,6 +677,10 @@ void MemoryManager::release_pte(PageDirectory& page_directory, VirtualAddress va
     auto* pd = quickmap_pd(page_directory, page_directory_table_index);
     PageDirectoryEntry& pde = pd[page_directory_index];
     if (pde.is_present()) {
+#if ARCH(X86_64)
+        // Huge pages must be released as a whole with release_huge_pde().
+        VERIFY(!pde.is_huge());
+#endif
         auto* page_table = quickmap_pt(PhysicalAddress((FlatPtr)pde.page_table_base()));
         auto& pte = page_table[page_table_index];
         pte.clear();
@@ -682,6 +703,126 @@ void MemoryManager::release_pte(PageDirectory& page_directory, VirtualAddress va
     }
 }
 
+bool MemoryManager::split_huge_pde(PageDirectory& page_directory, VirtualAddress vaddr)
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    VERIFY(page_directory.get_lock().is_locked_by_current_processor());
+    VERIFY(supports_huge_pages());
+#if ARCH(X86_64)
+    u32 page_directory_table_index = (vaddr.get() >> 30) & 0x1ff;
+    u32 page_directory_index = (vaddr.get() >> 21) & 0x1ff;
+
+    auto page_table_or_error = allocate_physical_page(ShouldZeroFill::No);
+    if (page_table_or_error.is_error()) {
+        dbgln("MM: Unable to allocate page table to split huge page at {}", vaddr);
+        return false;
+    }
+    auto page_table = page_table_or_error.release_value();
+
+    // NOTE: Allocating the page table may have purged memory and remapped the quickmapped page directory.
+    auto& pde = quickmap_pd(page_directory, page_directory_table_index)[page_directory_index];
+    VERIFY(pde.is_present() && pde.is_huge());
+
+    // Every page of the huge page keeps its physical address and its permissions.
+    auto* ptes = quickmap_pt(page_table->paddr());
+    for (size_t i = 0; i < PAGES_PER_HUGE_PAGE; ++i) {
+        auto& pte = ptes[i];
+        pte.clear();
+        pte.set_physical_page_base(pde.page_table_base() + i * PAGE_SIZE);
+        pte.set_present(true);
+        pte.set_writable(pde.is_writable());
+        pte.set_user_allowed(pde.is_user_allowed());
+        pte.set_cache_disabled(pde.is_cache_disabled());
+        pte.set_write_through(pde.is_write_through());
+        pte.set_global(pde.is_global());
+        pte.set_execute_disabled(pde.is_execute_disabled());
+    }
+
+    // Build the new entry before installing it, so other processors never see a non-present page directory entry.
+    PageDirectoryEntry page_table_pde;
+    page_table_pde.clear();
+    page_table_pde.set_page_table_base(page_table->paddr().get());
+    page_table_pde.set_user_allowed(true);
+    page_table_pde.set_present(true);
+    page_table_pde.set_writable(true);
+    page_table_pde.set_global(&page_directory == m_kernel_page_directory.ptr());
+    pde = page_table_pde;
+
+    // NOTE: This leaked ref is matched by the unref in MemoryManager::release_pte()
+    (void)page_table.leak_ref();
+
+    flush_tlb(&page_directory, VirtualAddress { vaddr.get() & ~(HUGE_PAGE_SIZE - 1) }, PAGES_PER_HUGE_PAGE);
+    return true;
+#else
+    (void)page_directory;
+    (void)vaddr;
+    return false;
+#endif
+}
+
+bool MemoryManager::set_huge_pde(PageDirectory& page_directory, VirtualAddress vaddr, PageDirectoryEntry const& huge_pde)
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    VERIFY(page_directory.get_lock().is_locked_by_current_processor());
+    VERIFY(vaddr.get() % HUGE_PAGE_SIZE == 0);
+#if ARCH(X86_64)
+    VERIFY(huge_pde.is_huge());
+    u32 page_directory_table_index = (vaddr.get() >> 30) & 0x1ff;
+    u32 page_directory_index = (vaddr.get() >> 21) & 0x1ff;
+
+    auto& pde = quickmap_pd(page_directory, page_directory_table_index)[page_directory_index];
+    bool const had_page_table = pde.is_present() && !pde.is_huge();
+    auto const page_table_base = pde.page_table_base();
+    pde = huge_pde;
+
+    // The huge page replaces every mapping of the page table, so we can let go of it.
+    if (had_page_table)
+        get_physical_page_entry(PhysicalAddress { page_table_base }).allocated.physical_page.unref();
+    return true;
+#else
+    (void)page_directory;
+    (void)huge_pde;
+    return false;
+#endif
+}
+
+bool MemoryManager::release_huge_pde(PageDirectory& page_directory, VirtualAddress vaddr)
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    VERIFY(page_directory.get_lock().is_locked_by_current_processor());
+#if ARCH(X86_64)
+    u32 page_directory_table_index = (vaddr.get() >> 30) & 0x1ff;
+    u32 page_directory_index = (vaddr.get() >> 21) & 0x1ff;
+
+    auto& pde = quickmap_pd(page_directory, page_directory_table_index)[page_directory_index];
+    if (!pde.is_present() || !pde.is_huge())
+        return false;
+    pde.clear();
+    return true;
+#else
+    (void)page_directory;
+    (void)vaddr;
+    return false;
+#endif
+}
+
+bool MemoryManager::is_mapped_as_huge_page(PageDirectory& page_directory, VirtualAddress vaddr)
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    VERIFY(page_directory.get_lock().is_locked_by_current_processor());
+#if ARCH(X86_64)
+    u32 page_directory_table_index = (vaddr.get() >> 30) & 0x1ff;
+    u32 page_directory_index = (vaddr.get() >> 21) & 0x1ff;
+
+    auto const& pde = quickmap_pd(page_directory, page_directory_table_index)[page_directory_index];
+    return pde.is_present() && pde.is_huge();
+#else
+    (void)page_directory;
+    (void)vaddr;
+    return false;
+#endif
+}
+
 UNMAP_AFTER_INIT void MemoryManager::initialize(u32 cpu)
 {
     dmesgln("Initialize MMU");
@@ -895,7 +1036,9 @@ ErrorOr<NonnullOwnPtr<Region>> MemoryManager::allocate_kernel_region_with_vmobje
 ErrorOr<CommittedPhysicalPageSet> MemoryManager::commit_physical_pages(size_t page_count)
 {
     VERIFY(page_count > 0);
+    SystemMemoryInfo memory_info;
     auto result = m_global_data.with([&](auto& global_data) -> ErrorOr<CommittedPhysicalPageSet> {
+        memory_info = global_data.system_memory_info;
         if (global_data.system_memory_info.physical_pages_uncommitted < page_count) {
             dbgln("MM: Unable to commit {} pages, have only {}", page_count, global_data.system_memory_info.physical_pages_uncommitted);
             return ENOMEM;
@@ -903,8 +1046,10 @@ ErrorOr<CommittedPhysicalPageSet> MemoryManager::commit_physical_pages(size_t pa
 
         global_data.system_memory_info.physical_pages_uncommitted -= page_count;
         global_data.system_memory_info.physical_pages_committed += page_count;
+        memory_info = global_data.system_memory_info;
         return CommittedPhysicalPageSet { {}, page_count };
     });
+    notify_if_memory_is_low(memory_info);
     if (result.is_error()) {
         Process::for_each_ignoring_jails([&](Process const& process) {
             size_t amount_resident = 0;
@@ -1061,7 +1206,7 @@ ErrorOr<NonnullRefPtr<PhysicalPage>> MemoryManager::allocate_physical_page(Shoul
     });
 }
 
-ErrorOr<Vector<NonnullRefPtr<PhysicalPage>>> MemoryManager::allocate_contiguous_physical_pages(size_t size)
+ErrorOr<Vector<NonnullRefPtr<PhysicalPage>>> MemoryManager::allocate_contiguous_physical_pages(size_t size, size_t physical_alignment)
 {
     VERIFY(!(size % PAGE_SIZE));
     size_t page_count = ceil_div(size, static_cast<size_t>(PAGE_SIZE));
@@ -1072,14 +1217,15 @@ ErrorOr<Vector<NonnullRefPtr<PhysicalPage>>> MemoryManager::allocate_contiguous_
             return ENOMEM;
 
         for (auto& physical_region : global_data.physical_regions) {
-            auto physical_pages = physical_region->take_contiguous_free_pages(page_count);
+            auto physical_pages = physical_region->take_contiguous_free_pages(page_count, physical_alignment);
             if (!physical_pages.is_empty()) {
                 global_data.system_memory_info.physical_pages_uncommitted -= page_count;
                 global_data.system_memory_info.physical_pages_used += page_count;
                 return physical_pages;
             }
         }
-        dmesgln("MM: no contiguous physical pages available");
+        // NOTE: Huge page faults fall back to regular pages when this fails, so it is not worth logging by default.
+        dbgln_if(PAGE_FAULT_DEBUG, "MM: no contiguous physical pages available");
         return ENOMEM;
     }));
 
@@ -1285,4 +1431,35 @@ MemoryManager::SystemMemoryInfo MemoryManager::get_system_memory_info()
         return global_data.system_memory_info;
     });
 }
+
+static bool is_memory_low(MemoryManager::SystemMemoryInfo const& memory_info)
+{
+    return memory_info.physical_pages_uncommitted < memory_info.physical_pages / 16;
+}
+
+bool MemoryManager::is_memory_low()
+{
+    return Kernel::Memory::is_memory_low(get_system_memory_info());
+}
+
+static Singleton<WaitQueue> s_low_memory_wait_queue;
+static Atomic<bool> s_low_memory_wake_pending { false };
+
+// NOTE: Only commits are watched here. Allocating uncommitted pages happens with the global data lock held,
+//       and running out of those already makes us purge volatile memory on the spot.
+void MemoryManager::notify_if_memory_is_low(SystemMemoryInfo const& memory_info)
+{
+    if (!Kernel::Memory::is_memory_low(memory_info))
+        return;
+    // Don't keep waking up the waiters while they are still busy giving memory back.
+    if (s_low_memory_wake_pending.exchange(true))
+        return;
+    s_low_memory_wait_queue->wake_all();
+}
+
+void MemoryManager::wait_for_low_memory(Duration const& timeout)
+{
+    (void)s_low_memory_wait_queue->wait_on(Thread::BlockTimeout(false, &timeout), "LowMemory"sv);
+    s_low_memory_wake_pending.store(false);
+}
 }
@@ -34,6 +34,19 @@ constexpr FlatPtr page_round_down(FlatPtr x)
     return ((FlatPtr)(x)) & ~(PAGE_SIZE - 1);
 }
 
+// A huge page is mapped by a single page directory entry instead of a whole page table.
+constexpr size_t HUGE_PAGE_SIZE = 2 * MiB;
+constexpr size_t PAGES_PER_HUGE_PAGE = HUGE_PAGE_SIZE / PAGE_SIZE;
+
+constexpr bool supports_huge_pages()
+{
+#if ARCH(X86_64)
+    return true;
+#else
+    return false;
+#endif
+}
+
 inline FlatPtr virtual_to_low_physical(FlatPtr virtual_)
 {
     return virtual_ - physical_to_virtual_offset;
@@ -165,7 +178,7 @@ public:
 
     NonnullRefPtr<PhysicalPage> allocate_committed_physical_page(Badge<CommittedPhysicalPageSet>, ShouldZeroFill = ShouldZeroFill::Yes);
     ErrorOr<NonnullRefPtr<PhysicalPage>> allocate_physical_page(ShouldZeroFill = ShouldZeroFill::Yes, bool* did_purge = nullptr);
-    ErrorOr<Vector<NonnullRefPtr<PhysicalPage>>> allocate_contiguous_physical_pages(size_t size);
+    ErrorOr<Vector<NonnullRefPtr<PhysicalPage>>> allocate_contiguous_physical_pages(size_t size, size_t physical_alignment = PAGE_SIZE);
     void deallocate_physical_page(PhysicalAddress);
 
     ErrorOr<NonnullOwnPtr<Region>> allocate_contiguous_kernel_region(size_t, StringView name, Region::Access access, Region::Cacheable = Region::Cacheable::Yes);
@@ -188,6 +201,13 @@ public:
 
     SystemMemoryInfo get_system_memory_info();
 
+    // Memory counts as low once less than 1/16 of physical memory is left uncommitted.
+    bool is_memory_low();
+
+    // Blocks until committing memory finds it running low, or until the timeout expires. This lets caches
+    // give back memory as soon as it's needed instead of waiting for their next periodic cleanup.
+    void wait_for_low_memory(Duration const& timeout);
+
     template<IteratorFunction<VMObject&> Callback>
     static void for_each_vmobject(Callback callback)
     {
@@ -252,6 +272,8 @@ private:
 
     RefPtr<PhysicalPage> find_free_physical_page(bool);
 
+    void notify_if_memory_is_low(SystemMemoryInfo const&);
+
     ALWAYS_INLINE u8* quickmap_page(PhysicalPage& page)
     {
         return quickmap_page(page.paddr());
@@ -270,6 +292,11 @@ private:
     };
     void release_pte(PageDirectory&, VirtualAddress, IsLastPTERelease);
 
+    bool set_huge_pde(PageDirectory&, VirtualAddress, PageDirectoryEntry const&);
+    bool release_huge_pde(PageDirectory&, VirtualAddress);
+    bool is_mapped_as_huge_page(PageDirectory&, VirtualAddress);
+    bool split_huge_pde(PageDirectory&, VirtualAddress);
+
     // NOTE: These are outside of GlobalData as they are only assigned on startup,
     //       and then never change. Atomic ref-counting covers that case without
     //       the need for additional synchronization.
@@ -74,13 +74,17 @@ OwnPtr<PhysicalRegion> PhysicalRegion::try_take_pages_from_beginning(size_t page
     return try_create(taken_lower, taken_upper);
 }
 
-Vector<NonnullRefPtr<PhysicalPage>> PhysicalRegion::take_contiguous_free_pages(size_t count)
+Vector<NonnullRefPtr<PhysicalPage>> PhysicalRegion::take_contiguous_free_pages(size_t count, size_t physical_alignment)
 {
     auto rounded_page_count = next_power_of_two(count);
     auto order = count_trailing_zeroes(rounded_page_count);
+    VERIFY(physical_alignment <= rounded_page_count * PAGE_SIZE);
 
     Optional<PhysicalAddress> page_base;
     for (auto& zone : m_usable_zones) {
+        // Buddy blocks are naturally aligned relative to the base of their zone.
+        if (zone.base().get() % physical_alignment != 0)
+            continue;
         page_base = zone.allocate_block(order);
         if (page_base.has_value()) {
             if (zone.is_empty()) {
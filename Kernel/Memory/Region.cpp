@@ -117,6 +117,7 @@ ErrorOr<NonnullOwnPtr<Region>> Region::try_clone()
         region->set_mmap(m_mmap, m_mmapped_from_readable, m_mmapped_from_writable);
         region->set_shared(m_shared);
         region->set_syscall_region(is_syscall_region());
+        region->set_huge_pages(m_huge_pages);
         return region;
     }
 
@@ -142,6 +143,7 @@ ErrorOr<NonnullOwnPtr<Region>> Region::try_clone()
     }
     clone_region->set_syscall_region(is_syscall_region());
     clone_region->set_mmap(m_mmap, m_mmapped_from_readable, m_mmapped_from_writable);
+    clone_region->set_huge_pages(m_huge_pages);
     return clone_region;
 }
 
@@ -179,6 +181,24 @@ size_t Region::amount_resident() const
     return bytes;
 }
 
+size_t Region::amount_huge() const
+{
+    if (!supports_huge_pages() || !m_page_directory)
+        return 0;
+    auto& page_directory = const_cast<PageDirectory&>(*m_page_directory);
+    size_t bytes = 0;
+    SpinlockLocker page_lock(page_directory.get_lock());
+    for (size_t i = 0; i < page_count(); ++i) {
+        auto page_vaddr = vaddr_from_page_index(i);
+        if (page_vaddr.get() % HUGE_PAGE_SIZE != 0 || i + PAGES_PER_HUGE_PAGE > page_count())
+            continue;
+        if (MM.is_mapped_as_huge_page(page_directory, page_vaddr))
+            bytes += HUGE_PAGE_SIZE;
+        i += PAGES_PER_HUGE_PAGE - 1;
+    }
+    return bytes;
+}
+
 size_t Region::amount_shared() const
 {
     size_t bytes = 0;
@@ -257,6 +277,94 @@ bool Region::map_individual_page_impl(size_t page_index)
     return map_individual_page_impl(page_index, page);
 }
 
+bool Region::can_map_as_huge_page(size_t page_index) const
+{
+    if (!supports_huge_pages() || !m_huge_pages)
+        return false;
+    if (vaddr_from_page_index(page_index).get() % HUGE_PAGE_SIZE != 0 || page_index + PAGES_PER_HUGE_PAGE > page_count())
+        return false;
+    if (!is_user() || !vmobject().is_anonymous() || is_write_combine())
+        return false;
+    return is_readable() || is_writable();
+}
+
+bool Region::map_huge_page_impl(size_t page_index)
+{
+    VERIFY(m_page_directory->get_lock().is_locked_by_current_processor());
+
+    if (!can_map_as_huge_page(page_index))
+        return false;
+
+#if ARCH(X86_64)
+    PhysicalAddress huge_page_base;
+    {
+        SpinlockLocker vmobject_locker(vmobject().m_lock);
+        auto first_page = physical_page(page_index);
+        if (!first_page || first_page->is_shared_zero_page() || first_page->is_lazy_committed_page())
+            return false;
+        huge_page_base = first_page->paddr();
+        if (huge_page_base.get() % HUGE_PAGE_SIZE != 0)
+            return false;
+        for (size_t i = 1; i < PAGES_PER_HUGE_PAGE; ++i) {
+            auto page = physical_page(page_index + i);
+            if (!page || page->paddr() != huge_page_base.offset(i * PAGE_SIZE))
+                return false;
+        }
+    }
+
+    // Every page in the huge page has to agree on whether writes should fault.
+    for (size_t i = 0; i < PAGES_PER_HUGE_PAGE; ++i) {
+        if (should_cow(page_index + i))
+            return false;
+    }
+
+    PageDirectoryEntry pde;
+    pde.clear();
+    pde.set_page_table_base(huge_page_base.get());
+    pde.set_huge(true);
+    pde.set_present(true);
+    pde.set_cache_disabled(!m_cacheable);
+    pde.set_writable(is_writable());
+    if (Processor::current().has_nx())
+        pde.set_execute_disabled(!is_executable());
+    pde.set_user_allowed(true);
+    return MM.set_huge_pde(*m_page_directory, vaddr_from_page_index(page_index), pde);
+#else
+    return false;
+#endif
+}
+
+Optional<PageFaultResponse> Region::try_handle_fault_with_huge_page(size_t page_index_in_region)
+{
+    auto huge_page_vaddr = VirtualAddress { vaddr_from_page_index(page_index_in_region).get() & ~(HUGE_PAGE_SIZE - 1) };
+    if (huge_page_vaddr < vaddr())
+        return {};
+    auto first_page_index = page_index_from_address(huge_page_vaddr);
+    if (!can_map_as_huge_page(first_page_index))
+        return {};
+
+    auto& anonymous_vmobject = static_cast<AnonymousVMObject&>(vmobject());
+    if (!anonymous_vmobject.try_populate_huge_page({}, translate_to_vmobject_page(first_page_index)))
+        return {};
+
+    auto current_thread = Thread::current();
+    if (current_thread != nullptr)
+        current_thread->did_zero_fault();
+
+    SpinlockLocker page_lock(m_page_directory->get_lock());
+    bool success = map_huge_page_impl(first_page_index);
+    if (!success) {
+        // The pages are in the VMObject now, so fall back to mapping them one at a time.
+        success = true;
+        for (size_t i = 0; i < PAGES_PER_HUGE_PAGE && success; ++i)
+            success = map_individual_page_impl(first_page_index + i);
+    }
+    MemoryManager::flush_tlb(m_page_directory, huge_page_vaddr, PAGES_PER_HUGE_PAGE);
+    if (!success)
+        return PageFaultResponse::OutOfMemory;
+    return PageFaultResponse::Continue;
+}
+
 bool Region::remap_vmobject_page(size_t page_index, NonnullRefPtr<PhysicalPage> physical_page)
 {
     SpinlockLocker page_lock(m_page_directory->get_lock());
@@ -285,6 +393,12 @@ void Region::unmap_with_locks_held(ShouldFlushTLB should_flush_tlb, SpinlockLock
     size_t count = page_count();
     for (size_t i = 0; i < count; ++i) {
         auto vaddr = vaddr_from_page_index(i);
+        if (supports_huge_pages() && vaddr.get() % HUGE_PAGE_SIZE == 0 && i + PAGES_PER_HUGE_PAGE <= count) {
+            if (MM.release_huge_pde(*m_page_directory, vaddr)) {
+                i += PAGES_PER_HUGE_PAGE - 1;
+                continue;
+            }
+        }
         MM.release_pte(*m_page_directory, vaddr, i == count - 1 ? MemoryManager::IsLastPTERelease::Yes : MemoryManager::IsLastPTERelease::No);
     }
     if (should_flush_tlb == ShouldFlushTLB::Yes)
@@ -310,6 +424,10 @@ ErrorOr<void> Region::map(PageDirectory& page_directory, ShouldFlushTLB should_f
     set_page_directory(page_directory);
     size_t page_index = 0;
     while (page_index < page_count()) {
+        if (map_huge_page_impl(page_index)) {
+            page_index += PAGES_PER_HUGE_PAGE;
+            continue;
+        }
         if (!map_individual_page_impl(page_index))
             break;
         ++page_index;
@@ -373,6 +491,9 @@ PageFaultResponse Region::handle_fault(PageFault const& fault)
             return handle_inode_fault(page_index_in_region);
         }
 
+        if (auto response = try_handle_fault_with_huge_page(page_index_in_region); response.has_value())
+            return response.release_value();
+
         SpinlockLocker vmobject_locker(vmobject().m_lock);
         auto& page_slot = physical_page_slot(page_index_in_region);
         if (page_slot->is_lazy_committed_page()) {
@@ -398,6 +519,8 @@ PageFaultResponse Region::handle_fault(PageFault const& fault)
         auto phys_page = physical_page(page_index_in_region);
         if (phys_page->is_shared_zero_page() || phys_page->is_lazy_committed_page()) {
             dbgln_if(PAGE_FAULT_DEBUG, "NP(zero) fault in Region({})[{}] at {}", this, page_index_in_region, fault.vaddr());
+            if (auto response = try_handle_fault_with_huge_page(page_index_in_region); response.has_value())
+                return response.release_value();
             return handle_zero_fault(page_index_in_region, *phys_page);
         }
         return handle_cow_fault(page_index_in_region);
@@ -10,6 +10,7 @@
 #include <AK/EnumBits.h>
 #include <AK/IntrusiveList.h>
 #include <AK/IntrusiveRedBlackTree.h>
+#include <AK/Optional.h>
 #include <Kernel/Forward.h>
 #include <Kernel/Library/KString.h>
 #include <Kernel/Library/LockWeakable.h>
@@ -104,6 +105,9 @@ public:
     [[nodiscard]] bool is_write_combine() const { return m_write_combine; }
     ErrorOr<void> set_write_combine(bool);
 
+    [[nodiscard]] bool wants_huge_pages() const { return m_huge_pages; }
+    void set_huge_pages(bool huge_pages) { m_huge_pages = huge_pages; }
+
     [[nodiscard]] bool is_user() const { return !is_kernel(); }
     [[nodiscard]] bool is_kernel() const { return vaddr().get() < USER_RANGE_BASE || vaddr().get() >= kernel_mapping_base; }
 
@@ -178,6 +182,7 @@ public:
     [[nodiscard]] size_t amount_resident() const;
     [[nodiscard]] size_t amount_shared() const;
     [[nodiscard]] size_t amount_dirty() const;
+    [[nodiscard]] size_t amount_huge() const;
 
     [[nodiscard]] bool should_cow(size_t page_index) const;
     ErrorOr<void> set_should_cow(size_t page_index, bool);
@@ -232,6 +237,10 @@ private:
     [[nodiscard]] bool map_individual_page_impl(size_t page_index);
     [[nodiscard]] bool map_individual_page_impl(size_t page_index, RefPtr<PhysicalPage>);
 
+    [[nodiscard]] bool can_map_as_huge_page(size_t page_index) const;
+    [[nodiscard]] bool map_huge_page_impl(size_t page_index);
+    [[nodiscard]] Optional<PageFaultResponse> try_handle_fault_with_huge_page(size_t page_index);
+
     LockRefPtr<PageDirectory> m_page_directory;
     VirtualRange m_range;
     size_t m_offset_in_vmobject { 0 };
@@ -246,6 +255,7 @@ private:
     bool m_immutable : 1 { false };
     bool m_syscall_region : 1 { false };
     bool m_write_combine : 1 { false };
+    bool m_huge_pages : 1 { false };
     bool m_mmapped_from_readable : 1 { false };
     bool m_mmapped_from_writable : 1 { false };
 
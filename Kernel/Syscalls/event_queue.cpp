@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/EventQueue.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Tasks/Process.h>
+
+namespace Kernel {
+
+using BlockFlags = Thread::FileBlocker::BlockFlags;
+
+static BlockFlags block_flags_from_poll_events(u32 events)
+{
+    BlockFlags block_flags = BlockFlags::WriteError | BlockFlags::WriteHangUp; // always want POLLERR, POLLHUP
+    if (events & POLLIN)
+        block_flags |= BlockFlags::Read;
+    if (events & POLLOUT)
+        block_flags |= BlockFlags::Write;
+    if (events & POLLPRI)
+        block_flags |= BlockFlags::ReadPriority;
+    if (events & POLLWRBAND)
+        block_flags |= BlockFlags::WritePriority;
+    if (events & POLLRDHUP)
+        block_flags |= BlockFlags::ReadHangUp;
+    return block_flags;
+}
+
+static EventQueue::Trigger trigger_from_events(u32 events)
+{
+    if (events & EVENT_QUEUE_ONE_SHOT)
+        return EventQueue::Trigger::OneShot;
+    if (events & EVENT_QUEUE_EDGE_TRIGGERED)
+        return EventQueue::Trigger::Edge;
+    return EventQueue::Trigger::Level;
+}
+
+static short poll_events_from_block_flags(BlockFlags block_flags)
+{
+    short events = 0;
+    if (has_flag(block_flags, BlockFlags::Read))
+        events |= POLLIN;
+    if (has_flag(block_flags, BlockFlags::Write))
+        events |= POLLOUT;
+    if (has_flag(block_flags, BlockFlags::ReadPriority))
+        events |= POLLPRI;
+    if (has_flag(block_flags, BlockFlags::WritePriority))
+        events |= POLLWRBAND;
+    if (has_flag(block_flags, BlockFlags::ReadHangUp))
+        events |= POLLRDHUP;
+    return events;
+}
+
+static short poll_revents_from_block_flags(BlockFlags block_flags)
+{
+    short revents = 0;
+    if (has_flag(block_flags, BlockFlags::WriteHangUp))
+        revents |= POLLHUP;
+    if (has_flag(block_flags, BlockFlags::WriteError)) {
+        revents |= POLLERR;
+        return revents;
+    }
+    if (has_flag(block_flags, BlockFlags::WriteHangUp))
+        block_flags &= ~BlockFlags::Write;
+    return revents | poll_events_from_block_flags(block_flags);
+}
+
+ErrorOr<FlatPtr> Process::sys$event_queue_create(int options)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+
+    auto event_queue = TRY(EventQueue::try_create());
+    auto description = TRY(OpenFileDescription::try_create(move(event_queue)));
+    description->set_readable(true);
+
+    u32 fd_flags = 0;
+    if (options & O_CLOEXEC)
+        fd_flags |= FD_CLOEXEC;
+
+    return m_fds.with_exclusive([&](auto& fds) -> ErrorOr<FlatPtr> {
+        auto new_fd = TRY(fds.allocate());
+        fds[new_fd.fd].set(move(description), fd_flags);
+        return new_fd.fd;
+    });
+}
+
+ErrorOr<FlatPtr> Process::sys$event_queue_control(int queue_fd, int operation, int fd, u32 events)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+
+    auto queue_description = TRY(open_file_description(queue_fd));
+    if (!queue_description->is_event_queue())
+        return EINVAL;
+    auto& event_queue = *queue_description->event_queue();
+
+    switch (operation) {
+    case EVENT_QUEUE_ADD: {
+        auto description = TRY(open_file_description(fd));
+        TRY(event_queue.add(fd, move(description), block_flags_from_poll_events(events), trigger_from_events(events)));
+        return 0;
+    }
+    case EVENT_QUEUE_MODIFY:
+        TRY(event_queue.modify(fd, block_flags_from_poll_events(events), trigger_from_events(events)));
+        return 0;
+    case EVENT_QUEUE_REMOVE:
+        TRY(event_queue.remove(fd));
+        return 0;
+    default:
+        return EINVAL;
+    }
+}
+
+ErrorOr<FlatPtr> Process::sys$event_queue_wait(Userspace<Syscall::SC_event_queue_wait_params const*> user_params)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+
+    auto params = TRY(copy_typed_from_user(user_params));
+
+    if (params.max_events == 0)
+        return EINVAL;
+    // There can't be more ready events than descriptors.
+    auto max_events = min<size_t>(params.max_events, OpenFileDescriptions::max_open());
+
+    Thread::BlockTimeout timeout;
+    if (params.timeout) {
+        auto timeout_time = TRY(copy_time_from_user(params.timeout));
+        timeout = Thread::BlockTimeout(false, &timeout_time);
+    }
+
+    auto queue_description = TRY(open_file_description(params.queue_fd));
+    if (!queue_description->is_event_queue())
+        return EINVAL;
+    auto& event_queue = *queue_description->event_queue();
+
+    Vector<EventQueue::ReadyEvent> ready_events;
+    TRY(ready_events.try_ensure_capacity(max_events));
+
+    for (;;) {
+        event_queue.collect_ready_events(ready_events, max_events);
+        if (!ready_events.is_empty())
+            break;
+
+        // The event queue is readable whenever something on it may have become ready. That can turn out to be a false
+        // alarm by the time we look, in which case we simply go back to waiting.
+        Thread::SelectBlocker::FDVector fds_info;
+        fds_info.unchecked_append({ queue_description, BlockFlags::Read });
+        auto block_result = Thread::current()->block<Thread::SelectBlocker>(timeout, fds_info);
+        if (block_result.was_interrupted())
+            return EINTR;
+        if (block_result == Thread::BlockResult::InterruptedByTimeout)
+            return 0;
+    }
+
+    Vector<pollfd> events;
+    TRY(events.try_ensure_capacity(ready_events.size()));
+    for (auto& ready_event : ready_events) {
+        events.unchecked_append({
+            .fd = ready_event.fd,
+            .events = poll_events_from_block_flags(ready_event.interest),
+            .revents = poll_revents_from_block_flags(ready_event.ready),
+        });
+    }
+    TRY(copy_n_to_user(params.events, events.data(), events.size()));
+    return events.size();
+}
+
+}
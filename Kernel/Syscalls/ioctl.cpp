@@ -13,23 +13,29 @@ namespace Kernel {
 
 ErrorOr<FlatPtr> Process::sys$ioctl(int fd, unsigned request, FlatPtr arg)
 {
-    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
     auto description = TRY(open_file_description(fd));
     if (request == FIONBIO) {
         description->set_blocking(TRY(copy_typed_from_user(Userspace<int const*>(arg))) == 0);
         return 0;
     }
     if (request == FIOCLEX) {
-        m_fds.with_exclusive([&](auto& fds) {
+        return m_fds.with_exclusive([&](auto& fds) -> ErrorOr<FlatPtr> {
+            // Another thread may have closed (or reused) the fd since we looked it up.
+            if (fds[fd].description() != description.ptr())
+                return EBADF;
             fds[fd].set_flags(fds[fd].flags() | FD_CLOEXEC);
+            return 0;
         });
-        return 0;
     }
     if (request == FIONCLEX) {
-        m_fds.with_exclusive([&](auto& fds) {
+        return m_fds.with_exclusive([&](auto& fds) -> ErrorOr<FlatPtr> {
+            // Another thread may have closed (or reused) the fd since we looked it up.
+            if (fds[fd].description() != description.ptr())
+                return EBADF;
             fds[fd].set_flags(fds[fd].flags() & ~FD_CLOEXEC);
+            return 0;
         });
-        return 0;
     }
     TRY(description->file().ioctl(*description, request, arg));
     return 0;
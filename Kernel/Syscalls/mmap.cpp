@@ -329,10 +329,11 @@ ErrorOr<FlatPtr> Process::sys$mprotect(Userspace<void*> addr, size_t size, int p
             new_region->set_executable(prot & PROT_EXEC);
 
             // Map the new regions using our page directory (they were just allocated and don't have one).
+            // The unmap() above already flushed the whole range from every TLB, so there's no need to do that again.
             for (auto* adjacent_region : adjacent_regions) {
-                TRY(adjacent_region->map(space->page_directory()));
+                TRY(adjacent_region->map(space->page_directory(), Memory::ShouldFlushTLB::No));
             }
-            TRY(new_region->map(space->page_directory()));
+            TRY(new_region->map(space->page_directory(), Memory::ShouldFlushTLB::No));
             return 0;
         }
 
@@ -391,10 +392,11 @@ ErrorOr<FlatPtr> Process::sys$mprotect(Userspace<void*> addr, size_t size, int p
                 new_region->set_executable(prot & PROT_EXEC);
 
                 // Map the new region using our page directory (they were just allocated and don't have one) if any.
+                // As above, the unmap() already flushed the range.
                 if (adjacent_regions.size())
-                    TRY(adjacent_regions[0]->map(space->page_directory()));
+                    TRY(adjacent_regions[0]->map(space->page_directory(), Memory::ShouldFlushTLB::No));
 
-                TRY(new_region->map(space->page_directory()));
+                TRY(new_region->map(space->page_directory(), Memory::ShouldFlushTLB::No));
             }
 
             return 0;
@@ -435,6 +437,15 @@ ErrorOr<FlatPtr> Process::sys$madvise(Userspace<void*> address, size_t size, int
             TRY(vmobject.set_volatile(advice == MADV_SET_VOLATILE, was_purged));
             return was_purged ? 1 : 0;
         }
+        if (advice == MADV_HUGEPAGE || advice == MADV_NOHUGEPAGE) {
+            if (!region->vmobject().is_anonymous())
+                return EINVAL;
+            region->set_huge_pages(advice == MADV_HUGEPAGE);
+            // Huge pages are populated on fault, but pages that are already huge have to be split up now.
+            if (advice == MADV_NOHUGEPAGE)
+                TRY(region->map(space->page_directory()));
+            return 0;
+        }
         return EINVAL;
     });
 }
@@ -40,7 +40,7 @@ static ErrorOr<void> check_blocked_read(OpenFileDescription* description)
 
 ErrorOr<FlatPtr> Process::readv_impl(int fd, Userspace<const struct iovec*> iov, int iov_count)
 {
-    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
     TRY(require_promise(Pledge::stdio));
     if (iov_count < 0)
         return EINVAL;
@@ -60,6 +60,11 @@ ErrorOr<FlatPtr> Process::readv_impl(int fd, Userspace<const struct iovec*> iov,
 
     auto description = TRY(open_readable_file_description(fds(), fd));
 
+    // The vectors are read from consecutive offsets, even when other threads read from the same description.
+    MutexLocker offset_locker;
+    if (description->file().is_seekable())
+        offset_locker.attach_and_lock(description->offset_lock());
+
     int nread = 0;
     for (auto& vec : vecs) {
         TRY(check_blocked_read(description));
@@ -73,7 +78,7 @@ ErrorOr<FlatPtr> Process::readv_impl(int fd, Userspace<const struct iovec*> iov,
 
 ErrorOr<FlatPtr> Process::read_impl(int fd, Userspace<u8*> buffer, size_t size)
 {
-    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
     TRY(require_promise(Pledge::stdio));
     if (size == 0)
         return 0;
@@ -89,7 +94,7 @@ ErrorOr<FlatPtr> Process::read_impl(int fd, Userspace<u8*> buffer, size_t size)
 
 ErrorOr<FlatPtr> Process::pread_impl(int fd, Userspace<u8*> buffer, size_t size, off_t offset)
 {
-    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
     TRY(require_promise(Pledge::stdio));
     if (size == 0)
         return 0;
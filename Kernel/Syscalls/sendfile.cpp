@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ByteBuffer.h>
+#include <AK/NumericLimits.h>
+#include <Kernel/Debug.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Tasks/Process.h>
+
+namespace Kernel {
+
+ErrorOr<NonnullRefPtr<OpenFileDescription>> open_readable_file_description(auto& fds, int fd);
+
+// Data is moved through a kernel buffer of this size, so the file contents never have to be
+// copied into (and back out of) the calling process.
+static constexpr size_t sendfile_chunk_size = 64 * KiB;
+
+ErrorOr<FlatPtr> Process::sys$sendfile(int out_fd, int in_fd, Userspace<off_t*> userspace_offset, size_t count)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+    if (count == 0)
+        return 0;
+    if (count > NumericLimits<ssize_t>::max())
+        return EINVAL;
+
+    dbgln_if(IO_DEBUG, "sys$sendfile({}, {}, {}, {})", out_fd, in_fd, userspace_offset.ptr(), count);
+
+    auto in_description = TRY(open_readable_file_description(fds(), in_fd));
+    // Only inode-backed files can be read at an arbitrary offset on behalf of the caller.
+    if (!in_description->inode() || !in_description->file().is_seekable())
+        return EINVAL;
+
+    auto out_description = TRY(open_file_description(out_fd));
+    if (!out_description->is_writable())
+        return EBADF;
+
+    off_t offset = 0;
+    if (userspace_offset.ptr()) {
+        TRY(copy_from_user(&offset, userspace_offset));
+        if (offset < 0)
+            return EINVAL;
+    } else {
+        offset = in_description->offset();
+    }
+
+    auto chunk = TRY(ByteBuffer::create_uninitialized(min(count, sendfile_chunk_size)));
+    auto chunk_buffer = UserOrKernelBuffer::for_kernel_buffer(chunk.data());
+
+    size_t total_nwritten = 0;
+    while (total_nwritten < count) {
+        auto nread_or_error = in_description->read(chunk_buffer, offset + total_nwritten, min(chunk.size(), count - total_nwritten));
+        if (nread_or_error.is_error()) {
+            if (total_nwritten > 0)
+                break;
+            return nread_or_error.release_error();
+        }
+        auto nread = nread_or_error.value();
+        if (nread == 0)
+            break;
+
+        auto nwritten_or_error = do_write(*out_description, chunk_buffer, nread);
+        if (nwritten_or_error.is_error()) {
+            if (total_nwritten > 0)
+                break;
+            return nwritten_or_error.release_error();
+        }
+        total_nwritten += nwritten_or_error.value();
+
+        // A short write means a non-blocking destination is full; let the caller retry later.
+        if (nwritten_or_error.value() < nread)
+            break;
+    }
+
+    if (total_nwritten == 0)
+        return 0;
+
+    // The data has already been moved at this point, so failing to update the offset must not hide that from the caller.
+    off_t new_offset = offset + total_nwritten;
+    if (userspace_offset.ptr()) {
+        if (auto result = copy_to_user(userspace_offset, &new_offset); result.is_error())
+            dbgln_if(IO_DEBUG, "sys$sendfile: Failed to update the offset after sending {} bytes: {}", total_nwritten, result.error());
+    } else {
+        if (auto result = in_description->seek(new_offset, SEEK_SET); result.is_error())
+            dbgln_if(IO_DEBUG, "sys$sendfile: Failed to update the offset after sending {} bytes: {}", total_nwritten, result.error());
+    }
+
+    return total_nwritten;
+}
+
+}
@@ -13,7 +13,7 @@ namespace Kernel {
 
 ErrorOr<FlatPtr> Process::sys$pwritev(int fd, Userspace<const struct iovec*> iov, int iov_count, off_t base_offset)
 {
-    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
     TRY(require_promise(Pledge::stdio));
     if (iov_count < 0)
         return EINVAL;
@@ -38,6 +38,11 @@ ErrorOr<FlatPtr> Process::sys$pwritev(int fd, Userspace<const struct iovec*> iov
     if (base_offset >= 0 && !description->file().is_seekable())
         return EINVAL;
 
+    // Like writev(), the vectors of a write at the current offset go out together.
+    MutexLocker offset_locker;
+    if (base_offset < 0 && description->file().is_seekable())
+        offset_locker.attach_and_lock(description->offset_lock());
+
     int nwritten = 0;
     off_t current_offset = base_offset;
     for (auto& vec : vecs) {
@@ -59,6 +64,12 @@ ErrorOr<FlatPtr> Process::do_write(OpenFileDescription& description, UserOrKerne
 {
     size_t total_nwritten = 0;
 
+    // Keep other threads from moving the offset between seeking to the end and writing there, or in between the
+    // partial writes below.
+    MutexLocker offset_locker;
+    if (!offset.has_value() && description.file().is_seekable())
+        offset_locker.attach_and_lock(description.offset_lock());
+
     if (description.should_append() && description.file().is_seekable()) {
         TRY(description.seek(0, SEEK_END));
     }
@@ -97,7 +108,7 @@ ErrorOr<FlatPtr> Process::do_write(OpenFileDescription& description, UserOrKerne
 
 ErrorOr<FlatPtr> Process::sys$write(int fd, Userspace<u8 const*> data, size_t size)
 {
-    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
     TRY(require_promise(Pledge::stdio));
     if (size == 0)
         return 0;
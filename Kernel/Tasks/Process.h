@@ -316,6 +316,9 @@ public:
     ErrorOr<FlatPtr> sys$create_inode_watcher(u32 flags);
     ErrorOr<FlatPtr> sys$inode_watcher_add_watch(Userspace<Syscall::SC_inode_watcher_add_watch_params const*> user_params);
     ErrorOr<FlatPtr> sys$inode_watcher_remove_watch(int fd, int wd);
+    ErrorOr<FlatPtr> sys$event_queue_create(int options);
+    ErrorOr<FlatPtr> sys$event_queue_control(int queue_fd, int operation, int fd, u32 events);
+    ErrorOr<FlatPtr> sys$event_queue_wait(Userspace<Syscall::SC_event_queue_wait_params const*>);
     ErrorOr<FlatPtr> sys$dbgputstr(Userspace<char const*>, size_t);
     ErrorOr<FlatPtr> sys$dump_backtrace();
     ErrorOr<FlatPtr> sys$gettid();
@@ -453,6 +456,7 @@ public:
     ErrorOr<FlatPtr> sys$get_stack_bounds(Userspace<FlatPtr*> stack_base, Userspace<size_t*> stack_size);
     ErrorOr<FlatPtr> sys$ptrace(Userspace<Syscall::SC_ptrace_params const*>);
     ErrorOr<FlatPtr> sys$sendfd(int sockfd, int fd);
+    ErrorOr<FlatPtr> sys$sendfile(int out_fd, int in_fd, Userspace<off_t*>, size_t);
     ErrorOr<FlatPtr> sys$recvfd(int sockfd, int options);
     ErrorOr<FlatPtr> sys$sysconf(int name);
     ErrorOr<FlatPtr> sys$disown(ProcessID);
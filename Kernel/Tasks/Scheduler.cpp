@@ -5,10 +5,12 @@
  */
 
 #include <AK/BuiltinWrappers.h>
+#include <AK/NumericLimits.h>
 #include <AK/ScopeGuard.h>
 #include <AK/Singleton.h>
 #include <AK/Time.h>
 #include <Kernel/Arch/TrapFrame.h>
+#include <Kernel/Boot/CommandLine.h>
 #include <Kernel/Debug.h>
 #include <Kernel/Interrupts/InterruptDisabler.h>
 #include <Kernel/Library/Panic.h>
@@ -44,9 +46,21 @@ struct ThreadReadyQueues {
     u32 mask {};
     static constexpr size_t count = sizeof(mask) * 8;
     Array<ThreadReadyQueue, count> queues;
+    size_t thread_count { 0 };
+    u64 steal_count { 0 };
 };
 
-static Singleton<SpinlockProtected<ThreadReadyQueues, LockRank::None>> g_ready_queues;
+// Thread affinity masks are 32 bits wide, so there is no point in having more ready queues than that.
+static constexpr size_t max_ready_queue_processors = sizeof(u32) * 8;
+
+using ProcessorReadyQueues = Array<SpinlockProtected<ThreadReadyQueues, LockRank::None>, max_ready_queue_processors>;
+
+static Singleton<ProcessorReadyQueues> g_ready_queues;
+
+static SchedulerReadyQueueMode s_ready_queue_mode { SchedulerReadyQueueMode::PerProcessor };
+
+// Processors that have nothing but their idle thread to run. Only modified with g_scheduler_lock held.
+static Atomic<u32> s_idle_processors_mask { 0 };
 
 static SpinlockProtected<TotalTimeScheduled, LockRank::None> g_total_time_scheduled {};
 
@@ -64,73 +78,201 @@ static inline u32 thread_priority_to_priority_index(u32 thread_priority)
     return priority_bucket;
 }
 
-Thread& Scheduler::pull_next_runnable_thread()
+static inline u32 ready_queue_processor_count()
 {
-    auto affinity_mask = 1u << Processor::current_id();
-
-    return g_ready_queues->with([&](auto& ready_queues) -> Thread& {
-        auto priority_mask = ready_queues.mask;
-        while (priority_mask != 0) {
-            auto priority = bit_scan_forward(priority_mask);
-            VERIFY(priority > 0);
-            auto& ready_queue = ready_queues.queues[--priority];
-            for (auto& thread : ready_queue.thread_list) {
-                VERIFY(thread.m_runnable_priority == (int)priority);
-                if (thread.is_active())
-                    continue;
-                if (!(thread.affinity() & affinity_mask))
-                    continue;
-                thread.m_runnable_priority = -1;
-                ready_queue.thread_list.remove(thread);
-                if (ready_queue.thread_list.is_empty())
-                    ready_queues.mask &= ~(1u << priority);
-                // Mark it as active because we are using this thread. This is similar
-                // to comparing it with Processor::current_thread, but when there are
-                // multiple processors there's no easy way to check whether the thread
-                // is actually still needed. This prevents accidental finalization when
-                // a thread is no longer in Running state, but running on another core.
-
-                // We need to mark it active here so that this thread won't be
-                // scheduled on another core if it were to be queued before actually
-                // switching to it.
-                // FIXME: Figure out a better way maybe?
-                thread.set_active(true);
-                return thread;
-            }
-            priority_mask &= ~(1u << priority);
+    if (s_ready_queue_mode == SchedulerReadyQueueMode::Global)
+        return 1;
+    // NOTE: Processor::count() is not maintained on every architecture yet, so always assume at least one processor.
+    return clamp(Processor::count(), 1u, (u32)max_ready_queue_processors);
+}
+
+static inline u32 ready_queue_index_for_processor(u32 processor)
+{
+    if (s_ready_queue_mode == SchedulerReadyQueueMode::Global)
+        return 0;
+    VERIFY(processor < max_ready_queue_processors);
+    return processor;
+}
+
+static u32 select_ready_queue_for(Thread const& thread)
+{
+    if (s_ready_queue_mode == SchedulerReadyQueueMode::Global)
+        return 0;
+
+    auto processor_count = ready_queue_processor_count();
+    u32 online_mask = processor_count >= 32 ? 0xffffffff : (1u << processor_count) - 1;
+    u32 allowed_mask = thread.affinity() & online_mask;
+    if (allowed_mask == 0)
+        return 0;
+
+    // Keep threads on the processor they last ran on, as long as they are allowed to run there
+    // and no other processor they could run on is sitting idle. This keeps their working set warm.
+    auto last_processor = thread.cpu();
+    bool may_use_last_processor = last_processor < processor_count && (allowed_mask & (1u << last_processor));
+    u32 idle_mask = s_idle_processors_mask.load(AK::MemoryOrder::memory_order_relaxed) & allowed_mask;
+    if (may_use_last_processor && (idle_mask == 0 || (idle_mask & (1u << last_processor))))
+        return last_processor;
+    if (idle_mask != 0)
+        return bit_scan_forward(idle_mask) - 1;
+    if (may_use_last_processor)
+        return last_processor;
+
+    // Otherwise, pick the least loaded processor the thread may run on.
+    u32 best_processor = bit_scan_forward(allowed_mask) - 1;
+    size_t best_thread_count = NumericLimits<size_t>::max();
+    for (u32 mask = allowed_mask; mask != 0;) {
+        u32 processor = bit_scan_forward(mask) - 1;
+        mask &= ~(1u << processor);
+        auto thread_count = (*g_ready_queues)[processor].with([](auto& ready_queues) { return ready_queues.thread_count; });
+        if (thread_count < best_thread_count) {
+            best_processor = processor;
+            best_thread_count = thread_count;
         }
+    }
+    return best_processor;
+}
 
-        auto* idle_thread = Processor::idle_thread();
-        idle_thread->set_active(true);
-        return *idle_thread;
-    });
+void Scheduler::remove_from_ready_queue(ThreadReadyQueues& ready_queues, Thread& thread)
+{
+    auto priority = thread.m_runnable_priority;
+    VERIFY(priority >= 0);
+    VERIFY(ready_queues.mask & (1u << priority));
+    auto& ready_queue = ready_queues.queues[priority];
+    thread.m_runnable_priority = -1;
+    ready_queue.thread_list.remove(thread);
+    if (ready_queue.thread_list.is_empty())
+        ready_queues.mask &= ~(1u << priority);
+    VERIFY(ready_queues.thread_count > 0);
+    ready_queues.thread_count--;
 }
 
-Thread* Scheduler::peek_next_runnable_thread()
+// Returns the highest priority thread in ready_queues that may run on the processor
+// described by affinity_mask, along with its priority bucket.
+Thread* Scheduler::find_runnable_thread(ThreadReadyQueues& ready_queues, u32 affinity_mask, u32& found_priority)
 {
-    auto affinity_mask = 1u << Processor::current_id();
-
-    return g_ready_queues->with([&](auto& ready_queues) -> Thread* {
-        auto priority_mask = ready_queues.mask;
-        while (priority_mask != 0) {
-            auto priority = bit_scan_forward(priority_mask);
-            VERIFY(priority > 0);
-            auto& ready_queue = ready_queues.queues[--priority];
-            for (auto& thread : ready_queue.thread_list) {
-                VERIFY(thread.m_runnable_priority == (int)priority);
-                if (thread.is_active())
-                    continue;
-                if (!(thread.affinity() & affinity_mask))
-                    continue;
-                return &thread;
+    auto priority_mask = ready_queues.mask;
+    while (priority_mask != 0) {
+        auto priority = bit_scan_forward(priority_mask);
+        VERIFY(priority > 0);
+        auto& ready_queue = ready_queues.queues[--priority];
+        for (auto& thread : ready_queue.thread_list) {
+            VERIFY(thread.m_runnable_priority == (int)priority);
+            if (thread.is_active())
+                continue;
+            if (!(thread.affinity() & affinity_mask))
+                continue;
+            found_priority = priority;
+            return &thread;
+        }
+        priority_mask &= ~(1u << priority);
+    }
+    return nullptr;
+}
+
+// Looks through the ready queues of all other processors for the highest priority thread
+// that is allowed to run on the current processor.
+Optional<u32> Scheduler::find_ready_queue_to_steal_from(u32 local_queue_index, u32 affinity_mask)
+{
+    Optional<u32> best_queue_index;
+    u32 best_priority = ThreadReadyQueues::count;
+    auto processor_count = ready_queue_processor_count();
+    for (u32 queue_index = 0; queue_index < processor_count; ++queue_index) {
+        if (queue_index == local_queue_index)
+            continue;
+        (*g_ready_queues)[queue_index].with([&](auto& ready_queues) {
+            if (ready_queues.mask == 0)
+                return;
+            u32 priority = 0;
+            if (!find_runnable_thread(ready_queues, affinity_mask, priority))
+                return;
+            if (priority < best_priority) {
+                best_priority = priority;
+                best_queue_index = queue_index;
             }
-            priority_mask &= ~(1u << priority);
+        });
+    }
+    return best_queue_index;
+}
+
+Thread* Scheduler::take_runnable_thread(ThreadReadyQueues& ready_queues, u32 affinity_mask)
+{
+    u32 priority = 0;
+    auto* thread = find_runnable_thread(ready_queues, affinity_mask, priority);
+    if (!thread)
+        return nullptr;
+    remove_from_ready_queue(ready_queues, *thread);
+    // Mark it as active because we are using this thread. This is similar
+    // to comparing it with Processor::current_thread, but when there are
+    // multiple processors there's no easy way to check whether the thread
+    // is actually still needed. This prevents accidental finalization when
+    // a thread is no longer in Running state, but running on another core.
+
+    // We need to mark it active here so that this thread won't be
+    // scheduled on another core if it were to be queued before actually
+    // switching to it.
+    // FIXME: Figure out a better way maybe?
+    thread->set_active(true);
+    return thread;
+}
+
+Thread& Scheduler::pull_next_runnable_thread()
+{
+    VERIFY(g_scheduler_lock.is_locked_by_current_processor());
+    auto current_id = Processor::current_id();
+    auto affinity_mask = 1u << current_id;
+    auto local_queue_index = ready_queue_index_for_processor(current_id);
+
+    auto* thread = (*g_ready_queues)[local_queue_index].with([&](auto& ready_queues) {
+        return take_runnable_thread(ready_queues, affinity_mask);
+    });
+
+    // Our own queue ran dry, so try to steal some work from other processors before going idle.
+    for (u32 attempt = 0; !thread && attempt < ready_queue_processor_count(); ++attempt) {
+        auto victim_queue_index = find_ready_queue_to_steal_from(local_queue_index, affinity_mask);
+        if (!victim_queue_index.has_value())
+            break;
+        thread = (*g_ready_queues)[victim_queue_index.value()].with([&](auto& ready_queues) {
+            return take_runnable_thread(ready_queues, affinity_mask);
+        });
+        if (thread) {
+            (*g_ready_queues)[local_queue_index].with([](auto& ready_queues) { ready_queues.steal_count++; });
+            dbgln_if(SCHEDULER_DEBUG, "Scheduler[{}]: Stole {} from processor {}", current_id, *thread, victim_queue_index.value());
         }
+    }
+
+    if (thread) {
+        s_idle_processors_mask.fetch_and(~affinity_mask, AK::MemoryOrder::memory_order_relaxed);
+        return *thread;
+    }
 
-        // Unlike in pull_next_runnable_thread() we don't want to fall back to
-        // the idle thread. We just want to see if we have any other thread ready
-        // to be scheduled.
+    s_idle_processors_mask.fetch_or(affinity_mask, AK::MemoryOrder::memory_order_relaxed);
+    auto* idle_thread = Processor::idle_thread();
+    idle_thread->set_active(true);
+    return *idle_thread;
+}
+
+Thread* Scheduler::peek_next_runnable_thread()
+{
+    auto current_id = Processor::current_id();
+    auto affinity_mask = 1u << current_id;
+    auto local_queue_index = ready_queue_index_for_processor(current_id);
+
+    auto* thread = (*g_ready_queues)[local_queue_index].with([&](auto& ready_queues) -> Thread* {
+        u32 priority = 0;
+        return find_runnable_thread(ready_queues, affinity_mask, priority);
+    });
+    if (thread)
+        return thread;
+
+    // Unlike in pull_next_runnable_thread() we don't want to fall back to
+    // the idle thread. We just want to see if we have any other thread ready
+    // to be scheduled, including ones we could steal from other processors.
+    auto victim_queue_index = find_ready_queue_to_steal_from(local_queue_index, affinity_mask);
+    if (!victim_queue_index.has_value())
         return nullptr;
+    return (*g_ready_queues)[victim_queue_index.value()].with([&](auto& ready_queues) -> Thread* {
+        u32 priority = 0;
+        return find_runnable_thread(ready_queues, affinity_mask, priority);
     });
 }
 
@@ -139,9 +281,8 @@ bool Scheduler::dequeue_runnable_thread(Thread& thread, bool check_affinity)
     if (thread.is_idle_thread())
         return true;
 
-    return g_ready_queues->with([&](auto& ready_queues) {
-        auto priority = thread.m_runnable_priority;
-        if (priority < 0) {
+    return (*g_ready_queues)[thread.m_runnable_processor].with([&](auto& ready_queues) {
+        if (thread.m_runnable_priority < 0) {
             VERIFY(!thread.m_ready_queue_node.is_in_list());
             return false;
         }
@@ -149,12 +290,7 @@ bool Scheduler::dequeue_runnable_thread(Thread& thread, bool check_affinity)
         if (check_affinity && !(thread.affinity() & (1 << Processor::current_id())))
             return false;
 
-        VERIFY(ready_queues.mask & (1u << priority));
-        auto& ready_queue = ready_queues.queues[priority];
-        thread.m_runnable_priority = -1;
-        ready_queue.thread_list.remove(thread);
-        if (ready_queue.thread_list.is_empty())
-            ready_queues.mask &= ~(1u << priority);
+        remove_from_ready_queue(ready_queues, thread);
         return true;
     });
 }
@@ -165,16 +301,19 @@ void Scheduler::enqueue_runnable_thread(Thread& thread)
     if (thread.is_idle_thread())
         return;
     auto priority = thread_priority_to_priority_index(thread.priority());
+    auto queue_index = select_ready_queue_for(thread);
 
-    g_ready_queues->with([&](auto& ready_queues) {
+    (*g_ready_queues)[queue_index].with([&](auto& ready_queues) {
         VERIFY(thread.m_runnable_priority < 0);
         thread.m_runnable_priority = (int)priority;
+        thread.m_runnable_processor = queue_index;
         VERIFY(!thread.m_ready_queue_node.is_in_list());
         auto& ready_queue = ready_queues.queues[priority];
         bool was_empty = ready_queue.thread_list.is_empty();
         ready_queue.thread_list.append(thread);
         if (was_empty)
             ready_queues.mask |= (1u << priority);
+        ready_queues.thread_count++;
     });
 }
 
@@ -372,6 +511,7 @@ UNMAP_AFTER_INIT void Scheduler::initialize()
     g_finalizer_wait_queue = new WaitQueue;
 
     g_finalizer_has_work.store(false, AK::MemoryOrder::memory_order_release);
+    s_ready_queue_mode = kernel_command_line().scheduler_ready_queue_mode();
     auto [colonel_process, idle_thread] = MUST(Process::create_kernel_process("colonel"sv, idle_loop, nullptr, 1, Process::RegisterProcess::No));
     s_colonel_process = &colonel_process.leak_ref();
     idle_thread->set_priority(THREAD_PRIORITY_MIN);
@@ -507,6 +647,12 @@ void dump_thread_list(bool with_stack_traces)
 {
     dbgln("Scheduler thread list for processor {}:", Processor::current_id());
 
+    for (u32 queue_index = 0; queue_index < ready_queue_processor_count(); ++queue_index) {
+        (*g_ready_queues)[queue_index].with([&](auto& ready_queues) {
+            dbgln("  Ready queue {}: {} runnable, {} stolen", queue_index, ready_queues.thread_count, ready_queues.steal_count);
+        });
+    }
+
     auto get_eip = [](Thread& thread) -> u32 {
         if (!thread.current_trap())
             return thread.regs().ip();
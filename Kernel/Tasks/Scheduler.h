@@ -9,6 +9,7 @@
 #include <AK/Assertions.h>
 #include <AK/Function.h>
 #include <AK/IntrusiveList.h>
+#include <AK/Optional.h>
 #include <AK/Types.h>
 #include <Kernel/Forward.h>
 #include <Kernel/Locking/Spinlock.h>
@@ -18,6 +19,7 @@
 namespace Kernel {
 
 struct RegisterState;
+struct ThreadReadyQueues;
 
 extern Thread* g_finalizer;
 extern WaitQueue* g_finalizer_wait_queue;
@@ -55,6 +57,12 @@ public:
     static bool is_initialized();
     static TotalTimeScheduled get_total_time_scheduled();
     static void add_time_scheduled(u64, bool);
+
+private:
+    static Thread* find_runnable_thread(ThreadReadyQueues&, u32 affinity_mask, u32& found_priority);
+    static Thread* take_runnable_thread(ThreadReadyQueues&, u32 affinity_mask);
+    static void remove_from_ready_queue(ThreadReadyQueues&, Thread&);
+    static Optional<u32> find_ready_queue_to_steal_from(u32 local_queue_index, u32 affinity_mask);
 };
 
 }
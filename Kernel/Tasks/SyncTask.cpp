@@ -16,9 +16,18 @@ UNMAP_AFTER_INIT void SyncTask::spawn()
 {
     MUST(Process::create_kernel_process("VFS Sync Task"sv, [] {
         dbgln("VFS SyncTask is running");
+        auto const sync_interval = Duration::from_seconds(1);
+        auto next_sync_time = TimeManagement::the().monotonic_time(TimePrecision::Coarse);
         while (!Process::current().is_dying()) {
-            VirtualFileSystem::sync();
-            (void)Thread::current()->sleep(Duration::from_seconds(1));
+            if (MM.is_memory_low())
+                VirtualFileSystem::the().release_file_system_cache_memory();
+            auto now = TimeManagement::the().monotonic_time(TimePrecision::Coarse);
+            if (now >= next_sync_time) {
+                VirtualFileSystem::sync();
+                next_sync_time = now + sync_interval;
+            }
+            // Running low on memory wakes us up early, so the file system caches can shrink right away.
+            MM.wait_for_low_memory(next_sync_time - now);
         }
         Process::current().sys$exit(0);
         VERIFY_NOT_REACHED();
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/HashTable.h>
+#include <AK/JsonArray.h>
+#include <AK/JsonObject.h>
+#include <AK/JsonValue.h>
+#include <LibCore/File.h>
+#include <LibTest/TestCase.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+static JsonObject read_json_object(StringView path)
+{
+    auto file = MUST(Core::File::open(path, Core::File::OpenMode::Read));
+    auto json = MUST(JsonValue::from_string(MUST(file->read_until_eof())));
+    return json.as_object();
+}
+
+struct DiskCache {
+    u64 size { 0 };
+    bool is_minimal { false };
+};
+
+// Bind mounts show up more than once, but they share their file system's cache.
+static Vector<DiskCache> read_disk_caches(JsonObject const& disk_cache_info)
+{
+    Vector<DiskCache> caches;
+    HashTable<u64> seen_file_systems;
+    disk_cache_info.get_array("file_systems"sv)->for_each([&](auto const& value) {
+        auto const& fs = value.as_object();
+        if (seen_file_systems.set(fs.get_u64("fsid"sv).value()) != HashSetResult::InsertedNewEntry)
+            return;
+        caches.append({
+            .size = fs.get_u64("capacity"sv).value() * fs.get_u64("block_size"sv).value(),
+            // Caches never shrink below one segment per shard.
+            .is_minimal = fs.get_u64("segments"sv).value() == fs.get_u64("shards"sv).value(),
+        });
+    });
+    return caches;
+}
+
+TEST_CASE(disk_caches_share_one_budget)
+{
+    auto disk_cache_info = read_json_object("/sys/kernel/diskcache"sv);
+    auto budget = disk_cache_info.get_u64("budget"sv).value();
+    auto budget_used = disk_cache_info.get_u64("budget_used"sv).value();
+
+    auto memory_status = read_json_object("/sys/kernel/memstat"sv);
+    auto physical_pages = memory_status.get_u64("physical_allocated"sv).value() + memory_status.get_u64("physical_available"sv).value();
+    EXPECT_EQ(budget, physical_pages * PAGE_SIZE / 8);
+
+    auto caches = read_disk_caches(disk_cache_info);
+    EXPECT(!caches.is_empty());
+
+    u64 total_size = 0;
+    bool all_caches_are_minimal = true;
+    for (auto const& cache : caches) {
+        total_size += cache.size;
+        all_caches_are_minimal &= cache.is_minimal;
+        // A cache can only grow into its share of the budget.
+        if (!cache.is_minimal)
+            EXPECT(cache.size <= budget / caches.size() || cache.size <= 64 * MiB);
+    }
+
+    // Every cache is guaranteed its minimal size, which is the only way to go over the budget.
+    EXPECT(budget_used <= budget || all_caches_are_minimal);
+    // Unmounted caches may linger until their file system goes away, so this isn't exact.
+    EXPECT(total_size <= budget_used);
+}
+
+TEST_CASE(disk_caches_shrink_when_memory_is_low)
+{
+    auto memory_status = read_json_object("/sys/kernel/memstat"sv);
+    auto physical_pages = memory_status.get_u64("physical_allocated"sv).value() + memory_status.get_u64("physical_available"sv).value();
+    auto uncommitted_pages = memory_status.get_u64("physical_uncommitted"sv).value();
+
+    // Commit just enough memory to count as low on memory. Anonymous private mappings are committed up front.
+    auto low_memory_watermark = physical_pages / 16;
+    if (uncommitted_pages <= low_memory_watermark)
+        return;
+    auto size = (uncommitted_pages - low_memory_watermark + 16) * PAGE_SIZE;
+    auto* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, 0, 0);
+    EXPECT_NE(ptr, MAP_FAILED);
+    if (ptr == MAP_FAILED)
+        return;
+
+    // The caches should give back everything they grew into without waiting for the next sync.
+    bool all_caches_are_minimal = false;
+    for (int attempt = 0; attempt < 50 && !all_caches_are_minimal; ++attempt) {
+        usleep(100'000);
+        all_caches_are_minimal = true;
+        for (auto const& cache : read_disk_caches(read_json_object("/sys/kernel/diskcache"sv)))
+            all_caches_are_minimal &= cache.is_minimal;
+    }
+    EXPECT(all_caches_are_minimal);
+
+    EXPECT_EQ(munmap(ptr, size), 0);
+}
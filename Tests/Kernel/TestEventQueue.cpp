@@ -0,0 +1,255 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <LibTest/TestCase.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <serenity.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+
+struct Pipe {
+    Pipe()
+    {
+        VERIFY(pipe2(fds, O_CLOEXEC | O_NONBLOCK) == 0);
+    }
+
+    ~Pipe()
+    {
+        close_read_end();
+        close_write_end();
+    }
+
+    void close_read_end()
+    {
+        if (fds[0] != -1)
+            close(fds[0]);
+        fds[0] = -1;
+    }
+
+    void close_write_end()
+    {
+        if (fds[1] != -1)
+            close(fds[1]);
+        fds[1] = -1;
+    }
+
+    int read_fd() const { return fds[0]; }
+    int write_fd() const { return fds[1]; }
+
+    void write_byte() const
+    {
+        char byte = 'x';
+        VERIFY(write(fds[1], &byte, 1) == 1);
+    }
+
+    void read_byte() const
+    {
+        char byte;
+        VERIFY(read(fds[0], &byte, 1) == 1);
+    }
+
+    int fds[2] { -1, -1 };
+};
+
+// Returns the number of ready events, without blocking.
+static int poll_event_queue(int queue_fd, Array<pollfd, 4>& events)
+{
+    timespec timeout {};
+    return event_queue_wait(queue_fd, events.data(), events.size(), &timeout);
+}
+
+TEST_CASE(level_triggered_events_are_reported_while_ready)
+{
+    auto queue_fd = event_queue_create(O_CLOEXEC);
+    EXPECT(queue_fd >= 0);
+    Pipe pipe;
+    EXPECT_EQ(event_queue_control(queue_fd, EVENT_QUEUE_ADD, pipe.read_fd(), POLLIN), 0);
+
+    Array<pollfd, 4> events;
+    EXPECT_EQ(poll_event_queue(queue_fd, events), 0);
+
+    pipe.write_byte();
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(poll_event_queue(queue_fd, events), 1);
+        EXPECT_EQ(events[0].fd, pipe.read_fd());
+        EXPECT(events[0].revents & POLLIN);
+    }
+
+    pipe.read_byte();
+    EXPECT_EQ(poll_event_queue(queue_fd, events), 0);
+
+    close(queue_fd);
+}
+
+TEST_CASE(wait_blocks_until_ready)
+{
+    auto queue_fd = event_queue_create(O_CLOEXEC);
+    Pipe pipe;
+    EXPECT_EQ(event_queue_control(queue_fd, EVENT_QUEUE_ADD, pipe.read_fd(), POLLIN), 0);
+
+    Array<pollfd, 4> events;
+    timespec timeout { .tv_sec = 0, .tv_nsec = 10'000'000 };
+    EXPECT_EQ(event_queue_wait(queue_fd, events.data(), events.size(), &timeout), 0);
+
+    pipe.write_byte();
+    EXPECT_EQ(event_queue_wait(queue_fd, events.data(), events.size(), nullptr), 1);
+    EXPECT_EQ(events[0].fd, pipe.read_fd());
+
+    close(queue_fd);
+}
+
+TEST_CASE(control_errors)
+{
+    auto queue_fd = event_queue_create(O_CLOEXEC);
+    Pipe pipe;
+
+    EXPECT_EQ(event_queue_control(queue_fd, EVENT_QUEUE_MODIFY, pipe.read_fd(), POLLIN), -1);
+    EXPECT_EQ(errno, ENOENT);
+    EXPECT_EQ(event_queue_control(queue_fd, EVENT_QUEUE_REMOVE, pipe.read_fd(), 0), -1);
+    EXPECT_EQ(errno, ENOENT);
+
+    EXPECT_EQ(event_queue_control(queue_fd, EVENT_QUEUE_ADD, pipe.read_fd(), POLLIN), 0);
+    EXPECT_EQ(event_queue_control(queue_fd, EVENT_QUEUE_ADD, pipe.read_fd(), POLLIN), -1);
+    EXPECT_EQ(errno, EEXIST);
+
+    // Event queues can't watch each other.
+    EXPECT_EQ(event_queue_control(queue_fd, EVENT_QUEUE_ADD, queue_fd, POLLIN), -1);
+    EXPECT_EQ(errno, EINVAL);
+
+    EXPECT_EQ(event_queue_control(queue_fd, EVENT_QUEUE_ADD, 12345, POLLIN), -1);
+    EXPECT_EQ(errno, EBADF);
+    EXPECT_EQ(event_queue_control(pipe.read_fd(), EVENT_QUEUE_ADD, pipe.write_fd(), POLLOUT), -1);
+    EXPECT_EQ(errno, EINVAL);
+
+    close(queue_fd);
+}
+
+TEST_CASE(modify_and_remove)
+{
+    auto queue_fd = event_queue_create(O_CLOEXEC);
+    Pipe pipe;
+    pipe.write_byte();
+
+    // The pipe is readable, but we only care about priority data at first.
+    EXPECT_EQ(event_queue_control(queue_fd, EVENT_QUEUE_ADD, pipe.read_fd(), POLLPRI), 0);
+    Array<pollfd, 4> events;
+    EXPECT_EQ(poll_event_queue(queue_fd, events), 0);
+
+    EXPECT_EQ(event_queue_control(queue_fd, EVENT_QUEUE_MODIFY, pipe.read_fd(), POLLIN), 0);
+    EXPECT_EQ(poll_event_queue(queue_fd, events), 1);
+    EXPECT(events[0].revents & POLLIN);
+
+    EXPECT_EQ(event_queue_control(queue_fd, EVENT_QUEUE_REMOVE, pipe.read_fd(), 0), 0);
+    EXPECT_EQ(poll_event_queue(queue_fd, events), 0);
+
+    close(queue_fd);
+}
+
+TEST_CASE(closing_a_watched_fd_drops_its_watch)
+{
+    // Make the write below fail with EPIPE instead of killing us.
+    signal(SIGPIPE, SIG_IGN);
+
+    auto queue_fd = event_queue_create(O_CLOEXEC);
+    Pipe pipe;
+    EXPECT_EQ(event_queue_control(queue_fd, EVENT_QUEUE_ADD, pipe.read_fd(), POLLIN), 0);
+    auto watched_fd = pipe.read_fd();
+    pipe.close_read_end();
+
+    // The event queue must not keep the read end open.
+    char byte = 'x';
+    EXPECT_EQ(write(pipe.write_fd(), &byte, 1), -1);
+    EXPECT_EQ(errno, EPIPE);
+
+    Array<pollfd, 4> events;
+    EXPECT_EQ(poll_event_queue(queue_fd, events), 0);
+    EXPECT_EQ(event_queue_control(queue_fd, EVENT_QUEUE_REMOVE, watched_fd, 0), -1);
+    EXPECT_EQ(errno, ENOENT);
+
+    close(queue_fd);
+}
+
+TEST_CASE(duplicated_watched_fd_keeps_its_watch)
+{
+    auto queue_fd = event_queue_create(O_CLOEXEC);
+    Pipe pipe;
+    EXPECT_EQ(event_queue_control(queue_fd, EVENT_QUEUE_ADD, pipe.read_fd(), POLLIN), 0);
+    auto watched_fd = pipe.read_fd();
+    auto duplicate_fd = dup(watched_fd);
+    pipe.close_read_end();
+
+    // Another fd still refers to the same description, so it's still being watched under the old fd.
+    pipe.write_byte();
+    Array<pollfd, 4> events;
+    EXPECT_EQ(poll_event_queue(queue_fd, events), 1);
+    EXPECT_EQ(events[0].fd, watched_fd);
+
+    close(duplicate_fd);
+    EXPECT_EQ(poll_event_queue(queue_fd, events), 0);
+
+    close(queue_fd);
+}
+
+TEST_CASE(edge_triggered_events_are_reported_once_per_change)
+{
+    auto queue_fd = event_queue_create(O_CLOEXEC);
+    Pipe pipe;
+    EXPECT_EQ(event_queue_control(queue_fd, EVENT_QUEUE_ADD, pipe.read_fd(), POLLIN | EVENT_QUEUE_EDGE_TRIGGERED), 0);
+
+    pipe.write_byte();
+    Array<pollfd, 4> events;
+    EXPECT_EQ(poll_event_queue(queue_fd, events), 1);
+    EXPECT_EQ(events[0].fd, pipe.read_fd());
+    EXPECT(events[0].revents & POLLIN);
+    // It's still readable, but nothing changed.
+    EXPECT_EQ(poll_event_queue(queue_fd, events), 0);
+
+    pipe.write_byte();
+    EXPECT_EQ(poll_event_queue(queue_fd, events), 1);
+    EXPECT_EQ(poll_event_queue(queue_fd, events), 0);
+
+    close(queue_fd);
+}
+
+TEST_CASE(one_shot_events_are_reported_once_until_modified)
+{
+    auto queue_fd = event_queue_create(O_CLOEXEC);
+    Pipe pipe;
+    EXPECT_EQ(event_queue_control(queue_fd, EVENT_QUEUE_ADD, pipe.read_fd(), POLLIN | EVENT_QUEUE_ONE_SHOT), 0);
+
+    pipe.write_byte();
+    Array<pollfd, 4> events;
+    EXPECT_EQ(poll_event_queue(queue_fd, events), 1);
+    EXPECT_EQ(events[0].fd, pipe.read_fd());
+
+    // Not even new data wakes it up again.
+    pipe.write_byte();
+    EXPECT_EQ(poll_event_queue(queue_fd, events), 0);
+
+    EXPECT_EQ(event_queue_control(queue_fd, EVENT_QUEUE_MODIFY, pipe.read_fd(), POLLIN | EVENT_QUEUE_ONE_SHOT), 0);
+    EXPECT_EQ(poll_event_queue(queue_fd, events), 1);
+    EXPECT_EQ(poll_event_queue(queue_fd, events), 0);
+
+    close(queue_fd);
+}
+
+TEST_CASE(event_queue_is_pollable)
+{
+    auto queue_fd = event_queue_create(O_CLOEXEC);
+    Pipe pipe;
+    EXPECT_EQ(event_queue_control(queue_fd, EVENT_QUEUE_ADD, pipe.read_fd(), POLLIN), 0);
+
+    pipe.write_byte();
+    pollfd queue_pollfd { .fd = queue_fd, .events = POLLIN, .revents = 0 };
+    EXPECT_EQ(poll(&queue_pollfd, 1, 1000), 1);
+    EXPECT(queue_pollfd.revents & POLLIN);
+
+    close(queue_fd);
+}
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/JsonArray.h>
+#include <AK/JsonObject.h>
+#include <AK/JsonValue.h>
+#include <AK/Platform.h>
+#include <AK/Types.h>
+#include <LibCore/File.h>
+#include <LibTest/TestCase.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static constexpr size_t huge_page_size = 2 * MiB;
+static constexpr size_t mapping_size = 4 * huge_page_size;
+
+static u8* map_huge_page_candidate()
+{
+    auto* ptr = serenity_mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, 0, 0, huge_page_size, "huge pages");
+    VERIFY(ptr != MAP_FAILED);
+    EXPECT_EQ(madvise(ptr, mapping_size, MADV_HUGEPAGE), 0);
+    return static_cast<u8*>(ptr);
+}
+
+// How much of the region starting at the given address is mapped with huge pages, according to /proc/self/vm.
+static size_t amount_huge_at(void const* address)
+{
+    auto file = MUST(Core::File::open("/proc/self/vm"sv, Core::File::OpenMode::Read));
+    auto json = MUST(JsonValue::from_string(MUST(file->read_until_eof())));
+    for (auto const& value : json.as_array().values()) {
+        auto const& region = value.as_object();
+        if (region.get_addr("address"sv).value_or(0) == reinterpret_cast<FlatPtr>(address))
+            return region.get_u64("amount_huge"sv).value_or(0);
+    }
+    VERIFY_NOT_REACHED();
+}
+
+// Huge pages are only supported on x86_64; everywhere else, opting in has no effect.
+static size_t expected_amount_huge(size_t size)
+{
+#if ARCH(X86_64)
+    return size;
+#else
+    (void)size;
+    return 0;
+#endif
+}
+
+static void fill(u8* ptr, size_t size)
+{
+    for (size_t i = 0; i < size; i += PAGE_SIZE)
+        ptr[i] = static_cast<u8>(i / PAGE_SIZE);
+}
+
+static bool has_pattern(u8 const* ptr, size_t offset, size_t size)
+{
+    for (size_t i = offset; i < offset + size; i += PAGE_SIZE) {
+        if (ptr[i] != static_cast<u8>(i / PAGE_SIZE))
+            return false;
+    }
+    return true;
+}
+
+TEST_CASE(huge_pages_are_used)
+{
+    auto* ptr = map_huge_page_candidate();
+    EXPECT_EQ(amount_huge_at(ptr), 0u);
+
+    fill(ptr, mapping_size);
+    EXPECT_EQ(amount_huge_at(ptr), expected_amount_huge(mapping_size));
+    EXPECT(has_pattern(ptr, 0, mapping_size));
+
+    EXPECT_EQ(munmap(ptr, mapping_size), 0);
+}
+
+TEST_CASE(huge_page_data_survives_partial_munmap)
+{
+    auto* ptr = map_huge_page_candidate();
+    fill(ptr, mapping_size);
+    EXPECT_EQ(amount_huge_at(ptr), expected_amount_huge(mapping_size));
+
+    // Punch a hole into the middle of the second huge page.
+    EXPECT_EQ(munmap(ptr + huge_page_size + PAGE_SIZE, PAGE_SIZE), 0);
+
+    EXPECT(has_pattern(ptr, 0, huge_page_size + PAGE_SIZE));
+    EXPECT(has_pattern(ptr, huge_page_size + 2 * PAGE_SIZE, mapping_size - huge_page_size - 2 * PAGE_SIZE));
+
+    // Only the huge page with the hole in it had to be split.
+    EXPECT_EQ(amount_huge_at(ptr), expected_amount_huge(huge_page_size));
+
+    // The rest of the split huge page must still be writable.
+    ptr[huge_page_size + 2 * PAGE_SIZE] = 0xaa;
+    EXPECT_EQ(ptr[huge_page_size + 2 * PAGE_SIZE], 0xaa);
+
+    EXPECT_EQ(munmap(ptr, huge_page_size + PAGE_SIZE), 0);
+    EXPECT_EQ(munmap(ptr + huge_page_size + 2 * PAGE_SIZE, mapping_size - huge_page_size - 2 * PAGE_SIZE), 0);
+}
+
+TEST_CASE(huge_page_data_survives_partial_mprotect)
+{
+    auto* ptr = map_huge_page_candidate();
+    fill(ptr, mapping_size);
+
+    EXPECT_EQ(mprotect(ptr + PAGE_SIZE, PAGE_SIZE, PROT_READ), 0);
+    EXPECT(has_pattern(ptr, 0, mapping_size));
+
+    // Pages around the read-only one are still writable.
+    ptr[0] = 0x55;
+    ptr[2 * PAGE_SIZE] = 0x55;
+    EXPECT_EQ(ptr[0], 0x55);
+    EXPECT_EQ(ptr[2 * PAGE_SIZE], 0x55);
+
+    EXPECT_EQ(mprotect(ptr + PAGE_SIZE, PAGE_SIZE, PROT_READ | PROT_WRITE), 0);
+    ptr[PAGE_SIZE] = 0x55;
+    EXPECT_EQ(ptr[PAGE_SIZE], 0x55);
+
+    EXPECT_EQ(munmap(ptr, mapping_size), 0);
+}
+
+TEST_CASE(huge_page_is_copied_on_write_after_fork)
+{
+    auto* ptr = map_huge_page_candidate();
+    fill(ptr, mapping_size);
+
+    pid_t pid = fork();
+    VERIFY(pid >= 0);
+    if (pid == 0) {
+        bool ok = has_pattern(ptr, 0, mapping_size);
+        for (size_t i = 0; i < mapping_size; i += PAGE_SIZE)
+            ptr[i] = 0xff;
+        _exit(ok ? 0 : 1);
+    }
+
+    int status = 0;
+    EXPECT_EQ(waitpid(pid, &status, 0), pid);
+    EXPECT(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+
+    // The child's writes must not be visible to us.
+    EXPECT(has_pattern(ptr, 0, mapping_size));
+    ptr[0] = 0x55;
+    EXPECT_EQ(ptr[0], 0x55);
+
+    EXPECT_EQ(munmap(ptr, mapping_size), 0);
+}
+
+TEST_CASE(huge_page_opt_out)
+{
+    auto* ptr = map_huge_page_candidate();
+    fill(ptr, mapping_size);
+
+    EXPECT_EQ(amount_huge_at(ptr), expected_amount_huge(mapping_size));
+
+    EXPECT_EQ(madvise(ptr, mapping_size, MADV_NOHUGEPAGE), 0);
+    EXPECT_EQ(amount_huge_at(ptr), 0u);
+    EXPECT(has_pattern(ptr, 0, mapping_size));
+
+    // Untouched memory isn't faulted in as huge pages anymore either.
+    auto* other = map_huge_page_candidate();
+    EXPECT_EQ(madvise(other, mapping_size, MADV_NOHUGEPAGE), 0);
+    fill(other, mapping_size);
+    EXPECT_EQ(amount_huge_at(other), 0u);
+    EXPECT_EQ(munmap(other, mapping_size), 0);
+
+    EXPECT_EQ(munmap(ptr, mapping_size), 0);
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <AK/Atomic.h>
+#include <AK/ScopeGuard.h>
+#include <AK/Vector.h>
+#include <LibTest/TestCase.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+
+// Sequential reads make the kernel read ahead into the disk cache while other threads keep writing to the same
+// blocks. Whatever the read-ahead brings in must never replace data that was written after the device read began.
+
+static constexpr auto test_file_path = "/home/anon/.read_ahead_test";
+static constexpr size_t block_size = 4 * KiB;
+static constexpr size_t block_count = 2048;
+static constexpr u32 rounds = 16;
+
+struct Context {
+    int fd { -1 };
+    Atomic<bool> writer_done { false };
+    // The latest version the writer has finished writing to each block.
+    Array<Atomic<u32>, block_count> written_versions {};
+    Atomic<bool> failed { false };
+};
+
+struct ReaderContext {
+    Context& context;
+    // Read-ahead is tracked per description, so every reader needs its own.
+    int fd { -1 };
+};
+
+static void write_version(int fd, size_t block, u32 version)
+{
+    Array<u32, block_size / sizeof(u32)> data;
+    data.fill(version);
+    auto nwritten = pwrite(fd, data.data(), block_size, block * block_size);
+    VERIFY(nwritten == block_size);
+}
+
+static void* write_blocks(void* argument)
+{
+    auto& context = *static_cast<Context*>(argument);
+    for (u32 version = 1; version <= rounds; ++version) {
+        for (size_t block = 0; block < block_count; block += 3) {
+            write_version(context.fd, block, version);
+            context.written_versions[block].store(version);
+        }
+        // Push the writes out to the device, so that the cached copies may be evicted and read again.
+        if (fsync(context.fd) < 0)
+            context.failed.store(true);
+    }
+    context.writer_done.store(true);
+    return nullptr;
+}
+
+static void* read_blocks_sequentially(void* argument)
+{
+    auto& reader = *static_cast<ReaderContext*>(argument);
+    auto& context = reader.context;
+    Array<u32, 16 * block_size / sizeof(u32)> buffer;
+    static constexpr size_t blocks_per_read = sizeof(buffer) / block_size;
+    Vector<u32> seen_versions;
+    seen_versions.resize(block_count);
+
+    while (!context.writer_done.load()) {
+        for (size_t block = 0; block < block_count; block += blocks_per_read) {
+            // Anything finished before the read started has to show up in it.
+            Array<u32, blocks_per_read> minimum_versions;
+            for (size_t i = 0; i < blocks_per_read; ++i)
+                minimum_versions[i] = context.written_versions[block + i].load();
+
+            auto nread = pread(reader.fd, buffer.data(), sizeof(buffer), block * block_size);
+            if (nread != sizeof(buffer)) {
+                context.failed.store(true);
+                return nullptr;
+            }
+            for (size_t i = 0; i < blocks_per_read; ++i) {
+                auto version = buffer[i * block_size / sizeof(u32)];
+                if (version < minimum_versions[i] || version < seen_versions[block + i]) {
+                    warnln("Block {} went back to version {} (expected at least {})", block + i, version, max(minimum_versions[i], seen_versions[block + i]));
+                    context.failed.store(true);
+                }
+                seen_versions[block + i] = version;
+            }
+        }
+    }
+    return nullptr;
+}
+
+TEST_CASE(read_ahead_does_not_overwrite_newer_writes)
+{
+    auto fd = open(test_file_path, O_CREAT | O_TRUNC | O_RDWR, 0600);
+    EXPECT(fd >= 0);
+    if (fd < 0)
+        return;
+    auto cleanup_guard = ScopeGuard([&] {
+        close(fd);
+        unlink(test_file_path);
+    });
+
+    for (size_t block = 0; block < block_count; ++block)
+        write_version(fd, block, 0);
+    EXPECT_EQ(fsync(fd), 0);
+
+    Context context { .fd = fd };
+    Vector<ReaderContext> readers;
+    for (size_t i = 0; i < 2; ++i) {
+        auto reader_fd = open(test_file_path, O_RDONLY);
+        EXPECT(reader_fd >= 0);
+        readers.append({ context, reader_fd });
+    }
+
+    pthread_t writer_thread;
+    Array<pthread_t, 2> reader_threads;
+    EXPECT_EQ(pthread_create(&writer_thread, nullptr, write_blocks, &context), 0);
+    for (size_t i = 0; i < reader_threads.size(); ++i)
+        EXPECT_EQ(pthread_create(&reader_threads[i], nullptr, read_blocks_sequentially, &readers[i]), 0);
+    EXPECT_EQ(pthread_join(writer_thread, nullptr), 0);
+    for (auto thread : reader_threads)
+        EXPECT_EQ(pthread_join(thread, nullptr), 0);
+    for (auto& reader : readers)
+        close(reader.fd);
+    EXPECT(!context.failed.load());
+
+    // In the end, every block has to hold the last version that was written to it.
+    for (size_t block = 0; block < block_count; ++block) {
+        u32 version = 0;
+        EXPECT_EQ(pread(fd, &version, sizeof(version), block * block_size), static_cast<ssize_t>(sizeof(version)));
+        EXPECT_EQ(version, context.written_versions[block].load());
+    }
+}
@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ByteBuffer.h>
+#include <AK/ScopeGuard.h>
+#include <AK/String.h>
+#include <LibTest/TestCase.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Larger than the kernel's 64 KiB transfer buffer, so that sendfile() has to go around several times.
+static constexpr size_t file_size = 1 * MiB;
+
+static u8 byte_at(size_t offset)
+{
+    return static_cast<u8>((offset * 7) ^ (offset >> 8));
+}
+
+static int create_test_file()
+{
+    char pattern[] = "/tmp/sendfile_test.XXXXXX";
+    auto fd = mkstemp(pattern);
+    VERIFY(fd >= 0);
+    unlink(pattern);
+
+    auto contents = MUST(ByteBuffer::create_uninitialized(file_size));
+    for (size_t i = 0; i < file_size; ++i)
+        contents[i] = byte_at(i);
+    VERIFY(write(fd, contents.data(), contents.size()) == static_cast<ssize_t>(file_size));
+    VERIFY(lseek(fd, 0, SEEK_SET) == 0);
+    return fd;
+}
+
+struct Sockets {
+    int sender { -1 };
+    int receiver { -1 };
+};
+
+static Sockets create_sockets()
+{
+    int fds[2];
+    VERIFY(socketpair(AF_LOCAL, SOCK_STREAM, 0, fds) == 0);
+    return { fds[0], fds[1] };
+}
+
+struct Receiver {
+    int fd { -1 };
+    size_t expected_size { 0 };
+    ByteBuffer received {};
+    pthread_t thread {};
+};
+
+static void* receive(void* argument)
+{
+    auto& receiver = *static_cast<Receiver*>(argument);
+    u8 buffer[4096];
+    while (receiver.received.size() < receiver.expected_size) {
+        auto nread = read(receiver.fd, buffer, sizeof(buffer));
+        if (nread <= 0)
+            break;
+        receiver.received.append(buffer, nread);
+    }
+    return nullptr;
+}
+
+// Socket buffers are smaller than what we send, so someone has to keep reading on the other end.
+static void start_receiving(Receiver& receiver)
+{
+    VERIFY(pthread_create(&receiver.thread, nullptr, receive, &receiver) == 0);
+}
+
+static void finish_receiving(Receiver& receiver)
+{
+    VERIFY(pthread_join(receiver.thread, nullptr) == 0);
+}
+
+static void expect_file_contents(ReadonlyBytes bytes, size_t file_offset)
+{
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        if (bytes[i] != byte_at(file_offset + i)) {
+            FAIL(MUST(String::formatted("Byte {} of the file was sent as {}", file_offset + i, bytes[i])));
+            return;
+        }
+    }
+}
+
+TEST_CASE(file_to_socket_with_offset)
+{
+    auto fd = create_test_file();
+    auto sockets = create_sockets();
+    ScopeGuard guard = [&] {
+        close(fd);
+        close(sockets.sender);
+        close(sockets.receiver);
+    };
+
+    Receiver receiver { .fd = sockets.receiver, .expected_size = file_size - 1000 };
+    start_receiving(receiver);
+    off_t offset = 1000;
+    size_t total_sent = 0;
+    while (total_sent < file_size - 1000) {
+        auto nsent = sendfile(sockets.sender, fd, &offset, file_size);
+        EXPECT(nsent > 0);
+        if (nsent <= 0)
+            break;
+        total_sent += nsent;
+        EXPECT_EQ(offset, static_cast<off_t>(1000 + total_sent));
+    }
+    finish_receiving(receiver);
+
+    EXPECT_EQ(total_sent, file_size - 1000);
+    EXPECT_EQ(receiver.received.size(), file_size - 1000);
+    expect_file_contents(receiver.received, 1000);
+
+    // The file offset is left alone when an explicit offset is given.
+    EXPECT_EQ(lseek(fd, 0, SEEK_CUR), 0);
+}
+
+TEST_CASE(file_to_socket_without_offset)
+{
+    auto fd = create_test_file();
+    auto sockets = create_sockets();
+    ScopeGuard guard = [&] {
+        close(fd);
+        close(sockets.sender);
+        close(sockets.receiver);
+    };
+
+    EXPECT_EQ(lseek(fd, 4096, SEEK_SET), 4096);
+    Receiver receiver { .fd = sockets.receiver, .expected_size = 200 * KiB };
+    start_receiving(receiver);
+    size_t total_sent = 0;
+    while (total_sent < 200 * KiB) {
+        auto nsent = sendfile(sockets.sender, fd, nullptr, 200 * KiB - total_sent);
+        EXPECT(nsent > 0);
+        if (nsent <= 0)
+            break;
+        total_sent += nsent;
+        // Without an explicit offset, the file offset advances instead.
+        EXPECT_EQ(lseek(fd, 0, SEEK_CUR), static_cast<off_t>(4096 + total_sent));
+    }
+    finish_receiving(receiver);
+
+    EXPECT_EQ(receiver.received.size(), 200 * KiB);
+    expect_file_contents(receiver.received, 4096);
+}
+
+TEST_CASE(short_transfer_at_end_of_file)
+{
+    auto fd = create_test_file();
+    auto sockets = create_sockets();
+    ScopeGuard guard = [&] {
+        close(fd);
+        close(sockets.sender);
+        close(sockets.receiver);
+    };
+
+    off_t offset = file_size - 100;
+    EXPECT_EQ(sendfile(sockets.sender, fd, &offset, 1000), 100);
+    EXPECT_EQ(offset, static_cast<off_t>(file_size));
+
+    u8 buffer[100];
+    EXPECT_EQ(read(sockets.receiver, buffer, sizeof(buffer)), 100);
+    expect_file_contents({ buffer, sizeof(buffer) }, file_size - 100);
+
+    // Nothing is left to send at the end of the file.
+    EXPECT_EQ(sendfile(sockets.sender, fd, &offset, 1000), 0);
+    EXPECT_EQ(offset, static_cast<off_t>(file_size));
+}
+
+TEST_CASE(short_transfer_to_full_socket)
+{
+    auto fd = create_test_file();
+    auto sockets = create_sockets();
+    ScopeGuard guard = [&] {
+        close(fd);
+        close(sockets.sender);
+        close(sockets.receiver);
+    };
+
+    EXPECT_EQ(fcntl(sockets.sender, F_SETFL, O_NONBLOCK), 0);
+
+    // Nobody reads from the socket, so it fills up before the whole file has been sent.
+    off_t offset = 0;
+    auto nsent = sendfile(sockets.sender, fd, &offset, file_size);
+    EXPECT(nsent > 0);
+    EXPECT(static_cast<size_t>(nsent) < file_size);
+    EXPECT_EQ(offset, static_cast<off_t>(nsent));
+
+    // Once it's full, there is nothing that could be sent.
+    errno = 0;
+    EXPECT_EQ(sendfile(sockets.sender, fd, &offset, file_size), -1);
+    EXPECT_EQ(errno, EAGAIN);
+    EXPECT_EQ(offset, static_cast<off_t>(nsent));
+
+    // What did make it into the socket is exactly the start of the file.
+    EXPECT_EQ(fcntl(sockets.receiver, F_SETFL, O_NONBLOCK), 0);
+    auto received = MUST(ByteBuffer::create_uninitialized(nsent));
+    size_t total_received = 0;
+    while (total_received < static_cast<size_t>(nsent)) {
+        auto nread = read(sockets.receiver, received.data() + total_received, nsent - total_received);
+        EXPECT(nread > 0);
+        if (nread <= 0)
+            break;
+        total_received += nread;
+    }
+    EXPECT_EQ(total_received, static_cast<size_t>(nsent));
+    expect_file_contents(received, 0);
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <AK/Vector.h>
+#include <LibCore/System.h>
+#include <LibTest/TestCase.h>
+#include <pthread.h>
+#include <unistd.h>
+
+// read() and write() don't take the process big lock, so several threads can be using the same description's offset at
+// once. Every record has to end up at its own offset: none may overlap another, none may be skipped.
+
+static constexpr size_t thread_count = 4;
+static constexpr size_t records_per_thread = 512;
+static constexpr size_t record_size = 64;
+static constexpr size_t record_count = thread_count * records_per_thread;
+
+struct ThreadContext {
+    int fd { -1 };
+    u8 id { 0 };
+    Vector<u32> records_read {};
+    bool failed { false };
+};
+
+static void run_threads(Array<ThreadContext, thread_count>& contexts, void* (*function)(void*))
+{
+    Array<pthread_t, thread_count> threads;
+    for (size_t i = 0; i < thread_count; ++i)
+        EXPECT_EQ(pthread_create(&threads[i], nullptr, function, &contexts[i]), 0);
+    for (auto thread : threads)
+        EXPECT_EQ(pthread_join(thread, nullptr), 0);
+    for (auto& context : contexts)
+        EXPECT(!context.failed);
+}
+
+static void* write_records(void* argument)
+{
+    auto& context = *static_cast<ThreadContext*>(argument);
+    Array<u8, record_size> record;
+    record.fill(context.id);
+    for (size_t i = 0; i < records_per_thread; ++i) {
+        if (write(context.fd, record.data(), record.size()) != record_size) {
+            context.failed = true;
+            break;
+        }
+    }
+    return nullptr;
+}
+
+static void* read_records(void* argument)
+{
+    auto& context = *static_cast<ThreadContext*>(argument);
+    Array<u32, record_size / sizeof(u32)> record;
+    for (;;) {
+        auto nread = read(context.fd, record.data(), record_size);
+        if (nread == 0)
+            break;
+        if (nread != record_size) {
+            context.failed = true;
+            break;
+        }
+        // A record read from a torn offset would straddle two records.
+        for (auto value : record) {
+            if (value != record[0])
+                context.failed = true;
+        }
+        context.records_read.append(record[0]);
+    }
+    return nullptr;
+}
+
+TEST_CASE(concurrent_writes_to_shared_description)
+{
+    char pattern[] = "/tmp/shared_description_writes.XXXXXX";
+    auto fd = MUST(Core::System::mkstemp(pattern));
+    MUST(Core::System::unlink({ pattern, sizeof(pattern) - 1 }));
+
+    Array<ThreadContext, thread_count> contexts;
+    for (size_t i = 0; i < thread_count; ++i)
+        contexts[i] = { .fd = fd, .id = static_cast<u8>('A' + i) };
+    run_threads(contexts, write_records);
+
+    // The offset must have advanced exactly once per write.
+    EXPECT_EQ(MUST(Core::System::lseek(fd, 0, SEEK_CUR)), static_cast<off_t>(record_count * record_size));
+    EXPECT_EQ(MUST(Core::System::fstat(fd)).st_size, static_cast<off_t>(record_count * record_size));
+
+    MUST(Core::System::lseek(fd, 0, SEEK_SET));
+    Array<size_t, thread_count> records_per_id {};
+    Array<u8, record_size> record;
+    for (size_t i = 0; i < record_count; ++i) {
+        EXPECT_EQ(MUST(Core::System::read(fd, record.span())), record_size);
+        for (auto byte : record)
+            EXPECT_EQ(byte, record[0]);
+        auto id = record[0] - 'A';
+        EXPECT(id >= 0 && static_cast<size_t>(id) < thread_count);
+        if (id >= 0 && static_cast<size_t>(id) < thread_count)
+            ++records_per_id[id];
+    }
+    for (auto count : records_per_id)
+        EXPECT_EQ(count, records_per_thread);
+
+    MUST(Core::System::close(fd));
+}
+
+TEST_CASE(concurrent_reads_from_shared_description)
+{
+    char pattern[] = "/tmp/shared_description_reads.XXXXXX";
+    auto fd = MUST(Core::System::mkstemp(pattern));
+    MUST(Core::System::unlink({ pattern, sizeof(pattern) - 1 }));
+
+    Array<u32, record_size / sizeof(u32)> record;
+    for (u32 i = 0; i < record_count; ++i) {
+        record.fill(i);
+        EXPECT_EQ(MUST(Core::System::write(fd, ReadonlyBytes { record.data(), record_size })), record_size);
+    }
+    MUST(Core::System::lseek(fd, 0, SEEK_SET));
+
+    Array<ThreadContext, thread_count> contexts;
+    for (auto& context : contexts)
+        context.fd = fd;
+    run_threads(contexts, read_records);
+
+    // Each record must have been read by exactly one thread.
+    Vector<size_t> times_read;
+    times_read.resize(record_count);
+    for (auto& context : contexts) {
+        for (auto index : context.records_read) {
+            EXPECT(index < record_count);
+            if (index < record_count)
+                ++times_read[index];
+        }
+    }
+    for (auto count : times_read)
+        EXPECT_EQ(count, 1u);
+
+    MUST(Core::System::close(fd));
+}
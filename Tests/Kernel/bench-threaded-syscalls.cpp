@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <AK/Vector.h>
+#include <LibCore/ArgsParser.h>
+#include <LibCore/ElapsedTimer.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <serenity.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+// Runs the same mix of I/O syscalls from several threads of one process at once, and reports how many of them the
+// kernel got through per second. With a per-process lock around these syscalls, adding threads doesn't help.
+
+static int s_iterations = 100000;
+static Atomic<bool> s_failed { false };
+
+static void fail(char const* what)
+{
+    perror(what);
+    s_failed = true;
+}
+
+static void* run_syscalls(void*)
+{
+    int pipe_fds[2];
+    if (pipe(pipe_fds) < 0) {
+        fail("pipe");
+        return nullptr;
+    }
+    int socket_fds[2];
+    if (socketpair(AF_LOCAL, SOCK_STREAM, 0, socket_fds) < 0) {
+        fail("socketpair");
+        return nullptr;
+    }
+    int zero_fd = open("/dev/zero", O_RDONLY);
+    if (zero_fd < 0) {
+        fail("open");
+        return nullptr;
+    }
+
+    u32 futex_word = 0;
+    char buffer[64];
+    iovec iov { buffer, sizeof(buffer) };
+    msghdr message {};
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+
+    for (int i = 0; i < s_iterations && !s_failed; ++i) {
+        if (write(pipe_fds[1], buffer, 1) != 1 || read(pipe_fds[0], buffer, 1) != 1) {
+            fail("pipe write/read");
+            break;
+        }
+        if (readv(zero_fd, &iov, 1) != sizeof(buffer)) {
+            fail("readv");
+            break;
+        }
+        iov.iov_len = 1;
+        if (sendmsg(socket_fds[0], &message, 0) != 1 || recvmsg(socket_fds[1], &message, 0) != 1) {
+            fail("sendmsg/recvmsg");
+            break;
+        }
+        iov.iov_len = sizeof(buffer);
+        int available = 0;
+        if (ioctl(socket_fds[1], FIONREAD, &available) < 0) {
+            fail("ioctl");
+            break;
+        }
+        if (futex_wake(&futex_word, 1, false) < 0) {
+            fail("futex");
+            break;
+        }
+    }
+
+    close(zero_fd);
+    close(socket_fds[0]);
+    close(socket_fds[1]);
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+    return nullptr;
+}
+
+// Each iteration above makes this many syscalls.
+static constexpr int syscalls_per_iteration = 7;
+
+int main(int argc, char** argv)
+{
+    Vector<StringView> arguments;
+    arguments.ensure_capacity(argc);
+    for (auto i = 0; i < argc; ++i)
+        arguments.append({ argv[i], strlen(argv[i]) });
+
+    int thread_count = 4;
+
+    Core::ArgsParser args_parser;
+    args_parser.add_option(thread_count, "Number of threads to run the syscalls on", "threads", 't', "count");
+    args_parser.add_option(s_iterations, "Number of iterations per thread", "iterations", 'n', "count");
+    args_parser.parse(arguments);
+
+    if (thread_count <= 0 || s_iterations <= 0) {
+        fprintf(stderr, "Thread and iteration counts have to be positive\n");
+        return EXIT_FAILURE;
+    }
+
+    Vector<pthread_t> threads;
+    threads.resize(thread_count);
+
+    auto timer = Core::ElapsedTimer::start_new();
+    for (auto& thread : threads) {
+        if (pthread_create(&thread, nullptr, run_syscalls, nullptr) != 0) {
+            perror("pthread_create");
+            return EXIT_FAILURE;
+        }
+    }
+    for (auto& thread : threads)
+        pthread_join(thread, nullptr);
+    auto elapsed_milliseconds = max<i64>(timer.elapsed_milliseconds(), 1);
+
+    if (s_failed)
+        return EXIT_FAILURE;
+
+    i64 total_syscalls = static_cast<i64>(thread_count) * s_iterations * syscalls_per_iteration;
+    printf("%d threads made %" PRIi64 " syscalls in %" PRIi64 " ms (%" PRIi64 " syscalls/s)\n",
+        thread_count, total_syscalls, elapsed_milliseconds, total_syscalls * 1000 / elapsed_milliseconds);
+    return EXIT_SUCCESS;
+}
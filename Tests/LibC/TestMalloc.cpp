@@ -8,7 +8,9 @@
 
 #include <errno.h>
 #include <mallocdefs.h>
+#include <pthread.h>
 #include <stdlib.h>
+#include <string.h>
 
 TEST_CASE(malloc_limits)
 {
@@ -38,3 +40,93 @@ TEST_CASE(malloc_limits)
         return Test::Crash::Failure::DidNotCrash;
     });
 }
+
+static constexpr size_t cross_thread_allocation_count = 512;
+
+static void* free_allocations(void* argument)
+{
+    auto** allocations = static_cast<void**>(argument);
+    for (size_t i = 0; i < cross_thread_allocation_count; ++i)
+        free(allocations[i]);
+    return nullptr;
+}
+
+TEST_CASE(free_on_another_thread)
+{
+    static void* allocations[cross_thread_allocation_count];
+    for (size_t i = 0; i < cross_thread_allocation_count; ++i) {
+        auto size = size_classes[i % num_size_classes];
+        allocations[i] = malloc(size);
+        EXPECT_NE(allocations[i], nullptr);
+        memset(allocations[i], 0xaa, size);
+    }
+
+    pthread_t thread;
+    EXPECT_EQ(pthread_create(&thread, nullptr, free_allocations, allocations), 0);
+    EXPECT_EQ(pthread_join(thread, nullptr), 0);
+
+    // The freed chunks must be usable again by this thread.
+    for (size_t i = 0; i < cross_thread_allocation_count; ++i) {
+        auto size = size_classes[i % num_size_classes];
+        allocations[i] = malloc(size);
+        EXPECT_NE(allocations[i], nullptr);
+        memset(allocations[i], 0x55, size);
+    }
+    for (size_t i = 0; i < cross_thread_allocation_count; ++i)
+        free(allocations[i]);
+}
+
+static void* allocate_and_free_repeatedly(void*)
+{
+    void* allocations[64];
+    for (size_t round = 0; round < 256; ++round) {
+        for (size_t i = 0; i < 64; ++i) {
+            allocations[i] = malloc(16 + (round * 64 + i) % 2048);
+            if (!allocations[i])
+                return reinterpret_cast<void*>(1);
+            memset(allocations[i], static_cast<int>(i), 16);
+        }
+        for (size_t i = 0; i < 64; ++i) {
+            auto* bytes = static_cast<unsigned char*>(allocations[i]);
+            if (bytes[0] != i || bytes[15] != i)
+                return reinterpret_cast<void*>(1);
+            free(allocations[i]);
+        }
+    }
+    return nullptr;
+}
+
+TEST_CASE(concurrent_allocations)
+{
+    pthread_t threads[4];
+    for (auto& thread : threads)
+        EXPECT_EQ(pthread_create(&thread, nullptr, allocate_and_free_repeatedly, nullptr), 0);
+    for (auto& thread : threads) {
+        void* result = nullptr;
+        EXPECT_EQ(pthread_join(thread, &result), 0);
+        EXPECT_EQ(result, nullptr);
+    }
+}
+
+TEST_CASE(double_free)
+{
+    EXPECT_CRASH("Freeing a chunk twice should crash", [] {
+        void* volatile ptr = malloc(32);
+        free(ptr);
+        free(ptr);
+        return Test::Crash::Failure::DidNotCrash;
+    });
+
+    EXPECT_CRASH("Freeing a chunk twice should crash after it was handed back to its block", [] {
+        void* volatile ptr = malloc(32);
+        free(ptr);
+        // Fill up this thread's cache so the chunk gets flushed back to the global allocator.
+        static void* allocations[256];
+        for (auto& allocation : allocations)
+            allocation = malloc(32);
+        for (auto& allocation : allocations)
+            free(allocation);
+        free(ptr);
+        return Test::Crash::Failure::DidNotCrash;
+    });
+}
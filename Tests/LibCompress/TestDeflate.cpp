@@ -149,6 +149,30 @@ TEST_CASE(deflate_round_trip_compress_large)
     EXPECT(uncompressed == original);
 }
 
+TEST_CASE(deflate_round_trip_compress_parallel)
+{
+    auto size = Compress::DeflateCompressor::parallel_chunk_size * 3 + 1234;
+    auto pattern_size = 16 * KiB;
+    auto original = ByteBuffer::create_uninitialized(size).release_value();
+    fill_with_random(original.bytes().trim(pattern_size));
+    for (size_t offset = pattern_size; offset < size; offset += pattern_size)
+        original.bytes().slice(offset).overwrite(0, original.data(), min(pattern_size, size - offset));
+    auto compressed = TRY_OR_FAIL(Compress::DeflateCompressor::compress_all_parallel(original, Compress::DeflateCompressor::CompressionLevel::GOOD, 4));
+    // Every chunk but the first can refer back to the pattern at the end of the previous chunk
+    EXPECT(compressed.size() < pattern_size * 2);
+    auto uncompressed = TRY_OR_FAIL(Compress::DeflateDecompressor::decompress_all(compressed));
+    EXPECT(uncompressed == original);
+}
+
+TEST_CASE(deflate_round_trip_short_final_code)
+{
+    // With fixed huffman codes, these literals leave fewer bits for the final end of block symbol than the longest code prefix
+    Array<u8, 6> original { 0x90, 0xa0, 0xb0, 0xc0, 0xd0, 0xe0 };
+    auto compressed = TRY_OR_FAIL(Compress::DeflateCompressor::compress_all(original, Compress::DeflateCompressor::CompressionLevel::GOOD));
+    auto uncompressed = TRY_OR_FAIL(Compress::DeflateDecompressor::decompress_all(compressed));
+    EXPECT(uncompressed.bytes() == original.span());
+}
+
 TEST_CASE(deflate_compress_literals)
 {
     // This byte array is known to not produce any back references with our lz77 implementation even at the highest compression settings
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Time.h>
+#include <AK/Vector.h>
+#include <LibCore/EventLoop.h>
+#include <LibCore/EventReceiver.h>
+#include <LibCore/Timer.h>
+#include <LibTest/TestCase.h>
+#include <unistd.h>
+
+class TimerReceiver final : public Core::EventReceiver {
+    C_OBJECT(TimerReceiver);
+
+public:
+    void set_visible(bool visible)
+    {
+        m_visible = visible;
+        did_change_visibility_for_timer_purposes();
+    }
+
+    virtual bool is_visible_for_timer_purposes() const override
+    {
+        ++visibility_checks;
+        return m_visible;
+    }
+
+    size_t fire_count { 0 };
+    mutable size_t visibility_checks { 0 };
+    Function<void()> on_timer;
+
+private:
+    TimerReceiver() = default;
+
+    virtual void timer_event(Core::TimerEvent&) override
+    {
+        ++fire_count;
+        if (on_timer)
+            on_timer();
+    }
+
+    bool m_visible { true };
+};
+
+static void pump_for(Core::EventLoop& event_loop, int milliseconds)
+{
+    for (int i = 0; i < milliseconds; i += 5) {
+        usleep(5'000);
+        event_loop.pump(Core::EventLoop::WaitMode::PollForEvents);
+    }
+}
+
+TEST_CASE(timers_fire_in_order_of_their_deadlines)
+{
+    Core::EventLoop event_loop;
+    auto reaper = MUST(Core::Timer::create_single_shot(2000, [] {
+        warnln("The timers never all fired!");
+        VERIFY_NOT_REACHED();
+    }));
+    reaper->start();
+
+    Vector<int> fired_intervals;
+    Vector<NonnullRefPtr<Core::Timer>> timers;
+    for (int interval : { 50, 10, 40, 25, 20, 30 }) {
+        auto timer = MUST(Core::Timer::create_single_shot(interval, [&, interval] {
+            fired_intervals.append(interval);
+            if (fired_intervals.size() == 5)
+                event_loop.quit(0);
+        }));
+        timer->start();
+        timers.append(move(timer));
+    }
+    // Take one out of the middle of the heap before it fires.
+    timers[3]->stop();
+
+    event_loop.exec();
+    EXPECT_EQ(fired_intervals, (Vector<int> { 10, 20, 30, 40, 50 }));
+}
+
+TEST_CASE(repeating_timers_are_rescheduled)
+{
+    Core::EventLoop event_loop;
+    size_t ticks = 0;
+    auto ticker = MUST(Core::Timer::create_repeating(10, [&] { ++ticks; }));
+    ticker->start();
+    auto quitter = MUST(Core::Timer::create_single_shot(100, [&] { event_loop.quit(0); }));
+    quitter->start();
+
+    event_loop.exec();
+    EXPECT(ticks >= 3);
+}
+
+TEST_CASE(timers_with_slack_fire_together)
+{
+    // A 512 ms timer may be up to 32 ms late, so its deadline is rounded up to a multiple of 32 ms. Start two of them
+    // early in the same 32 ms slot, 10 ms apart, and they have to end up firing at the same time.
+    static constexpr i64 slot_ns = 32'000'000;
+    for (;;) {
+        auto offset_in_slot_ns = MonotonicTime::now_coarse().nanoseconds() % slot_ns;
+        if (offset_in_slot_ns >= 1'000'000 && offset_in_slot_ns <= 8'000'000)
+            break;
+        usleep(500);
+    }
+
+    Core::EventLoop event_loop;
+    size_t pump_count = 0;
+    auto first = TimerReceiver::construct();
+    auto second = TimerReceiver::construct();
+    size_t first_fired_in_pump = 0;
+    size_t second_fired_in_pump = 0;
+    first->on_timer = [&] { first_fired_in_pump = pump_count; };
+    second->on_timer = [&] { second_fired_in_pump = pump_count; };
+
+    first->start_timer(512);
+    usleep(10'000);
+    second->start_timer(512);
+
+    while (first->fire_count == 0 || second->fire_count == 0) {
+        ++pump_count;
+        event_loop.pump(Core::EventLoop::WaitMode::WaitForEvents);
+    }
+    EXPECT_EQ(first_fired_in_pump, second_fired_in_pump);
+}
+
+TEST_CASE(timers_of_invisible_owners_are_suspended_until_they_become_visible)
+{
+    Core::EventLoop event_loop;
+    auto receiver = TimerReceiver::construct();
+    auto always_firing_receiver = TimerReceiver::construct();
+    receiver->set_visible(false);
+    always_firing_receiver->set_visible(false);
+    receiver->start_timer(10);
+    always_firing_receiver->start_timer(10, Core::TimerShouldFireWhenNotVisible::Yes);
+
+    pump_for(event_loop, 50);
+    EXPECT_EQ(receiver->fire_count, 0u);
+    EXPECT(always_firing_receiver->fire_count > 0);
+
+    // Nobody's visibility changed, so the suspended timer doesn't have to be looked at again.
+    auto visibility_checks = receiver->visibility_checks;
+    pump_for(event_loop, 50);
+    EXPECT_EQ(receiver->visibility_checks, visibility_checks);
+    EXPECT_EQ(receiver->fire_count, 0u);
+
+    // It already expired, so it fires as soon as its owner is visible again.
+    receiver->set_visible(true);
+    event_loop.pump(Core::EventLoop::WaitMode::PollForEvents);
+    EXPECT_EQ(receiver->fire_count, 1u);
+}
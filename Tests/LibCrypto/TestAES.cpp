@@ -454,3 +454,83 @@ TEST_CASE(test_AES_GCM_128bit_decrypt_multiple_blocks_with_aad)
     EXPECT(memcmp(result_pt, out.data(), out.size()) == 0);
     EXPECT_EQ(consistency, Crypto::VerificationConsistency::Consistent);
 }
+
+TEST_CASE(test_AES_CTR_batched_matches_block_by_block)
+{
+    auto key = "\x2b\x7e\x15\x16\x28\xae\xd2\xa6\xab\xf7\x15\x88\x09\xcf\x4f\x3c"_b;
+    u8 ivec[16] { 0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff };
+    u8 in[200];
+    for (size_t i = 0; i < sizeof(in); ++i)
+        in[i] = static_cast<u8>(i * 7);
+
+    Crypto::Cipher::AESCipher::CTRMode cipher(key, 128, Crypto::Cipher::Intent::Encryption);
+    auto batched = ByteBuffer::create_zeroed(sizeof(in)).release_value();
+    auto batched_span = batched.bytes();
+    cipher.encrypt({ in, sizeof(in) }, batched_span, { ivec, sizeof(ivec) });
+
+    auto block_by_block = ByteBuffer::create_zeroed(sizeof(in)).release_value();
+    u8 next_ivec[16];
+    __builtin_memcpy(next_ivec, ivec, sizeof(ivec));
+    for (size_t offset = 0; offset < sizeof(in); offset += 16) {
+        auto length = min<size_t>(16, sizeof(in) - offset);
+        auto out_span = block_by_block.bytes().slice(offset, length);
+        Bytes next_ivec_span { next_ivec, sizeof(next_ivec) };
+        u8 current_ivec[16];
+        __builtin_memcpy(current_ivec, next_ivec, sizeof(next_ivec));
+        cipher.encrypt({ in + offset, length }, out_span, { current_ivec, sizeof(current_ivec) }, &next_ivec_span);
+    }
+
+    EXPECT_EQ(batched, block_by_block);
+}
+
+TEST_CASE(test_AES_CBC_decrypt_in_place)
+{
+    auto key = "\x2b\x7e\x15\x16\x28\xae\xd2\xa6\xab\xf7\x15\x88\x09\xcf\x4f\x3c"_b;
+    auto iv = ByteBuffer::create_zeroed(Crypto::Cipher::AESCipher::block_size()).release_value();
+    u8 in[160];
+    for (size_t i = 0; i < sizeof(in); ++i)
+        in[i] = static_cast<u8>(i * 13 + 1);
+
+    Crypto::Cipher::AESCipher::CBCMode encryptor(key, 128, Crypto::Cipher::Intent::Encryption, Crypto::Cipher::PaddingMode::Null);
+    auto buffer = ByteBuffer::create_zeroed(sizeof(in)).release_value();
+    auto buffer_span = buffer.bytes();
+    encryptor.encrypt({ in, sizeof(in) }, buffer_span, iv);
+
+    Crypto::Cipher::AESCipher::CBCMode decryptor(key, 128, Crypto::Cipher::Intent::Decryption, Crypto::Cipher::PaddingMode::Null);
+    buffer_span = buffer.bytes();
+    decryptor.decrypt(buffer, buffer_span, iv);
+    EXPECT_EQ(buffer_span.size(), sizeof(in));
+    EXPECT(memcmp(buffer_span.data(), in, sizeof(in)) == 0);
+}
+
+static constexpr size_t benchmark_size = 16 * MiB;
+
+BENCHMARK_CASE(benchmark_AES_CBC_128bit_decrypt)
+{
+    Crypto::Cipher::AESCipher::CBCMode cipher("WellHelloFriends"_b, 128, Crypto::Cipher::Intent::Decryption, Crypto::Cipher::PaddingMode::Null);
+    auto in = ByteBuffer::create_zeroed(benchmark_size).release_value();
+    auto out = ByteBuffer::create_zeroed(benchmark_size).release_value();
+    auto iv = ByteBuffer::create_zeroed(Crypto::Cipher::AESCipher::block_size()).release_value();
+    auto out_span = out.bytes();
+    cipher.decrypt(in, out_span, iv);
+}
+
+BENCHMARK_CASE(benchmark_AES_CTR_128bit_encrypt)
+{
+    Crypto::Cipher::AESCipher::CTRMode cipher("WellHelloFriends"_b, 128, Crypto::Cipher::Intent::Encryption);
+    auto in = ByteBuffer::create_zeroed(benchmark_size).release_value();
+    auto out = ByteBuffer::create_zeroed(benchmark_size).release_value();
+    auto iv = ByteBuffer::create_zeroed(Crypto::Cipher::AESCipher::block_size()).release_value();
+    auto out_span = out.bytes();
+    cipher.encrypt(in, out_span, iv);
+}
+
+BENCHMARK_CASE(benchmark_AES_GCM_128bit_encrypt)
+{
+    Crypto::Cipher::AESCipher::GCMMode cipher("WellHelloFriends"_b, 128, Crypto::Cipher::Intent::Encryption);
+    auto in = ByteBuffer::create_zeroed(benchmark_size).release_value();
+    auto out = ByteBuffer::create_zeroed(benchmark_size).release_value();
+    auto iv = ByteBuffer::create_zeroed(Crypto::Cipher::AESCipher::block_size()).release_value();
+    u8 tag[16];
+    cipher.encrypt(in, out.bytes(), iv, {}, { tag, sizeof(tag) });
+}
@@ -241,6 +241,64 @@ TEST_CASE(test_SHA256_hash_split_into_blocks)
     EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA256::digest_size()) == 0);
 }
 
+static void test_SHA256_hash_many_matches_hash(Crypto::Hash::SHA256::HashManyStrategy strategy)
+{
+    auto data = ByteBuffer::create_uninitialized(1024).release_value();
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = static_cast<u8>(i * 7 + 3);
+
+    // Messages of differing lengths, so that some lanes finish earlier than others.
+    Vector<ReadonlyBytes> messages;
+    for (size_t length : { 0, 1, 55, 56, 63, 64, 65, 119, 120, 128, 500, 1024, 3, 17 })
+        messages.append(data.bytes().trim(length));
+
+    Vector<Crypto::Hash::SHA256::DigestType> digests;
+    digests.resize(messages.size());
+    Crypto::Hash::SHA256::hash_many(messages, digests, strategy);
+
+    for (size_t i = 0; i < messages.size(); ++i) {
+        auto expected = Crypto::Hash::SHA256::hash(messages[i].data(), messages[i].size());
+        EXPECT(memcmp(expected.data, digests[i].data, Crypto::Hash::SHA256::digest_size()) == 0);
+    }
+}
+
+TEST_CASE(test_SHA256_hash_many_matches_hash)
+{
+    test_SHA256_hash_many_matches_hash(Crypto::Hash::SHA256::HashManyStrategy::Automatic);
+    test_SHA256_hash_many_matches_hash(Crypto::Hash::SHA256::HashManyStrategy::OneAtATime);
+}
+
+TEST_CASE(test_SHA256_hash_many_interleaved_matches_hash)
+{
+    // This is the path CPUs with SHA extensions don't take by default, so force it.
+    if (!Crypto::Hash::SHA256::can_interleave())
+        return;
+    test_SHA256_hash_many_matches_hash(Crypto::Hash::SHA256::HashManyStrategy::Interleaved);
+}
+
+TEST_CASE(test_SHA_unaligned_updates_match_single_update)
+{
+    auto data = ByteBuffer::create_uninitialized(1000).release_value();
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = static_cast<u8>(i * 13 + 1);
+
+    Crypto::Hash::SHA1 sha1;
+    Crypto::Hash::SHA256 sha256;
+    for (size_t offset = 0, chunk = 1; offset < data.size(); offset += chunk, chunk = chunk * 3 % 197 + 1) {
+        auto bytes = data.bytes().slice(offset, min(chunk, data.size() - offset));
+        sha1.update(bytes);
+        sha256.update(bytes);
+    }
+
+    auto sha1_digest = sha1.digest();
+    auto sha1_expected = Crypto::Hash::SHA1::hash(data);
+    EXPECT(memcmp(sha1_expected.data, sha1_digest.data, Crypto::Hash::SHA1::digest_size()) == 0);
+
+    auto sha256_digest = sha256.digest();
+    auto sha256_expected = Crypto::Hash::SHA256::hash(data);
+    EXPECT(memcmp(sha256_expected.data, sha256_digest.data, Crypto::Hash::SHA256::digest_size()) == 0);
+}
+
 TEST_CASE(test_SHA384_name)
 {
     Crypto::Hash::SHA384 sha;
@@ -325,3 +383,38 @@ TEST_CASE(test_ghash_galois_field_multiply2)
     Crypto::Authentication::galois_multiply(z, x, y);
     EXPECT(memcmp(result, z, 4 * sizeof(u32)) == 0);
 }
+
+static constexpr size_t benchmark_size = 16 * MiB;
+static constexpr size_t benchmark_message_count = 64;
+
+BENCHMARK_CASE(benchmark_SHA1)
+{
+    auto data = ByteBuffer::create_zeroed(benchmark_size).release_value();
+    (void)Crypto::Hash::SHA1::hash(data);
+}
+
+BENCHMARK_CASE(benchmark_SHA256)
+{
+    auto data = ByteBuffer::create_zeroed(benchmark_size).release_value();
+    (void)Crypto::Hash::SHA256::hash(data);
+}
+
+BENCHMARK_CASE(benchmark_SHA256_many_messages_one_at_a_time)
+{
+    auto data = ByteBuffer::create_zeroed(benchmark_size).release_value();
+    auto message_size = benchmark_size / benchmark_message_count;
+    for (size_t i = 0; i < benchmark_message_count; ++i)
+        (void)Crypto::Hash::SHA256::hash(data.data() + i * message_size, message_size);
+}
+
+BENCHMARK_CASE(benchmark_SHA256_hash_many)
+{
+    auto data = ByteBuffer::create_zeroed(benchmark_size).release_value();
+    auto message_size = benchmark_size / benchmark_message_count;
+    Vector<ReadonlyBytes> messages;
+    for (size_t i = 0; i < benchmark_message_count; ++i)
+        messages.append(data.bytes().slice(i * message_size, message_size));
+    Vector<Crypto::Hash::SHA256::DigestType> digests;
+    digests.resize(benchmark_message_count);
+    Crypto::Hash::SHA256::hash_many(messages, digests);
+}
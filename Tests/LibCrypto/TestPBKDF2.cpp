@@ -164,3 +164,35 @@ TEST_CASE(test_vector_5_sha256)
 
     EXPECT_EQ(result, expected.span());
 }
+
+TEST_CASE(test_multi_block_sha256)
+{
+    Array<u8, 8> const password {
+        0x70, 0x61, 0x73, 0x73, 0x77, 0x6f, 0x72, 0x64
+    };
+    Array<u8, 4> const salt {
+        0x73, 0x61, 0x6c, 0x74
+    };
+    // Four blocks, the last of which is truncated, so all of them are derived together.
+    Array<u8, 100> const expected {
+        0xc5, 0xe4, 0x78, 0xd5, 0x92, 0x88, 0xc8, 0x41,
+        0xaa, 0x53, 0x0d, 0xb6, 0x84, 0x5c, 0x4c, 0x8d,
+        0x96, 0x28, 0x93, 0xa0, 0x01, 0xce, 0x4e, 0x11,
+        0xa4, 0x96, 0x38, 0x73, 0xaa, 0x98, 0x13, 0x4a,
+        0xf7, 0xad, 0x98, 0xc1, 0xb4, 0x58, 0xce, 0x3f,
+        0xd7, 0x4c, 0xa3, 0x5b, 0xeb, 0xa3, 0xcd, 0xa7,
+        0xb8, 0xd1, 0x03, 0x8d, 0x6a, 0x87, 0x07, 0x1b,
+        0x91, 0x8f, 0x83, 0x74, 0x05, 0xf3, 0xfe, 0x77,
+        0x28, 0xff, 0xe7, 0xf0, 0x97, 0x6f, 0xc3, 0x5d,
+        0xd8, 0x2f, 0xc0, 0xe5, 0xe4, 0x6c, 0xe9, 0xce,
+        0x26, 0xa7, 0x88, 0xb2, 0xc7, 0xd1, 0x83, 0xfa,
+        0x5b, 0xf8, 0xd9, 0x60, 0x7e, 0xec, 0xd7, 0x1d,
+        0x01, 0xb4, 0xf1, 0x19
+    };
+    u32 iterations = 4096;
+    u32 derived_key_length_bytes = 100;
+
+    auto result = MUST(Crypto::Hash::PBKDF2::derive_key<Crypto::Authentication::HMAC<Crypto::Hash::SHA256>>(password, salt, iterations, derived_key_length_bytes));
+
+    EXPECT_EQ(result, expected.span());
+}
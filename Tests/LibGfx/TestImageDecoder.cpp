@@ -257,6 +257,24 @@ TEST_CASE(test_jpeg_grayscale_with_app14)
     expect_single_frame_of_size(*plugin_decoder, { 80, 80 });
 }
 
+TEST_CASE(test_jpeg_sof0_restart_intervals)
+{
+    auto file = MUST(Core::MappedFile::map(TEST_INPUT("jpg/restart_intervals_420.jpg"sv)));
+    EXPECT(Gfx::JPEGImageDecoderPlugin::sniff(file->bytes()));
+    auto plugin_decoder = MUST(Gfx::JPEGImageDecoderPlugin::create(file->bytes()));
+
+    auto frame = expect_single_frame_of_size(*plugin_decoder, { 96, 72 });
+    EXPECT_EQ(frame.image->get_pixel(20, 10), Gfx::Color(50, 36, 120, 255));
+
+    auto parallel_plugin_decoder = MUST(Gfx::JPEGImageDecoderPlugin::create_with_options(file->bytes(), { .decode_restart_intervals_in_parallel = true }));
+    auto parallel_frame = expect_single_frame_of_size(*parallel_plugin_decoder, { 96, 72 });
+
+    for (int y = 0; y < frame.image->height(); ++y) {
+        for (int x = 0; x < frame.image->width(); ++x)
+            EXPECT_EQ(parallel_frame.image->get_pixel(x, y), frame.image->get_pixel(x, y));
+    }
+}
+
 TEST_CASE(test_jpeg_malformed_header)
 {
     Array test_inputs = {
@@ -0,0 +1,320 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/TemporaryChange.h>
+#include <LibJS/Bytecode/BasicBlock.h>
+#include <LibJS/Bytecode/Generator.h>
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/Bytecode/PassManager.h>
+#include <LibJS/Lexer.h>
+#include <LibJS/Parser.h>
+#include <LibJS/Runtime/GlobalObject.h>
+#include <LibJS/Runtime/VM.h>
+#include <LibJS/Runtime/ValueInlines.h>
+#include <LibJS/Script.h>
+#include <LibTest/TestCase.h>
+
+using namespace JS;
+using Bytecode::Instruction;
+
+namespace {
+
+// The generated bytecode refers back into the AST, so the program has to stay alive alongside it.
+struct UnoptimizedExecutable {
+    NonnullRefPtr<Program> program;
+    NonnullGCPtr<Bytecode::Executable> executable;
+};
+
+}
+
+static UnoptimizedExecutable generate_unoptimized(VM& vm, StringView source)
+{
+    auto parser = JS::Parser(JS::Lexer(source));
+    auto program = parser.parse_program();
+    VERIFY(!parser.has_errors());
+
+    TemporaryChange disable_optimizations(Bytecode::g_disable_bytecode_optimizations, true);
+    auto executable = MUST(Bytecode::Generator::generate(vm, *program));
+    return { move(program), executable };
+}
+
+static void run_passes(Bytecode::Executable& executable, Function<void(Bytecode::PassManager&)> add_passes)
+{
+    Bytecode::PassManager pass_manager;
+    add_passes(pass_manager);
+    pass_manager.perform(executable);
+}
+
+static size_t count_instructions(Bytecode::Executable const& executable, Instruction::Type type)
+{
+    size_t count = 0;
+    for (auto const& block : executable.basic_blocks) {
+        for (Bytecode::InstructionStreamIterator it(block->instruction_stream()); !it.at_end(); ++it) {
+            if ((*it).type() == type)
+                ++count;
+        }
+    }
+    return count;
+}
+
+static bool is_trampoline(Bytecode::BasicBlock const& block)
+{
+    if (block.handler() || block.finalizer())
+        return false;
+    Bytecode::InstructionStreamIterator it(block.instruction_stream());
+    if (it.at_end() || (*it).type() != Instruction::Type::Jump)
+        return false;
+    auto const& jump = static_cast<Bytecode::Op::Jump const&>(*it);
+    return !jump.false_target().has_value() && &jump.true_target()->block() != &block;
+}
+
+// Counts the jump targets that are blocks doing nothing but jumping on to somewhere else.
+static size_t count_jumps_into_trampolines(Bytecode::Executable const& executable)
+{
+    size_t count = 0;
+    for (auto const& block : executable.basic_blocks) {
+        auto const* terminator = block->terminator();
+        if (!terminator)
+            continue;
+        auto type = terminator->type();
+        if (type != Instruction::Type::Jump && type != Instruction::Type::JumpConditional && type != Instruction::Type::JumpNullish && type != Instruction::Type::JumpUndefined)
+            continue;
+        auto const& jump = static_cast<Bytecode::Op::Jump const&>(*terminator);
+        if (jump.true_target().has_value() && is_trampoline(jump.true_target()->block()))
+            ++count;
+        if (jump.false_target().has_value() && is_trampoline(jump.false_target()->block()))
+            ++count;
+    }
+    return count;
+}
+
+// Every edge of the CFG (including handler, finalizer and unwind edges) has to end in a block that still exists,
+// and every block that still exists has to be reachable from the entry block.
+static void expect_control_flow_graph_is_closed(Bytecode::Executable& executable)
+{
+    Bytecode::PassPipelineExecutable pipeline_executable { executable };
+    Bytecode::Passes::GenerateCFG {}.perform(pipeline_executable);
+
+    HashTable<Bytecode::BasicBlock const*> blocks;
+    for (auto const& block : executable.basic_blocks)
+        blocks.set(block.ptr());
+
+    HashTable<Bytecode::BasicBlock const*> reachable_blocks;
+    Vector<Bytecode::BasicBlock const*> work_list;
+    work_list.append(executable.basic_blocks.first().ptr());
+    reachable_blocks.set(work_list.first());
+    while (!work_list.is_empty()) {
+        auto const* block = work_list.take_last();
+        for (auto const* successor : pipeline_executable.cfg->get(block).value()) {
+            EXPECT(blocks.contains(successor));
+            if (reachable_blocks.set(successor) == HashSetResult::InsertedNewEntry)
+                work_list.append(successor);
+        }
+    }
+
+    EXPECT_EQ(reachable_blocks.size(), blocks.size());
+}
+
+namespace {
+
+class RecordingPass final : public Bytecode::Pass {
+public:
+    RecordingPass(StringView name, Vector<StringView>& log)
+        : m_name(name)
+        , m_log(log)
+    {
+    }
+
+    StringView name() const override { return m_name; }
+    void perform(Bytecode::PassPipelineExecutable&) override { m_log.append(m_name); }
+
+private:
+    StringView m_name;
+    Vector<StringView>& m_log;
+};
+
+}
+
+TEST_CASE(pass_manager_runs_passes_in_order)
+{
+    auto vm = MUST(VM::create());
+    auto unoptimized = generate_unoptimized(*vm, "1;"sv);
+
+    Vector<StringView> log;
+    run_passes(*unoptimized.executable, [&](auto& pass_manager) {
+        pass_manager.template add<RecordingPass>("first"sv, log);
+        pass_manager.template add<RecordingPass>("second"sv, log);
+        pass_manager.template add<RecordingPass>("third"sv, log);
+    });
+
+    EXPECT_EQ(log, (Vector<StringView> { "first"sv, "second"sv, "third"sv }));
+}
+
+TEST_CASE(generate_cfg_includes_handler_and_finalizer_edges)
+{
+    auto vm = MUST(VM::create());
+    auto unoptimized = generate_unoptimized(*vm, "var x; try { x(); } catch (e) { x = e; } finally { x = 1; }"sv);
+    auto& executable = *unoptimized.executable;
+
+    Bytecode::PassPipelineExecutable pipeline_executable { executable };
+    Bytecode::Passes::GenerateCFG {}.perform(pipeline_executable);
+    EXPECT(pipeline_executable.cfg.has_value());
+    EXPECT(pipeline_executable.inverted_cfg.has_value());
+
+    size_t unwind_edge_count = 0;
+    for (auto const& block : executable.basic_blocks) {
+        auto const& successors = pipeline_executable.cfg->get(block.ptr()).value();
+        for (auto const* target : { block->handler(), block->finalizer() }) {
+            if (!target)
+                continue;
+            EXPECT(successors.contains(target));
+            EXPECT(pipeline_executable.inverted_cfg->get(target).value().contains(block.ptr()));
+            ++unwind_edge_count;
+        }
+    }
+    EXPECT(unwind_edge_count > 0);
+}
+
+TEST_CASE(constant_branches_are_folded)
+{
+    auto vm = MUST(VM::create());
+
+    for (auto source : { "while (true) { x = 1; break; }"sv, "if (0) { x = 1; } else { x = 2; }"sv, "x = null ?? 1;"sv }) {
+        auto unoptimized = generate_unoptimized(*vm, source);
+        auto& executable = *unoptimized.executable;
+
+        auto conditional_jump_count = [&] {
+            return count_instructions(executable, Instruction::Type::JumpConditional)
+                + count_instructions(executable, Instruction::Type::JumpNullish)
+                + count_instructions(executable, Instruction::Type::JumpUndefined);
+        };
+        EXPECT_EQ(conditional_jump_count(), 1u);
+
+        run_passes(executable, [](auto& pass_manager) { pass_manager.template add<Bytecode::Passes::FoldConstantBranches>(); });
+        EXPECT_EQ(conditional_jump_count(), 0u);
+    }
+}
+
+TEST_CASE(branches_on_unknown_values_are_not_folded)
+{
+    auto vm = MUST(VM::create());
+    auto unoptimized = generate_unoptimized(*vm, "var x; while (x) { x = x - 1; }"sv);
+    auto& executable = *unoptimized.executable;
+
+    EXPECT_EQ(count_instructions(executable, Instruction::Type::JumpConditional), 1u);
+    run_passes(executable, [](auto& pass_manager) { pass_manager.template add<Bytecode::Passes::FoldConstantBranches>(); });
+    EXPECT_EQ(count_instructions(executable, Instruction::Type::JumpConditional), 1u);
+}
+
+TEST_CASE(jumps_are_threaded_through_blocks_that_only_jump)
+{
+    auto vm = MUST(VM::create());
+
+    for (auto source : { "var x; do { } while (x);"sv, "var x; switch (x) { case 1: case 2: x = 3; }"sv }) {
+        auto unoptimized = generate_unoptimized(*vm, source);
+        auto& executable = *unoptimized.executable;
+
+        EXPECT(count_jumps_into_trampolines(executable) > 0);
+        run_passes(executable, [](auto& pass_manager) { pass_manager.template add<Bytecode::Passes::ThreadJumps>(); });
+        EXPECT_EQ(count_jumps_into_trampolines(executable), 0u);
+    }
+}
+
+TEST_CASE(threading_a_cycle_of_jumps_terminates)
+{
+    auto vm = MUST(VM::create());
+    auto unoptimized = generate_unoptimized(*vm, "for (;;) { }"sv);
+
+    run_passes(*unoptimized.executable, [](auto& pass_manager) {
+        pass_manager.template add<Bytecode::Passes::FoldConstantBranches>();
+        pass_manager.template add<Bytecode::Passes::ThreadJumps>();
+    });
+}
+
+TEST_CASE(unreachable_blocks_are_eliminated)
+{
+    auto vm = MUST(VM::create());
+
+    for (auto source : { "if (0) { x = 1; } else { x = 2; }"sv, "var x; do { } while (x);"sv }) {
+        auto unoptimized = generate_unoptimized(*vm, source);
+        auto& executable = *unoptimized.executable;
+        auto block_count_before = executable.basic_blocks.size();
+
+        run_passes(executable, [](auto& pass_manager) {
+            pass_manager.template add<Bytecode::Passes::FoldConstantBranches>();
+            pass_manager.template add<Bytecode::Passes::ThreadJumps>();
+            pass_manager.template add<Bytecode::Passes::GenerateCFG>();
+            pass_manager.template add<Bytecode::Passes::EliminateUnreachableBlocks>();
+        });
+
+        EXPECT(executable.basic_blocks.size() < block_count_before);
+        expect_control_flow_graph_is_closed(executable);
+    }
+}
+
+TEST_CASE(blocks_only_reachable_through_unwind_edges_are_kept)
+{
+    auto vm = MUST(VM::create());
+
+    // The catch block is only reachable as a handler, the finally block only as a finalizer, and the code after
+    // the finalizer only through ContinuePendingUnwind and ScheduleJump.
+    for (auto source : {
+             "var x; try { throw 1; } catch (e) { x = e; }"sv,
+             "var x; for (;;) { try { break; } finally { x = 1; } }"sv,
+             "var x; while (true) { try { x(); } catch (e) { break; } finally { x = 2; } }"sv,
+         }) {
+        auto unoptimized = generate_unoptimized(*vm, source);
+        auto& executable = *unoptimized.executable;
+
+        run_passes(executable, [](auto& pass_manager) {
+            pass_manager.template add<Bytecode::Passes::FoldConstantBranches>();
+            pass_manager.template add<Bytecode::Passes::ThreadJumps>();
+            pass_manager.template add<Bytecode::Passes::GenerateCFG>();
+            pass_manager.template add<Bytecode::Passes::EliminateUnreachableBlocks>();
+        });
+
+        EXPECT(count_instructions(executable, Instruction::Type::EnterUnwindContext) > 0);
+        expect_control_flow_graph_is_closed(executable);
+
+        bool has_handler_or_finalizer = false;
+        for (auto const& block : executable.basic_blocks)
+            has_handler_or_finalizer |= block->handler() || block->finalizer();
+        EXPECT(has_handler_or_finalizer);
+    }
+}
+
+TEST_CASE(optimized_unwinding_code_still_runs_its_finalizers)
+{
+    auto vm = MUST(VM::create());
+    auto context = create_simple_execution_context<GlobalObject>(*vm);
+
+    auto source = R"(
+        var log = [];
+        while (true) {
+            try {
+                throw 1;
+            } catch (e) {
+                log.push("catch " + e);
+                break;
+            } finally {
+                log.push("outer finally");
+            }
+        }
+        for (;;) {
+            try {
+                break;
+            } finally {
+                log.push("break finally");
+            }
+        }
+        log.join();
+    )"sv;
+
+    auto script = MUST(Script::parse(source, *context->realm));
+    auto result = MUST(vm->bytecode_interpreter().run(*script));
+    EXPECT_EQ(MUST(result.to_string(*vm)), "catch 1,outer finally,break finally"sv);
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/StringBuilder.h>
+#include <LibJS/AST.h>
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/Runtime/GlobalObject.h>
+#include <LibJS/Runtime/VM.h>
+#include <LibJS/Runtime/ValueInlines.h>
+#include <LibJS/Script.h>
+#include <LibTest/TestCase.h>
+
+// Scripts below 1 KiB are never cached, so pad the source out with a comment.
+static DeprecatedString make_source(StringView body)
+{
+    StringBuilder builder;
+    builder.append(body);
+    builder.append("\n// "sv);
+    for (size_t i = 0; i < 1024; ++i)
+        builder.append('x');
+    return builder.to_deprecated_string();
+}
+
+static JS::NonnullGCPtr<JS::Script> parse(StringView source, JS::Realm& realm, StringView filename, size_t line_number_offset = 1)
+{
+    auto script_or_error = JS::Script::parse(source, realm, filename, nullptr, line_number_offset);
+    VERIFY(!script_or_error.is_error());
+    return script_or_error.release_value();
+}
+
+TEST_CASE(identical_source_in_two_realms_hits_the_cache)
+{
+    auto vm = MUST(JS::VM::create());
+    auto first_context = JS::create_simple_execution_context<JS::GlobalObject>(*vm);
+    auto second_context = JS::create_simple_execution_context<JS::GlobalObject>(*vm);
+
+    auto source = make_source("var counter = (globalThis.counter ?? 0) + 1; counter;"sv);
+    auto first_script = parse(source, *first_context->realm, "library.js"sv);
+    auto second_script = parse(source, *second_context->realm, "library.js"sv);
+
+    EXPECT_EQ(&first_script->parse_node(), &second_script->parse_node());
+    EXPECT_EQ(&first_script->realm(), first_context->realm.ptr());
+    EXPECT_EQ(&second_script->realm(), second_context->realm.ptr());
+
+    // The parse tree (and its bytecode) is shared, but every script still runs against its own realm's globals.
+    EXPECT_EQ(MUST(vm->bytecode_interpreter().run(*first_script)), JS::Value(1));
+    EXPECT_NE(first_script->parse_node().bytecode_executable(), nullptr);
+    EXPECT_EQ(MUST(vm->bytecode_interpreter().run(*first_script)), JS::Value(2));
+    EXPECT_EQ(MUST(vm->bytecode_interpreter().run(*second_script)), JS::Value(1));
+}
+
+TEST_CASE(different_source_with_the_same_filename_misses_the_cache)
+{
+    auto vm = MUST(JS::VM::create());
+    auto context = JS::create_simple_execution_context<JS::GlobalObject>(*vm);
+
+    auto first_script = parse(make_source("1 + 1;"sv), *context->realm, "library.js"sv);
+    auto second_script = parse(make_source("2 + 2;"sv), *context->realm, "library.js"sv);
+
+    EXPECT_NE(&first_script->parse_node(), &second_script->parse_node());
+    EXPECT_EQ(MUST(vm->bytecode_interpreter().run(*first_script)), JS::Value(2));
+    EXPECT_EQ(MUST(vm->bytecode_interpreter().run(*second_script)), JS::Value(4));
+}
+
+TEST_CASE(same_source_with_a_different_filename_or_line_offset_misses_the_cache)
+{
+    auto vm = MUST(JS::VM::create());
+    auto context = JS::create_simple_execution_context<JS::GlobalObject>(*vm);
+
+    auto source = make_source("1 + 1;"sv);
+    auto script = parse(source, *context->realm, "library.js"sv);
+    EXPECT_NE(&script->parse_node(), &parse(source, *context->realm, "other.js"sv)->parse_node());
+    EXPECT_NE(&script->parse_node(), &parse(source, *context->realm, "library.js"sv, 10)->parse_node());
+    EXPECT_EQ(&script->parse_node(), &parse(source, *context->realm, "library.js"sv)->parse_node());
+}
+
+TEST_CASE(small_scripts_are_not_cached)
+{
+    auto vm = MUST(JS::VM::create());
+    auto context = JS::create_simple_execution_context<JS::GlobalObject>(*vm);
+
+    auto first_script = parse("1 + 1;"sv, *context->realm, "small.js"sv);
+    auto second_script = parse("1 + 1;"sv, *context->realm, "small.js"sv);
+    EXPECT_NE(&first_script->parse_node(), &second_script->parse_node());
+}
@@ -1175,3 +1175,68 @@ TEST_CASE(inversion_state_in_char_class)
         EXPECT_EQ(result.capture_group_matches.first()[1].view.to_deprecated_string(), "}"sv);
     }
 }
+
+TEST_CASE(search_prefilters)
+{
+    {
+        // Has a required prefix, and the DFA can handle it.
+        Regex<ECMA262> re("ab+c", ECMAScriptFlags::Global);
+        EXPECT_EQ(re.parser_result.optimization_data.required_prefix, "ab"sv);
+
+        auto result = re.match("xxabxxabbbcxxabc"sv);
+        EXPECT_EQ(result.success, true);
+        EXPECT_EQ(result.matches.size(), 2u);
+        EXPECT_EQ(result.matches[0].view.to_deprecated_string(), "abbbc"sv);
+        EXPECT_EQ(result.matches[0].global_offset, 6u);
+        EXPECT_EQ(result.matches[1].view.to_deprecated_string(), "abc"sv);
+
+        EXPECT_EQ(re.match("xxabxxabbbbxxab"sv).success, false);
+    }
+    {
+        // Anchors only hold at the very beginning and end of the input.
+        Regex<ECMA262> re("^a[0-9]*$", ECMAScriptFlags::Global);
+        EXPECT_EQ(re.match("a123"sv).success, true);
+        EXPECT_EQ(re.match("ba123"sv).success, false);
+        EXPECT_EQ(re.match("a123b"sv).success, false);
+    }
+    {
+        // Code point input goes through the DFA as well.
+        Regex<ECMA262> re("[a-c]d", ECMAScriptFlags::Global);
+        Vector<u32> code_points { 'x', 'y', 'b', 'd', 'z' };
+        EXPECT_EQ(re.match(Utf32View { code_points.data(), code_points.size() }).success, true);
+
+        code_points[3] = 'e';
+        EXPECT_EQ(re.match(Utf32View { code_points.data(), code_points.size() }).success, false);
+        EXPECT_EQ(re.match("xybez"sv).success, false);
+    }
+    {
+        // Backreferences are left to the VM.
+        Regex<ECMA262> re("(a)\\1", ECMAScriptFlags::Global);
+        EXPECT_EQ(re.match("xaxaax"sv).success, true);
+        EXPECT_EQ(re.match("xaxabx"sv).success, false);
+    }
+}
+
+TEST_CASE(search_prefilters_keep_stateful_offset)
+{
+    // A stateful search that the DFA rejects has to end up at the same offset as one that tried every position.
+    {
+        Regex<ECMA262> re("[ab]c", ECMAScriptFlags::Global);
+        re.start_offset = 1;
+        EXPECT_EQ(re.match("xyzwv"sv).success, false);
+        EXPECT_EQ(re.start_offset, 3u);
+    }
+    {
+        Regex<ECMA262> re("[ab]c|d", ECMAScriptFlags::Global);
+        re.start_offset = 2;
+        EXPECT_EQ(re.match("xyzwv"sv).success, false);
+        EXPECT_EQ(re.start_offset, 4u);
+    }
+    {
+        // Starting past the last position where a match could begin doesn't move the offset back.
+        Regex<ECMA262> re("[ab]c", ECMAScriptFlags::Global);
+        re.start_offset = 4;
+        EXPECT_EQ(re.match("xyzwv"sv).success, false);
+        EXPECT_EQ(re.start_offset, 4u);
+    }
+}
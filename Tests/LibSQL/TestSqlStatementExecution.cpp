@@ -1061,3 +1061,106 @@ TEST_CASE(update_all_rows)
 }
 
 }
+
+TEST_CASE(select_using_primary_key)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    {
+        auto database = MUST(SQL::Database::create(db_name));
+        MUST(database->open());
+
+        create_schema(database);
+        execute(database, "CREATE TABLE TestSchema.TestTable ( Id integer PRIMARY KEY, TextColumn text );");
+        for (auto count = 9; count >= 0; --count)
+            execute(database, DeprecatedString::formatted("INSERT INTO TestSchema.TestTable VALUES ( {}, 'T{}' );", count, count));
+
+        auto result = execute(database, "SELECT TextColumn FROM TestSchema.TestTable WHERE Id = 3;");
+        EXPECT_EQ(result.size(), 1u);
+        EXPECT_EQ(result[0].row[0], "T3"sv);
+
+        result = execute(database, "SELECT Id FROM TestSchema.TestTable WHERE (Id >= 4) AND (Id < 7) ORDER BY Id;");
+        EXPECT_EQ(result.size(), 3u);
+        for (auto i = 0u; i < result.size(); ++i)
+            EXPECT_EQ(result[i].row[0], static_cast<int>(i) + 4);
+
+        result = execute(database, "SELECT Id FROM TestSchema.TestTable WHERE (7 < Id) AND (TextColumn <> 'T9');");
+        EXPECT_EQ(result.size(), 1u);
+        EXPECT_EQ(result[0].row[0], 8);
+
+        result = execute(database, "SELECT Id FROM TestSchema.TestTable WHERE Id = 42;");
+        EXPECT(result.is_empty());
+    }
+    {
+        auto database = MUST(SQL::Database::create(db_name));
+        MUST(database->open());
+
+        auto result = execute(database, "SELECT TextColumn FROM TestSchema.TestTable WHERE Id = 5;");
+        EXPECT_EQ(result.size(), 1u);
+        EXPECT_EQ(result[0].row[0], "T5"sv);
+    }
+}
+
+TEST_CASE(unique_constraint_violation)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    auto database = MUST(SQL::Database::create(db_name));
+    MUST(database->open());
+
+    create_schema(database);
+    execute(database, "CREATE TABLE TestSchema.TestTable ( Id integer PRIMARY KEY, TextColumn text UNIQUE );");
+    execute(database, "INSERT INTO TestSchema.TestTable VALUES ( 1, 'T1' ), ( 2, 'T2' );");
+
+    auto result = try_execute(database, "INSERT INTO TestSchema.TestTable VALUES ( 1, 'T3' );");
+    EXPECT(result.is_error());
+    EXPECT(result.release_error().error() == SQL::SQLErrorCode::UniqueConstraintViolated);
+
+    result = try_execute(database, "INSERT INTO TestSchema.TestTable VALUES ( 3, 'T2' );");
+    EXPECT(result.is_error());
+    EXPECT(result.release_error().error() == SQL::SQLErrorCode::UniqueConstraintViolated);
+
+    result = try_execute(database, "UPDATE TestSchema.TestTable SET Id = 2 WHERE Id = 1;");
+    EXPECT(result.is_error());
+    EXPECT(result.release_error().error() == SQL::SQLErrorCode::UniqueConstraintViolated);
+
+    execute(database, "DELETE FROM TestSchema.TestTable WHERE Id = 2;");
+    execute(database, "INSERT INTO TestSchema.TestTable VALUES ( 2, 'T2' );");
+
+    execute(database, "UPDATE TestSchema.TestTable SET Id = 5 WHERE Id = 1;");
+    EXPECT(execute(database, "SELECT * FROM TestSchema.TestTable WHERE Id = 1;").is_empty());
+
+    auto rows = execute(database, "SELECT TextColumn FROM TestSchema.TestTable WHERE Id = 5;");
+    EXPECT_EQ(rows.size(), 1u);
+    EXPECT_EQ(rows[0].row[0], "T1"sv);
+
+    rows = execute(database, "SELECT Id FROM TestSchema.TestTable WHERE Id >= 0 ORDER BY Id;");
+    EXPECT_EQ(rows.size(), 2u);
+    EXPECT_EQ(rows[0].row[0], 2);
+    EXPECT_EQ(rows[1].row[0], 5);
+}
+
+TEST_CASE(explain_query_plan)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    auto database = MUST(SQL::Database::create(db_name));
+    MUST(database->open());
+
+    create_schema(database);
+    execute(database, "CREATE TABLE TestSchema.TestTable ( Id integer PRIMARY KEY, TextColumn text );");
+
+    auto result = execute(database, "EXPLAIN SELECT * FROM TestSchema.TestTable WHERE Id = 3;");
+    EXPECT_EQ(result.command(), SQL::SQLCommand::Explain);
+    EXPECT_EQ(result.size(), 1u);
+    EXPECT_EQ(result[0].row[0], "SEARCH TABLE TESTSCHEMA.TESTTABLE USING INDEX TESTTABLE_pkey (ID = 3)"sv);
+
+    result = execute(database, "EXPLAIN QUERY PLAN SELECT * FROM TestSchema.TestTable WHERE (Id > 3) AND (Id <= 7);");
+    EXPECT_EQ(result.size(), 1u);
+    EXPECT_EQ(result[0].row[0], "SEARCH TABLE TESTSCHEMA.TESTTABLE USING INDEX TESTTABLE_pkey (ID > 3 AND ID <= 7)"sv);
+
+    result = execute(database, "EXPLAIN SELECT * FROM TestSchema.TestTable WHERE TextColumn = 'T3';");
+    EXPECT_EQ(result.size(), 1u);
+    EXPECT_EQ(result[0].row[0], "SCAN TABLE TESTSCHEMA.TESTTABLE"sv);
+
+    result = execute(database, "EXPLAIN SELECT * FROM TestSchema.TestTable WHERE Id < 3;");
+    EXPECT_EQ(result.size(), 1u);
+    EXPECT_EQ(result[0].row[0], "SCAN TABLE TESTSCHEMA.TESTTABLE"sv);
+}
@@ -58,11 +58,16 @@ TEST_CASE(create_table)
     EXPECT(parse("CREATE TABLE test ( column1 varchar(0xzzz) )"sv).is_error());
     EXPECT(parse("CREATE TABLE test ( column1 int ) AS SELECT * FROM table_name;"sv).is_error());
     EXPECT(parse("CREATE TABLE test AS SELECT * FROM table_name ( column1 int ) ;"sv).is_error());
+    EXPECT(parse("CREATE TABLE test ( column1 int PRIMARY );"sv).is_error());
+    EXPECT(parse("CREATE TABLE test ( column1 int CONSTRAINT );"sv).is_error());
+    EXPECT(parse("CREATE TABLE test ( column1 int CONSTRAINT name );"sv).is_error());
 
     struct Column {
         StringView name;
         StringView type;
         Vector<double> signed_numbers {};
+        bool is_primary_key { false };
+        bool is_unique { false };
     };
 
     auto validate = [](StringView sql, StringView expected_schema, StringView expected_table, Vector<Column> expected_columns, bool expected_is_temporary = false, bool expected_is_error_if_table_exists = true) {
@@ -89,6 +94,8 @@ TEST_CASE(create_table)
             const auto& column = columns[i];
             const auto& expected_column = expected_columns[i];
             EXPECT_EQ(column->name(), expected_column.name);
+            EXPECT_EQ(column->is_primary_key(), expected_column.is_primary_key);
+            EXPECT_EQ(column->is_unique(), expected_column.is_unique);
 
             const auto& type_name = column->type_name();
             EXPECT_EQ(type_name->name(), expected_column.type);
@@ -124,6 +131,11 @@ TEST_CASE(create_table)
     validate("CREATE TABLE test ( column1 varchar(0xff) );"sv, {}, "TEST"sv, { { "COLUMN1"sv, "VARCHAR"sv, { 255 } } });
     validate("CREATE TABLE test ( column1 varchar(3.14) );"sv, {}, "TEST"sv, { { "COLUMN1"sv, "VARCHAR"sv, { 3.14 } } });
     validate("CREATE TABLE test ( column1 varchar(1e3) );"sv, {}, "TEST"sv, { { "COLUMN1"sv, "VARCHAR"sv, { 1000 } } });
+
+    validate("CREATE TABLE test ( column1 int PRIMARY KEY );"sv, {}, "TEST"sv, { { "COLUMN1"sv, "INT"sv, {}, true, false } });
+    validate("CREATE TABLE test ( column1 int UNIQUE );"sv, {}, "TEST"sv, { { "COLUMN1"sv, "INT"sv, {}, false, true } });
+    validate("CREATE TABLE test ( column1 int CONSTRAINT pk PRIMARY KEY );"sv, {}, "TEST"sv, { { "COLUMN1"sv, "INT"sv, {}, true, false } });
+    validate("CREATE TABLE test ( column1 PRIMARY KEY, column2 text UNIQUE );"sv, {}, "TEST"sv, { { "COLUMN1"sv, "BLOB"sv, {}, true, false }, { "COLUMN2"sv, "TEXT"sv, {}, false, true } });
 }
 
 TEST_CASE(alter_table)
@@ -783,3 +795,23 @@ TEST_CASE(describe_table)
     validate("DESCRIBE TABLE TableName;"sv, {}, "TABLENAME"sv);
     validate("DESCRIBE TABLE SchemaName.TableName;"sv, "SCHEMANAME"sv, "TABLENAME"sv);
 }
+
+TEST_CASE(explain)
+{
+    EXPECT(parse("EXPLAIN"sv).is_error());
+    EXPECT(parse("EXPLAIN;"sv).is_error());
+    EXPECT(parse("EXPLAIN QUERY;"sv).is_error());
+    EXPECT(parse("EXPLAIN QUERY PLAN;"sv).is_error());
+    EXPECT(parse("EXPLAIN SELECT"sv).is_error());
+
+    auto validate = [](StringView sql) {
+        auto statement = TRY_OR_FAIL(parse(sql));
+        EXPECT(is<SQL::AST::Explain>(*statement));
+
+        const auto& explain_statement = static_cast<const SQL::AST::Explain&>(*statement);
+        EXPECT(is<SQL::AST::Select>(*explain_statement.statement()));
+    };
+
+    validate("EXPLAIN SELECT * FROM table_name;"sv);
+    validate("EXPLAIN QUERY PLAN SELECT * FROM table_name WHERE column_name = 1;"sv);
+}
@@ -0,0 +1,352 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/MemoryStream.h>
+#include <LibTest/TestCase.h>
+#include <LibWasm/AbstractMachine/AbstractMachine.h>
+#include <LibWasm/AbstractMachine/BytecodeInterpreter.h>
+#include <LibWasm/JIT/NativeFunction.h>
+#include <LibWasm/Types.h>
+#include <stdlib.h>
+
+// (module
+//   (memory 1)
+//   (func $fib (export "fib") (param $n i32) (result i32)
+//     (if (result i32) (i32.lt_s (local.get $n) (i32.const 2))
+//       (then (local.get $n))
+//       (else (i32.add (call $fib (i32.sub (local.get $n) (i32.const 1)))
+//                      (call $fib (i32.sub (local.get $n) (i32.const 2)))))))
+//   (func (export "sum_loop") (param $n i32) (result i32) (local $i i32) (local $sum i32)
+//     (block (loop
+//       (br_if 1 (i32.ge_u (local.get $i) (local.get $n)))
+//       (local.set $sum (i32.add (local.get $sum) (local.get $i)))
+//       (local.set $i (i32.add (local.get $i) (i32.const 1)))
+//       (br 0)))
+//     (local.get $sum))
+//   (func (export "memory_sum") (param $n i32) (result i32) (local $i i32) (local $sum i32) (local $address i32)
+//     (block (loop
+//       (br_if 1 (i32.ge_u (local.get $i) (local.get $n)))
+//       (local.set $address (i32.shl (i32.and (local.get $i) (i32.const 0x3fff)) (i32.const 2)))
+//       (i32.store (local.get $address) (local.get $i))
+//       (local.set $sum (i32.add (local.get $sum) (i32.load (local.get $address))))
+//       (local.set $i (i32.add (local.get $i) (i32.const 1)))
+//       (br 0)))
+//     (local.get $sum))
+//   (func (export "branch_out_of_if") (param $n i32) (result i32)
+//     (block (result i32)
+//       (if (result i32) (local.get $n)
+//         (then (br 0 (i32.const 10)))
+//         (else (i32.const 20)))
+//       (i32.const 1)
+//       (i32.add)))
+//   (func (export "loop_with_result") (param $n i32) (result i32)
+//     (i32.const 100)
+//     (loop (result i32)
+//       (local.set $n (i32.sub (local.get $n) (i32.const 1)))
+//       (local.get $n)
+//       (br_if 0 (local.get $n)))
+//     (i32.add)))
+static constexpr u8 benchmark_module[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x06, 0x01, 0x60, 0x01, 0x7f, 0x01, 0x7f,
+    0x03, 0x06, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x03, 0x01, 0x00, 0x01, 0x07, 0x45, 0x05,
+    0x03, 0x66, 0x69, 0x62, 0x00, 0x00, 0x08, 0x73, 0x75, 0x6d, 0x5f, 0x6c, 0x6f, 0x6f, 0x70, 0x00,
+    0x01, 0x0a, 0x6d, 0x65, 0x6d, 0x6f, 0x72, 0x79, 0x5f, 0x73, 0x75, 0x6d, 0x00, 0x02, 0x10, 0x62,
+    0x72, 0x61, 0x6e, 0x63, 0x68, 0x5f, 0x6f, 0x75, 0x74, 0x5f, 0x6f, 0x66, 0x5f, 0x69, 0x66, 0x00,
+    0x03, 0x10, 0x6c, 0x6f, 0x6f, 0x70, 0x5f, 0x77, 0x69, 0x74, 0x68, 0x5f, 0x72, 0x65, 0x73, 0x75,
+    0x6c, 0x74, 0x00, 0x04, 0x0a, 0xa8, 0x01, 0x05, 0x1c, 0x00, 0x20, 0x00, 0x41, 0x02, 0x48, 0x04,
+    0x7f, 0x20, 0x00, 0x05, 0x20, 0x00, 0x41, 0x01, 0x6b, 0x10, 0x00, 0x20, 0x00, 0x41, 0x02, 0x6b,
+    0x10, 0x00, 0x6a, 0x0b, 0x0b, 0x23, 0x01, 0x02, 0x7f, 0x02, 0x40, 0x03, 0x40, 0x20, 0x01, 0x20,
+    0x00, 0x4f, 0x0d, 0x01, 0x20, 0x02, 0x20, 0x01, 0x6a, 0x21, 0x02, 0x20, 0x01, 0x41, 0x01, 0x6a,
+    0x21, 0x01, 0x0c, 0x00, 0x0b, 0x0b, 0x20, 0x02, 0x0b, 0x39, 0x01, 0x03, 0x7f, 0x02, 0x40, 0x03,
+    0x40, 0x20, 0x01, 0x20, 0x00, 0x4f, 0x0d, 0x01, 0x20, 0x01, 0x41, 0xff, 0xff, 0x00, 0x71, 0x41,
+    0x02, 0x74, 0x21, 0x03, 0x20, 0x03, 0x20, 0x01, 0x36, 0x02, 0x00, 0x20, 0x02, 0x20, 0x03, 0x28,
+    0x02, 0x00, 0x6a, 0x21, 0x02, 0x20, 0x01, 0x41, 0x01, 0x6a, 0x21, 0x01, 0x0c, 0x00, 0x0b, 0x0b,
+    0x20, 0x02, 0x0b, 0x14, 0x00, 0x02, 0x7f, 0x20, 0x00, 0x04, 0x7f, 0x41, 0x0a, 0x0c, 0x00, 0x05,
+    0x41, 0x14, 0x0b, 0x41, 0x01, 0x6a, 0x0b, 0x0b, 0x16, 0x00, 0x41, 0xe4, 0x00, 0x03, 0x7f, 0x20,
+    0x00, 0x41, 0x01, 0x6b, 0x21, 0x00, 0x20, 0x00, 0x20, 0x00, 0x0d, 0x00, 0x0b, 0x6a, 0x0b
+};
+
+// (module
+//   (memory 1)
+//   (func (export "arithmetic") (param $n i32) (result i32)
+//     (i32.xor
+//       (i32.sub
+//         (i32.add
+//           (i32.xor (i32.mul (local.get $n) (i32.const 0x9e3779b1))
+//                    (i32.or (i32.shl (local.get $n) (i32.const 33)) (i32.shr_u (local.get $n) (i32.const 7))))
+//           (i32.sub (local.get $n) (i32.const -100)))
+//         (i32.and (local.get $n) (i32.const 0xff00)))
+//       (i32.shr_s (local.get $n) (i32.const 3))))
+//   (func (export "comparisons") (param $n i32) (result i32)
+//     ;; Every comparison sets a bit of its own.
+//     (i32.eqz (local.get $n))
+//     (i32.or (i32.shl (i32.lt_s (local.get $n) (i32.const 5)) (i32.const 1)))
+//     (i32.or (i32.shl (i32.lt_u (local.get $n) (i32.const 5)) (i32.const 2)))
+//     (i32.or (i32.shl (i32.gt_s (local.get $n) (i32.const -3)) (i32.const 3)))
+//     (i32.or (i32.shl (i32.ge_u (local.get $n) (i32.const 0x80000000)) (i32.const 4)))
+//     (i32.or (i32.shl (i32.eq (local.get $n) (i32.const 7)) (i32.const 5)))
+//     (i32.or (i32.shl (i32.ne (local.get $n) (i32.const 0)) (i32.const 6)))
+//     (i32.or (i32.shl (i32.le_s (local.get $n) (i32.const 0)) (i32.const 7)))
+//     (i32.or (i32.shl (i32.gt_u (local.get $n) (i32.const 9)) (i32.const 8)))
+//     (i32.or (i32.shl (i32.le_u (local.get $n) (i32.const 3)) (i32.const 9)))
+//     (i32.or (i32.shl (i32.ge_s (local.get $n) (i32.const 2)) (i32.const 10))))
+//   (func (export "branch_table") (param $n i32) (result i32)
+//     (block (block (block (block
+//       (br_table 0 1 2 3 (i32.and (local.get $n) (i32.const 3))))
+//       (return (i32.const 10)))
+//       (return (select (i32.const 20) (i32.const 21) (i32.and (local.get $n) (i32.const 4)))))
+//       (return (i32.shr_s (local.get $n) (i32.const 1))))
+//     (i32.const 40))
+//   (func (export "loads_and_stores") (param $n i32) (result i32)
+//     (i32.store (i32.const 8) (local.get $n))
+//     (i32.xor
+//       (i32.add (i32.add (i32.add (i32.load8_s (i32.const 8)) (i32.load8_u offset=1 (i32.const 8)))
+//                         (i32.load16_s (i32.const 8)))
+//                (i32.load16_u offset=4 (i32.const 6)))
+//       (i32.load offset=4 (i32.const 4))))
+//   (func (export "load_at") (param $n i32) (result i32)
+//     (i32.load (local.get $n)))
+//   (func (export "unreachable") (param $n i32) (result i32)
+//     (block (result i32)
+//       (br_if 0 (i32.const 7) (local.get $n))
+//       (drop)
+//       (br 0 (i32.const 5))
+//       (unreachable)
+//       (block (unreachable) (i32.add) (drop))
+//       (i32.add))
+//     (if (i32.eqz (local.get $n)) (then (unreachable))))
+//   (func (export "alternating_sum") (param $n i32) (result i32) (local $i i32) (local $sum i32)
+//     (block (loop
+//       (br_if 1 (i32.ge_s (local.get $i) (local.get $n)))
+//       (local.set $sum (i32.add (local.get $sum)
+//         (if (result i32) (i32.and (local.get $i) (i32.const 1))
+//           (then (local.get $i))
+//           (else (i32.sub (i32.const 0) (local.get $i))))))
+//       (if (i32.eq (local.tee $i (i32.add (local.get $i) (i32.const 1))) (i32.const 1000))
+//         (then (return (local.get $sum))))
+//       (br 0)))
+//     (local.get $sum)))
+static constexpr u8 jit_module[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x06, 0x01, 0x60, 0x01, 0x7f, 0x01, 0x7f,
+    0x03, 0x08, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x03, 0x01, 0x00, 0x01, 0x07,
+    0x68, 0x07, 0x0a, 0x61, 0x72, 0x69, 0x74, 0x68, 0x6d, 0x65, 0x74, 0x69, 0x63, 0x00, 0x00, 0x0b,
+    0x63, 0x6f, 0x6d, 0x70, 0x61, 0x72, 0x69, 0x73, 0x6f, 0x6e, 0x73, 0x00, 0x01, 0x0c, 0x62, 0x72,
+    0x61, 0x6e, 0x63, 0x68, 0x5f, 0x74, 0x61, 0x62, 0x6c, 0x65, 0x00, 0x02, 0x10, 0x6c, 0x6f, 0x61,
+    0x64, 0x73, 0x5f, 0x61, 0x6e, 0x64, 0x5f, 0x73, 0x74, 0x6f, 0x72, 0x65, 0x73, 0x00, 0x03, 0x07,
+    0x6c, 0x6f, 0x61, 0x64, 0x5f, 0x61, 0x74, 0x00, 0x04, 0x0b, 0x75, 0x6e, 0x72, 0x65, 0x61, 0x63,
+    0x68, 0x61, 0x62, 0x6c, 0x65, 0x00, 0x05, 0x0f, 0x61, 0x6c, 0x74, 0x65, 0x72, 0x6e, 0x61, 0x74,
+    0x69, 0x6e, 0x67, 0x5f, 0x73, 0x75, 0x6d, 0x00, 0x06, 0x0a, 0xcd, 0x02, 0x07, 0x2c, 0x00, 0x20,
+    0x00, 0x41, 0xb1, 0xf3, 0xdd, 0xf1, 0x79, 0x6c, 0x20, 0x00, 0x41, 0x21, 0x74, 0x20, 0x00, 0x41,
+    0x07, 0x76, 0x72, 0x73, 0x20, 0x00, 0x41, 0x9c, 0x7f, 0x6b, 0x6a, 0x20, 0x00, 0x41, 0x80, 0xfe,
+    0x03, 0x71, 0x6b, 0x20, 0x00, 0x41, 0x03, 0x75, 0x73, 0x0b, 0x63, 0x00, 0x20, 0x00, 0x45, 0x20,
+    0x00, 0x41, 0x05, 0x48, 0x41, 0x01, 0x74, 0x72, 0x20, 0x00, 0x41, 0x05, 0x49, 0x41, 0x02, 0x74,
+    0x72, 0x20, 0x00, 0x41, 0x7d, 0x4a, 0x41, 0x03, 0x74, 0x72, 0x20, 0x00, 0x41, 0x80, 0x80, 0x80,
+    0x80, 0x78, 0x4f, 0x41, 0x04, 0x74, 0x72, 0x20, 0x00, 0x41, 0x07, 0x46, 0x41, 0x05, 0x74, 0x72,
+    0x20, 0x00, 0x41, 0x00, 0x47, 0x41, 0x06, 0x74, 0x72, 0x20, 0x00, 0x41, 0x00, 0x4c, 0x41, 0x07,
+    0x74, 0x72, 0x20, 0x00, 0x41, 0x09, 0x4b, 0x41, 0x08, 0x74, 0x72, 0x20, 0x00, 0x41, 0x03, 0x4d,
+    0x41, 0x09, 0x74, 0x72, 0x20, 0x00, 0x41, 0x02, 0x4e, 0x41, 0x0a, 0x74, 0x72, 0x0b, 0x2f, 0x00,
+    0x02, 0x40, 0x02, 0x40, 0x02, 0x40, 0x02, 0x40, 0x20, 0x00, 0x41, 0x03, 0x71, 0x0e, 0x03, 0x00,
+    0x01, 0x02, 0x03, 0x0b, 0x41, 0x0a, 0x0f, 0x0b, 0x41, 0x14, 0x41, 0x15, 0x20, 0x00, 0x41, 0x04,
+    0x71, 0x1b, 0x0f, 0x0b, 0x20, 0x00, 0x41, 0x01, 0x75, 0x0f, 0x0b, 0x41, 0x28, 0x0b, 0x26, 0x00,
+    0x41, 0x08, 0x20, 0x00, 0x36, 0x02, 0x00, 0x41, 0x08, 0x2c, 0x00, 0x00, 0x41, 0x08, 0x2d, 0x00,
+    0x01, 0x6a, 0x41, 0x08, 0x2e, 0x01, 0x00, 0x6a, 0x41, 0x06, 0x2f, 0x01, 0x04, 0x6a, 0x41, 0x04,
+    0x28, 0x02, 0x04, 0x73, 0x0b, 0x07, 0x00, 0x20, 0x00, 0x28, 0x02, 0x00, 0x0b, 0x1f, 0x00, 0x02,
+    0x7f, 0x41, 0x07, 0x20, 0x00, 0x0d, 0x00, 0x1a, 0x41, 0x05, 0x0c, 0x00, 0x00, 0x02, 0x40, 0x00,
+    0x6a, 0x1a, 0x0b, 0x6a, 0x0b, 0x20, 0x00, 0x45, 0x04, 0x40, 0x00, 0x0b, 0x0b, 0x3b, 0x01, 0x02,
+    0x7f, 0x02, 0x40, 0x03, 0x40, 0x20, 0x01, 0x20, 0x00, 0x4e, 0x0d, 0x01, 0x20, 0x02, 0x20, 0x01,
+    0x41, 0x01, 0x71, 0x04, 0x7f, 0x20, 0x01, 0x05, 0x41, 0x00, 0x20, 0x01, 0x6b, 0x0b, 0x6a, 0x21,
+    0x02, 0x20, 0x01, 0x41, 0x01, 0x6a, 0x22, 0x01, 0x41, 0xe8, 0x07, 0x46, 0x04, 0x40, 0x20, 0x02,
+    0x0f, 0x0b, 0x0c, 0x00, 0x0b, 0x0b, 0x20, 0x02, 0x0b
+};
+
+class TestModule {
+public:
+    explicit TestModule(ReadonlyBytes bytes = { benchmark_module, sizeof(benchmark_module) })
+    {
+        FixedMemoryStream stream { bytes };
+        m_module = Wasm::Module::parse(stream).release_value();
+        m_instance = m_machine.instantiate(*m_module, {}).release_value();
+    }
+
+    Wasm::Result call(StringView name, i32 argument)
+    {
+        Vector<Wasm::Value> arguments;
+        arguments.append(Wasm::Value(argument));
+        return m_machine.invoke(address_of(name), move(arguments)).assert_wasm_result();
+    }
+
+    i32 invoke(StringView name, i32 argument)
+    {
+        auto result = call(name, argument);
+        VERIFY(!result.is_trap());
+        VERIFY(result.values().size() == 1);
+        return result.values()[0].to<i32>().value();
+    }
+
+    // Functions decide whether to use the JIT (which is only enabled by LIBWASM_JIT) the first time they're called,
+    // so this has to happen before that. Returns whether the function was compiled.
+    bool use_jit(StringView name, bool enabled)
+    {
+        Optional<DeprecatedString> previous_value;
+        if (auto* value = getenv("LIBWASM_JIT"))
+            previous_value = value;
+
+        if (enabled)
+            setenv("LIBWASM_JIT", "1", 1);
+        else
+            unsetenv("LIBWASM_JIT");
+
+        auto& function = m_machine.store().get(address_of(name))->get<Wasm::WasmFunction>();
+        auto did_compile = function.get_or_create_native_function() != nullptr;
+
+        if (previous_value.has_value())
+            setenv("LIBWASM_JIT", previous_value->characters(), 1);
+        else
+            unsetenv("LIBWASM_JIT");
+        return did_compile;
+    }
+
+private:
+    Wasm::FunctionAddress address_of(StringView name) const
+    {
+        for (auto& export_ : m_instance->exports()) {
+            if (export_.name() == name)
+                return export_.value().get<Wasm::FunctionAddress>();
+        }
+        VERIFY_NOT_REACHED();
+    }
+
+    Optional<Wasm::Module> m_module;
+    Wasm::AbstractMachine m_machine;
+    OwnPtr<Wasm::ModuleInstance> m_instance;
+};
+
+TEST_CASE(recursive_calls)
+{
+    TestModule module;
+    EXPECT_EQ(module.invoke("fib"sv, 0), 0);
+    EXPECT_EQ(module.invoke("fib"sv, 1), 1);
+    EXPECT_EQ(module.invoke("fib"sv, 10), 55);
+}
+
+TEST_CASE(loops)
+{
+    TestModule module;
+    EXPECT_EQ(module.invoke("sum_loop"sv, 0), 0);
+    EXPECT_EQ(module.invoke("sum_loop"sv, 100), 4950);
+    EXPECT_EQ(module.invoke("memory_sum"sv, 100), 4950);
+}
+
+TEST_CASE(branch_out_of_if_with_else)
+{
+    TestModule module;
+    EXPECT_EQ(module.invoke("branch_out_of_if"sv, 1), 11);
+    EXPECT_EQ(module.invoke("branch_out_of_if"sv, 0), 21);
+}
+
+TEST_CASE(branch_to_loop_with_result)
+{
+    // Branching back into a loop carries its parameters, not its results, so nothing is left behind on the stack.
+    TestModule module;
+    EXPECT_EQ(module.invoke("loop_with_result"sv, 1), 100);
+    EXPECT_EQ(module.invoke("loop_with_result"sv, 5), 100);
+}
+
+BENCHMARK_CASE(fib_25)
+{
+    TestModule module;
+    EXPECT_EQ(module.invoke("fib"sv, 25), 75025);
+}
+
+BENCHMARK_CASE(sum_loop_1m)
+{
+    TestModule module;
+    EXPECT_EQ(module.invoke("sum_loop"sv, 1'000'000), 1783293664);
+}
+
+BENCHMARK_CASE(memory_sum_1m)
+{
+    TestModule module;
+    EXPECT_EQ(module.invoke("memory_sum"sv, 1'000'000), 1783293664);
+}
+
+static constexpr StringView jit_module_functions[] = {
+    "arithmetic"sv,
+    "comparisons"sv,
+    "branch_table"sv,
+    "loads_and_stores"sv,
+    "load_at"sv,
+    "unreachable"sv,
+    "alternating_sum"sv,
+};
+
+static constexpr i32 interesting_values[] = {
+    0, 1, 2, 3, 4, 5, 6, 7, 9, 10, 999, 1000, 1001, 0x7fff, 0x8000, 0xff00, 0x12345678, 0x7fffffff,
+    -1, -2, -3, -4, -5, -100, -0x8000, NumericLimits<i32>::min()
+};
+
+TEST_CASE(jit_agrees_with_interpreter)
+{
+    TestModule interpreted { { jit_module, sizeof(jit_module) } };
+    TestModule compiled { { jit_module, sizeof(jit_module) } };
+    for (auto name : jit_module_functions) {
+        EXPECT(!interpreted.use_jit(name, false));
+        EXPECT(compiled.use_jit(name, true));
+    }
+
+    for (auto name : jit_module_functions) {
+        for (auto value : interesting_values) {
+            auto expected = interpreted.call(name, value);
+            auto result = compiled.call(name, value);
+            EXPECT_EQ(result.is_trap(), expected.is_trap());
+            if (expected.is_trap()) {
+                EXPECT_EQ(result.trap().reason, expected.trap().reason);
+                continue;
+            }
+            EXPECT_EQ(result.values().size(), 1u);
+            EXPECT_EQ(result.values()[0].to<i32>(), expected.values()[0].to<i32>());
+        }
+    }
+}
+
+TEST_CASE(jit_traps)
+{
+    TestModule module { { jit_module, sizeof(jit_module) } };
+    EXPECT(module.use_jit("load_at"sv, true));
+    EXPECT(module.use_jit("unreachable"sv, true));
+
+    EXPECT_EQ(module.invoke("load_at"sv, 65532), 0);
+    EXPECT(module.call("load_at"sv, 65533).is_trap());
+    EXPECT(module.call("load_at"sv, -1).is_trap());
+    EXPECT_EQ(module.call("load_at"sv, -1).trap().reason, "Memory access out of bounds");
+
+    EXPECT_EQ(module.invoke("unreachable"sv, 1), 7);
+    EXPECT_EQ(module.call("unreachable"sv, 0).trap().reason, "Unreachable");
+}
+
+TEST_CASE(jit_leaves_unsupported_functions_to_the_interpreter)
+{
+    // fib calls itself, which compiled code can't do.
+    TestModule module;
+    EXPECT(!module.use_jit("fib"sv, true));
+    EXPECT_EQ(module.invoke("fib"sv, 10), 55);
+    EXPECT(module.use_jit("loop_with_result"sv, true));
+    EXPECT_EQ(module.invoke("loop_with_result"sv, 5), 100);
+}
+
+BENCHMARK_CASE(sum_loop_1m_jit)
+{
+    TestModule module;
+    EXPECT(module.use_jit("sum_loop"sv, true));
+    EXPECT_EQ(module.invoke("sum_loop"sv, 1'000'000), 1783293664);
+}
+
+BENCHMARK_CASE(memory_sum_1m_jit)
+{
+    TestModule module;
+    EXPECT(module.use_jit("memory_sum"sv, true));
+    EXPECT_EQ(module.invoke("memory_sum"sv, 1'000'000), 1783293664);
+}
@@ -0,0 +1,336 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/URL.h>
+#include <LibWeb/Fetch/Fetching/HTTPCache.h>
+
+using Web::Fetch::Fetching::HTTPCache;
+
+struct TestHeader {
+    StringView name;
+    StringView value;
+};
+
+static Vector<Web::Fetch::Infrastructure::Header> make_headers(Vector<TestHeader> const& headers)
+{
+    Vector<Web::Fetch::Infrastructure::Header> result;
+    for (auto const& [name, value] : headers)
+        result.append({ MUST(ByteBuffer::copy(name.bytes())), MUST(ByteBuffer::copy(value.bytes())) });
+    return result;
+}
+
+static Optional<StringView> get_header(HTTPCache::CachedResponse const& entry, StringView name)
+{
+    for (auto const& header : entry.headers) {
+        if (StringView { header.name }.equals_ignoring_ascii_case(name))
+            return StringView { header.value };
+    }
+    return {};
+}
+
+// Keeps entries in memory, and only answers loads once it's told to, like the real one in RequestServer.
+class FakeDiskStore final : public HTTPCache::DiskStore {
+public:
+    virtual void load_http_cache_entry(DeprecatedString const& key, Function<void(Optional<ByteBuffer>)> on_complete) override
+    {
+        ++load_count;
+        m_pending_loads.append([this, key, on_complete = move(on_complete)] {
+            if (auto entry = entries.get(key); entry.has_value())
+                return on_complete(MUST(ByteBuffer::copy(*entry)));
+            on_complete({});
+        });
+    }
+
+    virtual void store_http_cache_entry(DeprecatedString const& key, ByteBuffer entry) override
+    {
+        ++store_count;
+        entries.set(key, move(entry));
+    }
+
+    virtual void remove_http_cache_entry(DeprecatedString const& key) override { entries.remove(key); }
+    virtual void clear_http_cache() override { entries.clear(); }
+
+    void finish_pending_loads()
+    {
+        auto pending_loads = move(m_pending_loads);
+        for (auto& load : pending_loads)
+            load();
+    }
+
+    HashMap<DeprecatedString, ByteBuffer> entries;
+    size_t load_count { 0 };
+    size_t store_count { 0 };
+
+private:
+    Vector<Function<void()>> m_pending_loads;
+};
+
+static DeprecatedString key_for(StringView top_level_site, StringView url)
+{
+    return HTTPCache::key_for_url(DeprecatedString::formatted("{} {}", top_level_site, top_level_site), AK::URL { url });
+}
+
+static RefPtr<HTTPCache::CachedResponse> select(HTTPCache& cache, DeprecatedString const& key, Vector<TestHeader> const& request_headers = {})
+{
+    return cache.select_response(key, make_headers(request_headers).span());
+}
+
+static void store(HTTPCache& cache, DeprecatedString const& key, Vector<TestHeader> const& request_headers, Vector<TestHeader> const& response_headers, StringView body, UnixDateTime now)
+{
+    cache.store(key, make_headers(request_headers), 200, make_headers(response_headers), body.bytes(), now, now);
+}
+
+static NonnullRefPtr<HTTPCache::CachedResponse> make_entry(Vector<TestHeader> const& headers, UnixDateTime response_time)
+{
+    auto entry = adopt_ref(*new HTTPCache::CachedResponse);
+    entry->status = 200;
+    entry->request_time = response_time;
+    entry->response_time = response_time;
+    for (auto const& [name, value] : headers)
+        entry->headers.append({ MUST(ByteBuffer::copy(name.bytes())), MUST(ByteBuffer::copy(value.bytes())) });
+    return entry;
+}
+
+TEST_CASE(parse_http_date)
+{
+    // Sun, 06 Nov 1994 08:49:37 GMT
+    auto expected = UnixDateTime::from_seconds_since_epoch(784111777);
+
+    EXPECT_EQ(HTTPCache::parse_http_date("Sun, 06 Nov 1994 08:49:37 GMT"sv)->seconds_since_epoch(), expected.seconds_since_epoch());
+    EXPECT_EQ(HTTPCache::parse_http_date("Sunday, 06-Nov-94 08:49:37 GMT"sv)->seconds_since_epoch(), expected.seconds_since_epoch());
+    EXPECT_EQ(HTTPCache::parse_http_date("Sun Nov  6 08:49:37 1994"sv)->seconds_since_epoch(), expected.seconds_since_epoch());
+    EXPECT(!HTTPCache::parse_http_date("yesterday"sv).has_value());
+    EXPECT(!HTTPCache::parse_http_date("Sun, 06 Nov 1994 08:49:37 CET"sv).has_value());
+}
+
+TEST_CASE(freshness_lifetime_prefers_max_age)
+{
+    auto now = UnixDateTime::from_seconds_since_epoch(784111777);
+    auto entry = make_entry({
+                                { "Date"sv, "Sun, 06 Nov 1994 08:49:37 GMT"sv },
+                                { "Expires"sv, "Sun, 06 Nov 1994 09:49:37 GMT"sv },
+                                { "Cache-Control"sv, "public, max-age=60"sv },
+                            },
+        now);
+    EXPECT_EQ(HTTPCache::freshness_lifetime(*entry).to_seconds(), 60);
+}
+
+TEST_CASE(freshness_lifetime_from_expires)
+{
+    auto now = UnixDateTime::from_seconds_since_epoch(784111777);
+    auto entry = make_entry({
+                                { "Date"sv, "Sun, 06 Nov 1994 08:49:37 GMT"sv },
+                                { "Expires"sv, "Sun, 06 Nov 1994 09:49:37 GMT"sv },
+                            },
+        now);
+    EXPECT_EQ(HTTPCache::freshness_lifetime(*entry).to_seconds(), 3600);
+
+    auto invalid_expires = make_entry({ { "Expires"sv, "0"sv } }, now);
+    EXPECT_EQ(HTTPCache::freshness_lifetime(*invalid_expires).to_seconds(), 0);
+}
+
+TEST_CASE(freshness_lifetime_heuristic)
+{
+    auto now = UnixDateTime::from_seconds_since_epoch(784111777);
+    auto entry = make_entry({
+                                { "Date"sv, "Sun, 06 Nov 1994 08:49:37 GMT"sv },
+                                { "Last-Modified"sv, "Sun, 06 Nov 1994 06:09:37 GMT"sv },
+                            },
+        now);
+    // 10% of the 160 minutes since the last modification.
+    EXPECT_EQ(HTTPCache::freshness_lifetime(*entry).to_seconds(), 960);
+
+    auto no_validator = make_entry({ { "Date"sv, "Sun, 06 Nov 1994 08:49:37 GMT"sv } }, now);
+    EXPECT_EQ(HTTPCache::freshness_lifetime(*no_validator).to_seconds(), 0);
+}
+
+TEST_CASE(current_age)
+{
+    auto response_time = UnixDateTime::from_seconds_since_epoch(784111777);
+    auto entry = make_entry({
+                                { "Date"sv, "Sun, 06 Nov 1994 08:49:37 GMT"sv },
+                                { "Age"sv, "30"sv },
+                            },
+        response_time);
+    entry->request_time = response_time - Duration::from_seconds(2);
+
+    // Age header, plus the time the response took to arrive, plus the time it has been stored.
+    auto now = response_time + Duration::from_seconds(100);
+    EXPECT_EQ(HTTPCache::current_age(*entry, now).to_seconds(), 132);
+}
+
+TEST_CASE(store_and_select_response)
+{
+    HTTPCache cache;
+    auto now = UnixDateTime::now();
+    auto key = key_for("https://a.example"sv, "https://cdn.example/image.png#fragment"sv);
+    EXPECT_EQ(key, key_for("https://a.example"sv, "https://cdn.example/image.png"sv));
+
+    store(cache, key, {}, { { "Cache-Control"sv, "max-age=60"sv } }, "hello"sv, now);
+
+    auto entry = select(cache, key);
+    EXPECT(entry);
+    EXPECT_EQ(entry->status, 200);
+    EXPECT_EQ(StringView { entry->body.bytes() }, "hello"sv);
+    EXPECT(!HTTPCache::needs_validation(*entry, {}, now));
+
+    // The same URL requested from another top-level site is stored apart.
+    EXPECT(!select(cache, key_for("https://b.example"sv, "https://cdn.example/image.png"sv)));
+}
+
+TEST_CASE(responses_that_cannot_be_reused_are_not_stored)
+{
+    HTTPCache cache;
+    auto now = UnixDateTime::now();
+    auto key = key_for("https://a.example"sv, "https://a.example/"sv);
+
+    store(cache, key, {}, { { "Cache-Control"sv, "no-store, max-age=60"sv } }, "hello"sv, now);
+    EXPECT(!select(cache, key));
+
+    store(cache, key, { { "Cache-Control"sv, "no-store"sv } }, { { "Cache-Control"sv, "max-age=60"sv } }, "hello"sv, now);
+    EXPECT(!select(cache, key));
+
+    store(cache, key, {}, { { "Cache-Control"sv, "max-age=60"sv }, { "Vary"sv, "*"sv } }, "hello"sv, now);
+    EXPECT(!select(cache, key));
+
+    // Neither fresh nor validatable.
+    store(cache, key, {}, {}, "hello"sv, now);
+    EXPECT(!select(cache, key));
+}
+
+TEST_CASE(vary_selects_matching_variant)
+{
+    HTTPCache cache;
+    auto now = UnixDateTime::now();
+    auto key = key_for("https://a.example"sv, "https://a.example/greeting"sv);
+    Vector<TestHeader> response_headers { { "Cache-Control"sv, "max-age=60"sv }, { "Vary"sv, "Accept-Language"sv } };
+
+    store(cache, key, { { "Accept-Language"sv, "en"sv } }, response_headers, "hello"sv, now);
+    store(cache, key, { { "accept-language"sv, "de"sv } }, response_headers, "hallo"sv, now);
+
+    auto english = select(cache, key, { { "Accept-Language"sv, "en"sv } });
+    EXPECT(english);
+    EXPECT_EQ(StringView { english->body.bytes() }, "hello"sv);
+    auto german = select(cache, key, { { "Accept-Language"sv, "de"sv } });
+    EXPECT(german);
+    EXPECT_EQ(StringView { german->body.bytes() }, "hallo"sv);
+    EXPECT(!select(cache, key, { { "Accept-Language"sv, "fr"sv } }));
+    EXPECT(!select(cache, key));
+
+    // A newer response for the same request headers replaces the old one.
+    store(cache, key, { { "Accept-Language"sv, "en"sv } }, response_headers, "hi"sv, now);
+    english = select(cache, key, { { "Accept-Language"sv, "en"sv } });
+    EXPECT_EQ(StringView { english->body.bytes() }, "hi"sv);
+}
+
+TEST_CASE(revalidate_and_freshen)
+{
+    HTTPCache cache;
+    FakeDiskStore disk_store;
+    cache.set_disk_store(&disk_store);
+
+    auto stored_at = UnixDateTime::now() - Duration::from_seconds(120);
+    auto key = key_for("https://a.example"sv, "https://a.example/script.js"sv);
+    store(cache, key, {}, { { "Cache-Control"sv, "max-age=60"sv }, { "ETag"sv, "\"v1\""sv }, { "Content-Length"sv, "5"sv } }, "hello"sv, stored_at);
+    EXPECT_EQ(disk_store.store_count, 1u);
+
+    auto now = UnixDateTime::now();
+    auto entry = select(cache, key);
+    EXPECT(entry);
+    EXPECT(HTTPCache::needs_validation(*entry, {}, now));
+
+    // The request can ask for validation of a fresh response as well.
+    EXPECT(HTTPCache::needs_validation(*entry, make_headers({ { "Cache-Control"sv, "no-cache"sv } }), stored_at));
+
+    // A 304 response updates the stored headers, except for Content-Length.
+    cache.freshen(*entry, make_headers({ { "Cache-Control"sv, "max-age=300"sv }, { "Content-Length"sv, "0"sv } }), now, now);
+    entry = select(cache, key);
+    EXPECT(entry);
+    EXPECT(!HTTPCache::needs_validation(*entry, {}, now));
+    EXPECT_EQ(get_header(*entry, "Cache-Control"sv), "max-age=300"sv);
+    EXPECT_EQ(get_header(*entry, "Content-Length"sv), "5"sv);
+    EXPECT_EQ(get_header(*entry, "ETag"sv), "\"v1\""sv);
+    EXPECT_EQ(StringView { entry->body.bytes() }, "hello"sv);
+
+    // The freshened response makes it to the disk store too.
+    EXPECT_EQ(disk_store.store_count, 2u);
+    HTTPCache other_cache;
+    other_cache.set_disk_store(&disk_store);
+    other_cache.load_from_disk(key, [] {});
+    disk_store.finish_pending_loads();
+    auto loaded_entry = select(other_cache, key);
+    EXPECT(loaded_entry);
+    EXPECT(!HTTPCache::needs_validation(*loaded_entry, {}, now));
+}
+
+TEST_CASE(evicted_responses_are_loaded_from_disk)
+{
+    HTTPCache cache;
+    FakeDiskStore disk_store;
+    cache.set_disk_store(&disk_store);
+
+    auto now = UnixDateTime::now();
+    auto body = MUST(ByteBuffer::create_zeroed(7 * MiB));
+    Vector<DeprecatedString> keys;
+    for (size_t i = 0; i < 5; ++i) {
+        keys.append(key_for("https://a.example"sv, DeprecatedString::formatted("https://a.example/{}.bin", i)));
+        cache.store(keys.last(), {}, 200, make_headers({ { "Cache-Control"sv, "max-age=60"sv } }), body, now, now);
+    }
+
+    // The memory tier only holds 32 MiB, so the least recently used response had to go.
+    EXPECT(!select(cache, keys[0]));
+    EXPECT(select(cache, keys[4]));
+    EXPECT(!cache.should_load_from_disk(keys[4]));
+    EXPECT(cache.should_load_from_disk(keys[0]));
+
+    // Loads of the same key share one trip to the disk store.
+    size_t completed_loads = 0;
+    cache.load_from_disk(keys[0], [&] { ++completed_loads; });
+    cache.load_from_disk(keys[0], [&] { ++completed_loads; });
+    EXPECT_EQ(disk_store.load_count, 1u);
+    EXPECT_EQ(completed_loads, 0u);
+    disk_store.finish_pending_loads();
+    EXPECT_EQ(completed_loads, 2u);
+
+    auto entry = select(cache, keys[0]);
+    EXPECT(entry);
+    EXPECT_EQ(entry->body.size(), 7 * MiB);
+    EXPECT(!cache.should_load_from_disk(keys[0]));
+
+    // Keys that the disk store doesn't have aren't asked about again.
+    auto missing_key = key_for("https://a.example"sv, "https://a.example/missing.bin"sv);
+    EXPECT(cache.should_load_from_disk(missing_key));
+    cache.load_from_disk(missing_key, [&] { ++completed_loads; });
+    disk_store.finish_pending_loads();
+    EXPECT_EQ(completed_loads, 3u);
+    EXPECT(!select(cache, missing_key));
+    EXPECT(!cache.should_load_from_disk(missing_key));
+}
+
+TEST_CASE(invalidate_and_clear)
+{
+    HTTPCache cache;
+    FakeDiskStore disk_store;
+    cache.set_disk_store(&disk_store);
+
+    auto now = UnixDateTime::now();
+    auto key = key_for("https://a.example"sv, "https://a.example/form"sv);
+    auto other_key = key_for("https://a.example"sv, "https://a.example/other"sv);
+    store(cache, key, {}, { { "Cache-Control"sv, "max-age=60"sv } }, "hello"sv, now);
+    store(cache, other_key, {}, { { "Cache-Control"sv, "max-age=60"sv } }, "hello"sv, now);
+
+    cache.invalidate(key);
+    EXPECT(!select(cache, key));
+    EXPECT(!disk_store.entries.contains(key));
+    EXPECT(!cache.should_load_from_disk(key));
+    EXPECT(select(cache, other_key));
+
+    cache.clear();
+    EXPECT(!select(cache, other_key));
+    EXPECT(disk_store.entries.is_empty());
+}
@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <LibGfx/Bitmap.h>
+#include <LibWeb/Painting/PaintingCommandExecutorCPU.h>
+#include <LibWeb/Painting/RecordingPainter.h>
+#include <LibWeb/Painting/TileCache.h>
+
+using Web::Painting::RecordingPainter;
+using Web::Painting::TileCache;
+
+// Three columns and three rows of tiles, where the last ones are only partially covered.
+static constexpr Gfx::IntSize frame_size { 600, 520 };
+
+// Records a page with stripes and boxes that span several tiles, as seen when scrolled to `scroll_position`.
+static void record_page(RecordingPainter& painter, Gfx::IntPoint scroll_position, Color accent_color = Color::Red)
+{
+    painter.fill_rect({ {}, frame_size }, Color::White);
+    painter.translate(-scroll_position);
+    for (int y = 0; y < 2000; y += 40)
+        painter.fill_rect({ 0, y, 2000, 20 }, Color(y % 256, 255 - y % 256, 128));
+    for (int i = 0; i < 20; ++i)
+        painter.fill_rect({ 37 * i, 91 * i, 150, 70 }, i % 2 ? accent_color : Color::Blue);
+}
+
+static NonnullRefPtr<Gfx::Bitmap> create_target()
+{
+    auto bitmap = MUST(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, frame_size));
+    bitmap->fill(Color::Black);
+    return bitmap;
+}
+
+static NonnullRefPtr<Gfx::Bitmap> paint_directly(Gfx::IntPoint scroll_position, Color accent_color = Color::Red)
+{
+    RecordingPainter painter;
+    record_page(painter, scroll_position, accent_color);
+    auto target = create_target();
+    Web::Painting::PaintingCommandExecutorCPU executor { *target };
+    painter.execute(executor);
+    return target;
+}
+
+static NonnullRefPtr<Gfx::Bitmap> paint_with_cache(TileCache& cache, Gfx::IntPoint scroll_position, Color accent_color = Color::Red)
+{
+    RecordingPainter painter;
+    record_page(painter, scroll_position, accent_color);
+    auto target = create_target();
+    MUST(cache.paint(painter, frame_size, *target));
+    return target;
+}
+
+static size_t count_different_pixels(Gfx::Bitmap const& a, Gfx::Bitmap const& b)
+{
+    size_t count = 0;
+    for (int y = 0; y < frame_size.height(); ++y) {
+        for (int x = 0; x < frame_size.width(); ++x) {
+            if (a.get_pixel(x, y) != b.get_pixel(x, y))
+                ++count;
+        }
+    }
+    return count;
+}
+
+static size_t count_valid_tiles(TileCache const& cache)
+{
+    size_t count = 0;
+    for (size_t tile_index = 0; tile_index < cache.tile_count(); ++tile_index) {
+        if (cache.tile_is_valid(tile_index))
+            ++count;
+    }
+    return count;
+}
+
+TEST_CASE(first_paint_goes_straight_into_the_target_and_fills_the_cache)
+{
+    TileCache cache;
+    auto first_frame = paint_with_cache(cache, {});
+    EXPECT_EQ(count_different_pixels(*first_frame, *paint_directly({})), 0u);
+    EXPECT_EQ(cache.tile_count(), 9u);
+    EXPECT_EQ(count_valid_tiles(cache), 9u);
+
+    // Nothing was invalidated, so the next frame comes out of the cache, even though the page changed.
+    auto second_frame = paint_with_cache(cache, {}, Color::Green);
+    EXPECT_EQ(count_different_pixels(*second_frame, *first_frame), 0u);
+}
+
+TEST_CASE(tiles_are_painted_the_same_as_the_whole_frame)
+{
+    TileCache cache;
+    (void)paint_with_cache(cache, {});
+
+    // Leave only the first tile valid, so the others are painted one by one, then repaint that one as well.
+    cache.invalidate({ TileCache::tile_size, 0, frame_size.width(), frame_size.height() });
+    cache.invalidate({ 0, TileCache::tile_size, frame_size.width(), frame_size.height() });
+    EXPECT_EQ(count_valid_tiles(cache), 1u);
+    (void)paint_with_cache(cache, {}, Color::Green);
+
+    cache.invalidate({ 0, 0, 1, 1 });
+    auto frame = paint_with_cache(cache, {}, Color::Green);
+    EXPECT_EQ(count_valid_tiles(cache), 9u);
+    EXPECT_EQ(count_different_pixels(*frame, *paint_directly({}, Color::Green)), 0u);
+}
+
+TEST_CASE(only_invalidated_tiles_are_repainted)
+{
+    TileCache cache;
+    auto red_frame = paint_with_cache(cache, {});
+
+    // Only the tile in the middle is repainted, so the red boxes only turn green there.
+    cache.invalidate({ 300, 300, 10, 10 });
+    EXPECT_EQ(count_valid_tiles(cache), 8u);
+    auto frame = paint_with_cache(cache, {}, Color::Green);
+    auto green_frame = paint_directly({}, Color::Green);
+
+    for (int y = 0; y < frame_size.height(); ++y) {
+        for (int x = 0; x < frame_size.width(); ++x) {
+            bool is_in_invalidated_tile = x >= TileCache::tile_size && x < 2 * TileCache::tile_size && y >= TileCache::tile_size && y < 2 * TileCache::tile_size;
+            auto const& expected_frame = is_in_invalidated_tile ? green_frame : red_frame;
+            if (frame->get_pixel(x, y) != expected_frame->get_pixel(x, y)) {
+                FAIL(DeprecatedString::formatted("Unexpected pixel at {},{}", x, y));
+                return;
+            }
+        }
+    }
+}
+
+TEST_CASE(scrolling_keeps_the_tiles_that_are_still_visible)
+{
+    struct Scroll {
+        Gfx::IntPoint from;
+        Gfx::IntPoint to;
+        size_t valid_tile_count;
+    };
+
+    for (auto scroll : {
+             // Down by exactly one row of tiles: the new first row was the second one.
+             Scroll { { 0, 0 }, { 0, TileCache::tile_size }, 3 },
+             // Down by less than a tile: the first row still only contains pixels of the first two rows.
+             Scroll { { 0, 0 }, { 0, 100 }, 3 },
+             // Up: the last two rows contain pixels of the first two.
+             Scroll { { 0, 300 }, { 0, 250 }, 6 },
+             // Sideways: the first two columns still only contain pixels of the frame.
+             Scroll { { 0, 0 }, { 30, 0 }, 6 },
+             Scroll { { 100, 0 }, { 0, 0 }, 6 },
+         }) {
+        TileCache cache;
+        (void)paint_with_cache(cache, scroll.from);
+
+        cache.scroll_by(scroll.from - scroll.to);
+        EXPECT_EQ(count_valid_tiles(cache), scroll.valid_tile_count);
+
+        auto frame = paint_with_cache(cache, scroll.to);
+        EXPECT_EQ(count_different_pixels(*frame, *paint_directly(scroll.to)), 0u);
+    }
+}
+
+TEST_CASE(scrolling_by_more_than_the_frame_invalidates_every_tile)
+{
+    TileCache cache;
+    (void)paint_with_cache(cache, {});
+
+    cache.scroll_by({ 0, -frame_size.height() });
+    EXPECT_EQ(count_valid_tiles(cache), 0u);
+
+    auto frame = paint_with_cache(cache, { 0, frame_size.height() });
+    EXPECT_EQ(count_different_pixels(*frame, *paint_directly({ 0, frame_size.height() })), 0u);
+}
+
+TEST_CASE(scrolling_keeps_invalidated_tiles_invalid)
+{
+    TileCache cache;
+    (void)paint_with_cache(cache, {});
+
+    // The second row moves up into the first one, which can then only be reused where the second row was valid.
+    cache.invalidate({ 0, TileCache::tile_size, 1, 1 });
+    cache.scroll_by({ 0, -TileCache::tile_size });
+    EXPECT(!cache.tile_is_valid(0));
+    EXPECT(cache.tile_is_valid(1));
+    EXPECT(cache.tile_is_valid(2));
+}
+
+TEST_CASE(content_fixed_to_the_viewport_is_detected)
+{
+    RecordingPainter painter;
+    record_page(painter, {});
+    EXPECT(!painter.has_content_fixed_to_the_viewport());
+
+    painter.mark_as_having_content_fixed_to_the_viewport();
+    EXPECT(painter.has_content_fixed_to_the_viewport());
+
+    RecordingPainter painter_with_fixed_position_box;
+    painter_with_fixed_position_box.push_stacking_context({
+        .opacity = 1.0f,
+        .is_fixed_position = true,
+        .source_paintable_rect = { 0, 0, 100, 100 },
+        .image_rendering = Web::CSS::ImageRendering::Auto,
+        .transform = { .origin = {}, .matrix = Gfx::FloatMatrix4x4::identity() },
+    });
+    painter_with_fixed_position_box.fill_rect({ 0, 0, 100, 100 }, Color::Red);
+    painter_with_fixed_position_box.pop_stacking_context();
+    EXPECT(painter_with_fixed_position_box.has_content_fixed_to_the_viewport());
+}
@@ -115,6 +115,12 @@ struct MallocStats {
     size_t number_of_hot_keeps;
     size_t number_of_cold_keeps;
     size_t number_of_frees;
+
+    size_t number_of_thread_cache_hits;
+    size_t number_of_thread_cache_misses;
+    size_t number_of_thread_cache_refills;
+    size_t number_of_thread_cache_frees;
+    size_t number_of_thread_cache_flushes;
 };
 static MallocStats g_malloc_stats = {};
 
@@ -153,6 +159,87 @@ static inline BigAllocator (&big_allocators())[1]
     return reinterpret_cast<BigAllocator(&)[1]>(g_big_allocators_storage);
 }
 
+#ifndef NO_TLS
+#    define MALLOC_THREAD_CACHE
+#endif
+
+#ifdef MALLOC_THREAD_CACHE
+// Every thread keeps a small cache of free chunks for each size class, which lets most
+// malloc() and free() calls complete without taking s_malloc_mutex. Chunks sitting in a
+// thread cache still count as used in their ChunkedBlock, so whichever thread ends up
+// holding a chunk (including one that did not allocate it) can hand it back to the
+// global allocator later on. They do carry a freed chunk marker though, see below.
+constexpr size_t thread_cache_bytes_per_size_class = 16 * KiB;
+constexpr size_t thread_cache_max_chunks_per_size_class = 32;
+
+struct ThreadCacheBin {
+    FreelistEntry* chunks { nullptr };
+    size_t chunk_count { 0 };
+};
+
+struct ThreadCache {
+    ThreadCacheBin bins[num_size_classes];
+
+    // These are only folded into g_malloc_stats while holding s_malloc_mutex.
+    size_t number_of_hits { 0 };
+    size_t number_of_misses { 0 };
+    size_t number_of_frees { 0 };
+};
+
+static __thread ThreadCache s_thread_cache;
+static bool s_thread_cache_enabled = true;
+
+static constexpr size_t thread_cache_capacity(size_t bytes_per_chunk)
+{
+    return clamp<size_t>(thread_cache_bytes_per_size_class / bytes_per_chunk, 1, thread_cache_max_chunks_per_size_class);
+}
+
+// The number of chunks moved between a thread cache and the global allocator at once.
+static constexpr size_t thread_cache_batch_size(size_t bytes_per_chunk)
+{
+    return max<size_t>(thread_cache_capacity(bytes_per_chunk) / 2, 1);
+}
+
+// Must be called with s_malloc_mutex held.
+static void flush_thread_cache_stats()
+{
+    g_malloc_stats.number_of_thread_cache_hits += exchange(s_thread_cache.number_of_hits, 0);
+    g_malloc_stats.number_of_thread_cache_misses += exchange(s_thread_cache.number_of_misses, 0);
+    g_malloc_stats.number_of_thread_cache_frees += exchange(s_thread_cache.number_of_frees, 0);
+}
+#endif
+
+// Every free chunk, whether it sits on a block's freelist or in a thread cache, has its second
+// word set to this marker. Allocating a chunk clears it again, so finding the marker in a chunk
+// that's being freed means it's a double free. The marker depends on a per-process secret to
+// keep user data from matching it by accident (or on purpose).
+static FlatPtr s_freed_chunk_secret;
+
+static ALWAYS_INLINE FlatPtr& freed_chunk_marker_slot(void* ptr)
+{
+    return reinterpret_cast<FlatPtr*>(ptr)[1];
+}
+
+static ALWAYS_INLINE FlatPtr freed_chunk_marker(void* ptr)
+{
+    return s_freed_chunk_secret ^ reinterpret_cast<FlatPtr>(ptr);
+}
+
+static ALWAYS_INLINE void mark_chunk_as_free(void* ptr)
+{
+    freed_chunk_marker_slot(ptr) = freed_chunk_marker(ptr);
+}
+
+static ALWAYS_INLINE void mark_chunk_as_used(void* ptr)
+{
+    freed_chunk_marker_slot(ptr) = 0;
+}
+
+static ALWAYS_INLINE bool chunk_is_marked_as_free(void* ptr)
+{
+    return freed_chunk_marker_slot(ptr) == freed_chunk_marker(ptr);
+}
+
 // --- BEGIN MATH ---
 // This stuff is only used for checking if there exists an aligned block in a
 // chunk. It has no bearing on the rest of the allocator, especially for
@@ -284,6 +371,174 @@ static void* try_allocate_chunk_aligned(size_t align, ChunkedBlock& block)
     return nullptr;
 }
 
+// Takes a chunk from one of the allocator's blocks, getting hold of a new block if necessary.
+// Must be called with s_malloc_mutex held.
+static ErrorOr<void*> allocate_chunk(Allocator& allocator, size_t good_size, size_t align)
+{
+    ChunkedBlock* block = nullptr;
+    void* ptr = nullptr;
+    for (auto& current : allocator.usable_blocks) {
+        if (current.free_chunks()) {
+            ptr = try_allocate_chunk_aligned(align, current);
+            if (ptr) {
+                block = &current;
+                break;
+            }
+        }
+    }
+
+    if (!block && s_hot_empty_block_count) {
+        g_malloc_stats.number_of_hot_empty_block_hits++;
+        block = s_hot_empty_blocks[--s_hot_empty_block_count];
+        if (block->m_size != good_size) {
+            new (block) ChunkedBlock(good_size);
+            ue_notify_chunk_size_changed(block, good_size);
+            char buffer[64];
+            snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
+            set_mmap_name(block, ChunkedBlock::block_size, buffer);
+        }
+        allocator.usable_blocks.append(*block);
+    }
+
+    if (!block && s_cold_empty_block_count) {
+        g_malloc_stats.number_of_cold_empty_block_hits++;
+        block = s_cold_empty_blocks[--s_cold_empty_block_count];
+        int rc = madvise(block, ChunkedBlock::block_size, MADV_SET_NONVOLATILE);
+        bool this_block_was_purged = rc == 1;
+        if (rc < 0) {
+            perror("madvise");
+            VERIFY_NOT_REACHED();
+        }
+        rc = mprotect(block, ChunkedBlock::block_size, PROT_READ | PROT_WRITE);
+        if (rc < 0) {
+            perror("mprotect");
+            VERIFY_NOT_REACHED();
+        }
+        if (this_block_was_purged || block->m_size != good_size) {
+            if (this_block_was_purged)
+                g_malloc_stats.number_of_cold_empty_block_purge_hits++;
+            new (block) ChunkedBlock(good_size);
+            ue_notify_chunk_size_changed(block, good_size);
+        }
+        allocator.usable_blocks.append(*block);
+    }
+
+    if (!block) {
+        g_malloc_stats.number_of_block_allocs++;
+        char buffer[64];
+        snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
+        block = (ChunkedBlock*)TRY(os_alloc(ChunkedBlock::block_size, buffer));
+        new (block) ChunkedBlock(good_size);
+        allocator.usable_blocks.append(*block);
+        ++allocator.block_count;
+    }
+
+    if (!ptr) {
+        ptr = try_allocate_chunk_aligned(align, *block);
+    }
+
+    VERIFY(ptr);
+    if (block->is_full()) {
+        g_malloc_stats.number_of_blocks_full++;
+        dbgln_if(MALLOC_DEBUG, "Block {:p} is now full in size class {}", block, good_size);
+        allocator.usable_blocks.remove(*block);
+        allocator.full_blocks.append(*block);
+    }
+    dbgln_if(MALLOC_DEBUG, "LibC: allocated {:p} (chunk in block {:p}, size {})", ptr, block, block->bytes_per_chunk());
+    mark_chunk_as_used(ptr);
+    return ptr;
+}
+
+// Returns a chunk to its block, releasing or recycling the block once it becomes empty.
+// Must be called with s_malloc_mutex held.
+static void free_chunk(ChunkedBlock* block, void* ptr)
+{
+    dbgln_if(MALLOC_DEBUG, "LibC: freeing {:p} in allocator {:p} (size={}, used={})", ptr, block, block->bytes_per_chunk(), block->used_chunks());
+
+    auto* entry = (FreelistEntry*)ptr;
+    entry->next = block->m_freelist;
+    block->m_freelist = entry;
+    mark_chunk_as_free(ptr);
+
+    if (block->is_full()) {
+        size_t good_size;
+        auto* allocator = allocator_for_size(block->m_size, good_size);
+        dbgln_if(MALLOC_DEBUG, "Block {:p} no longer full in size class {}", block, good_size);
+        g_malloc_stats.number_of_freed_full_blocks++;
+        allocator->full_blocks.remove(*block);
+        allocator->usable_blocks.prepend(*block);
+    }
+
+    ++block->m_free_chunks;
+
+    if (!block->used_chunks()) {
+        size_t good_size;
+        auto* allocator = allocator_for_size(block->m_size, good_size);
+        if (s_hot_empty_block_count < number_of_hot_chunked_blocks_to_keep_around) {
+            dbgln_if(MALLOC_DEBUG, "Keeping hot block {:p} around", block);
+            g_malloc_stats.number_of_hot_keeps++;
+            allocator->usable_blocks.remove(*block);
+            s_hot_empty_blocks[s_hot_empty_block_count++] = block;
+            return;
+        }
+        if (s_cold_empty_block_count < number_of_cold_chunked_blocks_to_keep_around) {
+            dbgln_if(MALLOC_DEBUG, "Keeping cold block {:p} around", block);
+            g_malloc_stats.number_of_cold_keeps++;
+            allocator->usable_blocks.remove(*block);
+            s_cold_empty_blocks[s_cold_empty_block_count++] = block;
+            mprotect(block, ChunkedBlock::block_size, PROT_NONE);
+            madvise(block, ChunkedBlock::block_size, MADV_SET_VOLATILE);
+            return;
+        }
+        dbgln_if(MALLOC_DEBUG, "Releasing block {:p} for size class {}", block, good_size);
+        g_malloc_stats.number_of_frees++;
+        allocator->usable_blocks.remove(*block);
+        --allocator->block_count;
+        os_free(block, ChunkedBlock::block_size);
+    }
+}
+
+#ifdef MALLOC_THREAD_CACHE
+// Moves a batch of chunks from the global allocator into the (empty) thread cache bin.
+static ErrorOr<void> refill_thread_cache_bin(ThreadCacheBin& bin, Allocator& allocator, size_t good_size)
+{
+    VERIFY(!bin.chunks);
+    PthreadMutexLocker locker(s_malloc_mutex);
+    g_malloc_stats.number_of_thread_cache_refills++;
+    flush_thread_cache_stats();
+    auto batch_size = thread_cache_batch_size(good_size);
+    for (size_t i = 0; i < batch_size; ++i) {
+        auto ptr_or_error = allocate_chunk(allocator, good_size, 16);
+        if (ptr_or_error.is_error()) {
+            // Make do with what we managed to get so far.
+            if (bin.chunks)
+                break;
+            return ptr_or_error.release_error();
+        }
+        auto* entry = (FreelistEntry*)ptr_or_error.value();
+        entry->next = bin.chunks;
+        bin.chunks = entry;
+        ++bin.chunk_count;
+        mark_chunk_as_free(entry);
+    }
+    return {};
+}
+
+// Hands up to chunk_count chunks from the thread cache bin back to the global allocator.
+static void flush_thread_cache_bin(ThreadCacheBin& bin, size_t chunk_count)
+{
+    PthreadMutexLocker locker(s_malloc_mutex);
+    g_malloc_stats.number_of_thread_cache_flushes++;
+    flush_thread_cache_stats();
+    for (size_t i = 0; i < chunk_count && bin.chunks; ++i) {
+        auto* entry = bin.chunks;
+        bin.chunks = entry->next;
+        --bin.chunk_count;
+        free_chunk((ChunkedBlock*)((FlatPtr)entry & ChunkedBlock::block_mask), entry);
+    }
+}
+#endif
+
 enum class CallerWillInitializeMemory {
     No,
     Yes,
@@ -321,6 +576,30 @@ static ErrorOr<void*> malloc_impl(size_t size, size_t align, CallerWillInitializ
     size_t good_size;
     auto* allocator = allocator_for_size(size, good_size, align);
 
+#ifdef MALLOC_THREAD_CACHE
+    // Every chunk is at least 16-byte aligned, so the thread cache can serve all allocations with default alignment.
+    if (allocator && align <= 16 && s_thread_cache_enabled) {
+        auto& bin = s_thread_cache.bins[allocator - allocators()];
+        if (bin.chunks) {
+            s_thread_cache.number_of_hits++;
+        } else {
+            s_thread_cache.number_of_misses++;
+            TRY(refill_thread_cache_bin(bin, *allocator, good_size));
+        }
+        auto* entry = bin.chunks;
+        bin.chunks = entry->next;
+        --bin.chunk_count;
+
+        void* ptr = entry;
+        mark_chunk_as_used(ptr);
+        if (s_scrub_malloc && caller_will_initialize_memory == CallerWillInitializeMemory::No)
+            memset(ptr, MALLOC_SCRUB_BYTE, good_size);
+
+        ue_notify_malloc(ptr, size);
+        return ptr;
+    }
+#endif
+
     PthreadMutexLocker locker(s_malloc_mutex);
 
     if (!allocator) {
@@ -365,79 +644,10 @@ static ErrorOr<void*> malloc_impl(size_t size, size_t align, CallerWillInitializ
         return ptr;
     }
 
-    ChunkedBlock* block = nullptr;
-    void* ptr = nullptr;
-    for (auto& current : allocator->usable_blocks) {
-        if (current.free_chunks()) {
-            ptr = try_allocate_chunk_aligned(align, current);
-            if (ptr) {
-                block = &current;
-                break;
-            }
-        }
-    }
-
-    if (!block && s_hot_empty_block_count) {
-        g_malloc_stats.number_of_hot_empty_block_hits++;
-        block = s_hot_empty_blocks[--s_hot_empty_block_count];
-        if (block->m_size != good_size) {
-            new (block) ChunkedBlock(good_size);
-            ue_notify_chunk_size_changed(block, good_size);
-            char buffer[64];
-            snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
-            set_mmap_name(block, ChunkedBlock::block_size, buffer);
-        }
-        allocator->usable_blocks.append(*block);
-    }
-
-    if (!block && s_cold_empty_block_count) {
-        g_malloc_stats.number_of_cold_empty_block_hits++;
-        block = s_cold_empty_blocks[--s_cold_empty_block_count];
-        int rc = madvise(block, ChunkedBlock::block_size, MADV_SET_NONVOLATILE);
-        bool this_block_was_purged = rc == 1;
-        if (rc < 0) {
-            perror("madvise");
-            VERIFY_NOT_REACHED();
-        }
-        rc = mprotect(block, ChunkedBlock::block_size, PROT_READ | PROT_WRITE);
-        if (rc < 0) {
-            perror("mprotect");
-            VERIFY_NOT_REACHED();
-        }
-        if (this_block_was_purged || block->m_size != good_size) {
-            if (this_block_was_purged)
-                g_malloc_stats.number_of_cold_empty_block_purge_hits++;
-            new (block) ChunkedBlock(good_size);
-            ue_notify_chunk_size_changed(block, good_size);
-        }
-        allocator->usable_blocks.append(*block);
-    }
-
-    if (!block) {
-        g_malloc_stats.number_of_block_allocs++;
-        char buffer[64];
-        snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
-        block = (ChunkedBlock*)TRY(os_alloc(ChunkedBlock::block_size, buffer));
-        new (block) ChunkedBlock(good_size);
-        allocator->usable_blocks.append(*block);
-        ++allocator->block_count;
-    }
-
-    if (!ptr) {
-        ptr = try_allocate_chunk_aligned(align, *block);
-    }
-
-    VERIFY(ptr);
-    if (block->is_full()) {
-        g_malloc_stats.number_of_blocks_full++;
-        dbgln_if(MALLOC_DEBUG, "Block {:p} is now full in size class {}", block, good_size);
-        allocator->usable_blocks.remove(*block);
-        allocator->full_blocks.append(*block);
-    }
-    dbgln_if(MALLOC_DEBUG, "LibC: allocated {:p} (chunk in block {:p}, size {})", ptr, block, block->bytes_per_chunk());
+    auto* ptr = TRY(allocate_chunk(*allocator, good_size, align));
 
     if (s_scrub_malloc && caller_will_initialize_memory == CallerWillInitializeMemory::No)
-        memset(ptr, MALLOC_SCRUB_BYTE, block->m_size);
+        memset(ptr, MALLOC_SCRUB_BYTE, good_size);
 
     ue_notify_malloc(ptr, size);
     return ptr;
@@ -459,6 +669,34 @@ static void free_impl(void* ptr)
     void* block_base = (void*)((FlatPtr)ptr & ChunkedBlock::ChunkedBlock::block_mask);
     size_t magic = *(size_t*)block_base;
 
+    if (magic == MAGIC_PAGE_HEADER && chunk_is_marked_as_free(ptr)) {
+        dbgln("LibC: double free of {:p}", ptr);
+        VERIFY_NOT_REACHED();
+    }
+
+#ifdef MALLOC_THREAD_CACHE
+    if (magic == MAGIC_PAGE_HEADER && s_thread_cache_enabled) {
+        auto* block = (ChunkedBlock*)block_base;
+        size_t good_size;
+        auto* allocator = allocator_for_size(block->m_size, good_size);
+        auto& bin = s_thread_cache.bins[allocator - allocators()];
+
+        if (s_scrub_free)
+            memset(ptr, FREE_SCRUB_BYTE, block->bytes_per_chunk());
+
+        if (bin.chunk_count >= thread_cache_capacity(good_size))
+            flush_thread_cache_bin(bin, thread_cache_batch_size(good_size));
+
+        s_thread_cache.number_of_frees++;
+        auto* entry = (FreelistEntry*)ptr;
+        entry->next = bin.chunks;
+        bin.chunks = entry;
+        ++bin.chunk_count;
+        mark_chunk_as_free(ptr);
+        return;
+    }
+#endif
+
     PthreadMutexLocker locker(s_malloc_mutex);
 
     if (magic == MAGIC_BIGALLOC_HEADER) {
@@ -489,51 +727,10 @@ static void free_impl(void* ptr)
     assert(magic == MAGIC_PAGE_HEADER);
     auto* block = (ChunkedBlock*)block_base;
 
-    dbgln_if(MALLOC_DEBUG, "LibC: freeing {:p} in allocator {:p} (size={}, used={})", ptr, block, block->bytes_per_chunk(), block->used_chunks());
-
     if (s_scrub_free)
         memset(ptr, FREE_SCRUB_BYTE, block->bytes_per_chunk());
 
-    auto* entry = (FreelistEntry*)ptr;
-    entry->next = block->m_freelist;
-    block->m_freelist = entry;
-
-    if (block->is_full()) {
-        size_t good_size;
-        auto* allocator = allocator_for_size(block->m_size, good_size);
-        dbgln_if(MALLOC_DEBUG, "Block {:p} no longer full in size class {}", block, good_size);
-        g_malloc_stats.number_of_freed_full_blocks++;
-        allocator->full_blocks.remove(*block);
-        allocator->usable_blocks.prepend(*block);
-    }
-
-    ++block->m_free_chunks;
-
-    if (!block->used_chunks()) {
-        size_t good_size;
-        auto* allocator = allocator_for_size(block->m_size, good_size);
-        if (s_hot_empty_block_count < number_of_hot_chunked_blocks_to_keep_around) {
-            dbgln_if(MALLOC_DEBUG, "Keeping hot block {:p} around", block);
-            g_malloc_stats.number_of_hot_keeps++;
-            allocator->usable_blocks.remove(*block);
-            s_hot_empty_blocks[s_hot_empty_block_count++] = block;
-            return;
-        }
-        if (s_cold_empty_block_count < number_of_cold_chunked_blocks_to_keep_around) {
-            dbgln_if(MALLOC_DEBUG, "Keeping cold block {:p} around", block);
-            g_malloc_stats.number_of_cold_keeps++;
-            allocator->usable_blocks.remove(*block);
-            s_cold_empty_blocks[s_cold_empty_block_count++] = block;
-            mprotect(block, ChunkedBlock::block_size, PROT_NONE);
-            madvise(block, ChunkedBlock::block_size, MADV_SET_VOLATILE);
-            return;
-        }
-        dbgln_if(MALLOC_DEBUG, "Releasing block {:p} for size class {}", block, good_size);
-        g_malloc_stats.number_of_frees++;
-        allocator->usable_blocks.remove(*block);
-        --allocator->block_count;
-        os_free(block, ChunkedBlock::block_size);
-    }
+    free_chunk(block, ptr);
 }
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/malloc.html
@@ -674,6 +871,13 @@ void __malloc_init()
     if (secure_getenv("LIBC_PROFILE_MALLOC"))
         s_profiling = true;
 
+    syscall(SC_getrandom, &s_freed_chunk_secret, sizeof(s_freed_chunk_secret), 0);
+#ifdef MALLOC_THREAD_CACHE
+    // The thread caches would hide the lifetime of cached chunks from UserspaceEmulator's heap auditing.
+    if (s_in_userspace_emulator || secure_getenv("LIBC_NO_MALLOC_THREAD_CACHE"))
+        s_thread_cache_enabled = false;
+#endif
+
     for (size_t i = 0; i < num_size_classes; ++i) {
         new (&allocators()[i]) Allocator();
         allocators()[i].size = size_classes[i];
@@ -682,8 +886,27 @@ void __malloc_init()
     new (&big_allocators()[0])(BigAllocator);
 }
 
+void __malloc_thread_exit()
+{
+#ifdef MALLOC_THREAD_CACHE
+    for (auto& bin : s_thread_cache.bins) {
+        if (bin.chunks)
+            flush_thread_cache_bin(bin, bin.chunk_count);
+    }
+    PthreadMutexLocker locker(s_malloc_mutex);
+    flush_thread_cache_stats();
+#endif
+}
+
 void serenity_dump_malloc_stats()
 {
+#ifdef MALLOC_THREAD_CACHE
+    {
+        // Other threads' counters only show up once they refill, flush or exit.
+        PthreadMutexLocker locker(s_malloc_mutex);
+        flush_thread_cache_stats();
+    }
+#endif
     dbgln("# malloc() calls: {}", g_malloc_stats.number_of_malloc_calls);
     dbgln();
     dbgln("big alloc hits: {}", g_malloc_stats.number_of_big_allocator_hits);
@@ -705,5 +928,11 @@ void serenity_dump_malloc_stats()
     dbgln("number of hot keeps: {}", g_malloc_stats.number_of_hot_keeps);
     dbgln("number of cold keeps: {}", g_malloc_stats.number_of_cold_keeps);
     dbgln("number of frees: {}", g_malloc_stats.number_of_frees);
+    dbgln();
+    dbgln("thread cache hits: {}", g_malloc_stats.number_of_thread_cache_hits);
+    dbgln("thread cache misses: {}", g_malloc_stats.number_of_thread_cache_misses);
+    dbgln("thread cache refills: {}", g_malloc_stats.number_of_thread_cache_refills);
+    dbgln("thread cache frees: {}", g_malloc_stats.number_of_thread_cache_frees);
+    dbgln("thread cache flushes: {}", g_malloc_stats.number_of_thread_cache_flushes);
 }
 }
@@ -152,6 +152,25 @@ int emuctl(uintptr_t command, uintptr_t arg0, uintptr_t arg1)
     return syscall(SC_emuctl, command, arg0, arg1);
 }
 
+int event_queue_create(int options)
+{
+    int rc = syscall(SC_event_queue_create, options);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
+int event_queue_control(int queue_fd, int operation, int fd, unsigned events)
+{
+    int rc = syscall(SC_event_queue_control, queue_fd, operation, fd, events);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
+int event_queue_wait(int queue_fd, struct pollfd* events, unsigned max_events, const struct timespec* timeout)
+{
+    Syscall::SC_event_queue_wait_params params { queue_fd, events, max_events, timeout };
+    int rc = syscall(SC_event_queue_wait, &params);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
 int serenity_open(char const* path, size_t path_length, int options, ...)
 {
     if (!path) {
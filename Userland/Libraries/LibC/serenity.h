@@ -72,4 +72,14 @@ int emuctl(uintptr_t command, uintptr_t arg0, uintptr_t arg1);
 
 int serenity_open(char const* path, size_t path_length, int options, ...);
 
+struct pollfd;
+
+// A persistent set of file descriptors to wait on. event_queue_wait() fills in up to max_events entries for the ones
+// that are ready, with the same flags as poll(), and returns how many it filled in. Readiness is level-triggered unless
+// EVENT_QUEUE_EDGE_TRIGGERED or EVENT_QUEUE_ONE_SHOT is passed along with the events. Closing the last fd referring to
+// a file removes it from every event queue watching it.
+int event_queue_create(int options);
+int event_queue_control(int queue_fd, int operation, int fd, unsigned events);
+int event_queue_wait(int queue_fd, struct pollfd* events, unsigned max_events, const struct timespec* timeout);
+
 __END_DECLS
@@ -0,0 +1,22 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <bits/pthread_cancel.h>
+#include <errno.h>
+#include <sys/sendfile.h>
+#include <syscall.h>
+
+extern "C" {
+
+// https://man7.org/linux/man-pages/man2/sendfile.2.html
+ssize_t sendfile(int out_fd, int in_fd, off_t* offset, size_t count)
+{
+    __pthread_maybe_cancel();
+
+    int rc = syscall(SC_sendfile, out_fd, in_fd, offset, count);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+}
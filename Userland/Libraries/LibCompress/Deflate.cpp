@@ -10,10 +10,13 @@
 #include <AK/BinaryHeap.h>
 #include <AK/BinarySearch.h>
 #include <AK/BitStream.h>
+#include <AK/BuiltinWrappers.h>
 #include <AK/MemoryStream.h>
 #include <string.h>
+#include <unistd.h>
 
 #include <LibCompress/Deflate.h>
+#include <LibThreading/Thread.h>
 
 namespace Compress {
 
@@ -146,7 +149,18 @@ ErrorOr<CanonicalCode> CanonicalCode::from_bytes(ReadonlyBytes bytes)
 
 ErrorOr<u32> CanonicalCode::read_symbol(LittleEndianInputBitStream& stream) const
 {
-    auto prefix = TRY(stream.peek_bits<size_t>(m_max_prefixed_code_length));
+    auto prefix_or_error = stream.peek_bits<size_t>(m_max_prefixed_code_length);
+    if (prefix_or_error.is_error()) {
+        // The stream may end with a code that is shorter than the longest prefix, so try to find it one bit at a time
+        size_t prefix = 0;
+        for (size_t length = 1; length <= m_max_prefixed_code_length; ++length) {
+            prefix |= TRY(stream.read_bits<size_t>(1)) << (length - 1);
+            if (auto [symbol_value, code_length] = m_prefix_table[prefix]; code_length == length)
+                return symbol_value;
+        }
+        return prefix_or_error.release_error();
+    }
+    auto prefix = prefix_or_error.release_value();
 
     if (auto [symbol_value, code_length] = m_prefix_table[prefix]; code_length != 0) {
         stream.discard_previously_peeked_bits(code_length);
@@ -562,8 +576,21 @@ size_t DeflateCompressor::compare_match_candidate(size_t start, size_t candidate
             return 0;
     }
 
-    // Find the actual length
+    // Find the actual length, comparing a word at a time for as long as possible
     auto match_length = previous_match_length + 1;
+    while (match_length + sizeof(u64) <= maximum_match_length) {
+        u64 start_word;
+        u64 candidate_word;
+        __builtin_memcpy(&start_word, &m_rolling_window[start + match_length], sizeof(u64));
+        __builtin_memcpy(&candidate_word, &m_rolling_window[candidate + match_length], sizeof(u64));
+        if (auto difference = start_word ^ candidate_word; difference != 0) {
+            // The first mismatching byte is the lowest differing one, as we only run on little-endian machines.
+            match_length += count_trailing_zeroes(difference) / 8;
+            VERIFY(match_length <= maximum_match_length);
+            return match_length;
+        }
+        match_length += sizeof(u64);
+    }
     while (match_length < maximum_match_length && m_rolling_window[start + match_length] == m_rolling_window[candidate + match_length]) {
         match_length++;
     }
@@ -592,7 +619,7 @@ size_t DeflateCompressor::find_back_match(size_t start, u16 hash, size_t previou
             break; // no remaining candidates
 
         VERIFY(candidate < start);
-        if (start - candidate > window_size)
+        if (start - candidate > max_distance)
             break; // outside the window
 
         auto match_length = compare_match_candidate(start, candidate, previous_match_length, maximum_match_length);
@@ -692,9 +719,9 @@ void DeflateCompressor::generate_huffman_lengths(Array<u8, Size>& lengths, Array
 
 void DeflateCompressor::lz77_compress_block()
 {
-    for (auto& slot : m_hash_head) { // initialize chained hash table
-        slot = empty_slot;
-    }
+    // initialize chained hash table
+    __builtin_memset(m_hash_head, 0xff, sizeof(m_hash_head));
+    static_assert(empty_slot == 0xffff);
 
     auto insert_hash = [&](auto pos, auto hash) {
         auto window_pos = pos % window_size;
@@ -702,6 +729,13 @@ void DeflateCompressor::lz77_compress_block()
         m_hash_head[hash] = window_pos;
     };
 
+    // our block starts at block_size and is m_pending_block_size in length
+    auto block_end = block_size + m_pending_block_size;
+
+    // Prime the hash chains with the previously seen data, so that matches can reach back into it
+    for (size_t position = block_size - m_dictionary_size; position < block_size && position + min_match_length <= block_end; position++)
+        insert_hash(position, hash_sequence(&m_rolling_window[position]));
+
     auto emit_literal = [&](auto literal) {
         VERIFY(m_pending_symbol_size <= block_size + 1);
         auto index = m_pending_symbol_size++;
@@ -724,8 +758,6 @@ void DeflateCompressor::lz77_compress_block()
 
     VERIFY(m_compression_constants.great_match_length <= max_match_length);
 
-    // our block starts at block_size and is m_pending_block_size in length
-    auto block_end = block_size + m_pending_block_size;
     size_t current_position;
     for (current_position = block_size; current_position < block_end - min_match_length + 1; current_position++) {
         auto hash = hash_sequence(&m_rolling_window[current_position]);
@@ -1037,17 +1069,29 @@ ErrorOr<void> DeflateCompressor::flush()
     if (m_finished)
         TRY(m_output_stream->align_to_byte_boundary());
 
+    // keep the block around as the dictionary of the next one
+    auto compressed_block = pending_block().trim(m_pending_block_size);
+    compressed_block.copy_to({ m_rolling_window + block_size - compressed_block.size(), compressed_block.size() });
+    m_dictionary_size = compressed_block.size();
+
     // reset all block specific members
     m_pending_block_size = 0;
     m_pending_symbol_size = 0;
     m_symbol_frequencies.fill(0);
     m_distance_frequencies.fill(0);
-    // On the final block this copy will potentially produce an invalid search window, but since its the final block we dont care
-    pending_block().copy_trimmed_to({ m_rolling_window, block_size });
 
     return {};
 }
 
+void DeflateCompressor::set_dictionary(ReadonlyBytes dictionary)
+{
+    VERIFY(m_pending_block_size == 0);
+    if (dictionary.size() > block_size)
+        dictionary = dictionary.slice(dictionary.size() - block_size);
+    dictionary.copy_to({ m_rolling_window + block_size - dictionary.size(), dictionary.size() });
+    m_dictionary_size = dictionary.size();
+}
+
 ErrorOr<void> DeflateCompressor::final_flush()
 {
     VERIFY(!m_finished);
@@ -1057,6 +1101,21 @@ ErrorOr<void> DeflateCompressor::final_flush()
     return {};
 }
 
+ErrorOr<void> DeflateCompressor::sync_flush()
+{
+    VERIFY(!m_finished);
+    if (m_pending_block_size != 0)
+        TRY(flush());
+
+    TRY(m_output_stream->write_bits(0b0u, 1));  // not the final block
+    TRY(m_output_stream->write_bits(0b00u, 2)); // no compression
+    TRY(m_output_stream->align_to_byte_boundary());
+    TRY(m_output_stream->write_value<LittleEndian<u16>>(0));
+    TRY(m_output_stream->write_value<LittleEndian<u16>>(0xffff));
+    TRY(m_output_stream->flush_buffer_to_stream());
+    return {};
+}
+
 ErrorOr<ByteBuffer> DeflateCompressor::compress_all(ReadonlyBytes bytes, CompressionLevel compression_level)
 {
     auto output_stream = TRY(try_make<AllocatingMemoryStream>());
@@ -1071,4 +1130,88 @@ ErrorOr<ByteBuffer> DeflateCompressor::compress_all(ReadonlyBytes bytes, Compres
     return buffer;
 }
 
+ErrorOr<ByteBuffer> DeflateCompressor::compress_chunk(ReadonlyBytes bytes, size_t chunk_index, CompressionLevel compression_level)
+{
+    auto chunk_start = chunk_index * parallel_chunk_size;
+    auto chunk = bytes.slice(chunk_start, min(parallel_chunk_size, bytes.size() - chunk_start));
+    auto is_last_chunk = chunk_start + chunk.size() == bytes.size();
+
+    auto output_stream = TRY(try_make<AllocatingMemoryStream>());
+    auto deflate_stream = TRY(DeflateCompressor::construct(MaybeOwned<Stream>(*output_stream), compression_level));
+
+    // The decompressor has already seen everything before this chunk, so back references into it are fine
+    deflate_stream->set_dictionary(bytes.trim(chunk_start));
+    TRY(deflate_stream->write_until_depleted(chunk));
+
+    if (is_last_chunk) {
+        TRY(deflate_stream->final_flush());
+    } else {
+        // Byte-align the output without ending the stream, so that the next chunk can just be appended to it
+        TRY(deflate_stream->sync_flush());
+        deflate_stream->m_finished = true;
+    }
+
+    auto buffer = TRY(ByteBuffer::create_uninitialized(output_stream->used_buffer_size()));
+    TRY(output_stream->read_until_filled(buffer));
+
+    return buffer;
+}
+
+ErrorOr<ByteBuffer> DeflateCompressor::compress_all_parallel(ReadonlyBytes bytes, CompressionLevel compression_level, size_t thread_count)
+{
+    if (thread_count == 0)
+        thread_count = max(sysconf(_SC_NPROCESSORS_ONLN), 1);
+
+    auto chunk_count = ceil_div(bytes.size(), parallel_chunk_size);
+    thread_count = min(thread_count, chunk_count);
+    if (thread_count <= 1)
+        return compress_all(bytes, compression_level);
+
+    Vector<ByteBuffer> compressed_chunks;
+    Vector<Optional<Error>> chunk_errors;
+    TRY(compressed_chunks.try_resize(chunk_count));
+    TRY(chunk_errors.try_resize(chunk_count));
+
+    // Every thread picks up the next chunk nobody is working on yet, and stores its result in the chunk's own slot
+    Atomic<size_t> next_chunk_index { 0 };
+    auto compress_chunks = [&]() -> intptr_t {
+        for (auto chunk_index = next_chunk_index++; chunk_index < chunk_count; chunk_index = next_chunk_index++) {
+            auto compressed_chunk_or_error = compress_chunk(bytes, chunk_index, compression_level);
+            if (compressed_chunk_or_error.is_error())
+                chunk_errors[chunk_index] = compressed_chunk_or_error.release_error();
+            else
+                compressed_chunks[chunk_index] = compressed_chunk_or_error.release_value();
+        }
+        return 0;
+    };
+
+    // The calling thread does its share of the work too
+    Vector<NonnullRefPtr<Threading::Thread>> threads;
+    for (size_t i = 1; i < thread_count; i++) {
+        auto thread_or_error = Threading::Thread::try_create([&] { return compress_chunks(); }, "Deflate worker"sv);
+        if (thread_or_error.is_error() || threads.try_append(thread_or_error.value()).is_error())
+            break;
+        threads.last()->start();
+    }
+    compress_chunks();
+    for (auto& thread : threads)
+        (void)thread->join();
+
+    size_t compressed_size = 0;
+    for (size_t i = 0; i < chunk_count; i++) {
+        if (chunk_errors[i].has_value())
+            return chunk_errors[i].release_value();
+        compressed_size += compressed_chunks[i].size();
+    }
+
+    auto buffer = TRY(ByteBuffer::create_uninitialized(compressed_size));
+    size_t offset = 0;
+    for (auto const& compressed_chunk : compressed_chunks) {
+        compressed_chunk.bytes().copy_to(buffer.bytes().slice(offset));
+        offset += compressed_chunk.size();
+    }
+
+    return buffer;
+}
+
 }
@@ -127,8 +127,10 @@ public:
     static constexpr size_t hash_bits = 15;
     static constexpr size_t max_huffman_literals = 288;
     static constexpr size_t max_huffman_distances = 32;
-    static constexpr size_t min_match_length = 4;   // matches smaller than these are not worth the size of the back reference
-    static constexpr size_t max_match_length = 258; // matches longer than these cannot be encoded using huffman codes
+    static constexpr size_t min_match_length = 4;    // matches smaller than these are not worth the size of the back reference
+    static constexpr size_t max_match_length = 258;  // matches longer than these cannot be encoded using huffman codes
+    static constexpr size_t max_distance = 32 * KiB; // back references cannot reach further back than this
+    static constexpr size_t parallel_chunk_size = 128 * KiB;
     static constexpr u16 empty_slot = UINT16_MAX;
 
     struct CompressionConstants {
@@ -165,12 +167,22 @@ public:
     virtual void close() override;
     ErrorOr<void> final_flush();
 
+    // Ends the current block and pads the output to a byte boundary with an empty stored block, without ending the stream.
+    ErrorOr<void> sync_flush();
+
     static ErrorOr<ByteBuffer> compress_all(ReadonlyBytes bytes, CompressionLevel = CompressionLevel::GOOD);
 
+    // Splits the input into chunks of parallel_chunk_size bytes and compresses them on up to thread_count threads (0 means one per processor).
+    // Each chunk is primed with the data preceding it, so the result is a single stream that is nearly as small as the one from compress_all().
+    static ErrorOr<ByteBuffer> compress_all_parallel(ReadonlyBytes bytes, CompressionLevel = CompressionLevel::GOOD, size_t thread_count = 0);
+
 private:
     DeflateCompressor(NonnullOwnPtr<LittleEndianOutputBitStream>, CompressionLevel = CompressionLevel::GOOD);
 
     Bytes pending_block() { return { m_rolling_window + block_size, block_size }; }
+    void set_dictionary(ReadonlyBytes);
+
+    static ErrorOr<ByteBuffer> compress_chunk(ReadonlyBytes bytes, size_t chunk_index, CompressionLevel);
 
     // LZ77 Compression
     static u16 hash_sequence(u8 const* bytes);
@@ -204,6 +216,7 @@ private:
 
     u8 m_rolling_window[window_size];
     size_t m_pending_block_size { 0 };
+    size_t m_dictionary_size { 0 }; // number of valid bytes right before the pending block
 
     struct [[gnu::packed]] {
         u16 distance; // back reference length
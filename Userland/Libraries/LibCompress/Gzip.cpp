@@ -215,7 +215,7 @@ ErrorOr<Bytes> GzipCompressor::read_some(Bytes)
     return Error::from_errno(EBADF);
 }
 
-ErrorOr<size_t> GzipCompressor::write_some(ReadonlyBytes bytes)
+static ErrorOr<void> write_member_header(Stream& stream)
 {
     BlockHeader header;
     header.identification_1 = 0x1f;
@@ -225,14 +225,26 @@ ErrorOr<size_t> GzipCompressor::write_some(ReadonlyBytes bytes)
     header.modification_time = 0;
     header.extra_flags = 3;      // DEFLATE sets 2 for maximum compression and 4 for minimum compression
     header.operating_system = 3; // unix
-    TRY(m_output_stream->write_until_depleted({ &header, sizeof(header) }));
+    TRY(stream.write_until_depleted({ &header, sizeof(header) }));
+    return {};
+}
+
+static ErrorOr<void> write_member_trailer(Stream& stream, ReadonlyBytes uncompressed_bytes)
+{
+    Crypto::Checksum::CRC32 crc32;
+    crc32.update(uncompressed_bytes);
+    TRY(stream.write_value<LittleEndian<u32>>(crc32.digest()));
+    TRY(stream.write_value<LittleEndian<u32>>(uncompressed_bytes.size()));
+    return {};
+}
+
+ErrorOr<size_t> GzipCompressor::write_some(ReadonlyBytes bytes)
+{
+    TRY(write_member_header(*m_output_stream));
     auto compressed_stream = TRY(DeflateCompressor::construct(MaybeOwned(*m_output_stream)));
     TRY(compressed_stream->write_until_depleted(bytes));
     TRY(compressed_stream->final_flush());
-    Crypto::Checksum::CRC32 crc32;
-    crc32.update(bytes);
-    TRY(m_output_stream->write_value<LittleEndian<u32>>(crc32.digest()));
-    TRY(m_output_stream->write_value<LittleEndian<u32>>(bytes.size()));
+    TRY(write_member_trailer(*m_output_stream, bytes));
     return bytes.size();
 }
 
@@ -262,7 +274,21 @@ ErrorOr<ByteBuffer> GzipCompressor::compress_all(ReadonlyBytes bytes)
     return buffer;
 }
 
-ErrorOr<void> GzipCompressor::compress_file(StringView input_filename, NonnullOwnPtr<Stream> output_stream)
+ErrorOr<ByteBuffer> GzipCompressor::compress_all_parallel(ReadonlyBytes bytes, size_t thread_count)
+{
+    auto output_stream = TRY(try_make<AllocatingMemoryStream>());
+
+    TRY(write_member_header(*output_stream));
+    auto compressed_bytes = TRY(DeflateCompressor::compress_all_parallel(bytes, DeflateCompressor::CompressionLevel::GOOD, thread_count));
+    TRY(output_stream->write_until_depleted(compressed_bytes));
+    TRY(write_member_trailer(*output_stream, bytes));
+
+    auto buffer = TRY(ByteBuffer::create_uninitialized(output_stream->used_buffer_size()));
+    TRY(output_stream->read_until_filled(buffer.bytes()));
+    return buffer;
+}
+
+ErrorOr<void> GzipCompressor::compress_file(StringView input_filename, NonnullOwnPtr<Stream> output_stream, size_t thread_count)
 {
     // We map the whole file instead of streaming to reduce size overhead (gzip header) and increase the deflate block size (better compression)
     // TODO: automatically fallback to buffered streaming for very large files
@@ -274,7 +300,7 @@ ErrorOr<void> GzipCompressor::compress_file(StringView input_filename, NonnullOw
         input_bytes = file->bytes();
     }
 
-    auto output_bytes = TRY(Compress::GzipCompressor::compress_all(input_bytes));
+    auto output_bytes = TRY(Compress::GzipCompressor::compress_all_parallel(input_bytes, thread_count));
     TRY(output_stream->write_until_depleted(output_bytes));
 
     return {};
@@ -93,7 +93,8 @@ public:
     virtual void close() override;
 
     static ErrorOr<ByteBuffer> compress_all(ReadonlyBytes bytes);
-    static ErrorOr<void> compress_file(StringView input_file, NonnullOwnPtr<Stream> output_stream);
+    static ErrorOr<ByteBuffer> compress_all_parallel(ReadonlyBytes bytes, size_t thread_count = 0);
+    static ErrorOr<void> compress_file(StringView input_file, NonnullOwnPtr<Stream> output_stream, size_t thread_count = 0);
 
 private:
     MaybeOwned<Stream> m_output_stream;
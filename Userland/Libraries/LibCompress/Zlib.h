@@ -74,10 +74,11 @@ public:
     ErrorOr<void> finish();
 
     static ErrorOr<ByteBuffer> compress_all(ReadonlyBytes bytes, ZlibCompressionLevel = ZlibCompressionLevel::Default);
+    static ErrorOr<ByteBuffer> compress_all_parallel(ReadonlyBytes bytes, ZlibCompressionLevel = ZlibCompressionLevel::Default, size_t thread_count = 0);
 
 private:
     ZlibCompressor(MaybeOwned<Stream> stream, NonnullOwnPtr<Stream> compressor_stream);
-    ErrorOr<void> write_header(ZlibCompressionMethod, ZlibCompressionLevel);
+    static ErrorOr<void> write_header(Stream&, ZlibCompressionMethod, ZlibCompressionLevel);
 
     bool m_finished { false };
     MaybeOwned<Stream> m_output_stream;
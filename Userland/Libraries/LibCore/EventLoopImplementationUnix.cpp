@@ -5,6 +5,7 @@
  */
 
 #include <AK/IDAllocator.h>
+#include <AK/IntrusiveList.h>
 #include <AK/Singleton.h>
 #include <AK/TemporaryChange.h>
 #include <AK/Time.h>
@@ -19,6 +20,11 @@
 #include <sys/select.h>
 #include <unistd.h>
 
+#ifdef AK_OS_SERENITY
+#    include <poll.h>
+#    include <serenity.h>
+#endif
+
 namespace Core {
 
 struct ThreadData;
@@ -30,13 +36,132 @@ thread_local ThreadData* s_thread_data;
 struct EventLoopTimer {
     int timer_id { 0 };
     Duration interval;
+    Duration slack;
     MonotonicTime fire_time { MonotonicTime::now_coarse() };
     bool should_reload { false };
     TimerShouldFireWhenNotVisible fire_when_not_visible { TimerShouldFireWhenNotVisible::No };
     WeakPtr<EventReceiver> owner;
 
-    void reload(MonotonicTime const& now) { fire_time = now + interval; }
+    // Our position in the thread's TimerHeap, while we're waiting to fire.
+    Optional<size_t> heap_index;
+    // Expired timers whose owner isn't visible wait on this list until it is.
+    IntrusiveListNode<EventLoopTimer> suspended_list_node;
+
+    void reload(MonotonicTime const& now)
+    {
+        fire_time = now + interval;
+        // Round the fire time up to a multiple of our slack, so we fire together with other timers that allow for
+        // some lateness, instead of waking up the loop for each of them separately.
+        if (auto slack_ns = slack.to_nanoseconds(); slack_ns > 0) {
+            if (auto remainder = fire_time.nanoseconds() % slack_ns; remainder != 0)
+                fire_time += Duration::from_nanoseconds(slack_ns - remainder);
+        }
+    }
     bool has_expired(MonotonicTime const& now) const { return now > fire_time; }
+    bool is_waiting_for_owner_to_become_visible(RefPtr<EventReceiver> const& strong_owner) const
+    {
+        return fire_when_not_visible == TimerShouldFireWhenNotVisible::No
+            && strong_owner && !strong_owner->is_visible_for_timer_purposes();
+    }
+};
+
+// Timers with short intervals usually drive animations and have to be precise. Anything slower won't notice being late
+// by up to 1/16th of its interval, so we allow for that, rounded down to a power of two so that timers with different
+// slack still line up with each other.
+static Duration slack_for_timer_interval(Duration interval)
+{
+    auto max_slack_ms = min<i64>(interval.to_milliseconds() / 16, 64);
+    if (max_slack_ms <= 0)
+        return Duration::zero();
+    i64 slack_ms = 1;
+    while (slack_ms * 2 <= max_slack_ms)
+        slack_ms *= 2;
+    return Duration::from_milliseconds(slack_ms);
+}
+
+// A binary min-heap of timers ordered by fire time. Each timer knows its position in the heap, so it can be removed or
+// rescheduled in O(log n) without searching for it.
+class TimerHeap {
+public:
+    bool is_empty() const { return m_timers.is_empty(); }
+    EventLoopTimer& peek_min() { return *m_timers.first(); }
+
+    void insert(EventLoopTimer& timer)
+    {
+        VERIFY(!timer.heap_index.has_value());
+        m_timers.append(&timer);
+        timer.heap_index = m_timers.size() - 1;
+        sift_up(m_timers.size() - 1);
+    }
+
+    void remove(EventLoopTimer& timer)
+    {
+        auto index = timer.heap_index.release_value();
+        auto* last = m_timers.take_last();
+        if (index == m_timers.size())
+            return;
+        place(index, *last);
+        reschedule_at(index);
+    }
+
+    // Restores the heap order after the timer's fire time has changed.
+    void reschedule(EventLoopTimer& timer) { reschedule_at(timer.heap_index.value()); }
+
+    void clear()
+    {
+        for (auto* timer : m_timers)
+            timer->heap_index.clear();
+        m_timers.clear();
+    }
+
+private:
+    void place(size_t index, EventLoopTimer& timer)
+    {
+        m_timers[index] = &timer;
+        timer.heap_index = index;
+    }
+
+    void reschedule_at(size_t index)
+    {
+        if (index > 0 && m_timers[index]->fire_time < m_timers[(index - 1) / 2]->fire_time)
+            sift_up(index);
+        else
+            sift_down(index);
+    }
+
+    void sift_up(size_t index)
+    {
+        auto& timer = *m_timers[index];
+        while (index > 0) {
+            auto parent_index = (index - 1) / 2;
+            auto& parent = *m_timers[parent_index];
+            if (parent.fire_time <= timer.fire_time)
+                break;
+            place(index, parent);
+            index = parent_index;
+        }
+        place(index, timer);
+    }
+
+    void sift_down(size_t index)
+    {
+        auto& timer = *m_timers[index];
+        for (;;) {
+            auto child_index = index * 2 + 1;
+            if (child_index >= m_timers.size())
+                break;
+            if (child_index + 1 < m_timers.size() && m_timers[child_index + 1]->fire_time < m_timers[child_index]->fire_time)
+                ++child_index;
+            auto& child = *m_timers[child_index];
+            if (timer.fire_time <= child.fire_time)
+                break;
+            place(index, child);
+            index = child_index;
+        }
+        place(index, timer);
+    }
+
+    Vector<EventLoopTimer*> m_timers;
 };
 
 struct ThreadData {
@@ -53,6 +178,9 @@ struct ThreadData {
     {
         pid = getpid();
         initialize_wake_pipe();
+#ifdef AK_OS_SERENITY
+        initialize_event_queue();
+#endif
     }
 
     void initialize_wake_pipe()
@@ -73,9 +201,139 @@ struct ThreadData {
         VERIFY(rc == 0);
     }
 
+#ifdef AK_OS_SERENITY
+    // Instead of passing every notifier's fd to select() each time we wait, we keep them registered with a kernel event
+    // queue, which only tells us about the ones that are ready.
+    void initialize_event_queue()
+    {
+        // NOTE: After a fork, we'd still share the parent's event queue.
+        if (event_queue_fd != -1)
+            close(event_queue_fd);
+        notifiers_by_fd.clear();
+
+        event_queue_fd = MUST(System::event_queue_create(O_CLOEXEC));
+        MUST(System::event_queue_control(event_queue_fd, EVENT_QUEUE_ADD, wake_pipe_fds[0], POLLIN));
+    }
+
+    static short poll_events_for(Notifier::Type type)
+    {
+        switch (type) {
+        case Notifier::Type::None:
+            return 0;
+        case Notifier::Type::Read:
+            return POLLIN;
+        case Notifier::Type::Write:
+            return POLLOUT;
+        case Notifier::Type::Exceptional:
+            return POLLPRI;
+        }
+        VERIFY_NOT_REACHED();
+    }
+
+    static bool is_activated_by(Notifier const& notifier, short revents)
+    {
+        // Mirror select(), which reports errors and hang-ups as the fd being readable or writable.
+        switch (notifier.type()) {
+        case Notifier::Type::None:
+            return false;
+        case Notifier::Type::Read:
+            return revents & (POLLIN | POLLHUP | POLLERR);
+        case Notifier::Type::Write:
+            return revents & (POLLOUT | POLLERR);
+        case Notifier::Type::Exceptional:
+            return revents & POLLPRI;
+        }
+        VERIFY_NOT_REACHED();
+    }
+
+    // Several notifiers can watch the same fd (e.g. one for reading and one for writing), but the event queue only
+    // takes each fd once, so it gets told about all of them at the same time.
+    void update_event_queue(int fd, int operation)
+    {
+        short events = 0;
+        if (auto it = notifiers_by_fd.find(fd); it != notifiers_by_fd.end()) {
+            for (auto* notifier : it->value)
+                events |= poll_events_for(notifier->type());
+        }
+        auto result = System::event_queue_control(event_queue_fd, operation, fd, events);
+        // The event queue drops fds on its own once they've been closed, even if a notifier still refers to them.
+        if (result.is_error() && result.error().code() == ENOENT && operation == EVENT_QUEUE_MODIFY)
+            result = System::event_queue_control(event_queue_fd, EVENT_QUEUE_ADD, fd, events);
+        MUST(result);
+    }
+
+    void add_to_event_queue(Notifier& notifier)
+    {
+        auto& fd_notifiers = notifiers_by_fd.ensure(notifier.fd());
+        if (fd_notifiers.contains_slow(&notifier))
+            return;
+        bool is_new_fd = fd_notifiers.is_empty();
+        fd_notifiers.append(&notifier);
+        update_event_queue(notifier.fd(), is_new_fd ? EVENT_QUEUE_ADD : EVENT_QUEUE_MODIFY);
+    }
+
+    void remove_from_event_queue(Notifier& notifier)
+    {
+        auto it = notifiers_by_fd.find(notifier.fd());
+        if (it == notifiers_by_fd.end() || !it->value.remove_first_matching([&](auto* other) { return other == &notifier; }))
+            return;
+        if (!it->value.is_empty()) {
+            update_event_queue(notifier.fd(), EVENT_QUEUE_MODIFY);
+            return;
+        }
+        notifiers_by_fd.remove(it);
+        if (auto result = System::event_queue_control(event_queue_fd, EVENT_QUEUE_REMOVE, notifier.fd(), 0); result.is_error() && result.error().code() != ENOENT)
+            MUST(result);
+    }
+#endif
+
+    void forget_timer(EventLoopTimer& timer)
+    {
+        if (timer.heap_index.has_value())
+            timer_heap.remove(timer);
+        if (timer.suspended_list_node.is_in_list())
+            suspended_timers.remove(timer);
+    }
+
+    void clear_timers()
+    {
+        timer_heap.clear();
+        suspended_timers.clear();
+        timers.clear();
+    }
+
+    // Puts the suspended timers whose owner has become visible back into the heap. They've already expired, so they'll
+    // be the next ones to fire. Nothing can have become visible unless the visibility generation changed.
+    void resume_timers_of_visible_owners()
+    {
+        if (suspended_timers.is_empty())
+            return;
+        auto generation = EventReceiver::timer_visibility_generation();
+        if (generation == last_seen_timer_visibility_generation)
+            return;
+        last_seen_timer_visibility_generation = generation;
+
+        IntrusiveList<&EventLoopTimer::suspended_list_node> still_suspended;
+        while (auto* timer = suspended_timers.take_first()) {
+            if (timer->is_waiting_for_owner_to_become_visible(timer->owner.strong_ref()))
+                still_suspended.append(*timer);
+            else
+                timer_heap.insert(*timer);
+        }
+        while (auto* timer = still_suspended.take_first())
+            suspended_timers.append(*timer);
+    }
+
     // Each thread has its own timers, notifiers and a wake pipe.
     HashMap<int, NonnullOwnPtr<EventLoopTimer>> timers;
+    TimerHeap timer_heap;
+    IntrusiveList<&EventLoopTimer::suspended_list_node> suspended_timers;
+    u64 last_seen_timer_visibility_generation { 0 };
     HashTable<Notifier*> notifiers;
+#ifdef AK_OS_SERENITY
+    HashMap<int, Vector<Notifier*, 1>> notifiers_by_fd;
+    int event_queue_fd { -1 };
+#endif
 
     // The wake pipe is used to notify another event loop that someone has called wake(), or a signal has been received.
     // wake() writes 0i32 into the pipe, signals write the signal number (guaranteed non-zero).
@@ -143,9 +401,12 @@ void EventLoopManagerUnix::wait_for_events(EventLoopImplementation::PumpMode mod
 {
     auto& thread_data = ThreadData::the();
 
+#ifndef AK_OS_SERENITY
     fd_set read_fds {};
     fd_set write_fds {};
+#endif
 retry:
+#ifndef AK_OS_SERENITY
     int max_fd = 0;
     auto add_fd_to_set = [&max_fd](int fd, fd_set& set) {
         FD_SET(fd, &set);
@@ -164,12 +425,13 @@ retry:
         if (notifier->type() == Notifier::Type::Exceptional)
             TODO();
     }
+#endif
 
     bool has_pending_events = ThreadEventQueue::current().has_pending_events();
 
     // Figure out how long to wait at maximum.
     // This mainly depends on the PumpMode and whether we have pending events, but also the next expiring timer.
-    struct timeval timeout = { 0, 0 };
+    auto timeout = Duration::zero();
     bool should_wait_forever = false;
     if (mode == EventLoopImplementation::PumpMode::WaitForEvents && !has_pending_events) {
         auto next_timer_expiration = get_next_timer_expiration();
@@ -178,15 +440,40 @@ retry:
             auto computed_timeout = next_timer_expiration.value() - now;
             if (computed_timeout.is_negative())
                 computed_timeout = Duration::zero();
-            timeout = computed_timeout.to_timeval();
+            timeout = computed_timeout;
         } else {
             should_wait_forever = true;
         }
     }
 
+#ifdef AK_OS_SERENITY
+    Array<pollfd, 64> ready_fds;
+    int marked_fd_count = 0;
+    auto timeout_spec = timeout.to_timespec();
+    for (;;) {
+        // Wait for file system events, calls to wake(), POSIX signals, or timer expirations.
+        auto result = System::event_queue_wait(thread_data.event_queue_fd, ready_fds, should_wait_forever ? nullptr : &timeout_spec);
+        if (!result.is_error()) {
+            marked_fd_count = result.value();
+            break;
+        }
+        // Because POSIX, we might spuriously return with EINTR; just wait again.
+        if (result.error().code() == EINTR)
+            continue;
+        dbgln("EventLoopImplementationUnix::wait_for_events: {}", result.error());
+        VERIFY_NOT_REACHED();
+    }
+
+    bool wake_pipe_is_readable = false;
+    for (int i = 0; i < marked_fd_count; ++i) {
+        if (ready_fds[i].fd == thread_data.wake_pipe_fds[0])
+            wake_pipe_is_readable = true;
+    }
+#else
+    auto timeout_value = timeout.to_timeval();
 try_select_again:
     // select() and wait for file system events, calls to wake(), POSIX signals, or timer expirations.
-    int marked_fd_count = select(max_fd + 1, &read_fds, &write_fds, nullptr, should_wait_forever ? nullptr : &timeout);
+    int marked_fd_count = select(max_fd + 1, &read_fds, &write_fds, nullptr, should_wait_forever ? nullptr : &timeout_value);
     // Because POSIX, we might spuriously return from select() with EINTR; just select again.
     if (marked_fd_count < 0) {
         int saved_errno = errno;
@@ -196,9 +483,12 @@ try_select_again:
         VERIFY_NOT_REACHED();
     }
 
+    bool wake_pipe_is_readable = FD_ISSET(thread_data.wake_pipe_fds[0], &read_fds);
+#endif
+
     // We woke up due to a call to wake() or a POSIX signal.
     // Handle signals and see whether we need to handle events as well.
-    if (FD_ISSET(thread_data.wake_pipe_fds[0], &read_fds)) {
+    if (wake_pipe_is_readable) {
         int wake_events[8];
         ssize_t nread;
         // We might receive another signal while read()ing here. The signal will go to the handle_signal properly,
@@ -230,14 +520,17 @@ try_select_again:
     // Handle expired timers.
     if (!thread_data.timers.is_empty()) {
         auto now = MonotonicTime::now_coarse();
+        thread_data.resume_timers_of_visible_owners();
 
-        for (auto& it : thread_data.timers) {
-            auto& timer = *it.value;
+        auto& timer_heap = thread_data.timer_heap;
+        while (!timer_heap.is_empty()) {
+            auto& timer = timer_heap.peek_min();
             if (!timer.has_expired(now))
-                continue;
+                break;
             auto owner = timer.owner.strong_ref();
-            if (timer.fire_when_not_visible == TimerShouldFireWhenNotVisible::No
-                && owner && !owner->is_visible_for_timer_purposes()) {
+            if (timer.is_waiting_for_owner_to_become_visible(owner)) {
+                timer_heap.remove(timer);
+                thread_data.suspended_timers.append(timer);
                 continue;
             }
 
@@ -245,9 +538,10 @@ try_select_again:
                 ThreadEventQueue::current().post_event(*owner, make<TimerEvent>(timer.timer_id));
             if (timer.should_reload) {
                 timer.reload(now);
+                timer_heap.reschedule(timer);
             } else {
-                // FIXME: Support removing expired timers that don't want to reload.
-                VERIFY_NOT_REACHED();
+                // The timer stays registered until its owner unregisters it, but it won't fire again.
+                timer_heap.remove(timer);
             }
         }
     }
@@ -256,6 +550,17 @@ try_select_again:
         return;
 
     // Handle file system notifiers by making them normal events.
+#ifdef AK_OS_SERENITY
+    for (int i = 0; i < marked_fd_count; ++i) {
+        auto it = thread_data.notifiers_by_fd.find(ready_fds[i].fd);
+        if (it == thread_data.notifiers_by_fd.end())
+            continue;
+        for (auto* notifier : it->value) {
+            if (ThreadData::is_activated_by(*notifier, ready_fds[i].revents))
+                ThreadEventQueue::current().post_event(*notifier, make<NotifierActivationEvent>(notifier->fd()));
+        }
+    }
+#else
     for (auto& notifier : thread_data.notifiers) {
         if (notifier->type() == Notifier::Type::Read && FD_ISSET(notifier->fd(), &read_fds)) {
             ThreadEventQueue::current().post_event(*notifier, make<NotifierActivationEvent>(notifier->fd()));
@@ -264,6 +569,7 @@ try_select_again:
             ThreadEventQueue::current().post_event(*notifier, make<NotifierActivationEvent>(notifier->fd()));
         }
     }
+#endif
 }
 
 class SignalHandlers : public RefCounted<SignalHandlers> {
@@ -336,9 +642,12 @@ void EventLoopManagerUnix::dispatch_signal(int signal_number)
 void EventLoopImplementationUnix::notify_forked_and_in_child()
 {
     auto& thread_data = ThreadData::the();
-    thread_data.timers.clear();
+    thread_data.clear_timers();
     thread_data.notifiers.clear();
     thread_data.initialize_wake_pipe();
+#ifdef AK_OS_SERENITY
+    thread_data.initialize_event_queue();
+#endif
     if (auto* info = signals_info<false>()) {
         info->signal_handlers.clear();
         info->next_signal_id = 0;
@@ -348,23 +657,12 @@ void EventLoopImplementationUnix::notify_forked_and_in_child()
 
 Optional<MonotonicTime> EventLoopManagerUnix::get_next_timer_expiration()
 {
-    auto now = MonotonicTime::now_coarse();
-    Optional<MonotonicTime> soonest {};
-    for (auto& it : ThreadData::the().timers) {
-        auto& fire_time = it.value->fire_time;
-        auto owner = it.value->owner.strong_ref();
-        if (it.value->fire_when_not_visible == TimerShouldFireWhenNotVisible::No
-            && owner && !owner->is_visible_for_timer_purposes()) {
-            continue;
-        }
-        // OPTIMIZATION: If we have a timer that needs to fire right away, we can stop looking here.
-        // FIXME: This whole operation could be O(1) with a better data structure.
-        if (fire_time < now)
-            return now;
-        if (!soonest.has_value() || fire_time < soonest.value())
-            soonest = fire_time;
-    }
-    return soonest;
+    auto& thread_data = ThreadData::the();
+    thread_data.resume_timers_of_visible_owners();
+    if (thread_data.timer_heap.is_empty())
+        return {};
+    // NOTE: If the owner of this timer isn't visible, we'll wake up for nothing once and suspend the timer then.
+    return thread_data.timer_heap.peek_min().fire_time;
 }
 
 SignalHandlers::SignalHandlers(int signal_number, void (*handle_signal)(int))
@@ -487,11 +785,13 @@ int EventLoopManagerUnix::register_timer(EventReceiver& object, int milliseconds
     auto timer = make<EventLoopTimer>();
     timer->owner = object;
     timer->interval = Duration::from_milliseconds(milliseconds);
+    timer->slack = slack_for_timer_interval(timer->interval);
     timer->reload(MonotonicTime::now_coarse());
     timer->should_reload = should_reload;
     timer->fire_when_not_visible = fire_when_not_visible;
     int timer_id = thread_data.id_allocator.allocate();
     timer->timer_id = timer_id;
+    thread_data.timer_heap.insert(*timer);
     thread_data.timers.set(timer_id, move(timer));
     return timer_id;
 }
@@ -500,17 +800,29 @@ bool EventLoopManagerUnix::unregister_timer(int timer_id)
 {
     auto& thread_data = ThreadData::the();
     thread_data.id_allocator.deallocate(timer_id);
-    return thread_data.timers.remove(timer_id);
+    auto timer = thread_data.timers.take(timer_id);
+    if (!timer.has_value())
+        return false;
+    thread_data.forget_timer(*timer.value());
+    return true;
 }
 
 void EventLoopManagerUnix::register_notifier(Notifier& notifier)
 {
-    ThreadData::the().notifiers.set(&notifier);
+    auto& thread_data = ThreadData::the();
+    thread_data.notifiers.set(&notifier);
+#ifdef AK_OS_SERENITY
+    thread_data.add_to_event_queue(notifier);
+#endif
 }
 
 void EventLoopManagerUnix::unregister_notifier(Notifier& notifier)
 {
-    ThreadData::the().notifiers.remove(&notifier);
+    auto& thread_data = ThreadData::the();
+    thread_data.notifiers.remove(&notifier);
+#ifdef AK_OS_SERENITY
+    thread_data.remove_from_event_queue(notifier);
+#endif
 }
 
 void EventLoopManagerUnix::did_post_event()
@@ -6,6 +6,7 @@
  */
 
 #include <AK/Assertions.h>
+#include <AK/Atomic.h>
 #include <AK/Badge.h>
 #include <AK/JsonObject.h>
 #include <LibCore/Event.h>
@@ -61,6 +62,8 @@ ErrorOr<void> EventReceiver::try_add_child(EventReceiver& object)
     VERIFY(!object.parent() || object.parent() == this);
     TRY(m_children.try_append(object));
     object.m_parent = this;
+    // We're now the one who decides whether our new child is visible.
+    did_change_visibility_for_timer_purposes();
     Core::ChildEvent child_event(Core::Event::ChildAdded, object);
     event(child_event);
     return {};
@@ -77,6 +80,7 @@ void EventReceiver::insert_child_before(EventReceiver& new_child, EventReceiver&
     VERIFY(!new_child.parent() || new_child.parent() == this);
     new_child.m_parent = this;
     m_children.insert_before_matching(new_child, [&](auto& existing_child) { return existing_child.ptr() == &before_child; });
+    did_change_visibility_for_timer_purposes();
     Core::ChildEvent child_event(Core::Event::ChildAdded, new_child, &before_child);
     event(child_event);
 }
@@ -89,6 +93,7 @@ void EventReceiver::remove_child(EventReceiver& object)
             NonnullRefPtr<EventReceiver> protector = object;
             object.m_parent = nullptr;
             m_children.remove(i);
+            did_change_visibility_for_timer_purposes();
             Core::ChildEvent child_event(Core::Event::ChildRemoved, object);
             event(child_event);
             return;
@@ -176,6 +181,18 @@ bool EventReceiver::is_visible_for_timer_purposes() const
     return true;
 }
 
+static Atomic<u64> s_timer_visibility_generation;
+
+u64 EventReceiver::timer_visibility_generation()
+{
+    return s_timer_visibility_generation.load(AK::MemoryOrder::memory_order_relaxed);
+}
+
+void EventReceiver::did_change_visibility_for_timer_purposes()
+{
+    s_timer_visibility_generation.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+}
+
 void EventReceiver::set_event_filter(Function<bool(Core::Event&)> filter)
 {
     m_event_filter = move(filter);
@@ -154,9 +154,16 @@ public:
 
     virtual bool is_visible_for_timer_purposes() const;
 
+    // Changes whenever any receiver's is_visible_for_timer_purposes() may have changed, so that timers waiting for their
+    // owner to become visible only have to be looked at again when this does.
+    static u64 timer_visibility_generation();
+
 protected:
     explicit EventReceiver(EventReceiver* parent = nullptr);
 
+    // Overrides of is_visible_for_timer_purposes() must call this whenever their answer may have changed.
+    static void did_change_visibility_for_timer_purposes();
+
     virtual void event(Core::Event&);
 
     virtual void timer_event(TimerEvent&);
@@ -27,12 +27,26 @@ void Notifier::set_enabled(bool enabled)
 {
     if (m_fd < 0)
         return;
+    m_is_enabled = enabled;
     if (enabled)
         Core::EventLoop::register_notifier({}, *this);
     else
         Core::EventLoop::unregister_notifier({}, *this);
 }
 
+void Notifier::set_type(Type type)
+{
+    if (m_type == type)
+        return;
+    // The event loop may have told the kernel what we're interested in, so let it know about the new type.
+    bool was_enabled = m_is_enabled;
+    if (was_enabled)
+        set_enabled(false);
+    m_type = type;
+    if (was_enabled)
+        set_enabled(true);
+}
+
 void Notifier::close()
 {
     if (m_fd < 0)
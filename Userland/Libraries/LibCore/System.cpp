@@ -36,6 +36,10 @@
 #    include <sys/sysmacros.h>
 #endif
 
+#if defined(AK_OS_SERENITY) || defined(AK_OS_LINUX)
+#    include <sys/sendfile.h>
+#endif
+
 #if defined(AK_OS_LINUX) && !defined(MFD_CLOEXEC)
 #    include <linux/memfd.h>
 #    include <sys/syscall.h>
@@ -372,6 +376,29 @@ ErrorOr<void> profiling_free_buffer(pid_t pid)
     int rc = ::profiling_free_buffer(pid);
     HANDLE_SYSCALL_RETURN_VALUE("profiling_free_buffer", rc, {});
 }
+
+ErrorOr<int> event_queue_create(int options)
+{
+    int fd = ::event_queue_create(options);
+    if (fd < 0)
+        return Error::from_syscall("event_queue_create"sv, -errno);
+    return fd;
+}
+
+ErrorOr<void> event_queue_control(int queue_fd, int operation, int fd, unsigned events)
+{
+    if (::event_queue_control(queue_fd, operation, fd, events) < 0)
+        return Error::from_syscall("event_queue_control"sv, -errno);
+    return {};
+}
+
+ErrorOr<size_t> event_queue_wait(int queue_fd, Span<struct pollfd> events, struct timespec const* timeout)
+{
+    int rc = ::event_queue_wait(queue_fd, events.data(), events.size(), timeout);
+    if (rc < 0)
+        return Error::from_syscall("event_queue_wait"sv, -errno);
+    return rc;
+}
 #endif
 
 #if !defined(AK_OS_BSD_GENERIC) && !defined(AK_OS_ANDROID)
@@ -1486,6 +1513,30 @@ ErrorOr<ssize_t> sendto(int sockfd, void const* source, size_t source_length, in
     return sent;
 }
 
+ErrorOr<size_t> sendfile(int out_fd, int in_fd, off_t* offset, size_t count)
+{
+#if defined(AK_OS_SERENITY) || defined(AK_OS_LINUX)
+    auto sent = ::sendfile(out_fd, in_fd, offset, count);
+    if (sent < 0)
+        return Error::from_syscall("sendfile"sv, -errno);
+    return sent;
+#else
+    // Emulate the Linux semantics with a userspace copy.
+    Array<u8, 64 * KiB> buffer;
+    off_t position = offset ? *offset : TRY(lseek(in_fd, 0, SEEK_CUR));
+    auto nread = ::pread(in_fd, buffer.data(), min(count, buffer.size()), position);
+    if (nread < 0)
+        return Error::from_syscall("pread"sv, -errno);
+    auto nwritten = TRY(write(out_fd, { buffer.data(), static_cast<size_t>(nread) }));
+    position += nwritten;
+    if (offset)
+        *offset = position;
+    else
+        TRY(lseek(in_fd, position, SEEK_SET));
+    return nwritten;
+#endif
+}
+
 ErrorOr<ssize_t> recv(int sockfd, void* buffer, size_t length, int flags)
 {
     auto received = ::recv(sockfd, buffer, length, flags);
@@ -69,6 +69,9 @@ ErrorOr<void> disown(pid_t pid);
 ErrorOr<void> profiling_enable(pid_t, u64 event_mask);
 ErrorOr<void> profiling_disable(pid_t);
 ErrorOr<void> profiling_free_buffer(pid_t);
+ErrorOr<int> event_queue_create(int options);
+ErrorOr<void> event_queue_control(int queue_fd, int operation, int fd, unsigned events);
+ErrorOr<size_t> event_queue_wait(int queue_fd, Span<struct pollfd> events, struct timespec const* timeout);
 #else
 inline ErrorOr<void> unveil(StringView, StringView)
 {
@@ -216,6 +219,7 @@ ErrorOr<void> shutdown(int sockfd, int how);
 ErrorOr<ssize_t> send(int sockfd, void const*, size_t, int flags);
 ErrorOr<ssize_t> sendmsg(int sockfd, const struct msghdr*, int flags);
 ErrorOr<ssize_t> sendto(int sockfd, void const*, size_t, int flags, struct sockaddr const*, socklen_t);
+ErrorOr<size_t> sendfile(int out_fd, int in_fd, off_t* offset, size_t count);
 ErrorOr<ssize_t> recv(int sockfd, void*, size_t, int flags);
 ErrorOr<ssize_t> recvmsg(int sockfd, struct msghdr*, int flags);
 ErrorOr<ssize_t> recvfrom(int sockfd, void*, size_t, int flags, struct sockaddr*, socklen_t*);
@@ -72,6 +72,10 @@ public:
         m_outer_hasher.update(m_key_data + m_inner_hasher.block_size(), m_outer_hasher.block_size());
     }
 
+    // The key XORed with ipad and opad, which every inner and outer hash starts with.
+    ReadonlyBytes inner_padded_key() const { return { m_key_data, m_inner_hasher.block_size() }; }
+    ReadonlyBytes outer_padded_key() const { return { m_key_data + m_inner_hasher.block_size(), m_outer_hasher.block_size() }; }
+
 #ifndef KERNEL
     DeprecatedString class_name() const
     {
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Platform.h>
+#include <AK/Types.h>
+
+// The kernel is built without SSE, so it always uses the portable implementations.
+#if ARCH(X86_64) && !defined(KERNEL)
+#    define CRYPTO_HAS_X86_64_ACCELERATION 1
+#    include <cpuid.h>
+#else
+#    define CRYPTO_HAS_X86_64_ACCELERATION 0
+#endif
+
+namespace Crypto {
+
+struct CPUFeatures {
+    bool aes { false };
+    bool pclmulqdq { false };
+    bool ssse3 { false };
+    bool sse41 { false };
+    bool sha { false };
+    bool avx2 { false };
+};
+
+inline CPUFeatures const& cpu_features()
+{
+    static CPUFeatures const features = [] {
+        CPUFeatures features;
+#if CRYPTO_HAS_X86_64_ACCELERATION
+        u32 eax, ebx, ecx, edx;
+        if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+            features.aes = (ecx & bit_AES) != 0;
+            features.pclmulqdq = (ecx & bit_PCLMUL) != 0;
+            features.ssse3 = (ecx & bit_SSSE3) != 0;
+            features.sse41 = (ecx & bit_SSE4_1) != 0;
+
+            // AVX state is only usable if the kernel has enabled it in XCR0.
+            bool os_saves_avx_state = false;
+            if ((ecx & bit_OSXSAVE) != 0 && (ecx & bit_AVX) != 0) {
+                u32 xcr0_low, xcr0_high;
+                asm volatile("xgetbv"
+                             : "=a"(xcr0_low), "=d"(xcr0_high)
+                             : "c"(0));
+                os_saves_avx_state = (xcr0_low & 0x6) == 0x6;
+            }
+
+            if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+                features.sha = (ebx & bit_SHA) != 0;
+                features.avx2 = os_saves_avx_state && (ebx & bit_AVX2) != 0;
+            }
+        }
+#endif
+        return features;
+    }();
+    return features;
+}
+
+}
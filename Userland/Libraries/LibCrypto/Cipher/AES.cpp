@@ -4,10 +4,17 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/ByteReader.h>
+#include <AK/Endian.h>
 #include <AK/StringBuilder.h>
+#include <LibCrypto/CPUFeatures.h>
 #include <LibCrypto/Cipher/AES.h>
 #include <LibCrypto/Cipher/AESTables.h>
 
+#if CRYPTO_HAS_X86_64_ACCELERATION
+#    include <wmmintrin.h>
+#endif
+
 namespace Crypto::Cipher {
 
 template<typename T>
@@ -41,6 +48,85 @@ DeprecatedString AESCipherKey::to_deprecated_string() const
 }
 #endif
 
+#if CRYPTO_HAS_X86_64_ACCELERATION
+namespace AESNI {
+
+// Keeping eight blocks in flight hides the latency of the AES round instructions.
+static constexpr size_t interleaved_blocks = 8;
+
+[[gnu::target("aes")]] static void encrypt_blocks(u8 const* round_key_bytes, size_t rounds, u8 const* in, u8* out, size_t block_count)
+{
+    auto const* round_keys = reinterpret_cast<__m128i const*>(round_key_bytes);
+
+    for (; block_count >= interleaved_blocks; block_count -= interleaved_blocks) {
+        __m128i blocks[interleaved_blocks];
+        auto round_key = _mm_loadu_si128(&round_keys[0]);
+        for (size_t i = 0; i < interleaved_blocks; ++i)
+            blocks[i] = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<__m128i const*>(in) + i), round_key);
+        for (size_t round = 1; round < rounds; ++round) {
+            round_key = _mm_loadu_si128(&round_keys[round]);
+            for (size_t i = 0; i < interleaved_blocks; ++i)
+                blocks[i] = _mm_aesenc_si128(blocks[i], round_key);
+        }
+        round_key = _mm_loadu_si128(&round_keys[rounds]);
+        for (size_t i = 0; i < interleaved_blocks; ++i)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out) + i, _mm_aesenclast_si128(blocks[i], round_key));
+        in += interleaved_blocks * 16;
+        out += interleaved_blocks * 16;
+    }
+
+    for (; block_count > 0; --block_count) {
+        auto block = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<__m128i const*>(in)), _mm_loadu_si128(&round_keys[0]));
+        for (size_t round = 1; round < rounds; ++round)
+            block = _mm_aesenc_si128(block, _mm_loadu_si128(&round_keys[round]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_aesenclast_si128(block, _mm_loadu_si128(&round_keys[rounds])));
+        in += 16;
+        out += 16;
+    }
+}
+
+// NOTE: The decryption key schedule already has InvMixColumns applied to the middle round keys,
+//       which is exactly what AESDEC expects.
+[[gnu::target("aes")]] static void decrypt_blocks(u8 const* round_key_bytes, size_t rounds, u8 const* in, u8* out, size_t block_count)
+{
+    auto const* round_keys = reinterpret_cast<__m128i const*>(round_key_bytes);
+
+    for (; block_count >= interleaved_blocks; block_count -= interleaved_blocks) {
+        __m128i blocks[interleaved_blocks];
+        auto round_key = _mm_loadu_si128(&round_keys[0]);
+        for (size_t i = 0; i < interleaved_blocks; ++i)
+            blocks[i] = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<__m128i const*>(in) + i), round_key);
+        for (size_t round = 1; round < rounds; ++round) {
+            round_key = _mm_loadu_si128(&round_keys[round]);
+            for (size_t i = 0; i < interleaved_blocks; ++i)
+                blocks[i] = _mm_aesdec_si128(blocks[i], round_key);
+        }
+        round_key = _mm_loadu_si128(&round_keys[rounds]);
+        for (size_t i = 0; i < interleaved_blocks; ++i)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out) + i, _mm_aesdeclast_si128(blocks[i], round_key));
+        in += interleaved_blocks * 16;
+        out += interleaved_blocks * 16;
+    }
+
+    for (; block_count > 0; --block_count) {
+        auto block = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<__m128i const*>(in)), _mm_loadu_si128(&round_keys[0]));
+        for (size_t round = 1; round < rounds; ++round)
+            block = _mm_aesdec_si128(block, _mm_loadu_si128(&round_keys[round]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_aesdeclast_si128(block, _mm_loadu_si128(&round_keys[rounds])));
+        in += 16;
+        out += 16;
+    }
+}
+
+}
+#endif
+
+void AESCipherKey::update_round_key_bytes()
+{
+    for (size_t i = 0; i < (rounds() + 1) * 4; ++i)
+        ByteReader::store(m_rd_key_bytes + i * 4, AK::convert_between_host_and_big_endian(m_rd_keys[i]));
+}
+
 void AESCipherKey::expand_encrypt_key(ReadonlyBytes user_key, size_t bits)
 {
     u32* round_key;
@@ -198,6 +284,13 @@ void AESCipherKey::expand_decrypt_key(ReadonlyBytes user_key, size_t bits)
 
 void AESCipher::encrypt_block(AESCipherBlock const& in, AESCipherBlock& out)
 {
+#if CRYPTO_HAS_X86_64_ACCELERATION
+    if (cpu_features().aes) {
+        AESNI::encrypt_blocks(key().round_key_bytes(), key().rounds(), in.bytes().data(), out.bytes().data(), 1);
+        return;
+    }
+#endif
+
     u32 s0, s1, s2, s3, t0, t1, t2, t3;
     size_t r { 0 };
 
@@ -287,6 +380,13 @@ void AESCipher::encrypt_block(AESCipherBlock const& in, AESCipherBlock& out)
 
 void AESCipher::decrypt_block(AESCipherBlock const& in, AESCipherBlock& out)
 {
+#if CRYPTO_HAS_X86_64_ACCELERATION
+    if (cpu_features().aes) {
+        AESNI::decrypt_blocks(key().round_key_bytes(), key().rounds(), in.bytes().data(), out.bytes().data(), 1);
+        return;
+    }
+#endif
+
     u32 s0, s1, s2, s3, t0, t1, t2, t3;
     size_t r { 0 };
 
@@ -374,6 +474,46 @@ void AESCipher::decrypt_block(AESCipherBlock const& in, AESCipherBlock& out)
     // clang-format on
 }
 
+void AESCipher::encrypt_blocks(ReadonlyBytes in, Bytes out)
+{
+    VERIFY(in.size() % block_size() == 0);
+    VERIFY(out.size() >= in.size());
+
+#if CRYPTO_HAS_X86_64_ACCELERATION
+    if (cpu_features().aes) {
+        AESNI::encrypt_blocks(key().round_key_bytes(), key().rounds(), in.data(), out.data(), in.size() / block_size());
+        return;
+    }
+#endif
+
+    AESCipherBlock block;
+    for (size_t offset = 0; offset < in.size(); offset += block_size()) {
+        block.overwrite(in.slice(offset, block_size()));
+        encrypt_block(block, block);
+        block.bytes().copy_to(out.slice(offset));
+    }
+}
+
+void AESCipher::decrypt_blocks(ReadonlyBytes in, Bytes out)
+{
+    VERIFY(in.size() % block_size() == 0);
+    VERIFY(out.size() >= in.size());
+
+#if CRYPTO_HAS_X86_64_ACCELERATION
+    if (cpu_features().aes) {
+        AESNI::decrypt_blocks(key().round_key_bytes(), key().rounds(), in.data(), out.data(), in.size() / block_size());
+        return;
+    }
+#endif
+
+    AESCipherBlock block;
+    for (size_t offset = 0; offset < in.size(); offset += block_size()) {
+        block.overwrite(in.slice(offset, block_size()));
+        decrypt_block(block, block);
+        block.bytes().copy_to(out.slice(offset));
+    }
+}
+
 void AESCipherBlock::overwrite(ReadonlyBytes bytes)
 {
     auto data = bytes.data();
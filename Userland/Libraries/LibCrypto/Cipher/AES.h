@@ -72,6 +72,9 @@ struct AESCipherKey : public CipherKey {
         return (u32 const*)m_rd_keys;
     }
 
+    // The round keys serialized in the byte order that the AES instructions expect.
+    u8 const* round_key_bytes() const { return m_rd_key_bytes; }
+
     AESCipherKey(ReadonlyBytes user_key, size_t key_bits, Intent intent)
         : m_bits(key_bits)
     {
@@ -79,6 +82,7 @@ struct AESCipherKey : public CipherKey {
             expand_encrypt_key(user_key, key_bits);
         else
             expand_decrypt_key(user_key, key_bits);
+        update_round_key_bytes();
     }
 
     virtual ~AESCipherKey() override = default;
@@ -93,8 +97,11 @@ protected:
     }
 
 private:
+    void update_round_key_bytes();
+
     static constexpr size_t MAX_ROUND_COUNT = 14;
     u32 m_rd_keys[(MAX_ROUND_COUNT + 1) * 4] { 0 };
+    u8 m_rd_key_bytes[(MAX_ROUND_COUNT + 1) * 16] { 0 };
     size_t m_rounds;
     size_t m_bits;
 };
@@ -119,6 +126,11 @@ public:
     virtual void encrypt_block(BlockType const& in, BlockType& out) override;
     virtual void decrypt_block(BlockType const& in, BlockType& out) override;
 
+    // These process any number of independent blocks at once, which lets the hardware
+    // implementation keep several blocks in flight.
+    void encrypt_blocks(ReadonlyBytes in, Bytes out);
+    void decrypt_blocks(ReadonlyBytes in, Bytes out);
+
 #ifndef KERNEL
     virtual DeprecatedString class_name() const override
     {
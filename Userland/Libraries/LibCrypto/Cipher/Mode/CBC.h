@@ -104,6 +104,36 @@ public:
         m_cipher_block.set_padding_mode(cipher.padding_mode());
         size_t offset { 0 };
 
+        if constexpr (CipherWithMultipleBlockOperations<T>) {
+            // Unlike encryption, decryption of each block doesn't depend on the previous one,
+            // so we can decrypt a batch of blocks at once and chain them afterwards.
+            // NOTE: The ciphertext is copied out first, as `in` and `out` may be the same buffer.
+            constexpr size_t blocks_per_batch = 8;
+            u8 previous_ciphertext[T::block_size()];
+            u8 ciphertext[blocks_per_batch * T::block_size()];
+            u8 plaintext[blocks_per_batch * T::block_size()];
+            iv.slice(0, block_size).copy_to({ previous_ciphertext, block_size });
+
+            while (length > 0) {
+                auto batch_size = min(length, sizeof(ciphertext));
+                in.slice(offset, batch_size).copy_to({ ciphertext, batch_size });
+                cipher.decrypt_blocks({ ciphertext, batch_size }, { plaintext, batch_size });
+                for (size_t i = 0; i < block_size; ++i)
+                    plaintext[i] ^= previous_ciphertext[i];
+                for (size_t i = block_size; i < batch_size; ++i)
+                    plaintext[i] ^= ciphertext[i - block_size];
+                __builtin_memcpy(previous_ciphertext, ciphertext + batch_size - block_size, block_size);
+
+                VERIFY(offset + batch_size <= out.size());
+                __builtin_memcpy(out.offset(offset), plaintext, batch_size);
+                length -= batch_size;
+                offset += batch_size;
+            }
+            out = out.slice(0, offset);
+            this->prune_padding(out);
+            return;
+        }
+
         while (length > 0) {
             auto slice = in.slice(offset);
             m_cipher_block.overwrite(slice.data(), block_size);
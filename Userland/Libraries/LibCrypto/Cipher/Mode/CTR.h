@@ -170,6 +170,33 @@ protected:
         size_t offset { 0 };
         auto block_size = cipher.block_size();
 
+        if constexpr (CipherWithMultipleBlockOperations<T>) {
+            // Generate the key stream for a batch of counter values at once.
+            constexpr size_t blocks_per_batch = 8;
+            u8 key_stream[blocks_per_batch * T::block_size()];
+
+            while (length > 0) {
+                auto blocks_in_batch = min(blocks_per_batch, ceil_div(length, block_size));
+                for (size_t i = 0; i < blocks_in_batch; ++i) {
+                    __builtin_memcpy(key_stream + i * block_size, iv.data(), block_size);
+                    increment(iv);
+                }
+                Bytes key_stream_bytes { key_stream, blocks_in_batch * block_size };
+                cipher.encrypt_blocks(key_stream_bytes, key_stream_bytes);
+
+                auto write_size = min(key_stream_bytes.size(), length);
+                VERIFY(offset + write_size <= out.size());
+                if (in) {
+                    for (size_t i = 0; i < write_size; ++i)
+                        out[offset + i] = (*in)[offset + i] ^ key_stream[i];
+                } else {
+                    __builtin_memcpy(out.offset(offset), key_stream, write_size);
+                }
+                length -= write_size;
+                offset += write_size;
+            }
+        }
+
         while (length > 0) {
             m_cipher_block.overwrite(iv.slice(0, block_size));
 
@@ -12,6 +12,13 @@
 
 namespace Crypto::Cipher {
 
+// Ciphers that can process several independent blocks in one call, e.g. to keep a hardware pipeline busy.
+template<typename T>
+concept CipherWithMultipleBlockOperations = requires(T& cipher, ReadonlyBytes in, Bytes out) {
+    cipher.encrypt_blocks(in, out);
+    cipher.decrypt_blocks(in, out);
+};
+
 template<typename T>
 class Mode {
 public:
@@ -6,8 +6,10 @@
 
 #pragma once
 
+#include <AK/ByteBuffer.h>
+#include <AK/Error.h>
 #include <AK/Math.h>
-#include <LibCrypto/BigInt/UnsignedBigInteger.h>
+#include <AK/Vector.h>
 
 namespace Crypto::Hash {
 
@@ -34,6 +36,11 @@ public:
         u32 l = AK::ceil_div(key_length_bytes, h_len);
         u32 r = key_length_bytes - (l - 1) * h_len;
 
+        if constexpr (requires { PRF::HashType::hash_many(ReadonlySpan<ReadonlyBytes> {}, Span<typename PRF::HashType::DigestType> {}); prf.inner_padded_key(); }) {
+            if (l > 1)
+                return derive_blocks_together(prf, salt, iterations, key_length_bytes, l);
+        }
+
         // 3. For each block of the derived key apply the function F defined
         //    below to the password P, the salt S, the iteration count c, and
         //    the block index to compute the block:
@@ -65,11 +72,8 @@ public:
                 auto digest_inner = prf.digest();
                 ui.overwrite(0, digest_inner.immutable_data(), h_len);
 
-                UnsignedBigInteger ti_temp = UnsignedBigInteger::import_data(ti.data(), ti.size());
-                UnsignedBigInteger ui_temp = UnsignedBigInteger::import_data(ui.data(), ui.size());
-                UnsignedBigInteger r_temp = ti_temp.bitwise_xor(ui_temp);
-
-                r_temp.export_data(ti.bytes());
+                for (size_t k = 0; k < h_len; ++k)
+                    ti[k] ^= ui[k];
             }
 
             //  4. Concatenate the blocks and extract the first dkLen octets to produce a derived key DK:
@@ -79,6 +83,86 @@ public:
         // 5. Output the derived key DK
         return key;
     }
+
+private:
+    // The blocks of the derived key don't depend on each other, so when the PRF is an HMAC over a hash that can
+    // hash several messages at once, all U_j of one iteration are computed together.
+    template<typename PRF>
+    static ErrorOr<ByteBuffer> derive_blocks_together(PRF const& prf, ReadonlyBytes salt, u32 iterations, u32 key_length_bytes, u32 block_count)
+    {
+        using DigestType = typename PRF::HashType::DigestType;
+
+        auto inner_key = prf.inner_padded_key();
+        auto outer_key = prf.outer_padded_key();
+        size_t h_len = prf.digest_size();
+
+        // Every inner hash is H(K ^ ipad || m), and every outer one is H(K ^ opad || inner digest).
+        size_t first_inner_message_size = inner_key.size() + salt.size() + 4;
+        size_t inner_message_size = inner_key.size() + h_len;
+        size_t outer_message_size = outer_key.size() + h_len;
+        auto first_inner_messages = TRY(ByteBuffer::create_uninitialized(block_count * first_inner_message_size));
+        auto inner_messages = TRY(ByteBuffer::create_uninitialized(block_count * inner_message_size));
+        auto outer_messages = TRY(ByteBuffer::create_uninitialized(block_count * outer_message_size));
+
+        Vector<ReadonlyBytes> first_inner_spans, inner_spans, outer_spans;
+        Vector<DigestType> digests, blocks;
+        TRY(first_inner_spans.try_ensure_capacity(block_count));
+        TRY(inner_spans.try_ensure_capacity(block_count));
+        TRY(outer_spans.try_ensure_capacity(block_count));
+        TRY(digests.try_resize(block_count));
+
+        for (u32 i = 0; i < block_count; ++i) {
+            u32 block_index = i + 1;
+            u8 iteration_bytes[4] {
+                static_cast<u8>(block_index >> 24),
+                static_cast<u8>(block_index >> 16),
+                static_cast<u8>(block_index >> 8),
+                static_cast<u8>(block_index),
+            };
+            auto first_inner_message = first_inner_messages.bytes().slice(i * first_inner_message_size, first_inner_message_size);
+            first_inner_message.overwrite(0, inner_key.data(), inner_key.size());
+            first_inner_message.overwrite(inner_key.size(), salt.data(), salt.size());
+            first_inner_message.overwrite(inner_key.size() + salt.size(), iteration_bytes, 4);
+            first_inner_spans.unchecked_append(first_inner_message);
+
+            auto inner_message = inner_messages.bytes().slice(i * inner_message_size, inner_message_size);
+            inner_message.overwrite(0, inner_key.data(), inner_key.size());
+            inner_spans.unchecked_append(inner_message);
+
+            auto outer_message = outer_messages.bytes().slice(i * outer_message_size, outer_message_size);
+            outer_message.overwrite(0, outer_key.data(), outer_key.size());
+            outer_spans.unchecked_append(outer_message);
+        }
+
+        auto finish_hmacs = [&] {
+            for (u32 i = 0; i < block_count; ++i)
+                outer_messages.overwrite(i * outer_message_size + outer_key.size(), digests[i].immutable_data(), h_len);
+            PRF::HashType::hash_many(outer_spans, digests);
+        };
+
+        // U_1 = PRF (P, S || INT (i))
+        PRF::HashType::hash_many(first_inner_spans, digests);
+        finish_hmacs();
+        TRY(blocks.try_extend(digests));
+
+        // U_j = PRF (P, U_{j-1})
+        for (u32 j = 2; j <= iterations; ++j) {
+            for (u32 i = 0; i < block_count; ++i)
+                inner_messages.overwrite(i * inner_message_size + inner_key.size(), digests[i].immutable_data(), h_len);
+            PRF::HashType::hash_many(inner_spans, digests);
+            finish_hmacs();
+
+            for (u32 i = 0; i < block_count; ++i) {
+                for (size_t k = 0; k < h_len; ++k)
+                    blocks[i].data[k] ^= digests[i].data[k];
+            }
+        }
+
+        ByteBuffer key = TRY(ByteBuffer::create_uninitialized(key_length_bytes));
+        for (u32 i = 0; i < block_count; ++i)
+            key.overwrite(i * h_len, blocks[i].immutable_data(), min<size_t>(h_len, key_length_bytes - i * h_len));
+        return key;
+    }
 };
 
 }
@@ -8,8 +8,13 @@
 #include <AK/Endian.h>
 #include <AK/Memory.h>
 #include <AK/Types.h>
+#include <LibCrypto/CPUFeatures.h>
 #include <LibCrypto/Hash/SHA1.h>
 
+#if CRYPTO_HAS_X86_64_ACCELERATION
+#    include <immintrin.h>
+#endif
+
 namespace Crypto::Hash {
 
 static constexpr auto ROTATE_LEFT(u32 value, size_t bits)
@@ -67,20 +72,116 @@ inline void SHA1::transform(u8 const* data)
     secure_zero(blocks, 16 * sizeof(u32));
 }
 
+#if CRYPTO_HAS_X86_64_ACCELERATION
+namespace SHANI {
+
+template<int Function>
+[[gnu::target("sha,sse4.1")]] static __m128i rounds(__m128i abcd, __m128i e)
+{
+    return _mm_sha1rnds4_epu32(abcd, e, Function);
+}
+
+[[gnu::target("sha,sse4.1")]] static void transform_blocks(u32* state, u8 const* data, size_t block_count)
+{
+    auto const byte_swap_mask = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+
+    auto abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(state)), 0x1b);
+    auto e0 = _mm_set_epi32(static_cast<int>(state[4]), 0, 0, 0);
+    __m128i e1;
+
+    for (; block_count > 0; --block_count, data += 64) {
+        auto const saved_abcd = abcd;
+        auto const saved_e0 = e0;
+        __m128i w[4];
+
+        // Each group of four rounds consumes one schedule vector and prepares the ones needed three groups later.
+#    pragma GCC unroll 20
+        for (size_t group = 0; group < 20; ++group) {
+            auto& current = w[group % 4];
+            if (group < 4)
+                current = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(data + group * 16)), byte_swap_mask);
+
+            auto& e_in = group % 2 == 0 ? e0 : e1;
+            auto& e_out = group % 2 == 0 ? e1 : e0;
+            if (group == 0)
+                e_in = _mm_add_epi32(e_in, current);
+            else
+                e_in = _mm_sha1nexte_epu32(e_in, current);
+            e_out = abcd;
+
+            if (group >= 3 && group <= 18)
+                w[(group + 1) % 4] = _mm_sha1msg2_epu32(w[(group + 1) % 4], current);
+
+            switch (group / 5) {
+            case 0:
+                abcd = rounds<0>(abcd, e_in);
+                break;
+            case 1:
+                abcd = rounds<1>(abcd, e_in);
+                break;
+            case 2:
+                abcd = rounds<2>(abcd, e_in);
+                break;
+            default:
+                abcd = rounds<3>(abcd, e_in);
+                break;
+            }
+
+            if (group >= 1 && group <= 16)
+                w[(group + 3) % 4] = _mm_sha1msg1_epu32(w[(group + 3) % 4], current);
+            if (group >= 2 && group <= 17)
+                w[(group + 2) % 4] = _mm_xor_si128(w[(group + 2) % 4], current);
+        }
+
+        e0 = _mm_sha1nexte_epu32(e0, saved_e0);
+        abcd = _mm_add_epi32(abcd, saved_abcd);
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_shuffle_epi32(abcd, 0x1b));
+    state[4] = static_cast<u32>(_mm_extract_epi32(e0, 3));
+}
+
+}
+#endif
+
+void SHA1::transform_blocks(u8 const* data, size_t block_count)
+{
+#if CRYPTO_HAS_X86_64_ACCELERATION
+    auto const& features = cpu_features();
+    if (features.sha && features.sse41 && features.ssse3) {
+        SHANI::transform_blocks(m_state, data, block_count);
+        return;
+    }
+#endif
+    for (; block_count > 0; --block_count, data += BlockSize)
+        transform(data);
+}
+
 void SHA1::update(u8 const* message, size_t length)
 {
-    while (length > 0) {
+    if (m_data_length > 0) {
         size_t copy_bytes = AK::min(length, BlockSize - m_data_length);
         __builtin_memcpy(m_data_buffer + m_data_length, message, copy_bytes);
         message += copy_bytes;
         length -= copy_bytes;
         m_data_length += copy_bytes;
-        if (m_data_length == BlockSize) {
-            transform(m_data_buffer);
-            m_bit_length += BlockSize * 8;
-            m_data_length = 0;
-        }
+        if (m_data_length < BlockSize)
+            return;
+        transform_blocks(m_data_buffer, 1);
+        m_bit_length += BlockSize * 8;
+        m_data_length = 0;
     }
+
+    // Whole blocks are hashed straight out of the caller's buffer.
+    if (auto block_count = length / BlockSize; block_count > 0) {
+        transform_blocks(message, block_count);
+        m_bit_length += block_count * BlockSize * 8;
+        message += block_count * BlockSize;
+        length -= block_count * BlockSize;
+    }
+
+    __builtin_memcpy(m_data_buffer, message, length);
+    m_data_length = length;
 }
 
 SHA1::DigestType SHA1::digest()
@@ -111,7 +212,7 @@ SHA1::DigestType SHA1::peek()
         m_data_buffer[i++] = 0x80;
         while (i < BlockSize)
             m_data_buffer[i++] = 0x00;
-        transform(m_data_buffer);
+        transform_blocks(m_data_buffer, 1);
 
         // Then start another block with BlockSize - 8 bytes of zeros
         __builtin_memset(m_data_buffer, 0, FinalBlockDataSize);
@@ -128,7 +229,7 @@ SHA1::DigestType SHA1::peek()
     m_data_buffer[BlockSize - 7] = m_bit_length >> 48;
     m_data_buffer[BlockSize - 8] = m_bit_length >> 56;
 
-    transform(m_data_buffer);
+    transform_blocks(m_data_buffer, 1);
 
     for (i = 0; i < 4; ++i) {
         digest.data[i + 0] = (m_state[0] >> (24 - i * 8)) & 0x000000ff;
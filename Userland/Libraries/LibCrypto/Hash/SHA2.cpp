@@ -6,8 +6,14 @@
  */
 
 #include <AK/Types.h>
+#include <LibCrypto/CPUFeatures.h>
 #include <LibCrypto/Hash/SHA2.h>
 
+#if CRYPTO_HAS_X86_64_ACCELERATION
+#    include <AK/SIMD.h>
+#    include <immintrin.h>
+#endif
+
 namespace Crypto::Hash {
 constexpr static auto ROTRIGHT(u32 a, size_t b) { return (a >> b) | (a << (32 - b)); }
 constexpr static auto CH(u32 x, u32 y, u32 z) { return (x & y) ^ (z & ~x); }
@@ -82,12 +88,251 @@ void update_buffer(u8* buffer, u8 const* input, size_t length, size_t& data_leng
     }
 }
 
+#if CRYPTO_HAS_X86_64_ACCELERATION
+namespace SHANI {
+
+[[gnu::target("sha,sse4.1")]] static void transform_blocks(u32* state, u8 const* data, size_t block_count)
+{
+    auto const byte_swap_mask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    // The SHA extensions want the state split into ABEF and CDGH halves.
+    auto abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(state)), 0xb1);
+    auto efgh = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(state + 4)), 0x1b);
+    auto abef = _mm_alignr_epi8(abcd, efgh, 8);
+    auto cdgh = _mm_blend_epi16(efgh, abcd, 0xf0);
+
+    for (; block_count > 0; --block_count, data += 64) {
+        auto const saved_abef = abef;
+        auto const saved_cdgh = cdgh;
+        __m128i w[4];
+
+        // Each group of four rounds consumes one schedule vector and prepares the ones needed three groups later.
+#    pragma GCC unroll 16
+        for (size_t group = 0; group < 16; ++group) {
+            auto& current = w[group % 4];
+            if (group < 4)
+                current = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(data + group * 16)), byte_swap_mask);
+
+            auto message = _mm_add_epi32(current, _mm_loadu_si128(reinterpret_cast<__m128i const*>(SHA256Constants::RoundConstants + group * 4)));
+            cdgh = _mm_sha256rnds2_epu32(cdgh, abef, message);
+
+            if (group >= 3 && group <= 14) {
+                auto& next = w[(group + 1) % 4];
+                next = _mm_add_epi32(next, _mm_alignr_epi8(current, w[(group + 3) % 4], 4));
+                next = _mm_sha256msg2_epu32(next, current);
+            }
+
+            abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(message, 0x0e));
+
+            if (group >= 1 && group <= 12)
+                w[(group + 3) % 4] = _mm_sha256msg1_epu32(w[(group + 3) % 4], current);
+        }
+
+        abef = _mm_add_epi32(abef, saved_abef);
+        cdgh = _mm_add_epi32(cdgh, saved_cdgh);
+    }
+
+    auto feba = _mm_shuffle_epi32(abef, 0x1b);
+    auto dchg = _mm_shuffle_epi32(cdgh, 0xb1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_blend_epi16(feba, dchg, 0xf0));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4), _mm_alignr_epi8(dchg, feba, 8));
+}
+
+}
+
+// Runs eight independent SHA-256 computations side by side, one per 32-bit lane.
+namespace MultiBuffer {
+
+using AK::SIMD::u32x8;
+
+static constexpr size_t Lanes = 8;
+
+[[gnu::target("avx2"), gnu::always_inline]] static inline u32x8 rotate_right(u32x8 const& x, int bits)
+{
+    return (x >> bits) | (x << (32 - bits));
+}
+
+[[gnu::target("avx2")]] static void hash_lanes(ReadonlySpan<ReadonlyBytes> messages, Span<SHA256::DigestType> digests)
+{
+    constexpr size_t BlockSize = SHA256::block_size();
+
+    // The padded end of each message, which is one or two blocks long.
+    u8 tails[Lanes][2 * BlockSize] {};
+    size_t full_block_counts[Lanes] {};
+    u32 block_counts[Lanes] {};
+    size_t max_block_count = 0;
+
+    for (size_t lane = 0; lane < messages.size(); ++lane) {
+        auto message = messages[lane];
+        full_block_counts[lane] = message.size() / BlockSize;
+        auto remainder = message.size() % BlockSize;
+        if (remainder > 0)
+            __builtin_memcpy(tails[lane], message.data() + full_block_counts[lane] * BlockSize, remainder);
+        tails[lane][remainder] = 0x80;
+
+        size_t tail_block_count = remainder < BlockSize - 8 ? 1 : 2;
+        u64 bit_length = static_cast<u64>(message.size()) * 8;
+        for (size_t i = 0; i < 8; ++i)
+            tails[lane][tail_block_count * BlockSize - 1 - i] = static_cast<u8>(bit_length >> (i * 8));
+
+        block_counts[lane] = full_block_counts[lane] + tail_block_count;
+        max_block_count = max(max_block_count, block_counts[lane]);
+    }
+
+    u32x8 const lane_block_counts { block_counts[0], block_counts[1], block_counts[2], block_counts[3], block_counts[4], block_counts[5], block_counts[6], block_counts[7] };
+
+    u32x8 state[8];
+    for (size_t i = 0; i < 8; ++i)
+        state[i] = u32x8 {} + SHA256Constants::InitializationHashes[i];
+
+    for (size_t block = 0; block < max_block_count; ++block) {
+        u8 const* data[Lanes];
+        for (size_t lane = 0; lane < Lanes; ++lane) {
+            if (block < full_block_counts[lane])
+                data[lane] = messages[lane].data() + block * BlockSize;
+            else
+                data[lane] = tails[lane] + min<size_t>(block - full_block_counts[lane], 1) * BlockSize;
+        }
+
+        u32x8 w[16];
+        for (size_t i = 0; i < 16; ++i) {
+            for (size_t lane = 0; lane < Lanes; ++lane) {
+                auto const* bytes = data[lane] + i * 4;
+                w[i][lane] = (bytes[0] << 24) | (bytes[1] << 16) | (bytes[2] << 8) | bytes[3];
+            }
+        }
+
+        auto a = state[0], b = state[1], c = state[2], d = state[3],
+             e = state[4], f = state[5], g = state[6], h = state[7];
+
+        for (size_t i = 0; i < 64; ++i) {
+            if (i >= 16) {
+                auto w15 = w[(i - 15) % 16];
+                auto w2 = w[(i - 2) % 16];
+                auto sigma0 = rotate_right(w15, 7) ^ rotate_right(w15, 18) ^ (w15 >> 3);
+                auto sigma1 = rotate_right(w2, 17) ^ rotate_right(w2, 19) ^ (w2 >> 10);
+                w[i % 16] += sigma0 + w[(i - 7) % 16] + sigma1;
+            }
+
+            auto temp0 = h + (rotate_right(e, 6) ^ rotate_right(e, 11) ^ rotate_right(e, 25)) + ((e & f) ^ (g & ~e)) + SHA256Constants::RoundConstants[i] + w[i % 16];
+            auto temp1 = (rotate_right(a, 2) ^ rotate_right(a, 13) ^ rotate_right(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            h = g;
+            g = f;
+            f = e;
+            e = d + temp0;
+            d = c;
+            c = b;
+            b = a;
+            a = temp0 + temp1;
+        }
+
+        // Lanes whose message has already ended keep their final state.
+        auto active = static_cast<u32x8>(lane_block_counts > (u32x8 {} + static_cast<u32>(block)));
+        state[0] += a & active;
+        state[1] += b & active;
+        state[2] += c & active;
+        state[3] += d & active;
+        state[4] += e & active;
+        state[5] += f & active;
+        state[6] += g & active;
+        state[7] += h & active;
+    }
+
+    for (size_t lane = 0; lane < messages.size(); ++lane) {
+        for (size_t i = 0; i < 8; ++i) {
+            auto word = state[i][lane];
+            digests[lane].data[i * 4 + 0] = word >> 24;
+            digests[lane].data[i * 4 + 1] = word >> 16;
+            digests[lane].data[i * 4 + 2] = word >> 8;
+            digests[lane].data[i * 4 + 3] = word;
+        }
+    }
+}
+
+}
+#endif
+
+void SHA256::transform_blocks(u8 const* data, size_t block_count)
+{
+#if CRYPTO_HAS_X86_64_ACCELERATION
+    auto const& features = cpu_features();
+    if (features.sha && features.sse41 && features.ssse3) {
+        SHANI::transform_blocks(m_state, data, block_count);
+        return;
+    }
+#endif
+    for (; block_count > 0; --block_count, data += BlockSize)
+        transform(data);
+}
+
 void SHA256::update(u8 const* message, size_t length)
 {
-    update_buffer<BlockSize>(m_data_buffer, message, length, m_data_length, [&]() {
-        transform(m_data_buffer);
+    if (m_data_length > 0) {
+        size_t copy_bytes = AK::min(length, BlockSize - m_data_length);
+        __builtin_memcpy(m_data_buffer + m_data_length, message, copy_bytes);
+        message += copy_bytes;
+        length -= copy_bytes;
+        m_data_length += copy_bytes;
+        if (m_data_length < BlockSize)
+            return;
+        transform_blocks(m_data_buffer, 1);
         m_bit_length += BlockSize * 8;
-    });
+        m_data_length = 0;
+    }
+
+    // Whole blocks are hashed straight out of the caller's buffer.
+    if (auto block_count = length / BlockSize; block_count > 0) {
+        transform_blocks(message, block_count);
+        m_bit_length += block_count * BlockSize * 8;
+        message += block_count * BlockSize;
+        length -= block_count * BlockSize;
+    }
+
+    __builtin_memcpy(m_data_buffer, message, length);
+    m_data_length = length;
+}
+
+bool SHA256::can_interleave()
+{
+#if CRYPTO_HAS_X86_64_ACCELERATION
+    return cpu_features().avx2;
+#else
+    return false;
+#endif
+}
+
+void SHA256::hash_many(ReadonlySpan<ReadonlyBytes> messages, Span<DigestType> digests, HashManyStrategy strategy)
+{
+    VERIFY(messages.size() == digests.size());
+
+#if CRYPTO_HAS_X86_64_ACCELERATION
+    // A single SHA extensions stream is about as fast as eight interleaved AVX2 streams,
+    // so the latter only pays off on CPUs without the former.
+    auto const& features = cpu_features();
+    bool interleave = false;
+    switch (strategy) {
+    case HashManyStrategy::Automatic:
+        interleave = features.avx2 && !features.sha;
+        break;
+    case HashManyStrategy::OneAtATime:
+        break;
+    case HashManyStrategy::Interleaved:
+        interleave = features.avx2;
+        break;
+    }
+    if (interleave) {
+        for (size_t offset = 0; offset < messages.size(); offset += MultiBuffer::Lanes) {
+            auto count = min(MultiBuffer::Lanes, messages.size() - offset);
+            MultiBuffer::hash_lanes(messages.slice(offset, count), digests.slice(offset, count));
+        }
+        return;
+    }
+#else
+    (void)strategy;
+#endif
+
+    for (size_t i = 0; i < messages.size(); ++i)
+        digests[i] = hash(messages[i].data(), messages[i].size());
 }
 
 SHA256::DigestType SHA256::digest()
@@ -111,7 +356,7 @@ SHA256::DigestType SHA256::peek()
         m_data_buffer[i++] = 0x80;
         while (i < BlockSize)
             m_data_buffer[i++] = 0x00;
-        transform(m_data_buffer);
+        transform_blocks(m_data_buffer, 1);
 
         // Then start another block with BlockSize - 8 bytes of zeros
         __builtin_memset(m_data_buffer, 0, FinalBlockDataSize);
@@ -128,7 +373,7 @@ SHA256::DigestType SHA256::peek()
     m_data_buffer[BlockSize - 7] = m_bit_length >> 48;
     m_data_buffer[BlockSize - 8] = m_bit_length >> 56;
 
-    transform(m_data_buffer);
+    transform_blocks(m_data_buffer, 1);
 
     // SHA uses big-endian and we assume little-endian
     // FIXME: looks like a thing for AK::NetworkOrdered,
@@ -99,6 +99,20 @@ public:
     static DigestType hash(ByteBuffer const& buffer) { return hash(buffer.data(), buffer.size()); }
     static DigestType hash(StringView buffer) { return hash((u8 const*)buffer.characters_without_null_termination(), buffer.length()); }
 
+    enum class HashManyStrategy {
+        // Interleave the messages only if that's faster than hashing them one after another on this CPU.
+        Automatic,
+        OneAtATime,
+        // Interleave the messages whenever the CPU can, even if it has faster single-stream instructions.
+        Interleaved,
+    };
+
+    static bool can_interleave();
+
+    // Hashes several independent messages, interleaving them when the CPU can do so faster
+    // than hashing them one after another. digests[i] receives the digest of messages[i].
+    static void hash_many(ReadonlySpan<ReadonlyBytes> messages, Span<DigestType> digests, HashManyStrategy = HashManyStrategy::Automatic);
+
 #ifndef KERNEL
     virtual DeprecatedString class_name() const override
     {
@@ -116,6 +130,7 @@ public:
 
 private:
     inline void transform(u8 const*);
+    void transform_blocks(u8 const*, size_t block_count);
 
     u8 m_data_buffer[BlockSize] {};
     size_t m_data_length { 0 };
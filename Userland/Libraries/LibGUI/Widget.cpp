@@ -902,6 +902,7 @@ void Widget::set_visible(bool visible)
     if (visible == m_visible)
         return;
     m_visible = visible;
+    did_change_visibility_for_timer_purposes();
     layout_relevant_change_occurred();
     if (m_visible)
         update();
@@ -177,6 +177,7 @@ void Window::show()
         launch_origin_rect);
     m_visible = true;
     m_visible_for_timer_purposes = true;
+    did_change_visibility_for_timer_purposes();
 
     apply_icon();
 
@@ -1241,6 +1242,7 @@ void Window::update_all_windows(Badge<ConnectionToWindowServer>)
 void Window::notify_state_changed(Badge<ConnectionToWindowServer>, bool minimized, bool maximized, bool occluded)
 {
     m_visible_for_timer_purposes = !minimized && !occluded;
+    did_change_visibility_for_timer_purposes();
 
     m_maximized = maximized;
 
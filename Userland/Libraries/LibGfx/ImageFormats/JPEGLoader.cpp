@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Atomic.h>
 #include <AK/Debug.h>
 #include <AK/Endian.h>
 #include <AK/Error.h>
@@ -13,11 +14,15 @@
 #include <AK/Math.h>
 #include <AK/MemoryStream.h>
 #include <AK/NumericLimits.h>
+#include <AK/SIMDExtras.h>
+#include <AK/SIMDMath.h>
 #include <AK/String.h>
 #include <AK/Try.h>
 #include <AK/Vector.h>
 #include <LibGfx/ImageFormats/JPEGLoader.h>
 #include <LibGfx/ImageFormats/JPEGShared.h>
+#include <LibThreading/Thread.h>
+#include <unistd.h>
 
 namespace Gfx {
 
@@ -214,6 +219,44 @@ public:
         return {};
     }
 
+    // Reads the entropy-coded data of a scan up to the next marker, splitting it at every restart marker.
+    // Each interval is terminated by an EOI marker, so that a HuffmanStream reading it stops there.
+    ErrorOr<Vector<ByteBuffer>> read_restart_intervals()
+    {
+        Vector<ByteBuffer> intervals;
+        ByteBuffer interval;
+
+        while (true) {
+            u8 const byte = TRY(read_u8());
+            if (byte != 0xFF) {
+                TRY(interval.try_append(byte));
+                continue;
+            }
+
+            u8 next_byte = TRY(read_u8());
+            // B.1.1.2 - Markers: Any marker may optionally be preceded by any number of fill bytes.
+            while (next_byte == 0xFF)
+                next_byte = TRY(read_u8());
+
+            if (next_byte == 0x00) {
+                TRY(interval.try_append(0xFF));
+                TRY(interval.try_append(0x00));
+                continue;
+            }
+
+            TRY(interval.try_append(0xFF));
+            TRY(interval.try_append(JPEG_EOI & 0xFF));
+            TRY(intervals.try_append(move(interval)));
+            interval = {};
+
+            Marker const marker = 0xFF00 | next_byte;
+            if (marker < JPEG_RST0 || marker > JPEG_RST7) {
+                m_saved_marker = marker;
+                return intervals;
+            }
+        }
+    }
+
     Optional<u16>& saved_marker(Badge<HuffmanStream>)
     {
         return m_saved_marker;
@@ -462,6 +505,41 @@ struct JPEGLoadingContext {
     Optional<ByteBuffer> icc_data;
 };
 
+using AK::SIMD::f32x4;
+using AK::SIMD::i16x4;
+using AK::SIMD::i16x8;
+using AK::SIMD::i32x4;
+
+ALWAYS_INLINE static i16x4 load_i16x4(i16 const* values)
+{
+    i16x4 vector;
+    __builtin_memcpy(&vector, values, sizeof(vector));
+    return vector;
+}
+
+ALWAYS_INLINE static i16x8 load_i16x8(i16 const* values)
+{
+    i16x8 vector;
+    __builtin_memcpy(&vector, values, sizeof(vector));
+    return vector;
+}
+
+ALWAYS_INLINE static void store_i16x4(i32x4 vector, i16* values)
+{
+    auto narrowed = __builtin_convertvector(vector, i16x4);
+    __builtin_memcpy(values, &narrowed, sizeof(narrowed));
+}
+
+ALWAYS_INLINE static void store_i16x4(f32x4 vector, i16* values)
+{
+    store_i16x4(AK::SIMD::to_i32x4(vector), values);
+}
+
+ALWAYS_INLINE static void store_i16x8(i16x8 vector, i16* values)
+{
+    __builtin_memcpy(values, &vector, sizeof(vector));
+}
+
 static inline auto* get_component(Macroblock& block, unsigned component)
 {
     switch (component) {
@@ -782,8 +860,122 @@ static void reset_decoder(JPEGLoadingContext& context)
     VERIFY_NOT_REACHED();
 }
 
+// Returns true if every call to build_macroblocks() decodes exactly one MCU.
+static bool is_made_of_whole_mcus(JPEGLoadingContext const& context)
+{
+    return context.current_scan->are_components_interleaved() || (context.hsample_factor == 1 && context.vsample_factor == 1);
+}
+
+static ErrorOr<void> decode_restart_interval(JPEGLoadingContext& context, Vector<Macroblock>& macroblocks, u32 interval_index)
+{
+    // A.2.3 - Interleaved order: MCUs are ordered left-to-right and top-to-bottom.
+    u32 const mcus_per_row = ceil_div(context.mblock_meta.hcount, static_cast<u32>(context.hsample_factor));
+    u32 const mcu_count = mcus_per_row * ceil_div(context.mblock_meta.vcount, static_cast<u32>(context.vsample_factor));
+
+    u32 const first_mcu = interval_index * context.dc_restart_interval;
+    u32 const last_mcu = min(first_mcu + context.dc_restart_interval, mcu_count);
+    for (u32 mcu = first_mcu; mcu < last_mcu; ++mcu) {
+        u32 const vcursor = (mcu / mcus_per_row) * context.vsample_factor;
+        u32 const hcursor = (mcu % mcus_per_row) * context.hsample_factor;
+        TRY(build_macroblocks<JPEGDecodingMode::Sequential>(context, macroblocks, hcursor, vcursor));
+    }
+
+    return {};
+}
+
+static ErrorOr<void> prepare_restart_interval_context(JPEGLoadingContext& interval_context, JPEGLoadingContext const& context, ReadonlyBytes interval)
+{
+    interval_context.stream = TRY(JPEGStream::create(TRY(try_make<FixedMemoryStream>(interval))));
+
+    auto const& scan = *context.current_scan;
+    Scan interval_scan(HuffmanStream { interval_context.stream });
+    for (auto const& scan_component : scan.components)
+        TRY(interval_scan.components.try_empend(interval_context.components[scan_component.component.index], scan_component.dc_destination_id, scan_component.ac_destination_id));
+    interval_scan.spectral_selection_start = scan.spectral_selection_start;
+    interval_scan.spectral_selection_end = scan.spectral_selection_end;
+    interval_scan.successive_approximation_high = scan.successive_approximation_high;
+    interval_scan.successive_approximation_low = scan.successive_approximation_low;
+    interval_context.current_scan = move(interval_scan);
+
+    reset_decoder(interval_context);
+    return {};
+}
+
+static ErrorOr<NonnullOwnPtr<JPEGLoadingContext>> create_restart_interval_context(JPEGLoadingContext const& context, ReadonlyBytes interval)
+{
+    auto interval_context = TRY(JPEGLoadingContext::create(TRY(try_make<FixedMemoryStream>(interval)), context.options));
+
+    interval_context->frame = context.frame;
+    interval_context->hsample_factor = context.hsample_factor;
+    interval_context->vsample_factor = context.vsample_factor;
+    interval_context->mblock_meta = context.mblock_meta;
+    interval_context->dc_restart_interval = context.dc_restart_interval;
+    TRY(interval_context->components.try_extend(context.components));
+    for (auto const& table : context.dc_tables)
+        TRY(interval_context->dc_tables.try_set(table.key, table.value));
+    for (auto const& table : context.ac_tables)
+        TRY(interval_context->ac_tables.try_set(table.key, table.value));
+
+    return interval_context;
+}
+
+static ErrorOr<void> decode_restart_intervals_in_parallel(JPEGLoadingContext& context, Vector<Macroblock>& macroblocks)
+{
+    // E.2.4 Control procedure for decoding a restart interval
+    // Every restart interval starts with a fresh decoder state, so they can be decoded independently
+    // from each other, and they all write to their own macroblocks.
+    auto const intervals = TRY(context.stream.read_restart_intervals());
+
+    size_t const thread_count = min(static_cast<size_t>(max(sysconf(_SC_NPROCESSORS_ONLN), 1)), intervals.size());
+
+    Vector<Optional<Error>> interval_errors;
+    TRY(interval_errors.try_resize(intervals.size()));
+
+    // Every thread picks up the next interval nobody is working on yet, using its own copy of the decoder state.
+    Atomic<size_t> next_interval_index { 0 };
+    auto decode_intervals = [&]() -> intptr_t {
+        OwnPtr<JPEGLoadingContext> interval_context;
+        for (auto interval_index = next_interval_index++; interval_index < intervals.size(); interval_index = next_interval_index++) {
+            auto result = [&]() -> ErrorOr<void> {
+                if (!interval_context)
+                    interval_context = TRY(create_restart_interval_context(context, intervals[interval_index]));
+                TRY(prepare_restart_interval_context(*interval_context, context, intervals[interval_index]));
+                return decode_restart_interval(*interval_context, macroblocks, interval_index);
+            }();
+            if (result.is_error())
+                interval_errors[interval_index] = result.release_error();
+        }
+        return 0;
+    };
+
+    // The calling thread does its share of the work too.
+    Vector<NonnullRefPtr<Threading::Thread>> threads;
+    for (size_t i = 1; i < thread_count; i++) {
+        auto thread_or_error = Threading::Thread::try_create([&] { return decode_intervals(); }, "JPEG decoder"sv);
+        if (thread_or_error.is_error() || threads.try_append(thread_or_error.value()).is_error())
+            break;
+        threads.last()->start();
+    }
+    decode_intervals();
+    for (auto& thread : threads)
+        (void)thread->join();
+
+    for (auto& error : interval_errors) {
+        if (error.has_value())
+            return error.release_value();
+    }
+
+    return {};
+}
+
 static ErrorOr<void> decode_huffman_stream(JPEGLoadingContext& context, Vector<Macroblock>& macroblocks)
 {
+    bool const is_made_of_mcus = is_made_of_whole_mcus(context);
+
+    if (context.options.decode_restart_intervals_in_parallel && context.dc_restart_interval > 0 && is_made_of_mcus && !is_progressive(context.frame.type))
+        return decode_restart_intervals_in_parallel(context, macroblocks);
+
+    u32 mcu_index = 0;
     for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
         for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
             u32 i = vcursor * context.mblock_meta.hpadded_count + hcursor;
@@ -791,7 +983,12 @@ static ErrorOr<void> decode_huffman_stream(JPEGLoadingContext& context, Vector<M
             auto& huffman_stream = context.current_scan->huffman_stream;
 
             if (context.dc_restart_interval > 0) {
-                if (i != 0 && i % (context.dc_restart_interval * context.vsample_factor * context.hsample_factor) == 0) {
+                // B.2.4.4 - Restart interval definition syntax: Ri specifies the number of MCUs in a restart interval.
+                auto const is_restart_interval_start = is_made_of_mcus
+                    ? mcu_index % context.dc_restart_interval == 0
+                    : i % (context.dc_restart_interval * context.vsample_factor * context.hsample_factor) == 0;
+
+                if (i != 0 && is_restart_interval_start) {
                     reset_decoder(context);
 
                     // Restart markers are stored in byte boundaries. Advance the huffman stream cursor to
@@ -816,6 +1013,8 @@ static ErrorOr<void> decode_huffman_stream(JPEGLoadingContext& context, Vector<M
                 }
                 return result.release_error();
             }
+
+            ++mcu_index;
         }
     }
     return {};
@@ -1366,8 +1565,12 @@ static ErrorOr<void> dequantize(JPEGLoadingContext& context, Vector<Macroblock>&
                         u32 macroblock_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hfactor_i + hcursor);
                         Macroblock& block = macroblocks[macroblock_index];
                         auto* block_component = get_component(block, i);
-                        for (u32 k = 0; k < 64; k++)
-                            block_component[k] *= table[k];
+                        for (u32 k = 0; k < 64; k += 8) {
+                            // Quantization values fit into 16 bits, and so does the dequantized coefficient.
+                            auto coefficients = load_i16x8(block_component + k);
+                            auto quantization_values = load_i16x8(bit_cast<i16 const*>(table.data()) + k);
+                            store_i16x8(coefficients * quantization_values, block_component + k);
+                        }
                     }
                 }
             }
@@ -1394,6 +1597,75 @@ static void inverse_dct(JPEGLoadingContext const& context, Vector<Macroblock>& m
     static float const s6 = AK::cos(6.0f / 16.0f * AK::Pi<float>) / 2.0f;
     static float const s7 = AK::cos(7.0f / 16.0f * AK::Pi<float>) / 2.0f;
 
+    // Computes the one-dimensional IDCT of four sets of 8 coefficients at once, `values[i]` being the i-th coefficient of every set.
+    auto const inverse_dct_8_points = [](f32x4 (&values)[8]) {
+        f32x4 const g0 = values[0] * s0;
+        f32x4 const g1 = values[4] * s4;
+        f32x4 const g2 = values[2] * s2;
+        f32x4 const g3 = values[6] * s6;
+        f32x4 const g4 = values[5] * s5;
+        f32x4 const g5 = values[1] * s1;
+        f32x4 const g6 = values[7] * s7;
+        f32x4 const g7 = values[3] * s3;
+
+        f32x4 const f0 = g0;
+        f32x4 const f1 = g1;
+        f32x4 const f2 = g2;
+        f32x4 const f3 = g3;
+        f32x4 const f4 = g4 - g7;
+        f32x4 const f5 = g5 + g6;
+        f32x4 const f6 = g5 - g6;
+        f32x4 const f7 = g4 + g7;
+
+        f32x4 const e0 = f0;
+        f32x4 const e1 = f1;
+        f32x4 const e2 = f2 - f3;
+        f32x4 const e3 = f2 + f3;
+        f32x4 const e4 = f4;
+        f32x4 const e5 = f5 - f7;
+        f32x4 const e6 = f6;
+        f32x4 const e7 = f5 + f7;
+        f32x4 const e8 = f4 + f6;
+
+        f32x4 const d0 = e0;
+        f32x4 const d1 = e1;
+        f32x4 const d2 = e2 * m1;
+        f32x4 const d3 = e3;
+        f32x4 const d4 = e4 * m2;
+        f32x4 const d5 = e5 * m3;
+        f32x4 const d6 = e6 * m4;
+        f32x4 const d7 = e7;
+        f32x4 const d8 = e8 * m5;
+
+        f32x4 const c0 = d0 + d1;
+        f32x4 const c1 = d0 - d1;
+        f32x4 const c2 = d2 - d3;
+        f32x4 const c3 = d3;
+        f32x4 const c4 = d4 + d8;
+        f32x4 const c5 = d5 + d7;
+        f32x4 const c6 = d6 - d8;
+        f32x4 const c7 = d7;
+        f32x4 const c8 = c5 - c6;
+
+        f32x4 const b0 = c0 + c3;
+        f32x4 const b1 = c1 + c2;
+        f32x4 const b2 = c1 - c2;
+        f32x4 const b3 = c0 - c3;
+        f32x4 const b4 = c4 - c8;
+        f32x4 const b5 = c8;
+        f32x4 const b6 = c6 - c7;
+        f32x4 const b7 = c7;
+
+        values[0] = b0 + b7;
+        values[1] = b1 + b6;
+        values[2] = b2 + b5;
+        values[3] = b3 + b4;
+        values[4] = b3 - b4;
+        values[5] = b2 - b5;
+        values[6] = b1 - b6;
+        values[7] = b0 - b7;
+    };
+
     for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
         for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
             for (u32 component_i = 0; component_i < context.components.size(); component_i++) {
@@ -1403,139 +1675,36 @@ static void inverse_dct(JPEGLoadingContext const& context, Vector<Macroblock>& m
                         u32 macroblock_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hfactor_i + hcursor);
                         Macroblock& block = macroblocks[macroblock_index];
                         auto* block_component = get_component(block, component_i);
-                        for (u32 k = 0; k < 8; ++k) {
-                            float const g0 = block_component[0 * 8 + k] * s0;
-                            float const g1 = block_component[4 * 8 + k] * s4;
-                            float const g2 = block_component[2 * 8 + k] * s2;
-                            float const g3 = block_component[6 * 8 + k] * s6;
-                            float const g4 = block_component[5 * 8 + k] * s5;
-                            float const g5 = block_component[1 * 8 + k] * s1;
-                            float const g6 = block_component[7 * 8 + k] * s7;
-                            float const g7 = block_component[3 * 8 + k] * s3;
-
-                            float const f0 = g0;
-                            float const f1 = g1;
-                            float const f2 = g2;
-                            float const f3 = g3;
-                            float const f4 = g4 - g7;
-                            float const f5 = g5 + g6;
-                            float const f6 = g5 - g6;
-                            float const f7 = g4 + g7;
-
-                            float const e0 = f0;
-                            float const e1 = f1;
-                            float const e2 = f2 - f3;
-                            float const e3 = f2 + f3;
-                            float const e4 = f4;
-                            float const e5 = f5 - f7;
-                            float const e6 = f6;
-                            float const e7 = f5 + f7;
-                            float const e8 = f4 + f6;
-
-                            float const d0 = e0;
-                            float const d1 = e1;
-                            float const d2 = e2 * m1;
-                            float const d3 = e3;
-                            float const d4 = e4 * m2;
-                            float const d5 = e5 * m3;
-                            float const d6 = e6 * m4;
-                            float const d7 = e7;
-                            float const d8 = e8 * m5;
-
-                            float const c0 = d0 + d1;
-                            float const c1 = d0 - d1;
-                            float const c2 = d2 - d3;
-                            float const c3 = d3;
-                            float const c4 = d4 + d8;
-                            float const c5 = d5 + d7;
-                            float const c6 = d6 - d8;
-                            float const c7 = d7;
-                            float const c8 = c5 - c6;
-
-                            float const b0 = c0 + c3;
-                            float const b1 = c1 + c2;
-                            float const b2 = c1 - c2;
-                            float const b3 = c0 - c3;
-                            float const b4 = c4 - c8;
-                            float const b5 = c8;
-                            float const b6 = c6 - c7;
-                            float const b7 = c7;
-
-                            block_component[0 * 8 + k] = b0 + b7;
-                            block_component[1 * 8 + k] = b1 + b6;
-                            block_component[2 * 8 + k] = b2 + b5;
-                            block_component[3 * 8 + k] = b3 + b4;
-                            block_component[4 * 8 + k] = b3 - b4;
-                            block_component[5 * 8 + k] = b2 - b5;
-                            block_component[6 * 8 + k] = b1 - b6;
-                            block_component[7 * 8 + k] = b0 - b7;
+
+                        // The first pass works on columns. Every vector holds one row of either the left or the right half of the block.
+                        f32x4 halves[2][8];
+                        for (u32 half = 0; half < 2; ++half) {
+                            for (u32 row = 0; row < 8; ++row)
+                                halves[half][row] = AK::SIMD::to_f32x4(load_i16x4(block_component + row * 8 + half * 4));
+                            inverse_dct_8_points(halves[half]);
+                            // The intermediate results used to be stored as integers, so keep doing that to get the exact same output.
+                            for (u32 row = 0; row < 8; ++row)
+                                halves[half][row] = AK::SIMD::truncate_int_range(halves[half][row]);
                         }
-                        for (u32 l = 0; l < 8; ++l) {
-                            float const g0 = block_component[l * 8 + 0] * s0;
-                            float const g1 = block_component[l * 8 + 4] * s4;
-                            float const g2 = block_component[l * 8 + 2] * s2;
-                            float const g3 = block_component[l * 8 + 6] * s6;
-                            float const g4 = block_component[l * 8 + 5] * s5;
-                            float const g5 = block_component[l * 8 + 1] * s1;
-                            float const g6 = block_component[l * 8 + 7] * s7;
-                            float const g7 = block_component[l * 8 + 3] * s3;
-
-                            float const f0 = g0;
-                            float const f1 = g1;
-                            float const f2 = g2;
-                            float const f3 = g3;
-                            float const f4 = g4 - g7;
-                            float const f5 = g5 + g6;
-                            float const f6 = g5 - g6;
-                            float const f7 = g4 + g7;
-
-                            float const e0 = f0;
-                            float const e1 = f1;
-                            float const e2 = f2 - f3;
-                            float const e3 = f2 + f3;
-                            float const e4 = f4;
-                            float const e5 = f5 - f7;
-                            float const e6 = f6;
-                            float const e7 = f5 + f7;
-                            float const e8 = f4 + f6;
-
-                            float const d0 = e0;
-                            float const d1 = e1;
-                            float const d2 = e2 * m1;
-                            float const d3 = e3;
-                            float const d4 = e4 * m2;
-                            float const d5 = e5 * m3;
-                            float const d6 = e6 * m4;
-                            float const d7 = e7;
-                            float const d8 = e8 * m5;
-
-                            float const c0 = d0 + d1;
-                            float const c1 = d0 - d1;
-                            float const c2 = d2 - d3;
-                            float const c3 = d3;
-                            float const c4 = d4 + d8;
-                            float const c5 = d5 + d7;
-                            float const c6 = d6 - d8;
-                            float const c7 = d7;
-                            float const c8 = c5 - c6;
-
-                            float const b0 = c0 + c3;
-                            float const b1 = c1 + c2;
-                            float const b2 = c1 - c2;
-                            float const b3 = c0 - c3;
-                            float const b4 = c4 - c8;
-                            float const b5 = c8;
-                            float const b6 = c6 - c7;
-                            float const b7 = c7;
-
-                            block_component[l * 8 + 0] = b0 + b7;
-                            block_component[l * 8 + 1] = b1 + b6;
-                            block_component[l * 8 + 2] = b2 + b5;
-                            block_component[l * 8 + 3] = b3 + b4;
-                            block_component[l * 8 + 4] = b3 - b4;
-                            block_component[l * 8 + 5] = b2 - b5;
-                            block_component[l * 8 + 6] = b1 - b6;
-                            block_component[l * 8 + 7] = b0 - b7;
+
+                        // The second pass works on rows. Transpose the block so that every vector holds one column of either the top or the bottom half.
+                        for (u32 half = 0; half < 2; ++half) {
+                            f32x4 columns[8];
+                            for (u32 column = 0; column < 8; ++column) {
+                                auto const& source = halves[column / 4];
+                                columns[column] = f32x4 {
+                                    source[half * 4 + 0][column % 4],
+                                    source[half * 4 + 1][column % 4],
+                                    source[half * 4 + 2][column % 4],
+                                    source[half * 4 + 3][column % 4],
+                                };
+                            }
+                            inverse_dct_8_points(columns);
+                            for (u32 row = 0; row < 4; ++row) {
+                                auto* output = block_component + (half * 4 + row) * 8;
+                                store_i16x4(f32x4 { columns[0][row], columns[1][row], columns[2][row], columns[3][row] }, output);
+                                store_i16x4(f32x4 { columns[4][row], columns[5][row], columns[6][row], columns[7][row] }, output + 4);
+                            }
                         }
                     }
                 }
@@ -1544,30 +1713,30 @@ static void inverse_dct(JPEGLoadingContext const& context, Vector<Macroblock>& m
     }
 
     // F.2.1.5 - Inverse DCT (IDCT)
-    auto const level_shift = 1 << (context.frame.precision - 1);
-    auto const max_value = (1 << context.frame.precision) - 1;
+    auto const level_shift = static_cast<float>(1 << (context.frame.precision - 1));
+    auto const max_value = static_cast<float>((1 << context.frame.precision) - 1);
     for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
         for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
             for (u8 vfactor_i = 0; vfactor_i < context.vsample_factor; ++vfactor_i) {
                 for (u8 hfactor_i = 0; hfactor_i < context.hsample_factor; ++hfactor_i) {
                     u32 mb_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hcursor + hfactor_i);
-                    for (u8 i = 0; i < 8; ++i) {
-                        for (u8 j = 0; j < 8; ++j) {
 
-                            // FIXME: This just truncate all coefficients, it's an easy way to support (read hack)
-                            //        12 bits JPEGs without rewriting all color transformations.
-                            auto const clamp_to_8_bits = [&](u16 color) -> u8 {
-                                if (context.frame.precision == 8)
-                                    return static_cast<u8>(color);
-                                return static_cast<u8>(color >> 4);
-                            };
-
-                            macroblocks[mb_index].r[i * 8 + j] = clamp_to_8_bits(clamp(macroblocks[mb_index].r[i * 8 + j] + level_shift, 0, max_value));
-                            macroblocks[mb_index].g[i * 8 + j] = clamp_to_8_bits(clamp(macroblocks[mb_index].g[i * 8 + j] + level_shift, 0, max_value));
-                            macroblocks[mb_index].b[i * 8 + j] = clamp_to_8_bits(clamp(macroblocks[mb_index].b[i * 8 + j] + level_shift, 0, max_value));
-                            macroblocks[mb_index].k[i * 8 + j] = clamp_to_8_bits(clamp(macroblocks[mb_index].k[i * 8 + j] + level_shift, 0, max_value));
+                    // FIXME: This just truncate all coefficients, it's an easy way to support (read hack)
+                    //        12 bits JPEGs without rewriting all color transformations.
+                    auto const level_shift_and_clamp = [&](i16* samples) {
+                        for (u32 i = 0; i < 64; i += 4) {
+                            auto shifted = AK::SIMD::clamp(AK::SIMD::to_f32x4(load_i16x4(samples + i)) + level_shift, 0.0f, max_value);
+                            auto color = AK::SIMD::to_i32x4(shifted);
+                            if (context.frame.precision != 8)
+                                color >>= 4;
+                            store_i16x4(color, samples + i);
                         }
-                    }
+                    };
+
+                    level_shift_and_clamp(macroblocks[mb_index].r);
+                    level_shift_and_clamp(macroblocks[mb_index].g);
+                    level_shift_and_clamp(macroblocks[mb_index].b);
+                    level_shift_and_clamp(macroblocks[mb_index].k);
                 }
             }
         }
@@ -1591,17 +1760,40 @@ static void ycbcr_to_rgb(JPEGLoadingContext const& context, Vector<Macroblock>&
                     auto* cb = macroblocks[macroblock_index].cb;
                     auto* cr = macroblocks[macroblock_index].cr;
                     for (u8 i = 7; i < 8; --i) {
-                        for (u8 j = 7; j < 8; --j) {
-                            u8 const pixel = i * 8 + j;
-                            u32 const chroma_pxrow = (i / context.vsample_factor) + 4 * vfactor_i;
+                        u32 const chroma_pxrow = (i / context.vsample_factor) + 4 * vfactor_i;
+                        auto const chroma_pixel = [&](u8 j) {
                             u32 const chroma_pxcol = (j / context.hsample_factor) + 4 * hfactor_i;
-                            u32 const chroma_pixel = chroma_pxrow * 8 + chroma_pxcol;
-                            int r = y[pixel] + 1.402f * (chroma.cr[chroma_pixel] - 128);
-                            int g = y[pixel] - 0.3441f * (chroma.cb[chroma_pixel] - 128) - 0.7141f * (chroma.cr[chroma_pixel] - 128);
-                            int b = y[pixel] + 1.772f * (chroma.cb[chroma_pixel] - 128);
-                            y[pixel] = clamp(r, 0, 255);
-                            cb[pixel] = clamp(g, 0, 255);
-                            cr[pixel] = clamp(b, 0, 255);
+                            return chroma_pxrow * 8 + chroma_pxcol;
+                        };
+
+                        auto load_chroma = [&](i16 const* channel, u8 j) -> f32x4 {
+                            return f32x4 {
+                                static_cast<float>(channel[chroma_pixel(j)]),
+                                static_cast<float>(channel[chroma_pixel(j + 1)]),
+                                static_cast<float>(channel[chroma_pixel(j + 2)]),
+                                static_cast<float>(channel[chroma_pixel(j + 3)]),
+                            } - 128.0f;
+                        };
+
+                        // Read the whole row before writing it back, as the chroma block may be the one we're converting.
+                        f32x4 y_values[2];
+                        f32x4 cb_values[2];
+                        f32x4 cr_values[2];
+                        for (u8 half = 0; half < 2; ++half) {
+                            u8 const j = half * 4;
+                            y_values[half] = AK::SIMD::to_f32x4(load_i16x4(y + i * 8 + j));
+                            cb_values[half] = load_chroma(chroma.cb, j);
+                            cr_values[half] = load_chroma(chroma.cr, j);
+                        }
+
+                        for (u8 half = 0; half < 2; ++half) {
+                            u8 const pixel = i * 8 + half * 4;
+                            auto r = y_values[half] + 1.402f * cr_values[half];
+                            auto g = y_values[half] - 0.3441f * cb_values[half] - 0.7141f * cr_values[half];
+                            auto b = y_values[half] + 1.772f * cb_values[half];
+                            store_i16x4(AK::SIMD::to_i32x4(AK::SIMD::clamp(r, 0.0f, 255.0f)), y + pixel);
+                            store_i16x4(AK::SIMD::to_i32x4(AK::SIMD::clamp(g, 0.0f, 255.0f)), cb + pixel);
+                            store_i16x4(AK::SIMD::to_i32x4(AK::SIMD::clamp(b, 0.0f, 255.0f)), cr + pixel);
                         }
                     }
                 }
@@ -25,6 +25,10 @@ struct JPEGDecoderOptions {
         PDF,
     };
     CMYK cmyk { CMYK::Normal };
+
+    // Sequential scans with restart markers are split into independent restart
+    // intervals, which can then be decoded on several threads.
+    bool decode_restart_intervals_in_parallel { false };
 };
 
 class JPEGImageDecoderPlugin : public ImageDecoderPlugin {
@@ -75,7 +75,7 @@ u32 PNGChunk::crc()
 
 ErrorOr<void> PNGChunk::compress_and_add(ReadonlyBytes uncompressed_bytes)
 {
-    return add(TRY(Compress::ZlibCompressor::compress_all(uncompressed_bytes, Compress::ZlibCompressionLevel::Best)));
+    return add(TRY(Compress::ZlibCompressor::compress_all_parallel(uncompressed_bytes, Compress::ZlibCompressionLevel::Best)));
 }
 
 ErrorOr<void> PNGChunk::add(ReadonlyBytes bytes)
@@ -405,6 +405,14 @@ struct X86_64Assembler {
 
     void mov32(Operand dst, Operand src, Extension extension = Extension::ZeroExtend)
     {
+        if (dst.type == Operand::Type::Mem64BaseAndOffset && src.type == Operand::Type::Reg) {
+            // mov r/m32, r32
+            emit_rex_for_mr(dst, src, REX_W::No);
+            emit8(0x89);
+            emit_modrm_mr(dst, src);
+            return;
+        }
+
         VERIFY(dst.type == Operand::Type::Reg && src.is_register_or_memory());
         if (extension == Extension::ZeroExtend) {
             // mov r32, r/m32
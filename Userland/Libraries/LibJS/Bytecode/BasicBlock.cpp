@@ -51,6 +51,17 @@ void BasicBlock::dump(Bytecode::Executable const& executable) const
     }
 }
 
+Instruction const* BasicBlock::terminator() const
+{
+    if (!m_terminated)
+        return nullptr;
+
+    Instruction const* last_instruction = nullptr;
+    for (Bytecode::InstructionStreamIterator it(instruction_stream()); !it.at_end(); ++it)
+        last_instruction = &*it;
+    return last_instruction;
+}
+
 void BasicBlock::grow(size_t additional_size)
 {
     m_buffer.grow_capacity(m_buffer.size() + additional_size);
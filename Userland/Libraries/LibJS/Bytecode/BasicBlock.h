@@ -37,6 +37,7 @@ public:
 
     void terminate(Badge<Generator>) { m_terminated = true; }
     bool is_terminated() const { return m_terminated; }
+    Instruction const* terminator() const;
 
     String const& name() const { return m_name; }
 
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Debug.h>
 #include <LibJS/Bytecode/CommonImplementations.h>
 #include <LibJS/Bytecode/Interpreter.h>
 #include <LibJS/Bytecode/Op.h>
@@ -72,6 +73,59 @@ ThrowCompletionOr<NonnullGCPtr<Object>> base_object_for_get(VM& vm, Value base_v
     return base_value.to_object(vm);
 }
 
+// OPTIMIZATION: Property lookup caches remember where a property lives for each of the last few shapes seen at a call site.
+//               Call sites that have seen too many shapes for that fall back to the shared megamorphic cache.
+// NOTE: Unique shapes don't change identity, so we compare their serial numbers instead.
+static Optional<u32> find_cached_property_offset(VM& vm, PropertyLookupCache& cache, Shape const& shape, DeprecatedFlyString const& property_name)
+{
+    for (auto const& entry : cache.entries) {
+        if (&shape != entry.shape)
+            continue;
+        if (shape.is_unique() && shape.unique_shape_serial_number() != entry.unique_shape_serial_number)
+            break;
+        if constexpr (JS_BYTECODE_DEBUG)
+            ++cache.hit_count;
+        return entry.property_offset;
+    }
+
+    if (cache.is_megamorphic) {
+        if (auto property_offset = vm.bytecode_interpreter().megamorphic_property_lookup_cache().find(shape, property_name); property_offset.has_value()) {
+            if constexpr (JS_BYTECODE_DEBUG)
+                ++cache.hit_count;
+            return property_offset;
+        }
+    }
+
+    if constexpr (JS_BYTECODE_DEBUG)
+        ++cache.miss_count;
+    return {};
+}
+
+static void update_property_lookup_cache(VM& vm, PropertyLookupCache& cache, Shape& shape, DeprecatedFlyString const& property_name, u32 property_offset)
+{
+    PropertyLookupCache::Entry* entry_to_update = nullptr;
+    for (auto& entry : cache.entries) {
+        if (&shape == entry.shape) {
+            entry_to_update = &entry;
+            break;
+        }
+        // NOTE: Entries whose shape has been garbage collected can be reused.
+        if (!entry_to_update && entry.shape.is_null())
+            entry_to_update = &entry;
+    }
+
+    if (!entry_to_update) {
+        // This call site sees too many shapes to cache them all. Keep the ones we have instead of thrashing the cache.
+        cache.is_megamorphic = true;
+        vm.bytecode_interpreter().megamorphic_property_lookup_cache().update(shape, property_name, property_offset);
+        return;
+    }
+
+    entry_to_update->shape = shape;
+    entry_to_update->property_offset = property_offset;
+    entry_to_update->unique_shape_serial_number = shape.unique_shape_serial_number();
+}
+
 ThrowCompletionOr<Value> get_by_id(VM& vm, DeprecatedFlyString const& property, Value base_value, Value this_value, PropertyLookupCache& cache)
 {
     if (base_value.is_string()) {
@@ -82,22 +136,15 @@ ThrowCompletionOr<Value> get_by_id(VM& vm, DeprecatedFlyString const& property,
 
     auto base_obj = TRY(base_object_for_get(vm, base_value));
 
-    // OPTIMIZATION: If the shape of the object hasn't changed, we can use the cached property offset.
-    // NOTE: Unique shapes don't change identity, so we compare their serial numbers instead.
     auto& shape = base_obj->shape();
-    if (&shape == cache.shape
-        && (!shape.is_unique() || shape.unique_shape_serial_number() == cache.unique_shape_serial_number)) {
-        return base_obj->get_direct(cache.property_offset.value());
-    }
+    if (auto property_offset = find_cached_property_offset(vm, cache, shape, property); property_offset.has_value())
+        return base_obj->get_direct(property_offset.value());
 
     CacheablePropertyMetadata cacheable_metadata;
     auto value = TRY(base_obj->internal_get(property, this_value, &cacheable_metadata));
 
-    if (cacheable_metadata.type == CacheablePropertyMetadata::Type::OwnProperty) {
-        cache.shape = shape;
-        cache.property_offset = cacheable_metadata.property_offset.value();
-        cache.unique_shape_serial_number = shape.unique_shape_serial_number();
-    }
+    if (cacheable_metadata.type == CacheablePropertyMetadata::Type::OwnProperty)
+        update_property_lookup_cache(vm, cache, shape, property, cacheable_metadata.property_offset.value());
 
     return value;
 }
@@ -241,21 +288,19 @@ ThrowCompletionOr<void> put_by_property_key(VM& vm, Value base, Value this_value
         break;
     }
     case Op::PropertyKind::KeyValue: {
-        if (cache
-            && cache->shape == &object->shape()
-            && (!object->shape().is_unique() || object->shape().unique_shape_serial_number() == cache->unique_shape_serial_number)) {
-            object->put_direct(*cache->property_offset, value);
-            return {};
+        // NOTE: Only string keys are cached, which is all that PutById ever passes us along with a cache.
+        if (cache && name.is_string()) {
+            if (auto property_offset = find_cached_property_offset(vm, *cache, object->shape(), name.as_string()); property_offset.has_value()) {
+                object->put_direct(property_offset.value(), value);
+                return {};
+            }
         }
 
         CacheablePropertyMetadata cacheable_metadata;
         bool succeeded = TRY(object->internal_set(name, value, this_value, &cacheable_metadata));
 
-        if (succeeded && cache && cacheable_metadata.type == CacheablePropertyMetadata::Type::OwnProperty) {
-            cache->shape = object->shape();
-            cache->property_offset = cacheable_metadata.property_offset.value();
-            cache->unique_shape_serial_number = object->shape().unique_shape_serial_number();
-        }
+        if (succeeded && cache && name.is_string() && cacheable_metadata.type == CacheablePropertyMetadata::Type::OwnProperty)
+            update_property_lookup_cache(vm, *cache, object->shape(), name.as_string(), cacheable_metadata.property_offset.value());
 
         if (!succeeded && vm.in_strict_mode()) {
             if (base.is_object())
@@ -396,6 +441,7 @@ ThrowCompletionOr<void> put_by_value(VM& vm, Value base, Value property_key_valu
             auto existing_value = storage->get(index)->value;
             if (!existing_value.is_accessor()) {
                 storage->put(index, value);
+                object.write_barrier(value);
                 return {};
             }
         }
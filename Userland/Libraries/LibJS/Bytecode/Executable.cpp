@@ -9,6 +9,7 @@
 #include <LibJS/Bytecode/RegexTable.h>
 #include <LibJS/JIT/Compiler.h>
 #include <LibJS/JIT/NativeExecutable.h>
+#include <LibJS/Runtime/Shape.h>
 #include <LibJS/SourceCode.h>
 
 namespace JS::Bytecode {
@@ -56,6 +57,59 @@ void Executable::dump() const
     }
 }
 
+void Executable::dump_property_lookup_cache_statistics() const
+{
+    u64 total_hit_count = 0;
+    u64 total_miss_count = 0;
+    size_t megamorphic_cache_count = 0;
+
+    for (size_t i = 0; i < property_lookup_caches.size(); ++i) {
+        auto const& cache = property_lookup_caches[i];
+        if (cache.hit_count == 0 && cache.miss_count == 0)
+            continue;
+
+        size_t entry_count = 0;
+        for (auto const& entry : cache.entries) {
+            if (!entry.shape.is_null())
+                ++entry_count;
+        }
+
+        dbgln("Property lookup cache {}: {} hits, {} misses, {} shapes{}", i, cache.hit_count, cache.miss_count, entry_count, cache.is_megamorphic ? " (megamorphic)"sv : ""sv);
+        total_hit_count += cache.hit_count;
+        total_miss_count += cache.miss_count;
+        if (cache.is_megamorphic)
+            ++megamorphic_cache_count;
+    }
+
+    dbgln("Property lookup caches of {}: {} hits, {} misses, {} of {} megamorphic", name, total_hit_count, total_miss_count, megamorphic_cache_count, property_lookup_caches.size());
+}
+
+size_t MegamorphicPropertyLookupCache::index_for(Shape const& shape, DeprecatedFlyString const& property_name)
+{
+    static_assert(is_power_of_two(number_of_entries));
+    return pair_int_hash(ptr_hash(&shape), property_name.hash()) & (number_of_entries - 1);
+}
+
+// NOTE: Unique shapes don't change identity, so we compare their serial numbers as well.
+Optional<u32> MegamorphicPropertyLookupCache::find(Shape const& shape, DeprecatedFlyString const& property_name) const
+{
+    auto const& entry = m_entries[index_for(shape, property_name)];
+    if (&shape != entry.shape || property_name != entry.property_name)
+        return {};
+    if (shape.is_unique() && shape.unique_shape_serial_number() != entry.unique_shape_serial_number)
+        return {};
+    return entry.property_offset;
+}
+
+void MegamorphicPropertyLookupCache::update(Shape& shape, DeprecatedFlyString const& property_name, u32 property_offset)
+{
+    auto& entry = m_entries[index_for(shape, property_name)];
+    entry.shape = shape;
+    entry.property_name = property_name;
+    entry.property_offset = property_offset;
+    entry.unique_shape_serial_number = shape.unique_shape_serial_number();
+}
+
 JIT::NativeExecutable const* Executable::get_or_create_native_executable()
 {
     if (!m_did_try_jitting) {
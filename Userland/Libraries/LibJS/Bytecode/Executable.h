@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/DeprecatedFlyString.h>
 #include <AK/HashMap.h>
 #include <AK/NonnullOwnPtr.h>
@@ -26,16 +27,51 @@ class NativeExecutable;
 namespace JS::Bytecode {
 
 struct PropertyLookupCache {
-    static FlatPtr shape_offset() { return OFFSET_OF(PropertyLookupCache, shape); }
-    static FlatPtr property_offset_offset() { return OFFSET_OF(PropertyLookupCache, property_offset); }
-    static FlatPtr unique_shape_serial_number_offset() { return OFFSET_OF(PropertyLookupCache, unique_shape_serial_number); }
+    struct Entry {
+        static FlatPtr shape_offset() { return OFFSET_OF(Entry, shape); }
+        static FlatPtr property_offset_offset() { return OFFSET_OF(Entry, property_offset); }
+        static FlatPtr unique_shape_serial_number_offset() { return OFFSET_OF(Entry, unique_shape_serial_number); }
 
-    WeakPtr<Shape> shape;
-    Optional<u32> property_offset;
-    u64 unique_shape_serial_number { 0 };
+        WeakPtr<Shape> shape;
+        Optional<u32> property_offset;
+        u64 unique_shape_serial_number { 0 };
+    };
+
+    // NOTE: Call sites that see more shapes than this are considered megamorphic. They keep the shapes they have, and
+    //       fall back to the interpreter's MegamorphicPropertyLookupCache for everything else.
+    static constexpr size_t max_number_of_entries = 4;
+
+    static FlatPtr entry_offset(size_t index) { return OFFSET_OF(PropertyLookupCache, entries) + index * sizeof(Entry); }
+    static FlatPtr hit_count_offset() { return OFFSET_OF(PropertyLookupCache, hit_count); }
+
+    AK::Array<Entry, max_number_of_entries> entries;
+    bool is_megamorphic { false };
+
+    // NOTE: These are only counted with JS_BYTECODE_DEBUG.
+    u64 hit_count { 0 };
+    u64 miss_count { 0 };
+};
+
+// A cache shared by all megamorphic call sites, indexed by both shape and property name. Each slot only remembers the
+// last shape and name that hashed to it.
+class MegamorphicPropertyLookupCache {
+public:
+    Optional<u32> find(Shape const&, DeprecatedFlyString const& property_name) const;
+    void update(Shape&, DeprecatedFlyString const& property_name, u32 property_offset);
+
+private:
+    static constexpr size_t number_of_entries = 1024;
+
+    struct Entry : public PropertyLookupCache::Entry {
+        DeprecatedFlyString property_name;
+    };
+
+    static size_t index_for(Shape const&, DeprecatedFlyString const& property_name);
+
+    AK::Array<Entry, number_of_entries> m_entries;
 };
 
-struct GlobalVariableCache : public PropertyLookupCache {
+struct GlobalVariableCache : public PropertyLookupCache::Entry {
     static FlatPtr environment_serial_number_offset() { return OFFSET_OF(GlobalVariableCache, environment_serial_number); }
 
     u64 environment_serial_number { 0 };
@@ -84,6 +120,7 @@ public:
     DeprecatedFlyString const& get_identifier(IdentifierTableIndex index) const { return identifier_table->get(index); }
 
     void dump() const;
+    void dump_property_lookup_cache_statistics() const;
 
     JIT::NativeExecutable const* get_or_create_native_executable();
     JIT::NativeExecutable const* native_executable() const { return m_native_executable; }
@@ -9,7 +9,9 @@
 #include <LibJS/Bytecode/BasicBlock.h>
 #include <LibJS/Bytecode/Generator.h>
 #include <LibJS/Bytecode/Instruction.h>
+#include <LibJS/Bytecode/Interpreter.h>
 #include <LibJS/Bytecode/Op.h>
+#include <LibJS/Bytecode/PassManager.h>
 #include <LibJS/Bytecode/Register.h>
 #include <LibJS/Runtime/VM.h>
 
@@ -22,6 +24,19 @@ Generator::Generator()
 {
 }
 
+static PassManager& optimization_pipeline()
+{
+    static auto pass_manager = [] {
+        auto pass_manager = make<PassManager>();
+        pass_manager->add<Passes::FoldConstantBranches>();
+        pass_manager->add<Passes::ThreadJumps>();
+        pass_manager->add<Passes::GenerateCFG>();
+        pass_manager->add<Passes::EliminateUnreachableBlocks>();
+        return pass_manager;
+    }();
+    return *pass_manager;
+}
+
 CodeGenerationErrorOr<NonnullGCPtr<Executable>> Generator::generate(VM& vm, ASTNode const& node, FunctionKind enclosing_function_kind)
 {
     Generator generator;
@@ -70,6 +85,9 @@ CodeGenerationErrorOr<NonnullGCPtr<Executable>> Generator::generate(VM& vm, ASTN
         move(generator.m_root_basic_blocks),
         is_strict_mode);
 
+    if (!g_disable_bytecode_optimizations)
+        optimization_pipeline().perform(*executable);
+
     return executable;
 }
 
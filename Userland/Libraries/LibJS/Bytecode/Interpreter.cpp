@@ -40,6 +40,7 @@
 namespace JS::Bytecode {
 
 bool g_dump_bytecode = false;
+bool g_disable_bytecode_optimizations = false;
 
 NonnullOwnPtr<CallFrame> CallFrame::create(size_t register_count)
 {
@@ -118,7 +119,14 @@ ThrowCompletionOr<Value> Interpreter::run(Script& script_record, JS::GCPtr<Envir
 
     // 13. If result.[[Type]] is normal, then
     if (result.type() == Completion::Type::Normal) {
-        auto executable_result = JS::Bytecode::Generator::generate(vm, script);
+        // NOTE: The parse tree may be shared with earlier loads of the same script (see ScriptCache), in which case it already has bytecode.
+        auto executable_result = [&]() -> CodeGenerationErrorOr<NonnullGCPtr<Executable>> {
+            if (auto* executable = script.bytecode_executable())
+                return NonnullGCPtr { *executable };
+            auto executable = TRY(JS::Bytecode::Generator::generate(vm, script));
+            const_cast<Program&>(script).set_bytecode_executable(executable);
+            return executable;
+        }();
 
         if (executable_result.is_error()) {
             if (auto error_string = executable_result.error().to_string(); error_string.is_error())
@@ -400,6 +408,7 @@ Interpreter::ValueAndFrame Interpreter::run_and_return_frame(Executable& executa
                 value_string = registers()[i].to_string_without_side_effects();
             dbgln("[{:3}] {}", i, value_string);
         }
+        executable.dump_property_lookup_cache_statistics();
     }
 
     auto return_value = js_undefined();
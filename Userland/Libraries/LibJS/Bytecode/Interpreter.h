@@ -95,6 +95,8 @@ public:
 
     void visit_edges(Cell::Visitor&);
 
+    MegamorphicPropertyLookupCache& megamorphic_property_lookup_cache() { return m_megamorphic_property_lookup_cache; }
+
     Span<Value> registers() { return m_current_call_frame; }
     ReadonlySpan<Value> registers() const { return m_current_call_frame; }
 
@@ -121,9 +123,11 @@ private:
     Executable* m_current_executable { nullptr };
     BasicBlock const* m_current_block { nullptr };
     Optional<InstructionStreamIterator&> m_pc {};
+    MegamorphicPropertyLookupCache m_megamorphic_property_lookup_cache;
 };
 
 extern bool g_dump_bytecode;
+extern bool g_disable_bytecode_optimizations;
 
 ThrowCompletionOr<NonnullGCPtr<Bytecode::Executable>> compile(VM&, ASTNode const& no, JS::FunctionKind kind, DeprecatedFlyString const& name);
 
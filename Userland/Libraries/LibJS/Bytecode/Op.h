@@ -960,6 +960,12 @@ public:
     auto& true_target() const { return m_true_target; }
     auto& false_target() const { return m_false_target; }
 
+    void set_targets(Optional<Label> true_target, Optional<Label> false_target)
+    {
+        m_true_target = move(true_target);
+        m_false_target = move(false_target);
+    }
+
 protected:
     Optional<Label> m_true_target;
     Optional<Label> m_false_target;
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <LibJS/Bytecode/PassManager.h>
+
+namespace JS::Bytecode::Passes {
+
+void EliminateUnreachableBlocks::perform(PassPipelineExecutable& executable)
+{
+    VERIFY(executable.cfg.has_value());
+
+    auto& basic_blocks = executable.executable.basic_blocks;
+    if (basic_blocks.is_empty())
+        return;
+
+    // The first block is always the entry point; everything else has to be reachable from it.
+    HashTable<BasicBlock const*> reachable_blocks;
+    Vector<BasicBlock const*> work_list;
+    work_list.append(basic_blocks.first().ptr());
+    reachable_blocks.set(basic_blocks.first().ptr());
+
+    while (!work_list.is_empty()) {
+        auto const* block = work_list.take_last();
+        for (auto const* successor : executable.cfg->get(block).value()) {
+            if (reachable_blocks.set(successor) == HashSetResult::InsertedNewEntry)
+                work_list.append(successor);
+        }
+    }
+
+    auto removed_block_count = basic_blocks.size() - reachable_blocks.size();
+    basic_blocks.remove_all_matching([&](auto const& block) {
+        return !reachable_blocks.contains(block.ptr());
+    });
+
+    if (removed_block_count > 0) {
+        // The removed blocks may still appear in the graph, so it has to be regenerated before it's used again.
+        executable.cfg.clear();
+        executable.inverted_cfg.clear();
+    }
+
+    dbgln_if(JS_BYTECODE_DEBUG, "EliminateUnreachableBlocks: Removed {} blocks from {}", removed_block_count, executable.executable.name);
+}
+
+}
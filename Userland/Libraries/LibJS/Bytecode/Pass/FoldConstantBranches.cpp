@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/Bytecode/PassManager.h>
+#include <LibJS/Runtime/ValueInlines.h>
+
+namespace JS::Bytecode::Passes {
+
+// All jumps share the storage layout of Op::Jump, which lets us rewrite them in place.
+static_assert(sizeof(Op::JumpConditional) == sizeof(Op::Jump));
+static_assert(sizeof(Op::JumpNullish) == sizeof(Op::Jump));
+static_assert(sizeof(Op::JumpUndefined) == sizeof(Op::Jump));
+
+static Optional<bool> evaluate_constant_branch(Instruction const& jump, Value value)
+{
+    switch (jump.type()) {
+    case Instruction::Type::JumpConditional:
+        return value.to_boolean();
+    case Instruction::Type::JumpNullish:
+        return value.is_nullish();
+    case Instruction::Type::JumpUndefined:
+        return value.is_undefined();
+    default:
+        return {};
+    }
+}
+
+void FoldConstantBranches::perform(PassPipelineExecutable& executable)
+{
+    size_t folded_branch_count = 0;
+
+    for (auto& block : executable.executable.basic_blocks) {
+        Instruction const* previous_instruction = nullptr;
+        Instruction const* last_instruction = nullptr;
+        for (InstructionStreamIterator it(block->instruction_stream()); !it.at_end(); ++it) {
+            previous_instruction = last_instruction;
+            last_instruction = &*it;
+        }
+
+        if (!block->is_terminated() || !last_instruction)
+            continue;
+
+        auto type = last_instruction->type();
+        if (type != Instruction::Type::JumpConditional && type != Instruction::Type::JumpNullish && type != Instruction::Type::JumpUndefined)
+            continue;
+
+        auto const& jump = static_cast<Op::Jump const&>(*last_instruction);
+        Optional<Label> target;
+
+        // The accumulator was loaded with a constant right before the branch, so its outcome is fixed.
+        if (previous_instruction && previous_instruction->type() == Instruction::Type::LoadImmediate) {
+            auto value = static_cast<Op::LoadImmediate const&>(*previous_instruction).value();
+            if (auto taken = evaluate_constant_branch(jump, value); taken.has_value())
+                target = taken.value() ? jump.true_target() : jump.false_target();
+        }
+
+        // Both arms lead to the same place, so the test itself doesn't matter.
+        if (!target.has_value() && &jump.true_target()->block() == &jump.false_target()->block())
+            target = jump.true_target();
+
+        if (!target.has_value())
+            continue;
+
+        auto source_record = jump.source_record();
+        auto& mutable_jump = const_cast<Instruction&>(*last_instruction);
+        Instruction::destroy(mutable_jump);
+        auto* folded_jump = new (&mutable_jump) Op::Jump(target.release_value());
+        folded_jump->set_source_record(source_record);
+        ++folded_branch_count;
+    }
+
+    dbgln_if(JS_BYTECODE_DEBUG, "FoldConstantBranches: Folded {} branches in {}", folded_branch_count, executable.executable.name);
+}
+
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/Bytecode/PassManager.h>
+
+namespace JS::Bytecode::Passes {
+
+static void for_each_successor(BasicBlock const& block, Function<void(BasicBlock const&)> const& callback)
+{
+    if (auto const* handler = block.handler())
+        callback(*handler);
+    if (auto const* finalizer = block.finalizer())
+        callback(*finalizer);
+
+    auto const* terminator = block.terminator();
+    if (!terminator)
+        return;
+
+    switch (terminator->type()) {
+    case Instruction::Type::Jump:
+    case Instruction::Type::JumpConditional:
+    case Instruction::Type::JumpNullish:
+    case Instruction::Type::JumpUndefined: {
+        auto const& jump = static_cast<Op::Jump const&>(*terminator);
+        if (jump.true_target().has_value())
+            callback(jump.true_target()->block());
+        if (jump.false_target().has_value())
+            callback(jump.false_target()->block());
+        break;
+    }
+    case Instruction::Type::EnterUnwindContext:
+        callback(static_cast<Op::EnterUnwindContext const&>(*terminator).entry_point().block());
+        break;
+    case Instruction::Type::ContinuePendingUnwind:
+        callback(static_cast<Op::ContinuePendingUnwind const&>(*terminator).resume_target().block());
+        break;
+    case Instruction::Type::ScheduleJump:
+        callback(static_cast<Op::ScheduleJump const&>(*terminator).target().block());
+        break;
+    case Instruction::Type::Yield:
+        if (auto const& continuation = static_cast<Op::Yield const&>(*terminator).continuation(); continuation.has_value())
+            callback(continuation->block());
+        break;
+    case Instruction::Type::Await:
+        callback(static_cast<Op::Await const&>(*terminator).continuation().block());
+        break;
+    default:
+        break;
+    }
+}
+
+void GenerateCFG::perform(PassPipelineExecutable& executable)
+{
+    HashMap<BasicBlock const*, HashTable<BasicBlock const*>> cfg;
+    HashMap<BasicBlock const*, HashTable<BasicBlock const*>> inverted_cfg;
+
+    for (auto const& block : executable.executable.basic_blocks) {
+        auto& successors = cfg.ensure(block.ptr());
+        inverted_cfg.ensure(block.ptr());
+        for_each_successor(*block, [&](BasicBlock const& successor) {
+            successors.set(&successor);
+            inverted_cfg.ensure(&successor).set(block.ptr());
+        });
+    }
+
+    executable.cfg = move(cfg);
+    executable.inverted_cfg = move(inverted_cfg);
+}
+
+}
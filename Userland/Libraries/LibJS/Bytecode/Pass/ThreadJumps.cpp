@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/Bytecode/PassManager.h>
+
+namespace JS::Bytecode::Passes {
+
+// If the block does nothing but jump somewhere else unconditionally, returns that destination.
+static BasicBlock const* trampoline_destination(BasicBlock const& block)
+{
+    // A jump can't throw, but the interpreter consults these when leaving the block, so leave such blocks alone.
+    if (block.handler() || block.finalizer())
+        return nullptr;
+
+    InstructionStreamIterator it(block.instruction_stream());
+    if (it.at_end() || (*it).type() != Instruction::Type::Jump)
+        return nullptr;
+
+    auto const& jump = static_cast<Op::Jump const&>(*it);
+    if (jump.false_target().has_value())
+        return nullptr;
+    return &jump.true_target()->block();
+}
+
+static BasicBlock const& resolve_target(BasicBlock const& block, size_t block_count)
+{
+    // Bound the walk by the number of blocks, so a cycle of trampolines (e.g. `for (;;) {}`) terminates.
+    auto const* destination = &block;
+    for (size_t i = 0; i < block_count; ++i) {
+        auto const* next = trampoline_destination(*destination);
+        if (!next || next == destination)
+            break;
+        destination = next;
+    }
+    return *destination;
+}
+
+void ThreadJumps::perform(PassPipelineExecutable& executable)
+{
+    auto& basic_blocks = executable.executable.basic_blocks;
+    size_t threaded_jump_count = 0;
+
+    for (auto& block : basic_blocks) {
+        auto const* terminator = block->terminator();
+        if (!terminator)
+            continue;
+
+        auto type = terminator->type();
+        if (type != Instruction::Type::Jump && type != Instruction::Type::JumpConditional && type != Instruction::Type::JumpNullish && type != Instruction::Type::JumpUndefined)
+            continue;
+
+        auto& jump = const_cast<Op::Jump&>(static_cast<Op::Jump const&>(*terminator));
+        auto thread = [&](Optional<Label> const& target) -> Optional<Label> {
+            if (!target.has_value())
+                return {};
+            auto const& destination = resolve_target(target->block(), basic_blocks.size());
+            if (&destination == &target->block())
+                return target;
+            ++threaded_jump_count;
+            return Label { destination };
+        };
+
+        jump.set_targets(thread(jump.true_target()), thread(jump.false_target()));
+    }
+
+    dbgln_if(JS_BYTECODE_DEBUG, "ThreadJumps: Threaded {} jumps in {}", threaded_jump_count, executable.executable.name);
+}
+
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/HashTable.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Vector.h>
+#include <LibJS/Bytecode/BasicBlock.h>
+#include <LibJS/Bytecode/Executable.h>
+
+namespace JS::Bytecode {
+
+struct PassPipelineExecutable {
+    Executable& executable;
+
+    // Every block maps to the blocks control can move to from it, including exception handlers,
+    // finalizers and generator continuations. Passes that change control flow invalidate this.
+    Optional<HashMap<BasicBlock const*, HashTable<BasicBlock const*>>> cfg {};
+    Optional<HashMap<BasicBlock const*, HashTable<BasicBlock const*>>> inverted_cfg {};
+};
+
+class Pass {
+public:
+    Pass() = default;
+    virtual ~Pass() = default;
+
+    virtual StringView name() const = 0;
+    virtual void perform(PassPipelineExecutable&) = 0;
+};
+
+class PassManager : public Pass {
+public:
+    PassManager() = default;
+    ~PassManager() override = default;
+
+    void add(NonnullOwnPtr<Pass> pass) { m_passes.append(move(pass)); }
+
+    template<typename PassT, typename... Args>
+    void add(Args&&... args) { m_passes.append(make<PassT>(forward<Args>(args)...)); }
+
+    StringView name() const override { return "PassManager"sv; }
+
+    void perform(Executable& executable)
+    {
+        PassPipelineExecutable pipeline_executable { executable };
+        perform(pipeline_executable);
+    }
+
+    void perform(PassPipelineExecutable& executable) override
+    {
+        for (auto& pass : m_passes)
+            pass->perform(executable);
+    }
+
+private:
+    Vector<NonnullOwnPtr<Pass>> m_passes;
+};
+
+namespace Passes {
+
+class GenerateCFG final : public Pass {
+public:
+    StringView name() const override { return "GenerateCFG"sv; }
+    void perform(PassPipelineExecutable&) override;
+};
+
+// Turns conditional jumps whose outcome is known at compile time into unconditional jumps,
+// e.g. the test of `while (true)` or `if (0)`.
+class FoldConstantBranches final : public Pass {
+public:
+    StringView name() const override { return "FoldConstantBranches"sv; }
+    void perform(PassPipelineExecutable&) override;
+};
+
+// Retargets jumps that land on a block consisting of nothing but another unconditional jump.
+class ThreadJumps final : public Pass {
+public:
+    StringView name() const override { return "ThreadJumps"sv; }
+    void perform(PassPipelineExecutable&) override;
+};
+
+// Removes every block that cannot be reached from the entry block. Requires the CFG.
+class EliminateUnreachableBlocks final : public Pass {
+public:
+    StringView name() const override { return "EliminateUnreachableBlocks"sv; }
+    void perform(PassPipelineExecutable&) override;
+};
+
+}
+
+}
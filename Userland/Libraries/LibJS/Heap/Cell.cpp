@@ -15,6 +15,11 @@ void JS::Cell::initialize(JS::Realm&)
 {
 }
 
+void JS::Cell::remember()
+{
+    heap().remember_cell({}, *this);
+}
+
 void JS::Cell::Visitor::visit(JS::Value value)
 {
     if (value.is_cell())
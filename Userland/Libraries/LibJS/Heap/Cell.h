@@ -26,6 +26,12 @@ public:                                            \
     }                                              \
     friend class JS::Heap;
 
+// Cells whose every store of a reference to another cell goes through Cell::write_barrier() can declare this,
+// which lets the garbage collector skip them during young generation collections unless they've been written to.
+// NOTE: This is not inherited by subclasses, since they may have edges of their own.
+#define JS_CELL_HAS_WRITE_BARRIERS(ClassName) \
+    using WriteBarrieredCellType = ClassName;
+
 class Cell {
     AK_MAKE_NONCOPYABLE(Cell);
     AK_MAKE_NONMOVABLE(Cell);
@@ -45,6 +51,38 @@ public:
     State state() const { return m_state; }
     void set_state(State state) { m_state = state; }
 
+    enum class Generation : u8 {
+        // Allocated since the last garbage collection.
+        Young,
+        // Survived a garbage collection, and holds no references to young cells.
+        Old,
+        // Survived a garbage collection, and may hold references to young cells.
+        Remembered,
+    };
+
+    Generation generation() const { return m_generation; }
+    void set_generation(Badge<Heap>, Generation generation) { m_generation = generation; }
+
+    static FlatPtr generation_offset() { return OFFSET_OF(Cell, m_generation); }
+
+    bool has_write_barriers(Badge<Heap>) const { return m_has_write_barriers; }
+    void set_has_write_barriers(Badge<Heap>) { m_has_write_barriers = true; }
+
+    // Must be called after storing a reference to `value` in a cell that declares JS_CELL_HAS_WRITE_BARRIERS.
+    ALWAYS_INLINE void write_barrier(Cell const* value)
+    {
+        if (m_generation == Generation::Old && value && value->m_generation == Generation::Young) [[unlikely]]
+            remember();
+    }
+
+    template<typename T>
+    requires(IsSame<T, Value>)
+    ALWAYS_INLINE void write_barrier(T const& value)
+    {
+        if (value.is_cell())
+            write_barrier(&value.as_cell());
+    }
+
     virtual StringView class_name() const = 0;
 
     class Visitor {
@@ -110,9 +148,13 @@ protected:
     void set_overrides_must_survive_garbage_collection(bool b) { m_overrides_must_survive_garbage_collection = b; }
 
 private:
+    void remember();
+
     bool m_mark : 1 { false };
     bool m_overrides_must_survive_garbage_collection : 1 { false };
     State m_state : 1 { State::Live };
+    bool m_has_write_barriers : 1 { false };
+    Generation m_generation { Generation::Young };
 };
 
 }
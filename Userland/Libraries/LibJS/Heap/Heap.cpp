@@ -75,9 +75,9 @@ void Heap::will_allocate(size_t size)
     if (should_collect_on_every_allocation()) {
         m_allocated_bytes_since_last_gc = 0;
         collect_garbage();
-    } else if (m_allocated_bytes_since_last_gc + size > m_gc_bytes_threshold) {
+    } else if (m_allocated_bytes_since_last_gc + size > GC_YOUNG_GENERATION_BYTES_THRESHOLD) {
         m_allocated_bytes_since_last_gc = 0;
-        collect_garbage();
+        collect_garbage(CollectionType::CollectYoungGeneration);
     }
 
     m_allocated_bytes_since_last_gc += size;
@@ -277,17 +277,23 @@ void Heap::collect_garbage(CollectionType collection_type, bool print_report)
     if (print_report)
         collection_measurement_timer.start();
 
-    if (collection_type == CollectionType::CollectGarbage) {
+    if (collection_type != CollectionType::CollectEverything) {
         if (m_gc_deferrals) {
-            m_should_gc_when_deferral_ends = true;
+            if (m_collection_when_deferral_ends != CollectionType::CollectGarbage)
+                m_collection_when_deferral_ends = collection_type;
             return;
         }
+
+        // Once enough cells have made it into the old generation, it's time to look for garbage there too.
+        if (collection_type == CollectionType::CollectYoungGeneration && m_promoted_bytes_since_last_full_gc >= m_gc_bytes_threshold)
+            collection_type = CollectionType::CollectGarbage;
+
         HashMap<Cell*, HeapRoot> roots;
         gather_roots(roots);
-        mark_live_cells(roots);
+        mark_live_cells(roots, collection_type);
     }
-    finalize_unmarked_cells();
-    sweep_dead_cells(print_report, collection_measurement_timer);
+    finalize_unmarked_cells(collection_type);
+    sweep_dead_cells(print_report, collection_measurement_timer, collection_type);
 }
 
 void Heap::gather_roots(HashMap<Cell*, HeapRoot>& roots)
@@ -387,8 +393,9 @@ __attribute__((no_sanitize("address"))) void Heap::gather_conservative_roots(Has
 
 class MarkingVisitor final : public Cell::Visitor {
 public:
-    explicit MarkingVisitor(Heap& heap, HashMap<Cell*, HeapRoot> const& roots)
+    MarkingVisitor(Heap& heap, HashMap<Cell*, HeapRoot> const& roots, bool young_generation_only)
         : m_heap(heap)
+        , m_young_generation_only(young_generation_only)
     {
         m_heap.find_min_and_max_block_addresses(m_min_block_address, m_max_block_address);
         m_heap.for_each_block([&](auto& block) {
@@ -405,6 +412,10 @@ public:
     {
         if (cell.is_marked())
             return;
+        // NOTE: Old cells are not collected by young generation collections, and any young cells they point to are
+        //       reachable from the remembered set, so there's no need to look inside them.
+        if (m_young_generation_only && cell.generation() != Cell::Generation::Young)
+            return;
         dbgln_if(HEAP_DEBUG, "  ! {}", &cell);
 
         cell.set_marked(true);
@@ -424,6 +435,8 @@ public:
                 return;
             if (cell->state() != Cell::State::Live)
                 return;
+            if (m_young_generation_only && cell->generation() != Cell::Generation::Young)
+                return;
             cell->set_marked(true);
             m_work_queue.append(*cell);
         });
@@ -438,29 +451,41 @@ public:
 
 private:
     Heap& m_heap;
+    bool m_young_generation_only { false };
     Vector<Cell&> m_work_queue;
     HashTable<HeapBlock*> m_all_live_heap_blocks;
     FlatPtr m_min_block_address;
     FlatPtr m_max_block_address;
 };
 
-void Heap::mark_live_cells(HashMap<Cell*, HeapRoot> const& roots)
+void Heap::mark_live_cells(HashMap<Cell*, HeapRoot> const& roots, CollectionType collection_type)
 {
     dbgln_if(HEAP_DEBUG, "mark_live_cells:");
 
-    MarkingVisitor visitor(*this, roots);
+    bool young_generation_only = collection_type == CollectionType::CollectYoungGeneration;
+    MarkingVisitor visitor(*this, roots, young_generation_only);
 
     for (auto& execution_context : m_execution_contexts)
         execution_context.visit_edges(visitor);
 
     vm().bytecode_interpreter().visit_edges(visitor);
 
+    if (young_generation_only) {
+        for (auto* cell : m_remembered_cells)
+            cell->visit_edges(visitor);
+        for (auto* cell : m_old_cells_without_write_barriers)
+            cell->visit_edges(visitor);
+    }
+
     visitor.mark_all_live_cells();
 
-    for (auto& inverse_root : m_uprooted_cells)
+    // NOTE: Uprooted old cells can only be collected by a full collection, so we hold on to them until then.
+    m_uprooted_cells.remove_all_matching([&](auto& inverse_root) {
+        if (young_generation_only && inverse_root->generation() != Cell::Generation::Young)
+            return false;
         inverse_root->set_marked(false);
-
-    m_uprooted_cells.clear();
+        return true;
+    });
 }
 
 bool Heap::cell_must_survive_garbage_collection(Cell const& cell)
@@ -470,18 +495,40 @@ bool Heap::cell_must_survive_garbage_collection(Cell const& cell)
     return cell.must_survive_garbage_collection();
 }
 
-void Heap::finalize_unmarked_cells()
+bool Heap::cell_is_collected_by(Cell const& cell, CollectionType collection_type)
+{
+    if (collection_type == CollectionType::CollectYoungGeneration && cell.generation() != Cell::Generation::Young)
+        return false;
+    return !cell.is_marked() && !cell_must_survive_garbage_collection(cell);
+}
+
+void Heap::finalize_unmarked_cells(CollectionType collection_type)
 {
     for_each_block([&](auto& block) {
-        block.template for_each_cell_in_state<Cell::State::Live>([](Cell* cell) {
-            if (!cell->is_marked() && !cell_must_survive_garbage_collection(*cell))
+        if (collection_type == CollectionType::CollectYoungGeneration && !block.has_young_cells())
+            return IterationDecision::Continue;
+        block.template for_each_cell_in_state<Cell::State::Live>([&](Cell* cell) {
+            if (cell_is_collected_by(*cell, collection_type))
                 cell->finalize();
         });
         return IterationDecision::Continue;
     });
 }
 
-void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measurement_timer)
+void Heap::promote_cell(Cell& cell)
+{
+    // NOTE: Every cell that survives a collection is promoted, and so is everything it points to.
+    //       Cells without write barriers can't tell us when they start pointing to young cells,
+    //       so they're treated as remembered for as long as they live.
+    if (cell.has_write_barriers({})) {
+        cell.set_generation({}, Cell::Generation::Old);
+    } else {
+        cell.set_generation({}, Cell::Generation::Remembered);
+        m_old_cells_without_write_barriers.append(&cell);
+    }
+}
+
+void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measurement_timer, CollectionType collection_type)
 {
     dbgln_if(HEAP_DEBUG, "sweep_dead_cells:");
     Vector<HeapBlock*, 32> empty_blocks;
@@ -491,22 +538,45 @@ void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measure
     size_t live_cells = 0;
     size_t collected_cell_bytes = 0;
     size_t live_cell_bytes = 0;
+    size_t promoted_cell_bytes = 0;
+
+    bool young_generation_only = collection_type == CollectionType::CollectYoungGeneration;
+
+    // Everything that survives is about to become old, so no old cell points to a young one anymore.
+    // The remembered cells will tell us again if they start to.
+    for (auto* cell : m_remembered_cells)
+        cell->set_generation({}, Cell::Generation::Old);
+    m_remembered_cells.clear();
+
+    // A full collection promotes every live cell again, which puts the ones without write barriers back in here.
+    if (!young_generation_only)
+        m_old_cells_without_write_barriers.clear();
 
     for_each_block([&](auto& block) {
+        if (young_generation_only && !block.has_young_cells())
+            return IterationDecision::Continue;
+        block.clear_has_young_cells({});
+
         bool block_has_live_cells = false;
         bool block_was_full = block.is_full();
         block.template for_each_cell_in_state<Cell::State::Live>([&](Cell* cell) {
-            if (!cell->is_marked() && !cell_must_survive_garbage_collection(*cell)) {
+            if (cell_is_collected_by(*cell, collection_type)) {
                 dbgln_if(HEAP_DEBUG, "  ~ {}", cell);
                 block.deallocate(cell);
                 ++collected_cells;
                 collected_cell_bytes += block.cell_size();
-            } else {
-                cell->set_marked(false);
-                block_has_live_cells = true;
-                ++live_cells;
-                live_cell_bytes += block.cell_size();
+                return;
+            }
+            if (cell->generation() == Cell::Generation::Young) {
+                promote_cell(*cell);
+                promoted_cell_bytes += block.cell_size();
+            } else if (!young_generation_only) {
+                promote_cell(*cell);
             }
+            cell->set_marked(false);
+            block_has_live_cells = true;
+            ++live_cells;
+            live_cell_bytes += block.cell_size();
         });
         if (!block_has_live_cells)
             empty_blocks.append(&block);
@@ -535,7 +605,12 @@ void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measure
         });
     }
 
-    m_gc_bytes_threshold = live_cell_bytes > GC_MIN_BYTES_THRESHOLD ? live_cell_bytes : GC_MIN_BYTES_THRESHOLD;
+    if (young_generation_only) {
+        m_promoted_bytes_since_last_full_gc += promoted_cell_bytes;
+    } else {
+        m_gc_bytes_threshold = live_cell_bytes > GC_MIN_BYTES_THRESHOLD ? live_cell_bytes : GC_MIN_BYTES_THRESHOLD;
+        m_promoted_bytes_since_last_full_gc = 0;
+    }
 
     if (print_report) {
         Duration const time_spent = measurement_timer.elapsed_time();
@@ -547,11 +622,14 @@ void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measure
 
         dbgln("Garbage collection report");
         dbgln("=============================================");
+        dbgln("Collection type: {}", young_generation_only ? "Young generation"sv : "Full"sv);
         dbgln("     Time spent: {} ms", time_spent.to_milliseconds());
         dbgln("     Live cells: {} ({} bytes)", live_cells, live_cell_bytes);
         dbgln("Collected cells: {} ({} bytes)", collected_cells, collected_cell_bytes);
         dbgln("    Live blocks: {} ({} bytes)", live_block_count, live_block_count * HeapBlock::block_size);
         dbgln("   Freed blocks: {} ({} bytes)", empty_blocks.size(), empty_blocks.size() * HeapBlock::block_size);
+        dbgln(" Promoted cells: {} bytes", promoted_cell_bytes);
+        dbgln(" Without write barriers: {} old cells", m_old_cells_without_write_barriers.size());
         dbgln("=============================================");
     }
 }
@@ -567,9 +645,10 @@ void Heap::undefer_gc()
     --m_gc_deferrals;
 
     if (!m_gc_deferrals) {
-        if (m_should_gc_when_deferral_ends)
-            collect_garbage();
-        m_should_gc_when_deferral_ends = false;
+        if (auto collection_type = m_collection_when_deferral_ends; collection_type.has_value()) {
+            m_collection_when_deferral_ends.clear();
+            collect_garbage(*collection_type);
+        }
     }
 }
 
@@ -42,6 +42,7 @@ public:
         auto* memory = allocate_cell<T>();
         defer_gc();
         new (memory) T(forward<Args>(args)...);
+        did_construct_cell<T>(*memory);
         undefer_gc();
         return *static_cast<T*>(memory);
     }
@@ -52,6 +53,7 @@ public:
         auto* memory = allocate_cell<T>();
         defer_gc();
         new (memory) T(forward<Args>(args)...);
+        did_construct_cell<T>(*memory);
         undefer_gc();
         auto* cell = static_cast<T*>(memory);
         memory->initialize(realm);
@@ -60,6 +62,7 @@ public:
 
     enum class CollectionType {
         CollectGarbage,
+        CollectYoungGeneration,
         CollectEverything,
     };
 
@@ -85,6 +88,8 @@ public:
 
     void uproot_cell(Cell* cell);
 
+    void remember_cell(Badge<Cell>, Cell&);
+
 private:
     friend class MarkingVisitor;
     friend class GraphConstructorVisitor;
@@ -94,6 +99,8 @@ private:
     void undefer_gc();
 
     static bool cell_must_survive_garbage_collection(Cell const&);
+    static bool cell_is_collected_by(Cell const&, CollectionType);
+    void promote_cell(Cell&);
 
     template<typename T>
     Cell* allocate_cell()
@@ -109,13 +116,22 @@ private:
 
     void will_allocate(size_t);
 
+    template<typename T>
+    void did_construct_cell(Cell& cell)
+    {
+        if constexpr (requires { typename T::WriteBarrieredCellType; }) {
+            if constexpr (IsSame<T, typename T::WriteBarrieredCellType>)
+                cell.set_has_write_barriers({});
+        }
+    }
+
     void find_min_and_max_block_addresses(FlatPtr& min_address, FlatPtr& max_address);
     void gather_roots(HashMap<Cell*, HeapRoot>&);
     void gather_conservative_roots(HashMap<Cell*, HeapRoot>&);
     void gather_asan_fake_stack_roots(HashMap<FlatPtr, HeapRoot>&, FlatPtr, FlatPtr min_block_address, FlatPtr max_block_address);
-    void mark_live_cells(HashMap<Cell*, HeapRoot> const& live_cells);
-    void finalize_unmarked_cells();
-    void sweep_dead_cells(bool print_report, Core::ElapsedTimer const&);
+    void mark_live_cells(HashMap<Cell*, HeapRoot> const& live_cells, CollectionType);
+    void finalize_unmarked_cells(CollectionType);
+    void sweep_dead_cells(bool print_report, Core::ElapsedTimer const&, CollectionType);
 
     ALWAYS_INLINE CellAllocator& allocator_for_size(size_t cell_size)
     {
@@ -137,9 +153,14 @@ private:
         }
     }
 
+    // A young generation collection happens every time this many bytes have been allocated.
+    static constexpr size_t GC_YOUNG_GENERATION_BYTES_THRESHOLD { 4 * 1024 * 1024 };
+    size_t m_allocated_bytes_since_last_gc { 0 };
+
+    // A full collection happens once this many bytes have survived young generation collections since the last one.
     static constexpr size_t GC_MIN_BYTES_THRESHOLD { 4 * 1024 * 1024 };
     size_t m_gc_bytes_threshold { GC_MIN_BYTES_THRESHOLD };
-    size_t m_allocated_bytes_since_last_gc { 0 };
+    size_t m_promoted_bytes_since_last_full_gc { 0 };
 
     bool m_should_collect_on_every_allocation { false };
 
@@ -152,14 +173,29 @@ private:
 
     Vector<GCPtr<Cell>> m_uprooted_cells;
 
+    // Old cells that started pointing to young cells since the last collection. These are visited as roots by young
+    // generation collections, and become old again afterwards.
+    Vector<Cell*> m_remembered_cells;
+
+    // Old cells that can't tell us when they start pointing to young cells, so young generation collections always
+    // visit them as roots.
+    Vector<Cell*> m_old_cells_without_write_barriers;
+
     BlockAllocator m_block_allocator;
 
     size_t m_gc_deferrals { 0 };
-    bool m_should_gc_when_deferral_ends { false };
+    Optional<CollectionType> m_collection_when_deferral_ends;
 
     bool m_collecting_garbage { false };
 };
 
+inline void Heap::remember_cell(Badge<Cell>, Cell& cell)
+{
+    VERIFY(cell.generation() == Cell::Generation::Old);
+    cell.set_generation({}, Cell::Generation::Remembered);
+    m_remembered_cells.append(&cell);
+}
+
 inline void Heap::did_create_handle(Badge<HandleImpl>, HandleImpl& impl)
 {
     VERIFY(!m_handles.contains(impl));
@@ -44,6 +44,7 @@ public:
 
         if (allocated_cell) {
             ASAN_UNPOISON_MEMORY_REGION(allocated_cell, m_cell_size);
+            m_has_young_cells = true;
         }
         return allocated_cell;
     }
@@ -88,6 +89,11 @@ public:
         return cell_from_possible_pointer((FlatPtr)cell);
     }
 
+    // True if any cell has been allocated in this block since the last garbage collection.
+    // Young generation collections skip blocks where this is false.
+    bool has_young_cells() const { return m_has_young_cells; }
+    void clear_has_young_cells(Badge<Heap>) { m_has_young_cells = false; }
+
     IntrusiveListNode<HeapBlock> m_list_node;
 
 private:
@@ -108,6 +114,7 @@ private:
 
     size_t m_cell_size { 0 };
     size_t m_next_lazy_freelist_index { 0 };
+    bool m_has_young_cells { false };
     GCPtr<FreelistEntry> m_freelist;
     alignas(__BIGGEST_ALIGNMENT__) u8 m_storage[];
 
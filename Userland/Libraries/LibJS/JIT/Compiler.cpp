@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Debug.h>
 #include <AK/OwnPtr.h>
 #include <AK/Platform.h>
 #include <LibJS/Bytecode/CommonImplementations.h>
@@ -1558,6 +1559,122 @@ void Compiler::compile_new_class(Bytecode::Op::NewClass const& op)
     store_accumulator(RET);
 }
 
+// NOTE: Storing a reference into an old cell may require a write barrier, so fast paths that store into cells
+//       bail out to C++ for those. Once the cell has been remembered, it no longer needs a barrier.
+void Compiler::jump_if_write_barrier_may_be_needed(Assembler::Reg cell, Assembler::Reg value, Assembler::Reg temp, Assembler::Label& label)
+{
+    Assembler::Label no_write_barrier_needed;
+
+    // if (!value.is_cell()) goto no_write_barrier_needed;
+    m_assembler.mov(
+        Assembler::Operand::Register(temp),
+        Assembler::Operand::Register(value));
+    m_assembler.shift_right(
+        Assembler::Operand::Register(temp),
+        Assembler::Operand::Imm(TAG_SHIFT));
+    m_assembler.bitwise_and(
+        Assembler::Operand::Register(temp),
+        Assembler::Operand::Imm(IS_CELL_PATTERN));
+    m_assembler.jump_if(
+        Assembler::Operand::Register(temp),
+        Assembler::Condition::NotEqualTo,
+        Assembler::Operand::Imm(IS_CELL_PATTERN),
+        no_write_barrier_needed);
+
+    // if (cell->generation() == Cell::Generation::Old) goto label;
+    m_assembler.mov8(
+        Assembler::Operand::Register(temp),
+        Assembler::Operand::Mem64BaseAndOffset(cell, Cell::generation_offset()));
+    m_assembler.jump_if(
+        Assembler::Operand::Register(temp),
+        Assembler::Condition::EqualTo,
+        Assembler::Operand::Imm(to_underlying(Cell::Generation::Old)),
+        label);
+
+    no_write_barrier_needed.link(m_assembler);
+}
+
+void Compiler::load_cached_property_offset(Assembler::Reg dst, Assembler::Reg object, Assembler::Reg cache, Assembler::Reg shape, Assembler::Label& slow_case)
+{
+    Assembler::Label found_entry;
+
+    // shape = &object->shape()
+    m_assembler.mov(
+        Assembler::Operand::Register(shape),
+        Assembler::Operand::Mem64BaseAndOffset(object, Object::shape_offset()));
+
+    for (size_t i = 0; i < Bytecode::PropertyLookupCache::max_number_of_entries; ++i) {
+        auto entry_offset = Bytecode::PropertyLookupCache::entry_offset(i);
+        Assembler::Label next_entry;
+
+        // if (!entry.shape || entry.shape.ptr() != shape) goto next_entry;
+        m_assembler.mov(
+            Assembler::Operand::Register(dst),
+            Assembler::Operand::Mem64BaseAndOffset(cache, entry_offset + Bytecode::PropertyLookupCache::Entry::shape_offset()));
+        m_assembler.jump_if(
+            Assembler::Operand::Register(dst),
+            Assembler::Condition::EqualTo,
+            Assembler::Operand::Imm(0),
+            next_entry);
+        m_assembler.mov(
+            Assembler::Operand::Register(dst),
+            Assembler::Operand::Mem64BaseAndOffset(dst, AK::WeakLink::ptr_offset()));
+        m_assembler.jump_if(
+            Assembler::Operand::Register(dst),
+            Assembler::Condition::NotEqualTo,
+            Assembler::Operand::Register(shape),
+            next_entry);
+
+        // (!shape->is_unique() || shape->unique_shape_serial_number() == entry.unique_shape_serial_number)
+        // NOTE: No other entry can have the same shape, so a mismatch here is a miss.
+        Assembler::Label shape_matches;
+        m_assembler.mov8(
+            Assembler::Operand::Register(dst),
+            Assembler::Operand::Mem64BaseAndOffset(shape, Shape::is_unique_offset()));
+        m_assembler.jump_if(
+            Assembler::Operand::Register(dst),
+            Assembler::Condition::EqualTo,
+            Assembler::Operand::Imm(0),
+            shape_matches);
+        m_assembler.mov(
+            Assembler::Operand::Register(dst),
+            Assembler::Operand::Mem64BaseAndOffset(shape, Shape::unique_shape_serial_number_offset()));
+        m_assembler.jump_if(
+            Assembler::Operand::Mem64BaseAndOffset(cache, entry_offset + Bytecode::PropertyLookupCache::Entry::unique_shape_serial_number_offset()),
+            Assembler::Condition::NotEqualTo,
+            Assembler::Operand::Register(dst),
+            slow_case);
+
+        shape_matches.link(m_assembler);
+
+        // dst = *entry.property_offset
+        m_assembler.mov(
+            Assembler::Operand::Register(dst),
+            Assembler::Operand::Mem64BaseAndOffset(cache, entry_offset + Bytecode::PropertyLookupCache::Entry::property_offset_offset() + Optional<u32>::value_offset()));
+        m_assembler.jump(found_entry);
+
+        next_entry.link(m_assembler);
+    }
+
+    // None of the entries matched.
+    m_assembler.jump(slow_case);
+
+    found_entry.link(m_assembler);
+
+    // dst *= sizeof(Value)
+    m_assembler.mul32(
+        Assembler::Operand::Register(dst),
+        Assembler::Operand::Imm(sizeof(Value)),
+        slow_case);
+
+    if constexpr (JS_BYTECODE_DEBUG) {
+        // ++cache.hit_count
+        m_assembler.add(
+            Assembler::Operand::Mem64BaseAndOffset(cache, Bytecode::PropertyLookupCache::hit_count_offset()),
+            Assembler::Operand::Imm(1));
+    }
+}
+
 static Value cxx_get_by_id(VM& vm, Value base, DeprecatedFlyString const& property, Bytecode::PropertyLookupCache& cache)
 {
     return TRY_OR_SET_EXCEPTION(Bytecode::get_by_id(vm, property, base, base, cache));
@@ -1638,73 +1755,8 @@ void Compiler::compile_get_by_id(Bytecode::Op::GetById const& op)
             no_magical_length_property_case.link(m_assembler);
         }
 
-        // if (cache.shape != &object->shape()) goto slow_case;
-        m_assembler.mov(
-            Assembler::Operand::Register(GPR2),
-            Assembler::Operand::Mem64BaseAndOffset(GPR0, Object::shape_offset()));
-        m_assembler.mov(
-            Assembler::Operand::Register(GPR1),
-            Assembler::Operand::Mem64BaseAndOffset(ARG5, Bytecode::PropertyLookupCache::shape_offset()));
-
-        m_assembler.jump_if(
-            Assembler::Operand::Register(GPR1),
-            Assembler::Condition::EqualTo,
-            Assembler::Operand::Imm(0),
-            slow_case);
-
-        m_assembler.mov(
-            Assembler::Operand::Register(GPR1),
-            Assembler::Operand::Mem64BaseAndOffset(GPR1, AK::WeakLink::ptr_offset()));
-
-        m_assembler.jump_if(
-            Assembler::Operand::Register(GPR2),
-            Assembler::Condition::NotEqualTo,
-            Assembler::Operand::Register(GPR1),
-            slow_case);
-
-        // (!object->shape().is_unique() || object->shape().unique_shape_serial_number() == cache.unique_shape_serial_number)) {
-        Assembler::Label fast_case;
-
-        // GPR1 = object->shape().is_unique()
-        m_assembler.mov8(
-            Assembler::Operand::Register(GPR1),
-            Assembler::Operand::Mem64BaseAndOffset(GPR2, Shape::is_unique_offset()));
-
-        m_assembler.jump_if(
-            Assembler::Operand::Register(GPR1),
-            Assembler::Condition::EqualTo,
-            Assembler::Operand::Imm(0),
-            fast_case);
-
-        // GPR1 = object->shape().unique_shape_serial_number()
-        m_assembler.mov(
-            Assembler::Operand::Register(GPR1),
-            Assembler::Operand::Mem64BaseAndOffset(GPR2, Shape::unique_shape_serial_number_offset()));
-
-        // GPR2 = cache.unique_shape_serial_number
-        m_assembler.mov(
-            Assembler::Operand::Register(GPR2),
-            Assembler::Operand::Mem64BaseAndOffset(ARG5, Bytecode::PropertyLookupCache::unique_shape_serial_number_offset()));
-
-        // if (GPR1 != GPR2) goto slow_case;
-        m_assembler.jump_if(
-            Assembler::Operand::Register(GPR1),
-            Assembler::Condition::NotEqualTo,
-            Assembler::Operand::Register(GPR2),
-            slow_case);
-
-        fast_case.link(m_assembler);
-
-        // return object->get_direct(*cache.property_offset);
-        // GPR0 = object
-        // GPR1 = *cache.property_offset * sizeof(Value)
-        m_assembler.mov(
-            Assembler::Operand::Register(GPR1),
-            Assembler::Operand::Mem64BaseAndOffset(ARG5, Bytecode::PropertyLookupCache::property_offset_offset() + decltype(cache.property_offset)::value_offset()));
-        m_assembler.mul32(
-            Assembler::Operand::Register(GPR1),
-            Assembler::Operand::Imm(sizeof(Value)),
-            slow_case);
+        // GPR1 = *entry.property_offset * sizeof(Value), for the cache entry that matches object->shape()
+        load_cached_property_offset(GPR1, GPR0, ARG5, GPR2, slow_case);
 
         // GPR0 = object->m_storage.outline_buffer
         m_assembler.mov(
@@ -1933,7 +1985,7 @@ void Compiler::compile_get_global(Bytecode::Op::GetGlobal const& op)
     // GPR2 = cache.shape.ptr()
     m_assembler.mov(
         Assembler::Operand::Register(GPR2),
-        Assembler::Operand::Mem64BaseAndOffset(ARG2, Bytecode::PropertyLookupCache::shape_offset()));
+        Assembler::Operand::Mem64BaseAndOffset(ARG2, Bytecode::GlobalVariableCache::shape_offset()));
     m_assembler.jump_if(
         Assembler::Operand::Register(GPR2),
         Assembler::Condition::EqualTo,
@@ -1971,7 +2023,7 @@ void Compiler::compile_get_global(Bytecode::Op::GetGlobal const& op)
     // GPR0 = cache.unique_shape_serial_number
     m_assembler.mov(
         Assembler::Operand::Register(GPR0),
-        Assembler::Operand::Mem64BaseAndOffset(ARG2, Bytecode::PropertyLookupCache::unique_shape_serial_number_offset()));
+        Assembler::Operand::Mem64BaseAndOffset(ARG2, Bytecode::GlobalVariableCache::unique_shape_serial_number_offset()));
 
     // if (GPR2 != GPR0) goto slow_case;
     m_assembler.jump_if(
@@ -1990,7 +2042,7 @@ void Compiler::compile_get_global(Bytecode::Op::GetGlobal const& op)
         Assembler::Operand::Register(GPR1));
     m_assembler.mov(
         Assembler::Operand::Register(GPR1),
-        Assembler::Operand::Mem64BaseAndOffset(ARG2, Bytecode::PropertyLookupCache::property_offset_offset() + decltype(cache.property_offset)::value_offset()));
+        Assembler::Operand::Mem64BaseAndOffset(ARG2, Bytecode::GlobalVariableCache::property_offset_offset() + decltype(cache.property_offset)::value_offset()));
     m_assembler.mul32(
         Assembler::Operand::Register(GPR1),
         Assembler::Operand::Imm(sizeof(Value)),
@@ -2268,73 +2320,11 @@ void Compiler::compile_put_by_id(Bytecode::Op::PutById const& op)
         branch_if_object(ARG1, [&] {
             extract_object_pointer(GPR0, ARG1);
 
-            // if (cache.shape != &object->shape()) goto slow_case;
-            m_assembler.mov(
-                Assembler::Operand::Register(GPR2),
-                Assembler::Operand::Mem64BaseAndOffset(GPR0, Object::shape_offset()));
-            m_assembler.mov(
-                Assembler::Operand::Register(GPR1),
-                Assembler::Operand::Mem64BaseAndOffset(ARG5, Bytecode::PropertyLookupCache::shape_offset()));
+            // if (value.is_cell() && object->generation() == Cell::Generation::Old) goto slow_case;
+            jump_if_write_barrier_may_be_needed(GPR0, CACHED_ACCUMULATOR, GPR1, slow_case);
 
-            m_assembler.jump_if(
-                Assembler::Operand::Register(GPR1),
-                Assembler::Condition::EqualTo,
-                Assembler::Operand::Imm(0),
-                slow_case);
-
-            m_assembler.mov(
-                Assembler::Operand::Register(GPR1),
-                Assembler::Operand::Mem64BaseAndOffset(GPR1, AK::WeakLink::ptr_offset()));
-
-            m_assembler.jump_if(
-                Assembler::Operand::Register(GPR2),
-                Assembler::Condition::NotEqualTo,
-                Assembler::Operand::Register(GPR1),
-                slow_case);
-
-            // (!object->shape().is_unique() || object->shape().unique_shape_serial_number() == cache.unique_shape_serial_number)) {
-            Assembler::Label fast_case;
-
-            // GPR1 = object->shape().is_unique()
-            m_assembler.mov8(
-                Assembler::Operand::Register(GPR1),
-                Assembler::Operand::Mem64BaseAndOffset(GPR2, Shape::is_unique_offset()));
-
-            m_assembler.jump_if(
-                Assembler::Operand::Register(GPR1),
-                Assembler::Condition::EqualTo,
-                Assembler::Operand::Imm(0),
-                fast_case);
-
-            // GPR1 = object->shape().unique_shape_serial_number()
-            m_assembler.mov(
-                Assembler::Operand::Register(GPR1),
-                Assembler::Operand::Mem64BaseAndOffset(GPR2, Shape::unique_shape_serial_number_offset()));
-
-            // GPR2 = cache.unique_shape_serial_number
-            m_assembler.mov(
-                Assembler::Operand::Register(GPR2),
-                Assembler::Operand::Mem64BaseAndOffset(ARG5, Bytecode::PropertyLookupCache::unique_shape_serial_number_offset()));
-
-            // if (GPR1 != GPR2) goto slow_case;
-            m_assembler.jump_if(
-                Assembler::Operand::Register(GPR1),
-                Assembler::Condition::NotEqualTo,
-                Assembler::Operand::Register(GPR2),
-                slow_case);
-
-            fast_case.link(m_assembler);
-
-            // object->put_direct(*cache.property_offset, value);
-            // GPR0 = object
-            // GPR1 = *cache.property_offset * sizeof(Value)
-            m_assembler.mov(
-                Assembler::Operand::Register(GPR1),
-                Assembler::Operand::Mem64BaseAndOffset(ARG5, Bytecode::PropertyLookupCache::property_offset_offset() + decltype(cache.property_offset)::value_offset()));
-            m_assembler.mul32(
-                Assembler::Operand::Register(GPR1),
-                Assembler::Operand::Imm(sizeof(Value)),
-                slow_case);
+            // GPR1 = *entry.property_offset * sizeof(Value), for the cache entry that matches object->shape()
+            load_cached_property_offset(GPR1, GPR0, ARG5, GPR2, slow_case);
 
             // GPR0 = object->m_storage.outline_buffer
             m_assembler.mov(
@@ -2412,6 +2402,9 @@ void Compiler::compile_put_by_value(Bytecode::Op::PutByValue const& op)
                 Assembler::Operand::Imm(0),
                 slow_case);
 
+            // if (value.is_cell() && object->generation() == Cell::Generation::Old) goto slow_case;
+            jump_if_write_barrier_may_be_needed(GPR0, CACHED_ACCUMULATOR, GPR1, slow_case);
+
             // GPR0 = object->indexed_properties().storage()
             m_assembler.mov(
                 Assembler::Operand::Register(GPR0),
@@ -205,6 +205,8 @@ private:
     }
 
     void extract_object_pointer(Assembler::Reg dst_object, Assembler::Reg src_value);
+    void jump_if_write_barrier_may_be_needed(Assembler::Reg cell, Assembler::Reg value, Assembler::Reg temp, Assembler::Label&);
+    void load_cached_property_offset(Assembler::Reg dst, Assembler::Reg object, Assembler::Reg cache, Assembler::Reg shape, Assembler::Label& slow_case);
     void convert_to_double(Assembler::Reg dst, Assembler::Reg src, Assembler::Reg nan, Assembler::Reg temp, Assembler::Label& not_number);
 
     template<typename Codegen>
@@ -33,7 +33,7 @@ namespace JS {
 
 JS_DEFINE_ALLOCATOR(ECMAScriptFunctionObject);
 
-NonnullGCPtr<ECMAScriptFunctionObject> ECMAScriptFunctionObject::create(Realm& realm, DeprecatedFlyString name, DeprecatedString source_text, Statement const& ecmascript_code, Vector<FunctionParameter> parameters, i32 m_function_length, Vector<DeprecatedFlyString> local_variables_names, Environment* parent_environment, PrivateEnvironment* private_environment, FunctionKind kind, bool is_strict, bool might_need_arguments_object, bool contains_direct_call_to_eval, bool is_arrow_function, Variant<PropertyKey, PrivateName, Empty> class_field_initializer_name)
+NonnullGCPtr<ECMAScriptFunctionObject> ECMAScriptFunctionObject::create(Realm& realm, DeprecatedFlyString name, SourceText source_text, Statement const& ecmascript_code, Vector<FunctionParameter> parameters, i32 m_function_length, Vector<DeprecatedFlyString> local_variables_names, Environment* parent_environment, PrivateEnvironment* private_environment, FunctionKind kind, bool is_strict, bool might_need_arguments_object, bool contains_direct_call_to_eval, bool is_arrow_function, Variant<PropertyKey, PrivateName, Empty> class_field_initializer_name)
 {
     Object* prototype = nullptr;
     switch (kind) {
@@ -53,12 +53,12 @@ NonnullGCPtr<ECMAScriptFunctionObject> ECMAScriptFunctionObject::create(Realm& r
     return realm.heap().allocate<ECMAScriptFunctionObject>(realm, move(name), move(source_text), ecmascript_code, move(parameters), m_function_length, move(local_variables_names), parent_environment, private_environment, *prototype, kind, is_strict, might_need_arguments_object, contains_direct_call_to_eval, is_arrow_function, move(class_field_initializer_name));
 }
 
-NonnullGCPtr<ECMAScriptFunctionObject> ECMAScriptFunctionObject::create(Realm& realm, DeprecatedFlyString name, Object& prototype, DeprecatedString source_text, Statement const& ecmascript_code, Vector<FunctionParameter> parameters, i32 m_function_length, Vector<DeprecatedFlyString> local_variables_names, Environment* parent_environment, PrivateEnvironment* private_environment, FunctionKind kind, bool is_strict, bool might_need_arguments_object, bool contains_direct_call_to_eval, bool is_arrow_function, Variant<PropertyKey, PrivateName, Empty> class_field_initializer_name)
+NonnullGCPtr<ECMAScriptFunctionObject> ECMAScriptFunctionObject::create(Realm& realm, DeprecatedFlyString name, Object& prototype, SourceText source_text, Statement const& ecmascript_code, Vector<FunctionParameter> parameters, i32 m_function_length, Vector<DeprecatedFlyString> local_variables_names, Environment* parent_environment, PrivateEnvironment* private_environment, FunctionKind kind, bool is_strict, bool might_need_arguments_object, bool contains_direct_call_to_eval, bool is_arrow_function, Variant<PropertyKey, PrivateName, Empty> class_field_initializer_name)
 {
     return realm.heap().allocate<ECMAScriptFunctionObject>(realm, move(name), move(source_text), ecmascript_code, move(parameters), m_function_length, move(local_variables_names), parent_environment, private_environment, prototype, kind, is_strict, might_need_arguments_object, contains_direct_call_to_eval, is_arrow_function, move(class_field_initializer_name));
 }
 
-ECMAScriptFunctionObject::ECMAScriptFunctionObject(DeprecatedFlyString name, DeprecatedString source_text, Statement const& ecmascript_code, Vector<FunctionParameter> formal_parameters, i32 function_length, Vector<DeprecatedFlyString> local_variables_names, Environment* parent_environment, PrivateEnvironment* private_environment, Object& prototype, FunctionKind kind, bool strict, bool might_need_arguments_object, bool contains_direct_call_to_eval, bool is_arrow_function, Variant<PropertyKey, PrivateName, Empty> class_field_initializer_name)
+ECMAScriptFunctionObject::ECMAScriptFunctionObject(DeprecatedFlyString name, SourceText source_text, Statement const& ecmascript_code, Vector<FunctionParameter> formal_parameters, i32 function_length, Vector<DeprecatedFlyString> local_variables_names, Environment* parent_environment, PrivateEnvironment* private_environment, Object& prototype, FunctionKind kind, bool strict, bool might_need_arguments_object, bool contains_direct_call_to_eval, bool is_arrow_function, Variant<PropertyKey, PrivateName, Empty> class_field_initializer_name)
     : FunctionObject(prototype)
     , m_name(move(name))
     , m_function_length(function_length)
@@ -102,8 +102,18 @@ ECMAScriptFunctionObject::ECMAScriptFunctionObject(DeprecatedFlyString name, Dep
         return true;
     });
 
-    // NOTE: The following steps are from FunctionDeclarationInstantiation that could be executed once
-    //       and then reused in all subsequent function instantiations.
+    vm().function_statistics().function_objects_created++;
+}
+
+// NOTE: The following steps are from FunctionDeclarationInstantiation that could be executed once
+//       and then reused in all subsequent function instantiations.
+//       They are deferred until the function is first called, as many functions never are.
+void ECMAScriptFunctionObject::prepare_function_declaration_instantiation()
+{
+    if (m_did_prepare_function_declaration_instantiation)
+        return;
+    m_did_prepare_function_declaration_instantiation = true;
+    vm().function_statistics().function_objects_prepared++;
 
     // 2. Let code be func.[[ECMAScriptCode]].
     ScopeNode const* scope_body = nullptr;
@@ -568,7 +578,7 @@ ThrowCompletionOr<void> ECMAScriptFunctionObject::function_declaration_instantia
     if (is<ScopeNode>(*m_ecmascript_code))
         scope_body = static_cast<ScopeNode const*>(m_ecmascript_code.ptr());
 
-    // NOTE: Following steps were executed in ECMAScriptFunctionObject constructor.
+    // NOTE: Following steps were executed in prepare_function_declaration_instantiation().
     //       3. Let strict be func.[[Strict]].
     //       4. Let formals be func.[[FormalParameters]].
     //       5. Let parameterNames be the BoundNames of formals.
@@ -577,7 +587,7 @@ ThrowCompletionOr<void> ECMAScriptFunctionObject::function_declaration_instantia
     // 7. Let simpleParameterList be IsSimpleParameterList of formals.
     bool const simple_parameter_list = has_simple_parameter_list();
 
-    // NOTE: Following steps were executed in ECMAScriptFunctionObject constructor.
+    // NOTE: Following steps were executed in prepare_function_declaration_instantiation().
     //       8. Let hasParameterExpressions be ContainsExpression of formals.
     //       9. Let varNames be the VarDeclaredNames of code.
     //       10. Let varDeclarations be the VarScopedDeclarations of code.
@@ -745,7 +755,7 @@ ThrowCompletionOr<void> ECMAScriptFunctionObject::function_declaration_instantia
             // c. For each element n of varNames, do
             for (auto const& variable_to_initialize : m_var_names_to_initialize_binding) {
                 auto const& id = variable_to_initialize.identifier;
-                // NOTE: Following steps were executed in ECMAScriptFunctionObject constructor.
+                // NOTE: Following steps were executed in prepare_function_declaration_instantiation().
                 //       i. If instantiatedVarNames does not contain n, then
                 //       1. Append n to instantiatedVarNames.
                 if (id.is_local()) {
@@ -784,7 +794,7 @@ ThrowCompletionOr<void> ECMAScriptFunctionObject::function_declaration_instantia
             for (auto const& variable_to_initialize : m_var_names_to_initialize_binding) {
                 auto const& id = variable_to_initialize.identifier;
 
-                // NOTE: Following steps were executed in ECMAScriptFunctionObject constructor.
+                // NOTE: Following steps were executed in prepare_function_declaration_instantiation().
                 //       i. If instantiatedVarNames does not contain n, then
                 //       1. Append n to instantiatedVarNames.
 
@@ -959,6 +969,8 @@ ThrowCompletionOr<void> ECMAScriptFunctionObject::prepare_for_ordinary_call(Exec
     // 6. Set the ScriptOrModule of calleeContext to F.[[ScriptOrModule]].
     callee_context.script_or_module = m_script_or_module;
 
+    prepare_function_declaration_instantiation();
+
     // 7. Let localEnv be NewFunctionEnvironment(F, newTarget).
     auto local_environment = new_function_environment(*this, new_target);
     local_environment->ensure_capacity(m_function_environment_bindings_count);
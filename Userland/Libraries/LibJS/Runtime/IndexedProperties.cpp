@@ -7,6 +7,7 @@
 #include <AK/QuickSort.h>
 #include <LibJS/Runtime/Accessor.h>
 #include <LibJS/Runtime/IndexedProperties.h>
+#include <LibJS/Runtime/Object.h>
 
 namespace JS {
 
@@ -236,6 +237,7 @@ void IndexedProperties::put(u32 index, Value value, PropertyAttributes attribute
     }
 
     m_storage->put(index, value, attributes);
+    m_owner.write_barrier(value);
 }
 
 void IndexedProperties::remove(u32 index)
@@ -133,12 +133,21 @@ private:
 };
 
 class IndexedProperties {
+    AK_MAKE_NONCOPYABLE(IndexedProperties);
+    AK_MAKE_NONMOVABLE(IndexedProperties);
+
 public:
-    IndexedProperties() = default;
+    // NOTE: The owner needs to know when it starts pointing to young cells.
+    explicit IndexedProperties(Object& owner)
+        : m_owner(owner)
+    {
+    }
 
-    explicit IndexedProperties(Vector<Value> values)
+    void set_elements(Vector<Value>&& values)
     {
-        if (!values.is_empty())
+        if (values.is_empty())
+            m_storage = nullptr;
+        else
             m_storage = make<SimpleIndexedPropertyStorage>(move(values));
     }
 
@@ -183,6 +192,7 @@ private:
     void switch_to_generic_storage();
     void ensure_storage();
 
+    Object& m_owner;
     OwnPtr<IndexedPropertyStorage> m_storage;
 };
 
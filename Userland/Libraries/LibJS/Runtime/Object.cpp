@@ -1113,7 +1113,7 @@ Optional<ValueAndAttributes> Object::storage_get(PropertyKey const& property_key
 
         if (m_has_intrinsic_accessors) {
             if (auto accessor = find_intrinsic_accessor(this, property_key); accessor.has_value())
-                const_cast<Object&>(*this).m_storage[metadata->offset] = (*accessor)(shape().realm());
+                const_cast<Object&>(*this).put_direct(metadata->offset, (*accessor)(shape().realm()));
         }
 
         value = m_storage[metadata->offset];
@@ -1165,6 +1165,7 @@ void Object::storage_set(PropertyKey const& property_key, ValueAndAttributes con
             set_shape(*m_shape->create_put_transition(property_key_string_or_symbol, attributes));
 
         m_storage.append(value);
+        write_barrier(value);
         return;
     }
 
@@ -1175,7 +1176,7 @@ void Object::storage_set(PropertyKey const& property_key, ValueAndAttributes con
             set_shape(*m_shape->create_configure_transition(property_key_string_or_symbol, attributes));
     }
 
-    m_storage[metadata->offset] = value;
+    put_direct(metadata->offset, value);
 }
 
 void Object::storage_delete(PropertyKey const& property_key)
@@ -1208,7 +1209,7 @@ void Object::set_prototype(Object* new_prototype)
     if (shape.is_unique())
         shape.set_prototype_without_transition(new_prototype);
     else
-        m_shape = shape.create_prototype_transition(new_prototype);
+        set_shape(*shape.create_prototype_transition(new_prototype));
 }
 
 void Object::define_native_accessor(Realm& realm, PropertyKey const& property_key, Function<ThrowCompletionOr<Value>(VM&)> getter, Function<ThrowCompletionOr<Value>(VM&)> setter, PropertyAttributes attribute)
@@ -1255,7 +1256,7 @@ void Object::ensure_shape_is_unique()
     if (shape().is_unique())
         return;
 
-    m_shape = m_shape->create_unique_clone();
+    set_shape(*m_shape->create_unique_clone());
 }
 
 // Simple side-effect free property lookup, following the prototype chain. Non-standard.
@@ -55,6 +55,7 @@ struct CacheablePropertyMetadata {
 class Object : public Cell {
     JS_CELL(Object, Cell);
     JS_DECLARE_ALLOCATOR(Object);
+    JS_CELL_HAS_WRITE_BARRIERS(Object);
 
 public:
     static NonnullGCPtr<Object> create(Realm&, Object* prototype);
@@ -199,13 +200,21 @@ public:
     virtual void visit_edges(Cell::Visitor&) override;
 
     Value get_direct(size_t index) const { return m_storage[index]; }
-    void put_direct(size_t index, Value value) { m_storage[index] = value; }
+    void put_direct(size_t index, Value value)
+    {
+        m_storage[index] = value;
+        write_barrier(value);
+    }
 
     static FlatPtr storage_offset() { return OFFSET_OF(Object, m_storage); }
 
     IndexedProperties const& indexed_properties() const { return m_indexed_properties; }
     IndexedProperties& indexed_properties() { return m_indexed_properties; }
-    void set_indexed_property_elements(Vector<Value>&& values) { m_indexed_properties = IndexedProperties(move(values)); }
+    void set_indexed_property_elements(Vector<Value>&& values)
+    {
+        m_indexed_properties.set_elements(move(values));
+        m_indexed_properties.for_each_value([&](auto& value) { write_barrier(value); });
+    }
 
     Shape& shape() { return *m_shape; }
     Shape const& shape() const { return *m_shape; }
@@ -249,7 +258,11 @@ protected:
     bool m_is_typed_array { false };
 
 private:
-    void set_shape(Shape& shape) { m_shape = &shape; }
+    void set_shape(Shape& shape)
+    {
+        m_shape = &shape;
+        write_barrier(&shape);
+    }
 
     Object* prototype() { return shape().prototype(); }
     Object const* prototype() const { return shape().prototype(); }
@@ -261,7 +274,7 @@ private:
 
     GCPtr<Shape> m_shape;
     Vector<Value> m_storage;
-    IndexedProperties m_indexed_properties;
+    IndexedProperties m_indexed_properties { *this };
     OwnPtr<Vector<PrivateElement>> m_private_elements; // [[PrivateElements]]
 };
 
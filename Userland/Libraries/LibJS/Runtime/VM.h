@@ -25,6 +25,7 @@
 #include <LibJS/Runtime/ExecutionContext.h>
 #include <LibJS/Runtime/Promise.h>
 #include <LibJS/Runtime/Value.h>
+#include <LibJS/ScriptCache.h>
 
 namespace JS {
 
@@ -69,6 +70,18 @@ public:
         return m_deprecated_string_cache;
     }
 
+    ScriptCache& script_cache() { return m_script_cache; }
+
+    // Function objects only do their FunctionDeclarationInstantiation setup when first called.
+    // These counters show how much of that work was never needed.
+    struct FunctionStatistics {
+        size_t function_objects_created { 0 };
+        // NOTE: This counts the function objects that were called at least once, not the calls themselves.
+        size_t function_objects_prepared { 0 };
+    };
+    FunctionStatistics& function_statistics() { return m_function_statistics; }
+    FunctionStatistics const& function_statistics() const { return m_function_statistics; }
+
     PrimitiveString& empty_string() { return *m_empty_string; }
 
     PrimitiveString& single_ascii_character_string(u8 character)
@@ -285,6 +298,9 @@ private:
 
     Heap m_heap;
 
+    // NOTE: Cached parse trees hold handles to their bytecode, so this must be destroyed before the heap.
+    ScriptCache m_script_cache;
+
     Vector<ExecutionContext*> m_execution_context_stack;
 
     Vector<Vector<ExecutionContext*>> m_saved_execution_context_stacks;
@@ -318,6 +334,8 @@ private:
 
     u32 m_execution_generation { 0 };
 
+    FunctionStatistics m_function_statistics;
+
     OwnPtr<CustomData> m_custom_data;
 
     OwnPtr<Bytecode::Interpreter> m_bytecode_interpreter;
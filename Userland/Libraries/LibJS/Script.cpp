@@ -17,6 +17,11 @@ JS_DEFINE_ALLOCATOR(Script);
 // 16.1.5 ParseScript ( sourceText, realm, hostDefined ), https://tc39.es/ecma262/#sec-parse-script
 Result<NonnullGCPtr<Script>, Vector<ParserError>> Script::parse(StringView source_text, Realm& realm, StringView filename, HostDefined* host_defined, size_t line_number_offset)
 {
+    // OPTIMIZATION: Parse trees are immutable, so a script we have seen before can reuse its parse tree (and the bytecode cached on it).
+    auto& script_cache = realm.vm().script_cache();
+    if (auto cached_script = script_cache.get(source_text, filename, line_number_offset))
+        return realm.heap().allocate_without_realm<Script>(realm, filename, cached_script.release_nonnull(), host_defined);
+
     // 1. Let script be ParseText(sourceText, Script).
     auto parser = Parser(Lexer(source_text, filename, line_number_offset));
     auto script = parser.parse_program();
@@ -25,6 +30,8 @@ Result<NonnullGCPtr<Script>, Vector<ParserError>> Script::parse(StringView sourc
     if (parser.has_errors())
         return parser.errors();
 
+    script_cache.set(source_text, filename, line_number_offset, script);
+
     // 3. Return Script Record { [[Realm]]: realm, [[ECMAScriptCode]]: script, [[HostDefined]]: hostDefined }.
     return realm.heap().allocate_without_realm<Script>(realm, filename, move(script), host_defined);
 }
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibJS/AST.h>
+#include <LibJS/ScriptCache.h>
+
+namespace JS {
+
+// Parse trees are several times larger than their source text, so the cache is bounded by the
+// total size of the cached sources rather than by the number of scripts.
+static constexpr size_t max_total_source_size = 16 * MiB;
+
+// Tiny scripts are cheap to parse, and there tend to be a lot of unique ones (e.g. inline event handlers).
+static constexpr size_t min_source_size = 1 * KiB;
+
+ScriptCache::ScriptCache() = default;
+ScriptCache::~ScriptCache() = default;
+
+static size_t source_size_of(Program const& program)
+{
+    return program.source_code().code().bytes().size();
+}
+
+ScriptCache::Key ScriptCache::make_key(StringView source_text, StringView filename, size_t line_number_offset)
+{
+    return Key { filename, line_number_offset, source_text.hash() };
+}
+
+RefPtr<Program> ScriptCache::get(StringView source_text, StringView filename, size_t line_number_offset)
+{
+    if (source_text.length() < min_source_size)
+        return nullptr;
+
+    auto key = make_key(source_text, filename, line_number_offset);
+    auto it = m_entries.find(key);
+    if (it == m_entries.end())
+        return nullptr;
+
+    NonnullRefPtr<Program> program = it->value;
+
+    // The hash only narrows things down, the source text has to match exactly.
+    if (program->source_code().code().bytes_as_string_view() != source_text)
+        return nullptr;
+
+    // Move the entry to the back, so that the least recently used script is evicted first.
+    m_entries.remove(it);
+    m_entries.set(move(key), program);
+    return program;
+}
+
+void ScriptCache::set(StringView source_text, StringView filename, size_t line_number_offset, NonnullRefPtr<Program> program)
+{
+    auto source_size = source_size_of(*program);
+    if (source_text.length() < min_source_size || source_size > max_total_source_size / 4)
+        return;
+
+    auto key = make_key(source_text, filename, line_number_offset);
+    if (auto it = m_entries.find(key); it != m_entries.end()) {
+        m_total_source_size -= source_size_of(*it->value);
+        m_entries.remove(it);
+    }
+
+    m_entries.set(move(key), move(program));
+    m_total_source_size += source_size;
+    evict_if_needed();
+}
+
+void ScriptCache::clear()
+{
+    m_entries.clear();
+    m_total_source_size = 0;
+}
+
+void ScriptCache::evict_if_needed()
+{
+    while (m_total_source_size > max_total_source_size && !m_entries.is_empty()) {
+        auto oldest = m_entries.begin();
+        m_total_source_size -= source_size_of(*oldest->value);
+        m_entries.remove(oldest);
+    }
+}
+
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/DeprecatedString.h>
+#include <AK/HashMap.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/Noncopyable.h>
+#include <LibJS/Forward.h>
+
+namespace JS {
+
+// Keeps the parse trees of recently parsed scripts alive, keyed by their filename and source text.
+// A parse tree holds on to the bytecode generated for it and for each function inside it, so loading
+// the same script again (e.g. a library script shared by several pages) skips lexing, parsing and
+// bytecode generation entirely.
+class ScriptCache {
+    AK_MAKE_NONCOPYABLE(ScriptCache);
+    AK_MAKE_NONMOVABLE(ScriptCache);
+
+public:
+    ScriptCache();
+    ~ScriptCache();
+
+    RefPtr<Program> get(StringView source_text, StringView filename, size_t line_number_offset);
+    void set(StringView source_text, StringView filename, size_t line_number_offset, NonnullRefPtr<Program>);
+    void clear();
+
+private:
+    struct Key {
+        DeprecatedString filename;
+        size_t line_number_offset { 0 };
+        u32 source_hash { 0 };
+
+        bool operator==(Key const&) const = default;
+    };
+
+    struct KeyTraits : public DefaultTraits<Key> {
+        static unsigned hash(Key const& key) { return pair_int_hash(key.filename.hash(), pair_int_hash(key.line_number_offset, key.source_hash)); }
+    };
+
+    static Key make_key(StringView source_text, StringView filename, size_t line_number_offset);
+    void evict_if_needed();
+
+    OrderedHashMap<Key, NonnullRefPtr<Program>, KeyTraits> m_entries;
+    size_t m_total_source_size { 0 };
+};
+
+}
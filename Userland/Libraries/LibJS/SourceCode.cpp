@@ -33,6 +33,13 @@ String const& SourceCode::code() const
     return m_code;
 }
 
+DeprecatedString SourceText::to_deprecated_string() const
+{
+    if (!m_source_code)
+        return m_text;
+    return m_source_code->code().bytes_as_string_view().substring_view(m_start_offset, m_end_offset - m_start_offset);
+}
+
 void SourceCode::fill_position_cache() const
 {
     constexpr size_t minimum_distance_between_cached_positions = 10000;
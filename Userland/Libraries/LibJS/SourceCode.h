@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/DeprecatedString.h>
 #include <AK/String.h>
 #include <AK/Vector.h>
 #include <LibJS/Forward.h>
@@ -35,4 +36,32 @@ private:
     Vector<Position> mutable m_cached_positions;
 };
 
+// The [[SourceText]] of a function or class. For parsed code this only refers to a range of the
+// SourceCode, so the text is copied out when something actually asks for it (which is rare, e.g.
+// Function.prototype.toString()) rather than once for every function while parsing.
+class SourceText {
+public:
+    SourceText() = default;
+
+    SourceText(DeprecatedString text)
+        : m_text(move(text))
+    {
+    }
+
+    SourceText(NonnullRefPtr<SourceCode const> source_code, u32 start_offset, u32 end_offset)
+        : m_source_code(move(source_code))
+        , m_start_offset(start_offset)
+        , m_end_offset(end_offset)
+    {
+    }
+
+    DeprecatedString to_deprecated_string() const;
+
+private:
+    RefPtr<SourceCode const> m_source_code;
+    u32 m_start_offset { 0 };
+    u32 m_end_offset { 0 };
+    DeprecatedString m_text;
+};
+
 }
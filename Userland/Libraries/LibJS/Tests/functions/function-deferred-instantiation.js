@@ -0,0 +1,135 @@
+// Function objects only set up their declarations, parameters and arguments object when first called.
+// These tests make sure that deferring this work doesn't change what a function sees, even when it is
+// called long after it was created, or more than once.
+
+test("function and var declarations are hoisted on the first call", () => {
+    const makeFunction = () =>
+        function () {
+            const before = [typeof hoisted, typeof variable];
+            var variable = 1;
+            function hoisted() {
+                return variable;
+            }
+            return [...before, hoisted()];
+        };
+
+    const f = makeFunction();
+    expect(f()).toEqual(["function", "undefined", 1]);
+    expect(f()).toEqual(["function", "undefined", 1]);
+});
+
+test("block-level functions are hoisted to the function scope when first called", () => {
+    function f() {
+        const before = typeof inBlock;
+        {
+            function inBlock() {
+                return "block";
+            }
+        }
+        return [before, inBlock()];
+    }
+
+    expect(f()).toEqual(["undefined", "block"]);
+    expect(f()).toEqual(["undefined", "block"]);
+});
+
+test("parameter expressions see earlier parameters and the enclosing scope", () => {
+    let outer = "outer";
+    function f(a, b = a + 1, c = () => a + b, d = outer) {
+        var a;
+        return [a, b, c(), d];
+    }
+
+    expect(f(1)).toEqual([1, 2, 3, "outer"]);
+    outer = "changed";
+    expect(f(10, 20)).toEqual([10, 20, 30, "changed"]);
+});
+
+test("parameter expressions get their own scope when the body has var declarations", () => {
+    function f(a, getA = () => a) {
+        var a = "body";
+        return [a, getA()];
+    }
+
+    expect(f("param")).toEqual(["body", "param"]);
+    expect(f("other")).toEqual(["body", "other"]);
+});
+
+test("a parameter expression that throws doesn't leave the function half set up", () => {
+    function f(a = thrower()) {
+        return a;
+    }
+    let shouldThrow = true;
+    function thrower() {
+        if (shouldThrow) throw new Error("thrown");
+        return "ok";
+    }
+
+    expect(() => f()).toThrowWithMessage(Error, "thrown");
+    shouldThrow = false;
+    expect(f()).toBe("ok");
+    expect(f("given")).toBe("given");
+});
+
+test("sloppy mode functions with simple parameters get a mapped arguments object", () => {
+    function f(a, b) {
+        arguments[0] = "changed";
+        b = "also changed";
+        return [a, arguments[1], arguments.length];
+    }
+
+    expect(f(1, 2)).toEqual(["changed", "also changed", 2]);
+    expect(f(1, 2, 3)).toEqual(["changed", "also changed", 3]);
+});
+
+test("strict mode functions and functions with parameter expressions get an unmapped arguments object", () => {
+    function strict(a) {
+        "use strict";
+        arguments[0] = "changed";
+        return [a, arguments[0]];
+    }
+    function withDefault(a = 0) {
+        arguments[0] = "changed";
+        return [a, arguments[0]];
+    }
+
+    expect(strict(1)).toEqual([1, "changed"]);
+    expect(strict(2)).toEqual([2, "changed"]);
+    expect(withDefault(1)).toEqual([1, "changed"]);
+    expect(withDefault(2)).toEqual([2, "changed"]);
+});
+
+test("a parameter or function declaration named arguments replaces the arguments object", () => {
+    function parameter(arguments) {
+        return arguments;
+    }
+    function declaration() {
+        function arguments() {}
+        return typeof arguments;
+    }
+
+    expect(parameter("param")).toBe("param");
+    expect(declaration()).toBe("function");
+    expect(declaration()).toBe("function");
+});
+
+test("every call gets its own arguments object", () => {
+    function f() {
+        return arguments;
+    }
+
+    const first = f(1);
+    const second = f(2, 3);
+    expect(first).not.toBe(second);
+    expect(Array.from(first)).toEqual([1]);
+    expect(Array.from(second)).toEqual([2, 3]);
+});
+
+test("arrow functions use the arguments object of their enclosing function", () => {
+    function f() {
+        return () => arguments[0];
+    }
+
+    const arrow = f("outer");
+    expect(arrow("inner")).toBe("outer");
+});
@@ -0,0 +1,68 @@
+test("young cells only referenced from old cells survive young generation collections", () => {
+    let old = { named: null };
+    let oldArray = [null];
+    let oldFunction = function () {};
+
+    // Make sure the containers are in the old generation.
+    gc();
+
+    old.named = { value: "named" };
+    oldArray[0] = { value: "indexed" };
+    oldArray.push({ value: "pushed" });
+    oldFunction.property = { value: "function" };
+    Object.setPrototypeOf(old, { value: "prototype" });
+
+    // Allocate enough to trigger a few young generation collections.
+    let garbage;
+    for (let i = 0; i < 200_000; ++i) garbage = { i, string: "garbage" + i };
+
+    expect(old.named.value).toBe("named");
+    expect(oldArray[0].value).toBe("indexed");
+    expect(oldArray[1].value).toBe("pushed");
+    expect(oldFunction.property.value).toBe("function");
+    expect(Object.getPrototypeOf(old).value).toBe("prototype");
+
+    gc();
+
+    expect(old.named.value).toBe("named");
+    expect(oldArray[0].value).toBe("indexed");
+    expect(oldArray[1].value).toBe("pushed");
+    expect(oldFunction.property.value).toBe("function");
+    expect(Object.getPrototypeOf(old).value).toBe("prototype");
+});
+
+test("stores into old cells from hot property access paths", () => {
+    let old = { value: null };
+    let oldArray = [null];
+    gc();
+
+    function store(i) {
+        old.value = { i };
+        oldArray[0] = { i };
+    }
+
+    for (let i = 0; i < 100_000; ++i) store(i);
+
+    expect(old.value.i).toBe(99_999);
+    expect(oldArray[0].i).toBe(99_999);
+});
+
+test("old cells are remembered again after a young generation collection", () => {
+    let old = { value: null };
+    let oldArray = [null];
+    gc();
+
+    function allocateGarbage() {
+        let garbage;
+        for (let i = 0; i < 200_000; ++i) garbage = { i, string: "garbage" + i };
+    }
+
+    // Every round stores a new young cell into the same old cells after the previous one has been promoted.
+    for (let round = 0; round < 3; ++round) {
+        old.value = { round };
+        oldArray[0] = { round };
+        allocateGarbage();
+        expect(old.value.round).toBe(round);
+        expect(oldArray[0].round).toBe(round);
+    }
+});
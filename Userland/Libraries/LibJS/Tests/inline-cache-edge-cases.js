@@ -16,3 +16,125 @@ test("Inline cache invalidated by deleting property from unique shape", () => {
     expect(first).toBe(2);
     expect(second).toBeUndefined();
 });
+
+test("Inline cache for a call site that sees several shapes", () => {
+    function get(o) {
+        return o.value;
+    }
+
+    function put(o, value) {
+        o.value = value;
+    }
+
+    // Every object stores "value" at a different offset.
+    let objects = [];
+    for (let i = 0; i < 8; ++i) {
+        let o = {};
+        for (let j = 0; j < i; ++j) o["padding" + j] = j;
+        o.value = i;
+        objects.push(o);
+    }
+
+    for (let round = 0; round < 3; ++round) {
+        for (let i = 0; i < objects.length; ++i) {
+            expect(get(objects[i])).toBe(i + round * 100);
+            put(objects[i], i + (round + 1) * 100);
+        }
+    }
+
+    for (let i = 0; i < objects.length; ++i) {
+        expect(objects[i]["padding0"]).toBe(i === 0 ? undefined : 0);
+        expect(get(objects[i])).toBe(i + 300);
+    }
+});
+
+test("Inline cache entry for a unique shape is invalidated by deleting a property", () => {
+    let unique = {};
+    for (let x = 0; x < 1000; ++x) {
+        unique["prop" + x] = x;
+    }
+
+    function ic(o) {
+        return o.prop2;
+    }
+
+    expect(ic({ prop2: "a" })).toBe("a");
+    expect(ic({ prop1: "b", prop2: "c" })).toBe("c");
+    expect(ic(unique)).toBe(2);
+    delete unique.prop2;
+    expect(ic(unique)).toBeUndefined();
+    unique.prop2 = "d";
+    expect(ic(unique)).toBe("d");
+    expect(ic({ prop2: "a" })).toBe("a");
+});
+
+test("Megamorphic call sites share a cache keyed by shape and property name", () => {
+    function getA(o) {
+        return o.a;
+    }
+
+    function getB(o) {
+        return o.b;
+    }
+
+    function putA(o, value) {
+        o.a = value;
+    }
+
+    // Enough shapes to push every call site past its own entries, with "a" and "b" at different offsets in each.
+    let objects = [];
+    for (let i = 0; i < 16; ++i) {
+        let o = {};
+        for (let j = 0; j < i; ++j) o["padding" + j] = j;
+        if (i % 2 === 0) {
+            o.a = i;
+            o.b = -i;
+        } else {
+            o.b = -i;
+            o.a = i;
+        }
+        objects.push(o);
+    }
+
+    for (let round = 0; round < 3; ++round) {
+        for (let i = 0; i < objects.length; ++i) {
+            expect(getA(objects[i])).toBe(i + round * 100);
+            expect(getB(objects[i])).toBe(-i);
+            putA(objects[i], i + (round + 1) * 100);
+        }
+    }
+
+    // Changing an object's shape must not make it hit on its old entry.
+    let o = objects[5];
+    delete o.padding0;
+    expect(getA(o)).toBe(305);
+    expect(getB(o)).toBe(-5);
+    o.padding0 = "x";
+    expect(getA(o)).toBe(305);
+    expect(o.padding0).toBe("x");
+});
+
+test("Megamorphic call site with a unique shape", () => {
+    function get(o) {
+        return o.prop2;
+    }
+
+    for (let i = 0; i < 8; ++i) {
+        let o = {};
+        for (let j = 0; j < i; ++j) o["padding" + j] = j;
+        o.prop2 = i;
+        expect(get(o)).toBe(i);
+    }
+
+    let unique = {};
+    for (let x = 0; x < 1000; ++x) {
+        unique["prop" + x] = x;
+    }
+
+    expect(get(unique)).toBe(2);
+    expect(get(unique)).toBe(2);
+    delete unique.prop2;
+    expect(get(unique)).toBeUndefined();
+    unique.prop2 = "d";
+    expect(get(unique)).toBe("d");
+});
@@ -19,6 +19,28 @@ void RequestClient::ensure_connection(URL const& url, ::RequestServer::CacheLeve
     async_ensure_connection(url, cache_level);
 }
 
+void RequestClient::load_http_cache_entry(DeprecatedString const& key, Function<void(Optional<ByteBuffer>)> on_complete)
+{
+    auto load_id = m_next_http_cache_load_id++;
+    m_pending_http_cache_loads.set(load_id, move(on_complete));
+    async_load_http_cache_entry(load_id, key);
+}
+
+void RequestClient::store_http_cache_entry(DeprecatedString const& key, ByteBuffer entry)
+{
+    async_store_http_cache_entry(key, move(entry));
+}
+
+void RequestClient::remove_http_cache_entry(DeprecatedString const& key)
+{
+    async_remove_http_cache_entry(key);
+}
+
+void RequestClient::clear_http_cache()
+{
+    async_clear_http_cache();
+}
+
 template<typename RequestHashMapTraits>
 RefPtr<Request> RequestClient::start_request(DeprecatedString const& method, URL const& url, HashMap<DeprecatedString, DeprecatedString, RequestHashMapTraits> const& request_headers, ReadonlyBytes request_body, Core::ProxyData const& proxy_data)
 {
@@ -93,6 +115,20 @@ void RequestClient::certificate_requested(i32 request_id)
     }
 }
 
+void RequestClient::http_cache_entry_loaded(i32 load_id, Optional<ByteBuffer> const& entry)
+{
+    auto on_complete = m_pending_http_cache_loads.take(load_id);
+    if (!on_complete.has_value())
+        return;
+
+    Optional<ByteBuffer> entry_copy;
+    if (entry.has_value()) {
+        if (auto bytes = ByteBuffer::copy(*entry); !bytes.is_error())
+            entry_copy = bytes.release_value();
+    }
+    (*on_complete)(move(entry_copy));
+}
+
 }
 
 template RefPtr<Protocol::Request> Protocol::RequestClient::start_request(DeprecatedString const& method, URL const&, HashMap<DeprecatedString, DeprecatedString> const& request_headers, ReadonlyBytes request_body, Core::ProxyData const&);
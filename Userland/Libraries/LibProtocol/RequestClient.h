@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Function.h>
 #include <AK/HashMap.h>
 #include <LibIPC/ConnectionToServer.h>
 #include <RequestServer/RequestClientEndpoint.h>
@@ -28,6 +29,11 @@ public:
 
     void ensure_connection(URL const&, ::RequestServer::CacheLevel);
 
+    void load_http_cache_entry(DeprecatedString const& key, Function<void(Optional<ByteBuffer>)> on_complete);
+    void store_http_cache_entry(DeprecatedString const& key, ByteBuffer entry);
+    void remove_http_cache_entry(DeprecatedString const& key);
+    void clear_http_cache();
+
     bool stop_request(Badge<Request>, Request&);
     bool set_certificate(Badge<Request>, Request&, DeprecatedString, DeprecatedString);
 
@@ -36,8 +42,12 @@ private:
     virtual void request_finished(i32, bool, u64) override;
     virtual void certificate_requested(i32) override;
     virtual void headers_became_available(i32, HashMap<DeprecatedString, DeprecatedString, CaseInsensitiveStringTraits> const&, Optional<u32> const&) override;
+    virtual void http_cache_entry_loaded(i32, Optional<ByteBuffer> const&) override;
 
     HashMap<i32, RefPtr<Request>> m_requests;
+
+    HashMap<i32, Function<void(Optional<ByteBuffer>)>> m_pending_http_cache_loads;
+    i32 m_next_http_cache_load_id { 0 };
 };
 
 }
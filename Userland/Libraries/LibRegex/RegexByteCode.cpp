@@ -941,6 +941,33 @@ Vector<CompareTypeAndValuePair> OpCode_Compare::flat_compares() const
     return result;
 }
 
+bool OpCode_Compare::has_argument_of_type(CharacterCompareType type) const
+{
+    // flat_compares() splits strings up into their characters, so this has to look at the arguments as they are.
+    size_t offset { state().instruction_position + 3 };
+
+    for (size_t i = 0; i < arguments_count(); ++i) {
+        auto compare_type = (CharacterCompareType)m_bytecode->at(offset++);
+        if (compare_type == type)
+            return true;
+
+        if (compare_type == CharacterCompareType::String || compare_type == CharacterCompareType::LookupTable) {
+            auto length = m_bytecode->at(offset++);
+            offset += length;
+        } else if (compare_type == CharacterCompareType::Char
+            || compare_type == CharacterCompareType::Reference
+            || compare_type == CharacterCompareType::CharClass
+            || compare_type == CharacterCompareType::CharRange
+            || compare_type == CharacterCompareType::GeneralCategory
+            || compare_type == CharacterCompareType::Property
+            || compare_type == CharacterCompareType::Script
+            || compare_type == CharacterCompareType::ScriptExtension) {
+            ++offset;
+        }
+    }
+    return false;
+}
+
 Vector<DeprecatedString> OpCode_Compare::variable_arguments_to_deprecated_string(Optional<MatchInput const&> input) const
 {
     Vector<DeprecatedString> result;
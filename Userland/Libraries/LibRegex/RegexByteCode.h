@@ -763,6 +763,7 @@ public:
     DeprecatedString arguments_string() const override;
     Vector<DeprecatedString> variable_arguments_to_deprecated_string(Optional<MatchInput const&> input = {}) const;
     Vector<CompareTypeAndValuePair> flat_compares() const;
+    bool has_argument_of_type(CharacterCompareType) const;
     static bool matches_character_class(CharClass, u32, bool insensitive);
 
 private:
@@ -0,0 +1,341 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/QuickSort.h>
+#include <AK/Utf16View.h>
+#include <AK/Utf32View.h>
+#include <LibRegex/RegexLazyDFA.h>
+
+namespace regex {
+
+// Every state costs a little over 1 KiB; once this many exist, the cache is thrown away and rebuilt from scratch.
+static constexpr size_t max_state_count = 1024;
+
+// Patterns that keep exhausting the cache aren't worth it, at that point we leave everything to the VM.
+static constexpr size_t max_cache_flush_count = 16;
+
+// Marks the (single) accepting state, which is never left once entered.
+static constexpr size_t accepting_position = NumericLimits<size_t>::max();
+
+Optional<LazyDFA::InputKind> LazyDFA::input_kind_for(RegexStringView const& view)
+{
+    // In unicode mode, positions in UTF-8 and UTF-16 input refer to code points that span several elements.
+    if (view.is_string_view() && !view.unicode())
+        return InputKind::Bytes;
+    if (view.is_u16_view() && !view.unicode())
+        return InputKind::CodeUnits;
+    if (view.is_u32_view())
+        return InputKind::CodePoints;
+    return {};
+}
+
+bool LazyDFA::can_handle(AllOptions options)
+{
+    // Line-based matching (and the options that only make sense with it) would need the automaton to know what
+    // precedes and follows each position.
+    return !options.has_flag_set(AllFlags::Multiline)
+        && !options.has_flag_set(AllFlags::MatchNotBeginOfLine)
+        && !options.has_flag_set(AllFlags::MatchNotEndOfLine);
+}
+
+bool LazyDFA::can_handle(ByteCode const& bytecode)
+{
+    MatchState state;
+    while (state.instruction_position < bytecode.size()) {
+        auto& opcode = bytecode.get_opcode(state);
+        switch (opcode.opcode_id()) {
+        case OpCodeId::Save:
+        case OpCodeId::Restore:
+        case OpCodeId::GoBack:
+            // Lookaround.
+            return false;
+        case OpCodeId::Compare: {
+            // Backreferences depend on earlier input, and strings consume more than one position at once.
+            auto& compare = static_cast<OpCode_Compare const&>(opcode);
+            if (compare.has_argument_of_type(CharacterCompareType::Reference) || compare.has_argument_of_type(CharacterCompareType::String))
+                return false;
+            break;
+        }
+        default:
+            break;
+        }
+        state.instruction_position += opcode.size();
+    }
+    return true;
+}
+
+NonnullOwnPtr<LazyDFA> LazyDFA::create(ByteCode const& bytecode, AllOptions options, InputKind input_kind)
+{
+    VERIFY(can_handle(options));
+    return adopt_own(*new LazyDFA(bytecode, options, input_kind));
+}
+
+LazyDFA::LazyDFA(ByteCode const& bytecode, AllOptions options, InputKind input_kind)
+    : m_bytecode(bytecode)
+    , m_options(options)
+    , m_input_kind(input_kind)
+    , m_unicode(options.has_flag_set(AllFlags::Unicode))
+{
+}
+
+void LazyDFA::add_closure(Closure& closure, size_t instruction_position, bool at_begin, bool at_end) const
+{
+    Vector<size_t, 16> work_list;
+    work_list.append(instruction_position);
+
+    auto add_jump_target = [&](size_t next_instruction_position, ssize_t offset) {
+        work_list.append(static_cast<size_t>(static_cast<ssize_t>(next_instruction_position) + offset));
+    };
+
+    while (!work_list.is_empty()) {
+        auto position = work_list.take_last();
+        if (closure.visited.set(position) != HashSetResult::InsertedNewEntry)
+            continue;
+
+        if (position >= m_bytecode.size()) {
+            closure.is_accepting = true;
+            continue;
+        }
+
+        MatchState state;
+        state.instruction_position = position;
+        auto& opcode = m_bytecode.get_opcode(state);
+        auto next_position = position + opcode.size();
+
+        switch (opcode.opcode_id()) {
+        case OpCodeId::Compare:
+            closure.positions.append(position);
+            break;
+        case OpCodeId::CheckBegin:
+            if (at_begin)
+                work_list.append(next_position);
+            break;
+        case OpCodeId::CheckEnd:
+            if (at_end)
+                work_list.append(next_position);
+            else
+                closure.positions.append(position);
+            break;
+        case OpCodeId::Jump:
+            add_jump_target(next_position, static_cast<OpCode_Jump const&>(opcode).offset());
+            break;
+        case OpCodeId::ForkJump:
+            add_jump_target(next_position, static_cast<OpCode_ForkJump const&>(opcode).offset());
+            work_list.append(next_position);
+            break;
+        case OpCodeId::ForkStay:
+            add_jump_target(next_position, static_cast<OpCode_ForkStay const&>(opcode).offset());
+            work_list.append(next_position);
+            break;
+        case OpCodeId::ForkReplaceJump:
+            add_jump_target(next_position, static_cast<OpCode_ForkReplaceJump const&>(opcode).offset());
+            work_list.append(next_position);
+            break;
+        case OpCodeId::ForkReplaceStay:
+            add_jump_target(next_position, static_cast<OpCode_ForkReplaceStay const&>(opcode).offset());
+            work_list.append(next_position);
+            break;
+        case OpCodeId::JumpNonEmpty:
+            add_jump_target(next_position, static_cast<OpCode_JumpNonEmpty const&>(opcode).offset());
+            work_list.append(next_position);
+            break;
+        case OpCodeId::Repeat:
+            // Any number of iterations is let through, not just the requested count.
+            work_list.append(position - static_cast<OpCode_Repeat const&>(opcode).offset());
+            work_list.append(next_position);
+            break;
+        case OpCodeId::Exit:
+            // An explicit Exit before the end of the bytecode fails the match.
+            break;
+        case OpCodeId::Save:
+        case OpCodeId::Restore:
+        case OpCodeId::GoBack:
+            VERIFY_NOT_REACHED();
+        default:
+            // Captures, checkpoints, atomic group markers and word boundaries don't affect what input is accepted
+            // (or, for the latter two, are assumed not to).
+            work_list.append(next_position);
+            break;
+        }
+    }
+}
+
+Optional<size_t> LazyDFA::position_after_compare(size_t instruction_position, u32 element) const
+{
+    MatchState state;
+    state.instruction_position = instruction_position;
+    auto& opcode = m_bytecode.get_opcode(state);
+    if (opcode.opcode_id() != OpCodeId::Compare)
+        return {};
+
+    // A compare only ever looks at the character at the current position, so running it on an input consisting of
+    // just that character gives the same answer as running it anywhere in the real input.
+    char byte = static_cast<char>(element);
+    u16 code_unit = static_cast<u16>(element);
+    RegexStringView view = [&]() -> RegexStringView {
+        switch (m_input_kind) {
+        case InputKind::Bytes:
+            return StringView { &byte, 1 };
+        case InputKind::CodeUnits:
+            return Utf16View { ReadonlySpan<u16> { &code_unit, 1 } };
+        case InputKind::CodePoints:
+            return Utf32View { &element, 1 };
+        }
+        VERIFY_NOT_REACHED();
+    }();
+    view.set_unicode(m_unicode);
+
+    MatchInput input;
+    input.view = view;
+    input.regex_options = m_options;
+
+    if (opcode.execute(input, state) != ExecutionResult::Continue || state.string_position != 1)
+        return {};
+    return instruction_position + opcode.size();
+}
+
+LazyDFA::StateIndex LazyDFA::intern(Closure&& closure)
+{
+    if (closure.is_accepting)
+        closure.positions = { accepting_position };
+    else
+        quick_sort(closure.positions);
+
+    if (auto index = m_state_indices.get(closure.positions); index.has_value())
+        return *index;
+
+    if (m_states.size() >= max_state_count) {
+        if (m_cache_generation >= max_cache_flush_count) {
+            m_gave_up = true;
+            return unknown_state;
+        }
+        m_states.clear();
+        m_state_indices.clear();
+        m_start_state_at_begin = unknown_state;
+        m_start_state_after_begin = unknown_state;
+        ++m_cache_generation;
+    }
+
+    auto state = make<State>();
+    state->positions = move(closure.positions);
+    state->is_accepting = closure.is_accepting;
+    state->transitions.fill(unknown_state);
+
+    auto index = static_cast<StateIndex>(m_states.size());
+    m_state_indices.set(state->positions, index);
+    m_states.append(move(state));
+    return index;
+}
+
+LazyDFA::StateIndex LazyDFA::start_state(bool at_begin)
+{
+    auto& start_state = at_begin ? m_start_state_at_begin : m_start_state_after_begin;
+    if (start_state == unknown_state) {
+        Closure closure;
+        add_closure(closure, 0, at_begin, false);
+        // Interning may flush the cache, which resets both start states; the new one is valid either way.
+        start_state = intern(move(closure));
+    }
+    return start_state;
+}
+
+LazyDFA::StateIndex LazyDFA::transition(StateIndex index, u32 element)
+{
+    auto& state = *m_states[index];
+    if (element < state.transitions.size()) {
+        if (auto next = state.transitions[element]; next != unknown_state)
+            return next;
+    } else if (auto next = state.wide_transitions.get(element); next.has_value()) {
+        return *next;
+    }
+
+    Closure closure;
+    for (auto position : state.positions) {
+        if (auto next_position = position_after_compare(position, element); next_position.has_value())
+            add_closure(closure, *next_position, false, false);
+    }
+
+    // This is a search, so a new match may start after every character.
+    add_closure(closure, 0, false, false);
+
+    auto generation = m_cache_generation;
+    auto next = intern(move(closure));
+    if (next == unknown_state || generation != m_cache_generation)
+        return next;
+
+    if (element < state.transitions.size())
+        state.transitions[element] = next;
+    else
+        state.wide_transitions.set(element, next);
+    return next;
+}
+
+bool LazyDFA::accepts_at_end(StateIndex index)
+{
+    auto& state = *m_states[index];
+    if (!state.accepts_at_end.has_value()) {
+        // Only end-of-input checks can still succeed here. Whether this is also the beginning of the input isn't
+        // tracked, so assume it might be.
+        Closure closure;
+        for (auto position : state.positions)
+            add_closure(closure, position, true, true);
+        state.accepts_at_end = closure.is_accepting;
+    }
+    return *state.accepts_at_end;
+}
+
+bool LazyDFA::may_match(RegexStringView const& view, size_t start_position)
+{
+    VERIFY(input_kind_for(view) == m_input_kind);
+
+    if (m_gave_up)
+        return true;
+
+    auto length = view.length();
+    if (start_position > length)
+        return false;
+
+    auto run = [&](auto element_at) {
+        auto index = start_state(start_position == 0);
+        for (size_t position = start_position; index != unknown_state; ++position) {
+            auto const& state = *m_states[index];
+            if (state.is_accepting)
+                return true;
+            if (position == length)
+                return accepts_at_end(index);
+
+            auto element = element_at(position);
+            if (!element.has_value())
+                return true;
+            index = transition(index, *element);
+        }
+        return true;
+    };
+
+    switch (m_input_kind) {
+    case InputKind::Bytes: {
+        auto bytes = view.string_view().bytes();
+        return run([&](size_t position) -> Optional<u32> { return bytes[position]; });
+    }
+    case InputKind::CodeUnits: {
+        auto const& u16_view = view.u16_view();
+        return run([&](size_t position) -> Optional<u32> {
+            // Character classes look at the whole surrogate pair, so the result doesn't only depend on this code unit.
+            auto code_unit = u16_view.code_unit_at(position);
+            if (Utf16View::is_high_surrogate(code_unit))
+                return {};
+            return code_unit;
+        });
+    }
+    case InputKind::CodePoints: {
+        auto const& u32_view = view.u32_view();
+        return run([&](size_t position) -> Optional<u32> { return u32_view.at(position); });
+    }
+    }
+    VERIFY_NOT_REACHED();
+}
+
+}
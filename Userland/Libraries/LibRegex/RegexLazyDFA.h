@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include "RegexByteCode.h"
+#include "RegexMatch.h"
+#include "RegexOptions.h"
+
+#include <AK/Array.h>
+#include <AK/HashFunctions.h>
+#include <AK/HashMap.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/NumericLimits.h>
+#include <AK/OwnPtr.h>
+#include <AK/Types.h>
+#include <AK/Vector.h>
+
+namespace regex {
+
+// A deterministic automaton for the bytecode, whose states are built (and cached) only as the input asks for them.
+// It answers a single question: can the pattern match anywhere at or after a given position? That lets the matcher
+// reject inputs without running the backtracking VM at every position of them.
+// Constructs the automaton can't express exactly (atomic groups, counted repetition, word boundaries) are treated as
+// if they always let the match through, so it may claim a match that the VM then doesn't find, but never the reverse.
+class LazyDFA {
+    AK_MAKE_NONCOPYABLE(LazyDFA);
+    AK_MAKE_NONMOVABLE(LazyDFA);
+
+public:
+    // What a single position of the input refers to.
+    enum class InputKind : u8 {
+        Bytes,
+        CodeUnits,
+        CodePoints,
+    };
+
+    static Optional<InputKind> input_kind_for(RegexStringView const&);
+
+    // Patterns with backreferences or lookaround can't be handled, and neither can line-based matching.
+    static bool can_handle(ByteCode const&);
+    static bool can_handle(AllOptions);
+
+    static NonnullOwnPtr<LazyDFA> create(ByteCode const&, AllOptions, InputKind);
+
+    AllOptions options() const { return m_options; }
+    InputKind input_kind() const { return m_input_kind; }
+
+    // Returns false only if no match can start at or after `start_position`.
+    // The view has to be of this automaton's input kind.
+    bool may_match(RegexStringView const&, size_t start_position);
+
+private:
+    using StateIndex = u32;
+    static constexpr StateIndex unknown_state = NumericLimits<StateIndex>::max();
+
+    // Instruction positions of the compares (and end-of-input checks) the NFA is waiting at.
+    using PositionSet = Vector<size_t>;
+
+    struct PositionSetTraits : public DefaultTraits<PositionSet> {
+        static unsigned hash(PositionSet const& positions)
+        {
+            unsigned hash = 0;
+            for (auto position : positions)
+                hash = pair_int_hash(hash, u64_hash(position));
+            return hash;
+        }
+        static bool equals(PositionSet const& a, PositionSet const& b) { return a == b; }
+    };
+
+    struct State {
+        PositionSet positions;
+        bool is_accepting { false };
+        Optional<bool> accepts_at_end;
+        Array<StateIndex, 256> transitions;
+        HashMap<u32, StateIndex> wide_transitions;
+    };
+
+    struct Closure {
+        HashTable<size_t> visited;
+        PositionSet positions;
+        bool is_accepting { false };
+    };
+
+    LazyDFA(ByteCode const&, AllOptions, InputKind);
+
+    void add_closure(Closure&, size_t instruction_position, bool at_begin, bool at_end) const;
+    Optional<size_t> position_after_compare(size_t instruction_position, u32 element) const;
+
+    StateIndex start_state(bool at_begin);
+    StateIndex transition(StateIndex, u32 element);
+    bool accepts_at_end(StateIndex);
+    StateIndex intern(Closure&&);
+
+    ByteCode const& m_bytecode;
+    AllOptions m_options;
+    InputKind m_input_kind;
+    bool m_unicode { false };
+
+    Vector<NonnullOwnPtr<State>> m_states;
+    HashMap<PositionSet, StateIndex, PositionSetTraits> m_state_indices;
+    StateIndex m_start_state_at_begin { unknown_state };
+    StateIndex m_start_state_after_begin { unknown_state };
+
+    // Bumped every time the state cache is flushed, which invalidates every StateIndex handed out before.
+    size_t m_cache_generation { 0 };
+    bool m_gave_up { false };
+};
+
+}
@@ -10,6 +10,7 @@
 #include <AK/StringBuilder.h>
 #include <LibRegex/RegexMatcher.h>
 #include <LibRegex/RegexParser.h>
+#include <string.h>
 
 #if REGEX_DEBUG
 #    include <LibRegex/RegexDebug.h>
@@ -99,6 +100,40 @@ DeprecatedString Regex<Parser>::error_string(Optional<DeprecatedString> message)
     return eb.to_deprecated_string();
 }
 
+// memchr() is vectorized on most platforms, so find candidates by their first byte and only then compare the rest.
+static Optional<size_t> find_literal(StringView haystack, StringView needle, size_t start)
+{
+    while (start + needle.length() <= haystack.length()) {
+        auto const* haystack_start = haystack.characters_without_null_termination();
+        auto const* candidate = static_cast<char const*>(memchr(haystack_start + start, needle[0], haystack.length() - needle.length() - start + 1));
+        if (!candidate)
+            return {};
+
+        size_t offset = candidate - haystack_start;
+        if (haystack.substring_view(offset, needle.length()) == needle)
+            return offset;
+        start = offset + 1;
+    }
+    return {};
+}
+
+template<typename Parser>
+LazyDFA* Matcher<Parser>::lazy_dfa_for(AllOptions options, RegexStringView const& view) const
+{
+    auto input_kind = LazyDFA::input_kind_for(view);
+    if (!input_kind.has_value() || !LazyDFA::can_handle(options))
+        return nullptr;
+
+    if (!m_pattern_supports_lazy_dfa.has_value())
+        m_pattern_supports_lazy_dfa = LazyDFA::can_handle(m_pattern->parser_result.bytecode);
+    if (!*m_pattern_supports_lazy_dfa)
+        return nullptr;
+
+    if (!m_lazy_dfa || m_lazy_dfa->options().value() != options.value() || m_lazy_dfa->input_kind() != *input_kind)
+        m_lazy_dfa = LazyDFA::create(m_pattern->parser_result.bytecode, options, *input_kind);
+    return m_lazy_dfa.ptr();
+}
+
 template<typename Parser>
 RegexResult Matcher<Parser>::match(RegexStringView view, Optional<typename ParserTraits<Parser>::OptionsType> regex_options) const
 {
@@ -185,6 +220,8 @@ RegexResult Matcher<Parser>::match(Vector<RegexStringView> const& views, Optiona
 
     auto single_match_only = input.regex_options.has_flag_set(AllFlags::SingleMatch);
 
+    auto const& optimization_data = m_pattern->parser_result.optimization_data;
+
     for (auto const& view : views) {
         if (lines_to_skip != 0) {
             ++input.line;
@@ -200,6 +237,25 @@ RegexResult Matcher<Parser>::match(Vector<RegexStringView> const& views, Optiona
         state.string_position_in_code_units = view_index;
         bool succeeded = false;
 
+        // Searches mostly look at input that doesn't match at all; the DFA can tell without trying every position.
+        if (continue_search && !optimization_data.pure_substring_search.has_value()) {
+            if (auto* lazy_dfa = lazy_dfa_for(input.regex_options, view); lazy_dfa && !lazy_dfa->may_match(view, view_index)) {
+                ++input.line;
+                input.global_offset += view.length() + 1;
+
+                // Leave a stateful matcher where trying (and failing) at every position below would have left it.
+                if (input.regex_options.has_flag_set(AllFlags::Internal_Stateful)) {
+                    auto last_start = view_length - min(view_length, m_pattern->parser_result.match_length_minimum);
+                    m_pattern->start_offset = max(view_index, last_start);
+                }
+                continue;
+            }
+        }
+
+        StringView required_prefix;
+        if (continue_search && optimization_data.required_prefix.has_value() && view.is_string_view() && !view.unicode() && !input.regex_options.has_flag_set(AllFlags::Insensitive))
+            required_prefix = optimization_data.required_prefix.value();
+
         if (view_index == view_length && m_pattern->parser_result.match_length_minimum == 0) {
             // Run the code until it tries to consume something.
             // This allows non-consuming code to run on empty strings, for instance
@@ -235,6 +291,14 @@ RegexResult Matcher<Parser>::match(Vector<RegexStringView> const& views, Optiona
             if (view_index == view_length && input.regex_options.has_flag_set(AllFlags::Multiline))
                 break;
 
+            // No match can start before the next occurrence of the prefix.
+            if (!required_prefix.is_empty()) {
+                auto next_occurrence = find_literal(view.string_view(), required_prefix, view_index);
+                if (!next_occurrence.has_value())
+                    break;
+                view_index = next_occurrence.value();
+            }
+
             auto& match_length_minimum = m_pattern->parser_result.match_length_minimum;
             // FIXME: More performant would be to know the remaining minimum string
             //        length needed to match from the current position onwards within
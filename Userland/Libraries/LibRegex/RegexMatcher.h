@@ -7,6 +7,7 @@
 #pragma once
 
 #include "RegexByteCode.h"
+#include "RegexLazyDFA.h"
 #include "RegexMatch.h"
 #include "RegexOptions.h"
 #include "RegexParser.h"
@@ -70,13 +71,19 @@ public:
     void reset_pattern(Badge<Regex<Parser>>, Regex<Parser> const* pattern)
     {
         m_pattern = pattern;
+        m_lazy_dfa = nullptr;
+        m_pattern_supports_lazy_dfa.clear();
     }
 
 private:
     bool execute(MatchInput const& input, MatchState& state, size_t& operations) const;
+    LazyDFA* lazy_dfa_for(AllOptions, RegexStringView const&) const;
 
     Regex<Parser> const* m_pattern;
     typename ParserTraits<Parser>::OptionsType const m_regex_options;
+
+    mutable OwnPtr<LazyDFA> m_lazy_dfa;
+    mutable Optional<bool> m_pattern_supports_lazy_dfa;
 };
 
 template<class Parser>
@@ -232,6 +239,7 @@ private:
     void run_optimization_passes();
     void attempt_rewrite_loops_as_atomic_groups(BasicBlockList const&);
     bool attempt_rewrite_entire_match_as_substring_search(BasicBlockList const&);
+    void find_required_prefix();
 };
 
 // free standing functions for match, search and has_match
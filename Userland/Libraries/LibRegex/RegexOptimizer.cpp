@@ -29,14 +29,15 @@ void Regex<Parser>::run_optimization_passes()
     parser_result.bytecode.flatten();
 
     auto blocks = split_basic_blocks(parser_result.bytecode);
-    if (attempt_rewrite_entire_match_as_substring_search(blocks))
-        return;
+    if (!attempt_rewrite_entire_match_as_substring_search(blocks)) {
+        // Rewrite fork loops as atomic groups
+        // e.g. a*b -> (ATOMIC a*)b
+        attempt_rewrite_loops_as_atomic_groups(blocks);
 
-    // Rewrite fork loops as atomic groups
-    // e.g. a*b -> (ATOMIC a*)b
-    attempt_rewrite_loops_as_atomic_groups(blocks);
+        parser_result.bytecode.flatten();
+    }
 
-    parser_result.bytecode.flatten();
+    find_required_prefix();
 }
 
 template<typename Parser>
@@ -572,6 +573,56 @@ bool Regex<Parser>::attempt_rewrite_entire_match_as_substring_search(BasicBlockL
     return true;
 }
 
+template<typename Parser>
+void Regex<Parser>::find_required_prefix()
+{
+    // Execution always starts at the first instruction, so every match has to get past the compares at the start of
+    // the bytecode before anything can branch away from them, e.g. /foo(bar|baz)*/ -> "foo".
+    auto& bytecode = parser_result.bytecode;
+
+    StringBuilder prefix;
+    MatchState state;
+    auto is_prefix_complete = false;
+    while (!is_prefix_complete && state.instruction_position < bytecode.size()) {
+        auto& opcode = bytecode.get_opcode(state);
+        switch (opcode.opcode_id()) {
+        case OpCodeId::Compare: {
+            auto& compare = static_cast<OpCode_Compare const&>(opcode);
+            auto flat_compares = compare.flat_compares();
+            // A single string compare shows up as its characters, anything else with more than one entry is a set.
+            auto is_sequence = compare.arguments_count() == 1 && compare.has_argument_of_type(CharacterCompareType::String);
+            if (flat_compares.is_empty() || (flat_compares.size() != 1 && !is_sequence)) {
+                is_prefix_complete = true;
+                break;
+            }
+            for (auto const& flat_compare : flat_compares) {
+                // Keep to ASCII, so the prefix means the same bytes whichever way the input is encoded.
+                if (flat_compare.type != CharacterCompareType::Char || flat_compare.value > 0x7f) {
+                    is_prefix_complete = true;
+                    break;
+                }
+                prefix.append(static_cast<char>(flat_compare.value));
+            }
+            break;
+        }
+        // These neither consume input nor branch.
+        case OpCodeId::SaveLeftCaptureGroup:
+        case OpCodeId::SaveRightCaptureGroup:
+        case OpCodeId::SaveRightNamedCaptureGroup:
+        case OpCodeId::ClearCaptureGroup:
+        case OpCodeId::Checkpoint:
+            break;
+        default:
+            is_prefix_complete = true;
+            break;
+        }
+        state.instruction_position += opcode.size();
+    }
+
+    if (!prefix.is_empty())
+        parser_result.optimization_data.required_prefix = prefix.to_deprecated_string();
+}
+
 template<typename Parser>
 void Regex<Parser>::attempt_rewrite_loops_as_atomic_groups(BasicBlockList const& basic_blocks)
 {
@@ -58,6 +58,8 @@ public:
 
         struct {
             Optional<DeprecatedString> pure_substring_search;
+            // Every match starts with these (ASCII) characters.
+            Optional<DeprecatedString> required_prefix;
         } optimization_data {};
     };
 
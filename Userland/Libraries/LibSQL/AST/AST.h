@@ -71,18 +71,24 @@ private:
 
 class ColumnDefinition : public ASTNode {
 public:
-    ColumnDefinition(DeprecatedString name, NonnullRefPtr<TypeName> type_name)
+    ColumnDefinition(DeprecatedString name, NonnullRefPtr<TypeName> type_name, bool is_primary_key, bool is_unique)
         : m_name(move(name))
         , m_type_name(move(type_name))
+        , m_is_primary_key(is_primary_key)
+        , m_is_unique(is_unique)
     {
     }
 
     DeprecatedString const& name() const { return m_name; }
     NonnullRefPtr<TypeName> const& type_name() const { return m_type_name; }
+    bool is_primary_key() const { return m_is_primary_key; }
+    bool is_unique() const { return m_is_unique; }
 
 private:
     DeprecatedString m_name;
     NonnullRefPtr<TypeName> m_type_name;
+    bool m_is_primary_key { false };
+    bool m_is_unique { false };
 };
 
 class CommonTableExpression : public ASTNode {
@@ -1107,4 +1113,18 @@ private:
     NonnullRefPtr<QualifiedTableName> m_qualified_table_name;
 };
 
+class Explain : public Statement {
+public:
+    explicit Explain(NonnullRefPtr<Statement> statement)
+        : m_statement(move(statement))
+    {
+    }
+
+    NonnullRefPtr<Statement> const& statement() const { return m_statement; }
+    ResultOr<ResultSet> execute(ExecutionContext&) const override;
+
+private:
+    NonnullRefPtr<Statement> m_statement;
+};
+
 }
@@ -6,6 +6,7 @@
 
 #include <LibSQL/AST/AST.h>
 #include <LibSQL/Database.h>
+#include <LibSQL/Meta.h>
 
 namespace SQL::AST {
 
@@ -13,6 +14,7 @@ ResultOr<ResultSet> CreateTable::execute(ExecutionContext& context) const
 {
     auto schema_def = TRY(context.database->get_schema(m_schema_name));
     auto table_def = TRY(TableDef::create(schema_def, m_table_name));
+    bool has_primary_key = false;
 
     for (auto const& column : m_columns) {
         SQLType type;
@@ -29,6 +31,21 @@ ResultOr<ResultSet> CreateTable::execute(ExecutionContext& context) const
             return Result { SQLCommand::Create, SQLErrorCode::InvalidType, column->type_name()->name() };
 
         table_def->append_column(column->name(), type);
+
+        // Primary keys and unique columns are backed by a unique index, named the way PostgreSQL names them.
+        if (column->is_primary_key()) {
+            if (has_primary_key)
+                return Result { SQLCommand::Create, SQLErrorCode::MultiplePrimaryKeys, m_table_name };
+            has_primary_key = true;
+
+            auto index_def = TRY(IndexDef::create(table_def, DeprecatedString::formatted("{}_pkey", m_table_name), true));
+            index_def->append_column(column->name(), type);
+            table_def->append_index(move(index_def));
+        } else if (column->is_unique()) {
+            auto index_def = TRY(IndexDef::create(table_def, DeprecatedString::formatted("{}_{}_key", m_table_name, column->name()), true));
+            index_def->append_column(column->name(), type);
+            table_def->append_index(move(index_def));
+        }
     }
 
     if (auto result = context.database->add_table(*table_def); result.is_error()) {
@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/TypeCasts.h>
+#include <LibSQL/AST/AST.h>
+#include <LibSQL/AST/QueryPlan.h>
+#include <LibSQL/ResultSet.h>
+#include <LibSQL/Tuple.h>
+
+namespace SQL::AST {
+
+ResultOr<ResultSet> Explain::execute(ExecutionContext& context) const
+{
+    if (!is<Select>(*m_statement))
+        return Result { SQLCommand::Explain, SQLErrorCode::NotYetImplemented, "Only SELECT statements can be explained"sv };
+
+    auto access_plans = TRY(plan_table_accesses(context, static_cast<Select const&>(*m_statement)));
+
+    auto descriptor = adopt_ref(*new TupleDescriptor);
+    descriptor->append({ "", "", "plan", SQLType::Text });
+
+    ResultSet result { SQLCommand::Explain, { "plan" } };
+    TRY(result.try_ensure_capacity(access_plans.size()));
+
+    for (auto const& access_plan : access_plans) {
+        Tuple tuple(descriptor);
+        tuple[0] = access_plan.to_deprecated_string();
+
+        result.insert_row(tuple, Tuple {});
+    }
+
+    return result;
+}
+
+}
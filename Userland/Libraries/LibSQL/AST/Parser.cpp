@@ -49,6 +49,8 @@ NonnullRefPtr<Statement> Parser::parse_statement()
         return parse_drop_table_statement();
     case TokenType::Describe:
         return parse_describe_table_statement();
+    case TokenType::Explain:
+        return parse_explain_statement();
     case TokenType::Insert:
         return parse_insert_statement({});
     case TokenType::Update:
@@ -58,7 +60,7 @@ NonnullRefPtr<Statement> Parser::parse_statement()
     case TokenType::Select:
         return parse_select_statement({});
     default:
-        expected("CREATE, ALTER, DROP, DESCRIBE, INSERT, UPDATE, DELETE, or SELECT"sv);
+        expected("CREATE, ALTER, DROP, DESCRIBE, EXPLAIN, INSERT, UPDATE, DELETE, or SELECT"sv);
         return create_ast_node<ErrorStatement>();
     }
 }
@@ -194,6 +196,19 @@ NonnullRefPtr<DescribeTable> Parser::parse_describe_table_statement()
     return create_ast_node<DescribeTable>(move(table_name));
 }
 
+NonnullRefPtr<Explain> Parser::parse_explain_statement()
+{
+    // https://sqlite.org/lang_explain.html
+    consume(TokenType::Explain);
+
+    // Note: SQLite distinguishes between EXPLAIN, which dumps the bytecode of the statement, and EXPLAIN QUERY PLAN. We
+    // don't compile statements to bytecode, so both forms describe the query plan.
+    if (consume_if(TokenType::Query))
+        consume(TokenType::Plan);
+
+    return create_ast_node<Explain>(parse_statement());
+}
+
 NonnullRefPtr<Insert> Parser::parse_insert_statement(RefPtr<CommonTableExpressionList> common_table_expression_list)
 {
     // https://sqlite.org/lang_insert.html
@@ -901,9 +916,29 @@ NonnullRefPtr<ColumnDefinition> Parser::parse_column_definition()
         // https://www.sqlite.org/datatype3.html: If no type is specified then the column has affinity BLOB.
         : create_ast_node<TypeName>("BLOB", Vector<NonnullRefPtr<SignedNumber>> {});
 
-    // FIXME: Parse "column-constraint".
+    // https://sqlite.org/syntax/column-constraint.html
+    bool is_primary_key = false;
+    bool is_unique = false;
+
+    while (true) {
+        if (consume_if(TokenType::Constraint)) {
+            consume(TokenType::Identifier);
+            if (!match(TokenType::Primary) && !match(TokenType::Unique))
+                expected("PRIMARY KEY or UNIQUE"sv);
+        }
+
+        if (consume_if(TokenType::Primary)) {
+            consume(TokenType::Key);
+            is_primary_key = true;
+        } else if (consume_if(TokenType::Unique)) {
+            is_unique = true;
+        } else {
+            // FIXME: Parse the remaining kinds of "column-constraint".
+            break;
+        }
+    }
 
-    return create_ast_node<ColumnDefinition>(move(name), move(type_name));
+    return create_ast_node<ColumnDefinition>(move(name), move(type_name), is_primary_key, is_unique);
 }
 
 NonnullRefPtr<TypeName> Parser::parse_type_name()
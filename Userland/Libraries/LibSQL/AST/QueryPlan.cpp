@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Math.h>
+#include <AK/StringBuilder.h>
+#include <AK/TypeCasts.h>
+#include <LibSQL/AST/QueryPlan.h>
+#include <LibSQL/Database.h>
+
+namespace SQL::AST {
+
+// FIXME: We don't keep statistics about tables yet, so plans are costed as if every table held this many rows.
+static constexpr double assumed_row_count = 1000;
+
+// Like SQLite, assume that every bound of a range restricts the selection to a quarter of the rows.
+static constexpr double range_bound_selectivity = 0.25;
+
+static void collect_conjuncts(Expression const& expression, Vector<Expression const*>& conjuncts)
+{
+    if (is<BinaryOperatorExpression>(expression)) {
+        auto const& binary_expression = static_cast<BinaryOperatorExpression const&>(expression);
+        if (binary_expression.type() == BinaryOperator::And) {
+            collect_conjuncts(*binary_expression.lhs(), conjuncts);
+            collect_conjuncts(*binary_expression.rhs(), conjuncts);
+            return;
+        }
+    }
+
+    // A parenthesized expression is parsed as a chain of a single expression.
+    if (is<ChainedExpression>(expression)) {
+        auto const& chained_expression = static_cast<ChainedExpression const&>(expression);
+        if (chained_expression.expressions().size() == 1) {
+            collect_conjuncts(chained_expression.expressions().first(), conjuncts);
+            return;
+        }
+    }
+
+    conjuncts.append(&expression);
+}
+
+static bool is_constant(Expression const& expression)
+{
+    if (is<NumericLiteral>(expression) || is<StringLiteral>(expression) || is<BooleanLiteral>(expression) || is<Placeholder>(expression))
+        return true;
+    if (is<UnaryOperatorExpression>(expression))
+        return is_constant(*static_cast<UnaryOperatorExpression const&>(expression).expression());
+    return false;
+}
+
+static bool refers_to_column(Expression const& expression, TableDef const& table, DeprecatedString const& column_name)
+{
+    if (!is<ColumnNameExpression>(expression))
+        return false;
+
+    auto const& column_name_expression = static_cast<ColumnNameExpression const&>(expression);
+    if (!column_name_expression.table_name().is_empty() && column_name_expression.table_name() != table.name())
+        return false;
+    return column_name_expression.column_name() == column_name;
+}
+
+static BinaryOperator mirrored_comparison(BinaryOperator type)
+{
+    switch (type) {
+    case BinaryOperator::LessThan:
+        return BinaryOperator::GreaterThan;
+    case BinaryOperator::LessThanEquals:
+        return BinaryOperator::GreaterThanEquals;
+    case BinaryOperator::GreaterThan:
+        return BinaryOperator::LessThan;
+    case BinaryOperator::GreaterThanEquals:
+        return BinaryOperator::LessThanEquals;
+    default:
+        return type;
+    }
+}
+
+static Optional<TableAccessPlan> plan_index_access(ExecutionContext& context, NonnullRefPtr<TableDef> const& table, IndexDef& index, Vector<Expression const*> const& conjuncts)
+{
+    // FIXME: Plan accesses through indexes on more than one column.
+    if (index.size() != 1)
+        return {};
+
+    auto const& key_part = index.key_definition().first();
+    Optional<TableAccessPlan::Bound> lower_bound;
+    Optional<TableAccessPlan::Bound> upper_bound;
+
+    auto tighten_lower_bound = [&](Value const& value, bool is_inclusive) {
+        if (!lower_bound.has_value() || value > lower_bound->value || (value == lower_bound->value && !is_inclusive))
+            lower_bound = TableAccessPlan::Bound { value, is_inclusive };
+    };
+    auto tighten_upper_bound = [&](Value const& value, bool is_inclusive) {
+        if (!upper_bound.has_value() || value < upper_bound->value || (value == upper_bound->value && !is_inclusive))
+            upper_bound = TableAccessPlan::Bound { value, is_inclusive };
+    };
+
+    for (auto const* conjunct : conjuncts) {
+        if (!is<BinaryOperatorExpression>(*conjunct))
+            continue;
+
+        auto const& comparison = static_cast<BinaryOperatorExpression const&>(*conjunct);
+        auto type = comparison.type();
+        Expression const* constant = nullptr;
+
+        if (refers_to_column(*comparison.lhs(), *table, key_part->name())) {
+            constant = comparison.rhs().ptr();
+        } else if (refers_to_column(*comparison.rhs(), *table, key_part->name())) {
+            constant = comparison.lhs().ptr();
+            type = mirrored_comparison(type);
+        } else {
+            continue;
+        }
+
+        if (!is_constant(*constant))
+            continue;
+
+        // Errors are reported when the WHERE clause itself is evaluated.
+        auto value = constant->evaluate(context);
+        if (value.is_error() || !value.value().is_type_compatible_with(key_part->type()))
+            continue;
+
+        switch (type) {
+        case BinaryOperator::Equals:
+            tighten_lower_bound(value.value(), true);
+            tighten_upper_bound(value.value(), true);
+            break;
+        case BinaryOperator::GreaterThan:
+        case BinaryOperator::GreaterThanEquals:
+            tighten_lower_bound(value.value(), type == BinaryOperator::GreaterThanEquals);
+            break;
+        case BinaryOperator::LessThan:
+        case BinaryOperator::LessThanEquals:
+            tighten_upper_bound(value.value(), type == BinaryOperator::LessThanEquals);
+            break;
+        default:
+            break;
+        }
+    }
+
+    // Our comparisons order NULL before every other value, so a range that is only bounded from above would
+    // have to include rows with a NULL key. Those are not indexed.
+    if (!lower_bound.has_value())
+        return {};
+
+    TableAccessPlan plan { table, TableAccessPlan::Strategy::IndexRangeScan, index, lower_bound, upper_bound, 0 };
+    auto descent_cost = AK::log2(assumed_row_count);
+
+    auto is_point_lookup = upper_bound.has_value() && lower_bound->is_inclusive && upper_bound->is_inclusive && lower_bound->value == upper_bound->value;
+    if (is_point_lookup && index.unique()) {
+        plan.strategy = TableAccessPlan::Strategy::IndexLookup;
+        plan.estimated_cost = descent_cost + 1;
+    } else {
+        auto selectivity = upper_bound.has_value() ? range_bound_selectivity * range_bound_selectivity : range_bound_selectivity;
+        plan.estimated_cost = descent_cost + assumed_row_count * selectivity;
+    }
+
+    return plan;
+}
+
+ResultOr<Vector<TableAccessPlan>> plan_table_accesses(ExecutionContext& context, Select const& select)
+{
+    auto const& table_or_subquery_list = select.table_or_subquery_list();
+
+    // FIXME: Also use the WHERE clause to plan accesses to joined tables. Unqualified column names may refer to
+    //        a column of any of them, so a predicate can't simply be attributed to the table that has the column.
+    Vector<Expression const*> conjuncts;
+    if (table_or_subquery_list.size() == 1 && select.where_clause())
+        collect_conjuncts(*select.where_clause(), conjuncts);
+
+    Vector<TableAccessPlan> plans;
+    TRY(plans.try_ensure_capacity(table_or_subquery_list.size()));
+
+    for (auto const& table_descriptor : table_or_subquery_list) {
+        if (!table_descriptor->is_table())
+            return Result { SQLCommand::Select, SQLErrorCode::NotYetImplemented, "Sub-selects are not yet implemented"sv };
+
+        auto table_def = TRY(context.database->get_table(table_descriptor->schema_name(), table_descriptor->table_name()));
+        if (table_def->num_columns() == 0)
+            continue;
+
+        TableAccessPlan best_plan { table_def, TableAccessPlan::Strategy::FullScan, {}, {}, {}, assumed_row_count };
+        for (auto const& index : table_def->indexes()) {
+            auto plan = plan_index_access(context, table_def, index, conjuncts);
+            if (plan.has_value() && plan->estimated_cost < best_plan.estimated_cost)
+                best_plan = plan.release_value();
+        }
+
+        plans.unchecked_append(move(best_plan));
+    }
+
+    return plans;
+}
+
+ResultOr<Vector<Row>> TableAccessPlan::fetch_rows(Database& database) const
+{
+    if (strategy == Strategy::FullScan)
+        return TRY(database.select_all(*table));
+
+    VERIFY(index);
+
+    Optional<Value> lower_value;
+    if (lower_bound.has_value())
+        lower_value = lower_bound->value;
+
+    Optional<Value> upper_value;
+    if (upper_bound.has_value())
+        upper_value = upper_bound->value;
+
+    return TRY(database.select_from_index(*table, *index, lower_value, upper_value));
+}
+
+DeprecatedString TableAccessPlan::to_deprecated_string() const
+{
+    StringBuilder builder;
+
+    if (strategy == Strategy::FullScan) {
+        builder.appendff("SCAN TABLE {}.{}", table->parent()->name(), table->name());
+        return builder.to_deprecated_string();
+    }
+
+    auto const& column_name = index->key_definition().first()->name();
+    builder.appendff("SEARCH TABLE {}.{} USING INDEX {} (", table->parent()->name(), table->name(), index->name());
+
+    if (strategy == Strategy::IndexLookup) {
+        builder.appendff("{} = {}", column_name, lower_bound->value);
+    } else {
+        builder.appendff("{} {} {}", column_name, lower_bound->is_inclusive ? ">="sv : ">"sv, lower_bound->value);
+        if (upper_bound.has_value())
+            builder.appendff(" AND {} {} {}", column_name, upper_bound->is_inclusive ? "<="sv : "<"sv, upper_bound->value);
+    }
+
+    builder.append(')');
+    return builder.to_deprecated_string();
+}
+
+}
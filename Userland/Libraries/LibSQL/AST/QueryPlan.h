@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/DeprecatedString.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/Optional.h>
+#include <AK/RefPtr.h>
+#include <AK/Vector.h>
+#include <LibSQL/AST/AST.h>
+#include <LibSQL/Forward.h>
+#include <LibSQL/Meta.h>
+#include <LibSQL/Row.h>
+#include <LibSQL/Value.h>
+
+namespace SQL::AST {
+
+/**
+ * A TableAccessPlan describes how the rows of one of the tables a SELECT
+ * statement reads from are retrieved: either by walking the whole table, or
+ * by walking the part of one of the table's indexes that the WHERE clause
+ * restricts the selection to. Index bounds are always inclusive, and the
+ * WHERE clause is still evaluated for every row the plan produces.
+ */
+struct TableAccessPlan {
+    enum class Strategy {
+        FullScan,
+        IndexLookup,
+        IndexRangeScan,
+    };
+
+    struct Bound {
+        Value value;
+        bool is_inclusive { true };
+    };
+
+    NonnullRefPtr<TableDef> table;
+    Strategy strategy { Strategy::FullScan };
+    RefPtr<IndexDef> index {};
+    Optional<Bound> lower_bound {};
+    Optional<Bound> upper_bound {};
+    double estimated_cost { 0 };
+
+    ResultOr<Vector<Row>> fetch_rows(Database&) const;
+    DeprecatedString to_deprecated_string() const;
+};
+
+ResultOr<Vector<TableAccessPlan>> plan_table_accesses(ExecutionContext&, Select const&);
+
+}
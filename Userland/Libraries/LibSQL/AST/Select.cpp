@@ -6,6 +6,7 @@
 
 #include <AK/NumericLimits.h>
 #include <LibSQL/AST/AST.h>
+#include <LibSQL/AST/QueryPlan.h>
 #include <LibSQL/Database.h>
 #include <LibSQL/Meta.h>
 #include <LibSQL/Row.h>
@@ -92,20 +93,16 @@ ResultOr<ResultSet> Select::execute(ExecutionContext& context) const
     tuple.append(Value { true });
     rows.append(tuple);
 
-    for (auto& table_descriptor : table_or_subquery_list()) {
-        if (!table_descriptor->is_table())
-            return Result { SQLCommand::Select, SQLErrorCode::NotYetImplemented, "Sub-selects are not yet implemented"sv };
-
-        auto table_def = TRY(context.database->get_table(table_descriptor->schema_name(), table_descriptor->table_name()));
-        if (table_def->num_columns() == 0)
-            continue;
+    auto access_plans = TRY(plan_table_accesses(context, *this));
 
+    for (auto const& access_plan : access_plans) {
         auto old_descriptor_size = descriptor->size();
-        descriptor->extend(table_def->to_tuple_descriptor());
+        descriptor->extend(access_plan.table->to_tuple_descriptor());
+
+        auto table_rows = TRY(access_plan.fetch_rows(*context.database));
 
         while (!rows.is_empty() && (rows.first().size() == old_descriptor_size)) {
             auto cartesian_row = rows.take_first();
-            auto table_rows = TRY(context.database->select_all(*table_def));
 
             for (auto& table_row : table_rows) {
                 auto new_row = cartesian_row;
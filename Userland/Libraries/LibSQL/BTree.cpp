@@ -84,6 +84,8 @@ Optional<u32> BTree::get(Key& key)
 {
     if (!m_root)
         initialize_root();
+    if (m_root->size() == 0)
+        return {};
     return m_root->get(key);
 }
 
@@ -103,6 +105,28 @@ BTreeIterator BTree::find(Key const& key)
     return end();
 }
 
+BTreeIterator BTree::lower_bound(Key const& key)
+{
+    if (!m_root)
+        initialize_root();
+
+    // Every entry in the subtree left of the first entry not less than the key
+    // sorts before that entry, so the deepest such entry we pass on the way down
+    // is the first one in the tree that is not less than the key.
+    auto candidate = end();
+    for (auto* node = m_root.ptr(); node && node->size() > 0;) {
+        size_t ix = 0;
+        while (ix < node->size() && (*node)[ix] < key)
+            ++ix;
+        if (ix < node->size())
+            candidate = BTreeIterator(node, (int)ix);
+        if (node->is_leaf())
+            break;
+        node = node->down_node(ix);
+    }
+    return candidate;
+}
+
 void BTree::list_tree()
 {
     if (!m_root)
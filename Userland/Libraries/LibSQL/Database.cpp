@@ -15,6 +15,39 @@
 
 namespace SQL {
 
+// Index keys hold values of the indexed column's type, so that all keys in a tree compare
+// the same way regardless of how the value was spelled in the statement that produced it.
+static Value normalized_index_value(Value const& value, SQLType type)
+{
+    switch (type) {
+    case SQLType::Integer:
+        if (auto integer = value.to_int<i64>(); integer.has_value())
+            return Value { *integer };
+        break;
+    case SQLType::Float:
+        if (auto number = value.to_double(); number.has_value())
+            return Value { *number };
+        break;
+    default:
+        break;
+    }
+    return value;
+}
+
+// Rows with a NULL in an indexed column are not indexed, as NULL is never equal to anything.
+static Optional<Key> index_key_for_row(BTree const& tree, IndexDef const& index, Row const& row)
+{
+    Key key(tree.descriptor());
+    for (auto const& part : index.key_definition()) {
+        auto const& value = row[part->name()];
+        if (value.is_null())
+            return {};
+        key[part->name()] = normalized_index_value(value, part->type());
+    }
+    key.set_block_index(row.block_index());
+    return key;
+}
+
 ErrorOr<NonnullRefPtr<Database>> Database::create(DeprecatedString name)
 {
     auto heap = TRY(Heap::create(move(name)));
@@ -47,6 +80,11 @@ ResultOr<void> Database::open()
         m_heap->set_table_columns_root(m_table_columns->root());
     };
 
+    m_table_indexes = TRY(BTree::create(m_serializer, IndexDef::index_def()->to_tuple_descriptor(), m_heap->table_indexes_root()));
+    m_table_indexes->on_new_root = [&]() {
+        m_heap->set_table_indexes_root(m_table_indexes->root());
+    };
+
     m_open = true;
 
     auto ensure_schema_exists = [&](auto schema_name) -> ResultOr<NonnullRefPtr<SchemaDef>> {
@@ -136,6 +174,20 @@ ResultOr<void> Database::add_table(TableDef& table)
             VERIFY_NOT_REACHED();
     }
 
+    for (auto& index : table.indexes()) {
+        // FIXME: Support non-unique indexes. Their entries can't be told apart by key alone,
+        //        which we rely on to repoint entries when rows are updated or removed.
+        VERIFY(index->unique());
+
+        if (!m_table_indexes->insert(index->key()))
+            VERIFY_NOT_REACHED();
+
+        for (auto& key_part : index->key_definition()) {
+            if (!m_table_columns->insert(key_part->key()))
+                VERIFY_NOT_REACHED();
+        }
+    }
+
     return {};
 }
 
@@ -172,6 +224,19 @@ ResultOr<NonnullRefPtr<TableDef>> Database::get_table(DeprecatedString const& sc
     for (auto it = m_table_columns->find(column_key); !it.is_end() && ((*it)["table_hash"].to_int<u32>() == table_hash); ++it)
         table_def->append_column(*it);
 
+    auto index_key = IndexDef::make_key(table_def);
+    for (auto it = m_table_indexes->find(index_key); !it.is_end() && ((*it)["table_hash"].to_int<u32>() == table_hash); ++it) {
+        auto is_unique = (*it)["unique"].to_int<i32>() == 1;
+        auto index_def = TRY(IndexDef::create(table_def, (*it)["index_name"].to_deprecated_string(), is_unique, (*it).block_index()));
+
+        auto index_hash = index_def->hash();
+        auto key_part_key = ColumnDef::make_key(index_def);
+        for (auto part_it = m_table_columns->find(key_part_key); !part_it.is_end() && ((*part_it)["table_hash"].to_int<u32>() == index_hash); ++part_it)
+            index_def->append_column(*part_it);
+
+        table_def->append_index(move(index_def));
+    }
+
     return table_def;
 }
 
@@ -184,6 +249,39 @@ ErrorOr<Vector<Row>> Database::select_all(TableDef& table)
     return ret;
 }
 
+ErrorOr<Vector<Row>> Database::select_from_index(TableDef& table, IndexDef& index, Optional<Value> const& lower_bound, Optional<Value> const& upper_bound)
+{
+    VERIFY(m_table_cache.get(table.key().hash()).has_value());
+    VERIFY(index.parent() == &table);
+    VERIFY(index.size() == 1);
+
+    auto tree = TRY(index_tree(index));
+    auto key_type = index.key_definition().first()->type();
+
+    auto make_key = [&](Value const& value) {
+        Key key(tree->descriptor());
+        key[0] = normalized_index_value(value, key_type);
+        return key;
+    };
+
+    auto it = lower_bound.has_value() ? tree->lower_bound(make_key(*lower_bound)) : tree->begin();
+
+    Optional<Key> upper_key;
+    if (upper_bound.has_value())
+        upper_key = make_key(*upper_bound);
+
+    Vector<Row> ret;
+    for (; !it.is_end(); ++it) {
+        if (upper_key.has_value() && *it > *upper_key)
+            break;
+
+        // Entries of removed rows are kept around with a null pointer, see remove_from_indexes().
+        if (auto block_index = (*it).block_index(); block_index != 0)
+            TRY(ret.try_append(m_serializer.deserialize_block<Row>(block_index, table, block_index)));
+    }
+    return ret;
+}
+
 ErrorOr<Vector<Row>> Database::match(TableDef& table, Key const& key)
 {
     VERIFY(m_table_cache.get(table.key().hash()).has_value());
@@ -200,16 +298,20 @@ ErrorOr<Vector<Row>> Database::match(TableDef& table, Key const& key)
     return ret;
 }
 
-ErrorOr<void> Database::insert(Row& row)
+ResultOr<void> Database::insert(Row& row)
 {
     VERIFY(m_table_cache.get(row.table().key().hash()).has_value());
-    // TODO: implement table constraints such as unique, foreign key, etc.
+    // TODO: implement table constraints such as foreign key, etc.
+
+    // Callers may reuse a Row for several insertions, so forget any block index left over
+    // from a previous one before looking for rows with conflicting keys.
+    row.set_block_index(0);
+    TRY(ensure_unique_constraints(row));
 
     row.set_block_index(m_heap->request_new_block_index());
     row.set_next_block_index(row.table().block_index());
-    TRY(update(row));
-
-    // TODO update indexes defined on table.
+    write_row(row);
+    TRY(add_to_indexes(row));
 
     auto table_key = row.table().key();
     table_key.set_block_index(row.block_index());
@@ -223,6 +325,7 @@ ErrorOr<void> Database::remove(Row& row)
     auto& table = row.table();
     VERIFY(m_table_cache.get(table.key().hash()).has_value());
 
+    TRY(remove_from_indexes(row));
     TRY(m_heap->free_storage(row.block_index()));
 
     if (table.block_index() == row.block_index()) {
@@ -239,7 +342,7 @@ ErrorOr<void> Database::remove(Row& row)
 
         if (current.next_block_index() == row.block_index()) {
             current.set_next_block_index(row.next_block_index());
-            TRY(update(current));
+            write_row(current);
             break;
         }
 
@@ -249,16 +352,119 @@ ErrorOr<void> Database::remove(Row& row)
     return {};
 }
 
-ErrorOr<void> Database::update(Row& tuple)
+ResultOr<void> Database::update(Row& row)
 {
-    VERIFY(m_table_cache.get(tuple.table().key().hash()).has_value());
-    // TODO: implement table constraints such as unique, foreign key, etc.
+    auto& table = row.table();
+    VERIFY(m_table_cache.get(table.key().hash()).has_value());
+    // TODO: implement table constraints such as foreign key, etc.
 
+    if (table.indexes().is_empty()) {
+        write_row(row);
+        return {};
+    }
+
+    TRY(ensure_unique_constraints(row));
+    auto old_row = m_serializer.deserialize_block<Row>(row.block_index(), table, row.block_index());
+
+    write_row(row);
+
+    for (auto& index : table.indexes()) {
+        auto tree = TRY(index_tree(index));
+        auto old_key = index_key_for_row(tree, index, old_row);
+        auto new_key = index_key_for_row(tree, index, row);
+        if (old_key == new_key)
+            continue;
+
+        if (old_key.has_value())
+            remove_from_index(tree, old_key.release_value());
+        if (new_key.has_value())
+            add_to_index(tree, new_key.release_value());
+    }
+
+    return {};
+}
+
+void Database::write_row(Row& row)
+{
     m_serializer.reset();
-    m_serializer.serialize_and_write<Tuple>(tuple);
+    m_serializer.serialize_and_write<Tuple>(row);
+}
+
+ErrorOr<NonnullRefPtr<BTree>> Database::index_tree(IndexDef& index)
+{
+    auto index_hash = index.hash();
+    if (auto it = m_index_cache.find(index_hash); it != m_index_cache.end())
+        return it->value;
+
+    auto tree = TRY(BTree::create(m_serializer, index.to_tuple_descriptor(), index.unique(), index.block_index()));
+    tree->on_new_root = [this, index = NonnullRefPtr { index }, tree = tree.ptr()]() {
+        index->set_block_index(tree->root());
+        VERIFY(m_table_indexes->update_key_pointer(index->key()));
+    };
+
+    m_index_cache.set(index_hash, tree);
+    return tree;
+}
+
+ResultOr<void> Database::ensure_unique_constraints(Row const& row)
+{
+    for (auto& index : row.table().indexes()) {
+        if (!index->unique())
+            continue;
+
+        auto tree = TRY(index_tree(index));
+        auto key = index_key_for_row(tree, index, row);
+        if (!key.has_value())
+            continue;
+
+        if (auto existing = tree->get(*key); existing.has_value() && *existing != 0 && *existing != row.block_index())
+            return Result { SQLCommand::Unknown, SQLErrorCode::UniqueConstraintViolated, index->name() };
+    }
+
+    return {};
+}
+
+ErrorOr<void> Database::add_to_indexes(Row const& row)
+{
+    for (auto& index : row.table().indexes()) {
+        auto tree = TRY(index_tree(index));
+        if (auto key = index_key_for_row(tree, index, row); key.has_value())
+            add_to_index(tree, key.release_value());
+    }
+    return {};
+}
 
-    // TODO update indexes defined on table.
+ErrorOr<void> Database::remove_from_indexes(Row const& row)
+{
+    for (auto& index : row.table().indexes()) {
+        auto tree = TRY(index_tree(index));
+        if (auto key = index_key_for_row(tree, index, row); key.has_value())
+            remove_from_index(tree, key.release_value());
+    }
     return {};
 }
 
+void Database::add_to_index(BTree& tree, Key key)
+{
+    // The key may still be present from a row that was since removed or changed, in which
+    // case it is pointed at the new row instead.
+    auto existing_key = key;
+    if (tree.get(existing_key).has_value())
+        VERIFY(tree.update_key_pointer(key));
+    else
+        VERIFY(tree.insert(key));
+}
+
+void Database::remove_from_index(BTree& tree, Key key)
+{
+    // FIXME: BTree does not support removing keys yet. Instead, we keep the key in the tree
+    //        with a null pointer, which index scans skip and which add_to_index() reuses.
+    auto row_block_index = key.block_index();
+    if (auto existing = tree.get(key); !existing.has_value() || *existing != row_block_index)
+        return;
+
+    key.set_block_index(0);
+    VERIFY(tree.update_key_pointer(key));
+}
+
 }
@@ -9,6 +9,7 @@
 
 #include <AK/DeprecatedString.h>
 #include <AK/NonnullRefPtr.h>
+#include <AK/Optional.h>
 #include <AK/RefPtr.h>
 #include <LibSQL/Forward.h>
 #include <LibSQL/Heap.h>
@@ -42,23 +43,35 @@ public:
     ResultOr<NonnullRefPtr<TableDef>> get_table(DeprecatedString const&, DeprecatedString const&);
 
     ErrorOr<Vector<Row>> select_all(TableDef&);
+    ErrorOr<Vector<Row>> select_from_index(TableDef&, IndexDef&, Optional<Value> const& lower_bound, Optional<Value> const& upper_bound);
     ErrorOr<Vector<Row>> match(TableDef&, Key const&);
-    ErrorOr<void> insert(Row&);
+    ResultOr<void> insert(Row&);
     ErrorOr<void> remove(Row&);
-    ErrorOr<void> update(Row&);
+    ResultOr<void> update(Row&);
 
 private:
     explicit Database(NonnullRefPtr<Heap>);
 
+    void write_row(Row&);
+
+    ErrorOr<NonnullRefPtr<BTree>> index_tree(IndexDef&);
+    ResultOr<void> ensure_unique_constraints(Row const&);
+    ErrorOr<void> add_to_indexes(Row const&);
+    ErrorOr<void> remove_from_indexes(Row const&);
+    static void add_to_index(BTree&, Key);
+    static void remove_from_index(BTree&, Key);
+
     bool m_open { false };
     NonnullRefPtr<Heap> m_heap;
     Serializer m_serializer;
     RefPtr<BTree> m_schemas;
     RefPtr<BTree> m_tables;
     RefPtr<BTree> m_table_columns;
+    RefPtr<BTree> m_table_indexes;
 
     HashMap<u32, NonnullRefPtr<SchemaDef>> m_schema_cache;
     HashMap<u32, NonnullRefPtr<TableDef>> m_table_cache;
+    HashMap<u32, NonnullRefPtr<BTree>> m_index_cache;
 };
 
 }
@@ -53,6 +53,7 @@ class DropTable;
 class ErrorExpression;
 class ErrorStatement;
 class ExistsExpression;
+class Explain;
 class Expression;
 class GroupByClause;
 class InChainedExpression;
@@ -292,7 +292,8 @@ constexpr static auto VERSION_OFFSET = FILE_ID.length();
 constexpr static auto SCHEMAS_ROOT_OFFSET = VERSION_OFFSET + sizeof(u32);
 constexpr static auto TABLES_ROOT_OFFSET = SCHEMAS_ROOT_OFFSET + sizeof(u32);
 constexpr static auto TABLE_COLUMNS_ROOT_OFFSET = TABLES_ROOT_OFFSET + sizeof(u32);
-constexpr static auto USER_VALUES_OFFSET = TABLE_COLUMNS_ROOT_OFFSET + sizeof(u32);
+constexpr static auto TABLE_INDEXES_ROOT_OFFSET = TABLE_COLUMNS_ROOT_OFFSET + sizeof(u32);
+constexpr static auto USER_VALUES_OFFSET = TABLE_INDEXES_ROOT_OFFSET + sizeof(u32);
 
 ErrorOr<void> Heap::read_zero_block()
 {
@@ -318,6 +319,9 @@ ErrorOr<void> Heap::read_zero_block()
     memcpy(&m_table_columns_root, block.offset_pointer(TABLE_COLUMNS_ROOT_OFFSET), sizeof(u32));
     dbgln_if(SQL_DEBUG, "Table columns root node: {}", m_table_columns_root);
 
+    memcpy(&m_table_indexes_root, block.offset_pointer(TABLE_INDEXES_ROOT_OFFSET), sizeof(u32));
+    dbgln_if(SQL_DEBUG, "Table indexes root node: {}", m_table_indexes_root);
+
     memcpy(m_user_values.data(), block.offset_pointer(USER_VALUES_OFFSET), m_user_values.size() * sizeof(u32));
     for (auto ix = 0u; ix < m_user_values.size(); ix++) {
         if (m_user_values[ix])
@@ -333,6 +337,7 @@ ErrorOr<void> Heap::update_zero_block()
     dbgln_if(SQL_DEBUG, "Schemas root node: {}", m_schemas_root);
     dbgln_if(SQL_DEBUG, "Tables root node: {}", m_tables_root);
     dbgln_if(SQL_DEBUG, "Table Columns root node: {}", m_table_columns_root);
+    dbgln_if(SQL_DEBUG, "Table Indexes root node: {}", m_table_indexes_root);
     for (auto ix = 0u; ix < m_user_values.size(); ix++) {
         if (m_user_values[ix] > 0)
             dbgln_if(SQL_DEBUG, "User value {}: {}", ix, m_user_values[ix]);
@@ -345,6 +350,7 @@ ErrorOr<void> Heap::update_zero_block()
     buffer_bytes.overwrite(SCHEMAS_ROOT_OFFSET, &m_schemas_root, sizeof(u32));
     buffer_bytes.overwrite(TABLES_ROOT_OFFSET, &m_tables_root, sizeof(u32));
     buffer_bytes.overwrite(TABLE_COLUMNS_ROOT_OFFSET, &m_table_columns_root, sizeof(u32));
+    buffer_bytes.overwrite(TABLE_INDEXES_ROOT_OFFSET, &m_table_indexes_root, sizeof(u32));
     buffer_bytes.overwrite(USER_VALUES_OFFSET, m_user_values.data(), m_user_values.size() * sizeof(u32));
 
     return write_raw_block_to_wal(0, move(buffer));
@@ -356,6 +362,7 @@ ErrorOr<void> Heap::initialize_zero_block()
     m_schemas_root = 0;
     m_tables_root = 0;
     m_table_columns_root = 0;
+    m_table_indexes_root = 0;
     m_next_block = 1;
     for (auto& user : m_user_values)
         user = 0u;
@@ -66,7 +66,7 @@ private:
  */
 class Heap : public RefCounted<Heap> {
 public:
-    static constexpr u32 VERSION = 4;
+    static constexpr u32 VERSION = 5;
 
     static ErrorOr<NonnullRefPtr<Heap>> create(DeprecatedString);
     virtual ~Heap();
@@ -102,6 +102,14 @@ public:
         m_table_columns_root = root;
         update_zero_block().release_value_but_fixme_should_propagate_errors();
     }
+
+    Block::Index table_indexes_root() const { return m_table_indexes_root; }
+
+    void set_table_indexes_root(Block::Index root)
+    {
+        m_table_indexes_root = root;
+        update_zero_block().release_value_but_fixme_should_propagate_errors();
+    }
     u32 version() const { return m_version; }
 
     u32 user_value(size_t index) const
@@ -144,6 +152,7 @@ private:
     Block::Index m_schemas_root { 0 };
     Block::Index m_tables_root { 0 };
     Block::Index m_table_columns_root { 0 };
+    Block::Index m_table_indexes_root { 0 };
     u32 m_version { VERSION };
     Array<u32, 16> m_user_values { 0 };
     HashMap<Block::Index, ByteBuffer> m_write_ahead_log;
@@ -88,6 +88,13 @@ Key ColumnDef::make_key(TableDef const& table_def)
     return key;
 }
 
+Key ColumnDef::make_key(IndexDef const& index_def)
+{
+    Key key(ColumnDef::index_def());
+    key["table_hash"] = index_def.key().hash();
+    return key;
+}
+
 NonnullRefPtr<IndexDef> ColumnDef::index_def()
 {
     NonnullRefPtr<IndexDef> s_index_def = IndexDef::create("$column", true, 0).release_value_but_fixme_should_propagate_errors();
@@ -134,6 +141,14 @@ void IndexDef::append_column(DeprecatedString name, SQLType sql_type, Order sort
     m_key_definition.append(part);
 }
 
+void IndexDef::append_column(Key const& column)
+{
+    auto column_type = column["column_type"].to_int<UnderlyingType<SQLType>>();
+    VERIFY(column_type.has_value());
+
+    append_column(column["column_name"].to_deprecated_string(), static_cast<SQLType>(*column_type));
+}
+
 NonnullRefPtr<TupleDescriptor> IndexDef::to_tuple_descriptor() const
 {
     NonnullRefPtr<TupleDescriptor> ret = adopt_ref(*new TupleDescriptor);
@@ -149,6 +164,7 @@ Key IndexDef::key() const
     key["table_hash"] = parent()->key().hash();
     key["index_name"] = name();
     key["unique"] = unique() ? 1 : 0;
+    key.set_block_index(block_index());
     return key;
 }
 
@@ -206,6 +222,12 @@ void TableDef::append_column(DeprecatedString name, SQLType sql_type)
     m_columns.append(column);
 }
 
+void TableDef::append_index(NonnullRefPtr<IndexDef> index)
+{
+    VERIFY(index->parent() == this);
+    m_indexes.append(move(index));
+}
+
 void TableDef::append_column(Key const& column)
 {
     auto column_type = column["column_type"].to_int<UnderlyingType<SQLType>>();
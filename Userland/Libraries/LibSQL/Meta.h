@@ -82,6 +82,7 @@ public:
 
     static NonnullRefPtr<IndexDef> index_def();
     static Key make_key(TableDef const&);
+    static Key make_key(IndexDef const&);
 
 protected:
     ColumnDef(Relation*, size_t, DeprecatedString, SQLType);
@@ -114,6 +115,7 @@ public:
     bool unique() const { return m_unique; }
     [[nodiscard]] size_t size() const { return m_key_definition.size(); }
     void append_column(DeprecatedString, SQLType, Order = Order::Ascending);
+    void append_column(Key const&);
     Key key() const override;
     [[nodiscard]] NonnullRefPtr<TupleDescriptor> to_tuple_descriptor() const;
     static NonnullRefPtr<IndexDef> index_def();
@@ -135,6 +137,7 @@ public:
     Key key() const override;
     void append_column(DeprecatedString, SQLType);
     void append_column(Key const&);
+    void append_index(NonnullRefPtr<IndexDef>);
     size_t num_columns() { return m_columns.size(); }
     size_t num_indexes() { return m_indexes.size(); }
     Vector<NonnullRefPtr<ColumnDef>> const& columns() const { return m_columns; }
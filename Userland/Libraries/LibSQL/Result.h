@@ -19,6 +19,7 @@ namespace SQL {
     S(Create)                     \
     S(Delete)                     \
     S(Describe)                   \
+    S(Explain)                    \
     S(Insert)                     \
     S(Select)                     \
     S(Update)
@@ -57,6 +58,7 @@ constexpr char const* command_tag(SQLCommand command)
     S(InvalidOperator, "Invalid operator '{}'")                                                   \
     S(InvalidType, "Invalid type '{}'")                                                           \
     S(InvalidValueType, "Invalid type for attribute '{}'")                                        \
+    S(MultiplePrimaryKeys, "Table '{}' has more than one primary key")                            \
     S(NoError, "No error")                                                                        \
     S(NotYetImplemented, "{}")                                                                    \
     S(NumericOperatorTypeMismatch, "Cannot apply '{}' operator to non-numeric operands")          \
@@ -65,7 +67,8 @@ constexpr char const* command_tag(SQLCommand command)
     S(StatementUnavailable, "Statement with id '{}' Unavailable")                                 \
     S(SyntaxError, "Syntax Error")                                                                \
     S(TableDoesNotExist, "Table '{}' does not exist")                                             \
-    S(TableExists, "Table '{}' already exist")
+    S(TableExists, "Table '{}' already exist")                                                    \
+    S(UniqueConstraintViolated, "Unique constraint '{}' violated")
 
 enum class SQLErrorCode {
 #undef __ENUMERATE_SQL_ERROR
@@ -160,10 +160,13 @@ bool TreeNode::insert(Key const& key)
 bool TreeNode::update_key_pointer(Key const& key)
 {
     dbgln_if(SQL_DEBUG, "[#{}] UPDATE({}, {})", block_index(), key.to_deprecated_string(), key.block_index());
-    if (!is_leaf())
-        return node_for(key)->update_key_pointer(key);
 
+    // Keys move up into non-leaf nodes when nodes are split, so the key we are
+    // looking for may live in any node on the path down to the leaf.
     for (auto ix = 0u; ix < size(); ix++) {
+        if (key < m_entries[ix])
+            return is_leaf() ? false : down_node(ix)->update_key_pointer(key);
+
         if (key == m_entries[ix]) {
             dbgln_if(SQL_DEBUG, "[#{}] {} == {}",
                 block_index(), key.to_deprecated_string(), m_entries[ix].to_deprecated_string());
@@ -175,7 +178,9 @@ bool TreeNode::update_key_pointer(Key const& key)
             return true;
         }
     }
-    return false;
+    if (is_leaf())
+        return false;
+    return down_node(size())->update_key_pointer(key);
 }
 
 bool TreeNode::insert_in_leaf(Key const& key)
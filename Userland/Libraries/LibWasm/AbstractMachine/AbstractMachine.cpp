@@ -9,10 +9,31 @@
 #include <LibWasm/AbstractMachine/Configuration.h>
 #include <LibWasm/AbstractMachine/Interpreter.h>
 #include <LibWasm/AbstractMachine/Validator.h>
+#include <LibWasm/JIT/Compiler.h>
+#include <LibWasm/JIT/NativeFunction.h>
 #include <LibWasm/Types.h>
 
 namespace Wasm {
 
+WasmFunction::WasmFunction(FunctionType const& type, ModuleInstance const& module, Module::Function const& code)
+    : m_type(type)
+    , m_module(module)
+    , m_code(code)
+{
+}
+
+WasmFunction::WasmFunction(WasmFunction&&) = default;
+WasmFunction::~WasmFunction() = default;
+
+JIT::NativeFunction const* WasmFunction::get_or_create_native_function()
+{
+    if (!m_did_try_jitting) {
+        m_did_try_jitting = true;
+        m_native_function = JIT::Compiler::compile(*this);
+    }
+    return m_native_function;
+}
+
 Optional<FunctionAddress> Store::allocate(ModuleInstance& module, Module::Function const& function)
 {
     FunctionAddress address { m_functions.size() };
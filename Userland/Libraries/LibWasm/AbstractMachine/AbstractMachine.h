@@ -23,6 +23,10 @@ namespace Wasm {
 class Configuration;
 struct Interpreter;
 
+namespace JIT {
+class NativeFunction;
+}
+
 struct InstantiationError {
     DeprecatedString error { "Unknown error" };
 };
@@ -134,6 +138,12 @@ public:
     template<typename T>
     ALWAYS_INLINE Optional<T> to() const
     {
+        // Fast path: the value already has the requested type, which is what validated code always asks for.
+        if constexpr (IsOneOf<T, i32, i64, float, double, u128>) {
+            if (auto* value = m_value.template get_pointer<T>()) [[likely]]
+                return *value;
+        }
+
         Optional<T> result;
         m_value.visit(
             [&](auto value) {
@@ -333,21 +343,23 @@ private:
 
 class WasmFunction {
 public:
-    explicit WasmFunction(FunctionType const& type, ModuleInstance const& module, Module::Function const& code)
-        : m_type(type)
-        , m_module(module)
-        , m_code(code)
-    {
-    }
+    explicit WasmFunction(FunctionType const& type, ModuleInstance const& module, Module::Function const& code);
+    WasmFunction(WasmFunction&&);
+    ~WasmFunction();
 
     auto& type() const { return m_type; }
     auto& module() const { return m_module; }
     auto& code() const { return m_code; }
 
+    // The function is compiled the first time this is asked for; null if the JIT can't (or won't) compile it.
+    JIT::NativeFunction const* get_or_create_native_function();
+
 private:
     FunctionType m_type;
     ModuleInstance const& m_module;
     Module::Function const& m_code;
+    OwnPtr<JIT::NativeFunction> m_native_function;
+    bool m_did_try_jitting { false };
 };
 
 class HostFunction {
@@ -548,18 +560,23 @@ private:
 
 class Label {
 public:
-    explicit Label(size_t arity, InstructionPointer continuation)
+    explicit Label(size_t arity, InstructionPointer continuation, size_t stack_height)
         : m_arity(arity)
         , m_continuation(continuation)
+        , m_stack_height(stack_height)
     {
     }
 
     auto continuation() const { return m_continuation; }
+    // The number of values a branch to the label carries: the results of a block or an if, but the parameters of a loop.
     auto arity() const { return m_arity; }
+    // The height of the value stack when the label was entered; branching to the label unwinds the stack to this height.
+    auto stack_height() const { return m_stack_height; }
 
 private:
     size_t m_arity { 0 };
     InstructionPointer m_continuation { 0 };
+    size_t m_stack_height { 0 };
 };
 
 class Frame {
@@ -578,30 +595,16 @@ public:
     auto& expression() const { return m_expression; }
     auto arity() const { return m_arity; }
 
+    // The index of the label that delimits the function body in the label stack.
+    auto label_index() const { return m_label_index; }
+    void set_label_index(size_t index) { m_label_index = index; }
+
 private:
     ModuleInstance const& m_module;
     Vector<Value> m_locals;
     Expression const& m_expression;
     size_t m_arity { 0 };
-};
-
-class Stack {
-public:
-    using EntryType = Variant<Value, Label, Frame>;
-    Stack() = default;
-
-    [[nodiscard]] ALWAYS_INLINE bool is_empty() const { return m_data.is_empty(); }
-    ALWAYS_INLINE void push(EntryType entry) { m_data.append(move(entry)); }
-    ALWAYS_INLINE auto pop() { return m_data.take_last(); }
-    ALWAYS_INLINE auto& peek() const { return m_data.last(); }
-    ALWAYS_INLINE auto& peek() { return m_data.last(); }
-
-    ALWAYS_INLINE auto size() const { return m_data.size(); }
-    ALWAYS_INLINE auto& entries() const { return m_data; }
-    ALWAYS_INLINE auto& entries() { return m_data; }
-
-private:
-    Vector<EntryType, 1024> m_data;
+    size_t m_label_index { 0 };
 };
 
 using InstantiationResult = AK::Result<NonnullOwnPtr<ModuleInstance>, InstantiationError>;
@@ -37,6 +37,12 @@ namespace Wasm {
     } while (false)
 
 void BytecodeInterpreter::interpret(Configuration& configuration)
+{
+    interpret_loop<false>(configuration);
+}
+
+template<bool HasInstructionHooks>
+void BytecodeInterpreter::interpret_loop(Configuration& configuration)
 {
     m_trap = Empty {};
     auto& instructions = configuration.frame().expression().instructions();
@@ -54,8 +60,11 @@ void BytecodeInterpreter::interpret(Configuration& configuration)
         }
         auto& instruction = instructions[current_ip_value.value()];
         auto old_ip = current_ip_value;
-        interpret(configuration, current_ip_value, instruction);
-        if (did_trap())
+        if constexpr (HasInstructionHooks)
+            interpret(configuration, current_ip_value, instruction);
+        else
+            interpret_instruction(configuration, current_ip_value, instruction);
+        if (!m_trap.has<Empty>()) [[unlikely]]
             return;
         if (current_ip_value == old_ip) // If no jump occurred
             ++current_ip_value;
@@ -65,24 +74,24 @@ void BytecodeInterpreter::interpret(Configuration& configuration)
 void BytecodeInterpreter::branch_to_label(Configuration& configuration, LabelIndex index)
 {
     dbgln_if(WASM_TRACE_DEBUG, "Branch to label with index {}...", index.value());
+    auto& labels = configuration.label_stack();
     auto label = configuration.nth_label(index.value());
-    dbgln_if(WASM_TRACE_DEBUG, "...which is actually IP {}, and has {} result(s)", label->continuation().value(), label->arity());
-    auto results = pop_values(configuration, label->arity());
-
-    size_t drop_count = index.value() + 1;
-    for (; !configuration.stack().is_empty();) {
-        auto& entry = configuration.stack().peek();
-        if (entry.has<Label>()) {
-            if (--drop_count == 0)
-                break;
-        }
-        configuration.stack().pop();
+    dbgln_if(WASM_TRACE_DEBUG, "...which is actually IP {}, and takes {} value(s)", label.continuation().value(), label.arity());
+
+    // Move the values the branch carries down to where the label's stack began, dropping everything in between.
+    auto& values = configuration.value_stack();
+    auto results_start = values.size() - label.arity();
+    if (results_start != label.stack_height()) {
+        for (size_t i = 0; i < label.arity(); ++i)
+            values[label.stack_height() + i] = move(values[results_start + i]);
+        values.shrink(label.stack_height() + label.arity(), true);
     }
 
-    for (auto& result : results)
-        configuration.stack().push(move(result));
+    // NOTE: The target label itself stays on the stack; loops branch back into their body,
+    //       and everything else branches to the `end` instruction that pops it.
+    labels.shrink(labels.size() - index.value(), true);
 
-    configuration.ip() = label->continuation();
+    configuration.ip() = label.continuation();
 }
 
 template<typename ReadType, typename PushType>
@@ -95,8 +104,8 @@ void BytecodeInterpreter::load_and_push(Configuration& configuration, Instructio
         m_trap = Trap { "Nonexistent memory" };
         return;
     }
-    auto& entry = configuration.stack().peek();
-    auto base = entry.get<Value>().to<i32>();
+    auto& entry = configuration.value_stack().last();
+    auto base = entry.to<i32>();
     if (!base.has_value()) {
         m_trap = Trap { "Memory access out of bounds" };
         return;
@@ -111,7 +120,7 @@ void BytecodeInterpreter::load_and_push(Configuration& configuration, Instructio
     }
     dbgln_if(WASM_TRACE_DEBUG, "load({} : {}) -> stack", instance_address, sizeof(ReadType));
     auto slice = memory->data().bytes().slice(instance_address, sizeof(ReadType));
-    configuration.stack().peek() = Value(static_cast<PushType>(read_value<ReadType>(slice)));
+    configuration.value_stack().last() = Value(static_cast<PushType>(read_value<ReadType>(slice)));
 }
 
 template<typename TDst, typename TSrc>
@@ -130,8 +139,8 @@ void BytecodeInterpreter::load_and_push_mxn(Configuration& configuration, Instru
         m_trap = Trap { "Nonexistent memory" };
         return;
     }
-    auto& entry = configuration.stack().peek();
-    auto base = entry.get<Value>().to<i32>();
+    auto& entry = configuration.value_stack().last();
+    auto base = entry.to<i32>();
     if (!base.has_value()) {
         m_trap = Trap { "Memory access out of bounds" };
         return;
@@ -155,7 +164,7 @@ void BytecodeInterpreter::load_and_push_mxn(Configuration& configuration, Instru
     else
         ByteReader::load(slice.data(), bytes);
 
-    configuration.stack().peek() = Value(bit_cast<u128>(convert_vector<V128>(bytes)));
+    configuration.value_stack().last() = Value(bit_cast<u128>(convert_vector<V128>(bytes)));
 }
 
 template<size_t M>
@@ -168,8 +177,8 @@ void BytecodeInterpreter::load_and_push_m_splat(Configuration& configuration, In
         m_trap = Trap { "Nonexistent memory" };
         return;
     }
-    auto& entry = configuration.stack().peek();
-    auto base = entry.get<Value>().to<i32>();
+    auto& entry = configuration.value_stack().last();
+    auto base = entry.to<i32>();
     if (!base.has_value()) {
         m_trap = Trap { "Memory access out of bounds" };
         return;
@@ -192,7 +201,7 @@ template<size_t M, template<size_t> typename NativeType>
 void BytecodeInterpreter::set_top_m_splat(Wasm::Configuration& configuration, NativeType<M> value)
 {
     auto push = [&](auto result) {
-        configuration.stack().peek() = Value(bit_cast<u128>(result));
+        configuration.value_stack().last() = Value(bit_cast<u128>(result));
     };
 
     if constexpr (IsFloatingPoint<NativeType<32>>) {
@@ -221,8 +230,8 @@ void BytecodeInterpreter::pop_and_push_m_splat(Wasm::Configuration& configuratio
 {
     using PopT = Conditional<M <= 32, NativeType<32>, NativeType<64>>;
     using ReadT = NativeType<M>;
-    auto entry = configuration.stack().peek();
-    auto value = static_cast<ReadT>(*entry.get<Value>().to<PopT>());
+    auto& entry = configuration.value_stack().last();
+    auto value = static_cast<ReadT>(*entry.to<PopT>());
     dbgln_if(WASM_TRACE_DEBUG, "stack({}) -> splat({})", value, M);
     set_top_m_splat<M, NativeType>(configuration, value);
 }
@@ -232,15 +241,15 @@ Optional<VectorType> BytecodeInterpreter::pop_vector(Configuration& configuratio
 {
     auto value = peek_vector<M, SetSign, VectorType>(configuration);
     if (value.has_value())
-        configuration.stack().pop();
+        configuration.value_stack().take_last();
     return value;
 }
 
 template<typename M, template<typename> typename SetSign, typename VectorType>
 Optional<VectorType> BytecodeInterpreter::peek_vector(Configuration& configuration)
 {
-    auto& entry = configuration.stack().peek();
-    auto value = entry.get<Value>().value().get_pointer<u128>();
+    auto& entry = configuration.value_stack().last();
+    auto value = entry.value().get_pointer<u128>();
     if (!value)
         return {};
     auto vector = bit_cast<VectorType>(*value);
@@ -263,17 +272,15 @@ void BytecodeInterpreter::call_address(Configuration& configuration, FunctionAdd
     auto instance = configuration.store().get(address);
     FunctionType const* type { nullptr };
     instance->visit([&](auto const& function) { type = &function.type(); });
-    TRAP_IF_NOT(configuration.stack().entries().size() > type->parameters().size());
+    auto& values = configuration.value_stack();
+    TRAP_IF_NOT(values.size() >= type->parameters().size());
     Vector<Value> args;
     args.ensure_capacity(type->parameters().size());
-    auto span = configuration.stack().entries().span().slice_from_end(type->parameters().size());
-    for (auto& entry : span) {
-        auto* call_argument = entry.get_pointer<Value>();
-        TRAP_IF_NOT(call_argument);
-        args.unchecked_append(move(*call_argument));
-    }
+    auto span = values.span().slice_from_end(type->parameters().size());
+    for (auto& entry : span)
+        args.unchecked_append(move(entry));
 
-    configuration.stack().entries().remove(configuration.stack().size() - span.size(), span.size());
+    values.shrink(values.size() - span.size(), true);
 
     Result result { Trap { ""sv } };
     {
@@ -291,20 +298,18 @@ void BytecodeInterpreter::call_address(Configuration& configuration, FunctionAdd
         return;
     }
 
-    configuration.stack().entries().ensure_capacity(configuration.stack().size() + result.values().size());
+    values.ensure_capacity(values.size() + result.values().size());
     for (auto& entry : result.values().in_reverse())
-        configuration.stack().entries().unchecked_append(move(entry));
+        values.unchecked_append(move(entry));
 }
 
 template<typename PopTypeLHS, typename PushType, typename Operator, typename PopTypeRHS>
 void BytecodeInterpreter::binary_numeric_operation(Configuration& configuration)
 {
-    auto rhs_entry = configuration.stack().pop();
-    auto& lhs_entry = configuration.stack().peek();
-    auto rhs_ptr = rhs_entry.get_pointer<Value>();
-    auto lhs_ptr = lhs_entry.get_pointer<Value>();
-    auto rhs = rhs_ptr->to<PopTypeRHS>();
-    auto lhs = lhs_ptr->to<PopTypeLHS>();
+    auto rhs_entry = configuration.value_stack().take_last();
+    auto& lhs_entry = configuration.value_stack().last();
+    auto rhs = rhs_entry.to<PopTypeRHS>();
+    auto lhs = lhs_entry.to<PopTypeLHS>();
     PushType result;
     auto call_result = Operator {}(lhs.value(), rhs.value());
     if constexpr (IsSpecializationOf<decltype(call_result), AK::Result>) {
@@ -323,9 +328,8 @@ void BytecodeInterpreter::binary_numeric_operation(Configuration& configuration)
 template<typename PopType, typename PushType, typename Operator>
 void BytecodeInterpreter::unary_operation(Configuration& configuration)
 {
-    auto& entry = configuration.stack().peek();
-    auto entry_ptr = entry.get_pointer<Value>();
-    auto value = entry_ptr->to<PopType>();
+    auto& entry = configuration.value_stack().last();
+    auto value = entry.to<PopType>();
     auto call_result = Operator {}(*value);
     PushType result;
     if constexpr (IsSpecializationOf<decltype(call_result), AK::Result>) {
@@ -374,11 +378,11 @@ struct ConvertToRaw<double> {
 template<typename PopT, typename StoreT>
 void BytecodeInterpreter::pop_and_store(Configuration& configuration, Instruction const& instruction)
 {
-    auto entry = configuration.stack().pop();
-    auto value = ConvertToRaw<StoreT> {}(*entry.get<Value>().to<PopT>());
+    auto entry = configuration.value_stack().take_last();
+    auto value = ConvertToRaw<StoreT> {}(*entry.to<PopT>());
     dbgln_if(WASM_TRACE_DEBUG, "stack({}) -> temporary({}b)", value, sizeof(StoreT));
-    auto base_entry = configuration.stack().pop();
-    auto base = base_entry.get<Value>().to<i32>();
+    auto base_entry = configuration.value_stack().take_last();
+    auto base = base_entry.to<i32>();
     store_to_memory(configuration, instruction, { &value, sizeof(StoreT) }, *base);
 }
 
@@ -402,35 +406,28 @@ void BytecodeInterpreter::store_to_memory(Configuration& configuration, Instruct
 template<typename T>
 T BytecodeInterpreter::read_value(ReadonlyBytes data)
 {
-    FixedMemoryStream stream { data };
-    auto value_or_error = stream.read_value<LittleEndian<T>>();
-    if (value_or_error.is_error()) {
+    // NOTE: Callers have already bounds-checked the access against the memory, so this is a plain
+    //       little-endian load rather than a trip through a stream.
+    if (data.size() < sizeof(T)) [[unlikely]] {
         dbgln("Read from {} failed", data.data());
         m_trap = Trap { "Read from memory failed" };
+        return {};
     }
-    return value_or_error.release_value();
+    LittleEndian<T> value;
+    __builtin_memcpy(&value, data.data(), sizeof(T));
+    return value;
 }
 
 template<>
 float BytecodeInterpreter::read_value<float>(ReadonlyBytes data)
 {
-    FixedMemoryStream stream { data };
-    auto raw_value_or_error = stream.read_value<LittleEndian<u32>>();
-    if (raw_value_or_error.is_error())
-        m_trap = Trap { "Read from memory failed" };
-    auto raw_value = raw_value_or_error.release_value();
-    return bit_cast<float>(static_cast<u32>(raw_value));
+    return bit_cast<float>(read_value<u32>(data));
 }
 
 template<>
 double BytecodeInterpreter::read_value<double>(ReadonlyBytes data)
 {
-    FixedMemoryStream stream { data };
-    auto raw_value_or_error = stream.read_value<LittleEndian<u64>>();
-    if (raw_value_or_error.is_error())
-        m_trap = Trap { "Read from memory failed" };
-    auto raw_value = raw_value_or_error.release_value();
-    return bit_cast<double>(static_cast<u64>(raw_value));
+    return bit_cast<double>(read_value<u64>(data));
 }
 
 template<typename V, typename T>
@@ -483,17 +480,17 @@ Vector<Value> BytecodeInterpreter::pop_values(Configuration& configuration, size
     Vector<Value> results;
     results.resize(count);
 
-    for (size_t i = 0; i < count; ++i) {
-        auto top_of_stack = configuration.stack().pop();
-        if (auto value = top_of_stack.get_pointer<Value>())
-            results[i] = move(*value);
-        else
-            TRAP_IF_NOT_NORETURN(value);
-    }
+    for (size_t i = 0; i < count; ++i)
+        results[i] = configuration.value_stack().take_last();
     return results;
 }
 
 void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPointer& ip, Instruction const& instruction)
+{
+    interpret_instruction(configuration, ip, instruction);
+}
+
+void BytecodeInterpreter::interpret_instruction(Configuration& configuration, InstructionPointer& ip, Instruction const& instruction)
 {
     dbgln_if(WASM_TRACE_DEBUG, "Executing instruction {} at ip {}", instruction_name(instruction.opcode()), ip.value());
 
@@ -504,24 +501,24 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
     case Instructions::nop.value():
         return;
     case Instructions::local_get.value():
-        configuration.stack().push(Value(configuration.frame().locals()[instruction.arguments().get<LocalIndex>().value()]));
+        configuration.value_stack().append(Value(configuration.frame().locals()[instruction.arguments().get<LocalIndex>().value()]));
         return;
     case Instructions::local_set.value(): {
-        auto entry = configuration.stack().pop();
-        configuration.frame().locals()[instruction.arguments().get<LocalIndex>().value()] = move(entry.get<Value>());
+        auto entry = configuration.value_stack().take_last();
+        configuration.frame().locals()[instruction.arguments().get<LocalIndex>().value()] = move(entry);
         return;
     }
     case Instructions::i32_const.value():
-        configuration.stack().push(Value(ValueType { ValueType::I32 }, static_cast<i64>(instruction.arguments().get<i32>())));
+        configuration.value_stack().append(Value(instruction.arguments().get<i32>()));
         return;
     case Instructions::i64_const.value():
-        configuration.stack().push(Value(ValueType { ValueType::I64 }, instruction.arguments().get<i64>()));
+        configuration.value_stack().append(Value(instruction.arguments().get<i64>()));
         return;
     case Instructions::f32_const.value():
-        configuration.stack().push(Value(ValueType { ValueType::F32 }, static_cast<double>(instruction.arguments().get<float>())));
+        configuration.value_stack().append(Value(instruction.arguments().get<float>()));
         return;
     case Instructions::f64_const.value():
-        configuration.stack().push(Value(ValueType { ValueType::F64 }, instruction.arguments().get<double>()));
+        configuration.value_stack().append(Value(instruction.arguments().get<double>()));
         return;
     case Instructions::block.value(): {
         size_t arity = 0;
@@ -540,27 +537,19 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
         }
         }
 
-        configuration.stack().entries().insert(configuration.stack().size() - parameter_count, Label(arity, args.end_ip));
+        configuration.label_stack().append(Label(arity, args.end_ip, configuration.value_stack().size() - parameter_count));
         return;
     }
     case Instructions::loop.value(): {
-        size_t arity = 0;
         size_t parameter_count = 0;
         auto& args = instruction.arguments().get<Instruction::StructuredInstructionArgs>();
-        switch (args.block_type.kind()) {
-        case BlockType::Empty:
-            break;
-        case BlockType::Type:
-            arity = 1;
-            break;
-        case BlockType::Index: {
+        if (args.block_type.kind() == BlockType::Index) {
             auto& type = configuration.frame().module().types()[args.block_type.type_index().value()];
-            arity = type.results().size();
             parameter_count = type.parameters().size();
         }
-        }
 
-        configuration.stack().entries().insert(configuration.stack().size() - parameter_count, Label(arity, ip.value() + 1));
+        // NOTE: Branching to a loop goes back to its start, so the branch carries the loop's parameters, not its results.
+        configuration.label_stack().append(Label(parameter_count, ip.value() + 1, configuration.value_stack().size() - parameter_count));
         return;
     }
     case Instructions::if_.value(): {
@@ -580,68 +569,46 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
         }
         }
 
-        auto entry = configuration.stack().pop();
-        auto value = entry.get<Value>().to<i32>();
-        auto end_label = Label(arity, args.end_ip.value());
+        auto entry = configuration.value_stack().take_last();
+        auto value = entry.to<i32>();
+        // NOTE: When there is an else arm, end_ip points one past the `end` instruction.
+        //       Both arms must run into that instruction so that it pops the label.
+        auto end_ip = args.else_ip.has_value() ? args.end_ip.value() - 1 : args.end_ip.value();
+        auto end_label = Label(arity, end_ip, configuration.value_stack().size() - parameter_count);
         if (value.value() == 0) {
             if (args.else_ip.has_value()) {
                 configuration.ip() = args.else_ip.value();
-                configuration.stack().entries().insert(configuration.stack().size() - parameter_count, end_label);
+                configuration.label_stack().append(end_label);
             } else {
                 configuration.ip() = args.end_ip.value() + 1;
             }
         } else {
-            configuration.stack().entries().insert(configuration.stack().size() - parameter_count, end_label);
+            configuration.label_stack().append(end_label);
         }
         return;
     }
     case Instructions::structured_end.value():
-    case Instructions::structured_else.value(): {
-        auto index = configuration.nth_label_index(0);
-        auto label = configuration.stack().entries()[*index].get<Label>();
-        configuration.stack().entries().remove(*index, 1);
-
-        if (instruction.opcode() == Instructions::structured_end)
-            return;
-
-        // Jump to the end label
-        configuration.ip() = label.continuation();
+        configuration.label_stack().take_last();
         return;
-    }
-    case Instructions::return_.value(): {
-        auto& frame = configuration.frame();
-        Checked checked_index { configuration.stack().size() };
-        checked_index -= frame.arity();
-        VERIFY(!checked_index.has_overflow());
-
-        auto index = checked_index.value();
-        size_t i = 1;
-        for (; i <= index; ++i) {
-            auto& entry = configuration.stack().entries()[index - i];
-            if (entry.has<Label>()) {
-                if (configuration.stack().entries()[index - i - 1].has<Frame>())
-                    break;
-            }
-        }
-
-        configuration.stack().entries().remove(index - i + 1, i - 1);
-
-        // Jump past the call/indirect instruction
-        configuration.ip() = configuration.frame().expression().instructions().size();
+    case Instructions::structured_else.value():
+        // Skip the else arm, the end label is popped by the `end` instruction.
+        configuration.ip() = configuration.nth_label(0).continuation();
         return;
-    }
+    case Instructions::return_.value():
+        // The function body's own label sits right above the frame, branching to it unwinds every open block.
+        return branch_to_label(configuration, LabelIndex(configuration.label_stack().size() - 1 - configuration.frame().label_index()));
     case Instructions::br.value():
         return branch_to_label(configuration, instruction.arguments().get<LabelIndex>());
     case Instructions::br_if.value(): {
-        auto entry = configuration.stack().pop();
-        if (entry.get<Value>().to<i32>().value_or(0) == 0)
+        auto entry = configuration.value_stack().take_last();
+        if (entry.to<i32>().value_or(0) == 0)
             return;
         return branch_to_label(configuration, instruction.arguments().get<LabelIndex>());
     }
     case Instructions::br_table.value(): {
         auto& arguments = instruction.arguments().get<Instruction::TableBranchArgs>();
-        auto entry = configuration.stack().pop();
-        auto maybe_i = entry.get<Value>().to<i32>();
+        auto entry = configuration.value_stack().take_last();
+        auto maybe_i = entry.to<i32>();
         if (0 <= *maybe_i) {
             size_t i = *maybe_i;
             if (i < arguments.labels.size())
@@ -660,8 +627,8 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
         auto& args = instruction.arguments().get<Instruction::IndirectCallArgs>();
         auto table_address = configuration.frame().module().tables()[args.table.value()];
         auto table_instance = configuration.store().get(table_address);
-        auto entry = configuration.stack().pop();
-        auto index = entry.get<Value>().to<i32>();
+        auto entry = configuration.value_stack().take_last();
+        auto index = entry.to<i32>();
         TRAP_IF_NOT(index.value() >= 0);
         TRAP_IF_NOT(static_cast<size_t>(index.value()) < table_instance->elements().size());
         auto element = table_instance->elements()[index.value()];
@@ -719,8 +686,8 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
     case Instructions::i64_store32.value():
         return pop_and_store<i64, i32>(configuration, instruction);
     case Instructions::local_tee.value(): {
-        auto& entry = configuration.stack().peek();
-        auto value = entry.get<Value>();
+        auto& entry = configuration.value_stack().last();
+        auto value = entry;
         auto local_index = instruction.arguments().get<LocalIndex>();
         dbgln_if(WASM_TRACE_DEBUG, "stack:peek -> locals({})", local_index.value());
         configuration.frame().locals()[local_index.value()] = move(value);
@@ -731,14 +698,14 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
         auto address = configuration.frame().module().globals()[global_index.value()];
         dbgln_if(WASM_TRACE_DEBUG, "global({}) -> stack", address.value());
         auto global = configuration.store().get(address);
-        configuration.stack().push(Value(global->value()));
+        configuration.value_stack().append(Value(global->value()));
         return;
     }
     case Instructions::global_set.value(): {
         auto global_index = instruction.arguments().get<GlobalIndex>();
         auto address = configuration.frame().module().globals()[global_index.value()];
-        auto entry = configuration.stack().pop();
-        auto value = entry.get<Value>();
+        auto entry = configuration.value_stack().take_last();
+        auto value = entry;
         dbgln_if(WASM_TRACE_DEBUG, "stack -> global({})", address.value());
         auto global = configuration.store().get(address);
         global->set_value(move(value));
@@ -750,7 +717,7 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
         auto instance = configuration.store().get(address);
         auto pages = instance->size() / Constants::page_size;
         dbgln_if(WASM_TRACE_DEBUG, "memory.size -> stack({})", pages);
-        configuration.stack().push(Value((i32)pages));
+        configuration.value_stack().append(Value((i32)pages));
         return;
     }
     case Instructions::memory_grow.value(): {
@@ -758,13 +725,13 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
         auto address = configuration.frame().module().memories()[args.memory_index.value()];
         auto instance = configuration.store().get(address);
         i32 old_pages = instance->size() / Constants::page_size;
-        auto& entry = configuration.stack().peek();
-        auto new_pages = entry.get<Value>().to<i32>();
+        auto& entry = configuration.value_stack().last();
+        auto new_pages = entry.to<i32>();
         dbgln_if(WASM_TRACE_DEBUG, "memory.grow({}), previously {} pages...", *new_pages, old_pages);
         if (instance->grow(new_pages.value() * Constants::page_size))
-            configuration.stack().peek() = Value((i32)old_pages);
+            configuration.value_stack().last() = Value((i32)old_pages);
         else
-            configuration.stack().peek() = Value((i32)-1);
+            configuration.value_stack().last() = Value((i32)-1);
         return;
     }
     // https://webassembly.github.io/spec/core/bikeshed/#exec-memory-fill
@@ -772,9 +739,9 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
         auto& args = instruction.arguments().get<Instruction::MemoryIndexArgument>();
         auto address = configuration.frame().module().memories()[args.memory_index.value()];
         auto instance = configuration.store().get(address);
-        auto count = configuration.stack().pop().get<Value>().to<i32>().value();
-        auto value = configuration.stack().pop().get<Value>().to<i32>().value();
-        auto destination_offset = configuration.stack().pop().get<Value>().to<i32>().value();
+        auto count = configuration.value_stack().take_last().to<i32>().value();
+        auto value = configuration.value_stack().take_last().to<i32>().value();
+        auto destination_offset = configuration.value_stack().take_last().to<i32>().value();
 
         TRAP_IF_NOT(static_cast<size_t>(destination_offset + count) <= instance->data().size());
 
@@ -799,9 +766,9 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
         auto source_instance = configuration.store().get(source_address);
         auto destination_instance = configuration.store().get(destination_address);
 
-        auto count = configuration.stack().pop().get<Value>().to<i32>().value();
-        auto source_offset = configuration.stack().pop().get<Value>().to<i32>().value();
-        auto destination_offset = configuration.stack().pop().get<Value>().to<i32>().value();
+        auto count = configuration.value_stack().take_last().to<i32>().value();
+        auto source_offset = configuration.value_stack().take_last().to<i32>().value();
+        auto destination_offset = configuration.value_stack().take_last().to<i32>().value();
 
         TRAP_IF_NOT(static_cast<size_t>(source_offset + count) <= source_instance->data().size());
         TRAP_IF_NOT(static_cast<size_t>(destination_offset + count) <= destination_instance->data().size());
@@ -833,9 +800,9 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
         auto& args = instruction.arguments().get<Instruction::MemoryInitArgs>();
         auto& data_address = configuration.frame().module().datas()[args.data_index.value()];
         auto& data = *configuration.store().get(data_address);
-        auto count = *configuration.stack().pop().get<Value>().to<i32>();
-        auto source_offset = *configuration.stack().pop().get<Value>().to<i32>();
-        auto destination_offset = *configuration.stack().pop().get<Value>().to<i32>();
+        auto count = *configuration.value_stack().take_last().to<i32>();
+        auto source_offset = *configuration.value_stack().take_last().to<i32>();
+        auto destination_offset = *configuration.value_stack().take_last().to<i32>();
 
         TRAP_IF_NOT(count > 0);
         TRAP_IF_NOT(source_offset + count > 0);
@@ -864,37 +831,37 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
         goto unimplemented;
     case Instructions::ref_null.value(): {
         auto type = instruction.arguments().get<ValueType>();
-        configuration.stack().push(Value(Reference(Reference::Null { type })));
+        configuration.value_stack().append(Value(Reference(Reference::Null { type })));
         return;
     };
     case Instructions::ref_func.value(): {
         auto index = instruction.arguments().get<FunctionIndex>().value();
         auto& functions = configuration.frame().module().functions();
         auto address = functions[index];
-        configuration.stack().push(Value(ValueType(ValueType::FunctionReference), address.value()));
+        configuration.value_stack().append(Value(ValueType(ValueType::FunctionReference), address.value()));
         return;
     }
     case Instructions::ref_is_null.value(): {
-        auto top = configuration.stack().peek().get_pointer<Value>();
+        auto top = &configuration.value_stack().last();
         TRAP_IF_NOT(top->type().is_reference());
         auto is_null = top->to<Reference::Null>().has_value();
-        configuration.stack().peek() = Value(ValueType(ValueType::I32), static_cast<u64>(is_null ? 1 : 0));
+        configuration.value_stack().last() = Value(ValueType(ValueType::I32), static_cast<u64>(is_null ? 1 : 0));
         return;
     }
     case Instructions::drop.value():
-        configuration.stack().pop();
+        configuration.value_stack().take_last();
         return;
     case Instructions::select.value():
     case Instructions::select_typed.value(): {
         // Note: The type seems to only be used for validation.
-        auto entry = configuration.stack().pop();
-        auto value = entry.get<Value>().to<i32>();
+        auto entry = configuration.value_stack().take_last();
+        auto value = entry.to<i32>();
         dbgln_if(WASM_TRACE_DEBUG, "select({})", value.value());
-        auto rhs_entry = configuration.stack().pop();
-        auto& lhs_entry = configuration.stack().peek();
-        auto rhs = move(rhs_entry.get<Value>());
-        auto lhs = move(lhs_entry.get<Value>());
-        configuration.stack().peek() = value.value() != 0 ? move(lhs) : move(rhs);
+        auto rhs_entry = configuration.value_stack().take_last();
+        auto& lhs_entry = configuration.value_stack().last();
+        auto rhs = move(rhs_entry);
+        auto lhs = move(lhs_entry);
+        configuration.value_stack().last() = value.value() != 0 ? move(lhs) : move(rhs);
         return;
     }
     case Instructions::i32_eqz.value():
@@ -1170,7 +1137,7 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
     case Instructions::i64_trunc_sat_f64_u.value():
         return unary_operation<double, i64, Operators::SaturatingTruncate<u64>>(configuration);
     case Instructions::v128_const.value():
-        configuration.stack().push(Value(instruction.arguments().get<u128>()));
+        configuration.value_stack().append(Value(instruction.arguments().get<u128>()));
         return;
     case Instructions::v128_load.value():
         return load_and_push<u128, u128>(configuration, instruction);
@@ -1212,7 +1179,7 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
         auto vector = peek_vector<u8, MakeSigned>(configuration);
         TRAP_IF_NOT(vector.has_value());
         auto result = shuffle_vector(vector.value(), indices.value());
-        configuration.stack().peek() = Value(result);
+        configuration.value_stack().last() = Value(result);
         return;
     }
     case Instructions::v128_store.value():
@@ -1255,6 +1222,11 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
     }
 }
 
+void DebuggerBytecodeInterpreter::interpret(Configuration& configuration)
+{
+    interpret_loop<true>(configuration);
+}
+
 void DebuggerBytecodeInterpreter::interpret(Configuration& configuration, InstructionPointer& ip, Instruction const& instruction)
 {
     if (pre_interpret_hook) {
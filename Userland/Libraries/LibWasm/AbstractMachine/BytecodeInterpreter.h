@@ -29,6 +29,7 @@ struct BytecodeInterpreter : public Interpreter {
             [](JS::Completion const& completion) { return completion.value()->to_string_without_side_effects().to_deprecated_string(); });
     }
     virtual void clear_trap() override { m_trap = Empty {}; }
+    virtual bool can_run_native_code() const override { return true; }
 
     struct CallFrameHandle {
         explicit CallFrameHandle(BytecodeInterpreter& interpreter, Configuration& configuration)
@@ -44,7 +45,12 @@ struct BytecodeInterpreter : public Interpreter {
     };
 
 protected:
+    // The main loop only goes through the virtual per-instruction entry point when a subclass
+    // needs to observe every instruction, everything else dispatches straight into the switch.
+    template<bool HasInstructionHooks>
+    void interpret_loop(Configuration&);
     virtual void interpret(Configuration&, InstructionPointer&, Instruction const&);
+    void interpret_instruction(Configuration&, InstructionPointer&, Instruction const&);
     void branch_to_label(Configuration&, LabelIndex);
     template<typename ReadT, typename PushT>
     void load_and_push(Configuration&, Instruction const&);
@@ -99,6 +105,10 @@ struct DebuggerBytecodeInterpreter : public BytecodeInterpreter {
     }
     virtual ~DebuggerBytecodeInterpreter() override = default;
 
+    virtual void interpret(Configuration&) override;
+    // The hooks have to see every instruction.
+    virtual bool can_run_native_code() const override { return false; }
+
     Function<bool(Configuration&, InstructionPointer&, Instruction const&)> pre_interpret_hook;
     Function<bool(Configuration&, InstructionPointer&, Instruction const&, Interpreter const&)> post_interpret_hook;
 
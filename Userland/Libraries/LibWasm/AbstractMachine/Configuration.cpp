@@ -7,34 +7,24 @@
 #include <AK/MemoryStream.h>
 #include <LibWasm/AbstractMachine/Configuration.h>
 #include <LibWasm/AbstractMachine/Interpreter.h>
+#include <LibWasm/JIT/NativeFunction.h>
 #include <LibWasm/Printer/Printer.h>
 
 namespace Wasm {
 
-Optional<size_t> Configuration::nth_label_index(size_t i)
-{
-    for (size_t index = m_stack.size(); index > 0; --index) {
-        auto& entry = m_stack.entries()[index - 1];
-        if (entry.has<Label>()) {
-            if (i == 0)
-                return index - 1;
-            --i;
-        }
-    }
-    return {};
-}
-
 void Configuration::unwind(Badge<CallFrameHandle>, CallFrameHandle const& frame_handle)
 {
-    if (m_stack.size() == frame_handle.stack_size && frame_handle.frame_index == m_current_frame_index)
+    if (m_frame_stack.size() == frame_handle.frame_stack_size)
         return;
 
-    VERIFY(m_stack.size() > frame_handle.stack_size);
-    m_stack.entries().remove(frame_handle.stack_size, m_stack.size() - frame_handle.stack_size);
-    m_current_frame_index = frame_handle.frame_index;
+    VERIFY(m_frame_stack.size() > frame_handle.frame_stack_size);
+    VERIFY(m_value_stack.size() >= frame_handle.value_stack_size);
+    VERIFY(m_label_stack.size() >= frame_handle.label_stack_size);
+    m_value_stack.shrink(frame_handle.value_stack_size, true);
+    m_label_stack.shrink(frame_handle.label_stack_size, true);
+    m_frame_stack.shrink(frame_handle.frame_stack_size, true);
     m_depth--;
     m_ip = frame_handle.ip;
-    VERIFY(m_stack.size() == frame_handle.stack_size);
 }
 
 Result Configuration::call(Interpreter& interpreter, FunctionAddress address, Vector<Value> arguments)
@@ -43,6 +33,16 @@ Result Configuration::call(Interpreter& interpreter, FunctionAddress address, Ve
     if (!function)
         return Trap {};
     if (auto* wasm_function = function->get_pointer<WasmFunction>()) {
+        // NOTE: Native code can't count the instructions it executes, so it's only used when there's no limit.
+        if (interpreter.can_run_native_code() && !m_should_limit_instruction_count) {
+            if (auto* native_function = wasm_function->get_or_create_native_function()) {
+                MemoryInstance* memory = nullptr;
+                if (!wasm_function->module().memories().is_empty())
+                    memory = m_store.get(wasm_function->module().memories().first());
+                return native_function->run(arguments, memory);
+            }
+        }
+
         Vector<Value> locals = move(arguments);
         locals.ensure_capacity(locals.size() + wasm_function->code().locals().size());
         for (auto& type : wasm_function->code().locals())
@@ -69,17 +69,18 @@ Result Configuration::execute(Interpreter& interpreter)
     if (interpreter.did_trap())
         return Trap { interpreter.trap_reason() };
 
-    if (stack().size() <= frame().arity() + 1)
+    // ASSERT: The only label left is the one delimiting the function body.
+    if (m_label_stack.size() != frame().label_index() + 1)
+        return Trap { "Invalid stack configuration" };
+    auto label = m_label_stack.take_last();
+
+    if (m_value_stack.size() < label.stack_height() + frame().arity())
         return Trap { "Not enough values to return from call" };
 
     Vector<Value> results;
     results.ensure_capacity(frame().arity());
     for (size_t i = 0; i < frame().arity(); ++i)
-        results.append(move(stack().pop().get<Value>()));
-    auto label = stack().pop();
-    // ASSERT: label == current frame
-    if (!label.has<Label>())
-        return Trap { "Invalid stack configuration" };
+        results.unchecked_append(m_value_stack.take_last());
     return Result { move(results) };
 }
 
@@ -92,21 +93,15 @@ void Configuration::dump_stack()
         memory_stream.read_until_filled(buffer).release_value_but_fixme_should_propagate_errors();
         dbgln(format.view(), StringView(buffer).trim_whitespace());
     };
-    for (auto const& entry : stack().entries()) {
-        entry.visit(
-            [&](Value const& v) {
-                print_value("    {}", v);
-            },
-            [&](Frame const& f) {
-                dbgln("    frame({})", f.arity());
-                for (auto& local : f.locals()) {
-                    print_value("        {}", local);
-                }
-            },
-            [](Label const& l) {
-                dbgln("    label({}) -> {}", l.arity(), l.continuation());
-            });
+    for (auto const& frame : m_frame_stack) {
+        dbgln("    frame({})", frame.arity());
+        for (auto& local : frame.locals())
+            print_value("        {}", local);
     }
+    for (auto const& label : m_label_stack)
+        dbgln("    label({}) -> {} @ {}", label.arity(), label.continuation(), label.stack_height());
+    for (auto const& value : m_value_stack)
+        print_value("    {}", value);
 }
 
 }
@@ -16,6 +16,9 @@ struct Interpreter {
     virtual bool did_trap() const = 0;
     virtual DeprecatedString trap_reason() const = 0;
     virtual void clear_trap() = 0;
+
+    // Whether functions may be run as compiled native code instead, which never goes through interpret().
+    virtual bool can_run_native_code() const { return false; }
 };
 
 }
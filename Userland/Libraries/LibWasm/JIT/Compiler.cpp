@@ -0,0 +1,504 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/AllOf.h>
+#include <AK/Debug.h>
+#include <AK/OwnPtr.h>
+#include <AK/Platform.h>
+#include <LibWasm/JIT/Compiler.h>
+#include <LibWasm/Opcode.h>
+#include <LibWasm/Printer/Printer.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#ifdef JIT_ARCH_SUPPORTED
+#    define LOG_JIT_SUCCESS 0
+#    define LOG_JIT_FAILURE 0
+#endif
+
+namespace Wasm::JIT {
+
+#ifdef JIT_ARCH_SUPPORTED
+
+Compiler::Assembler::Operand Compiler::local(size_t index) const
+{
+    return Assembler::Operand::Mem64BaseAndOffset(SLOTS_BASE, index * sizeof(u64));
+}
+
+Compiler::Assembler::Operand Compiler::stack_slot(size_t height) const
+{
+    return Assembler::Operand::Mem64BaseAndOffset(SLOTS_BASE, (m_local_count + height) * sizeof(u64));
+}
+
+void Compiler::push(Assembler::Reg reg)
+{
+    m_assembler.mov(stack_slot(m_stack_height), Assembler::Operand::Register(reg));
+    ++m_stack_height;
+    m_max_stack_height = max(m_max_stack_height, m_stack_height);
+}
+
+Optional<size_t> Compiler::arity_of(BlockType const& block_type) const
+{
+    switch (block_type.kind()) {
+    case BlockType::Empty:
+        return 0;
+    case BlockType::Type:
+        if (block_type.value_type().kind() != ValueType::I32)
+            return {};
+        return 1;
+    case BlockType::Index:
+        // FIXME: Support blocks with parameters and multiple results.
+        return {};
+    }
+    VERIFY_NOT_REACHED();
+}
+
+void Compiler::mark_rest_of_block_unreachable()
+{
+    m_is_unreachable = true;
+    m_unreachable_depth = 0;
+}
+
+void Compiler::compile_branch(size_t label_index)
+{
+    auto& frame = m_control_stack[m_control_stack.size() - label_index - 1];
+
+    // NOTE: Every value below the ones the branch carries is simply forgotten, as the slots are static.
+    if (frame.branch_arity() == 1 && m_stack_height - 1 != frame.stack_height) {
+        m_assembler.mov(Assembler::Operand::Register(GPR0), top());
+        m_assembler.mov(stack_slot(frame.stack_height), Assembler::Operand::Register(GPR0));
+    }
+
+    if (frame.kind == ControlFrame::Kind::Loop)
+        m_assembler.jump(frame.start_label);
+    else
+        m_assembler.jump(frame.end_label);
+}
+
+void Compiler::compile_binary_operation(OpCode opcode)
+{
+    auto lhs = Assembler::Operand::Register(GPR0);
+    auto rhs = Assembler::Operand::Register(GPR1);
+    m_assembler.mov(lhs, top(1));
+    m_assembler.mov(rhs, top(0));
+
+    // NOTE: The 32-bit operations zero the upper half of the result, which keeps every slot zero-extended.
+    //       Shifts take their count from CL (GPR1), and only look at its lowest five bits, just like Wasm.
+    switch (opcode.value()) {
+    case Instructions::i32_add.value():
+        m_assembler.add32(lhs, rhs, {});
+        break;
+    case Instructions::i32_sub.value():
+        m_assembler.sub32(lhs, rhs, {});
+        break;
+    case Instructions::i32_mul.value():
+        m_assembler.mul32(lhs, rhs, {});
+        break;
+    case Instructions::i32_and.value():
+        m_assembler.bitwise_and(lhs, rhs);
+        break;
+    case Instructions::i32_or.value():
+        m_assembler.bitwise_or(lhs, rhs);
+        break;
+    case Instructions::i32_xor.value():
+        m_assembler.bitwise_xor32(lhs, rhs);
+        break;
+    case Instructions::i32_shl.value():
+        m_assembler.shift_left32(lhs, {});
+        break;
+    case Instructions::i32_shrs.value():
+        m_assembler.arithmetic_right_shift32(lhs, {});
+        break;
+    case Instructions::i32_shru.value():
+        m_assembler.shift_right32(lhs, {});
+        break;
+    default:
+        VERIFY_NOT_REACHED();
+    }
+
+    m_assembler.mov(top(1), lhs);
+    --m_stack_height;
+}
+
+void Compiler::compile_comparison(Assembler::Condition condition, bool is_signed)
+{
+    // NOTE: This has to happen before the comparison, as it's done with a flag-clobbering xor.
+    m_assembler.mov(Assembler::Operand::Register(GPR2), Assembler::Operand::Imm(0));
+
+    if (is_signed) {
+        m_assembler.mov32(Assembler::Operand::Register(GPR0), top(1), Assembler::Extension::SignExtend);
+        m_assembler.mov32(Assembler::Operand::Register(GPR1), top(0), Assembler::Extension::SignExtend);
+    } else {
+        m_assembler.mov(Assembler::Operand::Register(GPR0), top(1));
+        m_assembler.mov(Assembler::Operand::Register(GPR1), top(0));
+    }
+    m_assembler.cmp(Assembler::Operand::Register(GPR0), Assembler::Operand::Register(GPR1));
+    m_assembler.set_if(condition, Assembler::Operand::Register(GPR2));
+
+    m_assembler.mov(top(1), Assembler::Operand::Register(GPR2));
+    --m_stack_height;
+}
+
+bool Compiler::compile_memory_access(Instruction const& instruction, bool is_store)
+{
+    auto& argument = instruction.arguments().get<Instruction::MemoryArgument>();
+    if (argument.memory_index.value() != 0)
+        return false;
+
+    size_t access_size = 4;
+    switch (instruction.opcode().value()) {
+    case Instructions::i32_load8_s.value():
+    case Instructions::i32_load8_u.value():
+        access_size = 1;
+        break;
+    case Instructions::i32_load16_s.value():
+    case Instructions::i32_load16_u.value():
+        access_size = 2;
+        break;
+    default:
+        break;
+    }
+
+    // GPR0 = address + offset, which can't overflow as both are only 32 bits wide.
+    auto address = Assembler::Operand::Register(GPR0);
+    m_assembler.mov(address, is_store ? top(1) : top(0));
+    m_assembler.mov(Assembler::Operand::Register(GPR1), Assembler::Operand::Imm(argument.offset));
+    m_assembler.add(address, Assembler::Operand::Register(GPR1));
+
+    // if (address + access_size > memory_size) trap
+    m_assembler.mov(Assembler::Operand::Register(GPR1), address);
+    m_assembler.add(Assembler::Operand::Register(GPR1), Assembler::Operand::Imm(access_size));
+    m_assembler.jump_if(
+        Assembler::Operand::Register(GPR1),
+        Assembler::Condition::UnsignedGreaterThan,
+        Assembler::Operand::Register(MEMORY_SIZE),
+        m_out_of_bounds_label);
+
+    m_assembler.add(address, Assembler::Operand::Register(MEMORY_BASE));
+    auto memory = Assembler::Operand::Mem64BaseAndOffset(GPR0, 0);
+
+    if (is_store) {
+        m_assembler.mov(Assembler::Operand::Register(GPR1), top(0));
+        m_assembler.mov32(memory, Assembler::Operand::Register(GPR1));
+        m_stack_height -= 2;
+        return true;
+    }
+
+    auto value = Assembler::Operand::Register(GPR1);
+    switch (instruction.opcode().value()) {
+    case Instructions::i32_load.value():
+        m_assembler.mov32(value, memory);
+        break;
+    case Instructions::i32_load8_s.value():
+        m_assembler.mov8(value, memory, Assembler::Extension::SignExtend);
+        break;
+    case Instructions::i32_load8_u.value():
+        m_assembler.mov8(value, memory, Assembler::Extension::ZeroExtend);
+        break;
+    case Instructions::i32_load16_s.value():
+        m_assembler.mov16(value, memory, Assembler::Extension::SignExtend);
+        break;
+    case Instructions::i32_load16_u.value():
+        m_assembler.mov16(value, memory, Assembler::Extension::ZeroExtend);
+        break;
+    default:
+        VERIFY_NOT_REACHED();
+    }
+    m_assembler.mov(top(0), value);
+    return true;
+}
+
+bool Compiler::compile_instruction(Instruction const& instruction)
+{
+    switch (instruction.opcode().value()) {
+    case Instructions::unreachable.value():
+        m_assembler.jump(m_unreachable_label);
+        mark_rest_of_block_unreachable();
+        return true;
+    case Instructions::nop.value():
+        return true;
+    case Instructions::block.value():
+    case Instructions::loop.value(): {
+        auto& args = instruction.arguments().get<Instruction::StructuredInstructionArgs>();
+        auto arity = arity_of(args.block_type);
+        if (!arity.has_value())
+            return false;
+        ControlFrame frame {
+            .kind = instruction.opcode() == Instructions::loop ? ControlFrame::Kind::Loop : ControlFrame::Kind::Block,
+            .stack_height = m_stack_height,
+            .arity = *arity,
+        };
+        if (frame.kind == ControlFrame::Kind::Loop)
+            frame.start_label.link(m_assembler);
+        m_control_stack.append(move(frame));
+        return true;
+    }
+    case Instructions::if_.value(): {
+        auto& args = instruction.arguments().get<Instruction::StructuredInstructionArgs>();
+        auto arity = arity_of(args.block_type);
+        if (!arity.has_value())
+            return false;
+        m_assembler.mov(Assembler::Operand::Register(GPR0), top());
+        --m_stack_height;
+        ControlFrame frame {
+            .kind = ControlFrame::Kind::If,
+            .stack_height = m_stack_height,
+            .arity = *arity,
+        };
+        m_assembler.jump_if(
+            Assembler::Operand::Register(GPR0),
+            Assembler::Condition::EqualTo,
+            Assembler::Operand::Imm(0),
+            frame.else_label);
+        m_control_stack.append(move(frame));
+        return true;
+    }
+    case Instructions::structured_else.value(): {
+        auto& frame = m_control_stack.last();
+        if (!m_is_unreachable)
+            m_assembler.jump(frame.end_label);
+        frame.else_label.link(m_assembler);
+        frame.has_else = true;
+        m_stack_height = frame.stack_height;
+        m_is_unreachable = false;
+        return true;
+    }
+    case Instructions::structured_end.value(): {
+        auto frame = m_control_stack.take_last();
+        if (frame.kind == ControlFrame::Kind::If && !frame.has_else)
+            frame.else_label.link(m_assembler);
+        frame.end_label.link(m_assembler);
+        m_stack_height = frame.stack_height + frame.arity;
+        m_max_stack_height = max(m_max_stack_height, m_stack_height);
+        m_is_unreachable = false;
+        return true;
+    }
+    case Instructions::br.value():
+        compile_branch(instruction.arguments().get<LabelIndex>().value());
+        mark_rest_of_block_unreachable();
+        return true;
+    case Instructions::br_if.value(): {
+        m_assembler.mov(Assembler::Operand::Register(GPR0), top());
+        --m_stack_height;
+        Assembler::Label not_taken {};
+        m_assembler.jump_if(
+            Assembler::Operand::Register(GPR0),
+            Assembler::Condition::EqualTo,
+            Assembler::Operand::Imm(0),
+            not_taken);
+        compile_branch(instruction.arguments().get<LabelIndex>().value());
+        not_taken.link(m_assembler);
+        return true;
+    }
+    case Instructions::br_table.value(): {
+        auto& args = instruction.arguments().get<Instruction::TableBranchArgs>();
+        m_assembler.mov(Assembler::Operand::Register(GPR2), top());
+        --m_stack_height;
+        for (size_t i = 0; i < args.labels.size(); ++i) {
+            Assembler::Label next {};
+            m_assembler.jump_if(
+                Assembler::Operand::Register(GPR2),
+                Assembler::Condition::NotEqualTo,
+                Assembler::Operand::Imm(i),
+                next);
+            compile_branch(args.labels[i].value());
+            next.link(m_assembler);
+        }
+        compile_branch(args.default_.value());
+        mark_rest_of_block_unreachable();
+        return true;
+    }
+    case Instructions::return_.value():
+        compile_branch(m_control_stack.size() - 1);
+        mark_rest_of_block_unreachable();
+        return true;
+    case Instructions::drop.value():
+        --m_stack_height;
+        return true;
+    case Instructions::select.value():
+        m_assembler.mov(Assembler::Operand::Register(GPR0), top(2));
+        m_assembler.mov(Assembler::Operand::Register(GPR1), top(1));
+        m_assembler.mov(Assembler::Operand::Register(GPR2), top(0));
+        m_assembler.cmp(Assembler::Operand::Register(GPR2), Assembler::Operand::Imm(0));
+        m_assembler.mov_if(Assembler::Condition::EqualTo, Assembler::Operand::Register(GPR0), Assembler::Operand::Register(GPR1));
+        m_assembler.mov(top(2), Assembler::Operand::Register(GPR0));
+        m_stack_height -= 2;
+        return true;
+    case Instructions::local_get.value():
+        m_assembler.mov(Assembler::Operand::Register(GPR0), local(instruction.arguments().get<LocalIndex>().value()));
+        push(GPR0);
+        return true;
+    case Instructions::local_set.value():
+        m_assembler.mov(Assembler::Operand::Register(GPR0), top());
+        m_assembler.mov(local(instruction.arguments().get<LocalIndex>().value()), Assembler::Operand::Register(GPR0));
+        --m_stack_height;
+        return true;
+    case Instructions::local_tee.value():
+        m_assembler.mov(Assembler::Operand::Register(GPR0), top());
+        m_assembler.mov(local(instruction.arguments().get<LocalIndex>().value()), Assembler::Operand::Register(GPR0));
+        return true;
+    case Instructions::i32_const.value():
+        m_assembler.mov(Assembler::Operand::Register(GPR0), Assembler::Operand::Imm(bit_cast<u32>(instruction.arguments().get<i32>())));
+        push(GPR0);
+        return true;
+    case Instructions::i32_load.value():
+    case Instructions::i32_load8_s.value():
+    case Instructions::i32_load8_u.value():
+    case Instructions::i32_load16_s.value():
+    case Instructions::i32_load16_u.value():
+        return compile_memory_access(instruction, false);
+    case Instructions::i32_store.value():
+        return compile_memory_access(instruction, true);
+    case Instructions::i32_eqz.value():
+        m_assembler.mov(Assembler::Operand::Register(GPR2), Assembler::Operand::Imm(0));
+        m_assembler.mov(Assembler::Operand::Register(GPR0), top());
+        m_assembler.cmp(Assembler::Operand::Register(GPR0), Assembler::Operand::Imm(0));
+        m_assembler.set_if(Assembler::Condition::EqualTo, Assembler::Operand::Register(GPR2));
+        m_assembler.mov(top(), Assembler::Operand::Register(GPR2));
+        return true;
+    case Instructions::i32_eq.value():
+        compile_comparison(Assembler::Condition::EqualTo, false);
+        return true;
+    case Instructions::i32_ne.value():
+        compile_comparison(Assembler::Condition::NotEqualTo, false);
+        return true;
+    case Instructions::i32_lts.value():
+        compile_comparison(Assembler::Condition::SignedLessThan, true);
+        return true;
+    case Instructions::i32_ltu.value():
+        compile_comparison(Assembler::Condition::UnsignedLessThan, false);
+        return true;
+    case Instructions::i32_gts.value():
+        compile_comparison(Assembler::Condition::SignedGreaterThan, true);
+        return true;
+    case Instructions::i32_gtu.value():
+        compile_comparison(Assembler::Condition::UnsignedGreaterThan, false);
+        return true;
+    case Instructions::i32_les.value():
+        compile_comparison(Assembler::Condition::SignedLessThanOrEqualTo, true);
+        return true;
+    case Instructions::i32_leu.value():
+        compile_comparison(Assembler::Condition::UnsignedLessThanOrEqualTo, false);
+        return true;
+    case Instructions::i32_ges.value():
+        compile_comparison(Assembler::Condition::SignedGreaterThanOrEqualTo, true);
+        return true;
+    case Instructions::i32_geu.value():
+        compile_comparison(Assembler::Condition::UnsignedGreaterThanOrEqualTo, false);
+        return true;
+    case Instructions::i32_add.value():
+    case Instructions::i32_sub.value():
+    case Instructions::i32_mul.value():
+    case Instructions::i32_and.value():
+    case Instructions::i32_or.value():
+    case Instructions::i32_xor.value():
+    case Instructions::i32_shl.value():
+    case Instructions::i32_shrs.value():
+    case Instructions::i32_shru.value():
+        compile_binary_operation(instruction.opcode());
+        return true;
+    default:
+        return false;
+    }
+}
+
+#endif
+
+OwnPtr<NativeFunction> Compiler::compile([[maybe_unused]] WasmFunction const& function)
+{
+#ifdef JIT_ARCH_SUPPORTED
+    if (!getenv("LIBWASM_JIT"))
+        return nullptr;
+
+    auto is_i32 = [](ValueType const& type) { return type.kind() == ValueType::I32; };
+    auto& type = function.type();
+    if (type.results().size() > 1 || !all_of(type.parameters(), is_i32) || !all_of(type.results(), is_i32) || !all_of(function.code().locals(), is_i32)) {
+        if constexpr (LOG_JIT_FAILURE)
+            dbgln("\033[31;1mWasm JIT compilation failed\033[0m: Unsupported function type");
+        return nullptr;
+    }
+
+    Compiler compiler { function };
+    compiler.m_local_count = type.parameters().size() + function.code().locals().size();
+
+    compiler.m_assembler.enter();
+    compiler.m_assembler.mov(Assembler::Operand::Register(SLOTS_BASE), Assembler::Operand::Register(ARG0));
+    compiler.m_assembler.mov(Assembler::Operand::Register(MEMORY_BASE), Assembler::Operand::Register(ARG1));
+    compiler.m_assembler.mov(Assembler::Operand::Register(MEMORY_SIZE), Assembler::Operand::Register(ARG2));
+
+    // The function body is a block of its own, branching to it returns.
+    compiler.m_control_stack.append({
+        .kind = ControlFrame::Kind::Block,
+        .stack_height = 0,
+        .arity = type.results().size(),
+    });
+
+    for (auto& instruction : function.code().body().instructions()) {
+        if (compiler.m_is_unreachable) {
+            auto opcode = instruction.opcode();
+            if (opcode == Instructions::block || opcode == Instructions::loop || opcode == Instructions::if_) {
+                ++compiler.m_unreachable_depth;
+                continue;
+            }
+            if (opcode == Instructions::structured_end && compiler.m_unreachable_depth > 0) {
+                --compiler.m_unreachable_depth;
+                continue;
+            }
+            if ((opcode != Instructions::structured_end && opcode != Instructions::structured_else) || compiler.m_unreachable_depth > 0)
+                continue;
+        }
+
+        if (!compiler.compile_instruction(instruction)) {
+            if constexpr (LOG_JIT_FAILURE)
+                dbgln("\033[31;1mWasm JIT compilation failed\033[0m: Unsupported instruction {}", instruction_name(instruction.opcode()));
+            return nullptr;
+        }
+    }
+
+    // NOTE: The body's results end up in the first stack slots, which is where NativeFunction::run() looks for them.
+    auto body = compiler.m_control_stack.take_last();
+    VERIFY(compiler.m_control_stack.is_empty());
+    body.end_label.link(compiler.m_assembler);
+    compiler.m_assembler.mov(Assembler::Operand::Register(RET), Assembler::Operand::Imm(to_underlying(NativeFunction::TrapReason::None)));
+
+    compiler.m_exit_label.link(compiler.m_assembler);
+    compiler.m_assembler.exit();
+
+    compiler.m_out_of_bounds_label.link(compiler.m_assembler);
+    compiler.m_assembler.mov(Assembler::Operand::Register(RET), Assembler::Operand::Imm(to_underlying(NativeFunction::TrapReason::MemoryAccessOutOfBounds)));
+    compiler.m_assembler.jump(compiler.m_exit_label);
+
+    compiler.m_unreachable_label.link(compiler.m_assembler);
+    compiler.m_assembler.mov(Assembler::Operand::Register(RET), Assembler::Operand::Imm(to_underlying(NativeFunction::TrapReason::Unreachable)));
+    compiler.m_assembler.jump(compiler.m_exit_label);
+
+    auto* executable_memory = mmap(nullptr, compiler.m_output.size(), PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, 0, 0);
+    if (executable_memory == MAP_FAILED) {
+        dbgln("mmap: {}", strerror(errno));
+        return nullptr;
+    }
+
+    memcpy(executable_memory, compiler.m_output.data(), compiler.m_output.size());
+
+    if (mprotect(executable_memory, compiler.m_output.size(), PROT_READ | PROT_EXEC) < 0) {
+        dbgln("mprotect: {}", strerror(errno));
+        munmap(executable_memory, compiler.m_output.size());
+        return nullptr;
+    }
+
+    if constexpr (LOG_JIT_SUCCESS)
+        dbgln("\033[32;1mWasm JIT compilation succeeded!\033[0m ({} bytes)", compiler.m_output.size());
+
+    auto slot_count = compiler.m_local_count + max(compiler.m_max_stack_height, type.results().size());
+    return make<NativeFunction>(executable_memory, compiler.m_output.size(), compiler.m_local_count, slot_count, type.results().size());
+#else
+    return nullptr;
+#endif
+}
+
+}
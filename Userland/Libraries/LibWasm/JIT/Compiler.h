@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/OwnPtr.h>
+#include <AK/Platform.h>
+#include <LibJIT/Assembler.h>
+#include <LibWasm/AbstractMachine/AbstractMachine.h>
+#include <LibWasm/JIT/NativeFunction.h>
+
+namespace Wasm::JIT {
+
+// A baseline compiler for functions that only compute with i32 values, straight from the validated instruction
+// stream. Every local and operand stack value lives in a fixed slot whose index is known at compile time.
+// Functions that use anything else (calls, globals, other value types, ...) are left to the interpreter.
+class Compiler {
+public:
+    static OwnPtr<NativeFunction> compile(WasmFunction const&);
+
+#ifdef JIT_ARCH_SUPPORTED
+private:
+    using Assembler = ::JIT::Assembler;
+
+#    if ARCH(X86_64)
+    static constexpr auto GPR0 = Assembler::Reg::RAX;
+    static constexpr auto GPR1 = Assembler::Reg::RCX;
+    static constexpr auto GPR2 = Assembler::Reg::RDX;
+    static constexpr auto ARG0 = Assembler::Reg::RDI;
+    static constexpr auto ARG1 = Assembler::Reg::RSI;
+    static constexpr auto ARG2 = Assembler::Reg::RDX;
+    static constexpr auto RET = Assembler::Reg::RAX;
+    static constexpr auto SLOTS_BASE = Assembler::Reg::RBX;
+    static constexpr auto MEMORY_BASE = Assembler::Reg::R12;
+    static constexpr auto MEMORY_SIZE = Assembler::Reg::R14;
+#    endif
+
+    struct ControlFrame {
+        enum class Kind {
+            Block,
+            Loop,
+            If,
+        };
+
+        Kind kind { Kind::Block };
+        size_t stack_height { 0 };
+        size_t arity { 0 };
+        Assembler::Label start_label {};
+        Assembler::Label else_label {};
+        Assembler::Label end_label {};
+        bool has_else { false };
+
+        // A branch to a loop goes back to its start, and loops never take parameters here.
+        size_t branch_arity() const { return kind == Kind::Loop ? 0 : arity; }
+    };
+
+    explicit Compiler(WasmFunction const& function)
+        : m_function(function)
+        , m_assembler(m_output)
+    {
+    }
+
+    bool compile_instruction(Instruction const&);
+    Optional<size_t> arity_of(BlockType const&) const;
+
+    Assembler::Operand local(size_t index) const;
+    Assembler::Operand stack_slot(size_t height) const;
+    Assembler::Operand top(size_t depth = 0) const { return stack_slot(m_stack_height - depth - 1); }
+    void push(Assembler::Reg);
+
+    void compile_binary_operation(OpCode);
+    void compile_comparison(Assembler::Condition, bool is_signed);
+    bool compile_memory_access(Instruction const&, bool is_store);
+    void compile_branch(size_t label_index);
+    void mark_rest_of_block_unreachable();
+
+    WasmFunction const& m_function;
+    Vector<u8> m_output;
+    Assembler m_assembler;
+
+    size_t m_local_count { 0 };
+    size_t m_stack_height { 0 };
+    size_t m_max_stack_height { 0 };
+    Vector<ControlFrame> m_control_stack;
+
+    // While the code after a branch is unreachable, we skip it up to the end (or else) of its block.
+    bool m_is_unreachable { false };
+    size_t m_unreachable_depth { 0 };
+
+    Assembler::Label m_exit_label {};
+    Assembler::Label m_out_of_bounds_label {};
+    Assembler::Label m_unreachable_label {};
+#endif
+};
+
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibWasm/JIT/NativeFunction.h>
+#include <sys/mman.h>
+
+namespace Wasm::JIT {
+
+NativeFunction::NativeFunction(void* code, size_t size, size_t local_count, size_t slot_count, size_t result_count)
+    : m_code(code)
+    , m_size(size)
+    , m_local_count(local_count)
+    , m_slot_count(slot_count)
+    , m_result_count(result_count)
+{
+}
+
+NativeFunction::~NativeFunction()
+{
+    munmap(m_code, m_size);
+}
+
+Result NativeFunction::run(ReadonlySpan<Value> arguments, MemoryInstance* memory) const
+{
+    // NOTE: Declared locals start out as zero, and every value the compiled code handles is an i32.
+    Vector<u64, 32> slots;
+    slots.resize(m_slot_count);
+    for (size_t i = 0; i < arguments.size(); ++i)
+        slots[i] = bit_cast<u32>(arguments[i].to<i32>().value());
+
+    typedef TrapReason (*JITCode)(u64* slots, u8* memory_base, u64 memory_size);
+    auto trap_reason = ((JITCode)m_code)(
+        slots.data(),
+        memory ? memory->data().data() : nullptr,
+        memory ? memory->size() : 0);
+
+    switch (trap_reason) {
+    case TrapReason::None:
+        break;
+    case TrapReason::MemoryAccessOutOfBounds:
+        return Trap { "Memory access out of bounds" };
+    case TrapReason::Unreachable:
+        return Trap { "Unreachable" };
+    }
+
+    Vector<Value> results;
+    results.ensure_capacity(m_result_count);
+    for (size_t i = 0; i < m_result_count; ++i)
+        results.unchecked_append(Value(bit_cast<i32>(static_cast<u32>(slots[m_local_count + i]))));
+    return Result { move(results) };
+}
+
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Noncopyable.h>
+#include <AK/Span.h>
+#include <AK/Types.h>
+#include <LibWasm/AbstractMachine/AbstractMachine.h>
+
+namespace Wasm::JIT {
+
+// A function that was compiled to machine code by JIT::Compiler.
+// The code keeps every local and operand stack value in a 64-bit slot, which run() fills in from the arguments.
+class NativeFunction {
+    AK_MAKE_NONCOPYABLE(NativeFunction);
+    AK_MAKE_NONMOVABLE(NativeFunction);
+
+public:
+    enum class TrapReason : u32 {
+        None = 0,
+        MemoryAccessOutOfBounds,
+        Unreachable,
+    };
+
+    NativeFunction(void* code, size_t size, size_t local_count, size_t slot_count, size_t result_count);
+    ~NativeFunction();
+
+    // The memory is the one the function's loads and stores go to, if it has any.
+    // NOTE: The compiled code never calls out or grows the memory, so the memory can't move while it runs.
+    Result run(ReadonlySpan<Value> arguments, MemoryInstance* memory) const;
+
+private:
+    void* m_code { nullptr };
+    size_t m_size { 0 };
+    size_t m_local_count { 0 };
+    size_t m_slot_count { 0 };
+    size_t m_result_count { 0 };
+};
+
+}
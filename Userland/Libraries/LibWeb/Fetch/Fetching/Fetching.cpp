@@ -16,6 +16,7 @@
 #include <LibWeb/Fetch/BodyInit.h>
 #include <LibWeb/Fetch/Fetching/Checks.h>
 #include <LibWeb/Fetch/Fetching/Fetching.h>
+#include <LibWeb/Fetch/Fetching/HTTPCache.h>
 #include <LibWeb/Fetch/Fetching/PendingResponse.h>
 #include <LibWeb/Fetch/Fetching/RefCountedFlag.h>
 #include <LibWeb/Fetch/Infrastructure/FetchAlgorithms.h>
@@ -1205,6 +1206,43 @@ WebIDL::ExceptionOr<Optional<JS::NonnullGCPtr<PendingResponse>>> http_redirect_f
     return main_fetch(realm, fetch_params, recursive);
 }
 
+// NOTE: Stored responses that aren't in the memory tier of the HTTP cache have to be loaded from its disk store
+//       first, which happens asynchronously. Once that's done, HTTP-network-or-cache fetch starts over, which is
+//       why this has to happen before any of its steps had a chance to modify the request.
+static WebIDL::ExceptionOr<JS::GCPtr<PendingResponse>> load_stored_responses_from_disk_if_needed(JS::Realm& realm, Infrastructure::FetchParams const& fetch_params, IsAuthenticationFetch is_authentication_fetch, IsNewConnectionFetch is_new_connection_fetch)
+{
+    auto& vm = realm.vm();
+    auto request = fetch_params.request();
+
+    if (request->cache_mode() == Infrastructure::Request::CacheMode::NoStore
+        || request->cache_mode() == Infrastructure::Request::CacheMode::Reload
+        || StringView { request->method() } != "GET"sv
+        || !HTTPCache::is_cacheable_url(request->current_url()))
+        return nullptr;
+
+    auto network_partition_key = HTTPCache::determine_network_partition_key(request);
+    if (!network_partition_key.has_value())
+        return nullptr;
+
+    auto& http_cache = HTTPCache::the();
+    auto key = HTTPCache::key_for_url(*network_partition_key, request->current_url());
+    if (!http_cache.should_load_from_disk(key))
+        return nullptr;
+
+    auto pending_response = PendingResponse::create(vm, request);
+    http_cache.load_from_disk(key, [&realm, &vm, &fetch_params, pending_response, is_authentication_fetch, is_new_connection_fetch] {
+        auto pending_response_or_error = http_network_or_cache_fetch(realm, fetch_params, is_authentication_fetch, is_new_connection_fetch);
+        if (pending_response_or_error.is_error()) {
+            pending_response->resolve(Infrastructure::Response::network_error(vm, "Failed to fetch after loading stored responses"sv));
+            return;
+        }
+        pending_response_or_error.value()->when_loaded([pending_response](JS::NonnullGCPtr<Infrastructure::Response> response) {
+            pending_response->resolve(response);
+        });
+    });
+    return pending_response;
+}
+
 // https://fetch.spec.whatwg.org/#concept-http-network-or-cache-fetch
 WebIDL::ExceptionOr<JS::NonnullGCPtr<PendingResponse>> http_network_or_cache_fetch(JS::Realm& realm, Infrastructure::FetchParams const& fetch_params, IsAuthenticationFetch is_authentication_fetch, IsNewConnectionFetch is_new_connection_fetch)
 {
@@ -1213,6 +1251,9 @@ WebIDL::ExceptionOr<JS::NonnullGCPtr<PendingResponse>> http_network_or_cache_fet
 
     auto& vm = realm.vm();
 
+    if (auto pending_response = TRY(load_stored_responses_from_disk_if_needed(realm, fetch_params, is_authentication_fetch, is_new_connection_fetch)))
+        return JS::NonnullGCPtr { *pending_response };
+
     // 1. Let request be fetchParams’s request.
     auto request = fetch_params.request();
 
@@ -1229,8 +1270,13 @@ WebIDL::ExceptionOr<JS::NonnullGCPtr<PendingResponse>> http_network_or_cache_fet
     JS::GCPtr<Infrastructure::Response> stored_response;
 
     // 6. Let httpCache be null.
-    // (Typeless until we actually implement it, needed for checks below)
-    void* http_cache = nullptr;
+    HTTPCache* http_cache = nullptr;
+
+    // NOTE: Stored responses in httpCache are keyed on the network partition key and the request's URL.
+    DeprecatedString http_cache_key;
+
+    // NOTE: This is the stored response as it lives in httpCache, which storedResponse is created from.
+    RefPtr<HTTPCache::CachedResponse> stored_cache_entry;
 
     // 7. Let the revalidatingFlag be unset.
     auto revalidating_flag = RefCountedFlag::create(false);
@@ -1470,7 +1516,18 @@ WebIDL::ExceptionOr<JS::NonnullGCPtr<PendingResponse>> http_network_or_cache_fet
         // FIXME: 21. If there’s a proxy-authentication entry, use it as appropriate.
         // NOTE: This intentionally does not depend on httpRequest’s credentials mode.
 
-        // FIXME: 22. Set httpCache to the result of determining the HTTP cache partition, given httpRequest.
+        // 22. Set httpCache to the result of determining the HTTP cache partition, given httpRequest.
+        // https://fetch.spec.whatwg.org/#determine-the-http-cache-partition
+        // 1. Let key be the result of determining the network partition key given request.
+        // 2. If key is null, then return null.
+        // 3. Return the unique HTTP cache associated with key.
+        // NOTE: There's a single HTTPCache, which keys its stored responses on the network partition key instead.
+        if (HTTPCache::is_cacheable_url(http_request->current_url())) {
+            if (auto network_partition_key = HTTPCache::determine_network_partition_key(*http_request); network_partition_key.has_value()) {
+                http_cache = &HTTPCache::the();
+                http_cache_key = HTTPCache::key_for_url(*network_partition_key, http_request->current_url());
+            }
+        }
 
         // 23. If httpCache is null, then set httpRequest’s cache mode to "no-store".
         if (!http_cache)
@@ -1483,12 +1540,50 @@ WebIDL::ExceptionOr<JS::NonnullGCPtr<PendingResponse>> http_network_or_cache_fet
             //    validation, as per the "Constructing Responses from Caches" chapter of HTTP Caching [HTTP-CACHING],
             //    if any.
             // NOTE: As mandated by HTTP, this still takes the `Vary` header into account.
-            stored_response = nullptr;
+            stored_cache_entry = http_cache->select_response(http_cache_key, *http_request);
+            if (stored_cache_entry)
+                stored_response = TRY(HTTPCache::create_response(realm, *stored_cache_entry));
 
             // 2. If storedResponse is non-null, then:
             if (stored_response) {
-                // FIXME: Caching is not implemented yet.
-                VERIFY_NOT_REACHED();
+                // FIXME: 1. If cache mode is "default", storedResponse is a stale-while-revalidate response, and
+                //           httpRequest’s client is non-null, then: [...]
+
+                // 2. Otherwise:
+                // 1. If storedResponse is a stale response, then set the revalidatingFlag.
+                if (HTTPCache::needs_validation(*stored_cache_entry, http_request->header_list()->span(), UnixDateTime::now()))
+                    revalidating_flag->set_value(true);
+
+                // 2. If the revalidatingFlag is set and httpRequest’s cache mode is neither "force-cache" nor
+                //    "only-if-cached", then:
+                if (revalidating_flag->value()
+                    && http_request->cache_mode() != Infrastructure::Request::CacheMode::ForceCache
+                    && http_request->cache_mode() != Infrastructure::Request::CacheMode::OnlyIfCached) {
+                    // 1. If storedResponse’s header list contains `ETag`, then append (`If-None-Match`, `ETag`'s value)
+                    //    to httpRequest’s header list.
+                    if (auto etag = TRY_OR_THROW_OOM(vm, stored_response->header_list()->get("ETag"sv.bytes())); etag.has_value()) {
+                        auto header = Infrastructure::Header {
+                            .name = TRY_OR_THROW_OOM(vm, ByteBuffer::copy("If-None-Match"sv.bytes())),
+                            .value = etag.release_value(),
+                        };
+                        TRY_OR_THROW_OOM(vm, http_request->header_list()->append(move(header)));
+                    }
+
+                    // 2. If storedResponse’s header list contains `Last-Modified`, then append (`If-Modified-Since`,
+                    //    `Last-Modified`'s value) to httpRequest’s header list.
+                    if (auto last_modified = TRY_OR_THROW_OOM(vm, stored_response->header_list()->get("Last-Modified"sv.bytes())); last_modified.has_value()) {
+                        auto header = Infrastructure::Header {
+                            .name = TRY_OR_THROW_OOM(vm, ByteBuffer::copy("If-Modified-Since"sv.bytes())),
+                            .value = last_modified.release_value(),
+                        };
+                        TRY_OR_THROW_OOM(vm, http_request->header_list()->append(move(header)));
+                    }
+                }
+                // 3. Otherwise, set response to storedResponse and set response’s cache state to "local".
+                else {
+                    response = stored_response;
+                    response->set_cache_state(Infrastructure::Response::CacheState::Local);
+                }
             }
         }
     }
@@ -1499,6 +1594,9 @@ WebIDL::ExceptionOr<JS::NonnullGCPtr<PendingResponse>> http_network_or_cache_fet
 
     JS::GCPtr<PendingResponse> pending_forward_response;
 
+    // NOTE: This is needed for the age calculation of a stored response.
+    auto request_time = UnixDateTime::now();
+
     // 10. If response is null, then:
     if (!response) {
         // 1. If httpRequest’s cache mode is "only-if-cached", then return a network error.
@@ -1514,34 +1612,42 @@ WebIDL::ExceptionOr<JS::NonnullGCPtr<PendingResponse>> http_network_or_cache_fet
 
     auto returned_pending_response = PendingResponse::create(vm, request);
 
-    pending_forward_response->when_loaded([&realm, &vm, &fetch_params, request, response, stored_response, http_request, returned_pending_response, is_authentication_fetch, is_new_connection_fetch, revalidating_flag, include_credentials, response_was_null = !response](JS::NonnullGCPtr<Infrastructure::Response> resolved_forward_response) mutable {
+    pending_forward_response->when_loaded([&realm, &vm, &fetch_params, request, response, stored_response, http_request, returned_pending_response, is_authentication_fetch, is_new_connection_fetch, revalidating_flag, include_credentials, http_cache, http_cache_key, stored_cache_entry, request_time, response_was_null = !response](JS::NonnullGCPtr<Infrastructure::Response> resolved_forward_response) mutable {
         dbgln_if(WEB_FETCH_DEBUG, "Fetch: Running 'HTTP-network-or-cache fetch' pending_forward_response load callback");
         if (response_was_null) {
             auto forward_response = resolved_forward_response;
 
             // NOTE: TRACE is omitted as it is a forbidden method in Fetch.
-            auto method_is_unsafe = StringView { http_request->method() }.is_one_of("GET"sv, "HEAD"sv, "OPTIONS"sv);
+            auto method_is_unsafe = !StringView { http_request->method() }.is_one_of("GET"sv, "HEAD"sv, "OPTIONS"sv);
 
             // 3. If httpRequest’s method is unsafe and forwardResponse’s status is in the range 200 to 399, inclusive,
             //    invalidate appropriate stored responses in httpCache, as per the "Invalidation" chapter of HTTP
             //    Caching, and set storedResponse to null.
             if (method_is_unsafe && forward_response->status() >= 200 && forward_response->status() <= 399) {
-                // FIXME: "invalidate appropriate stored responses in httpCache, as per the "Invalidation" chapter of HTTP Caching"
+                if (http_cache)
+                    http_cache->invalidate(http_cache_key);
                 stored_response = nullptr;
+                stored_cache_entry = nullptr;
             }
 
             // 4. If the revalidatingFlag is set and forwardResponse’s status is 304, then:
-            if (revalidating_flag->value() && forward_response->status() == 304) {
-                // FIXME: 1. Update storedResponse’s header list using forwardResponse’s header list, as per the "Freshening
-                //           Stored Responses upon Validation" chapter of HTTP Caching.
+            if (revalidating_flag->value() && forward_response->status() == 304 && stored_cache_entry) {
+                // 1. Update storedResponse’s header list using forwardResponse’s header list, as per the "Freshening
+                //    Stored Responses upon Validation" chapter of HTTP Caching.
                 // NOTE: This updates the stored response in cache as well.
+                http_cache->freshen(*stored_cache_entry, forward_response, request_time);
+                auto stored_response_or_error = HTTPCache::create_response(realm, *stored_cache_entry);
+                if (stored_response_or_error.is_error()) {
+                    returned_pending_response->resolve(Infrastructure::Response::network_error(vm, "Failed to create response from stored response"sv));
+                    return;
+                }
+                stored_response = stored_response_or_error.release_value();
 
                 // 2. Set response to storedResponse.
                 response = stored_response;
 
                 // 3. Set response’s cache state to "validated".
-                if (response)
-                    response->set_cache_state(Infrastructure::Response::CacheState::Validated);
+                response->set_cache_state(Infrastructure::Response::CacheState::Validated);
             }
 
             // 5. If response is null, then:
@@ -1549,11 +1655,14 @@ WebIDL::ExceptionOr<JS::NonnullGCPtr<PendingResponse>> http_network_or_cache_fet
                 // 1. Set response to forwardResponse.
                 response = forward_response;
 
-                // FIXME: 2. Store httpRequest and forwardResponse in httpCache, as per the "Storing Responses in Caches"
-                //           chapter of HTTP Caching.
+                // 2. Store httpRequest and forwardResponse in httpCache, as per the "Storing Responses in Caches"
+                //    chapter of HTTP Caching.
                 // NOTE: If forwardResponse is a network error, this effectively caches the network error, which is
                 //       sometimes known as "negative caching".
                 // NOTE: The associated body info is stored in the cache alongside the response.
+                // NOTE: We don't store network errors, see HTTPCache::store().
+                if (http_cache && http_request->cache_mode() != Infrastructure::Request::CacheMode::NoStore)
+                    http_cache->store(http_cache_key, *http_request, forward_response, request_time);
             }
         }
 
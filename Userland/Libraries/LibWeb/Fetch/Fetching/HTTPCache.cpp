@@ -0,0 +1,762 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/AnyOf.h>
+#include <AK/CharacterTypes.h>
+#include <AK/Debug.h>
+#include <AK/Endian.h>
+#include <AK/GenericLexer.h>
+#include <AK/MemoryStream.h>
+#include <AK/StringBuilder.h>
+#include <AK/URL.h>
+#include <AK/URLParser.h>
+#include <LibWeb/Fetch/BodyInit.h>
+#include <LibWeb/Fetch/Fetching/HTTPCache.h>
+#include <LibWeb/Fetch/Infrastructure/HTTP/Requests.h>
+#include <LibWeb/Fetch/Infrastructure/HTTP/Responses.h>
+#include <LibWeb/HTML/Origin.h>
+#include <LibWeb/HTML/Scripting/Environments.h>
+#include <LibWeb/URL/URL.h>
+
+namespace Web::Fetch::Fetching {
+
+static constexpr size_t memory_cache_capacity = 32 * MiB;
+
+// A single response this large would push most of everything else out of the memory cache.
+static constexpr size_t max_entry_size = memory_cache_capacity / 4;
+
+// Responses to the same URL that vary on request headers are kept side by side, up to this many.
+static constexpr size_t max_variants_per_key = 4;
+
+// We don't remember more keys than this as missing from the disk store, it's only there to save round trips.
+static constexpr size_t max_keys_missing_from_disk = 4096;
+
+static constexpr u32 disk_entry_magic = 0x50435448; // "HTCP"
+static constexpr u32 disk_entry_version = 2;
+
+struct CacheControl {
+    bool no_store { false };
+    bool no_cache { false };
+    Optional<u32> max_age;
+};
+
+template<typename Headers>
+static Optional<DeprecatedString> get_header(Headers const& headers, StringView name)
+{
+    // NOTE: This combines multiple headers with the same name, like https://fetch.spec.whatwg.org/#concept-header-list-get.
+    StringBuilder builder;
+    bool found = false;
+    for (auto const& header : headers) {
+        if (!StringView { header.name }.equals_ignoring_ascii_case(name))
+            continue;
+        if (found)
+            builder.append(", "sv);
+        builder.append(StringView { header.value });
+        found = true;
+    }
+    if (!found)
+        return {};
+    return builder.to_deprecated_string();
+}
+
+// https://httpwg.org/specs/rfc9111.html#field.cache-control
+static CacheControl parse_cache_control(Optional<DeprecatedString> const& value)
+{
+    CacheControl cache_control;
+    if (!value.has_value())
+        return cache_control;
+
+    for (auto directive : value->split_view(',')) {
+        directive = directive.trim_whitespace();
+
+        auto name = directive;
+        Optional<StringView> argument;
+        if (auto equals = directive.find('='); equals.has_value()) {
+            name = directive.substring_view(0, *equals).trim_whitespace();
+            argument = directive.substring_view(*equals + 1).trim_whitespace();
+            if (argument->length() >= 2 && argument->starts_with('"') && argument->ends_with('"'))
+                argument = argument->substring_view(1, argument->length() - 2);
+        }
+
+        if (name.equals_ignoring_ascii_case("no-store"sv)) {
+            cache_control.no_store = true;
+        } else if (name.equals_ignoring_ascii_case("no-cache"sv)) {
+            cache_control.no_cache = true;
+        } else if (name.equals_ignoring_ascii_case("max-age"sv)) {
+            // An invalid max-age makes the response stale, so treat it as zero.
+            cache_control.max_age = argument.has_value() ? argument->to_uint<u32>().value_or(0) : 0;
+        }
+    }
+    return cache_control;
+}
+
+// https://httpwg.org/specs/rfc9110.html#rfc.section.15.1
+static bool is_heuristically_cacheable_status(Infrastructure::Status status)
+{
+    // NOTE: 206 is left out, since we don't combine partial responses.
+    switch (status) {
+    case 200:
+    case 203:
+    case 204:
+    case 300:
+    case 301:
+    case 308:
+    case 404:
+    case 405:
+    case 410:
+    case 414:
+    case 501:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// https://httpwg.org/specs/rfc9110.html#http.date
+Optional<UnixDateTime> HTTPCache::parse_http_date(StringView value)
+{
+    // IMF-fixdate:  "Sun, 06 Nov 1994 08:49:37 GMT"
+    // rfc850-date:  "Sunday, 06-Nov-94 08:49:37 GMT"
+    // asctime-date: "Sun Nov  6 08:49:37 1994"
+    static constexpr Array short_month_names { "Jan"sv, "Feb"sv, "Mar"sv, "Apr"sv, "May"sv, "Jun"sv, "Jul"sv, "Aug"sv, "Sep"sv, "Oct"sv, "Nov"sv, "Dec"sv };
+
+    GenericLexer lexer { value.trim_whitespace() };
+
+    auto parse_number = [&]() {
+        return lexer.consume_while(is_ascii_digit).to_uint<u32>();
+    };
+    auto parse_month = [&]() -> Optional<u32> {
+        auto name = lexer.consume(3);
+        for (u32 i = 0; i < short_month_names.size(); ++i) {
+            if (name.equals_ignoring_ascii_case(short_month_names[i]))
+                return i + 1;
+        }
+        return {};
+    };
+
+    // The day name is redundant, so we don't bother validating it.
+    lexer.ignore_while(is_ascii_alpha);
+
+    Optional<u32> day;
+    Optional<u32> month;
+    Optional<u32> year;
+    bool is_asctime = false;
+
+    if (lexer.consume_specific(", "sv)) {
+        day = parse_number();
+        bool is_rfc850 = lexer.consume_specific('-');
+        if (!is_rfc850 && !lexer.consume_specific(' '))
+            return {};
+        month = parse_month();
+        if (!lexer.consume_specific(is_rfc850 ? '-' : ' '))
+            return {};
+        year = parse_number();
+        // Recipients of a timestamp value in rfc850-date format, which uses a two-digit year, MUST interpret a
+        // timestamp that appears to be more than 50 years in the future as representing the most recent year in the
+        // past that had the same last two digits.
+        // NOTE: We approximate this with a fixed pivot.
+        if (is_rfc850 && year.has_value() && *year < 100)
+            *year += *year < 70 ? 2000 : 1900;
+    } else if (lexer.consume_specific(' ')) {
+        is_asctime = true;
+        month = parse_month();
+        lexer.ignore_while(is_ascii_space);
+        day = parse_number();
+    } else {
+        return {};
+    }
+
+    if (!lexer.consume_specific(' '))
+        return {};
+    auto hour = parse_number();
+    if (!lexer.consume_specific(':'))
+        return {};
+    auto minute = parse_number();
+    if (!lexer.consume_specific(':'))
+        return {};
+    auto second = parse_number();
+
+    if (is_asctime) {
+        if (!lexer.consume_specific(' '))
+            return {};
+        year = parse_number();
+    } else if (!lexer.consume_specific(" GMT"sv)) {
+        return {};
+    }
+
+    if (!lexer.is_eof() || !day.has_value() || !month.has_value() || !year.has_value() || !hour.has_value() || !minute.has_value() || !second.has_value())
+        return {};
+    if (*day < 1 || *day > 31 || *hour > 23 || *minute > 59 || *second > 60)
+        return {};
+
+    // NOTE: A leap second is folded into the preceding second.
+    return UnixDateTime::from_unix_time_parts(*year, *month, *day, *hour, *minute, min(*second, 59u), 0);
+}
+
+template<typename Headers>
+static Optional<UnixDateTime> get_date_header(Headers const& headers, StringView name)
+{
+    auto value = get_header(headers, name);
+    if (!value.has_value())
+        return {};
+    return HTTPCache::parse_http_date(*value);
+}
+
+size_t HTTPCache::CachedResponse::size_in_bytes() const
+{
+    size_t size = sizeof(CachedResponse) + key.length() + body.size();
+    for (auto const& header : headers)
+        size += header.name.size() + header.value.size();
+    for (auto const& header : vary_request_headers)
+        size += header.name.size() + header.value.size();
+    return size;
+}
+
+static size_t size_in_bytes(Vector<NonnullRefPtr<HTTPCache::CachedResponse>> const& variants)
+{
+    size_t size = 0;
+    for (auto const& variant : variants)
+        size += variant->size_in_bytes();
+    return size;
+}
+
+HTTPCache& HTTPCache::the()
+{
+    static HTTPCache cache;
+    return cache;
+}
+
+bool HTTPCache::is_cacheable_url(AK::URL const& url)
+{
+    return url.scheme().is_one_of("http"sv, "https"sv);
+}
+
+// https://html.spec.whatwg.org/multipage/browsers.html#obtain-a-site
+static DeprecatedString obtain_a_site(HTML::Origin const& origin)
+{
+    // 1. If origin is an opaque origin, then return origin.
+    // NOTE: Callers never pass an opaque origin, since all of them serialize to the same string.
+    VERIFY(!origin.is_opaque());
+
+    // FIXME: 2. If origin's host's registrable domain is null, then return origin.
+    // FIXME: 3. Return (origin's scheme, origin's host's registrable domain).
+    // NOTE: We don't have a public suffix list to find registrable domains with, so we use the whole host.
+    //       This partitions the cache more finely than necessary, but never shares it across sites.
+    return DeprecatedString::formatted("{}://{}", origin.scheme(), MUST(AK::URLParser::serialize_host(origin.host())));
+}
+
+// https://fetch.spec.whatwg.org/#determine-the-network-partition-key
+static Optional<DeprecatedString> determine_network_partition_key(HTML::Environment const& environment, HTML::Origin const& environment_origin)
+{
+    // 1. Let topLevelOrigin be environment's top-level origin.
+    auto top_level_origin = environment.top_level_origin;
+
+    // 2. If topLevelOrigin is null, then set topLevelOrigin to environment's top-level creation URL's origin.
+    if (top_level_origin.is_opaque())
+        top_level_origin = URL::url_origin(environment.top_level_creation_url);
+
+    // 3. Assert: topLevelOrigin is an origin.
+    // NOTE: Opaque origins can't be told apart once serialized, so those environments don't get a partition.
+    if (top_level_origin.is_opaque())
+        return {};
+
+    // 4. Let topLevelSite be the result of obtaining a site, given topLevelOrigin.
+    auto top_level_site = obtain_a_site(top_level_origin);
+
+    // 5. Let secondKey be null or an implementation-defined value.
+    // NOTE: We use the environment's own origin, so that frames from different origins embedded in the same
+    //       top-level site don't share stored responses either.
+    DeprecatedString second_key = environment_origin.is_opaque() ? "null" : environment_origin.serialize();
+
+    // 6. Return (topLevelSite, secondKey).
+    return DeprecatedString::formatted("{} {}", top_level_site, second_key);
+}
+
+Optional<DeprecatedString> HTTPCache::determine_network_partition_key(Infrastructure::Request& request)
+{
+    // 1. If request's reserved client is non-null, then return the result of determining the network partition key
+    //    given request's reserved client.
+    auto& reserved_client = request.reserved_client();
+    if (auto* environment = reserved_client.get_pointer<HTML::Environment*>(); environment && *environment)
+        return Fetching::determine_network_partition_key(**environment, URL::url_origin((*environment)->creation_url));
+    if (auto* settings_object = reserved_client.get_pointer<JS::GCPtr<HTML::EnvironmentSettingsObject>>(); settings_object && *settings_object)
+        return Fetching::determine_network_partition_key(**settings_object, (*settings_object)->origin());
+
+    // 2. If request's client is non-null, then return the result of determining the network partition key given
+    //    request's client.
+    if (auto client = request.client())
+        return Fetching::determine_network_partition_key(*client, client->origin());
+
+    // 3. Return null.
+    return {};
+}
+
+DeprecatedString HTTPCache::key_for_url(StringView network_partition_key, AK::URL const& url)
+{
+    return DeprecatedString::formatted("{} {}", network_partition_key, url.serialize(AK::URL::ExcludeFragment::Yes));
+}
+
+Duration HTTPCache::freshness_lifetime(CachedResponse const& entry)
+{
+    // 1. If the cache is shared and the s-maxage response directive is present, use its value.
+    // NOTE: We are a private cache.
+
+    // 2. If the max-age response directive is present, use its value.
+    auto cache_control = parse_cache_control(get_header(entry.headers, "Cache-Control"sv));
+    if (cache_control.max_age.has_value())
+        return Duration::from_seconds(*cache_control.max_age);
+
+    auto date = get_date_header(entry.headers, "Date"sv).value_or(entry.response_time);
+
+    // 3. If the Expires response header field is present, use its value minus the value of the Date response header
+    //    field (using the time the message was received if it is not present).
+    if (auto expires = get_header(entry.headers, "Expires"sv); expires.has_value()) {
+        // NOTE: An invalid Expires value represents a time in the past.
+        auto expires_date = parse_http_date(*expires);
+        if (!expires_date.has_value() || *expires_date < date)
+            return Duration::zero();
+        return *expires_date - date;
+    }
+
+    // https://httpwg.org/specs/rfc9111.html#heuristic.freshness
+    // If the response has a Last-Modified header field, caches are encouraged to use a heuristic expiration value
+    // that is no more than some fraction of the interval since that time. A typical setting of this fraction might be 10%.
+    if (is_heuristically_cacheable_status(entry.status)) {
+        if (auto last_modified = get_date_header(entry.headers, "Last-Modified"sv); last_modified.has_value() && *last_modified < date)
+            return Duration::from_seconds((date - *last_modified).to_seconds() / 10);
+    }
+
+    return Duration::zero();
+}
+
+Duration HTTPCache::current_age(CachedResponse const& entry, UnixDateTime now)
+{
+    auto age_value = Duration::from_seconds(get_header(entry.headers, "Age"sv).value_or({}).to_uint<u32>().value_or(0));
+    auto date_value = get_date_header(entry.headers, "Date"sv).value_or(entry.response_time);
+
+    auto apparent_age = max(Duration::zero(), entry.response_time - date_value);
+    auto response_delay = entry.response_time - entry.request_time;
+    auto corrected_age_value = age_value + response_delay;
+    auto corrected_initial_age = max(apparent_age, corrected_age_value);
+
+    auto resident_time = now - entry.response_time;
+    return corrected_initial_age + resident_time;
+}
+
+bool HTTPCache::needs_validation(CachedResponse const& entry, ReadonlySpan<Infrastructure::Header> request_headers, UnixDateTime now)
+{
+    // https://httpwg.org/specs/rfc9111.html#cache-response-directive.no-cache
+    if (parse_cache_control(get_header(entry.headers, "Cache-Control"sv)).no_cache)
+        return true;
+
+    // https://httpwg.org/specs/rfc9111.html#cache-request-directive.no-cache
+    auto request_cache_control = parse_cache_control(get_header(request_headers, "Cache-Control"sv));
+    if (request_cache_control.no_cache)
+        return true;
+
+    auto age = current_age(entry, now);
+
+    // https://httpwg.org/specs/rfc9111.html#cache-request-directive.max-age
+    if (request_cache_control.max_age.has_value() && age > Duration::from_seconds(*request_cache_control.max_age))
+        return true;
+
+    // https://httpwg.org/specs/rfc9111.html#expiration.model
+    return age >= freshness_lifetime(entry);
+}
+
+// https://httpwg.org/specs/rfc9111.html#caching.negotiated.responses
+static bool matches_nominated_request_headers(HTTPCache::CachedResponse const& entry, ReadonlySpan<Infrastructure::Header> request_headers)
+{
+    for (auto const& header : entry.vary_request_headers) {
+        auto value = get_header(request_headers, StringView { header.name });
+        if (value.value_or({}) != StringView { header.value })
+            return false;
+    }
+    return true;
+}
+
+static bool nominate_the_same_request_headers(HTTPCache::CachedResponse const& a, HTTPCache::CachedResponse const& b)
+{
+    if (a.vary_request_headers.size() != b.vary_request_headers.size())
+        return false;
+    return matches_nominated_request_headers(a, b.vary_request_headers);
+}
+
+RefPtr<HTTPCache::CachedResponse> HTTPCache::select_response(DeprecatedString const& key, ReadonlySpan<Infrastructure::Header> request_headers)
+{
+    auto it = m_memory_entries.find(key);
+    if (it == m_memory_entries.end())
+        return nullptr;
+
+    // Move the entry to the back of the eviction order.
+    auto variants = it->value;
+    remove_from_memory(key);
+    insert_into_memory(key, variants);
+
+    // When more than one suitable response is stored, a cache MUST use the most recent one.
+    for (size_t i = variants.size(); i > 0; --i) {
+        if (matches_nominated_request_headers(variants[i - 1], request_headers)) {
+            dbgln_if(CACHE_DEBUG, "HTTPCache: Selected stored response for {}", key);
+            return variants[i - 1];
+        }
+    }
+
+    dbgln_if(CACHE_DEBUG, "HTTPCache: No stored response for {} matches the request's headers", key);
+    return nullptr;
+}
+
+RefPtr<HTTPCache::CachedResponse> HTTPCache::select_response(DeprecatedString const& key, Infrastructure::Request const& request)
+{
+    if (StringView { request.method() } != "GET"sv)
+        return nullptr;
+    return select_response(key, request.header_list()->span());
+}
+
+bool HTTPCache::should_load_from_disk(DeprecatedString const& key) const
+{
+    return m_disk_store && !m_memory_entries.contains(key) && !m_keys_missing_from_disk.contains(key);
+}
+
+static ErrorOr<ByteBuffer> serialize_variants(Vector<NonnullRefPtr<HTTPCache::CachedResponse>> const&);
+static ErrorOr<Vector<NonnullRefPtr<HTTPCache::CachedResponse>>> deserialize_variants(ReadonlyBytes, DeprecatedString const& key);
+
+void HTTPCache::load_from_disk(DeprecatedString const& key, Function<void()> on_complete)
+{
+    VERIFY(m_disk_store);
+
+    // Requests for the same key that come in while it's being loaded share the result.
+    auto& callbacks = m_pending_disk_loads.ensure(key);
+    callbacks.append(move(on_complete));
+    if (callbacks.size() > 1)
+        return;
+
+    dbgln_if(CACHE_DEBUG, "HTTPCache: Loading {} from the disk store", key);
+    m_disk_store->load_http_cache_entry(key, [this, key](Optional<ByteBuffer> bytes) {
+        did_load_from_disk(key, move(bytes));
+    });
+}
+
+void HTTPCache::did_load_from_disk(DeprecatedString const& key, Optional<ByteBuffer> bytes)
+{
+    auto variants_or_error = [&]() -> ErrorOr<Variants> {
+        if (!bytes.has_value())
+            return Error::from_string_literal("Not in the disk store");
+        return deserialize_variants(*bytes, key);
+    }();
+
+    // NOTE: A response that was stored while this was loading is newer than anything the disk store had.
+    if (!m_memory_entries.contains(key)) {
+        // Whatever happens, the key must either end up in memory or be known as missing from the disk store,
+        // otherwise the callbacks below would just ask for it again.
+        if (variants_or_error.is_error() || !insert_into_memory(key, variants_or_error.release_value())) {
+            if (variants_or_error.is_error())
+                dbgln_if(CACHE_DEBUG, "HTTPCache: Couldn't load {} from the disk store: {}", key, variants_or_error.error());
+            if (bytes.has_value())
+                m_disk_store->remove_http_cache_entry(key);
+            if (m_keys_missing_from_disk.size() >= max_keys_missing_from_disk)
+                m_keys_missing_from_disk.clear();
+            m_keys_missing_from_disk.set(key);
+        }
+    }
+
+    auto callbacks = m_pending_disk_loads.take(key).value_or({});
+    for (auto& callback : callbacks)
+        callback();
+}
+
+void HTTPCache::store(DeprecatedString const& key, ReadonlySpan<Infrastructure::Header> request_headers, Infrastructure::Status status, ReadonlySpan<Infrastructure::Header> response_headers, ReadonlyBytes body, UnixDateTime request_time, UnixDateTime response_time)
+{
+    // https://httpwg.org/specs/rfc9111.html#response.cacheability
+    // NOTE: The request method has already been checked by the caller.
+    // - the response status code is final and understood by the cache;
+    if (!is_heuristically_cacheable_status(status))
+        return;
+
+    if (body.size() > max_entry_size)
+        return;
+
+    // - the no-store cache directive is not present in the response or the request;
+    if (parse_cache_control(get_header(request_headers, "Cache-Control"sv)).no_store)
+        return;
+    if (parse_cache_control(get_header(response_headers, "Cache-Control"sv)).no_store)
+        return;
+
+    auto entry_or_error = [&]() -> ErrorOr<NonnullRefPtr<CachedResponse>> {
+        auto entry = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) CachedResponse));
+        entry->key = key;
+        entry->status = status;
+        entry->body = TRY(ByteBuffer::copy(body));
+        entry->request_time = request_time;
+        entry->response_time = response_time;
+        for (auto const& header : response_headers)
+            TRY(entry->headers.try_append({ TRY(ByteBuffer::copy(header.name)), TRY(ByteBuffer::copy(header.value)) }));
+
+        // https://httpwg.org/specs/rfc9111.html#caching.negotiated.responses
+        if (auto vary = get_header(entry->headers, "Vary"sv); vary.has_value()) {
+            for (auto name : vary->split_view(',')) {
+                name = name.trim_whitespace();
+                // A stored response with a Vary header field value containing a member "*" always fails to match.
+                if (name == "*"sv)
+                    return Error::from_string_literal("Response varies on everything");
+                auto value = get_header(request_headers, name).value_or({});
+                TRY(entry->vary_request_headers.try_append({ TRY(ByteBuffer::copy(name.bytes())), TRY(ByteBuffer::copy(value.bytes())) }));
+            }
+        }
+        return entry;
+    }();
+    if (entry_or_error.is_error())
+        return;
+    auto entry = entry_or_error.release_value();
+
+    // A response that is immediately stale and can't be validated would never be reused.
+    bool has_validator = get_header(entry->headers, "ETag"sv).has_value() || get_header(entry->headers, "Last-Modified"sv).has_value();
+    if (!has_validator && freshness_lifetime(*entry).is_zero())
+        return;
+
+    dbgln_if(CACHE_DEBUG, "HTTPCache: Storing response for {} ({} bytes)", key, entry->body.size());
+
+    // The new response replaces the one that was stored for the same nominated request headers, if any.
+    Variants variants;
+    if (auto it = m_memory_entries.find(key); it != m_memory_entries.end()) {
+        variants = it->value;
+        remove_from_memory(key);
+    }
+    variants.remove_all_matching([&](auto const& variant) { return nominate_the_same_request_headers(variant, entry); });
+    variants.append(entry);
+    if (variants.size() > max_variants_per_key)
+        variants.remove(0, variants.size() - max_variants_per_key);
+
+    m_keys_missing_from_disk.remove(key);
+    insert_into_memory(key, variants);
+    write_to_disk(key, variants);
+}
+
+void HTTPCache::store(DeprecatedString const& key, Infrastructure::Request const& request, Infrastructure::Response const& response, UnixDateTime request_time)
+{
+    // https://httpwg.org/specs/rfc9111.html#response.cacheability
+    // - the request method is understood by the cache;
+    if (StringView { request.method() } != "GET"sv)
+        return;
+
+    if (response.is_network_error())
+        return;
+
+    // NOTE: We can only store bodies that were fully received up front.
+    ReadonlyBytes body;
+    if (auto const& response_body = response.body()) {
+        auto const* bytes = response_body->source().get_pointer<ByteBuffer>();
+        if (!bytes)
+            return;
+        body = *bytes;
+    }
+
+    store(key, request.header_list()->span(), response.status(), response.header_list()->span(), body, request_time, UnixDateTime::now());
+}
+
+void HTTPCache::freshen(CachedResponse& entry, ReadonlySpan<Infrastructure::Header> not_modified_headers, UnixDateTime request_time, UnixDateTime response_time)
+{
+    // https://httpwg.org/specs/rfc9111.html#update
+    // The cache MUST add each header field in the provided response to the stored response, replacing field values
+    // that are already present, with the exception of Content-Length.
+    Vector<ByteBuffer> replaced_names;
+    for (auto const& header : not_modified_headers) {
+        if (StringView { header.name }.equals_ignoring_ascii_case("Content-Length"sv))
+            continue;
+        if (!replaced_names.contains_slow(header.name)) {
+            entry.headers.remove_all_matching([&](auto const& stored_header) {
+                return StringView { stored_header.name }.equals_ignoring_ascii_case(StringView { header.name });
+            });
+            replaced_names.append(MUST(ByteBuffer::copy(header.name)));
+        }
+        entry.headers.append({ MUST(ByteBuffer::copy(header.name)), MUST(ByteBuffer::copy(header.value)) });
+    }
+
+    entry.request_time = request_time;
+    entry.response_time = response_time;
+
+    dbgln_if(CACHE_DEBUG, "HTTPCache: Freshened stored response for {}", entry.key);
+
+    // NOTE: The entry may have been evicted from memory since it was selected.
+    Variants variants;
+    if (auto it = m_memory_entries.find(entry.key); it != m_memory_entries.end()) {
+        variants = it->value;
+        remove_from_memory(entry.key);
+    }
+    if (!any_of(variants, [&](auto const& variant) { return variant.ptr() == &entry; }))
+        variants.append(entry);
+    insert_into_memory(entry.key, variants);
+    write_to_disk(entry.key, variants);
+}
+
+void HTTPCache::freshen(CachedResponse& entry, Infrastructure::Response const& not_modified_response, UnixDateTime request_time)
+{
+    freshen(entry, not_modified_response.header_list()->span(), request_time, UnixDateTime::now());
+}
+
+void HTTPCache::invalidate(DeprecatedString const& key)
+{
+    dbgln_if(CACHE_DEBUG, "HTTPCache: Invalidating stored responses for {}", key);
+    remove_from_memory(key);
+    if (m_disk_store) {
+        m_disk_store->remove_http_cache_entry(key);
+        m_keys_missing_from_disk.set(key);
+    }
+}
+
+void HTTPCache::clear()
+{
+    m_memory_entries.clear();
+    m_memory_size = 0;
+    m_keys_missing_from_disk.clear();
+    if (m_disk_store)
+        m_disk_store->clear_http_cache();
+}
+
+WebIDL::ExceptionOr<JS::NonnullGCPtr<Infrastructure::Response>> HTTPCache::create_response(JS::Realm& realm, CachedResponse const& entry)
+{
+    auto& vm = realm.vm();
+
+    auto response = Infrastructure::Response::create(vm);
+    response->set_status(entry.status);
+    for (auto const& header : entry.headers) {
+        auto copied_header = Infrastructure::Header {
+            .name = TRY_OR_THROW_OOM(vm, ByteBuffer::copy(header.name)),
+            .value = TRY_OR_THROW_OOM(vm, ByteBuffer::copy(header.value)),
+        };
+        TRY_OR_THROW_OOM(vm, response->header_list()->append(move(copied_header)));
+    }
+
+    auto [body, _] = TRY(extract_body(realm, entry.body.bytes()));
+    response->set_body(move(body));
+    return response;
+}
+
+bool HTTPCache::insert_into_memory(DeprecatedString const& key, Variants variants)
+{
+    auto size = size_in_bytes(variants);
+    if (size > max_entry_size)
+        return false;
+
+    m_memory_size += size;
+    m_memory_entries.set(key, move(variants));
+
+    // Evict the least recently used entries, which are at the front.
+    while (m_memory_size > memory_cache_capacity) {
+        auto oldest = m_memory_entries.begin();
+        VERIFY(oldest->key != key);
+        dbgln_if(CACHE_DEBUG, "HTTPCache: Evicting {} from memory", oldest->key);
+        m_memory_size -= size_in_bytes(oldest->value);
+        m_memory_entries.remove(oldest);
+    }
+    return true;
+}
+
+void HTTPCache::remove_from_memory(DeprecatedString const& key)
+{
+    auto it = m_memory_entries.find(key);
+    if (it == m_memory_entries.end())
+        return;
+    m_memory_size -= size_in_bytes(it->value);
+    m_memory_entries.remove(it);
+}
+
+static ErrorOr<void> write_bytes(Stream& stream, ReadonlyBytes bytes)
+{
+    TRY(stream.write_value<LittleEndian<u32>>(bytes.size()));
+    TRY(stream.write_until_depleted(bytes));
+    return {};
+}
+
+static ErrorOr<ByteBuffer> read_bytes(Stream& stream)
+{
+    auto size = TRY(stream.read_value<LittleEndian<u32>>());
+    auto bytes = TRY(ByteBuffer::create_uninitialized(size));
+    TRY(stream.read_until_filled(bytes));
+    return bytes;
+}
+
+static ErrorOr<void> write_headers(Stream& stream, Vector<Infrastructure::Header> const& headers)
+{
+    TRY(stream.write_value<LittleEndian<u32>>(headers.size()));
+    for (auto const& header : headers) {
+        TRY(write_bytes(stream, header.name));
+        TRY(write_bytes(stream, header.value));
+    }
+    return {};
+}
+
+static ErrorOr<Vector<Infrastructure::Header>> read_headers(Stream& stream)
+{
+    Vector<Infrastructure::Header> headers;
+    auto count = TRY(stream.read_value<LittleEndian<u32>>());
+    for (u32 i = 0; i < count; ++i) {
+        auto name = TRY(read_bytes(stream));
+        auto value = TRY(read_bytes(stream));
+        TRY(headers.try_append({ move(name), move(value) }));
+    }
+    return headers;
+}
+
+// NOTE: The disk store takes care of telling apart keys that hash to the same file, so the key isn't part of this.
+static ErrorOr<ByteBuffer> serialize_variants(Vector<NonnullRefPtr<HTTPCache::CachedResponse>> const& variants)
+{
+    AllocatingMemoryStream stream;
+    TRY(stream.write_value<LittleEndian<u32>>(disk_entry_magic));
+    TRY(stream.write_value<LittleEndian<u32>>(disk_entry_version));
+    TRY(stream.write_value<LittleEndian<u32>>(variants.size()));
+    for (auto const& entry : variants) {
+        TRY(stream.write_value<LittleEndian<u16>>(entry->status));
+        TRY(stream.write_value<LittleEndian<i64>>(entry->request_time.milliseconds_since_epoch()));
+        TRY(stream.write_value<LittleEndian<i64>>(entry->response_time.milliseconds_since_epoch()));
+        TRY(write_headers(stream, entry->headers));
+        TRY(write_headers(stream, entry->vary_request_headers));
+        TRY(write_bytes(stream, entry->body));
+    }
+    return stream.read_until_eof();
+}
+
+static ErrorOr<Vector<NonnullRefPtr<HTTPCache::CachedResponse>>> deserialize_variants(ReadonlyBytes bytes, DeprecatedString const& key)
+{
+    FixedMemoryStream stream { bytes };
+    if (TRY(stream.read_value<LittleEndian<u32>>()) != disk_entry_magic)
+        return Error::from_string_literal("Not an HTTP cache entry");
+    if (TRY(stream.read_value<LittleEndian<u32>>()) != disk_entry_version)
+        return Error::from_string_literal("Unsupported HTTP cache entry version");
+
+    Vector<NonnullRefPtr<HTTPCache::CachedResponse>> variants;
+    auto count = TRY(stream.read_value<LittleEndian<u32>>());
+    if (count == 0 || count > max_variants_per_key)
+        return Error::from_string_literal("Invalid number of HTTP cache entry variants");
+    for (u32 i = 0; i < count; ++i) {
+        auto entry = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) HTTPCache::CachedResponse));
+        entry->key = key;
+        entry->status = TRY(stream.read_value<LittleEndian<u16>>());
+        entry->request_time = UnixDateTime::from_milliseconds_since_epoch(TRY(stream.read_value<LittleEndian<i64>>()));
+        entry->response_time = UnixDateTime::from_milliseconds_since_epoch(TRY(stream.read_value<LittleEndian<i64>>()));
+        entry->headers = TRY(read_headers(stream));
+        entry->vary_request_headers = TRY(read_headers(stream));
+        entry->body = TRY(read_bytes(stream));
+        TRY(variants.try_append(move(entry)));
+    }
+    if (!stream.is_eof())
+        return Error::from_string_literal("Trailing data after HTTP cache entry");
+    return variants;
+}
+
+void HTTPCache::write_to_disk(DeprecatedString const& key, Variants const& variants)
+{
+    if (!m_disk_store)
+        return;
+
+    auto bytes_or_error = serialize_variants(variants);
+    if (bytes_or_error.is_error()) {
+        dbgln_if(CACHE_DEBUG, "HTTPCache: Failed to serialize {}: {}", key, bytes_or_error.error());
+        return;
+    }
+    m_disk_store->store_http_cache_entry(key, bytes_or_error.release_value());
+}
+
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/DeprecatedString.h>
+#include <AK/Function.h>
+#include <AK/HashMap.h>
+#include <AK/HashTable.h>
+#include <AK/RefCounted.h>
+#include <AK/Time.h>
+#include <AK/Vector.h>
+#include <LibJS/Forward.h>
+#include <LibWeb/Fetch/Infrastructure/HTTP/Headers.h>
+#include <LibWeb/Fetch/Infrastructure/HTTP/Statuses.h>
+#include <LibWeb/Forward.h>
+#include <LibWeb/WebIDL/ExceptionOr.h>
+
+namespace Web::Fetch::Fetching {
+
+// https://httpwg.org/specs/rfc9111.html
+// A private HTTP cache with two tiers: a size-bounded in-memory map in front of a disk store.
+// The disk store lives out of process (in RequestServer), so it's only ever talked to asynchronously,
+// and entries are handed to it serialized.
+class HTTPCache {
+public:
+    struct CachedResponse : public RefCounted<CachedResponse> {
+        DeprecatedString key;
+        Infrastructure::Status status { 0 };
+        Vector<Infrastructure::Header> headers;
+        ByteBuffer body;
+
+        // The request headers nominated by the response's `Vary` header, at the time it was stored.
+        Vector<Infrastructure::Header> vary_request_headers;
+
+        // https://httpwg.org/specs/rfc9111.html#age.calculations
+        UnixDateTime request_time;
+        UnixDateTime response_time;
+
+        size_t size_in_bytes() const;
+    };
+
+    class DiskStore {
+    public:
+        virtual ~DiskStore() = default;
+
+        // on_complete is called later on, with the bytes that were last stored for the key, if any.
+        virtual void load_http_cache_entry(DeprecatedString const& key, Function<void(Optional<ByteBuffer>)> on_complete) = 0;
+        virtual void store_http_cache_entry(DeprecatedString const& key, ByteBuffer entry) = 0;
+        virtual void remove_http_cache_entry(DeprecatedString const& key) = 0;
+        virtual void clear_http_cache() = 0;
+    };
+
+    HTTPCache() = default;
+
+    static HTTPCache& the();
+
+    DiskStore* disk_store() const { return m_disk_store; }
+    void set_disk_store(DiskStore* disk_store) { m_disk_store = disk_store; }
+
+    // The cache is only used for HTTP(S) requests.
+    static bool is_cacheable_url(AK::URL const&);
+
+    // https://fetch.spec.whatwg.org/#determine-the-network-partition-key
+    static Optional<DeprecatedString> determine_network_partition_key(Infrastructure::Request&);
+
+    // Every stored response is keyed on the network partition key and the URL it was requested from.
+    static DeprecatedString key_for_url(StringView network_partition_key, AK::URL const&);
+
+    // https://httpwg.org/specs/rfc9111.html#constructing.responses.from.caches
+    // NOTE: This only looks at the memory tier. Use should_load_from_disk() and load_from_disk() to bring
+    //       responses that were evicted from it (or stored by an earlier process) back first.
+    RefPtr<CachedResponse> select_response(DeprecatedString const& key, ReadonlySpan<Infrastructure::Header> request_headers);
+    RefPtr<CachedResponse> select_response(DeprecatedString const& key, Infrastructure::Request const&);
+
+    bool should_load_from_disk(DeprecatedString const& key) const;
+    void load_from_disk(DeprecatedString const& key, Function<void()> on_complete);
+
+    // https://httpwg.org/specs/rfc9111.html#response.cacheability
+    void store(DeprecatedString const& key, ReadonlySpan<Infrastructure::Header> request_headers, Infrastructure::Status, ReadonlySpan<Infrastructure::Header> response_headers, ReadonlyBytes body, UnixDateTime request_time, UnixDateTime response_time);
+    void store(DeprecatedString const& key, Infrastructure::Request const&, Infrastructure::Response const&, UnixDateTime request_time);
+
+    // https://httpwg.org/specs/rfc9111.html#freshening.responses
+    void freshen(CachedResponse&, ReadonlySpan<Infrastructure::Header> not_modified_headers, UnixDateTime request_time, UnixDateTime response_time);
+    void freshen(CachedResponse&, Infrastructure::Response const& not_modified_response, UnixDateTime request_time);
+
+    // https://httpwg.org/specs/rfc9111.html#invalidation
+    void invalidate(DeprecatedString const& key);
+
+    // Whether the stored response must be validated with the origin server before it can be reused for the request.
+    static bool needs_validation(CachedResponse const&, ReadonlySpan<Infrastructure::Header> request_headers, UnixDateTime now);
+
+    static WebIDL::ExceptionOr<JS::NonnullGCPtr<Infrastructure::Response>> create_response(JS::Realm&, CachedResponse const&);
+
+    // https://httpwg.org/specs/rfc9111.html#calculating.freshness.lifetime
+    static Duration freshness_lifetime(CachedResponse const&);
+
+    // https://httpwg.org/specs/rfc9111.html#age.calculations
+    static Duration current_age(CachedResponse const&, UnixDateTime now);
+
+    static Optional<UnixDateTime> parse_http_date(StringView);
+
+    void clear();
+
+private:
+    // All stored responses for one key, which differ in the request headers nominated by their `Vary` header.
+    using Variants = Vector<NonnullRefPtr<CachedResponse>>;
+
+    bool insert_into_memory(DeprecatedString const& key, Variants);
+    void remove_from_memory(DeprecatedString const& key);
+    void write_to_disk(DeprecatedString const& key, Variants const&);
+    void did_load_from_disk(DeprecatedString const& key, Optional<ByteBuffer>);
+
+    OrderedHashMap<DeprecatedString, Variants> m_memory_entries;
+    size_t m_memory_size { 0 };
+
+    DiskStore* m_disk_store { nullptr };
+    HashMap<DeprecatedString, Vector<Function<void()>>> m_pending_disk_loads;
+    // Keys whose responses are known not to be in the disk store, so that it isn't asked about them over and over.
+    HashTable<DeprecatedString> m_keys_missing_from_disk;
+};
+
+}
@@ -41,6 +41,7 @@ public:
     using Vector::clear;
     using Vector::end;
     using Vector::is_empty;
+    using Vector::span;
 
     [[nodiscard]] static JS::NonnullGCPtr<HeaderList> create(JS::VM&);
 
@@ -227,18 +227,29 @@ Viewport& Node::root()
 
 void Node::set_needs_display()
 {
+    auto navigable = this->navigable();
+    if (!navigable)
+        return;
+
+    // Boxes repaint everything they paint, including their borders, shadows and visible overflow.
+    if (paintable() && is<Painting::PaintableBox>(*paintable())) {
+        navigable->set_needs_display(static_cast<Painting::PaintableBox const&>(*paintable()).absolute_paint_rect());
+        return;
+    }
+
+    // Everything else is painted as fragments of the lines of its containing block.
     auto* containing_block = this->containing_block();
     if (!containing_block)
         return;
     if (!containing_block->paintable_box())
         return;
-    if (!is<Painting::PaintableWithLines>(*containing_block->paintable_box()))
+    if (!is<Painting::PaintableWithLines>(*containing_block->paintable_box())) {
+        navigable->set_needs_display(containing_block->paintable_box()->absolute_paint_rect());
         return;
+    }
     static_cast<Painting::PaintableWithLines const&>(*containing_block->paintable_box()).for_each_fragment([&](auto& fragment) {
-        if (&fragment.layout_node() == this || is_ancestor_of(fragment.layout_node())) {
-            if (navigable())
-                navigable()->set_needs_display(fragment.absolute_rect());
-        }
+        if (&fragment.layout_node() == this || is_ancestor_of(fragment.layout_node()))
+            navigable->set_needs_display(fragment.absolute_rect());
         return IterationDecision::Continue;
     });
 }
@@ -12,6 +12,7 @@
 #include <LibCore/MimeData.h>
 #include <LibWeb/Cookie/Cookie.h>
 #include <LibWeb/Cookie/ParsedCookie.h>
+#include <LibWeb/Fetch/Fetching/HTTPCache.h>
 #include <LibWeb/Loader/ContentFilter.h>
 #include <LibWeb/Loader/GeneratedPagesLoader.h>
 #include <LibWeb/Loader/LoadRequest.h>
@@ -408,6 +409,7 @@ void ResourceLoader::clear_cache()
 {
     dbgln_if(CACHE_DEBUG, "Clearing {} items from ResourceLoader cache", s_resource_cache.size());
     s_resource_cache.clear();
+    Fetch::Fetching::HTTPCache::the().clear();
 }
 
 void ResourceLoader::evict_from_cache(LoadRequest const& request)
@@ -24,6 +24,21 @@ PaintingCommandExecutorCPU::PaintingCommandExecutorCPU(Gfx::Bitmap& bitmap)
         .scaling_mode = {} });
 }
 
+PaintingCommandExecutorCPU::PaintingCommandExecutorCPU(Gfx::Bitmap& bitmap, Gfx::IntRect const& target_rect)
+    : PaintingCommandExecutorCPU(bitmap)
+{
+    m_target_rect = target_rect;
+    clip_to_target_rect(painter());
+}
+
+void PaintingCommandExecutorCPU::clip_to_target_rect(Gfx::Painter& painter)
+{
+    // Stacking contexts with their own bitmap are only blitted into the target by the painter below them.
+    if (!m_target_rect.has_value() || &painter != stacking_contexts.first().painter.ptr())
+        return;
+    painter.add_clip_rect(m_target_rect->translated(-painter.translation()));
+}
+
 CommandResult PaintingCommandExecutorCPU::draw_glyph_run(Vector<Gfx::DrawGlyphOrEmoji> const& glyph_run, Color const& color)
 {
     auto& painter = this->painter();
@@ -75,6 +90,7 @@ CommandResult PaintingCommandExecutorCPU::set_clip_rect(Gfx::IntRect const& rect
 {
     auto& painter = this->painter();
     painter.clear_clip_rect();
+    clip_to_target_rect(painter);
     painter.add_clip_rect(rect);
     return CommandResult::Continue;
 }
@@ -82,6 +98,7 @@ CommandResult PaintingCommandExecutorCPU::set_clip_rect(Gfx::IntRect const& rect
 CommandResult PaintingCommandExecutorCPU::clear_clip_rect()
 {
     painter().clear_clip_rect();
+    clip_to_target_rect(painter());
     return CommandResult::Continue;
 }
 
@@ -57,8 +57,14 @@ public:
 
     PaintingCommandExecutorCPU(Gfx::Bitmap& bitmap);
 
+    // Only paints the given part of the bitmap, whatever the commands do with the clip rect.
+    PaintingCommandExecutorCPU(Gfx::Bitmap& bitmap, Gfx::IntRect const& target_rect);
+
 private:
+    void clip_to_target_rect(Gfx::Painter&);
+
     Gfx::Bitmap& m_target_bitmap;
+    Optional<Gfx::IntRect> m_target_rect;
 
     struct StackingContext {
         MaybeOwned<Gfx::Painter> painter;
@@ -408,7 +408,8 @@ static Optional<Gfx::IntRect> command_bounding_rectangle(PaintingCommand const&
         });
 }
 
-void RecordingPainter::execute(PaintingCommandExecutor& executor)
+template<typename CommandIndexCallback>
+void RecordingPainter::execute_commands(PaintingCommandExecutor& executor, size_t command_count, CommandIndexCallback const& command_index)
 {
     if (executor.needs_prepare_glyphs_texture()) {
         HashMap<Gfx::Font const*, HashTable<u32>> unique_glyphs;
@@ -437,8 +438,9 @@ void RecordingPainter::execute(PaintingCommandExecutor& executor)
     }
 
     size_t next_command_index = 0;
-    while (next_command_index < m_painting_commands.size()) {
-        auto& command = m_painting_commands[next_command_index++];
+    while (next_command_index < command_count) {
+        size_t index = command_index(next_command_index++);
+        auto& command = m_painting_commands[index];
         auto bounding_rect = command_bounding_rectangle(command);
         if (bounding_rect.has_value() && (bounding_rect->is_empty() || executor.would_be_fully_clipped_by_painter(*bounding_rect))) {
             continue;
@@ -547,10 +549,12 @@ void RecordingPainter::execute(PaintingCommandExecutor& executor)
 
         if (result == CommandResult::SkipStackingContext) {
             auto stacking_context_nesting_level = 1;
-            while (next_command_index < m_painting_commands.size()) {
-                if (m_painting_commands[next_command_index].has<PushStackingContext>()) {
+            while (next_command_index < command_count) {
+                size_t skipped_index = command_index(next_command_index);
+                auto const& skipped_command = m_painting_commands[skipped_index];
+                if (skipped_command.has<PushStackingContext>()) {
                     stacking_context_nesting_level++;
-                } else if (m_painting_commands[next_command_index].has<PopStackingContext>()) {
+                } else if (skipped_command.has<PopStackingContext>()) {
                     stacking_context_nesting_level--;
                 }
 
@@ -563,4 +567,134 @@ void RecordingPainter::execute(PaintingCommandExecutor& executor)
     }
 }
 
+void RecordingPainter::execute(PaintingCommandExecutor& executor)
+{
+    execute_commands(executor, m_painting_commands.size(), [](size_t index) { return index; });
+}
+
+void RecordingPainter::execute(PaintingCommandExecutor& executor, ReadonlySpan<size_t> command_indices)
+{
+    execute_commands(executor, command_indices.size(), [&](size_t index) { return command_indices[index]; });
+}
+
+Vector<Vector<size_t>> RecordingPainter::bin_commands_into_tiles(Gfx::IntSize target_size, int tile_size) const
+{
+    auto column_count = ceil_div(target_size.width(), tile_size);
+    auto row_count = ceil_div(target_size.height(), tile_size);
+
+    Vector<Vector<size_t>> tiles;
+    tiles.resize(column_count * row_count);
+
+    // Rects are in the coordinates of the target, an empty Optional means the command may paint anywhere.
+    auto add_to_tiles = [&](size_t command_index, Optional<Gfx::IntRect> const& rect) {
+        int first_column = 0;
+        int first_row = 0;
+        int last_column = column_count - 1;
+        int last_row = row_count - 1;
+        if (rect.has_value()) {
+            auto visible_rect = rect->intersected(Gfx::IntRect { {}, target_size });
+            if (visible_rect.is_empty())
+                return;
+            first_column = visible_rect.left() / tile_size;
+            first_row = visible_rect.top() / tile_size;
+            last_column = (visible_rect.right() - 1) / tile_size;
+            last_row = (visible_rect.bottom() - 1) / tile_size;
+        }
+        for (int row = first_row; row <= last_row; ++row) {
+            for (int column = first_column; column <= last_column; ++column)
+                tiles[row * column_count + column].append(command_index);
+        }
+    };
+
+    // This has to follow what PaintingCommandExecutorCPU does with stacking contexts: those that only translate their
+    // contents paint straight into the target, the others paint into a separate bitmap that gets blitted into the
+    // target once they are popped. Inside of those, everything goes into the tiles that the bitmap is blitted to.
+    struct StackingContextState {
+        Gfx::IntPoint translation;
+        bool paints_into_separate_bitmap { false };
+        Optional<Gfx::IntRect> destination;
+    };
+    Vector<StackingContextState> stacking_contexts;
+    StackingContextState state;
+
+    for (size_t command_index = 0; command_index < m_painting_commands.size(); ++command_index) {
+        auto const& command = m_painting_commands[command_index];
+
+        if (command.has<PushStackingContext>()) {
+            auto const& push_stacking_context = command.get<PushStackingContext>();
+            stacking_contexts.append(state);
+
+            if (!state.paints_into_separate_bitmap) {
+                if (push_stacking_context.is_fixed_position)
+                    state.translation = {};
+
+                auto affine_transform = Gfx::extract_2d_affine_transform(push_stacking_context.transform.matrix);
+                auto translation = state.translation + push_stacking_context.post_transform_translation;
+                if (push_stacking_context.mask.has_value()) {
+                    state.paints_into_separate_bitmap = true;
+                    state.destination = push_stacking_context.source_paintable_rect.translated(translation);
+                } else if (!affine_transform.is_identity_or_translation()) {
+                    // Anything that isn't a translation is assumed to be able to end up anywhere.
+                    state.paints_into_separate_bitmap = true;
+                    state.destination = {};
+                } else if (push_stacking_context.opacity != 1.0f) {
+                    state.paints_into_separate_bitmap = true;
+                    state.destination = push_stacking_context.source_paintable_rect.translated(translation + affine_transform.translation().to_rounded<int>());
+                } else {
+                    state.translation = translation + affine_transform.translation().to_rounded<int>();
+                }
+            }
+
+            add_to_tiles(command_index, state.paints_into_separate_bitmap ? state.destination : Optional<Gfx::IntRect> {});
+            continue;
+        }
+
+        if (command.has<PopStackingContext>()) {
+            add_to_tiles(command_index, state.paints_into_separate_bitmap ? state.destination : Optional<Gfx::IntRect> {});
+            if (!stacking_contexts.is_empty())
+                state = stacking_contexts.take_last();
+            continue;
+        }
+
+        if (state.paints_into_separate_bitmap) {
+            add_to_tiles(command_index, state.destination);
+            continue;
+        }
+
+        auto bounding_rect = command_bounding_rectangle(command);
+        if (bounding_rect.has_value())
+            bounding_rect = bounding_rect->translated(state.translation);
+        add_to_tiles(command_index, bounding_rect);
+    }
+
+    return tiles;
+}
+
+bool RecordingPainter::has_commands_that_sample_outside_their_bounds() const
+{
+    for (auto const& command : m_painting_commands) {
+        // Backdrop filters (blurs in particular) read the pixels around the region they are applied to.
+        if (command.has<ApplyBackdropFilter>())
+            return true;
+        // Stacking contexts that scale, rotate or skew resample what is underneath them.
+        if (command.has<PushStackingContext>()) {
+            auto const& push_stacking_context = command.get<PushStackingContext>();
+            if (!push_stacking_context.mask.has_value() && !Gfx::extract_2d_affine_transform(push_stacking_context.transform.matrix).is_identity_or_translation())
+                return true;
+        }
+    }
+    return false;
+}
+
+bool RecordingPainter::has_content_fixed_to_the_viewport() const
+{
+    if (m_has_content_fixed_to_the_viewport)
+        return true;
+    for (auto const& command : m_painting_commands) {
+        if (command.has<PushStackingContext>() && command.get<PushStackingContext>().is_fixed_position)
+            return true;
+    }
+    return false;
+}
+
 }
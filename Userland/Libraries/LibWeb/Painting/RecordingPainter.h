@@ -505,6 +505,24 @@ public:
 
     void execute(PaintingCommandExecutor&);
 
+    // Executes only the given commands, in order. They have to include the push and pop of every stacking context
+    // that any of them is nested in.
+    void execute(PaintingCommandExecutor&, ReadonlySpan<size_t> command_indices);
+
+    // Sorts the commands into the tiles of a grid of `tile_size` squares covering a target of the given size, row by
+    // row. A command goes into every tile it may paint to, and all of a stacking context's commands go into the same
+    // tiles as its push and pop, so every tile can be executed on its own.
+    Vector<Vector<size_t>> bin_commands_into_tiles(Gfx::IntSize target_size, int tile_size) const;
+
+    // Some commands read back pixels outside of their bounding rectangle, so a tile can't be painted without the
+    // rest of the target already being painted.
+    bool has_commands_that_sample_outside_their_bounds() const;
+
+    // Content that stays where it is in the viewport while the page scrolls, like fixed backgrounds. Fixed-position
+    // stacking contexts are found by looking at the commands, so they don't have to be marked.
+    void mark_as_having_content_fixed_to_the_viewport() { m_has_content_fixed_to_the_viewport = true; }
+    bool has_content_fixed_to_the_viewport() const;
+
     RecordingPainter()
     {
         m_state_stack.append(State());
@@ -518,6 +536,9 @@ public:
     State const& state() const { return m_state_stack.last(); }
 
 private:
+    template<typename CommandIndexCallback>
+    void execute_commands(PaintingCommandExecutor&, size_t command_count, CommandIndexCallback const&);
+
     void push_command(PaintingCommand command)
     {
         m_painting_commands.append(command);
@@ -525,6 +546,7 @@ private:
 
     Vector<PaintingCommand> m_painting_commands;
     Vector<State> m_state_stack;
+    bool m_has_content_fixed_to_the_viewport { false };
 };
 
 class RecordingPainterStateSaver {
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibGfx/Painter.h>
+#include <LibWeb/Painting/PaintingCommandExecutorCPU.h>
+#include <LibWeb/Painting/TileCache.h>
+
+namespace Web::Painting {
+
+template<typename Callback>
+void TileCache::for_each_tile_intersecting(Gfx::IntRect const& rect, Callback callback) const
+{
+    auto visible_rect = rect.intersected(m_frame->rect());
+    if (visible_rect.is_empty())
+        return;
+
+    for (int row = visible_rect.top() / tile_size; row <= (visible_rect.bottom() - 1) / tile_size; ++row) {
+        for (int column = visible_rect.left() / tile_size; column <= (visible_rect.right() - 1) / tile_size; ++column)
+            callback(static_cast<size_t>(row * m_column_count + column));
+    }
+}
+
+void TileCache::invalidate(Gfx::IntRect const& rect)
+{
+    if (!m_frame)
+        return;
+    for_each_tile_intersecting(rect, [&](size_t tile_index) {
+        m_tile_is_valid[tile_index] = false;
+    });
+}
+
+void TileCache::invalidate_all()
+{
+    for (auto& is_valid : m_tile_is_valid)
+        is_valid = false;
+}
+
+void TileCache::scroll_by(Gfx::IntPoint delta)
+{
+    if (!m_frame || delta.is_zero())
+        return;
+
+    auto frame_rect = m_frame->rect();
+    auto destination_rect = frame_rect.translated(delta).intersected(frame_rect);
+    if (destination_rect.is_empty()) {
+        invalidate_all();
+        return;
+    }
+
+    // Rows are moved starting from the side they move towards, so none of them is overwritten before it was read.
+    auto source_rect = destination_rect.translated(-delta);
+    auto move_row = [&](int y) {
+        memmove(m_frame->scanline_u8(destination_rect.top() + y) + destination_rect.left() * sizeof(Gfx::ARGB32),
+            m_frame->scanline_u8(source_rect.top() + y) + source_rect.left() * sizeof(Gfx::ARGB32),
+            destination_rect.width() * sizeof(Gfx::ARGB32));
+    };
+    if (delta.y() > 0) {
+        for (int y = destination_rect.height() - 1; y >= 0; --y)
+            move_row(y);
+    } else {
+        for (int y = 0; y < destination_rect.height(); ++y)
+            move_row(y);
+    }
+
+    // A tile stays valid if all of its pixels were moved there from tiles that were valid.
+    Vector<bool> tile_is_valid;
+    tile_is_valid.resize(m_tile_is_valid.size());
+    for (size_t tile_index = 0; tile_index < tile_is_valid.size(); ++tile_index) {
+        auto previous_rect = tile_rect(tile_index).translated(-delta);
+        if (!frame_rect.contains(previous_rect))
+            continue;
+        bool is_valid = true;
+        for_each_tile_intersecting(previous_rect, [&](size_t previous_tile_index) {
+            is_valid &= m_tile_is_valid[previous_tile_index];
+        });
+        tile_is_valid[tile_index] = is_valid;
+    }
+    m_tile_is_valid = move(tile_is_valid);
+}
+
+Gfx::IntRect TileCache::tile_rect(size_t tile_index) const
+{
+    auto column = static_cast<int>(tile_index) % m_column_count;
+    auto row = static_cast<int>(tile_index) / m_column_count;
+    return Gfx::IntRect { column * tile_size, row * tile_size, tile_size, tile_size }.intersected(m_frame->rect());
+}
+
+ErrorOr<void> TileCache::resize(Gfx::IntSize size, Gfx::BitmapFormat format)
+{
+    m_frame = nullptr;
+    m_frame = TRY(Gfx::Bitmap::create(format, size));
+    m_column_count = ceil_div(size.width(), tile_size);
+    m_tile_is_valid.clear();
+    m_tile_is_valid.resize(m_column_count * ceil_div(size.height(), tile_size));
+    return {};
+}
+
+static void copy_pixels(Gfx::Bitmap const& source, Gfx::Bitmap& destination, Gfx::IntRect const& rect)
+{
+    for (int y = rect.top(); y < rect.bottom(); ++y)
+        memcpy(destination.scanline_u8(y) + rect.left() * sizeof(Gfx::ARGB32), source.scanline_u8(y) + rect.left() * sizeof(Gfx::ARGB32), rect.width() * sizeof(Gfx::ARGB32));
+}
+
+ErrorOr<void> TileCache::paint(RecordingPainter& recording_painter, Gfx::IntSize size, Gfx::Bitmap& target)
+{
+    if (size.is_empty())
+        return {};
+    if (!m_frame || m_frame->size() != size || m_frame->format() != target.format())
+        TRY(resize(size, target.format()));
+
+    auto copy_rect = m_frame->rect().intersected(target.rect());
+
+    // Binning the commands and painting them tile by tile only pays off if some of the tiles can be kept. Commands that
+    // read pixels outside of their bounds need everything around them to be painted first, so they can't be tiled.
+    if (!m_tile_is_valid.contains_slow(true) || recording_painter.has_commands_that_sample_outside_their_bounds()) {
+        PaintingCommandExecutorCPU executor { target };
+        recording_painter.execute(executor);
+        copy_pixels(target, *m_frame, copy_rect);
+        for (size_t tile_index = 0; tile_index < m_tile_is_valid.size(); ++tile_index)
+            m_tile_is_valid[tile_index] = copy_rect.contains(tile_rect(tile_index));
+        return {};
+    }
+
+    if (m_tile_is_valid.contains_slow(false)) {
+        auto tiles = recording_painter.bin_commands_into_tiles(size, tile_size);
+        VERIFY(tiles.size() == m_tile_is_valid.size());
+
+        for (size_t tile_index = 0; tile_index < tiles.size(); ++tile_index) {
+            if (m_tile_is_valid[tile_index])
+                continue;
+            auto rect = tile_rect(tile_index);
+            Gfx::Painter(*m_frame).clear_rect(rect, Color::Transparent);
+            PaintingCommandExecutorCPU executor { *m_frame, rect };
+            recording_painter.execute(executor, tiles[tile_index]);
+            m_tile_is_valid[tile_index] = true;
+        }
+    }
+
+    copy_pixels(*m_frame, target, copy_rect);
+    return {};
+}
+
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/RefPtr.h>
+#include <AK/Vector.h>
+#include <LibGfx/Bitmap.h>
+#include <LibGfx/Rect.h>
+#include <LibWeb/Painting/RecordingPainter.h>
+
+namespace Web::Painting {
+
+// Keeps the pixels of the last painted frame, split into tiles, so that painting the next one only has to rasterize
+// the tiles that were invalidated in between. Every tile is rasterized with just the commands that can touch it.
+class TileCache {
+public:
+    static constexpr int tile_size = 256;
+
+    void invalidate(Gfx::IntRect const&);
+    void invalidate_all();
+
+    // Moves the cached frame along with content that moved by `delta` within it, e.g. by (0, -100) when the page was
+    // scrolled down by 100 pixels. Only the tiles that this uncovers have to be repainted.
+    void scroll_by(Gfx::IntPoint delta);
+
+    // Paints the invalidated tiles of a frame of the given size, then copies the whole frame into the top left of
+    // `target`. If no tile can be reused, the frame is painted straight into `target` in one go instead.
+    ErrorOr<void> paint(RecordingPainter&, Gfx::IntSize, Gfx::Bitmap& target);
+
+    bool tile_is_valid(size_t tile_index) const { return m_tile_is_valid[tile_index]; }
+    size_t tile_count() const { return m_tile_is_valid.size(); }
+
+private:
+    ErrorOr<void> resize(Gfx::IntSize, Gfx::BitmapFormat);
+    Gfx::IntRect tile_rect(size_t tile_index) const;
+
+    template<typename Callback>
+    void for_each_tile_intersecting(Gfx::IntRect const&, Callback) const;
+
+    RefPtr<Gfx::Bitmap> m_frame;
+    int m_column_count { 0 };
+    Vector<bool> m_tile_is_valid;
+};
+
+}
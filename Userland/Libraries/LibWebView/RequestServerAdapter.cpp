@@ -82,9 +82,15 @@ ErrorOr<NonnullRefPtr<RequestServerAdapter>> RequestServerAdapter::try_create()
 RequestServerAdapter::RequestServerAdapter(NonnullRefPtr<Protocol::RequestClient> protocol_client)
     : m_protocol_client(protocol_client)
 {
+    Web::Fetch::Fetching::HTTPCache::the().set_disk_store(this);
 }
 
-RequestServerAdapter::~RequestServerAdapter() = default;
+RequestServerAdapter::~RequestServerAdapter()
+{
+    auto& http_cache = Web::Fetch::Fetching::HTTPCache::the();
+    if (http_cache.disk_store() == this)
+        http_cache.set_disk_store(nullptr);
+}
 
 RefPtr<Web::ResourceLoaderConnectorRequest> RequestServerAdapter::start_request(DeprecatedString const& method, URL const& url, HashMap<DeprecatedString, DeprecatedString> const& headers, ReadonlyBytes body, Core::ProxyData const& proxy)
 {
@@ -104,4 +110,24 @@ void RequestServerAdapter::preconnect(AK::URL const& url)
     m_protocol_client->ensure_connection(url, RequestServer::CacheLevel::CreateConnection);
 }
 
+void RequestServerAdapter::load_http_cache_entry(DeprecatedString const& key, Function<void(Optional<ByteBuffer>)> on_complete)
+{
+    m_protocol_client->load_http_cache_entry(key, move(on_complete));
+}
+
+void RequestServerAdapter::store_http_cache_entry(DeprecatedString const& key, ByteBuffer entry)
+{
+    m_protocol_client->store_http_cache_entry(key, move(entry));
+}
+
+void RequestServerAdapter::remove_http_cache_entry(DeprecatedString const& key)
+{
+    m_protocol_client->remove_http_cache_entry(key);
+}
+
+void RequestServerAdapter::clear_http_cache()
+{
+    m_protocol_client->clear_http_cache();
+}
+
 }
@@ -8,6 +8,7 @@
 
 #include <AK/Function.h>
 #include <AK/URL.h>
+#include <LibWeb/Fetch/Fetching/HTTPCache.h>
 #include <LibWeb/Loader/ResourceLoader.h>
 
 namespace Protocol {
@@ -34,7 +35,9 @@ private:
     NonnullRefPtr<Protocol::Request> m_request;
 };
 
-class RequestServerAdapter : public Web::ResourceLoaderConnector {
+class RequestServerAdapter
+    : public Web::ResourceLoaderConnector
+    , public Web::Fetch::Fetching::HTTPCache::DiskStore {
 public:
     explicit RequestServerAdapter(NonnullRefPtr<Protocol::RequestClient> protocol_client);
 
@@ -47,6 +50,12 @@ public:
 
     virtual RefPtr<Web::ResourceLoaderConnectorRequest> start_request(DeprecatedString const& method, URL const&, HashMap<DeprecatedString, DeprecatedString> const& request_headers = {}, ReadonlyBytes request_body = {}, Core::ProxyData const& = {}) override;
 
+    // ^Web::Fetch::Fetching::HTTPCache::DiskStore
+    virtual void load_http_cache_entry(DeprecatedString const& key, Function<void(Optional<ByteBuffer>)> on_complete) override;
+    virtual void store_http_cache_entry(DeprecatedString const& key, ByteBuffer entry) override;
+    virtual void remove_http_cache_entry(DeprecatedString const& key) override;
+    virtual void clear_http_cache() override;
+
 private:
     RefPtr<Protocol::RequestClient> m_protocol_client;
 };
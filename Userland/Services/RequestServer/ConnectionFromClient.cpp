@@ -8,6 +8,7 @@
 #include <AK/NonnullOwnPtr.h>
 #include <LibCore/Proxy.h>
 #include <RequestServer/ConnectionFromClient.h>
+#include <RequestServer/HTTPDiskCache.h>
 #include <RequestServer/Protocol.h>
 #include <RequestServer/Request.h>
 #include <RequestServer/RequestClientEndpoint.h>
@@ -170,4 +171,30 @@ void ConnectionFromClient::ensure_connection(URL const& url, ::RequestServer::Ca
         dbgln("EnsureConnection: Invalid URL scheme: '{}'", url.scheme());
 }
 
+void ConnectionFromClient::load_http_cache_entry(i32 load_id, DeprecatedString const& key)
+{
+    HTTPDiskCache::the().load(key, [weak_this = make_weak_ptr<ConnectionFromClient>(), load_id](Optional<ByteBuffer> entry) {
+        if (weak_this)
+            weak_this->async_http_cache_entry_loaded(load_id, move(entry));
+    });
+}
+
+void ConnectionFromClient::store_http_cache_entry(DeprecatedString const& key, ByteBuffer const& entry)
+{
+    auto entry_copy = ByteBuffer::copy(entry);
+    if (entry_copy.is_error())
+        return;
+    HTTPDiskCache::the().store(key, entry_copy.release_value());
+}
+
+void ConnectionFromClient::remove_http_cache_entry(DeprecatedString const& key)
+{
+    HTTPDiskCache::the().remove(key);
+}
+
+void ConnectionFromClient::clear_http_cache()
+{
+    HTTPDiskCache::the().clear();
+}
+
 }
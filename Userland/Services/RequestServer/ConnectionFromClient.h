@@ -36,6 +36,10 @@ private:
     virtual Messages::RequestServer::StopRequestResponse stop_request(i32) override;
     virtual Messages::RequestServer::SetCertificateResponse set_certificate(i32, DeprecatedString const&, DeprecatedString const&) override;
     virtual void ensure_connection(URL const& url, ::RequestServer::CacheLevel const& cache_level) override;
+    virtual void load_http_cache_entry(i32, DeprecatedString const&) override;
+    virtual void store_http_cache_entry(DeprecatedString const&, ByteBuffer const&) override;
+    virtual void remove_http_cache_entry(DeprecatedString const&) override;
+    virtual void clear_http_cache() override;
 
     HashMap<i32, OwnPtr<Request>> m_requests;
 };
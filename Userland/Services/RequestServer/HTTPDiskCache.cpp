@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <AK/Endian.h>
+#include <AK/Hex.h>
+#include <AK/LexicalPath.h>
+#include <AK/MemoryStream.h>
+#include <AK/QuickSort.h>
+#include <LibCore/DirIterator.h>
+#include <LibCore/Directory.h>
+#include <LibCore/File.h>
+#include <LibCore/StandardPaths.h>
+#include <LibCore/System.h>
+#include <LibCrypto/Hash/SHA2.h>
+#include <LibThreading/BackgroundAction.h>
+#include <RequestServer/HTTPDiskCache.h>
+#include <unistd.h>
+
+namespace RequestServer {
+
+static constexpr u64 disk_cache_capacity = 256 * MiB;
+
+HTTPDiskCache& HTTPDiskCache::the()
+{
+    static HTTPDiskCache cache;
+    return cache;
+}
+
+DeprecatedString HTTPDiskCache::directory()
+{
+    return LexicalPath::join(Core::StandardPaths::cache_directory(), "RequestServer"sv, "HTTP"sv).string();
+}
+
+HTTPDiskCache::HTTPDiskCache()
+    : m_directory(directory())
+{
+}
+
+void HTTPDiskCache::load(DeprecatedString key, Function<void(Optional<ByteBuffer>)> on_complete)
+{
+    (void)Threading::BackgroundAction<Optional<ByteBuffer>>::construct(
+        [this, key = move(key)](auto&) -> ErrorOr<Optional<ByteBuffer>> {
+            auto entry_or_error = read_entry(key);
+            if (entry_or_error.is_error()) {
+                dbgln_if(CACHE_DEBUG, "HTTPDiskCache: Failed to load {}: {}", key, entry_or_error.error());
+                return Optional<ByteBuffer> {};
+            }
+            return entry_or_error.release_value();
+        },
+        [on_complete = move(on_complete)](Optional<ByteBuffer> entry) -> ErrorOr<void> {
+            on_complete(move(entry));
+            return {};
+        });
+}
+
+void HTTPDiskCache::store(DeprecatedString key, ByteBuffer entry)
+{
+    (void)Threading::BackgroundAction<int>::construct(
+        [this, key = move(key), entry = move(entry)](auto&) -> ErrorOr<int> {
+            if (!m_available)
+                return 0;
+
+            if (auto result = write_entry(key, entry); result.is_error()) {
+                dbgln_if(CACHE_DEBUG, "HTTPDiskCache: Failed to store {}: {}", key, result.error());
+                // If the cache directory isn't usable at all, stop trying.
+                if (result.error().is_errno() && (result.error().code() == EACCES || result.error().code() == EPERM || result.error().code() == EROFS))
+                    m_available = false;
+                return 0;
+            }
+
+            evict_if_needed();
+            return 0;
+        },
+        nullptr);
+}
+
+void HTTPDiskCache::remove(DeprecatedString key)
+{
+    (void)Threading::BackgroundAction<int>::construct(
+        [this, key = move(key)](auto&) -> ErrorOr<int> {
+            // NOTE: Our view of the disk usage will be corrected on the next eviction scan.
+            (void)Core::System::unlink(path_for_key(key));
+            return 0;
+        },
+        nullptr);
+}
+
+void HTTPDiskCache::clear()
+{
+    (void)Threading::BackgroundAction<int>::construct(
+        [this](auto&) -> ErrorOr<int> {
+            Core::DirIterator iterator(m_directory, Core::DirIterator::SkipParentAndBaseDir);
+            while (iterator.has_next())
+                (void)Core::System::unlink(iterator.next_full_path());
+            m_size = 0;
+            return 0;
+        },
+        nullptr);
+}
+
+DeprecatedString HTTPDiskCache::path_for_key(StringView key) const
+{
+    auto digest = Crypto::Hash::SHA256::hash(key);
+    return LexicalPath::join(m_directory, encode_hex(digest.bytes())).string();
+}
+
+// Every file starts with the key it was stored under, so that two keys with the same hash are told apart.
+ErrorOr<Optional<ByteBuffer>> HTTPDiskCache::read_entry(DeprecatedString const& key)
+{
+    if (!m_available)
+        return Optional<ByteBuffer> {};
+
+    auto path = path_for_key(key);
+    auto file_or_error = Core::File::open(path, Core::File::OpenMode::Read);
+    if (file_or_error.is_error())
+        return Optional<ByteBuffer> {};
+
+    auto bytes = TRY(file_or_error.value()->read_until_eof());
+    FixedMemoryStream stream { bytes.bytes() };
+    auto key_length = TRY(stream.read_value<LittleEndian<u32>>());
+    if (key_length != key.length() || bytes.size() - sizeof(u32) < key_length || bytes.bytes().slice(sizeof(u32), key_length) != key.bytes())
+        return Optional<ByteBuffer> {};
+
+    // Touch the file so that eviction sees it as recently used.
+    (void)Core::System::utime(path, {});
+
+    dbgln_if(CACHE_DEBUG, "HTTPDiskCache: Loaded {}", key);
+    return TRY(bytes.slice(sizeof(u32) + key_length, bytes.size() - sizeof(u32) - key_length));
+}
+
+ErrorOr<void> HTTPDiskCache::write_entry(DeprecatedString const& key, ReadonlyBytes entry)
+{
+    (void)TRY(Core::Directory::create(m_directory, Core::Directory::CreateDirectories::Yes));
+
+    auto path = path_for_key(key);
+
+    // Other RequestServer processes may be reading this entry, so write it out under a temporary
+    // name first and atomically replace the old file.
+    auto temporary_path = DeprecatedString::formatted("{}.{}.tmp", path, getpid());
+    {
+        auto file = TRY(Core::File::open(temporary_path, Core::File::OpenMode::Write | Core::File::OpenMode::Truncate));
+        TRY(file->write_value<LittleEndian<u32>>(key.length()));
+        TRY(file->write_until_depleted(key.bytes()));
+        TRY(file->write_until_depleted(entry));
+    }
+    if (auto result = Core::System::rename(temporary_path, path); result.is_error()) {
+        (void)Core::System::unlink(temporary_path);
+        return result.release_error();
+    }
+
+    if (m_size.has_value())
+        *m_size += sizeof(u32) + key.length() + entry.size();
+    return {};
+}
+
+void HTTPDiskCache::evict_if_needed()
+{
+    if (m_size.has_value() && *m_size <= disk_cache_capacity)
+        return;
+
+    struct DiskEntry {
+        DeprecatedString path;
+        i64 last_used { 0 };
+        u64 size { 0 };
+    };
+    Vector<DiskEntry> entries;
+    u64 total_size = 0;
+
+    Core::DirIterator iterator(m_directory, Core::DirIterator::SkipParentAndBaseDir);
+    while (iterator.has_next()) {
+        auto path = iterator.next_full_path();
+        auto stat_or_error = Core::System::stat(path);
+        if (stat_or_error.is_error())
+            continue;
+        auto size = static_cast<u64>(stat_or_error.value().st_size);
+        entries.append({ move(path), stat_or_error.value().st_mtime, size });
+        total_size += size;
+    }
+
+    // The cache is shared with other processes, so we re-scan to learn about their writes too.
+    m_size = total_size;
+    if (total_size <= disk_cache_capacity)
+        return;
+
+    // Evict down to three quarters of the capacity, so that we don't have to scan again right away.
+    quick_sort(entries, [](auto const& a, auto const& b) { return a.last_used < b.last_used; });
+    for (auto const& entry : entries) {
+        if (*m_size <= disk_cache_capacity / 4 * 3)
+            break;
+        if (Core::System::unlink(entry.path).is_error())
+            continue;
+        *m_size -= entry.size;
+    }
+
+    dbgln_if(CACHE_DEBUG, "HTTPDiskCache: Evicted down to {} bytes", *m_size);
+}
+
+}
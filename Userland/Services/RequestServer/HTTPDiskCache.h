@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/DeprecatedString.h>
+#include <AK/Function.h>
+#include <AK/Optional.h>
+
+namespace RequestServer {
+
+// The disk tier of the HTTP cache that lives in WebContent (see Web::Fetch::Fetching::HTTPCache).
+// Entries are opaque to us, they're only stored under their key, and evicted least recently used first.
+// The cache directory is shared by all RequestServer processes. All disk I/O happens on the background
+// thread, so it never holds up the event loop.
+class HTTPDiskCache {
+public:
+    static HTTPDiskCache& the();
+
+    static DeprecatedString directory();
+
+    // on_complete is called on the current event loop, with the entry if there is one.
+    void load(DeprecatedString key, Function<void(Optional<ByteBuffer>)> on_complete);
+    void store(DeprecatedString key, ByteBuffer entry);
+    void remove(DeprecatedString key);
+    void clear();
+
+private:
+    HTTPDiskCache();
+
+    // NOTE: Everything below is only ever used from the background thread.
+    DeprecatedString path_for_key(StringView key) const;
+    ErrorOr<Optional<ByteBuffer>> read_entry(DeprecatedString const& key);
+    ErrorOr<void> write_entry(DeprecatedString const& key, ReadonlyBytes entry);
+    void evict_if_needed();
+
+    DeprecatedString m_directory;
+    bool m_available { true };
+    // The cache directory is shared with other processes, so this is only an estimate between eviction scans.
+    Optional<u64> m_size;
+};
+
+}
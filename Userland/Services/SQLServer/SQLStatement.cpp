@@ -114,6 +114,7 @@ bool SQLStatement::should_send_result_rows(SQL::ResultSet const& result) const
 
     switch (result.command()) {
     case SQL::SQLCommand::Describe:
+    case SQL::SQLCommand::Explain:
     case SQL::SQLCommand::Select:
         return true;
     default:
@@ -56,6 +56,7 @@ ConnectionFromClient& PageClient::client() const
 void PageClient::set_has_focus(bool has_focus)
 {
     m_has_focus = has_focus;
+    m_tile_cache.invalidate_all();
 }
 
 void PageClient::setup_palette()
@@ -83,6 +84,7 @@ Gfx::Palette PageClient::palette() const
 void PageClient::set_palette_impl(Gfx::PaletteImpl& impl)
 {
     m_palette_impl = impl;
+    m_tile_cache.invalidate_all();
     if (auto* document = page().top_level_browsing_context().active_document())
         document->invalidate_style();
 }
@@ -90,6 +92,7 @@ void PageClient::set_palette_impl(Gfx::PaletteImpl& impl)
 void PageClient::set_preferred_color_scheme(Web::CSS::PreferredColorScheme color_scheme)
 {
     m_preferred_color_scheme = color_scheme;
+    m_tile_cache.invalidate_all();
     if (auto* document = page().top_level_browsing_context().active_document())
         document->invalidate_style();
 }
@@ -164,8 +167,26 @@ void PageClient::paint(Web::DevicePixelRect const& content_rect, Gfx::Bitmap& ta
         }
 #endif
     } else {
-        Web::Painting::PaintingCommandExecutorCPU painting_command_executor(target);
-        recording_painter.execute(painting_command_executor);
+        // Scrolling moves the tiles we already have, unless some of the content stays in place while the rest moves.
+        // Resizing changes what goes into every tile. Otherwise, only what was invalidated since has to be repainted.
+        if (content_rect.size() != m_last_painted_content_rect.size()) {
+            m_tile_cache.invalidate_all();
+        } else if (content_rect.location() != m_last_painted_content_rect.location()) {
+            if (recording_painter.has_content_fixed_to_the_viewport())
+                m_tile_cache.invalidate_all();
+            else
+                m_tile_cache.scroll_by((m_last_painted_content_rect.location() - content_rect.location()).to_type<int>());
+        }
+        m_tile_cache.invalidate(m_repaint_rect.translated(-content_rect.location()).to_type<int>());
+        m_last_painted_content_rect = content_rect;
+        m_repaint_rect = {};
+
+        if (auto result = m_tile_cache.paint(recording_painter, bitmap_rect.size(), target); result.is_error()) {
+            dbgln("Unable to paint using the tile cache: {}", result.error());
+            m_tile_cache.invalidate_all();
+            Web::Painting::PaintingCommandExecutorCPU painting_command_executor(target);
+            recording_painter.execute(painting_command_executor);
+        }
     }
 }
 
@@ -177,6 +198,7 @@ void PageClient::set_viewport_rect(Web::DevicePixelRect const& rect)
 void PageClient::page_did_invalidate(Web::CSSPixelRect const& content_rect)
 {
     m_invalidation_rect = m_invalidation_rect.united(page().enclosing_device_rect(content_rect));
+    m_repaint_rect = m_repaint_rect.united(page().enclosing_device_rect(content_rect));
     if (!m_invalidation_coalescing_timer->is_active())
         m_invalidation_coalescing_timer->start();
 }
@@ -11,6 +11,7 @@
 #include <LibAccelGfx/Forward.h>
 #include <LibGfx/Rect.h>
 #include <LibWeb/Page/Page.h>
+#include <LibWeb/Painting/TileCache.h>
 #include <LibWeb/PixelUnits.h>
 #include <WebContent/Forward.h>
 
@@ -35,9 +36,17 @@ public:
     void set_palette_impl(Gfx::PaletteImpl&);
     void set_viewport_rect(Web::DevicePixelRect const&);
     void set_screen_rects(Vector<Gfx::IntRect, 4> const& rects, size_t main_screen_index) { m_screen_rect = rects[main_screen_index].to_type<Web::DevicePixels>(); }
-    void set_device_pixels_per_css_pixel(float device_pixels_per_css_pixel) { m_device_pixels_per_css_pixel = device_pixels_per_css_pixel; }
+    void set_device_pixels_per_css_pixel(float device_pixels_per_css_pixel)
+    {
+        m_device_pixels_per_css_pixel = device_pixels_per_css_pixel;
+        m_tile_cache.invalidate_all();
+    }
     void set_preferred_color_scheme(Web::CSS::PreferredColorScheme);
-    void set_should_show_line_box_borders(bool b) { m_should_show_line_box_borders = b; }
+    void set_should_show_line_box_borders(bool b)
+    {
+        m_should_show_line_box_borders = b;
+        m_tile_cache.invalidate_all();
+    }
     void set_has_focus(bool);
     void set_is_scripting_enabled(bool);
     void set_window_position(Web::DevicePixelPoint);
@@ -138,6 +147,11 @@ private:
 
     RefPtr<Web::Platform::Timer> m_invalidation_coalescing_timer;
     Web::DevicePixelRect m_invalidation_rect;
+
+    Web::Painting::TileCache m_tile_cache;
+    // Everything invalidated since the last paint, in the same coordinates as the painted content rect.
+    Web::DevicePixelRect m_repaint_rect;
+    Web::DevicePixelRect m_last_painted_content_rect;
     Web::CSS::PreferredColorScheme m_preferred_color_scheme { Web::CSS::PreferredColorScheme::Auto };
 
     RefPtr<WebDriverConnection> m_webdriver;
@@ -25,6 +25,7 @@
 #include <LibHTTP/HttpResponse.h>
 #include <WebServer/Client.h>
 #include <WebServer/Configuration.h>
+#include <WebServer/FileCache.h>
 #include <stdio.h>
 #include <unistd.h>
 
@@ -130,6 +131,12 @@ ErrorOr<bool> Client::handle_request(HTTP::HttpRequest const& request)
 
     auto real_path = TRY(String::formatted("{}{}", Configuration::the().document_root_path(), requested_path));
 
+    // Fast path: a file we have served before, and which has not changed since.
+    if (auto cached_file = TRY(FileCache::the().lookup(real_path))) {
+        TRY(send_file_response(*cached_file, request));
+        return true;
+    }
+
     if (FileSystem::is_directory(real_path.bytes_as_string_view())) {
         if (!resource_decoded.ends_with('/')) {
             TRY(send_redirect(TRY(String::formatted("{}/", requested_path)), request));
@@ -166,6 +173,11 @@ ErrorOr<bool> Client::handle_request(HTTP::HttpRequest const& request)
         return false;
     }
 
+    if (auto file = TRY(FileCache::the().open(real_path))) {
+        TRY(send_file_response(*file, request));
+        return true;
+    }
+
     auto stream = TRY(Core::File::open(real_path.bytes_as_string_view(), Core::File::OpenMode::Read));
 
     auto const info = ContentInfo {
@@ -176,7 +188,7 @@ ErrorOr<bool> Client::handle_request(HTTP::HttpRequest const& request)
     return true;
 }
 
-ErrorOr<void> Client::send_response(Stream& response, HTTP::HttpRequest const& request, ContentInfo content_info)
+ErrorOr<void> Client::send_response_headers(HTTP::HttpRequest const& request, ContentInfo const& content_info)
 {
     StringBuilder builder;
     TRY(builder.try_append("HTTP/1.0 200 OK\r\n"sv));
@@ -194,6 +206,46 @@ ErrorOr<void> Client::send_response(Stream& response, HTTP::HttpRequest const& r
     auto builder_contents = TRY(builder.to_byte_buffer());
     TRY(m_socket->write_until_depleted(builder_contents));
     log_response(200, request);
+    return {};
+}
+
+void Client::finish_response(HTTP::HttpRequest const& request)
+{
+    auto keep_alive = false;
+    if (auto it = request.headers().find_if([](auto& header) { return header.name.equals_ignoring_ascii_case("Connection"sv); }); !it.is_end()) {
+        if (it->value.trim_whitespace().equals_ignoring_ascii_case("keep-alive"sv))
+            keep_alive = true;
+    }
+    if (!keep_alive)
+        m_socket->close();
+}
+
+ErrorOr<void> Client::send_file_response(FileCache::Entry const& file, HTTP::HttpRequest const& request)
+{
+    TRY(send_response_headers(request, { .type = file.mime_type, .length = file.size }));
+
+    // Let the kernel move the file contents straight to the socket.
+    auto socket_fd = m_socket->fd();
+    if (!socket_fd.has_value())
+        return Error::from_errno(ENOTCONN);
+
+    off_t offset = 0;
+    while (static_cast<size_t>(offset) < file.size) {
+        auto nsent = TRY(Core::System::sendfile(*socket_fd, file.fd, &offset, file.size - offset));
+        if (nsent == 0) {
+            // The file was truncated underneath us, so we can't deliver the promised Content-Length.
+            m_socket->close();
+            return {};
+        }
+    }
+
+    finish_response(request);
+    return {};
+}
+
+ErrorOr<void> Client::send_response(Stream& response, HTTP::HttpRequest const& request, ContentInfo content_info)
+{
+    TRY(send_response_headers(request, content_info));
 
     char buffer[PAGE_SIZE];
     do {
@@ -213,14 +265,7 @@ ErrorOr<void> Client::send_response(Stream& response, HTTP::HttpRequest const& r
         }
     } while (true);
 
-    auto keep_alive = false;
-    if (auto it = request.headers().find_if([](auto& header) { return header.name.equals_ignoring_ascii_case("Connection"sv); }); !it.is_end()) {
-        if (it->value.trim_whitespace().equals_ignoring_ascii_case("keep-alive"sv))
-            keep_alive = true;
-    }
-    if (!keep_alive)
-        m_socket->close();
-
+    finish_response(request);
     return {};
 }
 
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/MimeData.h>
+#include <LibCore/System.h>
+#include <WebServer/FileCache.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace WebServer {
+
+// Each entry holds a file descriptor open, so keep this well below the process' fd limit.
+static constexpr size_t max_entry_count = 128;
+
+FileCache::Entry::~Entry()
+{
+    if (fd >= 0)
+        (void)Core::System::close(fd);
+}
+
+FileCache& FileCache::the()
+{
+    static FileCache s_the;
+    return s_the;
+}
+
+static bool is_same_file(FileCache::Entry const& entry, struct stat const& st)
+{
+    return entry.device == st.st_dev
+        && entry.inode == st.st_ino
+        && entry.size == static_cast<size_t>(st.st_size)
+        && entry.modification_time.tv_sec == st.st_mtim.tv_sec
+        && entry.modification_time.tv_nsec == st.st_mtim.tv_nsec
+        && entry.change_time.tv_sec == st.st_ctim.tv_sec
+        && entry.change_time.tv_nsec == st.st_ctim.tv_nsec;
+}
+
+ErrorOr<RefPtr<FileCache::Entry>> FileCache::lookup(String const& path)
+{
+    auto it = m_entries.find(path);
+    if (it == m_entries.end())
+        return nullptr;
+
+    NonnullRefPtr entry = it->value;
+    m_entries.remove(it);
+
+    // NOTE: A change of permissions updates the change time, so a file that has become unreadable is not served from here.
+    auto st_or_error = Core::System::stat(path);
+    if (st_or_error.is_error() || !is_same_file(*entry, st_or_error.value()))
+        return nullptr;
+
+    // Move the entry to the back of the eviction order.
+    TRY(m_entries.try_set(path, entry));
+    return entry;
+}
+
+ErrorOr<RefPtr<FileCache::Entry>> FileCache::open(String const& path)
+{
+    auto fd = TRY(Core::System::open(path, O_RDONLY | O_CLOEXEC));
+    auto entry = adopt_ref(*new Entry);
+    entry->fd = fd;
+
+    auto st = TRY(Core::System::fstat(fd));
+    if (!S_ISREG(st.st_mode))
+        return nullptr;
+
+    entry->size = st.st_size;
+    entry->mime_type = TRY(String::from_utf8(Core::guess_mime_type_based_on_filename(path)));
+    entry->device = st.st_dev;
+    entry->inode = st.st_ino;
+    entry->modification_time = st.st_mtim;
+    entry->change_time = st.st_ctim;
+
+    if (m_entries.size() >= max_entry_count)
+        m_entries.remove(m_entries.begin());
+    TRY(m_entries.try_set(path, entry));
+    return entry;
+}
+
+}
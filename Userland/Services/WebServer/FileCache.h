@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/RefCounted.h>
+#include <AK/String.h>
+#include <sys/stat.h>
+
+namespace WebServer {
+
+// Keeps recently served files open, along with the metadata needed to respond to a request for them,
+// so that repeated requests for the same file cost a single stat() before the body is sent.
+class FileCache {
+public:
+    struct Entry : public RefCounted<Entry> {
+        ~Entry();
+
+        int fd { -1 };
+        size_t size { 0 };
+        String mime_type;
+
+        dev_t device { 0 };
+        ino_t inode { 0 };
+        timespec modification_time {};
+        timespec change_time {};
+    };
+
+    static FileCache& the();
+
+    // Returns the cached entry for the path if the file is still the one we opened, and hasn't changed since.
+    ErrorOr<RefPtr<Entry>> lookup(String const& path);
+
+    // Opens the file at the path and caches it. Returns null if the path is not a regular file.
+    ErrorOr<RefPtr<Entry>> open(String const& path);
+
+private:
+    FileCache() = default;
+
+    OrderedHashMap<String, NonnullRefPtr<Entry>> m_entries;
+};
+
+}
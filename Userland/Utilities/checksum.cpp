@@ -7,8 +7,10 @@
 #include <AK/LexicalPath.h>
 #include <LibCore/ArgsParser.h>
 #include <LibCore/File.h>
+#include <LibCore/MappedFile.h>
 #include <LibCore/System.h>
 #include <LibCrypto/Hash/HashManager.h>
+#include <LibCrypto/Hash/SHA2.h>
 #include <LibMain/Main.h>
 #include <unistd.h>
 
@@ -56,7 +58,49 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     int read_fail_count = 0;
     int failed_verification_count = 0;
 
+    // SHA-256 can hash several files side by side, so whole mapped files are queued up and hashed together.
+    // Anything that can't be mapped (like standard input or an empty file) is read and hashed on its own.
+    struct PendingFile {
+        NonnullOwnPtr<Core::MappedFile> file;
+        Function<void(ReadonlyBytes digest)> on_hashed;
+    };
+    static constexpr size_t max_pending_files = 8;
+    Vector<PendingFile, max_pending_files> pending_files;
+
+    auto hash_pending_files = [&] {
+        if (pending_files.is_empty())
+            return;
+        Vector<ReadonlyBytes, max_pending_files> contents;
+        for (auto const& pending_file : pending_files)
+            contents.append(pending_file.file->bytes());
+        Vector<Crypto::Hash::SHA256::DigestType, max_pending_files> digests;
+        digests.resize(pending_files.size());
+        Crypto::Hash::SHA256::hash_many(contents, digests);
+        for (size_t i = 0; i < pending_files.size(); ++i)
+            pending_files[i].on_hashed(digests[i].bytes());
+        pending_files.clear_with_capacity();
+    };
+
+    // Returns false if the file has to be hashed the normal way. Results are reported in the order files were queued.
+    auto queue_file = [&](StringView path, auto on_hashed) {
+        if (hash_kind != Crypto::Hash::HashKind::SHA256 || path == "-"sv)
+            return false;
+        auto mapped_file_or_error = Core::MappedFile::map(path);
+        if (mapped_file_or_error.is_error())
+            return false;
+        pending_files.append({ mapped_file_or_error.release_value(), move(on_hashed) });
+        if (pending_files.size() == max_pending_files)
+            hash_pending_files();
+        return true;
+    };
+
     for (auto const& path : paths) {
+        if (!verify_from_paths) {
+            if (queue_file(path, [path](ReadonlyBytes digest) { outln("{:hex-dump}  {}", digest, path); }))
+                continue;
+        }
+        hash_pending_files();
+
         auto file_or_error = Core::File::open_file_or_standard_stream(path, Core::File::OpenMode::Read);
         if (file_or_error.is_error()) {
             ++read_fail_count;
@@ -80,6 +124,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
             for (size_t i = 0; i < lines.size(); ++i) {
                 Vector<StringView> const line = lines[i].split_view("  "sv);
                 if (line.size() != 2) {
+                    hash_pending_files();
                     ++read_fail_count;
                     // The real line number is greater than the iterator.
                     warnln("{}: {}: Failed to parse line {}", program_name, path, i + 1);
@@ -89,6 +134,18 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
                 // line[0] = checksum
                 // line[1] = filename
                 StringView const filename = line[1];
+                auto check_digest = [&failed_verification_count, expected_digest = line[0], filename](ReadonlyBytes digest) {
+                    if (DeprecatedString::formatted("{:hex-dump}", digest) == expected_digest)
+                        outln("{}: OK", filename);
+                    else {
+                        ++failed_verification_count;
+                        warnln("{}: FAILED", filename);
+                    }
+                };
+                if (queue_file(filename, check_digest))
+                    continue;
+                hash_pending_files();
+
                 auto file_from_filename_or_error = Core::File::open_file_or_standard_stream(filename, Core::File::OpenMode::Read);
                 if (file_from_filename_or_error.is_error()) {
                     ++read_fail_count;
@@ -99,15 +156,13 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
                 hash.reset();
                 while (!file_from_filename->is_eof())
                     hash.update(TRY(file_from_filename->read_some(buffer)));
-                if (DeprecatedString::formatted("{:hex-dump}", hash.digest().bytes()) == line[0])
-                    outln("{}: OK", filename);
-                else {
-                    ++failed_verification_count;
-                    warnln("{}: FAILED", filename);
-                }
+                check_digest(hash.digest().bytes());
             }
+            hash_pending_files();
         }
     }
+    hash_pending_files();
+
     // Print the warnings here in order to only print them once.
     if (verify_from_paths) {
         if (read_fail_count) {
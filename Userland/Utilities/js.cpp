@@ -537,6 +537,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     bool disable_syntax_highlight = false;
     bool disable_debug_printing = false;
     bool use_test262_global = false;
+    bool dump_function_statistics = false;
     StringView evaluate_script;
     Vector<StringView> script_paths;
 
@@ -544,6 +545,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     args_parser.set_general_help("This is a JavaScript interpreter.");
     args_parser.add_option(s_dump_ast, "Dump the AST", "dump-ast", 'A');
     args_parser.add_option(JS::Bytecode::g_dump_bytecode, "Dump the bytecode", "dump-bytecode", 'd');
+    args_parser.add_option(JS::Bytecode::g_disable_bytecode_optimizations, "Disable bytecode optimizations", "disable-bytecode-optimizations", {});
     args_parser.add_option(s_as_module, "Treat as module", "as-module", 'm');
     args_parser.add_option(s_print_last_result, "Print last result", "print-last-result", 'l');
     args_parser.add_option(s_strip_ansi, "Disable ANSI colors", "disable-ansi-colors", 'i');
@@ -553,6 +555,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     args_parser.add_option(disable_debug_printing, "Disable debug output", "disable-debug-output", {});
     args_parser.add_option(evaluate_script, "Evaluate argument as a script", "evaluate", 'c', "script");
     args_parser.add_option(use_test262_global, "Use test262 global ($262)", "use-test262-global", {});
+    args_parser.add_option(dump_function_statistics, "Dump how many functions were created and called", "dump-function-statistics", {});
     args_parser.add_positional_argument(script_paths, "Path to script files", "scripts", Core::ArgsParser::Required::No);
     args_parser.parse(arguments);
 
@@ -848,7 +851,17 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
 
         // We resolve modules as if it is the first file
 
-        if (!TRY(parse_and_run(realm, builder.string_view(), source_name)))
+        auto success = TRY(parse_and_run(realm, builder.string_view(), source_name));
+
+        if (dump_function_statistics) {
+            auto const& statistics = g_vm->function_statistics();
+            warnln("Function objects: {} created, {} prepared on their first call, {} never called",
+                statistics.function_objects_created,
+                statistics.function_objects_prepared,
+                statistics.function_objects_created - statistics.function_objects_prepared);
+        }
+
+        if (!success)
             return 1;
     }
 